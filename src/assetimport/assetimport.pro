@@ -8,6 +8,7 @@ QT += core-private gui qml quick3drender-private quick3dutils-private
 SOURCES = \
     qssgassetimporterfactory.cpp \
     qssgassetimportmanager.cpp \
+    qssglightmapbaker.cpp \
     qssgmeshutilities.cpp \
     qssgqmlutilities.cpp \
     qssgpathutilities.cpp
@@ -19,6 +20,7 @@ HEADERS = \
     qssgassetimporterfactory_p.h \
     qssgassetimporterplugin_p.h \
     qssgassetimportmanager_p.h \
+    qssglightmapbaker_p.h \
     qssgmeshutilities_p.h \
     qssgpathutilities_p.h
 
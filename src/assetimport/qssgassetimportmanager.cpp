@@ -58,7 +58,14 @@ QSSGAssetImportManager::~QSSGAssetImportManager()
     }
 }
 
-bool QSSGAssetImportManager::importFile(const QString &filename, const QDir &outputPath, QString *error)
+bool QSSGAssetImportManager::importFile(const QString &filename, const QDir &outputPath, QString *error,
+                                        QStringList *generatedFiles)
+{
+    return importFile(filename, outputPath, QVariantMap(), error, generatedFiles);
+}
+
+bool QSSGAssetImportManager::importFile(const QString &filename, const QDir &outputPath, const QVariantMap &options,
+                                        QString *error, QStringList *generatedFiles)
 {
     QFileInfo fileInfo(filename);
 
@@ -78,8 +85,8 @@ bool QSSGAssetImportManager::importFile(const QString &filename, const QDir &out
         return false;
     }
 
-    QStringList generatedFiles;
-    auto errorString = importer->import(fileInfo.absoluteFilePath(), outputPath, QVariantMap(), &generatedFiles);
+    QStringList files;
+    auto errorString = importer->import(fileInfo.absoluteFilePath(), outputPath, options, &files);
 
     if (!errorString.isEmpty()) {
         if (error) {
@@ -89,9 +96,13 @@ bool QSSGAssetImportManager::importFile(const QString &filename, const QDir &out
         return false;
     }
 
-    // debug output
-    for (const auto &file : generatedFiles)
-        qDebug() << "generated file: " << file;
+    if (generatedFiles) {
+        *generatedFiles = files;
+    } else {
+        // debug output
+        for (const auto &file : files)
+            qDebug() << "generated file: " << file;
+    }
 
     return true;
 }
@@ -47,6 +47,7 @@
 #include <QtCore/QVector>
 #include <QtCore/QMap>
 #include <QtCore/QDir>
+#include <QtCore/QVariantMap>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,7 +61,11 @@ public:
     ~QSSGAssetImportManager();
 
     // ### Temp API
-    bool importFile(const QString &filename, const QDir &outputPath, QString *error = nullptr);
+    bool importFile(const QString &filename, const QDir &outputPath, QString *error = nullptr,
+                    QStringList *generatedFiles = nullptr);
+    // options are passed on to the importer, see QSSGAssetImporter::importOptions()
+    bool importFile(const QString &filename, const QDir &outputPath, const QVariantMap &options,
+                    QString *error = nullptr, QStringList *generatedFiles = nullptr);
 
 private:
     QVector<QSSGAssetImporter *> m_assetImporters;
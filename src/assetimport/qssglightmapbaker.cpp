@@ -0,0 +1,752 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qssglightmapbaker_p.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/qmath.h>
+#include <QtGui/QImage>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct UnionFind
+{
+    QVector<int> parents;
+
+    explicit UnionFind(int count) : parents(count)
+    {
+        for (int i = 0; i < count; ++i)
+            parents[i] = i;
+    }
+    int find(int i)
+    {
+        while (parents.at(i) != i)
+            i = parents[i] = parents.at(parents.at(i));
+        return i;
+    }
+    void unite(int a, int b) { parents[find(a)] = find(b); }
+};
+
+struct Chart
+{
+    int axis; // 0-2, the one the triangles are projected along
+    QVector<int> triangles;
+    QVector2D min;
+    QVector2D max;
+    QVector2D offset; // position in the atlas, in world units
+};
+
+QVector2D project(const QVector3D &position, int axis)
+{
+    return QVector2D(position[(axis + 1) % 3], position[(axis + 2) % 3]);
+}
+
+// Shelf packing, sorted by height. Returns false if the charts don't fit in side x side.
+bool packCharts(QVector<Chart> &charts, const QVector<int> &order, float side, float padding)
+{
+    float x = padding;
+    float y = padding;
+    float shelfHeight = 0.0f;
+    for (int index : order) {
+        Chart &chart = charts[index];
+        const QVector2D size = chart.max - chart.min;
+        if (size.x() + 2.0f * padding > side)
+            return false;
+        if (x + size.x() + padding > side) {
+            y += shelfHeight + padding;
+            x = padding;
+            shelfHeight = 0.0f;
+        }
+        chart.offset = QVector2D(x, y);
+        x += size.x() + padding;
+        shelfHeight = qMax(shelfHeight, size.y());
+    }
+    return y + shelfHeight + padding <= side;
+}
+
+float luminance(const QVector3D &color)
+{
+    return 0.2126f * color.x() + 0.7152f * color.y() + 0.0722f * color.z();
+}
+
+// Small and deterministic, the same scene always bakes the same way
+quint32 nextRandom(quint32 &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float randomFloat(quint32 &state)
+{
+    return float(nextRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+}
+
+bool QSSGLightmapUVGenerator::generate(const QVector<QVector3D> &positions, const QVector<quint32> &inIndices, int resolution, int padding)
+{
+    vertexMap.clear();
+    uvs.clear();
+    indices.clear();
+    chartCount = 0;
+
+    const int triangleCount = inIndices.size() / 3;
+    if (triangleCount == 0 || resolution <= 4 * padding)
+        return false;
+
+    // Every triangle is projected along the axis closest to its normal, the sign
+    // is part of the key so that opposite sides never end up in the same chart
+    QVector<int> directions(triangleCount);
+    for (int t = 0; t < triangleCount; ++t) {
+        const QVector3D &p0 = positions.at(int(inIndices.at(3 * t)));
+        const QVector3D &p1 = positions.at(int(inIndices.at(3 * t + 1)));
+        const QVector3D &p2 = positions.at(int(inIndices.at(3 * t + 2)));
+        const QVector3D normal = QVector3D::crossProduct(p1 - p0, p2 - p0);
+        int axis = 0;
+        for (int i = 1; i < 3; ++i) {
+            if (std::abs(normal[i]) > std::abs(normal[axis]))
+                axis = i;
+        }
+        directions[t] = 2 * axis + (normal[axis] < 0.0f ? 1 : 0);
+    }
+
+    // Triangles with the same direction that share an edge go into the same chart
+    UnionFind sets(triangleCount);
+    QHash<quint64, int> edges;
+    edges.reserve(triangleCount * 3);
+    for (int t = 0; t < triangleCount; ++t) {
+        for (int e = 0; e < 3; ++e) {
+            const quint32 a = inIndices.at(3 * t + e);
+            const quint32 b = inIndices.at(3 * t + (e + 1) % 3);
+            const quint64 key = quint64(qMin(a, b)) << 32 | qMax(a, b);
+            auto it = edges.find(key);
+            if (it == edges.end())
+                edges.insert(key, t);
+            else if (directions.at(it.value()) == directions.at(t))
+                sets.unite(t, it.value());
+        }
+    }
+
+    QVector<Chart> charts;
+    QHash<int, int> chartOfSet;
+    QVector<int> chartOfTriangle(triangleCount);
+    for (int t = 0; t < triangleCount; ++t) {
+        const int set = sets.find(t);
+        auto it = chartOfSet.find(set);
+        if (it == chartOfSet.end()) {
+            it = chartOfSet.insert(set, charts.size());
+            Chart chart;
+            chart.axis = directions.at(t) / 2;
+            chart.min = QVector2D(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+            chart.max = -chart.min;
+            charts.append(chart);
+        }
+        Chart &chart = charts[it.value()];
+        chart.triangles.append(t);
+        chartOfTriangle[t] = it.value();
+        for (int i = 0; i < 3; ++i) {
+            const QVector2D p = project(positions.at(int(inIndices.at(3 * t + i))), chart.axis);
+            chart.min = QVector2D(qMin(chart.min.x(), p.x()), qMin(chart.min.y(), p.y()));
+            chart.max = QVector2D(qMax(chart.max.x(), p.x()), qMax(chart.max.y(), p.y()));
+        }
+    }
+
+    // Start with the smallest square that could hold all the charts and grow it until they fit
+    QVector<int> order(charts.size());
+    float area = 0.0f;
+    for (int i = 0; i < charts.size(); ++i) {
+        order[i] = i;
+        const QVector2D size = charts.at(i).max - charts.at(i).min;
+        area += size.x() * size.y();
+    }
+    std::sort(order.begin(), order.end(), [&charts](int a, int b) {
+        return charts.at(a).max.y() - charts.at(a).min.y() > charts.at(b).max.y() - charts.at(b).min.y();
+    });
+    float side = qMax(std::sqrt(area), 1e-6f);
+    bool packed = false;
+    for (int attempt = 0; attempt < 100 && !packed; ++attempt) {
+        packed = packCharts(charts, order, side, side * float(padding) / float(resolution));
+        if (!packed)
+            side *= 1.1f;
+    }
+    if (!packed)
+        return false;
+
+    // A vertex is split for every chart it is part of
+    QHash<quint64, quint32> vertices;
+    indices.reserve(inIndices.size());
+    for (int t = 0; t < triangleCount; ++t) {
+        const int chartIndex = chartOfTriangle.at(t);
+        const Chart &chart = charts.at(chartIndex);
+        for (int i = 0; i < 3; ++i) {
+            const quint32 source = inIndices.at(3 * t + i);
+            const quint64 key = quint64(chartIndex) << 32 | source;
+            auto it = vertices.find(key);
+            if (it == vertices.end()) {
+                it = vertices.insert(key, quint32(vertexMap.size()));
+                vertexMap.append(source);
+                uvs.append((project(positions.at(int(source)), chart.axis) - chart.min + chart.offset) / side);
+            }
+            indices.append(it.value());
+        }
+    }
+    chartCount = charts.size();
+    return true;
+}
+
+struct QSSGLightmapBaker::Bvh
+{
+    struct Node
+    {
+        QVector3D min;
+        QVector3D max;
+        int first; // first triangle of a leaf, the right child otherwise
+        int count; // 0 for inner nodes, their left child is the next node
+    };
+
+    struct Hit
+    {
+        float t;
+        int triangle;
+    };
+
+    QVector<Node> nodes;
+    // Triangles as a vertex and two edges, in the order of the leaves
+    QVector<QVector3D> origins;
+    QVector<QVector3D> edges1;
+    QVector<QVector3D> edges2;
+    QVector<int> models;
+
+    void build(const QVector<Model> &sceneModels);
+    int buildNode(QVector<int> &triangles, const QVector<QVector3D> &centers, int first, int count);
+    bool intersect(const QVector3D &origin, const QVector3D &direction, float tMax, bool anyHit, Hit *hit) const;
+};
+
+void QSSGLightmapBaker::Bvh::build(const QVector<Model> &sceneModels)
+{
+    origins.clear();
+    edges1.clear();
+    edges2.clear();
+    models.clear();
+    nodes.clear();
+    QVector<QVector3D> centers;
+    for (int m = 0; m < sceneModels.size(); ++m) {
+        const Model &model = sceneModels.at(m);
+        for (int i = 0; i + 2 < model.indices.size(); i += 3) {
+            const QVector3D &p0 = model.positions.at(int(model.indices.at(i)));
+            const QVector3D &p1 = model.positions.at(int(model.indices.at(i + 1)));
+            const QVector3D &p2 = model.positions.at(int(model.indices.at(i + 2)));
+            origins.append(p0);
+            edges1.append(p1 - p0);
+            edges2.append(p2 - p0);
+            models.append(m);
+            centers.append((p0 + p1 + p2) / 3.0f);
+        }
+    }
+    if (origins.isEmpty())
+        return;
+
+    QVector<int> triangles(origins.size());
+    for (int i = 0; i < triangles.size(); ++i)
+        triangles[i] = i;
+    buildNode(triangles, centers, 0, triangles.size());
+
+    // Store the triangles in the order of the leaves
+    const QVector<QVector3D> unsortedOrigins = origins;
+    const QVector<QVector3D> unsortedEdges1 = edges1;
+    const QVector<QVector3D> unsortedEdges2 = edges2;
+    const QVector<int> unsortedModels = models;
+    for (int i = 0; i < triangles.size(); ++i) {
+        origins[i] = unsortedOrigins.at(triangles.at(i));
+        edges1[i] = unsortedEdges1.at(triangles.at(i));
+        edges2[i] = unsortedEdges2.at(triangles.at(i));
+        models[i] = unsortedModels.at(triangles.at(i));
+    }
+}
+
+int QSSGLightmapBaker::Bvh::buildNode(QVector<int> &triangles, const QVector<QVector3D> &centers, int first, int count)
+{
+    const int index = nodes.size();
+    nodes.append(Node());
+
+    QVector3D min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    QVector3D max = -min;
+    QVector3D centerMin = min;
+    QVector3D centerMax = max;
+    for (int i = first; i < first + count; ++i) {
+        const int triangle = triangles.at(i);
+        const QVector3D vertices[3] = { origins.at(triangle), origins.at(triangle) + edges1.at(triangle),
+                                        origins.at(triangle) + edges2.at(triangle) };
+        for (int axis = 0; axis < 3; ++axis) {
+            for (const QVector3D &vertex : vertices) {
+                min[axis] = qMin(min[axis], vertex[axis]);
+                max[axis] = qMax(max[axis], vertex[axis]);
+            }
+            centerMin[axis] = qMin(centerMin[axis], centers.at(triangle)[axis]);
+            centerMax[axis] = qMax(centerMax[axis], centers.at(triangle)[axis]);
+        }
+    }
+    nodes[index].min = min;
+    nodes[index].max = max;
+
+    if (count <= 4) {
+        nodes[index].first = first;
+        nodes[index].count = count;
+        return index;
+    }
+
+    // Median split along the longest axis of the centers
+    int axis = 0;
+    const QVector3D extent = centerMax - centerMin;
+    if (extent.y() > extent[axis])
+        axis = 1;
+    if (extent.z() > extent[axis])
+        axis = 2;
+    const int middle = first + count / 2;
+    std::nth_element(triangles.begin() + first, triangles.begin() + middle, triangles.begin() + first + count,
+                     [&centers, axis](int a, int b) { return centers.at(a)[axis] < centers.at(b)[axis]; });
+
+    nodes[index].count = 0;
+    buildNode(triangles, centers, first, middle - first);
+    const int right = buildNode(triangles, centers, middle, first + count - middle);
+    nodes[index].first = right;
+    return index;
+}
+
+bool QSSGLightmapBaker::Bvh::intersect(const QVector3D &origin, const QVector3D &direction, float tMax, bool anyHit, Hit *hit) const
+{
+    if (nodes.isEmpty())
+        return false;
+
+    const QVector3D inverse(1.0f / direction.x(), 1.0f / direction.y(), 1.0f / direction.z());
+    bool found = false;
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node &node = nodes.at(stack[--stackSize]);
+
+        // Slab test
+        float tNear = 0.0f;
+        float tFar = tMax;
+        for (int axis = 0; axis < 3; ++axis) {
+            float t0 = (node.min[axis] - origin[axis]) * inverse[axis];
+            float t1 = (node.max[axis] - origin[axis]) * inverse[axis];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tNear = qMax(tNear, t0);
+            tFar = qMin(tFar, t1);
+        }
+        if (tNear > tFar)
+            continue;
+
+        if (node.count == 0) {
+            const int left = int(&node - nodes.constData()) + 1;
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = left;
+            continue;
+        }
+
+        // Möller-Trumbore, both sides
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            const QVector3D p = QVector3D::crossProduct(direction, edges2.at(i));
+            const float determinant = QVector3D::dotProduct(edges1.at(i), p);
+            if (std::abs(determinant) < 1e-12f)
+                continue;
+            const float inverseDeterminant = 1.0f / determinant;
+            const QVector3D s = origin - origins.at(i);
+            const float u = QVector3D::dotProduct(s, p) * inverseDeterminant;
+            if (u < 0.0f || u > 1.0f)
+                continue;
+            const QVector3D q = QVector3D::crossProduct(s, edges1.at(i));
+            const float v = QVector3D::dotProduct(direction, q) * inverseDeterminant;
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+            const float t = QVector3D::dotProduct(edges2.at(i), q) * inverseDeterminant;
+            if (t <= 0.0f || t >= tMax)
+                continue;
+            found = true;
+            if (anyHit)
+                return true;
+            tMax = t;
+            hit->t = t;
+            hit->triangle = i;
+        }
+    }
+    return found;
+}
+
+struct QSSGLightmapBaker::Texel
+{
+    int index;
+    QVector3D position;
+    QVector3D normal;
+};
+
+class QSSGLightmapBakeTask : public QRunnable
+{
+public:
+    QSSGLightmapBakeTask(QSSGLightmapBaker *baker, int model, const QVector<QSSGLightmapBaker::Texel> *texels, int first, int last)
+        : m_baker(baker), m_model(model), m_texels(texels), m_first(first), m_last(last)
+    {
+    }
+
+    void run() override { m_baker->bakeTexels(m_model, *m_texels, m_first, m_last); }
+
+private:
+    QSSGLightmapBaker *m_baker;
+    int m_model;
+    const QVector<QSSGLightmapBaker::Texel> *m_texels;
+    int m_first;
+    int m_last;
+};
+
+QSSGLightmapBaker::QSSGLightmapBaker() = default;
+
+QSSGLightmapBaker::~QSSGLightmapBaker()
+{
+    delete m_bvh;
+}
+
+int QSSGLightmapBaker::addModel(const Model &model)
+{
+    m_models.append(model);
+    return m_models.size() - 1;
+}
+
+void QSSGLightmapBaker::addLight(const Light &light)
+{
+    m_lights.append(light);
+}
+
+bool QSSGLightmapBaker::bake()
+{
+    // Offset the rays relative to the size of the scene
+    QVector3D min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    QVector3D max = -min;
+    for (const Model &model : qAsConst(m_models)) {
+        for (const QVector3D &position : model.positions) {
+            for (int axis = 0; axis < 3; ++axis) {
+                min[axis] = qMin(min[axis], position[axis]);
+                max[axis] = qMax(max[axis], position[axis]);
+            }
+        }
+    }
+    if (min.x() > max.x())
+        return false;
+    m_epsilon = qMax(1e-4f * (max - min).length(), 1e-6f);
+
+    delete m_bvh;
+    m_bvh = new Bvh;
+    m_bvh->build(m_models);
+
+    m_lightmaps.clear();
+    m_lightmaps.resize(m_models.size());
+    QThreadPool pool;
+    for (int m = 0; m < m_models.size(); ++m) {
+        const Model &model = m_models.at(m);
+        if (model.resolution <= 0 || model.uvs.size() != model.positions.size())
+            continue;
+
+        Lightmap &lightmap = m_lightmaps[m];
+        const int size = model.resolution;
+        lightmap.width = size;
+        lightmap.height = size;
+        lightmap.radiosity.fill(QVector3D(), size * size);
+        lightmap.indirect.fill(QVector3D(), size * size);
+        lightmap.shadow.fill(1.0f, size * size);
+
+        // Find the texels whose center is covered by a triangle
+        QVector<Texel> texels;
+        QVector<bool> covered(size * size, false);
+        for (int i = 0; i + 2 < model.indices.size(); i += 3) {
+            const int i0 = int(model.indices.at(i));
+            const int i1 = int(model.indices.at(i + 1));
+            const int i2 = int(model.indices.at(i + 2));
+            const QVector2D uv0 = model.uvs.at(i0) * float(size);
+            const QVector2D uv1 = model.uvs.at(i1) * float(size);
+            const QVector2D uv2 = model.uvs.at(i2) * float(size);
+            const float area = (uv1.x() - uv0.x()) * (uv2.y() - uv0.y()) - (uv2.x() - uv0.x()) * (uv1.y() - uv0.y());
+            if (std::abs(area) < 1e-12f)
+                continue;
+            const QVector3D faceNormal = QVector3D::crossProduct(model.positions.at(i1) - model.positions.at(i0),
+                                                                 model.positions.at(i2) - model.positions.at(i0)).normalized();
+
+            const int x0 = qMax(0, int(std::floor(qMin(uv0.x(), qMin(uv1.x(), uv2.x())))));
+            const int x1 = qMin(size - 1, int(std::ceil(qMax(uv0.x(), qMax(uv1.x(), uv2.x())))));
+            const int y0 = qMax(0, int(std::floor(qMin(uv0.y(), qMin(uv1.y(), uv2.y())))));
+            const int y1 = qMin(size - 1, int(std::ceil(qMax(uv0.y(), qMax(uv1.y(), uv2.y())))));
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    const int index = y * size + x;
+                    if (covered.at(index))
+                        continue;
+                    const QVector2D center(float(x) + 0.5f, float(y) + 0.5f);
+                    const float b1 = ((center.x() - uv0.x()) * (uv2.y() - uv0.y()) - (uv2.x() - uv0.x()) * (center.y() - uv0.y())) / area;
+                    const float b2 = ((uv1.x() - uv0.x()) * (center.y() - uv0.y()) - (center.x() - uv0.x()) * (uv1.y() - uv0.y())) / area;
+                    const float b0 = 1.0f - b1 - b2;
+                    if (b0 < 0.0f || b1 < 0.0f || b2 < 0.0f)
+                        continue;
+                    covered[index] = true;
+                    Texel texel;
+                    texel.index = index;
+                    texel.position = model.positions.at(i0) * b0 + model.positions.at(i1) * b1 + model.positions.at(i2) * b2;
+                    if (model.normals.size() == model.positions.size()) {
+                        texel.normal = (model.normals.at(i0) * b0 + model.normals.at(i1) * b1 + model.normals.at(i2) * b2).normalized();
+                        if (texel.normal.isNull())
+                            texel.normal = faceNormal;
+                    } else {
+                        texel.normal = faceNormal;
+                    }
+                    texels.append(texel);
+                }
+            }
+        }
+
+        const int chunkSize = 256;
+        for (int first = 0; first < texels.size(); first += chunkSize)
+            pool.start(new QSSGLightmapBakeTask(this, m, &texels, first, qMin(first + chunkSize, texels.size())));
+        pool.waitForDone();
+
+        // Grow the charts into the empty texels so that filtering doesn't pull in black at the edges
+        for (int iteration = 0; iteration < m_settings.dilation; ++iteration) {
+            QVector<bool> grown = covered;
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    const int index = y * size + x;
+                    if (covered.at(index))
+                        continue;
+                    QVector3D radiosity;
+                    QVector3D indirect;
+                    float shadow = 0.0f;
+                    int neighbors = 0;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            const int nx = x + dx;
+                            const int ny = y + dy;
+                            if (nx < 0 || ny < 0 || nx >= size || ny >= size || !covered.at(ny * size + nx))
+                                continue;
+                            radiosity += lightmap.radiosity.at(ny * size + nx);
+                            indirect += lightmap.indirect.at(ny * size + nx);
+                            shadow += lightmap.shadow.at(ny * size + nx);
+                            ++neighbors;
+                        }
+                    }
+                    if (neighbors == 0)
+                        continue;
+                    lightmap.radiosity[index] = radiosity / float(neighbors);
+                    lightmap.indirect[index] = indirect / float(neighbors);
+                    lightmap.shadow[index] = shadow / float(neighbors);
+                    grown[index] = true;
+                }
+            }
+            covered = grown;
+        }
+    }
+    return true;
+}
+
+void QSSGLightmapBaker::bakeTexels(int model, const QVector<Texel> &texels, int first, int last)
+{
+    Lightmap &lightmap = m_lightmaps[model];
+    for (int i = first; i < last; ++i) {
+        const Texel &texel = texels.at(i);
+        QVector3D unoccluded;
+        const QVector3D direct = directLight(texel.position, texel.normal, &unoccluded);
+        const float unoccludedLuminance = luminance(unoccluded);
+        lightmap.radiosity[texel.index] = direct;
+        lightmap.shadow[texel.index] = unoccludedLuminance > 0.0f ? qBound(0.0f, luminance(direct) / unoccludedLuminance, 1.0f) : 1.0f;
+        const quint32 seed = quint32(texel.index) * 9781u + quint32(model) * 6271u + 1u;
+        lightmap.indirect[texel.index] = indirectLight(texel.position, texel.normal, seed);
+    }
+}
+
+QVector3D QSSGLightmapBaker::directLight(const QVector3D &position, const QVector3D &normal, QVector3D *unoccluded) const
+{
+    QVector3D result;
+    const QVector3D origin = position + normal * m_epsilon;
+    for (const Light &light : m_lights) {
+        QVector3D toLight;
+        float distance = std::numeric_limits<float>::max();
+        float attenuation = 1.0f;
+        if (light.type == Light::Type::Directional) {
+            toLight = -light.direction.normalized();
+        } else {
+            toLight = light.position - position;
+            distance = toLight.length();
+            if (distance <= 0.0f)
+                continue;
+            toLight /= distance;
+            const float falloff = light.constantAttenuation + light.linearAttenuation * distance
+                    + light.quadraticAttenuation * distance * distance;
+            if (falloff > 0.0f)
+                attenuation = 1.0f / falloff;
+            if (light.type == Light::Type::Spot) {
+                const float cosAngle = QVector3D::dotProduct(-toLight, light.direction.normalized());
+                const float cosOuter = std::cos(qDegreesToRadians(light.outerConeAngle));
+                const float cosInner = std::cos(qDegreesToRadians(qMin(light.innerConeAngle, light.outerConeAngle)));
+                if (cosAngle <= cosOuter)
+                    continue;
+                if (cosInner > cosOuter && cosAngle < cosInner) {
+                    const float t = (cosAngle - cosOuter) / (cosInner - cosOuter);
+                    attenuation *= t * t * (3.0f - 2.0f * t);
+                }
+            }
+        }
+
+        const float nDotL = QVector3D::dotProduct(normal, toLight);
+        if (nDotL <= 0.0f)
+            continue;
+        const QVector3D contribution = light.color * (nDotL * attenuation);
+        if (unoccluded)
+            *unoccluded += contribution;
+        if (!m_bvh->intersect(origin, toLight, distance - m_epsilon, true, nullptr))
+            result += contribution;
+    }
+    return result;
+}
+
+QVector3D QSSGLightmapBaker::indirectLight(const QVector3D &position, const QVector3D &normal, quint32 seed) const
+{
+    const int samples = m_settings.indirectSamples;
+    if (samples <= 0)
+        return QVector3D();
+
+    // Orthonormal basis around the normal
+    const QVector3D helper = std::abs(normal.x()) > 0.9f ? QVector3D(0.0f, 1.0f, 0.0f) : QVector3D(1.0f, 0.0f, 0.0f);
+    const QVector3D tangent = QVector3D::crossProduct(helper, normal).normalized();
+    const QVector3D bitangent = QVector3D::crossProduct(normal, tangent);
+    const QVector3D origin = position + normal * m_epsilon;
+
+    // Cosine weighted, so the pdf cancels the cosine and the 1/pi of the diffuse reflection
+    QVector3D sum;
+    quint32 state = seed ? seed : 1u;
+    for (int i = 0; i < samples; ++i) {
+        const float r1 = randomFloat(state);
+        const float r2 = randomFloat(state);
+        const float radius = std::sqrt(r1);
+        const float phi = 2.0f * float(M_PI) * r2;
+        const QVector3D direction = tangent * (radius * std::cos(phi)) + bitangent * (radius * std::sin(phi))
+                + normal * std::sqrt(qMax(0.0f, 1.0f - r1));
+
+        Bvh::Hit hit;
+        if (!m_bvh->intersect(origin, direction, std::numeric_limits<float>::max(), false, &hit))
+            continue;
+        QVector3D hitNormal = QVector3D::crossProduct(m_bvh->edges1.at(hit.triangle), m_bvh->edges2.at(hit.triangle)).normalized();
+        // The back side of a surface does not reflect anything
+        if (QVector3D::dotProduct(hitNormal, direction) > 0.0f)
+            continue;
+        const QVector3D hitPosition = origin + direction * hit.t;
+        sum += m_models.at(m_bvh->models.at(hit.triangle)).albedo * directLight(hitPosition, hitNormal, nullptr);
+    }
+    return sum / float(samples);
+}
+
+namespace {
+
+void encodeRgbe(const QVector3D &color, uchar *rgbe)
+{
+    const float value = qMax(color.x(), qMax(color.y(), color.z()));
+    if (value < 1e-32f) {
+        rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+        return;
+    }
+    int exponent;
+    const float scale = std::frexp(value, &exponent) * 256.0f / value;
+    rgbe[0] = uchar(qMax(0.0f, color.x()) * scale);
+    rgbe[1] = uchar(qMax(0.0f, color.y()) * scale);
+    rgbe[2] = uchar(qMax(0.0f, color.z()) * scale);
+    rgbe[3] = uchar(exponent + 128);
+}
+
+}
+
+bool QSSGLightmapBaker::saveHdr(const QString &fileName, int width, int height, const QVector<QVector3D> &texels)
+{
+    if (width <= 0 || height <= 0 || texels.size() != width * height)
+        return false;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray data = QByteArrayLiteral("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n");
+    data += "-Y " + QByteArray::number(height) + " +X " + QByteArray::number(width) + "\n";
+
+    // Run length encoded scanlines without runs, which keeps them unambiguous
+    const bool encoded = width >= 8 && width < 32768;
+    QVector<uchar> scanline(width * 4);
+    for (int row = height - 1; row >= 0; --row) {
+        for (int x = 0; x < width; ++x)
+            encodeRgbe(texels.at(row * width + x), scanline.data() + 4 * x);
+        if (!encoded) {
+            data.append(reinterpret_cast<const char *>(scanline.constData()), scanline.size());
+            continue;
+        }
+        data += char(2);
+        data += char(2);
+        data += char(width >> 8);
+        data += char(width & 0xff);
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int x = 0; x < width; x += 128) {
+                const int count = qMin(128, width - x);
+                data += char(count);
+                for (int i = 0; i < count; ++i)
+                    data += char(scanline.at(4 * (x + i) + channel));
+            }
+        }
+    }
+    return file.write(data) == data.size();
+}
+
+bool QSSGLightmapBaker::saveShadow(const QString &fileName, int width, int height, const QVector<float> &texels)
+{
+    if (width <= 0 || height <= 0 || texels.size() != width * height)
+        return false;
+    QImage image(width, height, QImage::Format_Grayscale8);
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        const int row = height - 1 - y;
+        for (int x = 0; x < width; ++x)
+            line[x] = uchar(qBound(0, int(texels.at(row * width + x) * 255.0f + 0.5f), 255));
+    }
+    return image.save(fileName);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSGLIGHTMAPBAKER_P_H
+#define QSSGLIGHTMAPBAKER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DAssetImport/private/qtquick3dassetimportglobal_p.h>
+
+#include <QtCore/QVector>
+#include <QtCore/QString>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+// Generates lightmap texture coordinates. Triangles facing the same axis that
+// share edges are projected together as one chart, the charts are packed into
+// the unit square without overlapping. Vertices on the border of two charts are
+// split, the result references the source vertices through vertexMap.
+struct Q_QUICK3DASSETIMPORT_EXPORT QSSGLightmapUVGenerator
+{
+    QVector<quint32> vertexMap; // source vertex of each generated vertex
+    QVector<QVector2D> uvs;
+    QVector<quint32> indices;
+    int chartCount = 0;
+
+    // padding is the space left around the charts, in texels of a resolution x resolution map
+    bool generate(const QVector<QVector3D> &positions, const QVector<quint32> &indices, int resolution, int padding = 2);
+};
+
+// Bakes the lighting of static geometry into lightmaps on the CPU.
+//
+// The radiosity map holds the direct light, the indirect map a single bounce
+// of it and the shadow map the fraction of the direct light that is not
+// occluded. These are what the lightmapRadiosity, lightmapIndirect and
+// lightmapShadow material properties expect. All models also occlude and
+// reflect light for each other.
+class Q_QUICK3DASSETIMPORT_EXPORT QSSGLightmapBaker
+{
+public:
+    struct Light
+    {
+        enum class Type
+        {
+            Directional,
+            Point,
+            Spot
+        };
+
+        Type type = Type::Directional;
+        QVector3D position;
+        QVector3D direction { 0.0f, 0.0f, -1.0f }; // the direction the light travels in
+        QVector3D color { 1.0f, 1.0f, 1.0f };
+        float constantAttenuation = 1.0f;
+        float linearAttenuation = 0.0f;
+        float quadraticAttenuation = 0.0f;
+        float outerConeAngle = 45.0f; // degrees, from the direction to the edge
+        float innerConeAngle = 30.0f;
+    };
+
+    // Geometry in world space, uvs are the lightmap coordinates
+    struct Model
+    {
+        QVector<QVector3D> positions;
+        QVector<QVector3D> normals;
+        QVector<QVector2D> uvs;
+        QVector<quint32> indices;
+        QVector3D albedo { 0.8f, 0.8f, 0.8f };
+        int resolution = 256; // 0 for geometry that only occludes
+    };
+
+    struct Lightmap
+    {
+        int width = 0;
+        int height = 0;
+        QVector<QVector3D> radiosity;
+        QVector<QVector3D> indirect;
+        QVector<float> shadow;
+    };
+
+    struct Settings
+    {
+        int indirectSamples = 64;
+        int dilation = 4; // texels filled in around the charts, against bleeding at the seams
+    };
+
+    QSSGLightmapBaker();
+    ~QSSGLightmapBaker();
+
+    int addModel(const Model &model);
+    void addLight(const Light &light);
+    void setSettings(const Settings &settings) { m_settings = settings; }
+
+    // Bakes all the models with a resolution, spread over a QThreadPool
+    bool bake();
+    const Lightmap &lightmap(int model) const { return m_lightmaps.at(model); }
+
+    // Radiance HDR for the light maps, an 8-bit grayscale image for the shadow map.
+    // Rows are written top down, so the first one is the one at v = 1.
+    static bool saveHdr(const QString &fileName, int width, int height, const QVector<QVector3D> &texels);
+    static bool saveShadow(const QString &fileName, int width, int height, const QVector<float> &texels);
+
+private:
+    struct Bvh;
+    struct Texel;
+    friend class QSSGLightmapBakeTask;
+
+    QVector3D directLight(const QVector3D &position, const QVector3D &normal, QVector3D *unoccluded) const;
+    QVector3D indirectLight(const QVector3D &position, const QVector3D &normal, quint32 seed) const;
+    void bakeTexels(int model, const QVector<Texel> &texels, int first, int last);
+
+    QVector<Model> m_models;
+    QVector<Light> m_lights;
+    QVector<Lightmap> m_lightmaps;
+    Settings m_settings;
+    Bvh *m_bvh = nullptr;
+    float m_epsilon = 1e-4f;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSGLIGHTMAPBAKER_P_H
@@ -34,6 +34,7 @@
 #include <QtQuick3D/private/qquick3dcustommaterial_p.h>
 #include <QtQuick3D/private/qquick3ddefaultmaterial_p.h>
 #include <QtQuick3D/private/qquick3deffect_p.h>
+#include <QtQuick3D/private/qquick3dkeyframeanimation_p.h>
 #include <QtQuick3D/private/qquick3dtexture_p.h>
 #include <QtQuick3D/private/qquick3dlight_p.h>
 #include <QtQuick3D/private/qquick3dmaterial_p.h>
@@ -99,6 +100,7 @@ public:
         qmlRegisterType<QQuick3DCustomMaterialRenderState>(uri, 1, 0, "CustomMaterialRenderState");
         qmlRegisterType<QQuick3DDefaultMaterial>(uri, 1, 0, "DefaultMaterial");
         qmlRegisterType<QQuick3DEffect>(uri, 1, 0, "Effect");
+        qmlRegisterType<QQuick3DKeyframeAnimation>(uri, 1, 0, "KeyframeAnimation");
         qmlRegisterType<QQuick3DTexture>(uri, 1, 0, "Texture");
         qmlRegisterType<QQuick3DLight>(uri, 1, 0, "Light");
         qmlRegisterUncreatableType<QQuick3DMaterial>(uri, 1, 0, "Material", QLatin1String("Material is Abstract"));
@@ -1,5 +1,5 @@
 TARGET = assimp
-QT += quick3dassetimport-private
+QT += quick3dassetimport-private quick3dutils-private
 
 PLUGIN_TYPE = assetimporters
 PLUGIN_CLASS_NAME = AssimpImporterPlugin
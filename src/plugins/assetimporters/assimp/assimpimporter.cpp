@@ -37,6 +37,8 @@
 
 #include <QtQuick3DAssetImport/private/qssgmeshutilities_p.h>
 #include <QtQuick3DAssetImport/private/qssgqmlutilities_p.h>
+#include <QtQuick3DAssetImport/private/qssglightmapbaker_p.h>
+#include <QtQuick3DUtils/private/qssgkeyframeanimation_p.h>
 
 #include <QtGui/QImage>
 #include <QtGui/QImageReader>
@@ -92,7 +94,10 @@ const QString AssimpImporter::type() const
 
 const QVariantMap AssimpImporter::importOptions() const
 {
-    return QVariantMap();
+    QVariantMap options;
+    options.insert(QStringLiteral("bakeLightmaps"), false);
+    options.insert(QStringLiteral("lightmapResolution"), 256);
+    return options;
 }
 
 #define demonPostProcessPresets ( \
@@ -115,6 +120,11 @@ const QString AssimpImporter::import(const QString &sourceFile, const QDir &save
     QString errorString;
     m_savePath = savePath;
     m_sourceFile = QFileInfo(sourceFile);
+    m_bakeLightmaps = options.value(QStringLiteral("bakeLightmaps"), false).toBool();
+    m_lightmapResolution = options.value(QStringLiteral("lightmapResolution"), 256).toInt();
+    m_lightmapModels.clear();
+    m_lightmapMeshes.clear();
+    m_generatedFiles.clear();
 
     // Create savePath if it doesn't exist already
     m_savePath.mkdir(".");
@@ -184,7 +194,12 @@ const QString AssimpImporter::import(const QString &sourceFile, const QDir &save
 
     // Traverse Node Tree
 
-    // Animations (timeline based)
+    // Animations, the animated nodes are kept even if they have no content
+    for (uint i = 0; i < m_scene->mNumAnimations; ++i) {
+        const aiAnimation *animation = m_scene->mAnimations[i];
+        for (uint j = 0; j < animation->mNumChannels; ++j)
+            m_animatedNodes.insert(QString::fromUtf8(animation->mChannels[j]->mNodeName.C_Str()));
+    }
 
     // Create QML Component
     QFileInfo sourceFileInfo(sourceFile);
@@ -208,8 +223,15 @@ const QString AssimpImporter::import(const QString &sourceFile, const QDir &save
         targetFile.close();
         if (generatedFiles)
             *generatedFiles += targetFileName;
+
+        // The lightmaps need the whole scene, the materials already reference them
+        if (m_bakeLightmaps)
+            bakeLightmaps();
     }
 
+    if (generatedFiles)
+        *generatedFiles += m_generatedFiles;
+
     return errorString;
 }
 
@@ -255,6 +277,10 @@ void AssimpImporter::processNode(aiNode *node, QTextStream &output, int tabLevel
         for (uint i = 0; i < currentNode->mNumChildren; ++i)
             processNode(currentNode->mChildren[i], output, tabLevel + 1);
 
+        // The animations of the whole scene go into the root
+        if (currentNode == m_scene->mRootNode)
+            generateAnimations(output, tabLevel + 1);
+
         // Write the QML Footer
         output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("}") << endl;
     }
@@ -275,22 +301,31 @@ void AssimpImporter::generateModelProperties(aiNode *modelNode, QTextStream &out
         materials.append(material);
     }
 
+    QString lightmapId;
+    if (m_bakeLightmaps) {
+        generateLightmapUVs(meshes);
+        lightmapId = m_nodeIdMap.value(modelNode, QStringLiteral("model") + QString::number(m_lightmapModels.count()));
+        m_lightmapModels.append({ modelNode, meshes, lightmapId });
+    }
+
     QString outputMeshFile = QStringLiteral("meshes/") +
             QString::fromUtf8(modelNode->mName.C_Str()) + QStringLiteral(".mesh");
 
     m_savePath.mkdir(QStringLiteral("./meshes"));
     QFile meshFile(m_savePath.absolutePath() + QDir::separator() + outputMeshFile);
-    generateMeshFile(meshFile, meshes);
+    if (generateMeshFile(meshFile, meshes).isEmpty())
+        m_generatedFiles += meshFile.fileName();
 
     output << QSSGQmlUtilities::insertTabs(tabLevel) << "source: \"" << outputMeshFile << QStringLiteral("\"") << endl;
 
     // skeletonRoot
 
     // materials
-    // If there are any new materials, add them as children of the Model first
+    // If there are any new materials, add them as children of the Model first.
+    // Lightmaps belong to the model, so baked models get materials of their own.
     for (int i = 0; i < materials.count(); ++i) {
-        if (!m_materialIdMap.contains(materials[i])) {
-            generateMaterial(materials[i], output, tabLevel);
+        if (!lightmapId.isEmpty() || !m_materialIdMap.contains(materials[i])) {
+            generateMaterial(materials[i], output, tabLevel, lightmapId);
             output << endl;
         }
     }
@@ -429,6 +464,7 @@ void AssimpImporter::generateNodeProperties(aiNode *node, QTextStream &output, i
         // ### we may need to account of non-unique and empty names
         QString id = generateUniqueId(QSSGQmlUtilities::sanitizeQmlId(name));
         output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("id: ") << id << endl;
+        m_nodeIdMap.insert(node, id);
     }
 
     // Apply correction if necessary
@@ -702,7 +738,7 @@ QColor aiColorToQColor(const aiColor3D &color)
 }
 }
 
-void AssimpImporter::generateMaterial(aiMaterial *material, QTextStream &output, int tabLevel)
+void AssimpImporter::generateMaterial(aiMaterial *material, QTextStream &output, int tabLevel, const QString &lightmapId)
 {
     output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("DefaultMaterial {") << endl;
 
@@ -832,6 +868,21 @@ void AssimpImporter::generateMaterial(aiMaterial *material, QTextStream &output,
 
     // displacementAmount
 
+    // lightmaps, written by bakeLightmaps()
+    if (!lightmapId.isEmpty()) {
+        const QString lightmapPath = QStringLiteral("maps/lightmaps/") + lightmapId;
+        auto writeLightmap = [&output, tabLevel](const QString &property, const QString &source) {
+            output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << property << QStringLiteral(": Texture {") << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel + 2) << QStringLiteral("source: \"") << source << QStringLiteral("\"") << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("}") << endl;
+        };
+        writeLightmap(QStringLiteral("lightmapIndirect"), lightmapPath + QStringLiteral("_indirect.hdr"));
+        writeLightmap(QStringLiteral("lightmapShadow"), lightmapPath + QStringLiteral("_shadow.png"));
+        // The baked direct light replaces the lights of the scene, in which case they should be removed
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("// lightmapRadiosity: Texture { source: \"")
+               << lightmapPath << QStringLiteral("_radiosity.hdr\" }") << endl;
+    }
+
     output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("}");
 }
 
@@ -996,6 +1047,289 @@ bool AssimpImporter::isCamera(aiNode *node)
     return node && m_cameras.contains(node);
 }
 
+void AssimpImporter::generateAnimations(QTextStream &output, int tabLevel)
+{
+    using Key = QSSGKeyframeAnimationData::Key;
+    using Property = QSSGKeyframeAnimationData::Property;
+    auto makeKey = [](double ticks, double ticksPerSecond, float value) {
+        Key key;
+        key.time = float(ticks / ticksPerSecond);
+        key.value = value;
+        return key;
+    };
+
+    for (uint i = 0; i < m_scene->mNumAnimations; ++i) {
+        const aiAnimation *animation = m_scene->mAnimations[i];
+        const double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+
+        // Every channel becomes one curve per component, played by a KeyframeAnimation
+        QSSGKeyframeAnimationData data;
+        QStringList targets;
+        auto addCurves = [&data](quint32 target, Property firstProperty, const QVector<Key> (&curves)[3]) {
+            for (int c = 0; c < 3; ++c) {
+                if (curves[c].isEmpty())
+                    continue;
+                QVector<Key> keys = curves[c];
+                QSSGKeyframeAnimationData::setLinearTangents(keys);
+                data.addChannel(target, Property(int(firstProperty) + c), QSSGKeyframeAnimationData::Interpolation::Hermite, keys);
+            }
+        };
+
+        for (uint j = 0; j < animation->mNumChannels; ++j) {
+            const aiNodeAnim *channel = animation->mChannels[j];
+            const QString id = m_nodeIdMap.value(m_scene->mRootNode->FindNode(channel->mNodeName));
+            if (id.isEmpty())
+                continue;
+            const quint32 target = quint32(targets.count());
+            targets.append(id);
+
+            // Same conventions as generateNodeProperties()
+            QVector<Key> curves[3];
+            for (uint k = 0; k < channel->mNumPositionKeys; ++k) {
+                const aiVectorKey &key = channel->mPositionKeys[k];
+                curves[0].append(makeKey(key.mTime, ticksPerSecond, key.mValue.x));
+                curves[1].append(makeKey(key.mTime, ticksPerSecond, key.mValue.y));
+                curves[2].append(makeKey(key.mTime, ticksPerSecond, -key.mValue.z));
+            }
+            addCurves(target, Property::PositionX, curves);
+
+            QVector<Key> rotationCurves[3];
+            QVector3D previous;
+            for (uint k = 0; k < channel->mNumRotationKeys; ++k) {
+                const aiQuatKey &key = channel->mRotationKeys[k];
+                aiVector3D scaling;
+                aiVector3D rotation;
+                aiVector3D translation;
+                aiMatrix4x4(key.mValue.GetMatrix()).Decompose(scaling, rotation, translation);
+                QVector3D angles(qRadiansToDegrees(rotation.x), qRadiansToDegrees(rotation.y), qRadiansToDegrees(rotation.z));
+                // Take the shortest way from the previous key instead of wrapping at 180 degrees
+                for (int c = 0; k > 0 && c < 3; ++c)
+                    angles[c] += 360.0f * std::round((previous[c] - angles[c]) / 360.0f);
+                previous = angles;
+                for (int c = 0; c < 3; ++c)
+                    rotationCurves[c].append(makeKey(key.mTime, ticksPerSecond, angles[c]));
+            }
+            addCurves(target, Property::RotationX, rotationCurves);
+
+            QVector<Key> scaleCurves[3];
+            for (uint k = 0; k < channel->mNumScalingKeys; ++k) {
+                const aiVectorKey &key = channel->mScalingKeys[k];
+                scaleCurves[0].append(makeKey(key.mTime, ticksPerSecond, key.mValue.x));
+                scaleCurves[1].append(makeKey(key.mTime, ticksPerSecond, key.mValue.y));
+                scaleCurves[2].append(makeKey(key.mTime, ticksPerSecond, key.mValue.z));
+            }
+            addCurves(target, Property::ScaleX, scaleCurves);
+        }
+
+        if (data.isEmpty())
+            continue;
+
+        QString name = QString::fromUtf8(animation->mName.C_Str());
+        if (name.isEmpty())
+            name = QStringLiteral("animation") + QString::number(i);
+        const QString id = generateUniqueId(QSSGQmlUtilities::sanitizeQmlId(name + QStringLiteral("Animation")));
+        const QString animationFile = QStringLiteral("animations/") + id + QStringLiteral(".qanim");
+        m_savePath.mkdir(QStringLiteral("./animations"));
+        QFile file(m_savePath.absolutePath() + QDir::separator() + animationFile);
+        if (!file.open(QIODevice::WriteOnly))
+            continue;
+        data.save(file);
+        file.close();
+        m_generatedFiles += file.fileName();
+
+        // The first animation plays in a loop, the others are started from QML
+        output << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("KeyframeAnimation {") << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("id: ") << id << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("source: \"") << animationFile << QStringLiteral("\"") << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("loops: KeyframeAnimation.Infinite") << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("running: ") << (i == 0 ? QStringLiteral("true") : QStringLiteral("false")) << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("targets: [") << endl;
+        for (int t = 0; t < targets.count(); ++t) {
+            output << QSSGQmlUtilities::insertTabs(tabLevel + 2) << targets.at(t);
+            if (t < targets.count() - 1)
+                output << QStringLiteral(",");
+            output << endl;
+        }
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("]") << endl;
+        output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("}") << endl;
+    }
+}
+
+namespace {
+
+template<typename T>
+void remapVertices(T *&vertices, const QVector<uint> &sources)
+{
+    if (!vertices)
+        return;
+    T *remapped = new T[sources.size()];
+    for (int i = 0; i < sources.size(); ++i)
+        remapped[i] = vertices[sources.at(i)];
+    delete[] vertices;
+    vertices = remapped;
+}
+
+aiMatrix4x4 worldTransform(const aiNode *node)
+{
+    aiMatrix4x4 transform = node->mTransformation;
+    for (const aiNode *parent = node->mParent; parent; parent = parent->mParent)
+        transform = parent->mTransformation * transform;
+    return transform;
+}
+
+}
+
+// Packs the lightmap coordinates of all the meshes of a model into one map and
+// stores them as the second uv channel. Meshes that already have one are left alone.
+void AssimpImporter::generateLightmapUVs(const QVector<aiMesh *> &meshes)
+{
+    for (aiMesh *mesh : meshes) {
+        if (mesh->HasTextureCoords(1) || m_lightmapMeshes.contains(mesh))
+            return;
+    }
+
+    QVector<QVector3D> positions;
+    QVector<quint32> indices;
+    for (const aiMesh *mesh : meshes) {
+        const quint32 baseIndex = quint32(positions.size());
+        for (uint i = 0; i < mesh->mNumVertices; ++i)
+            positions.append(QVector3D(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z));
+        for (uint f = 0; f < mesh->mNumFaces; ++f) {
+            for (uint i = 0; i < 3; ++i)
+                indices.append(baseIndex + mesh->mFaces[f].mIndices[i]);
+        }
+    }
+
+    QSSGLightmapUVGenerator generator;
+    if (!generator.generate(positions, indices, m_lightmapResolution)) {
+        qWarning() << "Could not generate lightmap coordinates for" << meshes.first()->mName.C_Str();
+        return;
+    }
+
+    // The generated triangles are in the same order, split them back into the meshes
+    int triangle = 0;
+    uint baseVertex = 0;
+    for (aiMesh *mesh : meshes) {
+        QVector<uint> sources;
+        QVector<aiVector3D> uvs;
+        QHash<quint32, uint> vertices;
+        for (uint f = 0; f < mesh->mNumFaces; ++f, ++triangle) {
+            for (uint i = 0; i < 3; ++i) {
+                const quint32 generated = generator.indices.at(3 * triangle + int(i));
+                auto it = vertices.find(generated);
+                if (it == vertices.end()) {
+                    it = vertices.insert(generated, uint(sources.size()));
+                    sources.append(generator.vertexMap.at(int(generated)) - baseVertex);
+                    const QVector2D &uv = generator.uvs.at(int(generated));
+                    uvs.append(aiVector3D(uv.x(), uv.y(), 0.0f));
+                }
+                mesh->mFaces[f].mIndices[i] = it.value();
+            }
+        }
+        baseVertex += mesh->mNumVertices;
+
+        remapVertices(mesh->mVertices, sources);
+        remapVertices(mesh->mNormals, sources);
+        remapVertices(mesh->mTangents, sources);
+        remapVertices(mesh->mBitangents, sources);
+        for (uint c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c)
+            remapVertices(mesh->mColors[c], sources);
+        for (uint c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c)
+            remapVertices(mesh->mTextureCoords[c], sources);
+        delete[] mesh->mTextureCoords[1];
+        mesh->mTextureCoords[1] = new aiVector3D[uvs.size()];
+        std::copy(uvs.constBegin(), uvs.constEnd(), mesh->mTextureCoords[1]);
+        mesh->mNumUVComponents[1] = 2;
+        mesh->mNumVertices = uint(sources.size());
+        m_lightmapMeshes.insert(mesh);
+    }
+}
+
+void AssimpImporter::bakeLightmaps()
+{
+    QSSGLightmapBaker baker;
+    for (const LightmapModel &lightmapModel : qAsConst(m_lightmapModels)) {
+        const aiMatrix4x4 transform = worldTransform(lightmapModel.node);
+        aiMatrix3x3 normalTransform(transform);
+        normalTransform.Inverse().Transpose();
+
+        QSSGLightmapBaker::Model model;
+        model.resolution = m_lightmapResolution;
+        bool hasAlbedo = false;
+        for (const aiMesh *mesh : lightmapModel.meshes) {
+            if (!mesh->HasTextureCoords(1))
+                continue;
+            const quint32 baseIndex = quint32(model.positions.size());
+            for (uint i = 0; i < mesh->mNumVertices; ++i) {
+                const aiVector3D position = transform * mesh->mVertices[i];
+                model.positions.append(QVector3D(position.x, position.y, position.z));
+                const aiVector3D normal = mesh->HasNormals() ? (normalTransform * mesh->mNormals[i]).Normalize() : aiVector3D();
+                model.normals.append(QVector3D(normal.x, normal.y, normal.z));
+                model.uvs.append(QVector2D(mesh->mTextureCoords[1][i].x, mesh->mTextureCoords[1][i].y));
+            }
+            for (uint f = 0; f < mesh->mNumFaces; ++f) {
+                for (uint i = 0; i < 3; ++i)
+                    model.indices.append(baseIndex + mesh->mFaces[f].mIndices[i]);
+            }
+            // Textures are not taken into account for the bounced light
+            aiColor3D diffuseColor;
+            if (!hasAlbedo && m_scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuseColor) == aiReturn_SUCCESS) {
+                model.albedo = QVector3D(diffuseColor.r, diffuseColor.g, diffuseColor.b);
+                hasAlbedo = true;
+            }
+        }
+        baker.addModel(model);
+    }
+
+    for (auto it = m_lights.cbegin(), end = m_lights.cend(); it != end; ++it) {
+        const aiLight *sceneLight = it.value();
+        QSSGLightmapBaker::Light light;
+        if (sceneLight->mType == aiLightSource_DIRECTIONAL)
+            light.type = QSSGLightmapBaker::Light::Type::Directional;
+        else if (sceneLight->mType == aiLightSource_POINT)
+            light.type = QSSGLightmapBaker::Light::Type::Point;
+        else if (sceneLight->mType == aiLightSource_SPOT)
+            light.type = QSSGLightmapBaker::Light::Type::Spot;
+        else
+            continue;
+        const aiMatrix4x4 transform = worldTransform(it.key());
+        const aiVector3D position = transform * sceneLight->mPosition;
+        const aiVector3D direction = (aiMatrix3x3(transform) * sceneLight->mDirection).Normalize();
+        light.position = QVector3D(position.x, position.y, position.z);
+        light.direction = QVector3D(direction.x, direction.y, direction.z);
+        light.color = QVector3D(sceneLight->mColorDiffuse.r, sceneLight->mColorDiffuse.g, sceneLight->mColorDiffuse.b);
+        light.constantAttenuation = sceneLight->mAttenuationConstant;
+        light.linearAttenuation = sceneLight->mAttenuationLinear;
+        light.quadraticAttenuation = sceneLight->mAttenuationQuadratic;
+        light.outerConeAngle = qRadiansToDegrees(sceneLight->mAngleOuterCone);
+        light.innerConeAngle = qRadiansToDegrees(sceneLight->mAngleInnerCone);
+        baker.addLight(light);
+    }
+
+    if (!baker.bake()) {
+        qWarning() << "Could not bake lightmaps";
+        return;
+    }
+
+    m_savePath.mkpath(QStringLiteral("./maps/lightmaps"));
+    for (int i = 0; i < m_lightmapModels.count(); ++i) {
+        const QSSGLightmapBaker::Lightmap &lightmap = baker.lightmap(i);
+        if (lightmap.width == 0)
+            continue;
+        const QString basePath = m_savePath.absoluteFilePath(QStringLiteral("maps/lightmaps/") + m_lightmapModels.at(i).id);
+        const QString radiosityFile = basePath + QStringLiteral("_radiosity.hdr");
+        const QString indirectFile = basePath + QStringLiteral("_indirect.hdr");
+        const QString shadowFile = basePath + QStringLiteral("_shadow.png");
+        if (QSSGLightmapBaker::saveHdr(radiosityFile, lightmap.width, lightmap.height, lightmap.radiosity))
+            m_generatedFiles += radiosityFile;
+        if (QSSGLightmapBaker::saveHdr(indirectFile, lightmap.width, lightmap.height, lightmap.indirect))
+            m_generatedFiles += indirectFile;
+        if (QSSGLightmapBaker::saveShadow(shadowFile, lightmap.width, lightmap.height, lightmap.shadow))
+            m_generatedFiles += shadowFile;
+    }
+}
+
 QString AssimpImporter::generateUniqueId(const QString &id)
 {
     int index = 0;
@@ -1017,6 +1351,7 @@ bool AssimpImporter::containsNodesOfConsequence(aiNode *node)
     isUseful |= isLight(node);
     isUseful |= isModel(node);
     isUseful |= isCamera(node);
+    isUseful |= m_animatedNodes.contains(QString::fromUtf8(node->mName.C_Str()));
 
     // Return early if we know already
     if (isUseful)
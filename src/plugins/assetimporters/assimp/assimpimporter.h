@@ -74,13 +74,24 @@ private:
     void generateCameraProperties(aiNode *cameraNode, QTextStream &output, int tabLevel);
     void generateNodeProperties(aiNode *node, QTextStream &output, int tabLevel, const aiMatrix4x4 &transformCorrection = aiMatrix4x4(), bool skipScaling = false);
     QString generateMeshFile(QIODevice &file, const QVector<aiMesh *> &meshes);
-    void generateMaterial(aiMaterial *material, QTextStream &output, int tabLevel);
+    void generateMaterial(aiMaterial *material, QTextStream &output, int tabLevel, const QString &lightmapId = QString());
     QString generateImage(aiMaterial *material, aiTextureType textureType, unsigned index, int tabLevel);
     bool isModel(aiNode *node);
     bool isLight(aiNode *node);
     bool isCamera(aiNode *node);
+    void generateAnimations(QTextStream &output, int tabLevel);
     QString generateUniqueId(const QString &id);
     bool containsNodesOfConsequence(aiNode *node);
+    void generateLightmapUVs(const QVector<aiMesh *> &meshes);
+    void bakeLightmaps();
+
+    // A model whose lighting is baked, lightmaps are named after the id
+    struct LightmapModel
+    {
+        aiNode *node;
+        QVector<aiMesh *> meshes;
+        QString id;
+    };
 
     Assimp::Importer *m_importer = nullptr;
     const aiScene *m_scene = nullptr;
@@ -88,11 +99,18 @@ private:
     QHash<aiNode *, aiCamera *> m_cameras;
     QHash<aiNode *, aiLight *> m_lights;
     QHash<aiMaterial *, QString> m_materialIdMap;
+    QHash<aiNode *, QString> m_nodeIdMap;
+    QSet<QString> m_animatedNodes;
     QSet<QString> m_uniqueIds;
 
     QDir m_savePath;
     QFileInfo m_sourceFile;
     QStringList m_generatedFiles;
+
+    bool m_bakeLightmaps = false;
+    int m_lightmapResolution = 256;
+    QVector<LightmapModel> m_lightmapModels;
+    QSet<aiMesh *> m_lightmapMeshes;
 };
 
 QT_END_NAMESPACE
@@ -33,9 +33,12 @@
 
 #include "propertymap.h"
 
+#include <QtCore/QFile>
+
 QT_BEGIN_NAMESPACE
 
-KeyframeGroupGenerator::KeyframeGroupGenerator()
+KeyframeGroupGenerator::KeyframeGroupGenerator(float startTime)
+    : m_startTime(startTime)
 {
 
 }
@@ -49,6 +52,9 @@ KeyframeGroupGenerator::~KeyframeGroupGenerator()
 
 void KeyframeGroupGenerator::addAnimation(const AnimationTrack &animation)
 {
+    if (addNativeAnimation(animation))
+        return;
+
     auto keyframeGroupMap = m_targetKeyframeMap.find(animation.m_target);
     QStringList propertyParts = animation.m_property.split(".");
     QString property = propertyParts.at(0);
@@ -87,6 +93,104 @@ void KeyframeGroupGenerator::generateKeyframeGroups(QTextStream &output, int tab
             keyframeGroup->generateKeyframeGroupQml(output, tabLevel);
 }
 
+bool KeyframeGroupGenerator::addNativeAnimation(const AnimationTrack &animation)
+{
+    using Property = QSSGKeyframeAnimationData::Property;
+
+    if (!animation.m_target || !animation.m_target->isNode() || animation.m_dynamic || animation.m_keyFrames.isEmpty())
+        return false;
+
+    const QStringList propertyParts = animation.m_property.split(QLatin1Char('.'));
+    const QString &property = propertyParts.first();
+    const QString field = propertyParts.count() > 1 ? propertyParts.last() : QString();
+    int component = 0;
+    if (field == QStringLiteral("y"))
+        component = 1;
+    else if (field == QStringLiteral("z"))
+        component = 2;
+    else if (!field.isEmpty() && field != QStringLiteral("x"))
+        return false;
+
+    Property channelProperty;
+    float valueScale = 1.0f;
+    if (property == QStringLiteral("position")) {
+        channelProperty = Property(int(Property::PositionX) + component);
+    } else if (property == QStringLiteral("rotation")) {
+        channelProperty = Property(int(Property::RotationX) + component);
+    } else if (property == QStringLiteral("scale")) {
+        channelProperty = Property(int(Property::ScaleX) + component);
+    } else if (property == QStringLiteral("opacity") && field.isEmpty()) {
+        channelProperty = Property::Opacity;
+        valueScale = 0.01f;
+    } else {
+        return false;
+    }
+
+    // Bezier tracks have their times in milliseconds, the others in seconds
+    const bool isBezier = animation.m_type == AnimationTrack::Bezier;
+    const float timeScale = isBezier ? 0.001f : 1.0f;
+    QVector<QSSGKeyframeAnimationData::Key> keys;
+    keys.reserve(animation.m_keyFrames.count());
+    for (const auto &keyframe : animation.m_keyFrames) {
+        QSSGKeyframeAnimationData::Key key;
+        key.time = keyframe.time * timeScale - m_startTime;
+        key.value = keyframe.value * valueScale;
+        keys.append(key);
+    }
+    QSSGKeyframeAnimationData::setLinearTangents(keys);
+
+    if (animation.m_type == AnimationTrack::EaseInOut) {
+        // Ease in and out are percentages, a full ease flattens the curve at the key
+        for (int i = 0; i < keys.count(); ++i) {
+            const auto &keyframe = animation.m_keyFrames.at(i);
+            keys[i].inTangent *= 1.0f - qBound(0.0f, keyframe.easeIn, 100.0f) * 0.01f;
+            keys[i].outTangent *= 1.0f - qBound(0.0f, keyframe.easeOut, 100.0f) * 0.01f;
+        }
+    } else if (isBezier) {
+        // Use the slopes of the control points as tangents: c2 leaves the key, c1 arrives at it
+        for (int i = 0; i < keys.count(); ++i) {
+            const auto &keyframe = animation.m_keyFrames.at(i);
+            if (i + 1 < keys.count() && keyframe.c2time > keyframe.time)
+                keys[i].outTangent = (keyframe.c2value - keyframe.value) * valueScale / ((keyframe.c2time - keyframe.time) * timeScale);
+            if (i > 0 && keyframe.time > keyframe.c1time)
+                keys[i].inTangent = (keyframe.value - keyframe.c1value) * valueScale / ((keyframe.time - keyframe.c1time) * timeScale);
+        }
+    }
+
+    int target = m_nativeTargets.indexOf(animation.m_target);
+    if (target < 0) {
+        target = m_nativeTargets.count();
+        m_nativeTargets.append(animation.m_target);
+    }
+    const auto interpolation = animation.m_type == AnimationTrack::NoAnimation ? QSSGKeyframeAnimationData::Interpolation::Step
+                                                                               : QSSGKeyframeAnimationData::Interpolation::Hermite;
+    m_nativeAnimation.addChannel(quint32(target), channelProperty, interpolation, keys);
+    return true;
+}
+
+bool KeyframeGroupGenerator::saveNativeAnimation(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write to file: " << filePath;
+        return false;
+    }
+    m_nativeAnimation.save(file);
+    return true;
+}
+
+void KeyframeGroupGenerator::generateNativeAnimationTargets(QTextStream &output, int tabLevel) const
+{
+    output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("targets: [") << endl;
+    for (int i = 0; i < m_nativeTargets.count(); ++i) {
+        output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << m_nativeTargets.at(i)->qmlId();
+        if (i < m_nativeTargets.count() - 1)
+            output << QStringLiteral(",");
+        output << endl;
+    }
+    output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("]") << endl;
+}
+
 KeyframeGroupGenerator::KeyframeGroup::KeyFrame::KeyFrame(const AnimationTrack::KeyFrame &keyframe, ValueType type, const QString &field)
 {
     valueType = type;
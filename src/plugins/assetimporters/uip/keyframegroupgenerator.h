@@ -35,6 +35,8 @@
 #include "uippresentation.h"
 #include "uipparser.h"
 
+#include <QtQuick3DUtils/private/qssgkeyframeanimation_p.h>
+
 QT_BEGIN_NAMESPACE
 
 class KeyframeGroupGenerator
@@ -92,16 +94,28 @@ public:
         KeyFrameList keyframes;
     };
 
-    KeyframeGroupGenerator();
+    // Keyframe times of the native animation are relative to startTime
+    explicit KeyframeGroupGenerator(float startTime = 0.0f);
     ~KeyframeGroupGenerator();
 
     void addAnimation(const AnimationTrack &animation);
 
     void generateKeyframeGroups(QTextStream &output, int tabLevel);
 
+    // Transform and opacity tracks of nodes are not turned into keyframe groups,
+    // they are played by a KeyframeAnimation which writes the node transforms directly
+    bool hasNativeAnimation() const { return !m_nativeAnimation.isEmpty(); }
+    bool saveNativeAnimation(const QString &filePath) const;
+    void generateNativeAnimationTargets(QTextStream &output, int tabLevel) const;
+
 private:
+    bool addNativeAnimation(const AnimationTrack &animation);
+
     using KeyframeGroupMap = QHash<QString, KeyframeGroup *>;
     QHash<GraphObject *, KeyframeGroupMap> m_targetKeyframeMap;
+    float m_startTime;
+    QSSGKeyframeAnimationData m_nativeAnimation;
+    QVector<GraphObject *> m_nativeTargets;
 };
 
 QT_END_NAMESPACE
@@ -1,5 +1,5 @@
 TARGET = uip
-QT += quick3dassetimport-private
+QT += quick3dassetimport-private quick3dutils-private
 
 PLUGIN_TYPE = assetimporters
 PLUGIN_CLASS_NAME = UipAssetImporterPlugin
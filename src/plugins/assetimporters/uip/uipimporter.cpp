@@ -529,7 +529,7 @@ void UipImporter::generateAnimationTimeLine(QTextStream &output, int tabLevel, U
         // Get a list off all animations for the master and first slide
         auto animations = combineAnimationTracks(masterSlide->animations(), slide->animations());
         // Create a list of KeyframeGroups
-        KeyframeGroupGenerator generator;
+        KeyframeGroupGenerator generator(startTime);
 
         for (auto animation: animations) {
             generator.addAnimation(animation);
@@ -538,6 +538,30 @@ void UipImporter::generateAnimationTimeLine(QTextStream &output, int tabLevel, U
         generator.generateKeyframeGroups(output, tabLevel + 1);
 
         output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("}") << endl;
+
+        // Node transforms are animated natively, from a file next to the meshes
+        if (generator.hasNativeAnimation()) {
+            const QString animationFile = QStringLiteral("animations/")
+                    + QSSGQmlUtilities::sanitizeQmlId(componentName + QStringLiteral("_") + slide->m_name)
+                    + QStringLiteral(".qanim");
+            m_exportPath.mkdir(QStringLiteral("animations"));
+            const QString animationPath = m_exportPath.absoluteFilePath(animationFile);
+            if (generator.saveNativeAnimation(animationPath)) {
+                m_generatedFiles += animationPath;
+                m_nativeAnimationSlides.insert(slide);
+                const QString sourcePath = component ? QStringLiteral("../") + animationFile : animationFile;
+                QString looping = QStringLiteral("1");
+                if (slide->m_playMode == Slide::Looping || slide->m_playMode == Slide::PingPong)
+                    looping = QStringLiteral("KeyframeAnimation.Infinite");
+                output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("KeyframeAnimation {") << endl;
+                output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("id: ") << QSSGQmlUtilities::sanitizeQmlId(slide->m_name + QStringLiteral("KeyframeAnimation")) << endl;
+                output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("source: \"") << sourcePath << QStringLiteral("\"") << endl;
+                output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("loops: ") << looping << endl;
+                output << QSSGQmlUtilities::insertTabs(tabLevel + 1) << QStringLiteral("pingPong: ") << (slide->m_playMode == Slide::PingPong ? QStringLiteral("true") : QStringLiteral("false")) << endl;
+                generator.generateNativeAnimationTargets(output, tabLevel + 1);
+                output << QSSGQmlUtilities::insertTabs(tabLevel) << QStringLiteral("}") << endl;
+            }
+        }
         slide = static_cast<Slide*>(slide->nextSibling());
     }
 }
@@ -573,6 +597,14 @@ void UipImporter::generateStatesFromSlides(Slide *masterSlide, QTextStream &outp
         output << QSSGQmlUtilities::insertTabs(tabLevel+3) << QStringLiteral("running: true") << endl;
         output << QSSGQmlUtilities::insertTabs(tabLevel+2) << QStringLiteral("}") << endl;
 
+        if (m_nativeAnimationSlides.contains(slide)) {
+            output << QSSGQmlUtilities::insertTabs(tabLevel+2) << QStringLiteral("PropertyChanges {") << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel+3) << QStringLiteral("target: ") << QSSGQmlUtilities::sanitizeQmlId(slide->m_name + QStringLiteral("KeyframeAnimation")) << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel+3) << QStringLiteral("currentTime: 0") << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel+3) << QStringLiteral("running: true") << endl;
+            output << QSSGQmlUtilities::insertTabs(tabLevel+2) << QStringLiteral("}") << endl;
+        }
+
         // Now all other properties changed by the slide
         auto changeList = slide->propertyChanges();
         for (auto it = changeList.cbegin(), ite = changeList.cend(); it != ite; ++it) {
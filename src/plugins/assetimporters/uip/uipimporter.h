@@ -33,6 +33,7 @@
 #include <QtQuick3DAssetImport/private/qssgassetimporter_p.h>
 
 #include <QtCore/QTextStream>
+#include <QtCore/QSet>
 
 #include "uipparser.h"
 #include "uiaparser.h"
@@ -83,6 +84,7 @@ private:
     QVector <AliasNode *> m_aliasNodes;
     QVector <ComponentNode *> m_componentNodes;
     QVector<QDir> m_qmlDirs;
+    QSet<Slide *> m_nativeAnimationSlides;
     bool m_hasQMLSubPresentations = false;
 
     // options
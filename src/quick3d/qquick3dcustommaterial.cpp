@@ -408,6 +408,17 @@ QSSGRenderGraphObject *QQuick3DCustomMaterial::updateSpatialNode(QSSGRenderGraph
         shaderInfo.version = m_shaderInfo->version;
         shaderInfo.shaderPrefix = m_shaderInfo->shaderPrefix;
 
+        // With constant buffer support the plain properties go into a uniform block that is
+        // laid out the same way by QSSGMaterialSystem::applyConstantBuffer()
+        const bool useConstantBuffer = renderContext->renderContext()->supportsConstantBuffer();
+        QByteArray constantBlock;
+        const auto declareProperty = [useConstantBuffer, &constantBlock, &shaderInfo](const QByteArray &type, const QByteArray &name) {
+            if (useConstantBuffer)
+                constantBlock.append(type + " " + name + ";\n");
+            else
+                appendShaderUniform(type, name, &shaderInfo.shaderPrefix);
+        };
+
         QMetaMethod propertyDirtyMethod;
         const int idx = metaObject()->indexOfSlot("onPropertyDirty()");
         if (idx != -1)
@@ -427,22 +438,22 @@ QSSGRenderGraphObject *QQuick3DCustomMaterial::updateSpatialNode(QSSGRenderGraph
                 connect(this, property.notifySignal(), this, propertyDirtyMethod);
 
             if (property.type() == QVariant::Double) {
-                appendShaderUniform(ShaderType<QVariant::Double>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Double>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Double>::type(), i});
             } else if (property.type() == QVariant::Bool) {
-                appendShaderUniform(ShaderType<QVariant::Bool>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Bool>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Bool>::type(), i});
             } else if (property.type() == QVariant::Vector2D) {
-                appendShaderUniform(ShaderType<QVariant::Vector2D>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Vector2D>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Vector2D>::type(), i});
             } else if (property.type() == QVariant::Vector3D) {
-                appendShaderUniform(ShaderType<QVariant::Vector3D>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Vector3D>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Vector3D>::type(), i});
             } else if (property.type() == QVariant::Vector4D) {
-                appendShaderUniform(ShaderType<QVariant::Vector4D>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Vector4D>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Vector4D>::type(), i});
             } else if (property.type() == QVariant::Int) {
-                appendShaderUniform(ShaderType<QVariant::Int>::name(), property.name(), &shaderInfo.shaderPrefix);
+                declareProperty(ShaderType<QVariant::Int>::name(), property.name());
                 customMaterial->properties.push_back({ property.name(), property.read(this), ShaderType<QVariant::Int>::type(), i});
             } else if (property.type() == QVariant::UserType) {
                 if (property.userType() == qMetaTypeId<QQuick3DCustomMaterialTexture *>())
@@ -452,6 +463,9 @@ QSSGRenderGraphObject *QQuick3DCustomMaterial::updateSpatialNode(QSSGRenderGraph
             }
         }
 
+        if (!constantBlock.isEmpty())
+            shaderInfo.shaderPrefix.append(QByteArrayLiteral("layout (std140) uniform cbCustomMaterial {\n") + constantBlock + "};\n");
+
         // Textures
         for (const auto &userProperty : qAsConst(userProperties)) {
             QSSGRenderCustomMaterial::TextureProperty textureData;
@@ -541,6 +555,7 @@ QSSGRenderGraphObject *QQuick3DCustomMaterial::updateSpatialNode(QSSGRenderGraph
             if (Q_LIKELY(p.isValid()))
                 prop.value = p.read(this);
         }
+        customMaterial->setDirty();
     }
 
     if (m_dirtyAttributes & Dirty::TextureDirty) {
@@ -0,0 +1,503 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquick3dkeyframeanimation_p.h"
+#include "qquick3dnode_p.h"
+
+#include <QtCore/QAbstractAnimation>
+#include <QtCore/QFile>
+#include <QtQml/QQmlFile>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype KeyframeAnimation
+    \instantiates QQuick3DKeyframeAnimation
+    \inqmlmodule QtQuick3D
+    \brief Plays keyframe animations of node transforms without property bindings.
+
+    KeyframeAnimation evaluates the keyframes of many nodes at once in C++ and
+    writes the results straight into the transforms of its targets, each node
+    being updated once per frame. The asset importers write the keyframes to an
+    animation file, the channels in it refer to the nodes by their index in
+    \l targets.
+
+    \qml
+    KeyframeAnimation {
+        source: "animations/Take001.qanim"
+        targets: [ hips, spine, head ]
+        loops: KeyframeAnimation.Infinite
+        running: true
+    }
+    \endqml
+*/
+
+// Drives the animation from the unified animation timer, like the QML animations
+class QQuick3DKeyframeAnimationTimer : public QAbstractAnimation
+{
+public:
+    explicit QQuick3DKeyframeAnimationTimer(QQuick3DKeyframeAnimation *animation)
+        : QAbstractAnimation(animation), m_animation(animation)
+    {
+    }
+
+    int duration() const override { return -1; }
+
+protected:
+    void updateCurrentTime(int currentTime) override
+    {
+        const int elapsed = currentTime - m_lastTime;
+        m_lastTime = currentTime;
+        if (elapsed > 0)
+            m_animation->advance(qreal(elapsed));
+    }
+
+    void updateState(State newState, State oldState) override
+    {
+        if (newState == Running && oldState == Stopped)
+            m_lastTime = 0;
+    }
+
+private:
+    QQuick3DKeyframeAnimation *m_animation;
+    int m_lastTime = 0;
+};
+
+QQuick3DKeyframeAnimation::QQuick3DKeyframeAnimation(QObject *parent)
+    : QObject(parent), m_timer(new QQuick3DKeyframeAnimationTimer(this))
+{
+}
+
+QQuick3DKeyframeAnimation::~QQuick3DKeyframeAnimation() {}
+
+/*!
+    \qmlproperty url KeyframeAnimation::source
+
+    This property holds the location of the animation file.
+*/
+QUrl QQuick3DKeyframeAnimation::source() const
+{
+    return m_source;
+}
+
+/*!
+    \qmlproperty List<QtQuick3D::Node> KeyframeAnimation::targets
+
+    This property holds the animated nodes. The animation file refers to them by
+    their index in this list.
+*/
+QQmlListProperty<QQuick3DNode> QQuick3DKeyframeAnimation::targets()
+{
+    return QQmlListProperty<QQuick3DNode>(this,
+                                          nullptr,
+                                          QQuick3DKeyframeAnimation::qmlAppendTarget,
+                                          QQuick3DKeyframeAnimation::qmlTargetsCount,
+                                          QQuick3DKeyframeAnimation::qmlTargetAt,
+                                          QQuick3DKeyframeAnimation::qmlClearTargets);
+}
+
+/*!
+    \qmlproperty bool KeyframeAnimation::running
+
+    This property holds whether the animation is playing. It is reset when the
+    last loop has finished.
+*/
+bool QQuick3DKeyframeAnimation::isRunning() const
+{
+    return m_running;
+}
+
+/*!
+    \qmlproperty bool KeyframeAnimation::paused
+
+    This property holds whether a running animation is paused.
+*/
+bool QQuick3DKeyframeAnimation::isPaused() const
+{
+    return m_paused;
+}
+
+/*!
+    \qmlproperty real KeyframeAnimation::currentTime
+
+    This property holds the position in the current loop, in milliseconds.
+    Setting it seeks the animation.
+*/
+qreal QQuick3DKeyframeAnimation::currentTime() const
+{
+    return m_currentTime;
+}
+
+/*!
+    \qmlproperty real KeyframeAnimation::duration
+
+    This property holds the length of one loop in milliseconds.
+*/
+qreal QQuick3DKeyframeAnimation::duration() const
+{
+    return qreal(m_data.duration) * 1000.0;
+}
+
+/*!
+    \qmlproperty real KeyframeAnimation::speed
+
+    This property holds the playback rate. The default value is \c 1, negative
+    values play the animation backwards.
+*/
+qreal QQuick3DKeyframeAnimation::speed() const
+{
+    return m_speed;
+}
+
+/*!
+    \qmlproperty int KeyframeAnimation::loops
+
+    This property holds how many times the animation is played. The default value
+    is \c 1, KeyframeAnimation.Infinite repeats it until it is stopped.
+*/
+int QQuick3DKeyframeAnimation::loops() const
+{
+    return m_loops;
+}
+
+/*!
+    \qmlproperty bool KeyframeAnimation::pingPong
+
+    This property holds whether every other loop is played backwards.
+*/
+bool QQuick3DKeyframeAnimation::pingPong() const
+{
+    return m_pingPong;
+}
+
+void QQuick3DKeyframeAnimation::setAnimationData(const QSSGKeyframeAnimationData &data)
+{
+    m_data = data;
+    m_evaluator.setAnimation(&m_data);
+    m_values.resize(m_data.channels.size());
+    prepareChannels();
+    m_currentTime = qBound(0.0, m_currentTime, duration());
+    emit durationChanged();
+    if (m_componentComplete)
+        apply();
+}
+
+void QQuick3DKeyframeAnimation::classBegin()
+{
+    m_componentComplete = false;
+}
+
+void QQuick3DKeyframeAnimation::componentComplete()
+{
+    m_componentComplete = true;
+    if (!m_source.isEmpty())
+        loadSource();
+    apply();
+    updateTimer();
+}
+
+void QQuick3DKeyframeAnimation::setSource(const QUrl &source)
+{
+    if (m_source == source)
+        return;
+
+    m_source = source;
+    if (m_componentComplete)
+        loadSource();
+    emit sourceChanged();
+}
+
+void QQuick3DKeyframeAnimation::setRunning(bool running)
+{
+    if (m_running == running)
+        return;
+
+    m_running = running;
+    if (running) {
+        // Starting again after the last loop plays it from the beginning
+        m_currentLoop = 0;
+        const qreal end = m_speed < 0.0 ? 0.0 : duration();
+        if (qFuzzyCompare(m_currentTime, end))
+            m_currentTime = m_speed < 0.0 ? duration() : 0.0;
+        if (m_componentComplete)
+            apply();
+    }
+    updateTimer();
+    emit runningChanged();
+}
+
+void QQuick3DKeyframeAnimation::setPaused(bool paused)
+{
+    if (m_paused == paused)
+        return;
+
+    m_paused = paused;
+    updateTimer();
+    emit pausedChanged();
+}
+
+void QQuick3DKeyframeAnimation::setSpeed(qreal speed)
+{
+    if (qFuzzyCompare(m_speed, speed))
+        return;
+
+    m_speed = speed;
+    emit speedChanged();
+}
+
+void QQuick3DKeyframeAnimation::setLoops(int loops)
+{
+    if (m_loops == loops)
+        return;
+
+    m_loops = loops;
+    emit loopsChanged();
+}
+
+void QQuick3DKeyframeAnimation::setPingPong(bool pingPong)
+{
+    if (m_pingPong == pingPong)
+        return;
+
+    m_pingPong = pingPong;
+    if (m_componentComplete)
+        apply();
+    emit pingPongChanged();
+}
+
+/*!
+    \qmlmethod KeyframeAnimation::play()
+
+    Starts the animation, or resumes it when it is paused.
+*/
+void QQuick3DKeyframeAnimation::play()
+{
+    setPaused(false);
+    setRunning(true);
+}
+
+/*!
+    \qmlmethod KeyframeAnimation::pause()
+
+    Pauses the animation at its current time.
+*/
+void QQuick3DKeyframeAnimation::pause()
+{
+    setPaused(true);
+}
+
+/*!
+    \qmlmethod KeyframeAnimation::stop()
+
+    Stops the animation, the targets keep their current transforms.
+*/
+void QQuick3DKeyframeAnimation::stop()
+{
+    setRunning(false);
+}
+
+/*!
+    \qmlmethod KeyframeAnimation::seek(real time)
+
+    Moves the animation to \a time milliseconds into the current loop and updates
+    the targets.
+*/
+void QQuick3DKeyframeAnimation::seek(qreal time)
+{
+    time = qBound(0.0, time, duration());
+    if (qFuzzyCompare(m_currentTime, time))
+        return;
+
+    m_currentTime = time;
+    if (m_componentComplete)
+        apply();
+    emit currentTimeChanged();
+}
+
+void QQuick3DKeyframeAnimation::loadSource()
+{
+    QSSGKeyframeAnimationData data;
+    if (!m_source.isEmpty()) {
+        QFile file(QQmlFile::urlToLocalFileOrQrc(m_source));
+        if (!file.open(QIODevice::ReadOnly))
+            qWarning("Could not open animation file %s", qPrintable(file.fileName()));
+        else if (!data.load(file))
+            qWarning("Could not load animation file %s", qPrintable(file.fileName()));
+    }
+    setAnimationData(data);
+}
+
+void QQuick3DKeyframeAnimation::prepareChannels()
+{
+    const int count = m_data.channels.size();
+    m_channelOrder.resize(count);
+    for (int i = 0; i < count; ++i)
+        m_channelOrder[i] = i;
+    std::stable_sort(m_channelOrder.begin(), m_channelOrder.end(), [this](int a, int b) {
+        return m_data.channels.at(a).target < m_data.channels.at(b).target;
+    });
+
+    m_targetRanges.clear();
+    for (int i = 0; i < count; ++i) {
+        const int target = int(m_data.channels.at(m_channelOrder.at(i)).target);
+        if (m_targetRanges.isEmpty() || m_targetRanges.last().target != target)
+            m_targetRanges.append(TargetRange{ target, i, 0 });
+        ++m_targetRanges.last().count;
+    }
+}
+
+void QQuick3DKeyframeAnimation::advance(qreal elapsed)
+{
+    const qreal length = duration();
+    if (length <= 0.0)
+        return;
+
+    // Wrap around for every loop that was completed in this step
+    qreal time = m_currentTime + elapsed * m_speed;
+    bool finished = false;
+    if (time >= length || time < 0.0) {
+        const int passed = int(std::floor(time / length));
+        const int loopsPassed = qAbs(passed);
+        if (m_loops != Infinite && m_currentLoop + loopsPassed >= m_loops) {
+            time = m_speed < 0.0 ? 0.0 : length;
+            m_currentLoop = m_loops - 1;
+            finished = true;
+        } else {
+            time -= passed * length;
+            m_currentLoop += loopsPassed;
+        }
+    }
+
+    m_currentTime = time;
+    apply();
+    emit currentTimeChanged();
+
+    if (finished) {
+        setRunning(false);
+        emit this->finished();
+    }
+}
+
+void QQuick3DKeyframeAnimation::apply()
+{
+    if (m_data.isEmpty() || m_targets.isEmpty())
+        return;
+
+    qreal time = m_currentTime;
+    if (m_pingPong && (m_currentLoop & 1))
+        time = duration() - time;
+    m_evaluator.evaluate(float(time / 1000.0), m_values.data());
+
+    using Property = QSSGKeyframeAnimationData::Property;
+    for (const TargetRange &range : qAsConst(m_targetRanges)) {
+        QQuick3DNode *node = m_targets.value(range.target);
+        if (!node)
+            continue;
+
+        QVector3D position = node->position();
+        QVector3D rotation = node->rotation();
+        QVector3D scale = node->scale();
+        float opacity = 0.0f;
+        bool hasOpacity = false;
+        for (int i = range.first, end = range.first + range.count; i < end; ++i) {
+            const int channel = m_channelOrder.at(i);
+            const float value = m_values.at(channel);
+            const Property property = m_data.channels.at(channel).property;
+            switch (property) {
+            case Property::PositionX:
+            case Property::PositionY:
+            case Property::PositionZ:
+                position[int(property) - int(Property::PositionX)] = value;
+                break;
+            case Property::RotationX:
+            case Property::RotationY:
+            case Property::RotationZ:
+                rotation[int(property) - int(Property::RotationX)] = value;
+                break;
+            case Property::ScaleX:
+            case Property::ScaleY:
+            case Property::ScaleZ:
+                scale[int(property) - int(Property::ScaleX)] = value;
+                break;
+            case Property::Opacity:
+                opacity = value;
+                hasOpacity = true;
+                break;
+            default:
+                break;
+            }
+        }
+        node->setLocalTransform(position, rotation, scale);
+        if (hasOpacity)
+            node->setLocalOpacity(opacity);
+    }
+}
+
+void QQuick3DKeyframeAnimation::updateTimer()
+{
+    if (!m_running || !m_componentComplete) {
+        m_timer->stop();
+    } else if (m_paused) {
+        if (m_timer->state() == QAbstractAnimation::Running)
+            m_timer->pause();
+    } else if (m_timer->state() == QAbstractAnimation::Paused) {
+        m_timer->resume();
+    } else if (m_timer->state() == QAbstractAnimation::Stopped) {
+        m_timer->start();
+    }
+}
+
+void QQuick3DKeyframeAnimation::qmlAppendTarget(QQmlListProperty<QQuick3DNode> *list, QQuick3DNode *target)
+{
+    QQuick3DKeyframeAnimation *self = static_cast<QQuick3DKeyframeAnimation *>(list->object);
+    self->m_targets.push_back(target);
+}
+
+QQuick3DNode *QQuick3DKeyframeAnimation::qmlTargetAt(QQmlListProperty<QQuick3DNode> *list, int index)
+{
+    QQuick3DKeyframeAnimation *self = static_cast<QQuick3DKeyframeAnimation *>(list->object);
+    return self->m_targets.at(index);
+}
+
+int QQuick3DKeyframeAnimation::qmlTargetsCount(QQmlListProperty<QQuick3DNode> *list)
+{
+    QQuick3DKeyframeAnimation *self = static_cast<QQuick3DKeyframeAnimation *>(list->object);
+    return self->m_targets.count();
+}
+
+void QQuick3DKeyframeAnimation::qmlClearTargets(QQmlListProperty<QQuick3DNode> *list)
+{
+    QQuick3DKeyframeAnimation *self = static_cast<QQuick3DKeyframeAnimation *>(list->object);
+    self->m_targets.clear();
+}
+
+QT_END_NAMESPACE
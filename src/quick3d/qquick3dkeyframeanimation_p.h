@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICK3DKEYFRAMEANIMATION_P_H
+#define QQUICK3DKEYFRAMEANIMATION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3D/qtquick3dglobal.h>
+
+#include <QtQuick3DUtils/private/qssgkeyframeanimation_p.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+#include <QtQml/QQmlListProperty>
+#include <QtQml/QQmlParserStatus>
+
+QT_BEGIN_NAMESPACE
+
+class QQuick3DNode;
+class QQuick3DKeyframeAnimationTimer;
+
+class Q_QUICK3D_EXPORT QQuick3DKeyframeAnimation : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QQmlListProperty<QQuick3DNode> targets READ targets)
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
+    Q_PROPERTY(bool paused READ isPaused WRITE setPaused NOTIFY pausedChanged)
+    Q_PROPERTY(qreal currentTime READ currentTime WRITE seek NOTIFY currentTimeChanged)
+    Q_PROPERTY(qreal duration READ duration NOTIFY durationChanged)
+    Q_PROPERTY(qreal speed READ speed WRITE setSpeed NOTIFY speedChanged)
+    Q_PROPERTY(int loops READ loops WRITE setLoops NOTIFY loopsChanged)
+    Q_PROPERTY(bool pingPong READ pingPong WRITE setPingPong NOTIFY pingPongChanged)
+
+public:
+    enum Loops { Infinite = -1 };
+    Q_ENUM(Loops)
+
+    explicit QQuick3DKeyframeAnimation(QObject *parent = nullptr);
+    ~QQuick3DKeyframeAnimation() override;
+
+    QUrl source() const;
+    QQmlListProperty<QQuick3DNode> targets();
+    bool isRunning() const;
+    bool isPaused() const;
+    qreal currentTime() const;
+    qreal duration() const;
+    qreal speed() const;
+    int loops() const;
+    bool pingPong() const;
+
+    // For loading the keyframes without going through a file
+    void setAnimationData(const QSSGKeyframeAnimationData &data);
+    const QSSGKeyframeAnimationData &animationData() const { return m_data; }
+
+    void classBegin() override;
+    void componentComplete() override;
+
+public Q_SLOTS:
+    void setSource(const QUrl &source);
+    void setRunning(bool running);
+    void setPaused(bool paused);
+    void setSpeed(qreal speed);
+    void setLoops(int loops);
+    void setPingPong(bool pingPong);
+
+    void play();
+    void pause();
+    void stop();
+    void seek(qreal time);
+
+Q_SIGNALS:
+    void sourceChanged();
+    void runningChanged();
+    void pausedChanged();
+    void currentTimeChanged();
+    void durationChanged();
+    void speedChanged();
+    void loopsChanged();
+    void pingPongChanged();
+    void finished();
+
+private:
+    void loadSource();
+    void prepareChannels();
+    void advance(qreal elapsed);
+    void apply();
+    void updateTimer();
+
+    static void qmlAppendTarget(QQmlListProperty<QQuick3DNode> *list, QQuick3DNode *target);
+    static QQuick3DNode *qmlTargetAt(QQmlListProperty<QQuick3DNode> *list, int index);
+    static int qmlTargetsCount(QQmlListProperty<QQuick3DNode> *list);
+    static void qmlClearTargets(QQmlListProperty<QQuick3DNode> *list);
+
+    // The channels of one target, applied together so the node is only marked dirty once
+    struct TargetRange
+    {
+        int target;
+        int first;
+        int count;
+    };
+
+    QUrl m_source;
+    QVector<QQuick3DNode *> m_targets;
+    QSSGKeyframeAnimationData m_data;
+    QSSGKeyframeEvaluator m_evaluator;
+    QVector<float> m_values;
+    QVector<int> m_channelOrder;
+    QVector<TargetRange> m_targetRanges;
+    QQuick3DKeyframeAnimationTimer *m_timer = nullptr;
+    qreal m_currentTime = 0.0; // milliseconds
+    qreal m_speed = 1.0;
+    int m_loops = 1;
+    int m_currentLoop = 0;
+    bool m_running = false;
+    bool m_paused = false;
+    bool m_pingPong = false;
+    bool m_componentComplete = true;
+
+    friend class QQuick3DKeyframeAnimationTimer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICK3DKEYFRAMEANIMATION_P_H
@@ -322,6 +322,7 @@ QSSGRenderGraphObject *QQuick3DMaterial::updateSpatialNode(QSSGRenderGraphObject
             defaultMaterial->displacementMap = m_displacementMap->getRenderImage();
 
         defaultMaterial->displaceAmount = m_displacementAmount;
+        defaultMaterial->dirty.setDirty();
         node = defaultMaterial;
 
     } else if (node->type == QSSGRenderGraphObject::Type::CustomMaterial) {
@@ -28,6 +28,7 @@
 ****************************************************************************/
 
 #include "qquick3dnode_p.h"
+#include "qquick3dobject_p_p.h"
 
 #include <QtQuick3DRuntimeRender/private/qssgrendereulerangles_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendernode_p.h>
@@ -392,7 +393,7 @@ void QQuick3DNode::setX(float x)
     m_position.setX(x);
     emit positionChanged(m_position);
     emit xChanged(x);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setY(float y)
@@ -403,7 +404,7 @@ void QQuick3DNode::setY(float y)
     m_position.setY(y);
     emit positionChanged(m_position);
     emit yChanged(y);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setZ(float z)
@@ -414,7 +415,7 @@ void QQuick3DNode::setZ(float z)
     m_position.setZ(z);
     emit positionChanged(m_position);
     emit zChanged(z);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setRotation(QVector3D rotation)
@@ -424,7 +425,7 @@ void QQuick3DNode::setRotation(QVector3D rotation)
 
     m_rotation = rotation;
     emit rotationChanged(m_rotation);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setPosition(QVector3D position)
@@ -446,7 +447,40 @@ void QQuick3DNode::setPosition(QVector3D position)
     if (!zUnchanged)
         emit zChanged(m_position.z());
 
-    update();
+    markTransformDirty();
+}
+
+void QQuick3DNode::setLocalTransform(const QVector3D &position, const QVector3D &rotation, const QVector3D &scale)
+{
+    const bool positionDirty = m_position != position;
+    const bool rotationDirty = m_rotation != rotation;
+    const bool scaleDirty = m_scale != scale;
+    if (!positionDirty && !rotationDirty && !scaleDirty)
+        return;
+
+    if (positionDirty) {
+        const bool xUnchanged = qFuzzyCompare(position.x(), m_position.x());
+        const bool yUnchanged = qFuzzyCompare(position.y(), m_position.y());
+        const bool zUnchanged = qFuzzyCompare(position.z(), m_position.z());
+        m_position = position;
+        emit positionChanged(m_position);
+        if (!xUnchanged)
+            emit xChanged(m_position.x());
+        if (!yUnchanged)
+            emit yChanged(m_position.y());
+        if (!zUnchanged)
+            emit zChanged(m_position.z());
+    }
+    if (rotationDirty) {
+        m_rotation = rotation;
+        emit rotationChanged(m_rotation);
+    }
+    if (scaleDirty) {
+        m_scale = scale;
+        emit scaleChanged(m_scale);
+    }
+
+    markTransformDirty();
 }
 
 void QQuick3DNode::setScale(QVector3D scale)
@@ -456,7 +490,7 @@ void QQuick3DNode::setScale(QVector3D scale)
 
     m_scale = scale;
     emit scaleChanged(m_scale);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setPivot(QVector3D pivot)
@@ -466,7 +500,7 @@ void QQuick3DNode::setPivot(QVector3D pivot)
 
     m_pivot = pivot;
     emit pivotChanged(m_pivot);
-    update();
+    markTransformDirty();
 }
 
 void QQuick3DNode::setLocalOpacity(float opacity)
@@ -525,25 +559,7 @@ QSSGRenderGraphObject *QQuick3DNode::updateSpatialNode(QSSGRenderGraphObject *no
         node = new QSSGRenderNode();
 
     auto spacialNode = static_cast<QSSGRenderNode *>(node);
-    bool transformIsDirty = false;
-    if (spacialNode->position != m_position) {
-        transformIsDirty = true;
-        spacialNode->position = m_position;
-    }
-    if (spacialNode->rotation != m_rotation) {
-        transformIsDirty = true;
-        spacialNode->rotation = QVector3D(qDegreesToRadians(m_rotation.x()),
-                                          qDegreesToRadians(m_rotation.y()),
-                                          qDegreesToRadians(m_rotation.z()));
-    }
-    if (spacialNode->scale != m_scale) {
-        transformIsDirty = true;
-        spacialNode->scale = m_scale;
-    }
-    if (spacialNode->pivot != m_pivot) {
-        transformIsDirty = true;
-        spacialNode->pivot = m_pivot;
-    }
+    bool transformIsDirty = updateSpatialTransform(spacialNode);
 
     if (spacialNode->rotationOrder != quint32(m_rotationorder)) {
         transformIsDirty = true;
@@ -560,18 +576,43 @@ QSSGRenderGraphObject *QQuick3DNode::updateSpatialNode(QSSGRenderGraphObject *no
 
     spacialNode->flags.setFlag(QSSGRenderNode::Flag::Active, m_visible);
 
-    if (transformIsDirty) {
+    // Global transforms of the subtree are calculated when the renderer prepares the layer
+    if (transformIsDirty)
         spacialNode->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
-        spacialNode->calculateGlobalVariables();
-        // Still needs to be marked dirty if it will show up correctly in the backend
-        // Note: no longer sure if this is still needed after we now do our own
-        // calculation of the global matrix from the front-end.
-        spacialNode->flags.setFlag(QSSGRenderNode::Flag::Dirty, true);
-    } else {
+    else
         spacialNode->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformNotDirty);
-    }
 
     return spacialNode;
 }
 
+bool QQuick3DNode::updateSpatialTransform(QSSGRenderNode *node)
+{
+    bool transformIsDirty = false;
+    if (node->position != m_position) {
+        transformIsDirty = true;
+        node->position = m_position;
+    }
+    const QVector3D rotation(qDegreesToRadians(m_rotation.x()),
+                             qDegreesToRadians(m_rotation.y()),
+                             qDegreesToRadians(m_rotation.z()));
+    if (node->rotation != rotation) {
+        transformIsDirty = true;
+        node->rotation = rotation;
+    }
+    if (node->scale != m_scale) {
+        transformIsDirty = true;
+        node->scale = m_scale;
+    }
+    if (node->pivot != m_pivot) {
+        transformIsDirty = true;
+        node->pivot = m_pivot;
+    }
+    return transformIsDirty;
+}
+
+void QQuick3DNode::markTransformDirty()
+{
+    QQuick3DObjectPrivate::get(this)->dirty(QQuick3DObjectPrivate::Transform);
+}
+
 QT_END_NAMESPACE
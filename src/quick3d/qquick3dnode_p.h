@@ -169,8 +169,15 @@ private:
 
     QMatrix4x4 calculateLocalTransformRightHanded();
     void calculateGlobalVariables();
+    // Copies position, rotation, scale and pivot to node, returns true if any changed
+    bool updateSpatialTransform(QSSGRenderNode *node);
+    // Flags a change the scene manager can sync without a full updateSpatialNode()
+    void markTransformDirty();
+    // Sets the whole local transform with a single update, used by animations
+    void setLocalTransform(const QVector3D &position, const QVector3D &rotation, const QVector3D &scale);
 
     friend QQuick3DSceneManager;
+    friend class QQuick3DKeyframeAnimation;
 };
 
 QT_END_NAMESPACE
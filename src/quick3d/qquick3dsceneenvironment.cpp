@@ -276,6 +276,32 @@ float QQuick3DSceneEnvironment::aoBias() const
     return m_aoBias;
 }
 
+/*!
+    \qmlproperty enumeration QtQuick3D::SceneEnvironment::aoResolution
+
+    This property defines the resolution the ambient occlusion is computed at,
+    relative to the size of the layer.
+
+    At a reduced resolution the occlusion is blurred and scaled back up to the
+    size of the layer with filters that follow the depth of the scene, so that
+    the shadowing does not bleed over the edges of objects.
+
+    Possible Values:
+    \list
+    \li SceneEnvironment.FullResolution
+    \li SceneEnvironment.HalfResolution - a quarter of the pixels.
+    \li SceneEnvironment.QuarterResolution - a sixteenth of the pixels.
+    \endlist
+
+    \note OpenGL ES 2 always computes the ambient occlusion at full resolution.
+
+    The default value is \c SceneEnvironment.HalfResolution
+*/
+QQuick3DSceneEnvironment::QQuick3DEnvironmentAOResolutionValues QQuick3DSceneEnvironment::aoResolution() const
+{
+    return m_aoResolution;
+}
+
 /*!
     \qmlproperty float QtQuick3D::SceneEnvironment::shadowStrength
 
@@ -449,6 +475,39 @@ bool QQuick3DSceneEnvironment::temporalAAEnabled() const
 {
     return m_temporalAAEnabled;
 }
+
+/*!
+    \qmlproperty enumeration QtQuick3D::SceneEnvironment::postProcessAAMode
+
+    This property sets the antialiasing filter that is applied to the
+    rendered image of the scene.
+
+    Instead of rendering more samples, the edges are found in the final image
+    and smoothed out by blending the pixels along them.
+
+    Pros: Low and fixed cost that does not depend on the complexity of the
+    scene; works with moving content and with all the other antialiasing
+    modes except progressive antialiasing.
+
+    Cons: Cannot recover detail that was lost in rendering; slightly softens
+    the image, SMAA less so than FXAA.
+
+    Possible Values:
+    \list
+    \li SceneEnvironment.NoPostAA
+    \li SceneEnvironment.FXAA - a single full screen pass.
+    \li SceneEnvironment.SMAA - edge detection, blend weight calculation and
+    neighborhood blending in three passes.
+    \endlist
+
+    The filter is not applied while progressive antialiasing is enabled.
+
+    The default value is \c SceneEnvironment.NoPostAA
+*/
+QQuick3DSceneEnvironment::QQuick3DEnvironmentPostAAModeValues QQuick3DSceneEnvironment::postProcessAAMode() const
+{
+    return m_postProcessAAMode;
+}
 /*!
     \qmlproperty List<QtQuick3D::Effect> QtQuick3D::SceneEnvironment::effects
 
@@ -597,6 +656,16 @@ void QQuick3DSceneEnvironment::setAoBias(float aoBias)
     update();
 }
 
+void QQuick3DSceneEnvironment::setAoResolution(QQuick3DSceneEnvironment::QQuick3DEnvironmentAOResolutionValues aoResolution)
+{
+    if (m_aoResolution == aoResolution)
+        return;
+
+    m_aoResolution = aoResolution;
+    emit aoResolutionChanged(m_aoResolution);
+    update();
+}
+
 void QQuick3DSceneEnvironment::setShadowStrength(float shadowStrength)
 {
     if (qFuzzyCompare(m_shadowStrength, shadowStrength))
@@ -792,6 +861,16 @@ void QQuick3DSceneEnvironment::setTemporalAAEnabled(bool temporalAAEnabled)
     update();
 }
 
+void QQuick3DSceneEnvironment::setPostProcessAAMode(QQuick3DSceneEnvironment::QQuick3DEnvironmentPostAAModeValues postProcessAAMode)
+{
+    if (m_postProcessAAMode == postProcessAAMode)
+        return;
+
+    m_postProcessAAMode = postProcessAAMode;
+    emit postProcessAAModeChanged(m_postProcessAAMode);
+    update();
+}
+
 void QQuick3DSceneEnvironment::qmlAppendEffect(QQmlListProperty<QQuick3DEffect> *list, QQuick3DEffect *effect)
 {
     if (effect == nullptr)
@@ -61,6 +61,7 @@ class Q_QUICK3D_EXPORT QQuick3DSceneEnvironment : public QQuick3DObject
     Q_PROPERTY(QQuick3DEnvironmentAAModeValues progressiveAAMode READ progressiveAAMode WRITE setProgressiveAAMode NOTIFY progressiveAAModeChanged)
     Q_PROPERTY(QQuick3DEnvironmentAAModeValues multisampleAAMode READ multisampleAAMode WRITE setMultisampleAAMode NOTIFY multisampleAAModeChanged)
     Q_PROPERTY(bool temporalAAEnabled READ temporalAAEnabled WRITE setTemporalAAEnabled NOTIFY temporalAAEnabledChanged)
+    Q_PROPERTY(QQuick3DEnvironmentPostAAModeValues postProcessAAMode READ postProcessAAMode WRITE setPostProcessAAMode NOTIFY postProcessAAModeChanged)
     Q_PROPERTY(QQuick3DEnvironmentBackgroundTypes backgroundMode READ backgroundMode WRITE setBackgroundMode NOTIFY backgroundModeChanged)
     Q_PROPERTY(QColor clearColor READ clearColor WRITE setClearColor NOTIFY clearColorChanged)
     Q_PROPERTY(bool isDepthTestDisabled READ isDepthTestDisabled WRITE setIsDepthTestDisabled NOTIFY isDepthTestDisabledChanged)
@@ -72,6 +73,7 @@ class Q_QUICK3D_EXPORT QQuick3DSceneEnvironment : public QQuick3DObject
     Q_PROPERTY(bool aoDither READ aoDither WRITE setAoDither NOTIFY aoDitherChanged)
     Q_PROPERTY(int aoSampleRate READ aoSampleRate WRITE setAoSampleRate NOTIFY aoSampleRateChanged)
     Q_PROPERTY(float aoBias READ aoBias WRITE setAoBias NOTIFY aoBiasChanged)
+    Q_PROPERTY(QQuick3DEnvironmentAOResolutionValues aoResolution READ aoResolution WRITE setAoResolution NOTIFY aoResolutionChanged)
 
     Q_PROPERTY(float shadowStrength READ shadowStrength WRITE setShadowStrength NOTIFY shadowStrengthChanged)
     Q_PROPERTY(float shadowDistance READ shadowDistance WRITE setShadowDistance NOTIFY shadowDistanceChanged)
@@ -98,6 +100,12 @@ public:
         X8 = 8
     };
     Q_ENUM(QQuick3DEnvironmentAAModeValues)
+    enum QQuick3DEnvironmentPostAAModeValues {
+        NoPostAA = 0,
+        FXAA,
+        SMAA
+    };
+    Q_ENUM(QQuick3DEnvironmentPostAAModeValues)
     enum QQuick3DEnvironmentBackgroundTypes {
         Transparent = 0,
         Unspecified,
@@ -105,6 +113,12 @@ public:
         SkyBox
     };
     Q_ENUM(QQuick3DEnvironmentBackgroundTypes)
+    enum QQuick3DEnvironmentAOResolutionValues {
+        FullResolution = 1,
+        HalfResolution = 2,
+        QuarterResolution = 4
+    };
+    Q_ENUM(QQuick3DEnvironmentAOResolutionValues)
 
     explicit QQuick3DSceneEnvironment(QQuick3DObject *parent = nullptr);
     ~QQuick3DSceneEnvironment() override;
@@ -112,6 +126,7 @@ public:
     QQuick3DEnvironmentAAModeValues progressiveAAMode() const;
     QQuick3DEnvironmentAAModeValues multisampleAAMode() const;
     bool temporalAAEnabled() const;
+    QQuick3DEnvironmentPostAAModeValues postProcessAAMode() const;
 
     QQuick3DEnvironmentBackgroundTypes backgroundMode() const;
     QColor clearColor() const;
@@ -122,6 +137,7 @@ public:
     bool aoDither() const;
     int aoSampleRate() const;
     float aoBias() const;
+    QQuick3DEnvironmentAOResolutionValues aoResolution() const;
 
     float shadowStrength() const;
     float shadowDistance() const;
@@ -150,6 +166,7 @@ public Q_SLOTS:
     void setProgressiveAAMode(QQuick3DEnvironmentAAModeValues progressiveAAMode);
     void setMultisampleAAMode(QQuick3DEnvironmentAAModeValues multisampleAAMode);
     void setTemporalAAEnabled(bool temporalAAEnabled);
+    void setPostProcessAAMode(QQuick3DEnvironmentPostAAModeValues postProcessAAMode);
 
     void setBackgroundMode(QQuick3DEnvironmentBackgroundTypes backgroundMode);
     void setClearColor(QColor clearColor);
@@ -160,6 +177,7 @@ public Q_SLOTS:
     void setAoDither(bool aoDither);
     void setAoSampleRate(int aoSampleRate);
     void setAoBias(float aoBias);
+    void setAoResolution(QQuick3DEnvironmentAOResolutionValues aoResolution);
 
     void setShadowStrength(float shadowStrength);
     void setShadowDistance(float shadowDistance);
@@ -184,6 +202,7 @@ Q_SIGNALS:
     void progressiveAAModeChanged(QQuick3DEnvironmentAAModeValues progressiveAAMode);
     void multisampleAAModeChanged(QQuick3DEnvironmentAAModeValues multisampleAAMode);
     void temporalAAEnabledChanged(bool temporalAAEnabled);
+    void postProcessAAModeChanged(QQuick3DEnvironmentPostAAModeValues postProcessAAMode);
 
     void backgroundModeChanged(QQuick3DEnvironmentBackgroundTypes backgroundMode);
     void clearColorChanged(QColor clearColor);
@@ -194,6 +213,7 @@ Q_SIGNALS:
     void aoDitherChanged(bool aoDither);
     void aoSampleRateChanged(int aoSampleRate);
     void aoBiasChanged(float aoBias);
+    void aoResolutionChanged(QQuick3DEnvironmentAOResolutionValues aoResolution);
 
     void shadowStrengthChanged(float shadowStrength);
     void shadowDistanceChanged(float shadowDistance);
@@ -224,6 +244,7 @@ private:
     QQuick3DEnvironmentAAModeValues m_progressiveAAMode = NoAA;
     QQuick3DEnvironmentAAModeValues m_multisampleAAMode = NoAA;
     bool m_temporalAAEnabled = false;
+    QQuick3DEnvironmentPostAAModeValues m_postProcessAAMode = NoPostAA;
 
     QQuick3DEnvironmentBackgroundTypes m_backgroundMode = Transparent;
     QColor m_clearColor = Qt::black;
@@ -234,6 +255,7 @@ private:
     bool m_aoDither = false;
     int m_aoSampleRate = 2;
     float m_aoBias = 0.0f;
+    QQuick3DEnvironmentAOResolutionValues m_aoResolution = HalfResolution;
     float m_shadowStrength = 0.0f;
     float m_shadowDistance = 10.0f;
     float m_shadowSoftness = 100.0f;
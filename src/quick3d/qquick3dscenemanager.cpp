@@ -72,6 +72,9 @@ void QQuick3DSceneManager::sync()
 
 void QQuick3DSceneManager::updateDirtyNodes()
 {
+    if (!cleanupNodeList.isEmpty() || dirtyImageList || dirtyResourceList || dirtySpatialNodeList || !dirtyLightList.isEmpty())
+        ++changeCount;
+
     cleanupNodes();
 
     auto updateNodes = [this](QQuick3DObject *updateList) {
@@ -90,6 +93,7 @@ void QQuick3DSceneManager::updateDirtyNodes()
     updateNodes(dirtyImageList);
     updateNodes(dirtyResourceList);
     updateNodes(dirtySpatialNodeList);
+    applyTransformUpdates();
     // Lights have to be last because of scoped lights
     for (const auto light : dirtyLightList)
         updateDirtyNode(light);
@@ -110,10 +114,8 @@ void QQuick3DSceneManager::updateDirtyNode(QQuick3DObject *object)
     case QQuick3DObject::Model:
     case QQuick3DObject::Text:
     case QQuick3DObject::Path: {
-        // handle hierarchical nodes
-        QQuick3DNode *spatialNode = qobject_cast<QQuick3DNode *>(object);
-        if (spatialNode)
-            updateDirtySpatialNode(spatialNode);
+        // handle hierarchical nodes, the type says it is one
+        updateDirtySpatialNode(static_cast<QQuick3DNode *>(object));
     } break;
     case QQuick3DObject::SceneEnvironment:
     case QQuick3DObject::DefaultMaterial:
@@ -135,11 +137,11 @@ void QQuick3DSceneManager::updateDirtyNode(QQuick3DObject *object)
 void QQuick3DSceneManager::updateDirtyResource(QQuick3DObject *resourceObject)
 {
     QQuick3DObjectPrivate *itemPriv = QQuick3DObjectPrivate::get(resourceObject);
-    quint32 dirty = itemPriv->dirtyAttributes;
-    Q_UNUSED(dirty)
     itemPriv->dirtyAttributes = 0;
+    QSSGRenderGraphObject *oldNode = itemPriv->spatialNode;
     itemPriv->spatialNode = resourceObject->updateSpatialNode(itemPriv->spatialNode);
-    if (itemPriv->spatialNode)
+    // Register the object only when its render node is created
+    if (itemPriv->spatialNode && itemPriv->spatialNode != oldNode)
         m_nodeMap.insert(itemPriv->spatialNode, resourceObject);
 
     // resource nodes dont go in the tree, so we dont need to parent them
@@ -148,11 +150,22 @@ void QQuick3DSceneManager::updateDirtyResource(QQuick3DObject *resourceObject)
 void QQuick3DSceneManager::updateDirtySpatialNode(QQuick3DNode *spatialNode)
 {
     QQuick3DObjectPrivate *itemPriv = QQuick3DObjectPrivate::get(spatialNode);
-    quint32 dirty = itemPriv->dirtyAttributes;
-    Q_UNUSED(dirty)
+    const quint32 dirty = itemPriv->dirtyAttributes;
     itemPriv->dirtyAttributes = 0;
+
+    // Only position, rotation, scale or pivot changed: queue the new local
+    // transform instead of running the full sync of the node
+    if (itemPriv->spatialNode && dirty == QQuick3DObjectPrivate::Transform) {
+        QSSGRenderNode *graphNode = static_cast<QSSGRenderNode *>(itemPriv->spatialNode);
+        if (spatialNode->updateSpatialTransform(graphNode))
+            m_transformUpdates.append({ graphNode, spatialNode->calculateLocalTransformRightHanded() });
+        return;
+    }
+
+    QSSGRenderGraphObject *oldNode = itemPriv->spatialNode;
     itemPriv->spatialNode = spatialNode->updateSpatialNode(itemPriv->spatialNode);
-    if (itemPriv->spatialNode)
+    // Register the object only when its render node is created
+    if (itemPriv->spatialNode && itemPriv->spatialNode != oldNode)
         m_nodeMap.insert(itemPriv->spatialNode, spatialNode);
 
     QSSGRenderNode *graphNode = static_cast<QSSGRenderNode *>(itemPriv->spatialNode);
@@ -178,6 +191,20 @@ void QQuick3DSceneManager::updateDirtySpatialNode(QQuick3DNode *spatialNode)
     }
 }
 
+void QQuick3DSceneManager::applyTransformUpdates()
+{
+    for (const TransformUpdate &update : qAsConst(m_transformUpdates)) {
+        QSSGRenderNode *node = update.node;
+        node->localTransform = update.localTransform;
+        node->flags.setFlag(QSSGRenderNode::Flag::TransformDirty, false);
+        // Flags the subtree for the calculation of global transforms, the walk
+        // stops at subtrees that are already flagged
+        node->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformNotDirty);
+    }
+    // Keeps the capacity for the next frame
+    m_transformUpdates.clear();
+}
+
 QQuick3DObject *QQuick3DSceneManager::lookUpNode(QSSGRenderGraphObject *node) const
 {
     return m_nodeMap[node];
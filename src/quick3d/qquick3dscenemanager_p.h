@@ -43,6 +43,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QSet>
+#include <QtGui/QMatrix4x4>
 
 #include <QtQuick3D/private/qtquick3dglobal_p.h>
 
@@ -70,6 +71,7 @@ public:
     void updateDirtyNode(QQuick3DObject *object);
     void updateDirtyResource(QQuick3DObject *resourceObject);
     void updateDirtySpatialNode(QQuick3DNode *spatialNode);
+    void applyTransformUpdates();
 
     QQuick3DObject *lookUpNode(QSSGRenderGraphObject *node) const;
 
@@ -83,6 +85,18 @@ public:
     QSet<QQuick3DObject *> parentlessItems;
     QVector<QSGDynamicTexture *> qsgDynamicTextures;
     QHash<QSSGRenderGraphObject *, QQuick3DObject *> m_nodeMap;
+
+    struct TransformUpdate
+    {
+        QSSGRenderNode *node;
+        QMatrix4x4 localTransform;
+    };
+    // Nodes of which only the transform changed, applied together by
+    // updateDirtyNodes() once all nodes are synced
+    QVector<TransformUpdate> m_transformUpdates;
+    // Incremented by updateDirtyNodes() whenever it changed the render graph,
+    // so renderers sharing the scene can tell whether it changed since they last drew it
+    quint64 changeCount = 0;
     friend QQuick3DObject;
 
 Q_SIGNALS:
@@ -43,11 +43,15 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
 #include <QtQuick/QQuickWindow>
 
+#include <QtCore/QMutexLocker>
+
 QT_BEGIN_NAMESPACE
 
 static bool dumpPerfTiming = false;
 static int frameCount = 0;
 static bool dumpRenderTimes = false;
+static bool alwaysRender = false;
+static QString perfTraceFile;
 
 namespace {
 void cleanupOpenGLState() {
@@ -106,10 +110,17 @@ void SGFramebufferObjectNode::preprocess()
 void SGFramebufferObjectNode::render()
 {
     if (renderPending) {
+        renderPending = false;
+        // Nothing changed, the texture still holds the last frame
+        if (texture() && !renderer->isFrameDirty())
+            return;
+
         QElapsedTimer renderTimer;
         renderTimer.start();
-        renderPending = false;
         GLuint textureId = renderer->render();
+        // Draw again once the shaders that are still being built are ready
+        if (renderer->hasPendingShaders())
+            QMetaObject::invokeMethod(quickFbo, "update", Qt::QueuedConnection);
 
         cleanupOpenGLState();
 
@@ -151,20 +162,33 @@ QQuick3DSceneRenderer::QQuick3DSceneRenderer(QWindow *window)
         m_renderContext = renderContextInterface->renderContext();
     }
 
-    // If there was no render context, then set it up for this window
-    if (m_renderContext.isNull())
-        m_renderContext = QSSGRenderContext::createGl(openGLContext->format());
-    if (m_sgContext.isNull())
-        m_sgContext = QSSGRenderContextInterface::getRenderContextInterface(m_renderContext, QString::fromLatin1("./"), quintptr(window));
+    // If there was no render context, then set it up for this window. Windows whose
+    // contexts share resources also share meshes, textures and shader programs.
+    if (m_sgContext.isNull()) {
+        const auto sharedResources = QSSGRenderSharedResources::getSharedResources(openGLContext);
+        m_sgContext = QSSGRenderContextInterface::getRenderContextInterface(sharedResources, QString::fromLatin1("./"), quintptr(window));
+        m_renderContext = m_sgContext->renderContext();
+    }
 
     dumpPerfTiming = !qgetenv("QUICK3D_PERFTIMERS").isEmpty();
     dumpRenderTimes = !qgetenv("QUICK3D_RENDERTIMES").isEmpty();
-    if (dumpPerfTiming)
+    alwaysRender = !qgetenv("QUICK3D_ALWAYS_RENDER").isEmpty();
+    perfTraceFile = qEnvironmentVariable("QUICK3D_PERFTRACE");
+    if (dumpPerfTiming) {
         m_sgContext->renderer()->enableLayerGpuProfiling(true);
+        m_sgContext->performanceTimer()->setEnabled(true);
+    }
+    if (!perfTraceFile.isEmpty()) {
+        m_sgContext->performanceTimer()->setEnabled(true);
+        m_sgContext->performanceTimer()->setTraceEnabled(true);
+    }
 }
 
 QQuick3DSceneRenderer::~QQuick3DSceneRenderer()
 {
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
+    if (!perfTraceFile.isEmpty() && !m_sgContext->performanceTimer()->exportTrace(perfTraceFile))
+        qWarning("Could not write performance trace to %s", qPrintable(perfTraceFile));
     delete m_layer;
 }
 
@@ -173,6 +197,7 @@ GLuint QQuick3DSceneRenderer::render()
     if (!m_layer)
         return 0;
 
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
     m_sgContext->beginFrame();
     m_renderContext->setRenderTarget(m_fbo->fbo);
     m_sgContext->renderList()->setViewport(QRect(0, 0, m_surfaceSize.width(), m_surfaceSize.height()));
@@ -183,6 +208,11 @@ GLuint QQuick3DSceneRenderer::render()
     m_sgContext->renderer()->renderLayer(*m_layer, m_surfaceSize, true, QVector3D(0, 0, 0), false);
     m_sgContext->endFrame();
 
+    // Progressive and temporal AA refine the image over several frames
+    m_frameDirty = alwaysRender || m_layer->progressiveAAMode != QSSGRenderLayer::AAMode::NoAA || m_layer->temporalAAEnabled;
+    m_shadersPending = m_sgContext->renderer()->hasPendingShaders();
+    m_frameDirty |= m_shadersPending;
+
     if (dumpPerfTiming) {
         if (++frameCount == 60) {
             m_sgContext->performanceTimer()->dump();
@@ -198,6 +228,7 @@ void QQuick3DSceneRenderer::render(const QRect &viewport, bool clearFirst)
     if (!m_layer)
         return;
 
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
     m_sgContext->beginFrame();
 
     // set render target to be current window (default)
@@ -212,6 +243,7 @@ void QQuick3DSceneRenderer::render(const QRect &viewport, bool clearFirst)
     m_sgContext->runRenderTasks();
     m_sgContext->renderer()->renderLayer(*m_layer, m_surfaceSize, clearFirst, QVector3D(0, 0, 0), false);
     m_sgContext->endFrame();
+    m_shadersPending = m_sgContext->renderer()->hasPendingShaders();
 
     if (dumpPerfTiming) {
         if (++frameCount == 60) {
@@ -226,24 +258,43 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
     if (!item)
         return;
 
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
     QElapsedTimer syncTimer;
     syncTimer.start();
 
     if (m_surfaceSize != size) {
         m_layerSizeIsDirty = true;
         m_surfaceSize = size;
+        m_frameDirty = true;
     }
 
     // wireframe mode
-    if (m_sgContext->wireframeMode() != item->enableWireframeMode())
+    if (m_sgContext->wireframeMode() != item->enableWireframeMode()) {
         m_sgContext->setWireframeMode(item->enableWireframeMode());
+        m_frameDirty = true;
+    }
 
+    // Scene managers can be shared between views, so compare change counts
+    // rather than relying on who cleared the dirty lists
     auto view3D = static_cast<QQuick3DViewport*>(item);
-    m_sceneManager = QQuick3DObjectPrivate::get(view3D->scene())->sceneManager;
-    m_sceneManager->updateDirtyNodes();
+    QQuick3DSceneManager *sceneManager = QQuick3DObjectPrivate::get(view3D->scene())->sceneManager;
+    sceneManager->updateDirtyNodes();
+    if (sceneManager != m_sceneManager || sceneManager->changeCount != m_sceneChangeCount) {
+        m_sceneManager = sceneManager;
+        m_sceneChangeCount = sceneManager->changeCount;
+        m_frameDirty = true;
+    }
 
+    QQuick3DSceneManager *referencedSceneManager = nullptr;
     if (view3D->referencedScene()) {
-        QQuick3DObjectPrivate::get(view3D->referencedScene())->sceneManager->updateDirtyNodes();
+        referencedSceneManager = QQuick3DObjectPrivate::get(view3D->referencedScene())->sceneManager;
+        referencedSceneManager->updateDirtyNodes();
+    }
+    if (referencedSceneManager != m_referencedSceneManager
+            || (referencedSceneManager && referencedSceneManager->changeCount != m_referencedSceneChangeCount)) {
+        m_referencedSceneManager = referencedSceneManager;
+        m_referencedSceneChangeCount = referencedSceneManager ? referencedSceneManager->changeCount : 0;
+        m_frameDirty = true;
     }
 
     // Generate layer node
@@ -251,7 +302,10 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
         m_layer = new QSSGRenderLayer();
 
     // Update the layer node properties
+    QSSGRenderCamera *previousCamera = m_layer->activeCamera;
     updateLayerNode(view3D);
+    if (m_layer->activeCamera != previousCamera)
+        m_frameDirty = true;
 
     // Set the root item for the scene to the layer
     auto rootNode = static_cast<QSSGRenderNode*>(QQuick3DObjectPrivate::get(view3D->scene())->spatialNode);
@@ -263,6 +317,7 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
             addNodeToLayer(rootNode);
 
         m_sceneRootNode = rootNode;
+        m_frameDirty = true;
     }
 
     // Add the referenced scene root node to the layer as well if available
@@ -277,6 +332,7 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
             addNodeToLayer(referencedRootNode);
 
         m_referencedRootNode = referencedRootNode;
+        m_frameDirty = true;
     }
 
     if (useFBO) {
@@ -286,6 +342,7 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
 
             m_fbo = new FramebufferObject(m_surfaceSize, m_renderContext);
             m_layerSizeIsDirty = false;
+            m_frameDirty = true;
         }
     }
     if (dumpRenderTimes) {
@@ -297,6 +354,7 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *item, const QSize &siz
 
 void QQuick3DSceneRenderer::update()
 {
+    m_frameDirty = true;
     if (data)
         static_cast<SGFramebufferObjectNode *>(data)->scheduleRender();
 }
@@ -309,6 +367,7 @@ void QQuick3DSceneRenderer::invalidateFramebufferObject()
 
 QQuick3DPickResult QQuick3DSceneRenderer::pick(const QPointF &pos)
 {
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
     auto pickResults = m_sgContext->renderer()->pick(*m_layer,
                                                      QVector2D(m_surfaceSize.width(), m_surfaceSize.height()),
                                                      QVector2D(pos.x(), pos.y()));
@@ -321,12 +380,64 @@ QQuick3DPickResult QQuick3DSceneRenderer::pick(const QPointF &pos)
     return QQuick3DPickResult();
 }
 
+QVector<QVector<QQuick3DPickResult>> QQuick3DSceneRenderer::pickBatch(const QVector<QPointF> &positions)
+{
+    QVector<QVector2D> mouseCoords;
+    mouseCoords.reserve(positions.size());
+    for (const QPointF &pos : positions)
+        mouseCoords.append(QVector2D(pos.x(), pos.y()));
+
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
+    const QSSGRenderPickBatchResult batchResult = m_sgContext->renderer()->pickBatch(*m_layer,
+                                                                                     QVector2D(m_surfaceSize.width(), m_surfaceSize.height()),
+                                                                                     mouseCoords);
+    return toPickResults(batchResult);
+}
+
+QVector<QVector<QQuick3DPickResult>> QQuick3DSceneRenderer::pickBatch(const QVector<QSSGRenderRay> &rays)
+{
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
+    const QSSGRenderPickBatchResult batchResult = m_sgContext->renderer()->pickBatch(*m_layer, rays);
+    return toPickResults(batchResult);
+}
+
+QVector<QQuick3DModel *> QQuick3DSceneRenderer::pickRect(const QRectF &rect)
+{
+    QMutexLocker locker(m_sgContext->sharedResources()->lock());
+    const auto objects = m_sgContext->renderer()->pickFrustum(*m_layer,
+                                                              QVector2D(m_surfaceSize.width(), m_surfaceSize.height()),
+                                                              rect);
+    QVector<QQuick3DModel *> models;
+    for (const QSSGRenderGraphObject *object : objects) {
+        QQuick3DModel *model = qobject_cast<QQuick3DModel*>(m_sceneManager->lookUpNode(const_cast<QSSGRenderGraphObject*>(object)));
+        if (model)
+            models.append(model);
+    }
+    return models;
+}
+
+QVector<QVector<QQuick3DPickResult>> QQuick3DSceneRenderer::toPickResults(const QSSGRenderPickBatchResult &batchResult) const
+{
+    QVector<QVector<QQuick3DPickResult>> results(batchResult.rayCount());
+    for (int ray = 0; ray < results.size(); ++ray) {
+        QVector<QQuick3DPickResult> &rayResults = results[ray];
+        for (int idx = 0, end = batchResult.hitCount(ray); idx < end; ++idx) {
+            const QSSGRenderPickResult &hit = batchResult.hit(ray, idx);
+            QQuick3DModel *model = qobject_cast<QQuick3DModel*>(m_sceneManager->lookUpNode(const_cast<QSSGRenderGraphObject*>(hit.m_hitObject)));
+            if (model)
+                rayResults.append(QQuick3DPickResult(model, ::sqrtf(hit.m_cameraDistanceSq), hit.m_localUVCoords));
+        }
+    }
+    return results;
+}
+
 void QQuick3DSceneRenderer::updateLayerNode(QQuick3DViewport *view3D)
 {
     QSSGRenderLayer *layerNode = m_layer;
     layerNode->progressiveAAMode = QSSGRenderLayer::AAMode(view3D->environment()->progressiveAAMode());
     layerNode->multisampleAAMode = QSSGRenderLayer::AAMode(view3D->environment()->multisampleAAMode());
     layerNode->temporalAAEnabled = view3D->environment()->temporalAAEnabled();
+    layerNode->postAAMode = QSSGRenderLayer::PostAAMode(view3D->environment()->postProcessAAMode());
 
     layerNode->background = QSSGRenderLayer::Background(view3D->environment()->backgroundMode());
     layerNode->clearColor = QVector3D(float(view3D->environment()->clearColor().redF()),
@@ -344,6 +455,7 @@ void QQuick3DSceneRenderer::updateLayerNode(QQuick3DViewport *view3D)
     layerNode->aoBias = view3D->environment()->aoBias();
     layerNode->aoSamplerate = view3D->environment()->aoSampleRate();
     layerNode->aoDither = view3D->environment()->aoDither();
+    layerNode->aoResolution = QSSGRenderLayer::AOResolution(view3D->environment()->aoResolution());
 
 
     layerNode->shadowStrength = view3D->environment()->shadowStrength();
@@ -508,6 +620,8 @@ void QQuick3DSGDirectRenderer::render()
     const QRect glViewport = convertQtRectToGLViewport(m_viewport, m_window->size() * m_window->devicePixelRatio());
     m_renderer->render(glViewport, false);
     cleanupOpenGLState();
+    if (m_renderer->hasPendingShaders())
+        QMetaObject::invokeMethod(m_window, "update", Qt::QueuedConnection);
     if (dumpRenderTimes) {
         QOpenGLContext::currentContext()->functions()->glFinish();
         qDebug() << "Window: Render took: " << renderTimer.elapsed() << "ms";
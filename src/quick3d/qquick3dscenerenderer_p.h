@@ -43,6 +43,8 @@
 
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendergraphobjectpickquery_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderray_p.h>
 
 #include <qsgtextureprovider.h>
 #include <qsgrendernode.h>
@@ -78,13 +80,23 @@ protected:
     void synchronize(QQuick3DViewport *item, const QSize &size, bool useFBO = true);
     void update();
     void invalidateFramebufferObject();
+    // The next render() has to draw the scene even if nothing in it changed
+    void markFrameDirty() { m_frameDirty = true; }
+    bool isFrameDirty() const { return m_frameDirty; }
+    // Some shaders were still being generated, the next frame draws more of the scene
+    bool hasPendingShaders() const { return m_shadersPending; }
     QSize surfaceSize() const { return m_surfaceSize; }
     QQuick3DPickResult pick(const QPointF &pos);
+    // The hits of every position or ray, nearest first
+    QVector<QVector<QQuick3DPickResult>> pickBatch(const QVector<QPointF> &positions);
+    QVector<QVector<QQuick3DPickResult>> pickBatch(const QVector<QSSGRenderRay> &rays);
+    QVector<QQuick3DModel *> pickRect(const QRectF &rect);
 
 private:
     void updateLayerNode(QQuick3DViewport *view3D);
     void addNodeToLayer(QSSGRenderNode *node);
     void removeNodeFromLayer(QSSGRenderNode *node);
+    QVector<QVector<QQuick3DPickResult>> toPickResults(const QSSGRenderPickBatchResult &batchResult) const;
     QQuick3DSceneManager *m_sceneManager = nullptr;
     QSSGRenderLayer *m_layer = nullptr;
     QSSGRenderContextInterface::QSSGRenderContextInterfacePtr m_sgContext;
@@ -98,6 +110,13 @@ private:
     QSSGRenderNode *m_sceneRootNode = nullptr;
     QSSGRenderNode *m_referencedRootNode = nullptr;
 
+    // Render on demand: the scene is only drawn again when something changed
+    bool m_frameDirty = true;
+    bool m_shadersPending = false;
+    quint64 m_sceneChangeCount = 0;
+    QQuick3DSceneManager *m_referencedSceneManager = nullptr;
+    quint64 m_referencedSceneChangeCount = 0;
+
     friend class SGFramebufferObjectNode;
     friend class QQuick3DSGRenderNode;
     friend class QQuick3DSGDirectRenderer;
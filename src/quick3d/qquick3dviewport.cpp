@@ -34,6 +34,7 @@
 #include "qquick3dtexture_p.h"
 #include "qquick3dscenerenderer_p.h"
 #include "qquick3dcamera_p.h"
+#include "qquick3dmodel_p.h"
 #include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
 #include <QOpenGLFunctions>
 
@@ -311,7 +312,8 @@ QSGNode *QQuick3DViewport::updatePaintNode(QSGNode *node, QQuickItem::UpdatePain
         // geometry.
         auto *sceneManager = QQuick3DObjectPrivate::get(m_sceneRoot)->sceneManager;
         for (auto *texture : qAsConst(sceneManager->qsgDynamicTextures)) {
-            texture->updateTexture();
+            if (texture->updateTexture())
+                n->renderer->markFrameDirty();
         }
 
         n->setTextureCoordinatesTransform(QSGSimpleTextureNode::MirrorVertically);
@@ -583,6 +585,87 @@ QQuick3DPickResult QQuick3DViewport::pick(float x, float y) const
     return QQuick3DPickResult();
 }
 
+/*!
+ * Returns all models under the view position \a x, \a y as a list of
+ * QQuick3DPickResult values, sorted from the nearest to the furthest.
+ *
+ * \sa pick pickRect
+ */
+QVariantList QQuick3DViewport::pickAll(float x, float y) const
+{
+    QVariantList results;
+    const QVector<QVector<QQuick3DPickResult>> hits = pickBatch(QVector<QPointF>() << QPointF(qreal(x), qreal(y)));
+    if (!hits.isEmpty()) {
+        for (const QQuick3DPickResult &hit : hits.first())
+            results.append(QVariant::fromValue(hit));
+    }
+    return results;
+}
+
+/*!
+ * Returns the models whose bounds are inside or intersect the part of the scene
+ * shown in the view rectangle \a x, \a y, \a width, \a height. This is meant for
+ * rubber band selection.
+ *
+ * \sa pickAll
+ */
+QVariantList QQuick3DViewport::pickRect(float x, float y, float width, float height) const
+{
+    QVariantList results;
+    QQuick3DSceneRenderer *renderer = getRenderer();
+    if (!renderer)
+        return results;
+
+    const qreal dpr = window()->effectiveDevicePixelRatio();
+    const QRectF rect(qreal(x) * dpr, qreal(y) * dpr, qreal(width) * dpr, qreal(height) * dpr);
+    for (QQuick3DModel *model : renderer->pickRect(rect))
+        results.append(QVariant::fromValue(model));
+    return results;
+}
+
+/*!
+ * Picks all view \a positions at once and returns the hits of each, sorted from
+ * the nearest to the furthest. This is much cheaper than calling pick() for every
+ * position, the scene is set up for picking only once and the positions are
+ * picked in parallel.
+ */
+QVector<QVector<QQuick3DPickResult>> QQuick3DViewport::pickBatch(const QVector<QPointF> &positions) const
+{
+    QQuick3DSceneRenderer *renderer = getRenderer();
+    if (!renderer)
+        return QVector<QVector<QQuick3DPickResult>>(positions.size());
+
+    const qreal dpr = window()->effectiveDevicePixelRatio();
+    QVector<QPointF> scaledPositions;
+    scaledPositions.reserve(positions.size());
+    for (const QPointF &position : positions)
+        scaledPositions.append(position * dpr);
+    return renderer->pickBatch(scaledPositions);
+}
+
+/*!
+ * Picks the rays starting at the scene positions \a origins in the scene
+ * \a directions, the same way as pickBatch() for view positions.
+ */
+QVector<QVector<QQuick3DPickResult>> QQuick3DViewport::pickBatch(const QVector<QVector3D> &origins, const QVector<QVector3D> &directions) const
+{
+    Q_ASSERT(origins.size() == directions.size());
+    QQuick3DSceneRenderer *renderer = getRenderer();
+    if (!renderer)
+        return QVector<QVector<QQuick3DPickResult>>(origins.size());
+
+    // The scene is left-handed, the renderer is right-handed
+    QVector<QSSGRenderRay> rays;
+    rays.reserve(origins.size());
+    for (int idx = 0, end = qMin(origins.size(), directions.size()); idx < end; ++idx) {
+        const QVector3D &origin = origins.at(idx);
+        const QVector3D &direction = directions.at(idx);
+        rays.append(QSSGRenderRay(QVector3D(origin.x(), origin.y(), -origin.z()),
+                                  QVector3D(direction.x(), direction.y(), -direction.z())));
+    }
+    return renderer->pickBatch(rays);
+}
+
 bool QQuick3DViewport::enableWireframeMode() const
 {
     return m_enableWireframeMode;
@@ -103,6 +103,10 @@ public:
     Q_INVOKABLE QVector3D viewToWorld(const QVector3D &viewPos) const;
 
     Q_INVOKABLE QQuick3DPickResult pick(float x, float y) const;
+    Q_INVOKABLE QVariantList pickAll(float x, float y) const;
+    Q_INVOKABLE QVariantList pickRect(float x, float y, float width, float height) const;
+    QVector<QVector<QQuick3DPickResult>> pickBatch(const QVector<QPointF> &positions) const;
+    QVector<QVector<QQuick3DPickResult>> pickBatch(const QVector<QVector3D> &origins, const QVector<QVector3D> &directions) const;
 
     bool enableWireframeMode() const;
 
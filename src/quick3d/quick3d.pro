@@ -10,6 +10,7 @@ SOURCES += \
     qquick3dcustommaterial.cpp \
     qquick3ddefaultmaterial.cpp \
     qquick3deffect.cpp \
+    qquick3dkeyframeanimation.cpp \
     qquick3dlight.cpp \
     qquick3dmaterial.cpp \
     qquick3dmodel.cpp \
@@ -32,6 +33,7 @@ HEADERS += \
     qquick3dcustommaterial_p.h \
     qquick3ddefaultmaterial_p.h \
     qquick3deffect_p.h \
+    qquick3dkeyframeanimation_p.h \
     qquick3dlight_p.h \
     qquick3dmaterial_p.h \
     qquick3dmodel_p.h \
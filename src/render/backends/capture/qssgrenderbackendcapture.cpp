@@ -0,0 +1,1826 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick3DRender/private/qssgrenderbackendcapture_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QVarLengthArray>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct CaptureFileHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 pointerSize;
+    quint32 reserved;
+};
+
+}
+
+constexpr quint32 QSSGRenderCaptureReader::Magic;
+constexpr quint32 QSSGRenderCaptureReader::Version;
+
+QSSGRenderBackendCapture::QSSGRenderBackendCapture(const QSSGRef<QSSGRenderBackend> &inTarget,
+                                                   const QString &inFileName,
+                                                   int inFrameCount)
+    : m_target(inTarget), m_file(inFileName), m_framesLeft(inFrameCount)
+{
+    Q_ASSERT(m_target);
+    if (m_framesLeft <= 0)
+        return;
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("Cannot open capture file %s: %s", qPrintable(inFileName), qPrintable(m_file.errorString()));
+        return;
+    }
+    const CaptureFileHeader header = { QSSGRenderCaptureReader::Magic, QSSGRenderCaptureReader::Version,
+                                       quint32(sizeof(void *)), 0 };
+    if (m_file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        qWarning("Cannot write capture file %s: %s", qPrintable(inFileName), qPrintable(m_file.errorString()));
+        m_file.close();
+        return;
+    }
+    m_capturing = true;
+}
+
+QSSGRenderBackendCapture::~QSSGRenderBackendCapture()
+{
+    // Keep a partially captured frame, it still contains resource creation
+    // later frames would depend on.
+    if (m_capturing && !m_commands.isEmpty())
+        m_commands.write(&m_file);
+    finish();
+}
+
+QSSGRef<QSSGRenderBackend> QSSGRenderBackendCapture::createFromEnvironment(const QSSGRef<QSSGRenderBackend> &inTarget)
+{
+    const QString fileName = qEnvironmentVariable("QUICK3D_CAPTURE_FILE");
+    if (fileName.isEmpty() || !inTarget)
+        return inTarget;
+    bool ok = false;
+    int frameCount = qEnvironmentVariableIntValue("QUICK3D_CAPTURE_FRAMES", &ok);
+    if (!ok)
+        frameCount = 100;
+    return QSSGRef<QSSGRenderBackend>(new QSSGRenderBackendCapture(inTarget, fileName, frameCount));
+}
+
+void QSSGRenderBackendCapture::finish()
+{
+    m_capturing = false;
+    m_commands.clear();
+    m_mappedRanges.clear();
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+void QSSGRenderBackendCapture::endFrame()
+{
+    if (m_capturing) {
+        if (!m_commands.write(&m_file)) {
+            qWarning("Cannot write capture file %s: %s", qPrintable(m_file.fileName()), qPrintable(m_file.errorString()));
+            finish();
+        } else if (--m_framesLeft == 0) {
+            finish();
+        } else {
+            m_commands.reset();
+        }
+    }
+    m_target->endFrame();
+}
+
+void QSSGRenderBackendCapture::resetStateCache()
+{
+    m_target->resetStateCache();
+}
+
+QSSGRenderContextType QSSGRenderBackendCapture::getRenderContextType() const
+{
+    return m_target->getRenderContextType();
+}
+
+const char *QSSGRenderBackendCapture::getShadingLanguageVersion()
+{
+    return m_target->getShadingLanguageVersion();
+}
+
+qint32 QSSGRenderBackendCapture::getMaxCombinedTextureUnits()
+{
+    return m_target->getMaxCombinedTextureUnits();
+}
+
+bool QSSGRenderBackendCapture::getRenderBackendCap(QSSGRenderBackendCaps inCap) const
+{
+    return m_target->getRenderBackendCap(inCap);
+}
+
+void QSSGRenderBackendCapture::getRenderBackendValue(QSSGRenderBackendQuery inQuery, qint32 *params) const
+{
+    m_target->getRenderBackendValue(inQuery, params);
+}
+
+qint32 QSSGRenderBackendCapture::getDepthBits() const
+{
+    return m_target->getDepthBits();
+}
+
+qint32 QSSGRenderBackendCapture::getStencilBits() const
+{
+    return m_target->getStencilBits();
+}
+
+void QSSGRenderBackendCapture::setRenderState(bool bEnable, const QSSGRenderState value)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetRenderState{ bEnable, value });
+    m_target->setRenderState(bEnable, value);
+}
+
+bool QSSGRenderBackendCapture::getRenderState(const QSSGRenderState value)
+{
+    return m_target->getRenderState(value);
+}
+
+QSSGRenderBoolOp QSSGRenderBackendCapture::getDepthFunc()
+{
+    return m_target->getDepthFunc();
+}
+
+QSSGRenderBackend::QSSGRenderBackendDepthStencilStateObject QSSGRenderBackendCapture::createDepthStencilState(
+        bool enableDepth,
+        bool depthMask,
+        QSSGRenderBoolOp depthFunc,
+        bool enableStencil,
+        QSSGRenderStencilFunction &stencilFuncFront,
+        QSSGRenderStencilFunction &stencilFuncBack,
+        QSSGRenderStencilOperation &depthStencilOpFront,
+        QSSGRenderStencilOperation &depthStencilOpBack)
+{
+    QSSGRenderBackendDepthStencilStateObject result = m_target->createDepthStencilState(enableDepth,
+                                                                                        depthMask,
+                                                                                        depthFunc,
+                                                                                        enableStencil,
+                                                                                        stencilFuncFront,
+                                                                                        stencilFuncBack,
+                                                                                        depthStencilOpFront,
+                                                                                        depthStencilOpBack);
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateDepthStencilState{ enableDepth, depthMask, depthFunc, enableStencil, stencilFuncFront, stencilFuncBack, depthStencilOpFront, depthStencilOpBack, result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseDepthStencilState{ depthStencilState });
+    m_target->releaseDepthStencilState(depthStencilState);
+}
+
+QSSGRenderBackend::QSSGRenderBackendRasterizerStateObject QSSGRenderBackendCapture::createRasterizerState(
+        float depthBias,
+        float depthScale,
+        QSSGRenderFace cullFace)
+{
+    QSSGRenderBackendRasterizerStateObject result = m_target->createRasterizerState(depthBias, depthScale, cullFace);
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateRasterizerState{ depthBias, depthScale, cullFace, result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseRasterizerState{ rasterizerState });
+    m_target->releaseRasterizerState(rasterizerState);
+}
+
+void QSSGRenderBackendCapture::setDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetDepthStencilState{ depthStencilState });
+    m_target->setDepthStencilState(depthStencilState);
+}
+
+void QSSGRenderBackendCapture::setRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetRasterizerState{ rasterizerState });
+    m_target->setRasterizerState(rasterizerState);
+}
+
+void QSSGRenderBackendCapture::setDepthFunc(const QSSGRenderBoolOp func)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetDepthFunc{ func });
+    m_target->setDepthFunc(func);
+}
+
+bool QSSGRenderBackendCapture::getDepthWrite()
+{
+    return m_target->getDepthWrite();
+}
+
+void QSSGRenderBackendCapture::setDepthWrite(bool bEnable)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetDepthWrite{ bEnable });
+    m_target->setDepthWrite(bEnable);
+}
+
+void QSSGRenderBackendCapture::setColorWrites(bool bRed, bool bGreen, bool bBlue, bool bAlpha)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetColorWrites{ bRed, bGreen, bBlue, bAlpha });
+    m_target->setColorWrites(bRed, bGreen, bBlue, bAlpha);
+}
+
+void QSSGRenderBackendCapture::setMultisample(bool bEnable)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetMultisample{ bEnable });
+    m_target->setMultisample(bEnable);
+}
+
+void QSSGRenderBackendCapture::getBlendFunc(QSSGRenderBlendFunctionArgument *pBlendFuncArg)
+{
+    m_target->getBlendFunc(pBlendFuncArg);
+}
+
+void QSSGRenderBackendCapture::setBlendFunc(const QSSGRenderBlendFunctionArgument &blendFuncArg)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetBlendFunc{ blendFuncArg });
+    m_target->setBlendFunc(blendFuncArg);
+}
+
+void QSSGRenderBackendCapture::setBlendEquation(const QSSGRenderBlendEquationArgument &pBlendEquArg)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetBlendEquation{ pBlendEquArg });
+    m_target->setBlendEquation(pBlendEquArg);
+}
+
+void QSSGRenderBackendCapture::setBlendBarrier()
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetBlendBarrier{  });
+    m_target->setBlendBarrier();
+}
+
+void QSSGRenderBackendCapture::getScissorRect(QRect *pRect)
+{
+    m_target->getScissorRect(pRect);
+}
+
+void QSSGRenderBackendCapture::setScissorRect(const QRect &rect)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetScissorRect{ rect });
+    m_target->setScissorRect(rect);
+}
+
+void QSSGRenderBackendCapture::getViewportRect(QRect *pRect)
+{
+    m_target->getViewportRect(pRect);
+}
+
+void QSSGRenderBackendCapture::setViewportRect(const QRect &rect)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetViewportRect{ rect });
+    m_target->setViewportRect(rect);
+}
+
+void QSSGRenderBackendCapture::setClearColor(const QVector4D *pClearColor)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetClearColor{ *pClearColor });
+    m_target->setClearColor(pClearColor);
+}
+
+void QSSGRenderBackendCapture::clear(QSSGRenderClearFlags flags)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::Clear{ flags });
+    m_target->clear(flags);
+}
+
+QSSGRenderBackend::QSSGRenderBackendBufferObject QSSGRenderBackendCapture::createBuffer(QSSGRenderBufferType bindFlags,
+                                                                                        QSSGRenderBufferUsageType usage,
+                                                                                        QSSGByteView hostData)
+{
+    QSSGRenderBackendBufferObject result = m_target->createBuffer(bindFlags, usage, hostData);
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateBuffer{ bindFlags, usage, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::bindBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::BindBuffer{ bo, bindFlags });
+    m_target->bindBuffer(bo, bindFlags);
+}
+
+void QSSGRenderBackendCapture::releaseBuffer(QSSGRenderBackendBufferObject bo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseBuffer{ bo });
+    m_target->releaseBuffer(bo);
+}
+
+void QSSGRenderBackendCapture::updateBuffer(QSSGRenderBackendBufferObject bo,
+                                            QSSGRenderBufferType bindFlags,
+                                            QSSGRenderBufferUsageType usage,
+                                            QSSGByteView data)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(data.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::UpdateBuffer{ bo, bindFlags, usage, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), data.begin(), size);
+    }
+    m_target->updateBuffer(bo, bindFlags, usage, data);
+}
+
+void QSSGRenderBackendCapture::updateBufferRange(QSSGRenderBackendBufferObject bo,
+                                                 QSSGRenderBufferType bindFlags,
+                                                 size_t offset,
+                                                 QSSGByteView data)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(data.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::UpdateBufferRange{ bo, bindFlags, offset, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), data.begin(), size);
+    }
+    m_target->updateBufferRange(bo, bindFlags, offset, data);
+}
+
+void *QSSGRenderBackendCapture::mapBuffer(QSSGRenderBackendBufferObject bo,
+                                          QSSGRenderBufferType bindFlags,
+                                          size_t offset,
+                                          size_t length,
+                                          QSSGRenderBufferAccessFlags accessFlags)
+{
+    void *result = m_target->mapBuffer(bo, bindFlags, offset, length, accessFlags);
+    if (m_capturing && result && (accessFlags & QSSGRenderBufferAccessTypeValues::Write))
+        m_mappedRanges.append({ bo, bindFlags, offset, length, accessFlags, result });
+    return result;
+}
+
+bool QSSGRenderBackendCapture::unmapBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags)
+{
+    if (m_capturing) {
+        // Capture what was written to the mapped range
+        for (int i = 0, end = m_mappedRanges.size(); i < end; ++i) {
+            const MappedRange &range = m_mappedRanges.at(i);
+            if (range.bo != bo || range.bindFlags != bindFlags)
+                continue;
+            const quint32 size = quint32(range.length);
+            auto *cmd = m_commands.append(QSSGRenderCommands::MapBuffer{ bo, bindFlags, range.offset, size, range.accessFlags }, size);
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), range.data, size);
+            m_mappedRanges.remove(i);
+            break;
+        }
+    }
+    return m_target->unmapBuffer(bo, bindFlags);
+}
+
+void QSSGRenderBackendCapture::setMemoryBarrier(QSSGRenderBufferBarrierFlags barriers)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetMemoryBarrier{ barriers });
+    m_target->setMemoryBarrier(barriers);
+}
+
+QSSGRenderBackend::QSSGRenderBackendQueryObject QSSGRenderBackendCapture::createQuery()
+{
+    QSSGRenderBackendQueryObject result = m_target->createQuery();
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateQuery{ result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseQuery(QSSGRenderBackendQueryObject qo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseQuery{ qo });
+    m_target->releaseQuery(qo);
+}
+
+void QSSGRenderBackendCapture::beginQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::BeginQuery{ qo, type });
+    m_target->beginQuery(qo, type);
+}
+
+void QSSGRenderBackendCapture::endQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::EndQuery{ qo, type });
+    m_target->endQuery(qo, type);
+}
+
+void QSSGRenderBackendCapture::getQueryResult(QSSGRenderBackendQueryObject qo,
+                                              QSSGRenderQueryResultType resultType,
+                                              quint32 *params)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::GetQueryResult{ qo, resultType, false });
+    m_target->getQueryResult(qo, resultType, params);
+}
+
+void QSSGRenderBackendCapture::getQueryResult(QSSGRenderBackendQueryObject qo,
+                                              QSSGRenderQueryResultType resultType,
+                                              quint64 *params)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::GetQueryResult{ qo, resultType, true });
+    m_target->getQueryResult(qo, resultType, params);
+}
+
+void QSSGRenderBackendCapture::setQueryTimer(QSSGRenderBackendQueryObject qo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetQueryTimer{ qo });
+    m_target->setQueryTimer(qo);
+}
+
+QSSGRenderBackend::QSSGRenderBackendSyncObject QSSGRenderBackendCapture::createSync(QSSGRenderSyncType tpye,
+                                                                                    QSSGRenderSyncFlags syncFlags)
+{
+    QSSGRenderBackendSyncObject result = m_target->createSync(tpye, syncFlags);
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateSync{ tpye, syncFlags, result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseSync(QSSGRenderBackendSyncObject so)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseSync{ so });
+    m_target->releaseSync(so);
+}
+
+void QSSGRenderBackendCapture::waitSync(QSSGRenderBackendSyncObject so,
+                                        QSSGRenderCommandFlushFlags syncFlags,
+                                        quint64 timeout)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::WaitSync{ so, syncFlags, timeout });
+    m_target->waitSync(so, syncFlags, timeout);
+}
+
+bool QSSGRenderBackendCapture::isSyncSignaled(QSSGRenderBackendSyncObject so)
+{
+    // Polling does not change any state, nothing to record
+    return m_target->isSyncSignaled(so);
+}
+
+QSSGRenderBackend::QSSGRenderBackendRenderTargetObject QSSGRenderBackendCapture::createRenderTarget()
+{
+    QSSGRenderBackendRenderTargetObject result = m_target->createRenderTarget();
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateRenderTarget{ result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseRenderTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseRenderTarget{ rto });
+    m_target->releaseRenderTarget(rto);
+}
+
+void QSSGRenderBackendCapture::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                  QSSGRenderFrameBufferAttachment attachment,
+                                                  QSSGRenderBackendRenderbufferObject rbo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::RenderTargetAttachRenderbuffer{ rto, attachment, rbo });
+    m_target->renderTargetAttach(rto, attachment, rbo);
+}
+
+void QSSGRenderBackendCapture::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                  QSSGRenderFrameBufferAttachment attachment,
+                                                  QSSGRenderBackendTextureObject to,
+                                                  QSSGRenderTextureTargetType target)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::RenderTargetAttachTexture{ rto, attachment, to, target });
+    m_target->renderTargetAttach(rto, attachment, to, target);
+}
+
+void QSSGRenderBackendCapture::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                  QSSGRenderFrameBufferAttachment attachment,
+                                                  QSSGRenderBackendTextureObject to,
+                                                  qint32 level,
+                                                  qint32 layer)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::RenderTargetAttachTextureLayer{ rto, attachment, to, level, layer });
+    m_target->renderTargetAttach(rto, attachment, to, level, layer);
+}
+
+void QSSGRenderBackendCapture::setRenderTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetRenderTarget{ rto });
+    m_target->setRenderTarget(rto);
+}
+
+bool QSSGRenderBackendCapture::renderTargetIsValid(QSSGRenderBackendRenderTargetObject rto)
+{
+    return m_target->renderTargetIsValid(rto);
+}
+
+void QSSGRenderBackendCapture::setReadTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetReadTarget{ rto });
+    m_target->setReadTarget(rto);
+}
+
+void QSSGRenderBackendCapture::setDrawBuffers(QSSGRenderBackendRenderTargetObject rto,
+                                              QSSGDataView<qint32> inDrawBufferSet)
+{
+    if (m_capturing) {
+        const quint32 count = quint32(inDrawBufferSet.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetDrawBuffers{ rto, count }, count * sizeof(qint32));
+        if (count)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), inDrawBufferSet.begin(), count * sizeof(qint32));
+    }
+    m_target->setDrawBuffers(rto, inDrawBufferSet);
+}
+
+void QSSGRenderBackendCapture::setReadBuffer(QSSGRenderBackendRenderTargetObject rto, QSSGReadFace inReadFace)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetReadBuffer{ rto, inReadFace });
+    m_target->setReadBuffer(rto, inReadFace);
+}
+
+void QSSGRenderBackendCapture::blitFramebuffer(qint32 srcX0,
+                                               qint32 srcY0,
+                                               qint32 srcX1,
+                                               qint32 srcY1,
+                                               qint32 dstX0,
+                                               qint32 dstY0,
+                                               qint32 dstX1,
+                                               qint32 dstY1,
+                                               QSSGRenderClearFlags flags,
+                                               QSSGRenderTextureMagnifyingOp filter)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::BlitFramebuffer{ srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, flags, filter });
+    m_target->blitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, flags, filter);
+}
+
+QSSGRenderBackend::QSSGRenderBackendRenderbufferObject QSSGRenderBackendCapture::createRenderbuffer(
+        QSSGRenderRenderBufferFormat storageFormat,
+        qint32 width,
+        qint32 height)
+{
+    QSSGRenderBackendRenderbufferObject result = m_target->createRenderbuffer(storageFormat, width, height);
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateRenderbuffer{ storageFormat, width, height, result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseRenderbuffer(QSSGRenderBackendRenderbufferObject rbo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseRenderbuffer{ rbo });
+    m_target->releaseRenderbuffer(rbo);
+}
+
+bool QSSGRenderBackendCapture::resizeRenderbuffer(QSSGRenderBackendRenderbufferObject rbo,
+                                                  QSSGRenderRenderBufferFormat storageFormat,
+                                                  qint32 width,
+                                                  qint32 height)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ResizeRenderbuffer{ rbo, storageFormat, width, height });
+    return m_target->resizeRenderbuffer(rbo, storageFormat, width, height);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTextureObject QSSGRenderBackendCapture::createTexture()
+{
+    QSSGRenderBackendTextureObject result = m_target->createTexture();
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateTexture{ result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::setTextureData2D(QSSGRenderBackendTextureObject to,
+                                                QSSGRenderTextureTargetType target,
+                                                qint32 level,
+                                                QSSGRenderTextureFormat internalFormat,
+                                                qint32 width,
+                                                qint32 height,
+                                                qint32 border,
+                                                QSSGRenderTextureFormat format,
+                                                QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetTextureData2D{ to, target, level, internalFormat, width, height, border, format, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setTextureData2D(to, target, level, internalFormat, width, height, border, format, hostData);
+}
+
+void QSSGRenderBackendCapture::setTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                                      QSSGRenderTextureTargetType target,
+                                                      qint32 level,
+                                                      QSSGRenderTextureFormat internalFormat,
+                                                      qint32 width,
+                                                      qint32 height,
+                                                      qint32 border,
+                                                      QSSGRenderTextureFormat format,
+                                                      QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetTextureDataCubeFace{ to, target, level, internalFormat, width, height, border, format, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setTextureDataCubeFace(to, target, level, internalFormat, width, height, border, format, hostData);
+}
+
+void QSSGRenderBackendCapture::createTextureStorage2D(QSSGRenderBackendTextureObject to,
+                                                      QSSGRenderTextureTargetType target,
+                                                      qint32 levels,
+                                                      QSSGRenderTextureFormat internalFormat,
+                                                      qint32 width,
+                                                      qint32 height)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateTextureStorage2D{ to, target, levels, internalFormat, width, height });
+    m_target->createTextureStorage2D(to, target, levels, internalFormat, width, height);
+}
+
+void QSSGRenderBackendCapture::setTextureSubData2D(QSSGRenderBackendTextureObject to,
+                                                   QSSGRenderTextureTargetType target,
+                                                   qint32 level,
+                                                   qint32 xOffset,
+                                                   qint32 yOffset,
+                                                   qint32 width,
+                                                   qint32 height,
+                                                   QSSGRenderTextureFormat format,
+                                                   QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetTextureSubData2D{ to, target, level, xOffset, yOffset, width, height, format, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setTextureSubData2D(to, target, level, xOffset, yOffset, width, height, format, hostData);
+}
+
+void QSSGRenderBackendCapture::setCompressedTextureData2D(QSSGRenderBackendTextureObject to,
+                                                          QSSGRenderTextureTargetType target,
+                                                          qint32 level,
+                                                          QSSGRenderTextureFormat internalFormat,
+                                                          qint32 width,
+                                                          qint32 height,
+                                                          qint32 border,
+                                                          QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetCompressedTextureData2D{ to, target, level, internalFormat, width, height, border, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setCompressedTextureData2D(to, target, level, internalFormat, width, height, border, hostData);
+}
+
+void QSSGRenderBackendCapture::setCompressedTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                                                QSSGRenderTextureTargetType target,
+                                                                qint32 level,
+                                                                QSSGRenderTextureFormat internalFormat,
+                                                                qint32 width,
+                                                                qint32 height,
+                                                                qint32 border,
+                                                                QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetCompressedTextureDataCubeFace{ to, target, level, internalFormat, width, height, border, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setCompressedTextureDataCubeFace(to, target, level, internalFormat, width, height, border, hostData);
+}
+
+void QSSGRenderBackendCapture::setCompressedTextureSubData2D(QSSGRenderBackendTextureObject to,
+                                                             QSSGRenderTextureTargetType target,
+                                                             qint32 level,
+                                                             qint32 xOffset,
+                                                             qint32 yOffset,
+                                                             qint32 width,
+                                                             qint32 height,
+                                                             QSSGRenderTextureFormat format,
+                                                             QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetCompressedTextureSubData2D{ to, target, level, xOffset, yOffset, width, height, format, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setCompressedTextureSubData2D(to, target, level, xOffset, yOffset, width, height, format, hostData);
+}
+
+void QSSGRenderBackendCapture::setMultisampledTextureData2D(QSSGRenderBackendTextureObject to,
+                                                            QSSGRenderTextureTargetType target,
+                                                            qint32 samples,
+                                                            QSSGRenderTextureFormat internalFormat,
+                                                            qint32 width,
+                                                            qint32 height,
+                                                            bool fixedsamplelocations)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetMultisampledTextureData2D{ to, target, samples, internalFormat, width, height, fixedsamplelocations });
+    m_target->setMultisampledTextureData2D(to, target, samples, internalFormat, width, height, fixedsamplelocations);
+}
+
+void QSSGRenderBackendCapture::setTextureData3D(QSSGRenderBackendTextureObject to,
+                                                QSSGRenderTextureTargetType target,
+                                                qint32 level,
+                                                QSSGRenderTextureFormat internalFormat,
+                                                qint32 width,
+                                                qint32 height,
+                                                qint32 depth,
+                                                qint32 border,
+                                                QSSGRenderTextureFormat format,
+                                                QSSGByteView hostData)
+{
+    if (m_capturing) {
+        const quint32 size = quint32(hostData.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetTextureData3D{ to, target, level, internalFormat, width, height, depth, border, format, size }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), hostData.begin(), size);
+    }
+    m_target->setTextureData3D(to, target, level, internalFormat, width, height, depth, border, format, hostData);
+}
+
+void QSSGRenderBackendCapture::generateMipMaps(QSSGRenderBackendTextureObject to,
+                                               QSSGRenderTextureTargetType target,
+                                               QSSGRenderHint genType)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::GenerateMipMaps{ to, target, genType });
+    m_target->generateMipMaps(to, target, genType);
+}
+
+void QSSGRenderBackendCapture::bindTexture(QSSGRenderBackendTextureObject to,
+                                           QSSGRenderTextureTargetType target,
+                                           qint32 unit)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::BindTexture{ to, target, unit });
+    m_target->bindTexture(to, target, unit);
+}
+
+void QSSGRenderBackendCapture::bindImageTexture(QSSGRenderBackendTextureObject to,
+                                                quint32 unit,
+                                                qint32 level,
+                                                bool layered,
+                                                qint32 layer,
+                                                QSSGRenderImageAccessType accessFlags,
+                                                QSSGRenderTextureFormat format)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::BindImageTexture{ to, unit, level, layered, layer, accessFlags, format });
+    m_target->bindImageTexture(to, unit, level, layered, layer, accessFlags, format);
+}
+
+void QSSGRenderBackendCapture::releaseTexture(QSSGRenderBackendTextureObject to)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseTexture{ to });
+    m_target->releaseTexture(to);
+}
+
+QSSGRenderTextureSwizzleMode QSSGRenderBackendCapture::getTextureSwizzleMode(
+        const QSSGRenderTextureFormat inFormat) const
+{
+    return m_target->getTextureSwizzleMode(inFormat);
+}
+
+QSSGRenderBackend::QSSGRenderBackendSamplerObject QSSGRenderBackendCapture::createSampler(
+        QSSGRenderTextureMinifyingOp minFilter,
+        QSSGRenderTextureMagnifyingOp magFilter,
+        QSSGRenderTextureCoordOp wrapS,
+        QSSGRenderTextureCoordOp wrapT,
+        QSSGRenderTextureCoordOp wrapR,
+        qint32 minLod,
+        qint32 maxLod,
+        float lodBias,
+        QSSGRenderTextureCompareMode compareMode,
+        QSSGRenderTextureCompareOp compareFunc,
+        float anisotropy,
+        float *borderColor)
+{
+    QSSGRenderBackendSamplerObject result = m_target->createSampler(minFilter,
+                                                                    magFilter,
+                                                                    wrapS,
+                                                                    wrapT,
+                                                                    wrapR,
+                                                                    minLod,
+                                                                    maxLod,
+                                                                    lodBias,
+                                                                    compareMode,
+                                                                    compareFunc,
+                                                                    anisotropy,
+                                                                    borderColor);
+    if (m_capturing) {
+        QSSGRenderCommands::CreateSampler cmd{ minFilter, magFilter, wrapS, wrapT, wrapR,
+                                               minLod, maxLod, lodBias, compareMode, compareFunc, anisotropy,
+                                               borderColor != nullptr, { 0.0f, 0.0f, 0.0f, 0.0f }, result };
+        if (borderColor)
+            ::memcpy(cmd.borderColor, borderColor, sizeof(cmd.borderColor));
+        m_commands.append(cmd);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::updateSampler(QSSGRenderBackendSamplerObject so,
+                                             QSSGRenderTextureTargetType target,
+                                             QSSGRenderTextureMinifyingOp minFilter,
+                                             QSSGRenderTextureMagnifyingOp magFilter,
+                                             QSSGRenderTextureCoordOp wrapS,
+                                             QSSGRenderTextureCoordOp wrapT,
+                                             QSSGRenderTextureCoordOp wrapR,
+                                             float minLod,
+                                             float maxLod,
+                                             float lodBias,
+                                             QSSGRenderTextureCompareMode compareMode,
+                                             QSSGRenderTextureCompareOp compareFunc,
+                                             float anisotropy,
+                                             float *borderColor)
+{
+    if (m_capturing) {
+        QSSGRenderCommands::UpdateSampler cmd{ so, target, minFilter, magFilter, wrapS, wrapT, wrapR,
+                                               minLod, maxLod, lodBias, compareMode, compareFunc, anisotropy,
+                                               borderColor != nullptr, { 0.0f, 0.0f, 0.0f, 0.0f } };
+        if (borderColor)
+            ::memcpy(cmd.borderColor, borderColor, sizeof(cmd.borderColor));
+        m_commands.append(cmd);
+    }
+    m_target->updateSampler(so,
+                            target,
+                            minFilter,
+                            magFilter,
+                            wrapS,
+                            wrapT,
+                            wrapR,
+                            minLod,
+                            maxLod,
+                            lodBias,
+                            compareMode,
+                            compareFunc,
+                            anisotropy,
+                            borderColor);
+}
+
+void QSSGRenderBackendCapture::updateTextureSwizzle(QSSGRenderBackendTextureObject to,
+                                                    QSSGRenderTextureTargetType target,
+                                                    QSSGRenderTextureSwizzleMode swizzleMode)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::UpdateTextureSwizzle{ to, target, swizzleMode });
+    m_target->updateTextureSwizzle(to, target, swizzleMode);
+}
+
+void QSSGRenderBackendCapture::updateTextureObject(QSSGRenderBackendTextureObject to,
+                                                   QSSGRenderTextureTargetType target,
+                                                   qint32 baseLevel,
+                                                   qint32 maxLevel)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::UpdateTextureObject{ to, target, baseLevel, maxLevel });
+    m_target->updateTextureObject(to, target, baseLevel, maxLevel);
+}
+
+void QSSGRenderBackendCapture::releaseSampler(QSSGRenderBackendSamplerObject so)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseSampler{ so });
+    m_target->releaseSampler(so);
+}
+
+QSSGRenderBackend::QSSGRenderBackendAttribLayoutObject QSSGRenderBackendCapture::createAttribLayout(
+        QSSGDataView<QSSGRenderVertexBufferEntry> attribs)
+{
+    QSSGRenderBackendAttribLayoutObject result = m_target->createAttribLayout(attribs);
+    if (m_capturing) {
+        const quint32 count = quint32(attribs.size());
+        QVarLengthArray<QSSGRenderCommands::AttribEntry, 16> entries;
+        QByteArray names;
+        for (const QSSGRenderVertexBufferEntry &attrib : attribs) {
+            entries.append({ quint32(names.size()), attrib.m_componentType, attrib.m_numComponents,
+                             attrib.m_firstItemOffset, attrib.m_inputSlot });
+            names.append(attrib.m_name).append('\0');
+        }
+        const quint32 entrySize = count * sizeof(QSSGRenderCommands::AttribEntry);
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateAttribLayout{ count, result }, entrySize + quint32(names.size()));
+        quint8 *data = QSSGRenderCommandList::extraData(cmd);
+        ::memcpy(data, entries.constData(), entrySize);
+        ::memcpy(data + entrySize, names.constData(), size_t(names.size()));
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseAttribLayout(QSSGRenderBackendAttribLayoutObject ao)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseAttribLayout{ ao });
+    m_target->releaseAttribLayout(ao);
+}
+
+QSSGRenderBackend::QSSGRenderBackendInputAssemblerObject QSSGRenderBackendCapture::createInputAssembler(
+        QSSGRenderBackendAttribLayoutObject attribLayout,
+        QSSGDataView<QSSGRenderBackendBufferObject> buffers,
+        const QSSGRenderBackendBufferObject indexBuffer,
+        QSSGDataView<quint32> strides,
+        QSSGDataView<quint32> offsets,
+        quint32 patchVertexCount)
+{
+    QSSGRenderBackendInputAssemblerObject result = m_target->createInputAssembler(attribLayout,
+                                                                                  buffers,
+                                                                                  indexBuffer,
+                                                                                  strides,
+                                                                                  offsets,
+                                                                                  patchVertexCount);
+    if (m_capturing) {
+        const quint32 bufferCount = quint32(buffers.size());
+        const quint32 strideCount = quint32(strides.size());
+        const quint32 offsetCount = quint32(offsets.size());
+        const quint32 bufferSize = bufferCount * sizeof(QSSGRenderBackendBufferObject);
+        const quint32 size = bufferSize + (strideCount + offsetCount) * sizeof(quint32);
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateInputAssembler{ attribLayout, indexBuffer,
+                                                                                bufferCount, strideCount, offsetCount,
+                                                                                patchVertexCount, result },
+                                      size);
+        quint8 *data = QSSGRenderCommandList::extraData(cmd);
+        if (bufferCount)
+            ::memcpy(data, buffers.begin(), bufferSize);
+        if (strideCount)
+            ::memcpy(data + bufferSize, strides.begin(), strideCount * sizeof(quint32));
+        if (offsetCount)
+            ::memcpy(data + bufferSize + strideCount * sizeof(quint32), offsets.begin(), offsetCount * sizeof(quint32));
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseInputAssembler(QSSGRenderBackendInputAssemblerObject iao)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseInputAssembler{ iao });
+    m_target->releaseInputAssembler(iao);
+}
+
+bool QSSGRenderBackendCapture::setInputAssembler(QSSGRenderBackendInputAssemblerObject iao,
+                                                 QSSGRenderBackendShaderProgramObject po)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetInputAssembler{ iao, po });
+    return m_target->setInputAssembler(iao, po);
+}
+
+void QSSGRenderBackendCapture::setPatchVertexCount(QSSGRenderBackendInputAssemblerObject iao, quint32 count)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetPatchVertexCount{ iao, count });
+    m_target->setPatchVertexCount(iao, count);
+}
+
+QSSGRenderBackend::QSSGRenderBackendVertexShaderObject QSSGRenderBackendCapture::createVertexShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendVertexShaderObject result = m_target->createVertexShader(source, errorMessage, binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::Vertex, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseVertexShader(QSSGRenderBackendVertexShaderObject vso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::Vertex, vso });
+    m_target->releaseVertexShader(vso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendFragmentShaderObject QSSGRenderBackendCapture::createFragmentShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendFragmentShaderObject result = m_target->createFragmentShader(source, errorMessage, binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::Fragment, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseFragmentShader(QSSGRenderBackendFragmentShaderObject fso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::Fragment, fso });
+    m_target->releaseFragmentShader(fso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTessControlShaderObject QSSGRenderBackendCapture::createTessControlShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendTessControlShaderObject result = m_target->createTessControlShader(source, errorMessage, binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::TessControl, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseTessControlShader(QSSGRenderBackendTessControlShaderObject tcso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::TessControl, tcso });
+    m_target->releaseTessControlShader(tcso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTessEvaluationShaderObject QSSGRenderBackendCapture::createTessEvaluationShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendTessEvaluationShaderObject result = m_target->createTessEvaluationShader(source,
+                                                                                              errorMessage,
+                                                                                              binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::TessEvaluation, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseTessEvaluationShader(QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::TessEvaluation, teso });
+    m_target->releaseTessEvaluationShader(teso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendGeometryShaderObject QSSGRenderBackendCapture::createGeometryShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendGeometryShaderObject result = m_target->createGeometryShader(source, errorMessage, binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::Geometry, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseGeometryShader(QSSGRenderBackendGeometryShaderObject gso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::Geometry, gso });
+    m_target->releaseGeometryShader(gso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendComputeShaderObject QSSGRenderBackendCapture::createComputeShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    QSSGRenderBackendComputeShaderObject result = m_target->createComputeShader(source, errorMessage, binary);
+    if (m_capturing) {
+        const quint32 size = quint32(source.size());
+        auto *cmd = m_commands.append(QSSGRenderCommands::CreateShader{ QSSGRenderCommands::ShaderStage::Compute, binary, size, result }, size);
+        if (size)
+            ::memcpy(QSSGRenderCommandList::extraData(cmd), source.begin(), size);
+    }
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseComputeShader(QSSGRenderBackendComputeShaderObject cso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShader{ QSSGRenderCommands::ShaderStage::Compute, cso });
+    m_target->releaseComputeShader(cso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendVertexShaderObject vso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::Vertex, vso });
+    m_target->attachShader(po, vso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendVertexShaderObject vso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::Vertex, vso });
+    m_target->detachShader(po, vso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendFragmentShaderObject fso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::Fragment, fso });
+    m_target->attachShader(po, fso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendFragmentShaderObject fso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::Fragment, fso });
+    m_target->detachShader(po, fso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendTessControlShaderObject tcso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::TessControl, tcso });
+    m_target->attachShader(po, tcso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendTessControlShaderObject tcso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::TessControl, tcso });
+    m_target->detachShader(po, tcso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::TessEvaluation, teso });
+    m_target->attachShader(po, teso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::TessEvaluation, teso });
+    m_target->detachShader(po, teso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendGeometryShaderObject gso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::Geometry, gso });
+    m_target->attachShader(po, gso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendGeometryShaderObject gso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::Geometry, gso });
+    m_target->detachShader(po, gso);
+}
+
+void QSSGRenderBackendCapture::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendComputeShaderObject cso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::AttachShader{ po, QSSGRenderCommands::ShaderStage::Compute, cso });
+    m_target->attachShader(po, cso);
+}
+
+void QSSGRenderBackendCapture::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                            QSSGRenderBackendComputeShaderObject cso)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DetachShader{ po, QSSGRenderCommands::ShaderStage::Compute, cso });
+    m_target->detachShader(po, cso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendShaderProgramObject QSSGRenderBackendCapture::createShaderProgram(bool isSeparable)
+{
+    QSSGRenderBackendShaderProgramObject result = m_target->createShaderProgram(isSeparable);
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateShaderProgram{ isSeparable, result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseShaderProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseShaderProgram{ po });
+    m_target->releaseShaderProgram(po);
+}
+
+bool QSSGRenderBackendCapture::linkProgram(QSSGRenderBackendShaderProgramObject po, QByteArray &errorMessage)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::LinkProgram{ po });
+    return m_target->linkProgram(po, errorMessage);
+}
+
+void QSSGRenderBackendCapture::startLinkProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    // Replayed as a plain link. The linkProgram call finishing it is recorded
+    // as well, linking the program a second time on replay is harmless.
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::LinkProgram{ po });
+    m_target->startLinkProgram(po);
+}
+
+bool QSSGRenderBackendCapture::isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->isProgramLinkComplete(po);
+}
+
+void QSSGRenderBackendCapture::setActiveProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetActiveProgram{ po });
+    m_target->setActiveProgram(po);
+}
+
+QSSGRenderBackend::QSSGRenderBackendProgramPipeline QSSGRenderBackendCapture::createProgramPipeline()
+{
+    QSSGRenderBackendProgramPipeline result = m_target->createProgramPipeline();
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::CreateProgramPipeline{ result });
+    return result;
+}
+
+void QSSGRenderBackendCapture::releaseProgramPipeline(QSSGRenderBackendProgramPipeline ppo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReleaseProgramPipeline{ ppo });
+    m_target->releaseProgramPipeline(ppo);
+}
+
+void QSSGRenderBackendCapture::setActiveProgramPipeline(QSSGRenderBackendProgramPipeline ppo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetActiveProgramPipeline{ ppo });
+    m_target->setActiveProgramPipeline(ppo);
+}
+
+void QSSGRenderBackendCapture::setProgramStages(QSSGRenderBackendProgramPipeline ppo,
+                                                QSSGRenderShaderTypeFlags flags,
+                                                QSSGRenderBackendShaderProgramObject po)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::SetProgramStages{ ppo, flags, po });
+    m_target->setProgramStages(ppo, flags, po);
+}
+
+void QSSGRenderBackendCapture::dispatchCompute(QSSGRenderBackendShaderProgramObject po,
+                                               quint32 numGroupsX,
+                                               quint32 numGroupsY,
+                                               quint32 numGroupsZ)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DispatchCompute{ po, numGroupsX, numGroupsY, numGroupsZ });
+    m_target->dispatchCompute(po, numGroupsX, numGroupsY, numGroupsZ);
+}
+
+qint32 QSSGRenderBackendCapture::getConstantCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getConstantCount(po);
+}
+
+qint32 QSSGRenderBackendCapture::getConstantBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getConstantBufferCount(po);
+}
+
+qint32 QSSGRenderBackendCapture::getConstantInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                     quint32 id,
+                                                     quint32 bufSize,
+                                                     qint32 *numElem,
+                                                     QSSGRenderShaderDataType *type,
+                                                     qint32 *binding,
+                                                     char *nameBuf)
+{
+    return m_target->getConstantInfoByID(po, id, bufSize, numElem, type, binding, nameBuf);
+}
+
+qint32 QSSGRenderBackendCapture::getConstantBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                           quint32 id,
+                                                           quint32 nameBufSize,
+                                                           qint32 *paramCount,
+                                                           qint32 *bufferSize,
+                                                           qint32 *length,
+                                                           char *nameBuf)
+{
+    return m_target->getConstantBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendCapture::getConstantBufferParamIndices(QSSGRenderBackendShaderProgramObject po,
+                                                             quint32 id,
+                                                             qint32 *indices)
+{
+    m_target->getConstantBufferParamIndices(po, id, indices);
+}
+
+void QSSGRenderBackendCapture::getConstantBufferParamInfoByIndices(QSSGRenderBackendShaderProgramObject po,
+                                                                   quint32 count,
+                                                                   quint32 *indices,
+                                                                   QSSGRenderShaderDataType *type,
+                                                                   qint32 *size,
+                                                                   qint32 *offset)
+{
+    m_target->getConstantBufferParamInfoByIndices(po, count, indices, type, size, offset);
+}
+
+void QSSGRenderBackendCapture::programSetConstantBlock(QSSGRenderBackendShaderProgramObject po,
+                                                       quint32 blockIndex,
+                                                       quint32 binding)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ProgramSetConstantBlock{ po, blockIndex, binding });
+    m_target->programSetConstantBlock(po, blockIndex, binding);
+}
+
+void QSSGRenderBackendCapture::programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ProgramSetConstantBuffer{ index, bo });
+    m_target->programSetConstantBuffer(index, bo);
+}
+
+void QSSGRenderBackendCapture::programSetConstantBufferRange(quint32 index,
+                                                            QSSGRenderBackendBufferObject bo,
+                                                            quint32 offset,
+                                                            quint32 size)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ProgramSetConstantBufferRange{ index, bo, offset, size });
+    m_target->programSetConstantBufferRange(index, bo, offset, size);
+}
+
+qint32 QSSGRenderBackendCapture::getStorageBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getStorageBufferCount(po);
+}
+
+qint32 QSSGRenderBackendCapture::getStorageBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                          quint32 id,
+                                                          quint32 nameBufSize,
+                                                          qint32 *paramCount,
+                                                          qint32 *bufferSize,
+                                                          qint32 *length,
+                                                          char *nameBuf)
+{
+    return m_target->getStorageBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendCapture::programSetStorageBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ProgramSetStorageBuffer{ index, bo });
+    m_target->programSetStorageBuffer(index, bo);
+}
+
+qint32 QSSGRenderBackendCapture::getAtomicCounterBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getAtomicCounterBufferCount(po);
+}
+
+qint32 QSSGRenderBackendCapture::getAtomicCounterBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                                quint32 id,
+                                                                quint32 nameBufSize,
+                                                                qint32 *paramCount,
+                                                                qint32 *bufferSize,
+                                                                qint32 *length,
+                                                                char *nameBuf)
+{
+    return m_target->getAtomicCounterBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendCapture::programSetAtomicCounterBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ProgramSetAtomicCounterBuffer{ index, bo });
+    m_target->programSetAtomicCounterBuffer(index, bo);
+}
+
+void QSSGRenderBackendCapture::setConstantValue(QSSGRenderBackendShaderProgramObject po,
+                                                quint32 id,
+                                                QSSGRenderShaderDataType type,
+                                                qint32 count,
+                                                const void *value,
+                                                bool transpose)
+{
+    if (m_capturing) {
+        quint32 storageSize = 0;
+        const quint32 valueSize = QSSGRenderCommandList::constantValueSize(type, count, &storageSize);
+        auto *cmd = m_commands.append(QSSGRenderCommands::SetConstantValue{ po, id, type, count, storageSize, transpose }, storageSize);
+        quint8 *data = QSSGRenderCommandList::extraData(cmd);
+        ::memcpy(data, value, valueSize);
+        if (storageSize > valueSize)
+            ::memset(data + valueSize, 0, storageSize - valueSize);
+    }
+    m_target->setConstantValue(po, id, type, count, value, transpose);
+}
+
+void QSSGRenderBackendCapture::draw(QSSGRenderDrawMode drawMode, quint32 start, quint32 count)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::Draw{ drawMode, start, count });
+    m_target->draw(drawMode, start, count);
+}
+
+void QSSGRenderBackendCapture::drawIndirect(QSSGRenderDrawMode drawMode, const void *indirect)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DrawIndirect{ drawMode, reinterpret_cast<quintptr>(indirect) });
+    m_target->drawIndirect(drawMode, indirect);
+}
+
+void QSSGRenderBackendCapture::drawIndexed(QSSGRenderDrawMode drawMode,
+                                           quint32 count,
+                                           QSSGRenderComponentType type,
+                                           const void *indices)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DrawIndexed{ drawMode, count, type, reinterpret_cast<quintptr>(indices) });
+    m_target->drawIndexed(drawMode, count, type, indices);
+}
+
+void QSSGRenderBackendCapture::drawIndexedIndirect(QSSGRenderDrawMode drawMode,
+                                                   QSSGRenderComponentType type,
+                                                   const void *indirect)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::DrawIndexedIndirect{ drawMode, type, reinterpret_cast<quintptr>(indirect) });
+    m_target->drawIndexedIndirect(drawMode, type, indirect);
+}
+
+void QSSGRenderBackendCapture::readPixel(QSSGRenderBackendRenderTargetObject rto,
+                                         qint32 x,
+                                         qint32 y,
+                                         qint32 width,
+                                         qint32 height,
+                                         QSSGRenderReadPixelFormat inFormat,
+                                         QSSGByteRef pixels)
+{
+    if (m_capturing)
+        m_commands.append(QSSGRenderCommands::ReadPixel{ rto, x, y, width, height, inFormat });
+    m_target->readPixel(rto, x, y, width, height, inFormat, pixels);
+}
+
+QSSGRenderBackend::QSSGRenderBackendPathObject QSSGRenderBackendCapture::createPathNVObject(size_t range)
+{
+    return m_target->createPathNVObject(range);
+}
+
+void QSSGRenderBackendCapture::releasePathNVObject(QSSGRenderBackendPathObject po, size_t range)
+{
+    m_target->releasePathNVObject(po, range);
+}
+
+void QSSGRenderBackendCapture::setPathSpecification(QSSGRenderBackendPathObject inPathObject,
+                                                    QSSGByteView inPathCommands,
+                                                    QSSGDataView<float> inPathCoords)
+{
+    m_target->setPathSpecification(inPathObject, inPathCommands, inPathCoords);
+}
+
+QSSGBounds3 QSSGRenderBackendCapture::getPathObjectBoundingBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectBoundingBox(inPathObject);
+}
+
+QSSGBounds3 QSSGRenderBackendCapture::getPathObjectFillBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectFillBox(inPathObject);
+}
+
+QSSGBounds3 QSSGRenderBackendCapture::getPathObjectStrokeBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectStrokeBox(inPathObject);
+}
+
+void QSSGRenderBackendCapture::setStrokeWidth(QSSGRenderBackendPathObject inPathObject, float inStrokeWidth)
+{
+    m_target->setStrokeWidth(inPathObject, inStrokeWidth);
+}
+
+void QSSGRenderBackendCapture::setPathProjectionMatrix(const QMatrix4x4 inPathProjection)
+{
+    m_target->setPathProjectionMatrix(inPathProjection);
+}
+
+void QSSGRenderBackendCapture::setPathModelViewMatrix(const QMatrix4x4 inPathModelview)
+{
+    m_target->setPathModelViewMatrix(inPathModelview);
+}
+
+void QSSGRenderBackendCapture::stencilStrokePath(QSSGRenderBackendPathObject inPathObject)
+{
+    m_target->stencilStrokePath(inPathObject);
+}
+
+void QSSGRenderBackendCapture::stencilFillPath(QSSGRenderBackendPathObject inPathObject)
+{
+    m_target->stencilFillPath(inPathObject);
+}
+
+void QSSGRenderBackendCapture::stencilFillPathInstanced(QSSGRenderBackendPathObject po,
+                                                        size_t numPaths,
+                                                        QSSGRenderPathFormatType type,
+                                                        const void *charCodes,
+                                                        QSSGRenderPathFillMode fillMode,
+                                                        quint32 stencilMask,
+                                                        QSSGRenderPathTransformType transformType,
+                                                        const float *transformValues)
+{
+    m_target->stencilFillPathInstanced(po,
+                                       numPaths,
+                                       type,
+                                       charCodes,
+                                       fillMode,
+                                       stencilMask,
+                                       transformType,
+                                       transformValues);
+}
+
+void QSSGRenderBackendCapture::stencilStrokePathInstancedN(QSSGRenderBackendPathObject po,
+                                                           size_t numPaths,
+                                                           QSSGRenderPathFormatType type,
+                                                           const void *charCodes,
+                                                           qint32 stencilRef,
+                                                           quint32 stencilMask,
+                                                           QSSGRenderPathTransformType transformType,
+                                                           const float *transformValues)
+{
+    m_target->stencilStrokePathInstancedN(po,
+                                          numPaths,
+                                          type,
+                                          charCodes,
+                                          stencilRef,
+                                          stencilMask,
+                                          transformType,
+                                          transformValues);
+}
+
+void QSSGRenderBackendCapture::coverFillPathInstanced(QSSGRenderBackendPathObject po,
+                                                      size_t numPaths,
+                                                      QSSGRenderPathFormatType type,
+                                                      const void *charCodes,
+                                                      QSSGRenderPathCoverMode coverMode,
+                                                      QSSGRenderPathTransformType transformType,
+                                                      const float *transformValues)
+{
+    m_target->coverFillPathInstanced(po, numPaths, type, charCodes, coverMode, transformType, transformValues);
+}
+
+void QSSGRenderBackendCapture::coverStrokePathInstanced(QSSGRenderBackendPathObject po,
+                                                        size_t numPaths,
+                                                        QSSGRenderPathFormatType type,
+                                                        const void *charCodes,
+                                                        QSSGRenderPathCoverMode coverMode,
+                                                        QSSGRenderPathTransformType transformType,
+                                                        const float *transformValues)
+{
+    m_target->coverStrokePathInstanced(po, numPaths, type, charCodes, coverMode, transformType, transformValues);
+}
+
+void QSSGRenderBackendCapture::setPathStencilDepthOffset(float inSlope, float inBias)
+{
+    m_target->setPathStencilDepthOffset(inSlope, inBias);
+}
+
+void QSSGRenderBackendCapture::setPathCoverDepthFunc(QSSGRenderBoolOp inDepthFunction)
+{
+    m_target->setPathCoverDepthFunc(inDepthFunction);
+}
+
+void QSSGRenderBackendCapture::loadPathGlyphs(QSSGRenderBackendPathObject po,
+                                              QSSGRenderPathFontTarget fontTarget,
+                                              const void *fontName,
+                                              QSSGRenderPathFontStyleFlags fontStyle,
+                                              size_t numGlyphs,
+                                              QSSGRenderPathFormatType type,
+                                              const void *charCodes,
+                                              QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                                              QSSGRenderBackendPathObject pathParameterTemplate,
+                                              float emScale)
+{
+    m_target->loadPathGlyphs(po,
+                             fontTarget,
+                             fontName,
+                             fontStyle,
+                             numGlyphs,
+                             type,
+                             charCodes,
+                             handleMissingGlyphs,
+                             pathParameterTemplate,
+                             emScale);
+}
+
+QSSGRenderPathReturnValues QSSGRenderBackendCapture::loadPathGlyphsIndexed(
+        QSSGRenderBackendPathObject po,
+        QSSGRenderPathFontTarget fontTarget,
+        const void *fontName,
+        QSSGRenderPathFontStyleFlags fontStyle,
+        quint32 firstGlyphIndex,
+        size_t numGlyphs,
+        QSSGRenderBackendPathObject pathParameterTemplate,
+        float emScale)
+{
+    return m_target->loadPathGlyphsIndexed(po,
+                                           fontTarget,
+                                           fontName,
+                                           fontStyle,
+                                           firstGlyphIndex,
+                                           numGlyphs,
+                                           pathParameterTemplate,
+                                           emScale);
+}
+
+QSSGRenderBackend::QSSGRenderBackendPathObject QSSGRenderBackendCapture::loadPathGlyphsIndexedRange(
+        QSSGRenderPathFontTarget fontTarget,
+        const void *fontName,
+        QSSGRenderPathFontStyleFlags fontStyle,
+        QSSGRenderBackendPathObject pathParameterTemplate,
+        float emScale,
+        quint32 *count)
+{
+    return m_target->loadPathGlyphsIndexedRange(fontTarget, fontName, fontStyle, pathParameterTemplate, emScale, count);
+}
+
+void QSSGRenderBackendCapture::loadPathGlyphRange(QSSGRenderBackendPathObject po,
+                                                  QSSGRenderPathFontTarget fontTarget,
+                                                  const void *fontName,
+                                                  QSSGRenderPathFontStyleFlags fontStyle,
+                                                  quint32 firstGlyph,
+                                                  size_t numGlyphs,
+                                                  QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                                                  QSSGRenderBackendPathObject pathParameterTemplate,
+                                                  float emScale)
+{
+    m_target->loadPathGlyphRange(po,
+                                 fontTarget,
+                                 fontName,
+                                 fontStyle,
+                                 firstGlyph,
+                                 numGlyphs,
+                                 handleMissingGlyphs,
+                                 pathParameterTemplate,
+                                 emScale);
+}
+
+void QSSGRenderBackendCapture::getPathMetrics(QSSGRenderBackendPathObject po,
+                                              size_t numPaths,
+                                              QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                                              QSSGRenderPathFormatType type,
+                                              const void *charCodes,
+                                              size_t stride,
+                                              float *metrics)
+{
+    m_target->getPathMetrics(po, numPaths, metricQueryMask, type, charCodes, stride, metrics);
+}
+
+void QSSGRenderBackendCapture::getPathMetricsRange(QSSGRenderBackendPathObject po,
+                                                   size_t numPaths,
+                                                   QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                                                   size_t stride,
+                                                   float *metrics)
+{
+    m_target->getPathMetricsRange(po, numPaths, metricQueryMask, stride, metrics);
+}
+
+void QSSGRenderBackendCapture::getPathSpacing(QSSGRenderBackendPathObject po,
+                                              size_t numPaths,
+                                              QSSGRenderPathListMode pathListMode,
+                                              QSSGRenderPathFormatType type,
+                                              const void *charCodes,
+                                              float advanceScale,
+                                              float kerningScale,
+                                              QSSGRenderPathTransformType transformType,
+                                              float *spacing)
+{
+    m_target->getPathSpacing(po,
+                             numPaths,
+                             pathListMode,
+                             type,
+                             charCodes,
+                             advanceScale,
+                             kerningScale,
+                             transformType,
+                             spacing);
+}
+
+QSurfaceFormat QSSGRenderBackendCapture::format() const
+{
+    return m_target->format();
+}
+
+QSSGRenderCaptureReader::QSSGRenderCaptureReader(const QString &inFileName) : m_file(inFileName) {}
+
+bool QSSGRenderCaptureReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    CaptureFileHeader header;
+    if (m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) || header.magic != Magic) {
+        m_error = QStringLiteral("Not a capture file");
+        return false;
+    }
+    if (header.version != Version) {
+        m_error = QStringLiteral("Unsupported capture file version %1").arg(header.version);
+        return false;
+    }
+    if (header.pointerSize != sizeof(void *)) {
+        m_error = QStringLiteral("Capture file was written by a %1 bit build").arg(header.pointerSize * 8);
+        return false;
+    }
+    return true;
+}
+
+bool QSSGRenderCaptureReader::atEnd() const
+{
+    return m_file.atEnd();
+}
+
+bool QSSGRenderCaptureReader::readFrame(QSSGRenderCommandList *outCommands)
+{
+    if (!outCommands->read(&m_file)) {
+        m_error = QStringLiteral("Truncated or corrupt frame at offset %1").arg(m_file.pos());
+        return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
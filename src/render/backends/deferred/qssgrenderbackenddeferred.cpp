@@ -0,0 +1,1384 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick3DRender/private/qssgrenderbackenddeferred_p.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+QSSGRenderBackendDeferred::QSSGRenderBackendDeferred(const QSSGRef<QSSGRenderBackend> &inTarget)
+    : m_target(inTarget)
+{
+    Q_ASSERT(m_target);
+}
+
+QSSGRenderBackendDeferred::~QSSGRenderBackendDeferred() = default;
+
+void QSSGRenderBackendDeferred::submit()
+{
+    m_commands.replay(m_target.data());
+    m_commands.reset();
+}
+
+void QSSGRenderBackendDeferred::flush()
+{
+    if (!m_commands.isEmpty())
+        submit();
+}
+
+void QSSGRenderBackendDeferred::setShadowRenderState(QSSGRenderState inState, bool inEnabled)
+{
+    const quint32 bit = 1u << quint32(inState);
+    m_knownRenderStates |= bit;
+    if (inEnabled)
+        m_renderStates |= bit;
+    else
+        m_renderStates &= ~bit;
+}
+
+QSSGRenderContextType QSSGRenderBackendDeferred::getRenderContextType() const
+{
+    return m_target->getRenderContextType();
+}
+
+const char *QSSGRenderBackendDeferred::getShadingLanguageVersion()
+{
+    return m_target->getShadingLanguageVersion();
+}
+
+qint32 QSSGRenderBackendDeferred::getMaxCombinedTextureUnits()
+{
+    return m_target->getMaxCombinedTextureUnits();
+}
+
+bool QSSGRenderBackendDeferred::getRenderBackendCap(QSSGRenderBackendCaps inCap) const
+{
+    return m_target->getRenderBackendCap(inCap);
+}
+
+void QSSGRenderBackendDeferred::getRenderBackendValue(QSSGRenderBackendQuery inQuery, qint32 *params) const
+{
+    m_target->getRenderBackendValue(inQuery, params);
+}
+
+qint32 QSSGRenderBackendDeferred::getDepthBits() const
+{
+    return m_target->getDepthBits();
+}
+
+qint32 QSSGRenderBackendDeferred::getStencilBits() const
+{
+    return m_target->getStencilBits();
+}
+
+void QSSGRenderBackendDeferred::setRenderState(bool bEnable, const QSSGRenderState value)
+{
+    m_commands.append(QSSGRenderCommands::SetRenderState{ bEnable, value });
+    setShadowRenderState(value, bEnable);
+}
+
+bool QSSGRenderBackendDeferred::getRenderState(const QSSGRenderState value)
+{
+    const quint32 bit = 1u << quint32(value);
+    if (m_knownRenderStates & bit)
+        return (m_renderStates & bit) != 0;
+    return m_target->getRenderState(value);
+}
+
+QSSGRenderBoolOp QSSGRenderBackendDeferred::getDepthFunc()
+{
+    if (m_knownState & KnownDepthFunc)
+        return m_depthFunc;
+    return m_target->getDepthFunc();
+}
+
+QSSGRenderBackend::QSSGRenderBackendDepthStencilStateObject QSSGRenderBackendDeferred::createDepthStencilState(
+        bool enableDepth,
+        bool depthMask,
+        QSSGRenderBoolOp depthFunc,
+        bool enableStencil,
+        QSSGRenderStencilFunction &stencilFuncFront,
+        QSSGRenderStencilFunction &stencilFuncBack,
+        QSSGRenderStencilOperation &depthStencilOpFront,
+        QSSGRenderStencilOperation &depthStencilOpBack)
+{
+    return m_target->createDepthStencilState(enableDepth,
+                                             depthMask,
+                                             depthFunc,
+                                             enableStencil,
+                                             stencilFuncFront,
+                                             stencilFuncBack,
+                                             depthStencilOpFront,
+                                             depthStencilOpBack);
+}
+
+void QSSGRenderBackendDeferred::releaseDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState)
+{
+    m_target->releaseDepthStencilState(depthStencilState);
+}
+
+QSSGRenderBackend::QSSGRenderBackendRasterizerStateObject QSSGRenderBackendDeferred::createRasterizerState(
+        float depthBias,
+        float depthScale,
+        QSSGRenderFace cullFace)
+{
+    return m_target->createRasterizerState(depthBias, depthScale, cullFace);
+}
+
+void QSSGRenderBackendDeferred::releaseRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState)
+{
+    m_target->releaseRasterizerState(rasterizerState);
+}
+
+void QSSGRenderBackendDeferred::setDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState)
+{
+    m_commands.append(QSSGRenderCommands::SetDepthStencilState{ depthStencilState });
+    // The state object overrides depth and stencil settings we do not track
+    m_knownState &= ~KnownDepthFunc;
+    m_knownRenderStates &= ~((1u << quint32(QSSGRenderState::DepthTest)) | (1u << quint32(QSSGRenderState::StencilTest))
+                             | (1u << quint32(QSSGRenderState::DepthWrite)));
+}
+
+void QSSGRenderBackendDeferred::setRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState)
+{
+    m_commands.append(QSSGRenderCommands::SetRasterizerState{ rasterizerState });
+    m_knownRenderStates &= ~(1u << quint32(QSSGRenderState::CullFace));
+}
+
+void QSSGRenderBackendDeferred::setDepthFunc(const QSSGRenderBoolOp func)
+{
+    m_commands.append(QSSGRenderCommands::SetDepthFunc{ func });
+    m_depthFunc = func;
+    m_knownState |= KnownDepthFunc;
+}
+
+bool QSSGRenderBackendDeferred::getDepthWrite()
+{
+    return getRenderState(QSSGRenderState::DepthWrite);
+}
+
+void QSSGRenderBackendDeferred::setDepthWrite(bool bEnable)
+{
+    m_commands.append(QSSGRenderCommands::SetDepthWrite{ bEnable });
+    setShadowRenderState(QSSGRenderState::DepthWrite, bEnable);
+}
+
+void QSSGRenderBackendDeferred::setColorWrites(bool bRed, bool bGreen, bool bBlue, bool bAlpha)
+{
+    m_commands.append(QSSGRenderCommands::SetColorWrites{ bRed, bGreen, bBlue, bAlpha });
+}
+
+void QSSGRenderBackendDeferred::setMultisample(bool bEnable)
+{
+    m_commands.append(QSSGRenderCommands::SetMultisample{ bEnable });
+    setShadowRenderState(QSSGRenderState::Multisample, bEnable);
+}
+
+void QSSGRenderBackendDeferred::getBlendFunc(QSSGRenderBlendFunctionArgument *pBlendFuncArg)
+{
+    if (m_knownState & KnownBlendFunc)
+        *pBlendFuncArg = m_blendFunc;
+    else
+        m_target->getBlendFunc(pBlendFuncArg);
+}
+
+void QSSGRenderBackendDeferred::setBlendFunc(const QSSGRenderBlendFunctionArgument &blendFuncArg)
+{
+    m_commands.append(QSSGRenderCommands::SetBlendFunc{ blendFuncArg });
+    m_blendFunc = blendFuncArg;
+    m_knownState |= KnownBlendFunc;
+}
+
+void QSSGRenderBackendDeferred::setBlendEquation(const QSSGRenderBlendEquationArgument &pBlendEquArg)
+{
+    m_commands.append(QSSGRenderCommands::SetBlendEquation{ pBlendEquArg });
+}
+
+void QSSGRenderBackendDeferred::setBlendBarrier()
+{
+    m_commands.append(QSSGRenderCommands::SetBlendBarrier{});
+}
+
+void QSSGRenderBackendDeferred::getScissorRect(QRect *pRect)
+{
+    if (m_knownState & KnownScissorRect)
+        *pRect = m_scissorRect;
+    else
+        m_target->getScissorRect(pRect);
+}
+
+void QSSGRenderBackendDeferred::setScissorRect(const QRect &rect)
+{
+    m_commands.append(QSSGRenderCommands::SetScissorRect{ rect });
+    m_scissorRect = rect;
+    m_knownState |= KnownScissorRect;
+}
+
+void QSSGRenderBackendDeferred::getViewportRect(QRect *pRect)
+{
+    if (m_knownState & KnownViewportRect)
+        *pRect = m_viewportRect;
+    else
+        m_target->getViewportRect(pRect);
+}
+
+void QSSGRenderBackendDeferred::setViewportRect(const QRect &rect)
+{
+    m_commands.append(QSSGRenderCommands::SetViewportRect{ rect });
+    m_viewportRect = rect;
+    m_knownState |= KnownViewportRect;
+}
+
+void QSSGRenderBackendDeferred::setClearColor(const QVector4D *pClearColor)
+{
+    Q_ASSERT(pClearColor);
+    m_commands.append(QSSGRenderCommands::SetClearColor{ *pClearColor });
+}
+
+void QSSGRenderBackendDeferred::clear(QSSGRenderClearFlags flags)
+{
+    m_commands.append(QSSGRenderCommands::Clear{ flags });
+}
+
+QSSGRenderBackend::QSSGRenderBackendBufferObject QSSGRenderBackendDeferred::createBuffer(
+        QSSGRenderBufferType bindFlags,
+        QSSGRenderBufferUsageType usage,
+        QSSGByteView hostData)
+{
+    return m_target->createBuffer(bindFlags, usage, hostData);
+}
+
+void QSSGRenderBackendDeferred::bindBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags)
+{
+    m_commands.append(QSSGRenderCommands::BindBuffer{ bo, bindFlags });
+}
+
+void QSSGRenderBackendDeferred::releaseBuffer(QSSGRenderBackendBufferObject bo)
+{
+    m_target->releaseBuffer(bo);
+}
+
+void QSSGRenderBackendDeferred::updateBuffer(QSSGRenderBackendBufferObject bo,
+                                             QSSGRenderBufferType bindFlags,
+                                             QSSGRenderBufferUsageType usage,
+                                             QSSGByteView data)
+{
+    const quint32 size = quint32(data.size());
+    auto *cmd = m_commands.append(QSSGRenderCommands::UpdateBuffer{ bo, bindFlags, usage, size }, size);
+    if (size)
+        ::memcpy(QSSGRenderCommandList::extraData(cmd), data.begin(), size);
+}
+
+void QSSGRenderBackendDeferred::updateBufferRange(QSSGRenderBackendBufferObject bo,
+                                                  QSSGRenderBufferType bindFlags,
+                                                  size_t offset,
+                                                  QSSGByteView data)
+{
+    const quint32 size = quint32(data.size());
+    auto *cmd = m_commands.append(QSSGRenderCommands::UpdateBufferRange{ bo, bindFlags, offset, size }, size);
+    if (size)
+        ::memcpy(QSSGRenderCommandList::extraData(cmd), data.begin(), size);
+}
+
+void *QSSGRenderBackendDeferred::mapBuffer(QSSGRenderBackendBufferObject bo,
+                                           QSSGRenderBufferType bindFlags,
+                                           size_t offset,
+                                           size_t length,
+                                           QSSGRenderBufferAccessFlags accessFlags)
+{
+    flush();
+    return m_target->mapBuffer(bo, bindFlags, offset, length, accessFlags);
+}
+
+bool QSSGRenderBackendDeferred::unmapBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags)
+{
+    flush();
+    return m_target->unmapBuffer(bo, bindFlags);
+}
+
+void QSSGRenderBackendDeferred::setMemoryBarrier(QSSGRenderBufferBarrierFlags barriers)
+{
+    m_commands.append(QSSGRenderCommands::SetMemoryBarrier{ barriers });
+}
+
+QSSGRenderBackend::QSSGRenderBackendQueryObject QSSGRenderBackendDeferred::createQuery()
+{
+    return m_target->createQuery();
+}
+
+void QSSGRenderBackendDeferred::releaseQuery(QSSGRenderBackendQueryObject qo)
+{
+    m_target->releaseQuery(qo);
+}
+
+void QSSGRenderBackendDeferred::beginQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type)
+{
+    m_commands.append(QSSGRenderCommands::BeginQuery{ qo, type });
+}
+
+void QSSGRenderBackendDeferred::endQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type)
+{
+    m_commands.append(QSSGRenderCommands::EndQuery{ qo, type });
+}
+
+void QSSGRenderBackendDeferred::getQueryResult(QSSGRenderBackendQueryObject qo,
+                                               QSSGRenderQueryResultType resultType,
+                                               quint32 *params)
+{
+    flush();
+    m_target->getQueryResult(qo, resultType, params);
+}
+
+void QSSGRenderBackendDeferred::getQueryResult(QSSGRenderBackendQueryObject qo,
+                                               QSSGRenderQueryResultType resultType,
+                                               quint64 *params)
+{
+    flush();
+    m_target->getQueryResult(qo, resultType, params);
+}
+
+void QSSGRenderBackendDeferred::setQueryTimer(QSSGRenderBackendQueryObject qo)
+{
+    m_commands.append(QSSGRenderCommands::SetQueryTimer{ qo });
+}
+
+QSSGRenderBackend::QSSGRenderBackendSyncObject QSSGRenderBackendDeferred::createSync(QSSGRenderSyncType tpye,
+                                                                                     QSSGRenderSyncFlags syncFlags)
+{
+    flush();
+    return m_target->createSync(tpye, syncFlags);
+}
+
+void QSSGRenderBackendDeferred::releaseSync(QSSGRenderBackendSyncObject so)
+{
+    m_target->releaseSync(so);
+}
+
+void QSSGRenderBackendDeferred::waitSync(QSSGRenderBackendSyncObject so,
+                                         QSSGRenderCommandFlushFlags syncFlags,
+                                         quint64 timeout)
+{
+    m_target->waitSync(so, syncFlags, timeout);
+}
+
+bool QSSGRenderBackendDeferred::isSyncSignaled(QSSGRenderBackendSyncObject so)
+{
+    return m_target->isSyncSignaled(so);
+}
+
+QSSGRenderBackend::QSSGRenderBackendRenderTargetObject QSSGRenderBackendDeferred::createRenderTarget()
+{
+    return m_target->createRenderTarget();
+}
+
+void QSSGRenderBackendDeferred::releaseRenderTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    m_target->releaseRenderTarget(rto);
+}
+
+void QSSGRenderBackendDeferred::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                   QSSGRenderFrameBufferAttachment attachment,
+                                                   QSSGRenderBackendRenderbufferObject rbo)
+{
+    m_target->renderTargetAttach(rto, attachment, rbo);
+}
+
+void QSSGRenderBackendDeferred::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                   QSSGRenderFrameBufferAttachment attachment,
+                                                   QSSGRenderBackendTextureObject to,
+                                                   QSSGRenderTextureTargetType target)
+{
+    m_target->renderTargetAttach(rto, attachment, to, target);
+}
+
+void QSSGRenderBackendDeferred::renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                                                   QSSGRenderFrameBufferAttachment attachment,
+                                                   QSSGRenderBackendTextureObject to,
+                                                   qint32 level,
+                                                   qint32 layer)
+{
+    m_target->renderTargetAttach(rto, attachment, to, level, layer);
+}
+
+void QSSGRenderBackendDeferred::setRenderTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    m_commands.append(QSSGRenderCommands::SetRenderTarget{ rto });
+}
+
+bool QSSGRenderBackendDeferred::renderTargetIsValid(QSSGRenderBackendRenderTargetObject rto)
+{
+    return m_target->renderTargetIsValid(rto);
+}
+
+void QSSGRenderBackendDeferred::setReadTarget(QSSGRenderBackendRenderTargetObject rto)
+{
+    m_commands.append(QSSGRenderCommands::SetReadTarget{ rto });
+}
+
+void QSSGRenderBackendDeferred::setDrawBuffers(QSSGRenderBackendRenderTargetObject rto,
+                                               QSSGDataView<qint32> inDrawBufferSet)
+{
+    const quint32 count = quint32(inDrawBufferSet.size());
+    auto *cmd = m_commands.append(QSSGRenderCommands::SetDrawBuffers{ rto, count }, count * sizeof(qint32));
+    if (count)
+        ::memcpy(QSSGRenderCommandList::extraData(cmd), inDrawBufferSet.begin(), count * sizeof(qint32));
+}
+
+void QSSGRenderBackendDeferred::setReadBuffer(QSSGRenderBackendRenderTargetObject rto, QSSGReadFace inReadFace)
+{
+    m_commands.append(QSSGRenderCommands::SetReadBuffer{ rto, inReadFace });
+}
+
+void QSSGRenderBackendDeferred::blitFramebuffer(qint32 srcX0,
+                                                qint32 srcY0,
+                                                qint32 srcX1,
+                                                qint32 srcY1,
+                                                qint32 dstX0,
+                                                qint32 dstY0,
+                                                qint32 dstX1,
+                                                qint32 dstY1,
+                                                QSSGRenderClearFlags flags,
+                                                QSSGRenderTextureMagnifyingOp filter)
+{
+    m_commands.append(QSSGRenderCommands::BlitFramebuffer{ srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, flags, filter });
+}
+
+QSSGRenderBackend::QSSGRenderBackendRenderbufferObject QSSGRenderBackendDeferred::createRenderbuffer(
+        QSSGRenderRenderBufferFormat storageFormat,
+        qint32 width,
+        qint32 height)
+{
+    return m_target->createRenderbuffer(storageFormat, width, height);
+}
+
+void QSSGRenderBackendDeferred::releaseRenderbuffer(QSSGRenderBackendRenderbufferObject rbo)
+{
+    m_target->releaseRenderbuffer(rbo);
+}
+
+bool QSSGRenderBackendDeferred::resizeRenderbuffer(QSSGRenderBackendRenderbufferObject rbo,
+                                                   QSSGRenderRenderBufferFormat storageFormat,
+                                                   qint32 width,
+                                                   qint32 height)
+{
+    return m_target->resizeRenderbuffer(rbo, storageFormat, width, height);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTextureObject QSSGRenderBackendDeferred::createTexture()
+{
+    return m_target->createTexture();
+}
+
+void QSSGRenderBackendDeferred::setTextureData2D(QSSGRenderBackendTextureObject to,
+                                                 QSSGRenderTextureTargetType target,
+                                                 qint32 level,
+                                                 QSSGRenderTextureFormat internalFormat,
+                                                 qint32 width,
+                                                 qint32 height,
+                                                 qint32 border,
+                                                 QSSGRenderTextureFormat format,
+                                                 QSSGByteView hostData)
+{
+    m_target->setTextureData2D(to, target, level, internalFormat, width, height, border, format, hostData);
+}
+
+void QSSGRenderBackendDeferred::setTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                                       QSSGRenderTextureTargetType target,
+                                                       qint32 level,
+                                                       QSSGRenderTextureFormat internalFormat,
+                                                       qint32 width,
+                                                       qint32 height,
+                                                       qint32 border,
+                                                       QSSGRenderTextureFormat format,
+                                                       QSSGByteView hostData)
+{
+    m_target->setTextureDataCubeFace(to, target, level, internalFormat, width, height, border, format, hostData);
+}
+
+void QSSGRenderBackendDeferred::createTextureStorage2D(QSSGRenderBackendTextureObject to,
+                                                       QSSGRenderTextureTargetType target,
+                                                       qint32 levels,
+                                                       QSSGRenderTextureFormat internalFormat,
+                                                       qint32 width,
+                                                       qint32 height)
+{
+    m_target->createTextureStorage2D(to, target, levels, internalFormat, width, height);
+}
+
+void QSSGRenderBackendDeferred::setTextureSubData2D(QSSGRenderBackendTextureObject to,
+                                                    QSSGRenderTextureTargetType target,
+                                                    qint32 level,
+                                                    qint32 xOffset,
+                                                    qint32 yOffset,
+                                                    qint32 width,
+                                                    qint32 height,
+                                                    QSSGRenderTextureFormat format,
+                                                    QSSGByteView hostData)
+{
+    m_target->setTextureSubData2D(to, target, level, xOffset, yOffset, width, height, format, hostData);
+}
+
+void QSSGRenderBackendDeferred::setCompressedTextureData2D(QSSGRenderBackendTextureObject to,
+                                                           QSSGRenderTextureTargetType target,
+                                                           qint32 level,
+                                                           QSSGRenderTextureFormat internalFormat,
+                                                           qint32 width,
+                                                           qint32 height,
+                                                           qint32 border,
+                                                           QSSGByteView hostData)
+{
+    m_target->setCompressedTextureData2D(to, target, level, internalFormat, width, height, border, hostData);
+}
+
+void QSSGRenderBackendDeferred::setCompressedTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                                                 QSSGRenderTextureTargetType target,
+                                                                 qint32 level,
+                                                                 QSSGRenderTextureFormat internalFormat,
+                                                                 qint32 width,
+                                                                 qint32 height,
+                                                                 qint32 border,
+                                                                 QSSGByteView hostData)
+{
+    m_target->setCompressedTextureDataCubeFace(to, target, level, internalFormat, width, height, border, hostData);
+}
+
+void QSSGRenderBackendDeferred::setCompressedTextureSubData2D(QSSGRenderBackendTextureObject to,
+                                                              QSSGRenderTextureTargetType target,
+                                                              qint32 level,
+                                                              qint32 xOffset,
+                                                              qint32 yOffset,
+                                                              qint32 width,
+                                                              qint32 height,
+                                                              QSSGRenderTextureFormat format,
+                                                              QSSGByteView hostData)
+{
+    m_target->setCompressedTextureSubData2D(to, target, level, xOffset, yOffset, width, height, format, hostData);
+}
+
+void QSSGRenderBackendDeferred::setMultisampledTextureData2D(QSSGRenderBackendTextureObject to,
+                                                             QSSGRenderTextureTargetType target,
+                                                             qint32 samples,
+                                                             QSSGRenderTextureFormat internalFormat,
+                                                             qint32 width,
+                                                             qint32 height,
+                                                             bool fixedsamplelocations)
+{
+    m_target->setMultisampledTextureData2D(to, target, samples, internalFormat, width, height, fixedsamplelocations);
+}
+
+void QSSGRenderBackendDeferred::setTextureData3D(QSSGRenderBackendTextureObject to,
+                                                 QSSGRenderTextureTargetType target,
+                                                 qint32 level,
+                                                 QSSGRenderTextureFormat internalFormat,
+                                                 qint32 width,
+                                                 qint32 height,
+                                                 qint32 depth,
+                                                 qint32 border,
+                                                 QSSGRenderTextureFormat format,
+                                                 QSSGByteView hostData)
+{
+    m_target->setTextureData3D(to, target, level, internalFormat, width, height, depth, border, format, hostData);
+}
+
+void QSSGRenderBackendDeferred::generateMipMaps(QSSGRenderBackendTextureObject to,
+                                                QSSGRenderTextureTargetType target,
+                                                QSSGRenderHint genType)
+{
+    m_commands.append(QSSGRenderCommands::GenerateMipMaps{ to, target, genType });
+}
+
+void QSSGRenderBackendDeferred::bindTexture(QSSGRenderBackendTextureObject to,
+                                            QSSGRenderTextureTargetType target,
+                                            qint32 unit)
+{
+    m_commands.append(QSSGRenderCommands::BindTexture{ to, target, unit });
+}
+
+void QSSGRenderBackendDeferred::bindImageTexture(QSSGRenderBackendTextureObject to,
+                                                 quint32 unit,
+                                                 qint32 level,
+                                                 bool layered,
+                                                 qint32 layer,
+                                                 QSSGRenderImageAccessType accessFlags,
+                                                 QSSGRenderTextureFormat format)
+{
+    m_commands.append(QSSGRenderCommands::BindImageTexture{ to, unit, level, layered, layer, accessFlags, format });
+}
+
+void QSSGRenderBackendDeferred::releaseTexture(QSSGRenderBackendTextureObject to)
+{
+    m_target->releaseTexture(to);
+}
+
+QSSGRenderTextureSwizzleMode QSSGRenderBackendDeferred::getTextureSwizzleMode(
+        const QSSGRenderTextureFormat inFormat) const
+{
+    return m_target->getTextureSwizzleMode(inFormat);
+}
+
+QSSGRenderBackend::QSSGRenderBackendSamplerObject QSSGRenderBackendDeferred::createSampler(
+        QSSGRenderTextureMinifyingOp minFilter,
+        QSSGRenderTextureMagnifyingOp magFilter,
+        QSSGRenderTextureCoordOp wrapS,
+        QSSGRenderTextureCoordOp wrapT,
+        QSSGRenderTextureCoordOp wrapR,
+        qint32 minLod,
+        qint32 maxLod,
+        float lodBias,
+        QSSGRenderTextureCompareMode compareMode,
+        QSSGRenderTextureCompareOp compareFunc,
+        float anisotropy,
+        float *borderColor)
+{
+    return m_target->createSampler(minFilter,
+                                   magFilter,
+                                   wrapS,
+                                   wrapT,
+                                   wrapR,
+                                   minLod,
+                                   maxLod,
+                                   lodBias,
+                                   compareMode,
+                                   compareFunc,
+                                   anisotropy,
+                                   borderColor);
+}
+
+void QSSGRenderBackendDeferred::updateSampler(QSSGRenderBackendSamplerObject so,
+                                              QSSGRenderTextureTargetType target,
+                                              QSSGRenderTextureMinifyingOp minFilter,
+                                              QSSGRenderTextureMagnifyingOp magFilter,
+                                              QSSGRenderTextureCoordOp wrapS,
+                                              QSSGRenderTextureCoordOp wrapT,
+                                              QSSGRenderTextureCoordOp wrapR,
+                                              float minLod,
+                                              float maxLod,
+                                              float lodBias,
+                                              QSSGRenderTextureCompareMode compareMode,
+                                              QSSGRenderTextureCompareOp compareFunc,
+                                              float anisotropy,
+                                              float *borderColor)
+{
+    QSSGRenderCommands::UpdateSampler cmd{ so, target, minFilter, magFilter, wrapS, wrapT, wrapR,
+                                           minLod, maxLod, lodBias, compareMode, compareFunc, anisotropy,
+                                           borderColor != nullptr, { 0.0f, 0.0f, 0.0f, 0.0f } };
+    if (borderColor)
+        ::memcpy(cmd.borderColor, borderColor, sizeof(cmd.borderColor));
+    m_commands.append(cmd);
+}
+
+void QSSGRenderBackendDeferred::updateTextureSwizzle(QSSGRenderBackendTextureObject to,
+                                                     QSSGRenderTextureTargetType target,
+                                                     QSSGRenderTextureSwizzleMode swizzleMode)
+{
+    m_commands.append(QSSGRenderCommands::UpdateTextureSwizzle{ to, target, swizzleMode });
+}
+
+void QSSGRenderBackendDeferred::updateTextureObject(QSSGRenderBackendTextureObject to,
+                                                    QSSGRenderTextureTargetType target,
+                                                    qint32 baseLevel,
+                                                    qint32 maxLevel)
+{
+    m_commands.append(QSSGRenderCommands::UpdateTextureObject{ to, target, baseLevel, maxLevel });
+}
+
+void QSSGRenderBackendDeferred::releaseSampler(QSSGRenderBackendSamplerObject so)
+{
+    m_target->releaseSampler(so);
+}
+
+QSSGRenderBackend::QSSGRenderBackendAttribLayoutObject QSSGRenderBackendDeferred::createAttribLayout(
+        QSSGDataView<QSSGRenderVertexBufferEntry> attribs)
+{
+    return m_target->createAttribLayout(attribs);
+}
+
+void QSSGRenderBackendDeferred::releaseAttribLayout(QSSGRenderBackendAttribLayoutObject ao)
+{
+    m_target->releaseAttribLayout(ao);
+}
+
+QSSGRenderBackend::QSSGRenderBackendInputAssemblerObject QSSGRenderBackendDeferred::createInputAssembler(
+        QSSGRenderBackendAttribLayoutObject attribLayout,
+        QSSGDataView<QSSGRenderBackendBufferObject> buffers,
+        const QSSGRenderBackendBufferObject indexBuffer,
+        QSSGDataView<quint32> strides,
+        QSSGDataView<quint32> offsets,
+        quint32 patchVertexCount)
+{
+    return m_target->createInputAssembler(attribLayout, buffers, indexBuffer, strides, offsets, patchVertexCount);
+}
+
+void QSSGRenderBackendDeferred::releaseInputAssembler(QSSGRenderBackendInputAssemblerObject iao)
+{
+    m_target->releaseInputAssembler(iao);
+}
+
+bool QSSGRenderBackendDeferred::setInputAssembler(QSSGRenderBackendInputAssemblerObject iao,
+                                                  QSSGRenderBackendShaderProgramObject po)
+{
+    // The result of the real call is not known until replay, the GL backends
+    // only fail here for a null input assembler.
+    m_commands.append(QSSGRenderCommands::SetInputAssembler{ iao, po });
+    return iao != nullptr;
+}
+
+void QSSGRenderBackendDeferred::setPatchVertexCount(QSSGRenderBackendInputAssemblerObject iao, quint32 count)
+{
+    m_commands.append(QSSGRenderCommands::SetPatchVertexCount{ iao, count });
+}
+
+QSSGRenderBackend::QSSGRenderBackendVertexShaderObject QSSGRenderBackendDeferred::createVertexShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createVertexShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseVertexShader(QSSGRenderBackendVertexShaderObject vso)
+{
+    m_target->releaseVertexShader(vso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendFragmentShaderObject QSSGRenderBackendDeferred::createFragmentShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createFragmentShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseFragmentShader(QSSGRenderBackendFragmentShaderObject fso)
+{
+    m_target->releaseFragmentShader(fso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTessControlShaderObject QSSGRenderBackendDeferred::createTessControlShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createTessControlShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseTessControlShader(QSSGRenderBackendTessControlShaderObject tcso)
+{
+    m_target->releaseTessControlShader(tcso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendTessEvaluationShaderObject QSSGRenderBackendDeferred::createTessEvaluationShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createTessEvaluationShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseTessEvaluationShader(QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    m_target->releaseTessEvaluationShader(teso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendGeometryShaderObject QSSGRenderBackendDeferred::createGeometryShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createGeometryShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseGeometryShader(QSSGRenderBackendGeometryShaderObject gso)
+{
+    m_target->releaseGeometryShader(gso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendComputeShaderObject QSSGRenderBackendDeferred::createComputeShader(
+        QSSGByteView source,
+        QByteArray &errorMessage,
+        bool binary)
+{
+    return m_target->createComputeShader(source, errorMessage, binary);
+}
+
+void QSSGRenderBackendDeferred::releaseComputeShader(QSSGRenderBackendComputeShaderObject cso)
+{
+    m_target->releaseComputeShader(cso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendVertexShaderObject vso)
+{
+    m_target->attachShader(po, vso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendVertexShaderObject vso)
+{
+    m_target->detachShader(po, vso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendFragmentShaderObject fso)
+{
+    m_target->attachShader(po, fso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendFragmentShaderObject fso)
+{
+    m_target->detachShader(po, fso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendTessControlShaderObject tcso)
+{
+    m_target->attachShader(po, tcso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendTessControlShaderObject tcso)
+{
+    m_target->detachShader(po, tcso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    m_target->attachShader(po, teso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendTessEvaluationShaderObject teso)
+{
+    m_target->detachShader(po, teso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendGeometryShaderObject gso)
+{
+    m_target->attachShader(po, gso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendGeometryShaderObject gso)
+{
+    m_target->detachShader(po, gso);
+}
+
+void QSSGRenderBackendDeferred::attachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendComputeShaderObject cso)
+{
+    m_target->attachShader(po, cso);
+}
+
+void QSSGRenderBackendDeferred::detachShader(QSSGRenderBackendShaderProgramObject po,
+                                             QSSGRenderBackendComputeShaderObject cso)
+{
+    m_target->detachShader(po, cso);
+}
+
+QSSGRenderBackend::QSSGRenderBackendShaderProgramObject QSSGRenderBackendDeferred::createShaderProgram(bool isSeparable)
+{
+    return m_target->createShaderProgram(isSeparable);
+}
+
+void QSSGRenderBackendDeferred::releaseShaderProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    m_target->releaseShaderProgram(po);
+}
+
+bool QSSGRenderBackendDeferred::linkProgram(QSSGRenderBackendShaderProgramObject po, QByteArray &errorMessage)
+{
+    return m_target->linkProgram(po, errorMessage);
+}
+
+void QSSGRenderBackendDeferred::startLinkProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    m_target->startLinkProgram(po);
+}
+
+bool QSSGRenderBackendDeferred::isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->isProgramLinkComplete(po);
+}
+
+void QSSGRenderBackendDeferred::setActiveProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    m_commands.append(QSSGRenderCommands::SetActiveProgram{ po });
+}
+
+QSSGRenderBackend::QSSGRenderBackendProgramPipeline QSSGRenderBackendDeferred::createProgramPipeline()
+{
+    return m_target->createProgramPipeline();
+}
+
+void QSSGRenderBackendDeferred::releaseProgramPipeline(QSSGRenderBackendProgramPipeline ppo)
+{
+    m_target->releaseProgramPipeline(ppo);
+}
+
+void QSSGRenderBackendDeferred::setActiveProgramPipeline(QSSGRenderBackendProgramPipeline ppo)
+{
+    m_commands.append(QSSGRenderCommands::SetActiveProgramPipeline{ ppo });
+}
+
+void QSSGRenderBackendDeferred::setProgramStages(QSSGRenderBackendProgramPipeline ppo,
+                                                 QSSGRenderShaderTypeFlags flags,
+                                                 QSSGRenderBackendShaderProgramObject po)
+{
+    m_commands.append(QSSGRenderCommands::SetProgramStages{ ppo, flags, po });
+}
+
+void QSSGRenderBackendDeferred::dispatchCompute(QSSGRenderBackendShaderProgramObject po,
+                                                quint32 numGroupsX,
+                                                quint32 numGroupsY,
+                                                quint32 numGroupsZ)
+{
+    m_commands.append(QSSGRenderCommands::DispatchCompute{ po, numGroupsX, numGroupsY, numGroupsZ });
+}
+
+qint32 QSSGRenderBackendDeferred::getConstantCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getConstantCount(po);
+}
+
+qint32 QSSGRenderBackendDeferred::getConstantBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getConstantBufferCount(po);
+}
+
+qint32 QSSGRenderBackendDeferred::getConstantInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                      quint32 id,
+                                                      quint32 bufSize,
+                                                      qint32 *numElem,
+                                                      QSSGRenderShaderDataType *type,
+                                                      qint32 *binding,
+                                                      char *nameBuf)
+{
+    return m_target->getConstantInfoByID(po, id, bufSize, numElem, type, binding, nameBuf);
+}
+
+qint32 QSSGRenderBackendDeferred::getConstantBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                            quint32 id,
+                                                            quint32 nameBufSize,
+                                                            qint32 *paramCount,
+                                                            qint32 *bufferSize,
+                                                            qint32 *length,
+                                                            char *nameBuf)
+{
+    return m_target->getConstantBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendDeferred::getConstantBufferParamIndices(QSSGRenderBackendShaderProgramObject po,
+                                                              quint32 id,
+                                                              qint32 *indices)
+{
+    m_target->getConstantBufferParamIndices(po, id, indices);
+}
+
+void QSSGRenderBackendDeferred::getConstantBufferParamInfoByIndices(QSSGRenderBackendShaderProgramObject po,
+                                                                    quint32 count,
+                                                                    quint32 *indices,
+                                                                    QSSGRenderShaderDataType *type,
+                                                                    qint32 *size,
+                                                                    qint32 *offset)
+{
+    m_target->getConstantBufferParamInfoByIndices(po, count, indices, type, size, offset);
+}
+
+void QSSGRenderBackendDeferred::programSetConstantBlock(QSSGRenderBackendShaderProgramObject po,
+                                                        quint32 blockIndex,
+                                                        quint32 binding)
+{
+    m_commands.append(QSSGRenderCommands::ProgramSetConstantBlock{ po, blockIndex, binding });
+}
+
+void QSSGRenderBackendDeferred::programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    m_commands.append(QSSGRenderCommands::ProgramSetConstantBuffer{ index, bo });
+}
+
+void QSSGRenderBackendDeferred::programSetConstantBufferRange(quint32 index,
+                                                             QSSGRenderBackendBufferObject bo,
+                                                             quint32 offset,
+                                                             quint32 size)
+{
+    m_commands.append(QSSGRenderCommands::ProgramSetConstantBufferRange{ index, bo, offset, size });
+}
+
+qint32 QSSGRenderBackendDeferred::getStorageBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getStorageBufferCount(po);
+}
+
+qint32 QSSGRenderBackendDeferred::getStorageBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                           quint32 id,
+                                                           quint32 nameBufSize,
+                                                           qint32 *paramCount,
+                                                           qint32 *bufferSize,
+                                                           qint32 *length,
+                                                           char *nameBuf)
+{
+    return m_target->getStorageBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendDeferred::programSetStorageBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    m_commands.append(QSSGRenderCommands::ProgramSetStorageBuffer{ index, bo });
+}
+
+qint32 QSSGRenderBackendDeferred::getAtomicCounterBufferCount(QSSGRenderBackendShaderProgramObject po)
+{
+    return m_target->getAtomicCounterBufferCount(po);
+}
+
+qint32 QSSGRenderBackendDeferred::getAtomicCounterBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                                                 quint32 id,
+                                                                 quint32 nameBufSize,
+                                                                 qint32 *paramCount,
+                                                                 qint32 *bufferSize,
+                                                                 qint32 *length,
+                                                                 char *nameBuf)
+{
+    return m_target->getAtomicCounterBufferInfoByID(po, id, nameBufSize, paramCount, bufferSize, length, nameBuf);
+}
+
+void QSSGRenderBackendDeferred::programSetAtomicCounterBuffer(quint32 index, QSSGRenderBackendBufferObject bo)
+{
+    m_commands.append(QSSGRenderCommands::ProgramSetAtomicCounterBuffer{ index, bo });
+}
+
+void QSSGRenderBackendDeferred::setConstantValue(QSSGRenderBackendShaderProgramObject po,
+                                                 quint32 id,
+                                                 QSSGRenderShaderDataType type,
+                                                 qint32 count,
+                                                 const void *value,
+                                                 bool transpose)
+{
+    quint32 storageSize = 0;
+    const quint32 valueSize = QSSGRenderCommandList::constantValueSize(type, count, &storageSize);
+    auto *cmd = m_commands.append(QSSGRenderCommands::SetConstantValue{ po, id, type, count, storageSize, transpose }, storageSize);
+    quint8 *data = QSSGRenderCommandList::extraData(cmd);
+    ::memcpy(data, value, valueSize);
+    if (storageSize > valueSize)
+        ::memset(data + valueSize, 0, storageSize - valueSize);
+}
+
+void QSSGRenderBackendDeferred::draw(QSSGRenderDrawMode drawMode, quint32 start, quint32 count)
+{
+    m_commands.append(QSSGRenderCommands::Draw{ drawMode, start, count });
+}
+
+void QSSGRenderBackendDeferred::drawIndirect(QSSGRenderDrawMode drawMode, const void *indirect)
+{
+    m_commands.append(QSSGRenderCommands::DrawIndirect{ drawMode, reinterpret_cast<quintptr>(indirect) });
+}
+
+void QSSGRenderBackendDeferred::drawIndexed(QSSGRenderDrawMode drawMode,
+                                            quint32 count,
+                                            QSSGRenderComponentType type,
+                                            const void *indices)
+{
+    m_commands.append(QSSGRenderCommands::DrawIndexed{ drawMode, count, type, reinterpret_cast<quintptr>(indices) });
+}
+
+void QSSGRenderBackendDeferred::drawIndexedIndirect(QSSGRenderDrawMode drawMode,
+                                                    QSSGRenderComponentType type,
+                                                    const void *indirect)
+{
+    m_commands.append(QSSGRenderCommands::DrawIndexedIndirect{ drawMode, type, reinterpret_cast<quintptr>(indirect) });
+}
+
+void QSSGRenderBackendDeferred::readPixel(QSSGRenderBackendRenderTargetObject rto,
+                                          qint32 x,
+                                          qint32 y,
+                                          qint32 width,
+                                          qint32 height,
+                                          QSSGRenderReadPixelFormat inFormat,
+                                          QSSGByteRef pixels)
+{
+    flush();
+    m_target->readPixel(rto, x, y, width, height, inFormat, pixels);
+}
+
+QSSGRenderBackend::QSSGRenderBackendPathObject QSSGRenderBackendDeferred::createPathNVObject(size_t range)
+{
+    return m_target->createPathNVObject(range);
+}
+
+void QSSGRenderBackendDeferred::releasePathNVObject(QSSGRenderBackendPathObject po, size_t range)
+{
+    m_target->releasePathNVObject(po, range);
+}
+
+void QSSGRenderBackendDeferred::setPathSpecification(QSSGRenderBackendPathObject inPathObject,
+                                                     QSSGByteView inPathCommands,
+                                                     QSSGDataView<float> inPathCoords)
+{
+    m_target->setPathSpecification(inPathObject, inPathCommands, inPathCoords);
+}
+
+QSSGBounds3 QSSGRenderBackendDeferred::getPathObjectBoundingBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectBoundingBox(inPathObject);
+}
+
+QSSGBounds3 QSSGRenderBackendDeferred::getPathObjectFillBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectFillBox(inPathObject);
+}
+
+QSSGBounds3 QSSGRenderBackendDeferred::getPathObjectStrokeBox(QSSGRenderBackendPathObject inPathObject)
+{
+    return m_target->getPathObjectStrokeBox(inPathObject);
+}
+
+void QSSGRenderBackendDeferred::setStrokeWidth(QSSGRenderBackendPathObject inPathObject, float inStrokeWidth)
+{
+    m_target->setStrokeWidth(inPathObject, inStrokeWidth);
+}
+
+void QSSGRenderBackendDeferred::setPathProjectionMatrix(const QMatrix4x4 inPathProjection)
+{
+    m_target->setPathProjectionMatrix(inPathProjection);
+}
+
+void QSSGRenderBackendDeferred::setPathModelViewMatrix(const QMatrix4x4 inPathModelview)
+{
+    m_target->setPathModelViewMatrix(inPathModelview);
+}
+
+void QSSGRenderBackendDeferred::stencilStrokePath(QSSGRenderBackendPathObject inPathObject)
+{
+    m_target->stencilStrokePath(inPathObject);
+}
+
+void QSSGRenderBackendDeferred::stencilFillPath(QSSGRenderBackendPathObject inPathObject)
+{
+    m_target->stencilFillPath(inPathObject);
+}
+
+void QSSGRenderBackendDeferred::stencilFillPathInstanced(QSSGRenderBackendPathObject po,
+                                                         size_t numPaths,
+                                                         QSSGRenderPathFormatType type,
+                                                         const void *charCodes,
+                                                         QSSGRenderPathFillMode fillMode,
+                                                         quint32 stencilMask,
+                                                         QSSGRenderPathTransformType transformType,
+                                                         const float *transformValues)
+{
+    m_target->stencilFillPathInstanced(po,
+                                       numPaths,
+                                       type,
+                                       charCodes,
+                                       fillMode,
+                                       stencilMask,
+                                       transformType,
+                                       transformValues);
+}
+
+void QSSGRenderBackendDeferred::stencilStrokePathInstancedN(QSSGRenderBackendPathObject po,
+                                                            size_t numPaths,
+                                                            QSSGRenderPathFormatType type,
+                                                            const void *charCodes,
+                                                            qint32 stencilRef,
+                                                            quint32 stencilMask,
+                                                            QSSGRenderPathTransformType transformType,
+                                                            const float *transformValues)
+{
+    m_target->stencilStrokePathInstancedN(po,
+                                          numPaths,
+                                          type,
+                                          charCodes,
+                                          stencilRef,
+                                          stencilMask,
+                                          transformType,
+                                          transformValues);
+}
+
+void QSSGRenderBackendDeferred::coverFillPathInstanced(QSSGRenderBackendPathObject po,
+                                                       size_t numPaths,
+                                                       QSSGRenderPathFormatType type,
+                                                       const void *charCodes,
+                                                       QSSGRenderPathCoverMode coverMode,
+                                                       QSSGRenderPathTransformType transformType,
+                                                       const float *transformValues)
+{
+    m_target->coverFillPathInstanced(po, numPaths, type, charCodes, coverMode, transformType, transformValues);
+}
+
+void QSSGRenderBackendDeferred::coverStrokePathInstanced(QSSGRenderBackendPathObject po,
+                                                         size_t numPaths,
+                                                         QSSGRenderPathFormatType type,
+                                                         const void *charCodes,
+                                                         QSSGRenderPathCoverMode coverMode,
+                                                         QSSGRenderPathTransformType transformType,
+                                                         const float *transformValues)
+{
+    m_target->coverStrokePathInstanced(po, numPaths, type, charCodes, coverMode, transformType, transformValues);
+}
+
+void QSSGRenderBackendDeferred::setPathStencilDepthOffset(float inSlope, float inBias)
+{
+    m_target->setPathStencilDepthOffset(inSlope, inBias);
+}
+
+void QSSGRenderBackendDeferred::setPathCoverDepthFunc(QSSGRenderBoolOp inDepthFunction)
+{
+    m_target->setPathCoverDepthFunc(inDepthFunction);
+}
+
+void QSSGRenderBackendDeferred::loadPathGlyphs(QSSGRenderBackendPathObject po,
+                                               QSSGRenderPathFontTarget fontTarget,
+                                               const void *fontName,
+                                               QSSGRenderPathFontStyleFlags fontStyle,
+                                               size_t numGlyphs,
+                                               QSSGRenderPathFormatType type,
+                                               const void *charCodes,
+                                               QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                                               QSSGRenderBackendPathObject pathParameterTemplate,
+                                               float emScale)
+{
+    m_target->loadPathGlyphs(po,
+                             fontTarget,
+                             fontName,
+                             fontStyle,
+                             numGlyphs,
+                             type,
+                             charCodes,
+                             handleMissingGlyphs,
+                             pathParameterTemplate,
+                             emScale);
+}
+
+QSSGRenderPathReturnValues QSSGRenderBackendDeferred::loadPathGlyphsIndexed(
+        QSSGRenderBackendPathObject po,
+        QSSGRenderPathFontTarget fontTarget,
+        const void *fontName,
+        QSSGRenderPathFontStyleFlags fontStyle,
+        quint32 firstGlyphIndex,
+        size_t numGlyphs,
+        QSSGRenderBackendPathObject pathParameterTemplate,
+        float emScale)
+{
+    return m_target->loadPathGlyphsIndexed(po,
+                                           fontTarget,
+                                           fontName,
+                                           fontStyle,
+                                           firstGlyphIndex,
+                                           numGlyphs,
+                                           pathParameterTemplate,
+                                           emScale);
+}
+
+QSSGRenderBackend::QSSGRenderBackendPathObject QSSGRenderBackendDeferred::loadPathGlyphsIndexedRange(
+        QSSGRenderPathFontTarget fontTarget,
+        const void *fontName,
+        QSSGRenderPathFontStyleFlags fontStyle,
+        QSSGRenderBackendPathObject pathParameterTemplate,
+        float emScale,
+        quint32 *count)
+{
+    return m_target->loadPathGlyphsIndexedRange(fontTarget, fontName, fontStyle, pathParameterTemplate, emScale, count);
+}
+
+void QSSGRenderBackendDeferred::loadPathGlyphRange(QSSGRenderBackendPathObject po,
+                                                   QSSGRenderPathFontTarget fontTarget,
+                                                   const void *fontName,
+                                                   QSSGRenderPathFontStyleFlags fontStyle,
+                                                   quint32 firstGlyph,
+                                                   size_t numGlyphs,
+                                                   QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                                                   QSSGRenderBackendPathObject pathParameterTemplate,
+                                                   float emScale)
+{
+    m_target->loadPathGlyphRange(po,
+                                 fontTarget,
+                                 fontName,
+                                 fontStyle,
+                                 firstGlyph,
+                                 numGlyphs,
+                                 handleMissingGlyphs,
+                                 pathParameterTemplate,
+                                 emScale);
+}
+
+void QSSGRenderBackendDeferred::getPathMetrics(QSSGRenderBackendPathObject po,
+                                               size_t numPaths,
+                                               QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                                               QSSGRenderPathFormatType type,
+                                               const void *charCodes,
+                                               size_t stride,
+                                               float *metrics)
+{
+    m_target->getPathMetrics(po, numPaths, metricQueryMask, type, charCodes, stride, metrics);
+}
+
+void QSSGRenderBackendDeferred::getPathMetricsRange(QSSGRenderBackendPathObject po,
+                                                    size_t numPaths,
+                                                    QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                                                    size_t stride,
+                                                    float *metrics)
+{
+    m_target->getPathMetricsRange(po, numPaths, metricQueryMask, stride, metrics);
+}
+
+void QSSGRenderBackendDeferred::getPathSpacing(QSSGRenderBackendPathObject po,
+                                               size_t numPaths,
+                                               QSSGRenderPathListMode pathListMode,
+                                               QSSGRenderPathFormatType type,
+                                               const void *charCodes,
+                                               float advanceScale,
+                                               float kerningScale,
+                                               QSSGRenderPathTransformType transformType,
+                                               float *spacing)
+{
+    m_target->getPathSpacing(po,
+                             numPaths,
+                             pathListMode,
+                             type,
+                             charCodes,
+                             advanceScale,
+                             kerningScale,
+                             transformType,
+                             spacing);
+}
+
+QSurfaceFormat QSSGRenderBackendDeferred::format() const
+{
+    return m_target->format();
+}
+void QSSGRenderBackendDeferred::endFrame()
+{
+    m_target->endFrame();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,582 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_BACKEND_DEFERRED_H
+#define QSSG_RENDER_BACKEND_DEFERRED_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRender/private/qssgrenderbackend_p.h>
+#include <QtQuick3DRender/private/qssgrendercommandlist_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// A backend that records instead of executing.
+//
+// State changes, bindings, uniform updates, buffer updates and draw calls are
+// appended to a QSSGRenderCommandList owned by the backend and issued on the
+// target backend by submit(), in the order they were recorded.
+//
+// Everything else (resource creation and uploads, queries of results,
+// program introspection, path rendering) cannot be deferred and is forwarded
+// to the target right away. Resources referenced by the recorded commands
+// have to stay alive until they have been submitted. Calls that observe the
+// results of the recorded commands (mapping buffers, reading pixels, query
+// results and fences) first replay everything recorded before them, then run
+// on the target; commands recorded afterwards go to the now empty list and
+// are replayed by the next submit() or readback. The target therefore sees
+// the recorded commands and the readbacks in the order they were issued.
+//
+// The backend and the target are used from the thread owning the target's
+// context; recording passes on other threads is not supported yet.
+//
+// The render state getters answer from the state recorded so far and fall
+// back to querying the target for state that has not been set yet.
+class Q_QUICK3DRENDER_EXPORT QSSGRenderBackendDeferred : public QSSGRenderBackend
+{
+public:
+    explicit QSSGRenderBackendDeferred(const QSSGRef<QSSGRenderBackend> &inTarget);
+    ~QSSGRenderBackendDeferred() override;
+
+    const QSSGRef<QSSGRenderBackend> &target() const { return m_target; }
+
+    // Commands recorded since the last submit() or readback.
+    const QSSGRenderCommandList *commandList() const { return &m_commands; }
+
+    // Replay the recorded commands on the target and reset the list.
+    void submit();
+
+    /// backend interface
+
+    QSSGRenderContextType getRenderContextType() const override;
+    const char *getShadingLanguageVersion() override;
+    qint32 getMaxCombinedTextureUnits() override;
+    bool getRenderBackendCap(QSSGRenderBackendCaps inCap) const override;
+    void getRenderBackendValue(QSSGRenderBackendQuery inQuery, qint32 *params) const override;
+    qint32 getDepthBits() const override;
+    qint32 getStencilBits() const override;
+    void setRenderState(bool bEnable, const QSSGRenderState value) override;
+    bool getRenderState(const QSSGRenderState value) override;
+    QSSGRenderBoolOp getDepthFunc() override;
+    QSSGRenderBackendDepthStencilStateObject createDepthStencilState(
+            bool enableDepth,
+            bool depthMask,
+            QSSGRenderBoolOp depthFunc,
+            bool enableStencil,
+            QSSGRenderStencilFunction &stencilFuncFront,
+            QSSGRenderStencilFunction &stencilFuncBack,
+            QSSGRenderStencilOperation &depthStencilOpFront,
+            QSSGRenderStencilOperation &depthStencilOpBack) override;
+    void releaseDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState) override;
+    QSSGRenderBackendRasterizerStateObject createRasterizerState(float depthBias,
+                                                                 float depthScale,
+                                                                 QSSGRenderFace cullFace) override;
+    void releaseRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState) override;
+    void setDepthStencilState(QSSGRenderBackendDepthStencilStateObject depthStencilState) override;
+    void setRasterizerState(QSSGRenderBackendRasterizerStateObject rasterizerState) override;
+    void setDepthFunc(const QSSGRenderBoolOp func) override;
+    bool getDepthWrite() override;
+    void setDepthWrite(bool bEnable) override;
+    void setColorWrites(bool bRed, bool bGreen, bool bBlue, bool bAlpha) override;
+    void setMultisample(bool bEnable) override;
+    void getBlendFunc(QSSGRenderBlendFunctionArgument *pBlendFuncArg) override;
+    void setBlendFunc(const QSSGRenderBlendFunctionArgument &blendFuncArg) override;
+    void setBlendEquation(const QSSGRenderBlendEquationArgument &pBlendEquArg) override;
+    void setBlendBarrier() override;
+    void getScissorRect(QRect *pRect) override;
+    void setScissorRect(const QRect &rect) override;
+    void getViewportRect(QRect *pRect) override;
+    void setViewportRect(const QRect &rect) override;
+    void setClearColor(const QVector4D *pClearColor) override;
+    void clear(QSSGRenderClearFlags flags) override;
+    QSSGRenderBackendBufferObject createBuffer(QSSGRenderBufferType bindFlags,
+                                               QSSGRenderBufferUsageType usage,
+                                               QSSGByteView hostData) override;
+    void bindBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags) override;
+    void releaseBuffer(QSSGRenderBackendBufferObject bo) override;
+    void updateBuffer(QSSGRenderBackendBufferObject bo,
+                      QSSGRenderBufferType bindFlags,
+                      QSSGRenderBufferUsageType usage,
+                      QSSGByteView data) override;
+    void updateBufferRange(QSSGRenderBackendBufferObject bo,
+                           QSSGRenderBufferType bindFlags,
+                           size_t offset,
+                           QSSGByteView data) override;
+    void *mapBuffer(QSSGRenderBackendBufferObject bo,
+                    QSSGRenderBufferType bindFlags,
+                    size_t offset,
+                    size_t length,
+                    QSSGRenderBufferAccessFlags accessFlags) override;
+    bool unmapBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags) override;
+    void setMemoryBarrier(QSSGRenderBufferBarrierFlags barriers) override;
+    QSSGRenderBackendQueryObject createQuery() override;
+    void releaseQuery(QSSGRenderBackendQueryObject qo) override;
+    void beginQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type) override;
+    void endQuery(QSSGRenderBackendQueryObject qo, QSSGRenderQueryType type) override;
+    void getQueryResult(QSSGRenderBackendQueryObject qo,
+                        QSSGRenderQueryResultType resultType,
+                        quint32 *params) override;
+    void getQueryResult(QSSGRenderBackendQueryObject qo,
+                        QSSGRenderQueryResultType resultType,
+                        quint64 *params) override;
+    void setQueryTimer(QSSGRenderBackendQueryObject qo) override;
+    QSSGRenderBackendSyncObject createSync(QSSGRenderSyncType tpye, QSSGRenderSyncFlags syncFlags) override;
+    void releaseSync(QSSGRenderBackendSyncObject so) override;
+    void waitSync(QSSGRenderBackendSyncObject so, QSSGRenderCommandFlushFlags syncFlags, quint64 timeout) override;
+    bool isSyncSignaled(QSSGRenderBackendSyncObject so) override;
+    QSSGRenderBackendRenderTargetObject createRenderTarget() override;
+    void releaseRenderTarget(QSSGRenderBackendRenderTargetObject rto) override;
+    void renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                            QSSGRenderFrameBufferAttachment attachment,
+                            QSSGRenderBackendRenderbufferObject rbo) override;
+    void renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                            QSSGRenderFrameBufferAttachment attachment,
+                            QSSGRenderBackendTextureObject to,
+                            QSSGRenderTextureTargetType target) override;
+    void renderTargetAttach(QSSGRenderBackendRenderTargetObject rto,
+                            QSSGRenderFrameBufferAttachment attachment,
+                            QSSGRenderBackendTextureObject to,
+                            qint32 level,
+                            qint32 layer) override;
+    void setRenderTarget(QSSGRenderBackendRenderTargetObject rto) override;
+    bool renderTargetIsValid(QSSGRenderBackendRenderTargetObject rto) override;
+    void setReadTarget(QSSGRenderBackendRenderTargetObject rto) override;
+    void setDrawBuffers(QSSGRenderBackendRenderTargetObject rto, QSSGDataView<qint32> inDrawBufferSet) override;
+    void setReadBuffer(QSSGRenderBackendRenderTargetObject rto, QSSGReadFace inReadFace) override;
+    void blitFramebuffer(qint32 srcX0,
+                         qint32 srcY0,
+                         qint32 srcX1,
+                         qint32 srcY1,
+                         qint32 dstX0,
+                         qint32 dstY0,
+                         qint32 dstX1,
+                         qint32 dstY1,
+                         QSSGRenderClearFlags flags,
+                         QSSGRenderTextureMagnifyingOp filter) override;
+    QSSGRenderBackendRenderbufferObject createRenderbuffer(QSSGRenderRenderBufferFormat storageFormat,
+                                                           qint32 width,
+                                                           qint32 height) override;
+    void releaseRenderbuffer(QSSGRenderBackendRenderbufferObject rbo) override;
+    bool resizeRenderbuffer(QSSGRenderBackendRenderbufferObject rbo,
+                            QSSGRenderRenderBufferFormat storageFormat,
+                            qint32 width,
+                            qint32 height) override;
+    QSSGRenderBackendTextureObject createTexture() override;
+    void setTextureData2D(QSSGRenderBackendTextureObject to,
+                          QSSGRenderTextureTargetType target,
+                          qint32 level,
+                          QSSGRenderTextureFormat internalFormat,
+                          qint32 width,
+                          qint32 height,
+                          qint32 border,
+                          QSSGRenderTextureFormat format,
+                          QSSGByteView hostData) override;
+    void setTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                QSSGRenderTextureTargetType target,
+                                qint32 level,
+                                QSSGRenderTextureFormat internalFormat,
+                                qint32 width,
+                                qint32 height,
+                                qint32 border,
+                                QSSGRenderTextureFormat format,
+                                QSSGByteView hostData) override;
+    void createTextureStorage2D(QSSGRenderBackendTextureObject to,
+                                QSSGRenderTextureTargetType target,
+                                qint32 levels,
+                                QSSGRenderTextureFormat internalFormat,
+                                qint32 width,
+                                qint32 height) override;
+    void setTextureSubData2D(QSSGRenderBackendTextureObject to,
+                             QSSGRenderTextureTargetType target,
+                             qint32 level,
+                             qint32 xOffset,
+                             qint32 yOffset,
+                             qint32 width,
+                             qint32 height,
+                             QSSGRenderTextureFormat format,
+                             QSSGByteView hostData) override;
+    void setCompressedTextureData2D(QSSGRenderBackendTextureObject to,
+                                    QSSGRenderTextureTargetType target,
+                                    qint32 level,
+                                    QSSGRenderTextureFormat internalFormat,
+                                    qint32 width,
+                                    qint32 height,
+                                    qint32 border,
+                                    QSSGByteView hostData) override;
+    void setCompressedTextureDataCubeFace(QSSGRenderBackendTextureObject to,
+                                          QSSGRenderTextureTargetType target,
+                                          qint32 level,
+                                          QSSGRenderTextureFormat internalFormat,
+                                          qint32 width,
+                                          qint32 height,
+                                          qint32 border,
+                                          QSSGByteView hostData) override;
+    void setCompressedTextureSubData2D(QSSGRenderBackendTextureObject to,
+                                       QSSGRenderTextureTargetType target,
+                                       qint32 level,
+                                       qint32 xOffset,
+                                       qint32 yOffset,
+                                       qint32 width,
+                                       qint32 height,
+                                       QSSGRenderTextureFormat format,
+                                       QSSGByteView hostData) override;
+    void setMultisampledTextureData2D(QSSGRenderBackendTextureObject to,
+                                      QSSGRenderTextureTargetType target,
+                                      qint32 samples,
+                                      QSSGRenderTextureFormat internalFormat,
+                                      qint32 width,
+                                      qint32 height,
+                                      bool fixedsamplelocations) override;
+    void setTextureData3D(QSSGRenderBackendTextureObject to,
+                          QSSGRenderTextureTargetType target,
+                          qint32 level,
+                          QSSGRenderTextureFormat internalFormat,
+                          qint32 width,
+                          qint32 height,
+                          qint32 depth,
+                          qint32 border,
+                          QSSGRenderTextureFormat format,
+                          QSSGByteView hostData) override;
+    void generateMipMaps(QSSGRenderBackendTextureObject to,
+                         QSSGRenderTextureTargetType target,
+                         QSSGRenderHint genType) override;
+    void bindTexture(QSSGRenderBackendTextureObject to, QSSGRenderTextureTargetType target, qint32 unit) override;
+    void bindImageTexture(QSSGRenderBackendTextureObject to,
+                          quint32 unit,
+                          qint32 level,
+                          bool layered,
+                          qint32 layer,
+                          QSSGRenderImageAccessType accessFlags,
+                          QSSGRenderTextureFormat format) override;
+    void releaseTexture(QSSGRenderBackendTextureObject to) override;
+    QSSGRenderTextureSwizzleMode getTextureSwizzleMode(const QSSGRenderTextureFormat inFormat) const override;
+    QSSGRenderBackendSamplerObject createSampler(QSSGRenderTextureMinifyingOp minFilter,
+                                                 QSSGRenderTextureMagnifyingOp magFilter,
+                                                 QSSGRenderTextureCoordOp wrapS,
+                                                 QSSGRenderTextureCoordOp wrapT,
+                                                 QSSGRenderTextureCoordOp wrapR,
+                                                 qint32 minLod,
+                                                 qint32 maxLod,
+                                                 float lodBias,
+                                                 QSSGRenderTextureCompareMode compareMode,
+                                                 QSSGRenderTextureCompareOp compareFunc,
+                                                 float anisotropy,
+                                                 float *borderColor) override;
+    void updateSampler(QSSGRenderBackendSamplerObject so,
+                       QSSGRenderTextureTargetType target,
+                       QSSGRenderTextureMinifyingOp minFilter,
+                       QSSGRenderTextureMagnifyingOp magFilter,
+                       QSSGRenderTextureCoordOp wrapS,
+                       QSSGRenderTextureCoordOp wrapT,
+                       QSSGRenderTextureCoordOp wrapR,
+                       float minLod,
+                       float maxLod,
+                       float lodBias,
+                       QSSGRenderTextureCompareMode compareMode,
+                       QSSGRenderTextureCompareOp compareFunc,
+                       float anisotropy,
+                       float *borderColor) override;
+    void updateTextureSwizzle(QSSGRenderBackendTextureObject to,
+                              QSSGRenderTextureTargetType target,
+                              QSSGRenderTextureSwizzleMode swizzleMode) override;
+    void updateTextureObject(QSSGRenderBackendTextureObject to,
+                             QSSGRenderTextureTargetType target,
+                             qint32 baseLevel,
+                             qint32 maxLevel) override;
+    void releaseSampler(QSSGRenderBackendSamplerObject so) override;
+    QSSGRenderBackendAttribLayoutObject createAttribLayout(QSSGDataView<QSSGRenderVertexBufferEntry> attribs) override;
+    void releaseAttribLayout(QSSGRenderBackendAttribLayoutObject ao) override;
+    QSSGRenderBackendInputAssemblerObject createInputAssembler(
+            QSSGRenderBackendAttribLayoutObject attribLayout,
+            QSSGDataView<QSSGRenderBackendBufferObject> buffers,
+            const QSSGRenderBackendBufferObject indexBuffer,
+            QSSGDataView<quint32> strides,
+            QSSGDataView<quint32> offsets,
+            quint32 patchVertexCount) override;
+    void releaseInputAssembler(QSSGRenderBackendInputAssemblerObject iao) override;
+    bool setInputAssembler(QSSGRenderBackendInputAssemblerObject iao, QSSGRenderBackendShaderProgramObject po) override;
+    void setPatchVertexCount(QSSGRenderBackendInputAssemblerObject iao, quint32 count) override;
+    QSSGRenderBackendVertexShaderObject createVertexShader(QSSGByteView source,
+                                                           QByteArray &errorMessage,
+                                                           bool binary) override;
+    void releaseVertexShader(QSSGRenderBackendVertexShaderObject vso) override;
+    QSSGRenderBackendFragmentShaderObject createFragmentShader(QSSGByteView source,
+                                                               QByteArray &errorMessage,
+                                                               bool binary) override;
+    void releaseFragmentShader(QSSGRenderBackendFragmentShaderObject fso) override;
+    QSSGRenderBackendTessControlShaderObject createTessControlShader(QSSGByteView source,
+                                                                     QByteArray &errorMessage,
+                                                                     bool binary) override;
+    void releaseTessControlShader(QSSGRenderBackendTessControlShaderObject tcso) override;
+    QSSGRenderBackendTessEvaluationShaderObject createTessEvaluationShader(QSSGByteView source,
+                                                                           QByteArray &errorMessage,
+                                                                           bool binary) override;
+    void releaseTessEvaluationShader(QSSGRenderBackendTessEvaluationShaderObject teso) override;
+    QSSGRenderBackendGeometryShaderObject createGeometryShader(QSSGByteView source,
+                                                               QByteArray &errorMessage,
+                                                               bool binary) override;
+    void releaseGeometryShader(QSSGRenderBackendGeometryShaderObject gso) override;
+    QSSGRenderBackendComputeShaderObject createComputeShader(QSSGByteView source,
+                                                             QByteArray &errorMessage,
+                                                             bool binary) override;
+    void releaseComputeShader(QSSGRenderBackendComputeShaderObject cso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendVertexShaderObject vso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendVertexShaderObject vso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendFragmentShaderObject fso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendFragmentShaderObject fso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendTessControlShaderObject tcso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendTessControlShaderObject tcso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po,
+                      QSSGRenderBackendTessEvaluationShaderObject teso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po,
+                      QSSGRenderBackendTessEvaluationShaderObject teso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendGeometryShaderObject gso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendGeometryShaderObject gso) override;
+    void attachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendComputeShaderObject cso) override;
+    void detachShader(QSSGRenderBackendShaderProgramObject po, QSSGRenderBackendComputeShaderObject cso) override;
+    QSSGRenderBackendShaderProgramObject createShaderProgram(bool isSeparable) override;
+    void releaseShaderProgram(QSSGRenderBackendShaderProgramObject po) override;
+    bool linkProgram(QSSGRenderBackendShaderProgramObject po, QByteArray &errorMessage) override;
+    void startLinkProgram(QSSGRenderBackendShaderProgramObject po) override;
+    bool isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po) override;
+    void setActiveProgram(QSSGRenderBackendShaderProgramObject po) override;
+    QSSGRenderBackendProgramPipeline createProgramPipeline() override;
+    void releaseProgramPipeline(QSSGRenderBackendProgramPipeline ppo) override;
+    void setActiveProgramPipeline(QSSGRenderBackendProgramPipeline ppo) override;
+    void setProgramStages(QSSGRenderBackendProgramPipeline ppo,
+                          QSSGRenderShaderTypeFlags flags,
+                          QSSGRenderBackendShaderProgramObject po) override;
+    void dispatchCompute(QSSGRenderBackendShaderProgramObject po,
+                         quint32 numGroupsX,
+                         quint32 numGroupsY,
+                         quint32 numGroupsZ) override;
+    qint32 getConstantCount(QSSGRenderBackendShaderProgramObject po) override;
+    qint32 getConstantBufferCount(QSSGRenderBackendShaderProgramObject po) override;
+    qint32 getConstantInfoByID(QSSGRenderBackendShaderProgramObject po,
+                               quint32 id,
+                               quint32 bufSize,
+                               qint32 *numElem,
+                               QSSGRenderShaderDataType *type,
+                               qint32 *binding,
+                               char *nameBuf) override;
+    qint32 getConstantBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                     quint32 id,
+                                     quint32 nameBufSize,
+                                     qint32 *paramCount,
+                                     qint32 *bufferSize,
+                                     qint32 *length,
+                                     char *nameBuf) override;
+    void getConstantBufferParamIndices(QSSGRenderBackendShaderProgramObject po, quint32 id, qint32 *indices) override;
+    void getConstantBufferParamInfoByIndices(QSSGRenderBackendShaderProgramObject po,
+                                             quint32 count,
+                                             quint32 *indices,
+                                             QSSGRenderShaderDataType *type,
+                                             qint32 *size,
+                                             qint32 *offset) override;
+    void programSetConstantBlock(QSSGRenderBackendShaderProgramObject po, quint32 blockIndex, quint32 binding) override;
+    void programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) override;
+    qint32 getStorageBufferCount(QSSGRenderBackendShaderProgramObject po) override;
+    qint32 getStorageBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                    quint32 id,
+                                    quint32 nameBufSize,
+                                    qint32 *paramCount,
+                                    qint32 *bufferSize,
+                                    qint32 *length,
+                                    char *nameBuf) override;
+    void programSetStorageBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    qint32 getAtomicCounterBufferCount(QSSGRenderBackendShaderProgramObject po) override;
+    qint32 getAtomicCounterBufferInfoByID(QSSGRenderBackendShaderProgramObject po,
+                                          quint32 id,
+                                          quint32 nameBufSize,
+                                          qint32 *paramCount,
+                                          qint32 *bufferSize,
+                                          qint32 *length,
+                                          char *nameBuf) override;
+    void programSetAtomicCounterBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    void setConstantValue(QSSGRenderBackendShaderProgramObject po,
+                          quint32 id,
+                          QSSGRenderShaderDataType type,
+                          qint32 count,
+                          const void *value,
+                          bool transpose) override;
+    void draw(QSSGRenderDrawMode drawMode, quint32 start, quint32 count) override;
+    void drawIndirect(QSSGRenderDrawMode drawMode, const void *indirect) override;
+    void drawIndexed(QSSGRenderDrawMode drawMode,
+                     quint32 count,
+                     QSSGRenderComponentType type,
+                     const void *indices) override;
+    void drawIndexedIndirect(QSSGRenderDrawMode drawMode, QSSGRenderComponentType type, const void *indirect) override;
+    void readPixel(QSSGRenderBackendRenderTargetObject rto,
+                   qint32 x,
+                   qint32 y,
+                   qint32 width,
+                   qint32 height,
+                   QSSGRenderReadPixelFormat inFormat,
+                   QSSGByteRef pixels) override;
+    QSSGRenderBackendPathObject createPathNVObject(size_t range) override;
+    void releasePathNVObject(QSSGRenderBackendPathObject po, size_t range) override;
+    void setPathSpecification(QSSGRenderBackendPathObject inPathObject,
+                              QSSGByteView inPathCommands,
+                              QSSGDataView<float> inPathCoords) override;
+    QSSGBounds3 getPathObjectBoundingBox(QSSGRenderBackendPathObject inPathObject) override;
+    QSSGBounds3 getPathObjectFillBox(QSSGRenderBackendPathObject inPathObject) override;
+    QSSGBounds3 getPathObjectStrokeBox(QSSGRenderBackendPathObject inPathObject) override;
+    void setStrokeWidth(QSSGRenderBackendPathObject inPathObject, float inStrokeWidth) override;
+    void setPathProjectionMatrix(const QMatrix4x4 inPathProjection) override;
+    void setPathModelViewMatrix(const QMatrix4x4 inPathModelview) override;
+    void stencilStrokePath(QSSGRenderBackendPathObject inPathObject) override;
+    void stencilFillPath(QSSGRenderBackendPathObject inPathObject) override;
+    void stencilFillPathInstanced(QSSGRenderBackendPathObject po,
+                                  size_t numPaths,
+                                  QSSGRenderPathFormatType type,
+                                  const void *charCodes,
+                                  QSSGRenderPathFillMode fillMode,
+                                  quint32 stencilMask,
+                                  QSSGRenderPathTransformType transformType,
+                                  const float *transformValues) override;
+    void stencilStrokePathInstancedN(QSSGRenderBackendPathObject po,
+                                     size_t numPaths,
+                                     QSSGRenderPathFormatType type,
+                                     const void *charCodes,
+                                     qint32 stencilRef,
+                                     quint32 stencilMask,
+                                     QSSGRenderPathTransformType transformType,
+                                     const float *transformValues) override;
+    void coverFillPathInstanced(QSSGRenderBackendPathObject po,
+                                size_t numPaths,
+                                QSSGRenderPathFormatType type,
+                                const void *charCodes,
+                                QSSGRenderPathCoverMode coverMode,
+                                QSSGRenderPathTransformType transformType,
+                                const float *transformValues) override;
+    void coverStrokePathInstanced(QSSGRenderBackendPathObject po,
+                                  size_t numPaths,
+                                  QSSGRenderPathFormatType type,
+                                  const void *charCodes,
+                                  QSSGRenderPathCoverMode coverMode,
+                                  QSSGRenderPathTransformType transformType,
+                                  const float *transformValues) override;
+    void setPathStencilDepthOffset(float inSlope, float inBias) override;
+    void setPathCoverDepthFunc(QSSGRenderBoolOp inDepthFunction) override;
+    void loadPathGlyphs(QSSGRenderBackendPathObject po,
+                        QSSGRenderPathFontTarget fontTarget,
+                        const void *fontName,
+                        QSSGRenderPathFontStyleFlags fontStyle,
+                        size_t numGlyphs,
+                        QSSGRenderPathFormatType type,
+                        const void *charCodes,
+                        QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                        QSSGRenderBackendPathObject pathParameterTemplate,
+                        float emScale) override;
+    QSSGRenderPathReturnValues loadPathGlyphsIndexed(QSSGRenderBackendPathObject po,
+                                                     QSSGRenderPathFontTarget fontTarget,
+                                                     const void *fontName,
+                                                     QSSGRenderPathFontStyleFlags fontStyle,
+                                                     quint32 firstGlyphIndex,
+                                                     size_t numGlyphs,
+                                                     QSSGRenderBackendPathObject pathParameterTemplate,
+                                                     float emScale) override;
+    QSSGRenderBackendPathObject loadPathGlyphsIndexedRange(QSSGRenderPathFontTarget fontTarget,
+                                                           const void *fontName,
+                                                           QSSGRenderPathFontStyleFlags fontStyle,
+                                                           QSSGRenderBackendPathObject pathParameterTemplate,
+                                                           float emScale,
+                                                           quint32 *count) override;
+    void loadPathGlyphRange(QSSGRenderBackendPathObject po,
+                            QSSGRenderPathFontTarget fontTarget,
+                            const void *fontName,
+                            QSSGRenderPathFontStyleFlags fontStyle,
+                            quint32 firstGlyph,
+                            size_t numGlyphs,
+                            QSSGRenderPathMissingGlyphs handleMissingGlyphs,
+                            QSSGRenderBackendPathObject pathParameterTemplate,
+                            float emScale) override;
+    void getPathMetrics(QSSGRenderBackendPathObject po,
+                        size_t numPaths,
+                        QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                        QSSGRenderPathFormatType type,
+                        const void *charCodes,
+                        size_t stride,
+                        float *metrics) override;
+    void getPathMetricsRange(QSSGRenderBackendPathObject po,
+                             size_t numPaths,
+                             QSSGRenderPathGlyphFontMetricFlags metricQueryMask,
+                             size_t stride,
+                             float *metrics) override;
+    void getPathSpacing(QSSGRenderBackendPathObject po,
+                        size_t numPaths,
+                        QSSGRenderPathListMode pathListMode,
+                        QSSGRenderPathFormatType type,
+                        const void *charCodes,
+                        float advanceScale,
+                        float kerningScale,
+                        QSSGRenderPathTransformType transformType,
+                        float *spacing) override;
+    QSurfaceFormat format() const override;
+    void endFrame() override;
+
+private:
+    enum KnownStateFlag : quint32
+    {
+        KnownDepthFunc = 1 << 0,
+        KnownBlendFunc = 1 << 1,
+        KnownScissorRect = 1 << 2,
+        KnownViewportRect = 1 << 3
+    };
+
+    void setShadowRenderState(QSSGRenderState inState, bool inEnabled);
+    // Replays the commands recorded so far, if any, before a readback
+    void flush();
+
+    QSSGRef<QSSGRenderBackend> m_target;
+    QSSGRenderCommandList m_commands;
+
+    // shadow copy of the recorded state
+    quint32 m_knownState = 0;
+    quint32 m_knownRenderStates = 0;
+    quint32 m_renderStates = 0;
+    QSSGRenderBoolOp m_depthFunc = QSSGRenderBoolOp::Less;
+    QSSGRenderBlendFunctionArgument m_blendFunc;
+    QRect m_scissorRect;
+    QRect m_viewportRect;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,1116 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick3DRender/private/qssgrendercommandlist_p.h>
+
+#include <QtCore/QIODevice>
+#include <QtCore/QVarLengthArray>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+inline size_t alignedSize(size_t inSize)
+{
+    return (inSize + QSSGRenderCommandList::Alignment - 1) & ~(QSSGRenderCommandList::Alignment - 1);
+}
+
+template<typename TCommand>
+inline const TCommand &payload(const QSSGRenderCommandList::Header *inHeader)
+{
+    return *reinterpret_cast<const TCommand *>(inHeader + 1);
+}
+
+template<typename TCommand>
+inline quint8 *payloadData(const QSSGRenderCommandList::Header *inHeader)
+{
+    // Trailing data is handed to the backend as is, the GL backend converts
+    // boolean uniforms in place which is why this is not const.
+    return reinterpret_cast<quint8 *>(const_cast<QSSGRenderCommandList::Header *>(inHeader) + 1) + sizeof(TCommand);
+}
+
+using QSSGRenderCommands::ShaderObject;
+using QSSGRenderCommands::ShaderStage;
+
+template<typename THandle>
+inline THandle mapHandle(const QSSGRenderHandleMap *inHandles, THandle inHandle)
+{
+    return inHandles ? inHandles->map(inHandle) : inHandle;
+}
+
+template<typename THandle>
+inline void insertHandle(QSSGRenderHandleMap *ioHandles,
+                         QSSGRenderCommandType inCreatedBy,
+                         THandle inRecorded,
+                         THandle inCreated,
+                         ShaderStage inStage = ShaderStage::Vertex)
+{
+    if (ioHandles)
+        ioHandles->insert(inRecorded, inCreated, inCreatedBy, inStage);
+}
+
+template<typename THandle>
+inline void removeHandle(QSSGRenderHandleMap *ioHandles, THandle inRecorded)
+{
+    if (ioHandles)
+        ioHandles->remove(inRecorded);
+}
+
+ShaderObject createShader(QSSGRenderBackend *inBackend, ShaderStage inStage, QSSGByteView inSource, bool inBinary)
+{
+    QByteArray errorMessage;
+    switch (inStage) {
+    case ShaderStage::Vertex:
+        return inBackend->createVertexShader(inSource, errorMessage, inBinary);
+    case ShaderStage::Fragment:
+        return inBackend->createFragmentShader(inSource, errorMessage, inBinary);
+    case ShaderStage::TessControl:
+        return inBackend->createTessControlShader(inSource, errorMessage, inBinary);
+    case ShaderStage::TessEvaluation:
+        return inBackend->createTessEvaluationShader(inSource, errorMessage, inBinary);
+    case ShaderStage::Geometry:
+        return inBackend->createGeometryShader(inSource, errorMessage, inBinary);
+    case ShaderStage::Compute:
+        return inBackend->createComputeShader(inSource, errorMessage, inBinary);
+    }
+    Q_UNREACHABLE();
+    return nullptr;
+}
+
+void releaseShader(QSSGRenderBackend *inBackend, ShaderStage inStage, ShaderObject inShader)
+{
+    switch (inStage) {
+    case ShaderStage::Vertex:
+        inBackend->releaseVertexShader(static_cast<QSSGRenderBackend::QSSGRenderBackendVertexShaderObject>(inShader));
+        break;
+    case ShaderStage::Fragment:
+        inBackend->releaseFragmentShader(static_cast<QSSGRenderBackend::QSSGRenderBackendFragmentShaderObject>(inShader));
+        break;
+    case ShaderStage::TessControl:
+        inBackend->releaseTessControlShader(static_cast<QSSGRenderBackend::QSSGRenderBackendTessControlShaderObject>(inShader));
+        break;
+    case ShaderStage::TessEvaluation:
+        inBackend->releaseTessEvaluationShader(static_cast<QSSGRenderBackend::QSSGRenderBackendTessEvaluationShaderObject>(inShader));
+        break;
+    case ShaderStage::Geometry:
+        inBackend->releaseGeometryShader(static_cast<QSSGRenderBackend::QSSGRenderBackendGeometryShaderObject>(inShader));
+        break;
+    case ShaderStage::Compute:
+        inBackend->releaseComputeShader(static_cast<QSSGRenderBackend::QSSGRenderBackendComputeShaderObject>(inShader));
+        break;
+    }
+}
+
+template<typename TShader>
+inline void attachShader(QSSGRenderBackend *inBackend,
+                         QSSGRenderBackend::QSSGRenderBackendShaderProgramObject inProgram,
+                         TShader inShader,
+                         bool inAttach)
+{
+    if (inAttach)
+        inBackend->attachShader(inProgram, inShader);
+    else
+        inBackend->detachShader(inProgram, inShader);
+}
+
+void attachShader(QSSGRenderBackend *inBackend,
+                  QSSGRenderBackend::QSSGRenderBackendShaderProgramObject inProgram,
+                  ShaderStage inStage,
+                  ShaderObject inShader,
+                  bool inAttach)
+{
+    switch (inStage) {
+    case ShaderStage::Vertex:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendVertexShaderObject>(inShader), inAttach);
+        break;
+    case ShaderStage::Fragment:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendFragmentShaderObject>(inShader), inAttach);
+        break;
+    case ShaderStage::TessControl:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendTessControlShaderObject>(inShader), inAttach);
+        break;
+    case ShaderStage::TessEvaluation:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendTessEvaluationShaderObject>(inShader), inAttach);
+        break;
+    case ShaderStage::Geometry:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendGeometryShaderObject>(inShader), inAttach);
+        break;
+    case ShaderStage::Compute:
+        attachShader(inBackend, inProgram, static_cast<QSSGRenderBackend::QSSGRenderBackendComputeShaderObject>(inShader), inAttach);
+        break;
+    }
+}
+
+void replayCommand(QSSGRenderBackend *inBackend, const QSSGRenderCommandList::Header *inHeader, QSSGRenderHandleMap *ioHandles)
+{
+    using namespace QSSGRenderCommands;
+
+    switch (inHeader->type) {
+    case QSSGRenderCommandType::SetRenderState: {
+        const auto &cmd = payload<SetRenderState>(inHeader);
+        inBackend->setRenderState(cmd.enable, cmd.state);
+    } break;
+    case QSSGRenderCommandType::SetDepthStencilState:
+        inBackend->setDepthStencilState(mapHandle(ioHandles, payload<SetDepthStencilState>(inHeader).depthStencilState));
+        break;
+    case QSSGRenderCommandType::SetRasterizerState:
+        inBackend->setRasterizerState(mapHandle(ioHandles, payload<SetRasterizerState>(inHeader).rasterizerState));
+        break;
+    case QSSGRenderCommandType::SetDepthFunc:
+        inBackend->setDepthFunc(payload<SetDepthFunc>(inHeader).func);
+        break;
+    case QSSGRenderCommandType::SetDepthWrite:
+        inBackend->setDepthWrite(payload<SetDepthWrite>(inHeader).enable);
+        break;
+    case QSSGRenderCommandType::SetColorWrites: {
+        const auto &cmd = payload<SetColorWrites>(inHeader);
+        inBackend->setColorWrites(cmd.red, cmd.green, cmd.blue, cmd.alpha);
+    } break;
+    case QSSGRenderCommandType::SetMultisample:
+        inBackend->setMultisample(payload<SetMultisample>(inHeader).enable);
+        break;
+    case QSSGRenderCommandType::SetBlendFunc:
+        inBackend->setBlendFunc(payload<SetBlendFunc>(inHeader).blendFunc);
+        break;
+    case QSSGRenderCommandType::SetBlendEquation:
+        inBackend->setBlendEquation(payload<SetBlendEquation>(inHeader).blendEquation);
+        break;
+    case QSSGRenderCommandType::SetBlendBarrier:
+        inBackend->setBlendBarrier();
+        break;
+    case QSSGRenderCommandType::SetScissorRect:
+        inBackend->setScissorRect(payload<SetScissorRect>(inHeader).rect);
+        break;
+    case QSSGRenderCommandType::SetViewportRect:
+        inBackend->setViewportRect(payload<SetViewportRect>(inHeader).rect);
+        break;
+    case QSSGRenderCommandType::SetClearColor:
+        inBackend->setClearColor(&payload<SetClearColor>(inHeader).color);
+        break;
+    case QSSGRenderCommandType::Clear:
+        inBackend->clear(payload<Clear>(inHeader).flags);
+        break;
+    case QSSGRenderCommandType::BindBuffer: {
+        const auto &cmd = payload<BindBuffer>(inHeader);
+        inBackend->bindBuffer(mapHandle(ioHandles, cmd.bo), cmd.bindFlags);
+    } break;
+    case QSSGRenderCommandType::UpdateBuffer: {
+        const auto &cmd = payload<UpdateBuffer>(inHeader);
+        inBackend->updateBuffer(mapHandle(ioHandles, cmd.bo), cmd.bindFlags, cmd.usage, QSSGByteView(payloadData<UpdateBuffer>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::UpdateBufferRange: {
+        const auto &cmd = payload<UpdateBufferRange>(inHeader);
+        inBackend->updateBufferRange(mapHandle(ioHandles, cmd.bo), cmd.bindFlags, cmd.offset, QSSGByteView(payloadData<UpdateBufferRange>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetMemoryBarrier:
+        inBackend->setMemoryBarrier(payload<SetMemoryBarrier>(inHeader).barriers);
+        break;
+    case QSSGRenderCommandType::BeginQuery: {
+        const auto &cmd = payload<BeginQuery>(inHeader);
+        inBackend->beginQuery(mapHandle(ioHandles, cmd.qo), cmd.type);
+    } break;
+    case QSSGRenderCommandType::EndQuery: {
+        const auto &cmd = payload<EndQuery>(inHeader);
+        inBackend->endQuery(mapHandle(ioHandles, cmd.qo), cmd.type);
+    } break;
+    case QSSGRenderCommandType::SetQueryTimer:
+        inBackend->setQueryTimer(mapHandle(ioHandles, payload<SetQueryTimer>(inHeader).qo));
+        break;
+    case QSSGRenderCommandType::SetRenderTarget:
+        inBackend->setRenderTarget(mapHandle(ioHandles, payload<SetRenderTarget>(inHeader).rto));
+        break;
+    case QSSGRenderCommandType::SetReadTarget:
+        inBackend->setReadTarget(mapHandle(ioHandles, payload<SetReadTarget>(inHeader).rto));
+        break;
+    case QSSGRenderCommandType::SetDrawBuffers: {
+        const auto &cmd = payload<SetDrawBuffers>(inHeader);
+        const qint32 *drawBuffers = reinterpret_cast<const qint32 *>(payloadData<SetDrawBuffers>(inHeader));
+        inBackend->setDrawBuffers(mapHandle(ioHandles, cmd.rto), QSSGDataView<qint32>(drawBuffers, qint32(cmd.count)));
+    } break;
+    case QSSGRenderCommandType::SetReadBuffer: {
+        const auto &cmd = payload<SetReadBuffer>(inHeader);
+        inBackend->setReadBuffer(mapHandle(ioHandles, cmd.rto), cmd.readFace);
+    } break;
+    case QSSGRenderCommandType::BlitFramebuffer: {
+        const auto &cmd = payload<BlitFramebuffer>(inHeader);
+        inBackend->blitFramebuffer(cmd.srcX0, cmd.srcY0, cmd.srcX1, cmd.srcY1,
+                                   cmd.dstX0, cmd.dstY0, cmd.dstX1, cmd.dstY1,
+                                   cmd.flags, cmd.filter);
+    } break;
+    case QSSGRenderCommandType::GenerateMipMaps: {
+        const auto &cmd = payload<GenerateMipMaps>(inHeader);
+        inBackend->generateMipMaps(mapHandle(ioHandles, cmd.to), cmd.target, cmd.genType);
+    } break;
+    case QSSGRenderCommandType::BindTexture: {
+        const auto &cmd = payload<BindTexture>(inHeader);
+        inBackend->bindTexture(mapHandle(ioHandles, cmd.to), cmd.target, cmd.unit);
+    } break;
+    case QSSGRenderCommandType::BindImageTexture: {
+        const auto &cmd = payload<BindImageTexture>(inHeader);
+        inBackend->bindImageTexture(mapHandle(ioHandles, cmd.to), cmd.unit, cmd.level, cmd.layered, cmd.layer, cmd.accessFlags, cmd.format);
+    } break;
+    case QSSGRenderCommandType::UpdateSampler: {
+        const auto &cmd = payload<UpdateSampler>(inHeader);
+        float borderColor[4] = { cmd.borderColor[0], cmd.borderColor[1], cmd.borderColor[2], cmd.borderColor[3] };
+        inBackend->updateSampler(mapHandle(ioHandles, cmd.so), cmd.target, cmd.minFilter, cmd.magFilter,
+                                 cmd.wrapS, cmd.wrapT, cmd.wrapR,
+                                 cmd.minLod, cmd.maxLod, cmd.lodBias,
+                                 cmd.compareMode, cmd.compareFunc, cmd.anisotropy,
+                                 cmd.hasBorderColor ? borderColor : nullptr);
+    } break;
+    case QSSGRenderCommandType::UpdateTextureSwizzle: {
+        const auto &cmd = payload<UpdateTextureSwizzle>(inHeader);
+        inBackend->updateTextureSwizzle(mapHandle(ioHandles, cmd.to), cmd.target, cmd.swizzleMode);
+    } break;
+    case QSSGRenderCommandType::UpdateTextureObject: {
+        const auto &cmd = payload<UpdateTextureObject>(inHeader);
+        inBackend->updateTextureObject(mapHandle(ioHandles, cmd.to), cmd.target, cmd.baseLevel, cmd.maxLevel);
+    } break;
+    case QSSGRenderCommandType::SetInputAssembler: {
+        const auto &cmd = payload<SetInputAssembler>(inHeader);
+        inBackend->setInputAssembler(mapHandle(ioHandles, cmd.iao), mapHandle(ioHandles, cmd.po));
+    } break;
+    case QSSGRenderCommandType::SetPatchVertexCount: {
+        const auto &cmd = payload<SetPatchVertexCount>(inHeader);
+        inBackend->setPatchVertexCount(mapHandle(ioHandles, cmd.iao), cmd.count);
+    } break;
+    case QSSGRenderCommandType::SetActiveProgram:
+        inBackend->setActiveProgram(mapHandle(ioHandles, payload<SetActiveProgram>(inHeader).po));
+        break;
+    case QSSGRenderCommandType::SetActiveProgramPipeline:
+        inBackend->setActiveProgramPipeline(mapHandle(ioHandles, payload<SetActiveProgramPipeline>(inHeader).ppo));
+        break;
+    case QSSGRenderCommandType::SetProgramStages: {
+        const auto &cmd = payload<SetProgramStages>(inHeader);
+        inBackend->setProgramStages(mapHandle(ioHandles, cmd.ppo), cmd.flags, mapHandle(ioHandles, cmd.po));
+    } break;
+    case QSSGRenderCommandType::DispatchCompute: {
+        const auto &cmd = payload<DispatchCompute>(inHeader);
+        inBackend->dispatchCompute(mapHandle(ioHandles, cmd.po), cmd.numGroupsX, cmd.numGroupsY, cmd.numGroupsZ);
+    } break;
+    case QSSGRenderCommandType::ProgramSetConstantBlock: {
+        const auto &cmd = payload<ProgramSetConstantBlock>(inHeader);
+        inBackend->programSetConstantBlock(mapHandle(ioHandles, cmd.po), cmd.blockIndex, cmd.binding);
+    } break;
+    case QSSGRenderCommandType::ProgramSetConstantBuffer: {
+        const auto &cmd = payload<ProgramSetConstantBuffer>(inHeader);
+        inBackend->programSetConstantBuffer(cmd.index, mapHandle(ioHandles, cmd.bo));
+    } break;
+    case QSSGRenderCommandType::ProgramSetConstantBufferRange: {
+        const auto &cmd = payload<ProgramSetConstantBufferRange>(inHeader);
+        inBackend->programSetConstantBufferRange(cmd.index, mapHandle(ioHandles, cmd.bo), cmd.offset, cmd.size);
+    } break;
+    case QSSGRenderCommandType::ProgramSetStorageBuffer: {
+        const auto &cmd = payload<ProgramSetStorageBuffer>(inHeader);
+        inBackend->programSetStorageBuffer(cmd.index, mapHandle(ioHandles, cmd.bo));
+    } break;
+    case QSSGRenderCommandType::ProgramSetAtomicCounterBuffer: {
+        const auto &cmd = payload<ProgramSetAtomicCounterBuffer>(inHeader);
+        inBackend->programSetAtomicCounterBuffer(cmd.index, mapHandle(ioHandles, cmd.bo));
+    } break;
+    case QSSGRenderCommandType::SetConstantValue: {
+        const auto &cmd = payload<SetConstantValue>(inHeader);
+        inBackend->setConstantValue(mapHandle(ioHandles, cmd.po), cmd.id, cmd.type, cmd.count, payloadData<SetConstantValue>(inHeader), cmd.transpose);
+    } break;
+    case QSSGRenderCommandType::Draw: {
+        const auto &cmd = payload<Draw>(inHeader);
+        inBackend->draw(cmd.drawMode, cmd.start, cmd.count);
+    } break;
+    case QSSGRenderCommandType::DrawIndirect: {
+        const auto &cmd = payload<DrawIndirect>(inHeader);
+        inBackend->drawIndirect(cmd.drawMode, reinterpret_cast<const void *>(cmd.indirect));
+    } break;
+    case QSSGRenderCommandType::DrawIndexed: {
+        const auto &cmd = payload<DrawIndexed>(inHeader);
+        inBackend->drawIndexed(cmd.drawMode, cmd.count, cmd.type, reinterpret_cast<const void *>(cmd.indices));
+    } break;
+    case QSSGRenderCommandType::DrawIndexedIndirect: {
+        const auto &cmd = payload<DrawIndexedIndirect>(inHeader);
+        inBackend->drawIndexedIndirect(cmd.drawMode, cmd.type, reinterpret_cast<const void *>(cmd.indirect));
+    } break;
+    case QSSGRenderCommandType::CreateDepthStencilState: {
+        const auto &cmd = payload<CreateDepthStencilState>(inHeader);
+        QSSGRenderStencilFunction stencilFuncFront = cmd.stencilFuncFront;
+        QSSGRenderStencilFunction stencilFuncBack = cmd.stencilFuncBack;
+        QSSGRenderStencilOperation depthStencilOpFront = cmd.depthStencilOpFront;
+        QSSGRenderStencilOperation depthStencilOpBack = cmd.depthStencilOpBack;
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createDepthStencilState(cmd.enableDepth,
+                                                                                               cmd.depthMask,
+                                                                                               cmd.depthFunc,
+                                                                                               cmd.enableStencil,
+                                                                                               stencilFuncFront,
+                                                                                               stencilFuncBack,
+                                                                                               depthStencilOpFront,
+                                                                                               depthStencilOpBack));
+    } break;
+    case QSSGRenderCommandType::ReleaseDepthStencilState: {
+        const auto &cmd = payload<ReleaseDepthStencilState>(inHeader);
+        inBackend->releaseDepthStencilState(mapHandle(ioHandles, cmd.depthStencilState));
+        removeHandle(ioHandles, cmd.depthStencilState);
+    } break;
+    case QSSGRenderCommandType::CreateRasterizerState: {
+        const auto &cmd = payload<CreateRasterizerState>(inHeader);
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createRasterizerState(cmd.depthBias, cmd.depthScale, cmd.cullFace));
+    } break;
+    case QSSGRenderCommandType::ReleaseRasterizerState: {
+        const auto &cmd = payload<ReleaseRasterizerState>(inHeader);
+        inBackend->releaseRasterizerState(mapHandle(ioHandles, cmd.rasterizerState));
+        removeHandle(ioHandles, cmd.rasterizerState);
+    } break;
+    case QSSGRenderCommandType::CreateBuffer: {
+        const auto &cmd = payload<CreateBuffer>(inHeader);
+        const QSSGByteView data(payloadData<CreateBuffer>(inHeader), qint32(cmd.size));
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createBuffer(cmd.bindFlags, cmd.usage, data));
+    } break;
+    case QSSGRenderCommandType::ReleaseBuffer: {
+        const auto &cmd = payload<ReleaseBuffer>(inHeader);
+        inBackend->releaseBuffer(mapHandle(ioHandles, cmd.bo));
+        removeHandle(ioHandles, cmd.bo);
+    } break;
+    case QSSGRenderCommandType::MapBuffer: {
+        const auto &cmd = payload<MapBuffer>(inHeader);
+        const auto bo = mapHandle(ioHandles, cmd.bo);
+        void *mapped = inBackend->mapBuffer(bo, cmd.bindFlags, cmd.offset, cmd.size, cmd.accessFlags);
+        if (mapped)
+            ::memcpy(mapped, payloadData<MapBuffer>(inHeader), cmd.size);
+        inBackend->unmapBuffer(bo, cmd.bindFlags);
+    } break;
+    case QSSGRenderCommandType::CreateQuery:
+        insertHandle(ioHandles, inHeader->type, payload<CreateQuery>(inHeader).result, inBackend->createQuery());
+        break;
+    case QSSGRenderCommandType::ReleaseQuery: {
+        const auto &cmd = payload<ReleaseQuery>(inHeader);
+        inBackend->releaseQuery(mapHandle(ioHandles, cmd.qo));
+        removeHandle(ioHandles, cmd.qo);
+    } break;
+    case QSSGRenderCommandType::GetQueryResult: {
+        const auto &cmd = payload<GetQueryResult>(inHeader);
+        if (cmd.result64) {
+            quint64 result = 0;
+            inBackend->getQueryResult(mapHandle(ioHandles, cmd.qo), cmd.resultType, &result);
+        } else {
+            quint32 result = 0;
+            inBackend->getQueryResult(mapHandle(ioHandles, cmd.qo), cmd.resultType, &result);
+        }
+    } break;
+    case QSSGRenderCommandType::CreateSync: {
+        const auto &cmd = payload<CreateSync>(inHeader);
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createSync(cmd.syncType, cmd.syncFlags));
+    } break;
+    case QSSGRenderCommandType::ReleaseSync: {
+        const auto &cmd = payload<ReleaseSync>(inHeader);
+        inBackend->releaseSync(mapHandle(ioHandles, cmd.so));
+        removeHandle(ioHandles, cmd.so);
+    } break;
+    case QSSGRenderCommandType::WaitSync: {
+        const auto &cmd = payload<WaitSync>(inHeader);
+        inBackend->waitSync(mapHandle(ioHandles, cmd.so), cmd.syncFlags, cmd.timeout);
+    } break;
+    case QSSGRenderCommandType::CreateRenderTarget:
+        insertHandle(ioHandles, inHeader->type, payload<CreateRenderTarget>(inHeader).result, inBackend->createRenderTarget());
+        break;
+    case QSSGRenderCommandType::ReleaseRenderTarget: {
+        const auto &cmd = payload<ReleaseRenderTarget>(inHeader);
+        inBackend->releaseRenderTarget(mapHandle(ioHandles, cmd.rto));
+        removeHandle(ioHandles, cmd.rto);
+    } break;
+    case QSSGRenderCommandType::RenderTargetAttachRenderbuffer: {
+        const auto &cmd = payload<RenderTargetAttachRenderbuffer>(inHeader);
+        inBackend->renderTargetAttach(mapHandle(ioHandles, cmd.rto), cmd.attachment, mapHandle(ioHandles, cmd.rbo));
+    } break;
+    case QSSGRenderCommandType::RenderTargetAttachTexture: {
+        const auto &cmd = payload<RenderTargetAttachTexture>(inHeader);
+        inBackend->renderTargetAttach(mapHandle(ioHandles, cmd.rto), cmd.attachment, mapHandle(ioHandles, cmd.to), cmd.target);
+    } break;
+    case QSSGRenderCommandType::RenderTargetAttachTextureLayer: {
+        const auto &cmd = payload<RenderTargetAttachTextureLayer>(inHeader);
+        inBackend->renderTargetAttach(mapHandle(ioHandles, cmd.rto), cmd.attachment, mapHandle(ioHandles, cmd.to), cmd.level, cmd.layer);
+    } break;
+    case QSSGRenderCommandType::CreateRenderbuffer: {
+        const auto &cmd = payload<CreateRenderbuffer>(inHeader);
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createRenderbuffer(cmd.storageFormat, cmd.width, cmd.height));
+    } break;
+    case QSSGRenderCommandType::ReleaseRenderbuffer: {
+        const auto &cmd = payload<ReleaseRenderbuffer>(inHeader);
+        inBackend->releaseRenderbuffer(mapHandle(ioHandles, cmd.rbo));
+        removeHandle(ioHandles, cmd.rbo);
+    } break;
+    case QSSGRenderCommandType::ResizeRenderbuffer: {
+        const auto &cmd = payload<ResizeRenderbuffer>(inHeader);
+        inBackend->resizeRenderbuffer(mapHandle(ioHandles, cmd.rbo), cmd.storageFormat, cmd.width, cmd.height);
+    } break;
+    case QSSGRenderCommandType::CreateTexture:
+        insertHandle(ioHandles, inHeader->type, payload<CreateTexture>(inHeader).result, inBackend->createTexture());
+        break;
+    case QSSGRenderCommandType::SetTextureData2D: {
+        const auto &cmd = payload<SetTextureData2D>(inHeader);
+        inBackend->setTextureData2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.internalFormat,
+                                    cmd.width, cmd.height, cmd.border, cmd.format,
+                                    QSSGByteView(payloadData<SetTextureData2D>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetTextureDataCubeFace: {
+        const auto &cmd = payload<SetTextureDataCubeFace>(inHeader);
+        inBackend->setTextureDataCubeFace(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.internalFormat,
+                                          cmd.width, cmd.height, cmd.border, cmd.format,
+                                          QSSGByteView(payloadData<SetTextureDataCubeFace>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::CreateTextureStorage2D: {
+        const auto &cmd = payload<CreateTextureStorage2D>(inHeader);
+        inBackend->createTextureStorage2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.levels, cmd.internalFormat, cmd.width, cmd.height);
+    } break;
+    case QSSGRenderCommandType::SetTextureSubData2D: {
+        const auto &cmd = payload<SetTextureSubData2D>(inHeader);
+        inBackend->setTextureSubData2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.xOffset, cmd.yOffset,
+                                       cmd.width, cmd.height, cmd.format,
+                                       QSSGByteView(payloadData<SetTextureSubData2D>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetCompressedTextureData2D: {
+        const auto &cmd = payload<SetCompressedTextureData2D>(inHeader);
+        inBackend->setCompressedTextureData2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.internalFormat,
+                                              cmd.width, cmd.height, cmd.border,
+                                              QSSGByteView(payloadData<SetCompressedTextureData2D>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetCompressedTextureDataCubeFace: {
+        const auto &cmd = payload<SetCompressedTextureDataCubeFace>(inHeader);
+        inBackend->setCompressedTextureDataCubeFace(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.internalFormat,
+                                                    cmd.width, cmd.height, cmd.border,
+                                                    QSSGByteView(payloadData<SetCompressedTextureDataCubeFace>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetCompressedTextureSubData2D: {
+        const auto &cmd = payload<SetCompressedTextureSubData2D>(inHeader);
+        inBackend->setCompressedTextureSubData2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.xOffset, cmd.yOffset,
+                                                 cmd.width, cmd.height, cmd.format,
+                                                 QSSGByteView(payloadData<SetCompressedTextureSubData2D>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::SetMultisampledTextureData2D: {
+        const auto &cmd = payload<SetMultisampledTextureData2D>(inHeader);
+        inBackend->setMultisampledTextureData2D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.samples, cmd.internalFormat,
+                                                cmd.width, cmd.height, cmd.fixedSampleLocations);
+    } break;
+    case QSSGRenderCommandType::SetTextureData3D: {
+        const auto &cmd = payload<SetTextureData3D>(inHeader);
+        inBackend->setTextureData3D(mapHandle(ioHandles, cmd.to), cmd.target, cmd.level, cmd.internalFormat,
+                                    cmd.width, cmd.height, cmd.depth, cmd.border, cmd.format,
+                                    QSSGByteView(payloadData<SetTextureData3D>(inHeader), qint32(cmd.size)));
+    } break;
+    case QSSGRenderCommandType::ReleaseTexture: {
+        const auto &cmd = payload<ReleaseTexture>(inHeader);
+        inBackend->releaseTexture(mapHandle(ioHandles, cmd.to));
+        removeHandle(ioHandles, cmd.to);
+    } break;
+    case QSSGRenderCommandType::CreateSampler: {
+        const auto &cmd = payload<CreateSampler>(inHeader);
+        float borderColor[4] = { cmd.borderColor[0], cmd.borderColor[1], cmd.borderColor[2], cmd.borderColor[3] };
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createSampler(cmd.minFilter, cmd.magFilter,
+                                                                                     cmd.wrapS, cmd.wrapT, cmd.wrapR,
+                                                                                     cmd.minLod, cmd.maxLod, cmd.lodBias,
+                                                                                     cmd.compareMode, cmd.compareFunc, cmd.anisotropy,
+                                                                                     cmd.hasBorderColor ? borderColor : nullptr));
+    } break;
+    case QSSGRenderCommandType::ReleaseSampler: {
+        const auto &cmd = payload<ReleaseSampler>(inHeader);
+        inBackend->releaseSampler(mapHandle(ioHandles, cmd.so));
+        removeHandle(ioHandles, cmd.so);
+    } break;
+    case QSSGRenderCommandType::CreateAttribLayout: {
+        const auto &cmd = payload<CreateAttribLayout>(inHeader);
+        const auto *entries = reinterpret_cast<const AttribEntry *>(payloadData<CreateAttribLayout>(inHeader));
+        const char *names = reinterpret_cast<const char *>(entries + cmd.count);
+        QVarLengthArray<QSSGRenderVertexBufferEntry, 16> attribs;
+        for (quint32 i = 0; i < cmd.count; ++i) {
+            const AttribEntry &entry = entries[i];
+            attribs.append(QSSGRenderVertexBufferEntry(names + entry.nameOffset,
+                                                       entry.componentType,
+                                                       entry.numComponents,
+                                                       entry.firstItemOffset,
+                                                       entry.inputSlot));
+        }
+        insertHandle(ioHandles, inHeader->type, cmd.result,
+                     inBackend->createAttribLayout(QSSGDataView<QSSGRenderVertexBufferEntry>(attribs.constData(), attribs.size())));
+    } break;
+    case QSSGRenderCommandType::ReleaseAttribLayout: {
+        const auto &cmd = payload<ReleaseAttribLayout>(inHeader);
+        inBackend->releaseAttribLayout(mapHandle(ioHandles, cmd.ao));
+        removeHandle(ioHandles, cmd.ao);
+    } break;
+    case QSSGRenderCommandType::CreateInputAssembler: {
+        const auto &cmd = payload<CreateInputAssembler>(inHeader);
+        const auto *buffers = reinterpret_cast<const BufferObject *>(payloadData<CreateInputAssembler>(inHeader));
+        const auto *strides = reinterpret_cast<const quint32 *>(buffers + cmd.bufferCount);
+        const auto *offsets = strides + cmd.strideCount;
+        QVarLengthArray<BufferObject, 8> mappedBuffers;
+        for (quint32 i = 0; i < cmd.bufferCount; ++i)
+            mappedBuffers.append(mapHandle(ioHandles, buffers[i]));
+        insertHandle(ioHandles, inHeader->type, cmd.result,
+                     inBackend->createInputAssembler(mapHandle(ioHandles, cmd.attribLayout),
+                                                     QSSGDataView<BufferObject>(mappedBuffers.constData(), mappedBuffers.size()),
+                                                     mapHandle(ioHandles, cmd.indexBuffer),
+                                                     QSSGDataView<quint32>(strides, qint32(cmd.strideCount)),
+                                                     QSSGDataView<quint32>(offsets, qint32(cmd.offsetCount)),
+                                                     cmd.patchVertexCount));
+    } break;
+    case QSSGRenderCommandType::ReleaseInputAssembler: {
+        const auto &cmd = payload<ReleaseInputAssembler>(inHeader);
+        inBackend->releaseInputAssembler(mapHandle(ioHandles, cmd.iao));
+        removeHandle(ioHandles, cmd.iao);
+    } break;
+    case QSSGRenderCommandType::CreateShader: {
+        const auto &cmd = payload<CreateShader>(inHeader);
+        const QSSGByteView source(payloadData<CreateShader>(inHeader), qint32(cmd.size));
+        insertHandle(ioHandles, inHeader->type, cmd.result, createShader(inBackend, cmd.stage, source, cmd.binary), cmd.stage);
+    } break;
+    case QSSGRenderCommandType::ReleaseShader: {
+        const auto &cmd = payload<ReleaseShader>(inHeader);
+        releaseShader(inBackend, cmd.stage, mapHandle(ioHandles, cmd.shader));
+        removeHandle(ioHandles, cmd.shader);
+    } break;
+    case QSSGRenderCommandType::AttachShader: {
+        const auto &cmd = payload<AttachShader>(inHeader);
+        attachShader(inBackend, mapHandle(ioHandles, cmd.po), cmd.stage, mapHandle(ioHandles, cmd.shader), true);
+    } break;
+    case QSSGRenderCommandType::DetachShader: {
+        const auto &cmd = payload<DetachShader>(inHeader);
+        attachShader(inBackend, mapHandle(ioHandles, cmd.po), cmd.stage, mapHandle(ioHandles, cmd.shader), false);
+    } break;
+    case QSSGRenderCommandType::CreateShaderProgram: {
+        const auto &cmd = payload<CreateShaderProgram>(inHeader);
+        insertHandle(ioHandles, inHeader->type, cmd.result, inBackend->createShaderProgram(cmd.isSeparable));
+    } break;
+    case QSSGRenderCommandType::ReleaseShaderProgram: {
+        const auto &cmd = payload<ReleaseShaderProgram>(inHeader);
+        inBackend->releaseShaderProgram(mapHandle(ioHandles, cmd.po));
+        removeHandle(ioHandles, cmd.po);
+    } break;
+    case QSSGRenderCommandType::LinkProgram: {
+        QByteArray errorMessage;
+        inBackend->linkProgram(mapHandle(ioHandles, payload<LinkProgram>(inHeader).po), errorMessage);
+    } break;
+    case QSSGRenderCommandType::CreateProgramPipeline:
+        insertHandle(ioHandles, inHeader->type, payload<CreateProgramPipeline>(inHeader).result, inBackend->createProgramPipeline());
+        break;
+    case QSSGRenderCommandType::ReleaseProgramPipeline: {
+        const auto &cmd = payload<ReleaseProgramPipeline>(inHeader);
+        inBackend->releaseProgramPipeline(mapHandle(ioHandles, cmd.ppo));
+        removeHandle(ioHandles, cmd.ppo);
+    } break;
+    case QSSGRenderCommandType::ReadPixel: {
+        const auto &cmd = payload<ReadPixel>(inHeader);
+        QByteArray pixels(cmd.width * cmd.height * sizeofPixelFormat(cmd.format), Qt::Uninitialized);
+        inBackend->readPixel(mapHandle(ioHandles, cmd.rto), cmd.x, cmd.y, cmd.width, cmd.height, cmd.format,
+                             QSSGByteRef(reinterpret_cast<quint8 *>(pixels.data()), pixels.size()));
+    } break;
+    default:
+        Q_ASSERT(false);
+        break;
+    }
+}
+
+} // namespace
+
+const char *toString(QSSGRenderCommandType value)
+{
+    switch (value) {
+    case QSSGRenderCommandType::Unknown:
+        return "Unknown";
+    case QSSGRenderCommandType::SetRenderState:
+        return "SetRenderState";
+    case QSSGRenderCommandType::SetDepthStencilState:
+        return "SetDepthStencilState";
+    case QSSGRenderCommandType::SetRasterizerState:
+        return "SetRasterizerState";
+    case QSSGRenderCommandType::SetDepthFunc:
+        return "SetDepthFunc";
+    case QSSGRenderCommandType::SetDepthWrite:
+        return "SetDepthWrite";
+    case QSSGRenderCommandType::SetColorWrites:
+        return "SetColorWrites";
+    case QSSGRenderCommandType::SetMultisample:
+        return "SetMultisample";
+    case QSSGRenderCommandType::SetBlendFunc:
+        return "SetBlendFunc";
+    case QSSGRenderCommandType::SetBlendEquation:
+        return "SetBlendEquation";
+    case QSSGRenderCommandType::SetBlendBarrier:
+        return "SetBlendBarrier";
+    case QSSGRenderCommandType::SetScissorRect:
+        return "SetScissorRect";
+    case QSSGRenderCommandType::SetViewportRect:
+        return "SetViewportRect";
+    case QSSGRenderCommandType::SetClearColor:
+        return "SetClearColor";
+    case QSSGRenderCommandType::Clear:
+        return "Clear";
+    case QSSGRenderCommandType::BindBuffer:
+        return "BindBuffer";
+    case QSSGRenderCommandType::UpdateBuffer:
+        return "UpdateBuffer";
+    case QSSGRenderCommandType::UpdateBufferRange:
+        return "UpdateBufferRange";
+    case QSSGRenderCommandType::SetMemoryBarrier:
+        return "SetMemoryBarrier";
+    case QSSGRenderCommandType::BeginQuery:
+        return "BeginQuery";
+    case QSSGRenderCommandType::EndQuery:
+        return "EndQuery";
+    case QSSGRenderCommandType::SetQueryTimer:
+        return "SetQueryTimer";
+    case QSSGRenderCommandType::SetRenderTarget:
+        return "SetRenderTarget";
+    case QSSGRenderCommandType::SetReadTarget:
+        return "SetReadTarget";
+    case QSSGRenderCommandType::SetDrawBuffers:
+        return "SetDrawBuffers";
+    case QSSGRenderCommandType::SetReadBuffer:
+        return "SetReadBuffer";
+    case QSSGRenderCommandType::BlitFramebuffer:
+        return "BlitFramebuffer";
+    case QSSGRenderCommandType::GenerateMipMaps:
+        return "GenerateMipMaps";
+    case QSSGRenderCommandType::BindTexture:
+        return "BindTexture";
+    case QSSGRenderCommandType::BindImageTexture:
+        return "BindImageTexture";
+    case QSSGRenderCommandType::UpdateSampler:
+        return "UpdateSampler";
+    case QSSGRenderCommandType::UpdateTextureSwizzle:
+        return "UpdateTextureSwizzle";
+    case QSSGRenderCommandType::UpdateTextureObject:
+        return "UpdateTextureObject";
+    case QSSGRenderCommandType::SetInputAssembler:
+        return "SetInputAssembler";
+    case QSSGRenderCommandType::SetPatchVertexCount:
+        return "SetPatchVertexCount";
+    case QSSGRenderCommandType::SetActiveProgram:
+        return "SetActiveProgram";
+    case QSSGRenderCommandType::SetActiveProgramPipeline:
+        return "SetActiveProgramPipeline";
+    case QSSGRenderCommandType::SetProgramStages:
+        return "SetProgramStages";
+    case QSSGRenderCommandType::DispatchCompute:
+        return "DispatchCompute";
+    case QSSGRenderCommandType::ProgramSetConstantBlock:
+        return "ProgramSetConstantBlock";
+    case QSSGRenderCommandType::ProgramSetConstantBuffer:
+        return "ProgramSetConstantBuffer";
+    case QSSGRenderCommandType::ProgramSetConstantBufferRange:
+        return "ProgramSetConstantBufferRange";
+    case QSSGRenderCommandType::ProgramSetStorageBuffer:
+        return "ProgramSetStorageBuffer";
+    case QSSGRenderCommandType::ProgramSetAtomicCounterBuffer:
+        return "ProgramSetAtomicCounterBuffer";
+    case QSSGRenderCommandType::SetConstantValue:
+        return "SetConstantValue";
+    case QSSGRenderCommandType::Draw:
+        return "Draw";
+    case QSSGRenderCommandType::DrawIndirect:
+        return "DrawIndirect";
+    case QSSGRenderCommandType::DrawIndexed:
+        return "DrawIndexed";
+    case QSSGRenderCommandType::DrawIndexedIndirect:
+        return "DrawIndexedIndirect";
+    case QSSGRenderCommandType::CreateDepthStencilState:
+        return "CreateDepthStencilState";
+    case QSSGRenderCommandType::ReleaseDepthStencilState:
+        return "ReleaseDepthStencilState";
+    case QSSGRenderCommandType::CreateRasterizerState:
+        return "CreateRasterizerState";
+    case QSSGRenderCommandType::ReleaseRasterizerState:
+        return "ReleaseRasterizerState";
+    case QSSGRenderCommandType::CreateBuffer:
+        return "CreateBuffer";
+    case QSSGRenderCommandType::ReleaseBuffer:
+        return "ReleaseBuffer";
+    case QSSGRenderCommandType::MapBuffer:
+        return "MapBuffer";
+    case QSSGRenderCommandType::CreateQuery:
+        return "CreateQuery";
+    case QSSGRenderCommandType::ReleaseQuery:
+        return "ReleaseQuery";
+    case QSSGRenderCommandType::GetQueryResult:
+        return "GetQueryResult";
+    case QSSGRenderCommandType::CreateSync:
+        return "CreateSync";
+    case QSSGRenderCommandType::ReleaseSync:
+        return "ReleaseSync";
+    case QSSGRenderCommandType::WaitSync:
+        return "WaitSync";
+    case QSSGRenderCommandType::CreateRenderTarget:
+        return "CreateRenderTarget";
+    case QSSGRenderCommandType::ReleaseRenderTarget:
+        return "ReleaseRenderTarget";
+    case QSSGRenderCommandType::RenderTargetAttachRenderbuffer:
+        return "RenderTargetAttachRenderbuffer";
+    case QSSGRenderCommandType::RenderTargetAttachTexture:
+        return "RenderTargetAttachTexture";
+    case QSSGRenderCommandType::RenderTargetAttachTextureLayer:
+        return "RenderTargetAttachTextureLayer";
+    case QSSGRenderCommandType::CreateRenderbuffer:
+        return "CreateRenderbuffer";
+    case QSSGRenderCommandType::ReleaseRenderbuffer:
+        return "ReleaseRenderbuffer";
+    case QSSGRenderCommandType::ResizeRenderbuffer:
+        return "ResizeRenderbuffer";
+    case QSSGRenderCommandType::CreateTexture:
+        return "CreateTexture";
+    case QSSGRenderCommandType::SetTextureData2D:
+        return "SetTextureData2D";
+    case QSSGRenderCommandType::SetTextureDataCubeFace:
+        return "SetTextureDataCubeFace";
+    case QSSGRenderCommandType::CreateTextureStorage2D:
+        return "CreateTextureStorage2D";
+    case QSSGRenderCommandType::SetTextureSubData2D:
+        return "SetTextureSubData2D";
+    case QSSGRenderCommandType::SetCompressedTextureData2D:
+        return "SetCompressedTextureData2D";
+    case QSSGRenderCommandType::SetCompressedTextureDataCubeFace:
+        return "SetCompressedTextureDataCubeFace";
+    case QSSGRenderCommandType::SetCompressedTextureSubData2D:
+        return "SetCompressedTextureSubData2D";
+    case QSSGRenderCommandType::SetMultisampledTextureData2D:
+        return "SetMultisampledTextureData2D";
+    case QSSGRenderCommandType::SetTextureData3D:
+        return "SetTextureData3D";
+    case QSSGRenderCommandType::ReleaseTexture:
+        return "ReleaseTexture";
+    case QSSGRenderCommandType::CreateSampler:
+        return "CreateSampler";
+    case QSSGRenderCommandType::ReleaseSampler:
+        return "ReleaseSampler";
+    case QSSGRenderCommandType::CreateAttribLayout:
+        return "CreateAttribLayout";
+    case QSSGRenderCommandType::ReleaseAttribLayout:
+        return "ReleaseAttribLayout";
+    case QSSGRenderCommandType::CreateInputAssembler:
+        return "CreateInputAssembler";
+    case QSSGRenderCommandType::ReleaseInputAssembler:
+        return "ReleaseInputAssembler";
+    case QSSGRenderCommandType::CreateShader:
+        return "CreateShader";
+    case QSSGRenderCommandType::ReleaseShader:
+        return "ReleaseShader";
+    case QSSGRenderCommandType::AttachShader:
+        return "AttachShader";
+    case QSSGRenderCommandType::DetachShader:
+        return "DetachShader";
+    case QSSGRenderCommandType::CreateShaderProgram:
+        return "CreateShaderProgram";
+    case QSSGRenderCommandType::ReleaseShaderProgram:
+        return "ReleaseShaderProgram";
+    case QSSGRenderCommandType::LinkProgram:
+        return "LinkProgram";
+    case QSSGRenderCommandType::CreateProgramPipeline:
+        return "CreateProgramPipeline";
+    case QSSGRenderCommandType::ReleaseProgramPipeline:
+        return "ReleaseProgramPipeline";
+    case QSSGRenderCommandType::ReadPixel:
+        return "ReadPixel";
+    default:
+        break;
+    }
+    return "Unknown";
+}
+
+void QSSGRenderHandleMap::releaseAll(QSSGRenderBackend *inBackend)
+{
+    using namespace QSSGRenderCommands;
+
+    // Users before the objects they use, the input assemblers before their
+    // buffers and layouts, programs before their shaders.
+    static const QSSGRenderCommandType releaseOrder[] = {
+        QSSGRenderCommandType::CreateInputAssembler,
+        QSSGRenderCommandType::CreateProgramPipeline,
+        QSSGRenderCommandType::CreateShaderProgram,
+        QSSGRenderCommandType::CreateShader,
+        QSSGRenderCommandType::CreateRenderTarget,
+        QSSGRenderCommandType::CreateRenderbuffer,
+        QSSGRenderCommandType::CreateTexture,
+        QSSGRenderCommandType::CreateSampler,
+        QSSGRenderCommandType::CreateAttribLayout,
+        QSSGRenderCommandType::CreateBuffer,
+        QSSGRenderCommandType::CreateDepthStencilState,
+        QSSGRenderCommandType::CreateRasterizerState,
+        QSSGRenderCommandType::CreateQuery,
+        QSSGRenderCommandType::CreateSync
+    };
+
+    for (QSSGRenderCommandType type : releaseOrder) {
+        for (const Entry &entry : qAsConst(m_handles)) {
+            if (entry.createdBy != type || !entry.created)
+                continue;
+            switch (type) {
+            case QSSGRenderCommandType::CreateInputAssembler:
+                inBackend->releaseInputAssembler(reinterpret_cast<InputAssemblerObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateProgramPipeline:
+                inBackend->releaseProgramPipeline(reinterpret_cast<ProgramPipeline>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateShaderProgram:
+                inBackend->releaseShaderProgram(reinterpret_cast<ShaderProgramObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateShader:
+                releaseShader(inBackend, entry.stage, reinterpret_cast<ShaderObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateRenderTarget:
+                inBackend->releaseRenderTarget(reinterpret_cast<RenderTargetObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateRenderbuffer:
+                inBackend->releaseRenderbuffer(reinterpret_cast<RenderbufferObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateTexture:
+                inBackend->releaseTexture(reinterpret_cast<TextureObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateSampler:
+                inBackend->releaseSampler(reinterpret_cast<SamplerObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateAttribLayout:
+                inBackend->releaseAttribLayout(reinterpret_cast<AttribLayoutObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateBuffer:
+                inBackend->releaseBuffer(reinterpret_cast<BufferObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateDepthStencilState:
+                inBackend->releaseDepthStencilState(reinterpret_cast<DepthStencilStateObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateRasterizerState:
+                inBackend->releaseRasterizerState(reinterpret_cast<RasterizerStateObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateQuery:
+                inBackend->releaseQuery(reinterpret_cast<QueryObject>(entry.created));
+                break;
+            case QSSGRenderCommandType::CreateSync:
+                inBackend->releaseSync(reinterpret_cast<SyncObject>(entry.created));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    m_handles.clear();
+}
+
+constexpr size_t QSSGRenderCommandList::Alignment;
+constexpr size_t QSSGRenderCommandList::ChunkSize;
+
+QSSGRenderCommandList::~QSSGRenderCommandList()
+{
+    clear();
+}
+
+void QSSGRenderCommandList::reset()
+{
+    for (Chunk &chunk : m_chunks)
+        chunk.used = 0;
+    m_currentChunk = 0;
+    m_commandCount = 0;
+}
+
+void QSSGRenderCommandList::clear()
+{
+    for (const Chunk &chunk : qAsConst(m_chunks))
+        ::free(chunk.data);
+    m_chunks.clear();
+    m_currentChunk = 0;
+    m_commandCount = 0;
+}
+
+size_t QSSGRenderCommandList::size() const
+{
+    size_t result = 0;
+    for (const Chunk &chunk : m_chunks)
+        result += chunk.used;
+    return result;
+}
+
+void *QSSGRenderCommandList::allocate(QSSGRenderCommandType inType, size_t inSize)
+{
+    const size_t commandSize = alignedSize(sizeof(Header) + inSize);
+    Q_ASSERT(commandSize <= std::numeric_limits<quint32>::max());
+
+    // Commands never straddle chunks, move on to the next chunk that has room.
+    // Chunks left behind keep their tail unused until the next reset().
+    while (m_currentChunk < m_chunks.size()) {
+        const Chunk &chunk = m_chunks.at(m_currentChunk);
+        if (chunk.capacity - chunk.used >= commandSize)
+            break;
+        ++m_currentChunk;
+    }
+    if (m_currentChunk == m_chunks.size()) {
+        // Commands larger than a chunk, like big buffer updates, get a chunk of their own
+        const size_t capacity = qMax(ChunkSize, commandSize);
+        m_chunks.append({ static_cast<quint8 *>(::malloc(capacity)), capacity, 0 });
+    }
+
+    Chunk &chunk = m_chunks[m_currentChunk];
+    Header *header = reinterpret_cast<Header *>(chunk.data + chunk.used);
+    header->type = inType;
+    header->reserved = 0;
+    header->size = quint32(commandSize);
+    chunk.used += commandSize;
+    ++m_commandCount;
+    return header + 1;
+}
+
+// Booleans get stored as 32 bit values since the GL backend converts them in
+// place to GLint before uploading.
+quint32 QSSGRenderCommandList::constantValueSize(QSSGRenderShaderDataType inType, qint32 inCount, quint32 *outStorageSize)
+{
+    const quint32 count = quint32(qMax(inCount, 1));
+    quint32 size = 0;
+    quint32 storageSize = 0;
+    switch (inType) {
+    case QSSGRenderShaderDataType::Boolean:
+        size = count * sizeof(bool);
+        storageSize = count * sizeof(qint32);
+        break;
+    case QSSGRenderShaderDataType::BooleanVec2:
+        size = count * sizeof(bool_2);
+        storageSize = count * 2 * sizeof(qint32);
+        break;
+    case QSSGRenderShaderDataType::BooleanVec3:
+        size = count * sizeof(bool_3);
+        storageSize = count * 3 * sizeof(qint32);
+        break;
+    case QSSGRenderShaderDataType::BooleanVec4:
+        size = count * sizeof(bool_4);
+        storageSize = count * 4 * sizeof(qint32);
+        break;
+    case QSSGRenderShaderDataType::Integer:
+    case QSSGRenderShaderDataType::UnsignedInteger:
+    case QSSGRenderShaderDataType::Float:
+    // texture and image constants carry the texture unit
+    case QSSGRenderShaderDataType::Texture2D:
+    case QSSGRenderShaderDataType::Texture2DHandle:
+    case QSSGRenderShaderDataType::Texture2DArray:
+    case QSSGRenderShaderDataType::TextureCube:
+    case QSSGRenderShaderDataType::TextureCubeHandle:
+    case QSSGRenderShaderDataType::Image2D:
+        size = count * sizeof(quint32);
+        break;
+    case QSSGRenderShaderDataType::IntegerVec2:
+    case QSSGRenderShaderDataType::UnsignedIntegerVec2:
+    case QSSGRenderShaderDataType::Vec2:
+        size = count * 2 * sizeof(quint32);
+        break;
+    case QSSGRenderShaderDataType::IntegerVec3:
+    case QSSGRenderShaderDataType::UnsignedIntegerVec3:
+    case QSSGRenderShaderDataType::Vec3:
+        size = count * 3 * sizeof(quint32);
+        break;
+    case QSSGRenderShaderDataType::IntegerVec4:
+    case QSSGRenderShaderDataType::UnsignedIntegerVec4:
+    case QSSGRenderShaderDataType::Vec4:
+        size = count * 4 * sizeof(quint32);
+        break;
+    case QSSGRenderShaderDataType::Matrix3x3:
+        size = count * 9 * sizeof(float);
+        break;
+    case QSSGRenderShaderDataType::Matrix4x4:
+        size = count * 16 * sizeof(float);
+        break;
+    default:
+        Q_ASSERT(false);
+        break;
+    }
+    *outStorageSize = qMax(size, storageSize);
+    return size;
+}
+
+void QSSGRenderCommandList::appendCommand(const Header *inCommand)
+{
+    Q_ASSERT(inCommand->size >= sizeof(Header));
+    void *mem = allocate(inCommand->type, inCommand->size - sizeof(Header));
+    ::memcpy(mem, inCommand + 1, inCommand->size - sizeof(Header));
+}
+
+void QSSGRenderCommandList::replay(QSSGRenderBackend *inBackend) const
+{
+    Q_ASSERT(inBackend);
+    forEachCommand([inBackend](const Header *inCommand) {
+        replayCommand(inBackend, inCommand, nullptr);
+    });
+}
+
+void QSSGRenderCommandList::replay(QSSGRenderBackend *inBackend, QSSGRenderHandleMap &ioHandles) const
+{
+    Q_ASSERT(inBackend);
+    forEachCommand([inBackend, &ioHandles](const Header *inCommand) {
+        replayCommand(inBackend, inCommand, &ioHandles);
+    });
+}
+
+void QSSGRenderCommandList::replay(QSSGRenderBackend *inBackend, const Header *inCommand, QSSGRenderHandleMap *ioHandles)
+{
+    Q_ASSERT(inBackend);
+    replayCommand(inBackend, inCommand, ioHandles);
+}
+
+bool QSSGRenderCommandList::write(QIODevice *inDevice) const
+{
+    const quint32 commandCount = m_commandCount;
+    const quint64 byteSize = size();
+    if (inDevice->write(reinterpret_cast<const char *>(&commandCount), sizeof(commandCount)) != sizeof(commandCount))
+        return false;
+    if (inDevice->write(reinterpret_cast<const char *>(&byteSize), sizeof(byteSize)) != sizeof(byteSize))
+        return false;
+    for (const Chunk &chunk : m_chunks) {
+        if (chunk.used && inDevice->write(reinterpret_cast<const char *>(chunk.data), qint64(chunk.used)) != qint64(chunk.used))
+            return false;
+    }
+    return true;
+}
+
+bool QSSGRenderCommandList::read(QIODevice *inDevice)
+{
+    quint32 commandCount = 0;
+    quint64 byteSize = 0;
+    if (inDevice->read(reinterpret_cast<char *>(&commandCount), sizeof(commandCount)) != sizeof(commandCount))
+        return false;
+    if (inDevice->read(reinterpret_cast<char *>(&byteSize), sizeof(byteSize)) != sizeof(byteSize))
+        return false;
+
+    for (quint32 i = 0; i < commandCount; ++i) {
+        Header header;
+        if (byteSize < sizeof(Header) || inDevice->read(reinterpret_cast<char *>(&header), sizeof(Header)) != sizeof(Header))
+            return false;
+        if (header.size < sizeof(Header) || header.size > byteSize || header.type >= QSSGRenderCommandType::Count)
+            return false;
+        const qint64 dataSize = qint64(header.size - sizeof(Header));
+        void *mem = allocate(header.type, size_t(dataSize));
+        if (inDevice->read(static_cast<char *>(mem), dataSize) != dataSize)
+            return false;
+        byteSize -= header.size;
+    }
+    return byteSize == 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,1169 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_COMMAND_LIST_H
+#define QSSG_RENDER_COMMAND_LIST_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRender/private/qssgrenderbackend_p.h>
+
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+#include <QtCore/QRect>
+#include <QtGui/QVector4D>
+
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+enum class QSSGRenderCommandType : quint16
+{
+    Unknown = 0,
+    SetRenderState,
+    SetDepthStencilState,
+    SetRasterizerState,
+    SetDepthFunc,
+    SetDepthWrite,
+    SetColorWrites,
+    SetMultisample,
+    SetBlendFunc,
+    SetBlendEquation,
+    SetBlendBarrier,
+    SetScissorRect,
+    SetViewportRect,
+    SetClearColor,
+    Clear,
+    BindBuffer,
+    UpdateBuffer,
+    UpdateBufferRange,
+    SetMemoryBarrier,
+    BeginQuery,
+    EndQuery,
+    SetQueryTimer,
+    SetRenderTarget,
+    SetReadTarget,
+    SetDrawBuffers,
+    SetReadBuffer,
+    BlitFramebuffer,
+    GenerateMipMaps,
+    BindTexture,
+    BindImageTexture,
+    UpdateSampler,
+    UpdateTextureSwizzle,
+    UpdateTextureObject,
+    SetInputAssembler,
+    SetPatchVertexCount,
+    SetActiveProgram,
+    SetActiveProgramPipeline,
+    SetProgramStages,
+    DispatchCompute,
+    ProgramSetConstantBlock,
+    ProgramSetConstantBuffer,
+    ProgramSetConstantBufferRange,
+    ProgramSetStorageBuffer,
+    ProgramSetAtomicCounterBuffer,
+    SetConstantValue,
+    Draw,
+    DrawIndirect,
+    DrawIndexed,
+    DrawIndexedIndirect,
+
+    // Resource management, only recorded by QSSGRenderBackendCapture. These
+    // carry the handle returned at capture time so replay can map it to the
+    // handle created by the replaying backend.
+    CreateDepthStencilState,
+    ReleaseDepthStencilState,
+    CreateRasterizerState,
+    ReleaseRasterizerState,
+    CreateBuffer,
+    ReleaseBuffer,
+    MapBuffer,
+    CreateQuery,
+    ReleaseQuery,
+    GetQueryResult,
+    CreateSync,
+    ReleaseSync,
+    WaitSync,
+    CreateRenderTarget,
+    ReleaseRenderTarget,
+    RenderTargetAttachRenderbuffer,
+    RenderTargetAttachTexture,
+    RenderTargetAttachTextureLayer,
+    CreateRenderbuffer,
+    ReleaseRenderbuffer,
+    ResizeRenderbuffer,
+    CreateTexture,
+    SetTextureData2D,
+    SetTextureDataCubeFace,
+    CreateTextureStorage2D,
+    SetTextureSubData2D,
+    SetCompressedTextureData2D,
+    SetCompressedTextureDataCubeFace,
+    SetCompressedTextureSubData2D,
+    SetMultisampledTextureData2D,
+    SetTextureData3D,
+    ReleaseTexture,
+    CreateSampler,
+    ReleaseSampler,
+    CreateAttribLayout,
+    ReleaseAttribLayout,
+    CreateInputAssembler,
+    ReleaseInputAssembler,
+    CreateShader,
+    ReleaseShader,
+    AttachShader,
+    DetachShader,
+    CreateShaderProgram,
+    ReleaseShaderProgram,
+    LinkProgram,
+    CreateProgramPipeline,
+    ReleaseProgramPipeline,
+    ReadPixel,
+
+    Count
+};
+
+Q_QUICK3DRENDER_EXPORT const char *toString(QSSGRenderCommandType value);
+
+// Payloads of the recorded backend calls. Each one is a plain copy of the
+// arguments of the QSSGRenderBackend function of the same name, variable sized
+// data (buffer contents, uniform values, draw buffer lists) follows the payload
+// directly in the command list.
+namespace QSSGRenderCommands {
+
+typedef QSSGRenderBackend::QSSGRenderBackendBufferObject BufferObject;
+typedef QSSGRenderBackend::QSSGRenderBackendInputAssemblerObject InputAssemblerObject;
+typedef QSSGRenderBackend::QSSGRenderBackendTextureObject TextureObject;
+typedef QSSGRenderBackend::QSSGRenderBackendSamplerObject SamplerObject;
+typedef QSSGRenderBackend::QSSGRenderBackendRenderTargetObject RenderTargetObject;
+typedef QSSGRenderBackend::QSSGRenderBackendShaderProgramObject ShaderProgramObject;
+typedef QSSGRenderBackend::QSSGRenderBackendDepthStencilStateObject DepthStencilStateObject;
+typedef QSSGRenderBackend::QSSGRenderBackendRasterizerStateObject RasterizerStateObject;
+typedef QSSGRenderBackend::QSSGRenderBackendQueryObject QueryObject;
+typedef QSSGRenderBackend::QSSGRenderBackendProgramPipeline ProgramPipeline;
+typedef QSSGRenderBackend::QSSGRenderBackendAttribLayoutObject AttribLayoutObject;
+typedef QSSGRenderBackend::QSSGRenderBackendRenderbufferObject RenderbufferObject;
+typedef QSSGRenderBackend::QSSGRenderBackendSyncObject SyncObject;
+// Any of the shader object handles, see ShaderStage
+typedef void *ShaderObject;
+
+enum class ShaderStage : quint32
+{
+    Vertex,
+    Fragment,
+    TessControl,
+    TessEvaluation,
+    Geometry,
+    Compute
+};
+
+struct SetRenderState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetRenderState;
+    bool enable;
+    QSSGRenderState state;
+};
+
+struct SetDepthStencilState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetDepthStencilState;
+    DepthStencilStateObject depthStencilState;
+};
+
+struct SetRasterizerState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetRasterizerState;
+    RasterizerStateObject rasterizerState;
+};
+
+struct SetDepthFunc
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetDepthFunc;
+    QSSGRenderBoolOp func;
+};
+
+struct SetDepthWrite
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetDepthWrite;
+    bool enable;
+};
+
+struct SetColorWrites
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetColorWrites;
+    bool red;
+    bool green;
+    bool blue;
+    bool alpha;
+};
+
+struct SetMultisample
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetMultisample;
+    bool enable;
+};
+
+struct SetBlendFunc
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetBlendFunc;
+    QSSGRenderBlendFunctionArgument blendFunc;
+};
+
+struct SetBlendEquation
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetBlendEquation;
+    QSSGRenderBlendEquationArgument blendEquation;
+};
+
+struct SetBlendBarrier
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetBlendBarrier;
+};
+
+struct SetScissorRect
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetScissorRect;
+    QRect rect;
+};
+
+struct SetViewportRect
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetViewportRect;
+    QRect rect;
+};
+
+struct SetClearColor
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetClearColor;
+    QVector4D color;
+};
+
+struct Clear
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::Clear;
+    QSSGRenderClearFlags flags;
+};
+
+struct BindBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::BindBuffer;
+    BufferObject bo;
+    QSSGRenderBufferType bindFlags;
+};
+
+struct UpdateBuffer // followed by size bytes of data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::UpdateBuffer;
+    BufferObject bo;
+    QSSGRenderBufferType bindFlags;
+    QSSGRenderBufferUsageType usage;
+    quint32 size;
+};
+
+struct UpdateBufferRange // followed by size bytes of data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::UpdateBufferRange;
+    BufferObject bo;
+    QSSGRenderBufferType bindFlags;
+    size_t offset;
+    quint32 size;
+};
+
+struct SetMemoryBarrier
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetMemoryBarrier;
+    QSSGRenderBufferBarrierFlags barriers;
+};
+
+struct BeginQuery
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::BeginQuery;
+    QueryObject qo;
+    QSSGRenderQueryType type;
+};
+
+struct EndQuery
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::EndQuery;
+    QueryObject qo;
+    QSSGRenderQueryType type;
+};
+
+struct SetQueryTimer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetQueryTimer;
+    QueryObject qo;
+};
+
+struct SetRenderTarget
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetRenderTarget;
+    RenderTargetObject rto;
+};
+
+struct SetReadTarget
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetReadTarget;
+    RenderTargetObject rto;
+};
+
+struct SetDrawBuffers // followed by count qint32 draw buffer indices
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetDrawBuffers;
+    RenderTargetObject rto;
+    quint32 count;
+};
+
+struct SetReadBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetReadBuffer;
+    RenderTargetObject rto;
+    QSSGReadFace readFace;
+};
+
+struct BlitFramebuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::BlitFramebuffer;
+    qint32 srcX0;
+    qint32 srcY0;
+    qint32 srcX1;
+    qint32 srcY1;
+    qint32 dstX0;
+    qint32 dstY0;
+    qint32 dstX1;
+    qint32 dstY1;
+    QSSGRenderClearFlags flags;
+    QSSGRenderTextureMagnifyingOp filter;
+};
+
+struct GenerateMipMaps
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::GenerateMipMaps;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    QSSGRenderHint genType;
+};
+
+struct BindTexture
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::BindTexture;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 unit;
+};
+
+struct BindImageTexture
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::BindImageTexture;
+    TextureObject to;
+    quint32 unit;
+    qint32 level;
+    bool layered;
+    qint32 layer;
+    QSSGRenderImageAccessType accessFlags;
+    QSSGRenderTextureFormat format;
+};
+
+struct UpdateSampler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::UpdateSampler;
+    SamplerObject so;
+    QSSGRenderTextureTargetType target;
+    QSSGRenderTextureMinifyingOp minFilter;
+    QSSGRenderTextureMagnifyingOp magFilter;
+    QSSGRenderTextureCoordOp wrapS;
+    QSSGRenderTextureCoordOp wrapT;
+    QSSGRenderTextureCoordOp wrapR;
+    float minLod;
+    float maxLod;
+    float lodBias;
+    QSSGRenderTextureCompareMode compareMode;
+    QSSGRenderTextureCompareOp compareFunc;
+    float anisotropy;
+    bool hasBorderColor;
+    float borderColor[4];
+};
+
+struct UpdateTextureSwizzle
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::UpdateTextureSwizzle;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    QSSGRenderTextureSwizzleMode swizzleMode;
+};
+
+struct UpdateTextureObject
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::UpdateTextureObject;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 baseLevel;
+    qint32 maxLevel;
+};
+
+struct SetInputAssembler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetInputAssembler;
+    InputAssemblerObject iao;
+    ShaderProgramObject po;
+};
+
+struct SetPatchVertexCount
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetPatchVertexCount;
+    InputAssemblerObject iao;
+    quint32 count;
+};
+
+struct SetActiveProgram
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetActiveProgram;
+    ShaderProgramObject po;
+};
+
+struct SetActiveProgramPipeline
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetActiveProgramPipeline;
+    ProgramPipeline ppo;
+};
+
+struct SetProgramStages
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetProgramStages;
+    ProgramPipeline ppo;
+    QSSGRenderShaderTypeFlags flags;
+    ShaderProgramObject po;
+};
+
+struct DispatchCompute
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::DispatchCompute;
+    ShaderProgramObject po;
+    quint32 numGroupsX;
+    quint32 numGroupsY;
+    quint32 numGroupsZ;
+};
+
+struct ProgramSetConstantBlock
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ProgramSetConstantBlock;
+    ShaderProgramObject po;
+    quint32 blockIndex;
+    quint32 binding;
+};
+
+struct ProgramSetConstantBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ProgramSetConstantBuffer;
+    quint32 index;
+    BufferObject bo;
+};
+
+struct ProgramSetConstantBufferRange
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ProgramSetConstantBufferRange;
+    quint32 index;
+    BufferObject bo;
+    quint32 offset;
+    quint32 size;
+};
+
+struct ProgramSetStorageBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ProgramSetStorageBuffer;
+    quint32 index;
+    BufferObject bo;
+};
+
+struct ProgramSetAtomicCounterBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ProgramSetAtomicCounterBuffer;
+    quint32 index;
+    BufferObject bo;
+};
+
+struct SetConstantValue // followed by size bytes of value data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetConstantValue;
+    ShaderProgramObject po;
+    quint32 id;
+    QSSGRenderShaderDataType type;
+    qint32 count;
+    quint32 size;
+    bool transpose;
+};
+
+struct Draw
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::Draw;
+    QSSGRenderDrawMode drawMode;
+    quint32 start;
+    quint32 count;
+};
+
+struct DrawIndirect
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::DrawIndirect;
+    QSSGRenderDrawMode drawMode;
+    quintptr indirect; // offset into the bound indirect buffer
+};
+
+struct DrawIndexed
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::DrawIndexed;
+    QSSGRenderDrawMode drawMode;
+    quint32 count;
+    QSSGRenderComponentType type;
+    quintptr indices; // offset into the bound index buffer
+};
+
+struct DrawIndexedIndirect
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::DrawIndexedIndirect;
+    QSSGRenderDrawMode drawMode;
+    QSSGRenderComponentType type;
+    quintptr indirect; // offset into the bound indirect buffer
+};
+
+struct CreateDepthStencilState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateDepthStencilState;
+    bool enableDepth;
+    bool depthMask;
+    QSSGRenderBoolOp depthFunc;
+    bool enableStencil;
+    QSSGRenderStencilFunction stencilFuncFront;
+    QSSGRenderStencilFunction stencilFuncBack;
+    QSSGRenderStencilOperation depthStencilOpFront;
+    QSSGRenderStencilOperation depthStencilOpBack;
+    DepthStencilStateObject result;
+};
+
+struct ReleaseDepthStencilState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseDepthStencilState;
+    DepthStencilStateObject depthStencilState;
+};
+
+struct CreateRasterizerState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateRasterizerState;
+    float depthBias;
+    float depthScale;
+    QSSGRenderFace cullFace;
+    RasterizerStateObject result;
+};
+
+struct ReleaseRasterizerState
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseRasterizerState;
+    RasterizerStateObject rasterizerState;
+};
+
+struct CreateBuffer // followed by size bytes of initial data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateBuffer;
+    QSSGRenderBufferType bindFlags;
+    QSSGRenderBufferUsageType usage;
+    quint32 size;
+    BufferObject result;
+};
+
+struct ReleaseBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseBuffer;
+    BufferObject bo;
+};
+
+// A mapBuffer()/unmapBuffer() pair, followed by the size bytes that were in
+// the mapped range when it got unmapped.
+struct MapBuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::MapBuffer;
+    BufferObject bo;
+    QSSGRenderBufferType bindFlags;
+    size_t offset;
+    quint32 size;
+    QSSGRenderBufferAccessFlags accessFlags;
+};
+
+struct CreateQuery
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateQuery;
+    QueryObject result;
+};
+
+struct ReleaseQuery
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseQuery;
+    QueryObject qo;
+};
+
+struct GetQueryResult
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::GetQueryResult;
+    QueryObject qo;
+    QSSGRenderQueryResultType resultType;
+    bool result64;
+};
+
+struct CreateSync
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateSync;
+    QSSGRenderSyncType syncType;
+    QSSGRenderSyncFlags syncFlags;
+    SyncObject result;
+};
+
+struct ReleaseSync
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseSync;
+    SyncObject so;
+};
+
+struct WaitSync
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::WaitSync;
+    SyncObject so;
+    QSSGRenderCommandFlushFlags syncFlags;
+    quint64 timeout;
+};
+
+struct CreateRenderTarget
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateRenderTarget;
+    RenderTargetObject result;
+};
+
+struct ReleaseRenderTarget
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseRenderTarget;
+    RenderTargetObject rto;
+};
+
+struct RenderTargetAttachRenderbuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::RenderTargetAttachRenderbuffer;
+    RenderTargetObject rto;
+    QSSGRenderFrameBufferAttachment attachment;
+    RenderbufferObject rbo;
+};
+
+struct RenderTargetAttachTexture
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::RenderTargetAttachTexture;
+    RenderTargetObject rto;
+    QSSGRenderFrameBufferAttachment attachment;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+};
+
+struct RenderTargetAttachTextureLayer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::RenderTargetAttachTextureLayer;
+    RenderTargetObject rto;
+    QSSGRenderFrameBufferAttachment attachment;
+    TextureObject to;
+    qint32 level;
+    qint32 layer;
+};
+
+struct CreateRenderbuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateRenderbuffer;
+    QSSGRenderRenderBufferFormat storageFormat;
+    qint32 width;
+    qint32 height;
+    RenderbufferObject result;
+};
+
+struct ReleaseRenderbuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseRenderbuffer;
+    RenderbufferObject rbo;
+};
+
+struct ResizeRenderbuffer
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ResizeRenderbuffer;
+    RenderbufferObject rbo;
+    QSSGRenderRenderBufferFormat storageFormat;
+    qint32 width;
+    qint32 height;
+};
+
+struct CreateTexture
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateTexture;
+    TextureObject result;
+};
+
+struct SetTextureData2D // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetTextureData2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    qint32 border;
+    QSSGRenderTextureFormat format;
+    quint32 size;
+};
+
+struct SetTextureDataCubeFace // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetTextureDataCubeFace;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    qint32 border;
+    QSSGRenderTextureFormat format;
+    quint32 size;
+};
+
+struct CreateTextureStorage2D
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateTextureStorage2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 levels;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+};
+
+struct SetTextureSubData2D // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetTextureSubData2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    qint32 xOffset;
+    qint32 yOffset;
+    qint32 width;
+    qint32 height;
+    QSSGRenderTextureFormat format;
+    quint32 size;
+};
+
+struct SetCompressedTextureData2D // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetCompressedTextureData2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    qint32 border;
+    quint32 size;
+};
+
+struct SetCompressedTextureDataCubeFace // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetCompressedTextureDataCubeFace;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    qint32 border;
+    quint32 size;
+};
+
+struct SetCompressedTextureSubData2D // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetCompressedTextureSubData2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    qint32 xOffset;
+    qint32 yOffset;
+    qint32 width;
+    qint32 height;
+    QSSGRenderTextureFormat format;
+    quint32 size;
+};
+
+struct SetMultisampledTextureData2D
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetMultisampledTextureData2D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 samples;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    bool fixedSampleLocations;
+};
+
+struct SetTextureData3D // followed by size bytes of texel data
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::SetTextureData3D;
+    TextureObject to;
+    QSSGRenderTextureTargetType target;
+    qint32 level;
+    QSSGRenderTextureFormat internalFormat;
+    qint32 width;
+    qint32 height;
+    qint32 depth;
+    qint32 border;
+    QSSGRenderTextureFormat format;
+    quint32 size;
+};
+
+struct ReleaseTexture
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseTexture;
+    TextureObject to;
+};
+
+struct CreateSampler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateSampler;
+    QSSGRenderTextureMinifyingOp minFilter;
+    QSSGRenderTextureMagnifyingOp magFilter;
+    QSSGRenderTextureCoordOp wrapS;
+    QSSGRenderTextureCoordOp wrapT;
+    QSSGRenderTextureCoordOp wrapR;
+    qint32 minLod;
+    qint32 maxLod;
+    float lodBias;
+    QSSGRenderTextureCompareMode compareMode;
+    QSSGRenderTextureCompareOp compareFunc;
+    float anisotropy;
+    bool hasBorderColor;
+    float borderColor[4];
+    SamplerObject result;
+};
+
+struct ReleaseSampler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseSampler;
+    SamplerObject so;
+};
+
+// Followed by count AttribEntry structs and then the zero terminated
+// attribute names the entries point to.
+struct CreateAttribLayout
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateAttribLayout;
+    quint32 count;
+    AttribLayoutObject result;
+};
+
+struct AttribEntry
+{
+    quint32 nameOffset; // from the start of the name block
+    QSSGRenderComponentType componentType;
+    quint32 numComponents;
+    quint32 firstItemOffset;
+    quint32 inputSlot;
+};
+
+struct ReleaseAttribLayout
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseAttribLayout;
+    AttribLayoutObject ao;
+};
+
+// Followed by bufferCount buffer handles, strideCount strides and offsetCount
+// offsets.
+struct CreateInputAssembler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateInputAssembler;
+    AttribLayoutObject attribLayout;
+    BufferObject indexBuffer;
+    quint32 bufferCount;
+    quint32 strideCount;
+    quint32 offsetCount;
+    quint32 patchVertexCount;
+    InputAssemblerObject result;
+};
+
+struct ReleaseInputAssembler
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseInputAssembler;
+    InputAssemblerObject iao;
+};
+
+struct CreateShader // followed by size bytes of source or binary
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateShader;
+    ShaderStage stage;
+    bool binary;
+    quint32 size;
+    ShaderObject result;
+};
+
+struct ReleaseShader
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseShader;
+    ShaderStage stage;
+    ShaderObject shader;
+};
+
+struct AttachShader
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::AttachShader;
+    ShaderProgramObject po;
+    ShaderStage stage;
+    ShaderObject shader;
+};
+
+struct DetachShader
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::DetachShader;
+    ShaderProgramObject po;
+    ShaderStage stage;
+    ShaderObject shader;
+};
+
+struct CreateShaderProgram
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateShaderProgram;
+    bool isSeparable;
+    ShaderProgramObject result;
+};
+
+struct ReleaseShaderProgram
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseShaderProgram;
+    ShaderProgramObject po;
+};
+
+struct LinkProgram
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::LinkProgram;
+    ShaderProgramObject po;
+};
+
+struct CreateProgramPipeline
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::CreateProgramPipeline;
+    ProgramPipeline result;
+};
+
+struct ReleaseProgramPipeline
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReleaseProgramPipeline;
+    ProgramPipeline ppo;
+};
+
+struct ReadPixel
+{
+    static constexpr QSSGRenderCommandType Type = QSSGRenderCommandType::ReadPixel;
+    RenderTargetObject rto;
+    qint32 x;
+    qint32 y;
+    qint32 width;
+    qint32 height;
+    QSSGRenderReadPixelFormat format;
+};
+
+} // namespace QSSGRenderCommands
+
+// Translates backend handles recorded in a command list to the handles of
+// the backend the list is replayed on. Filled while replaying the Create*
+// commands of a capture, handles that were never created during replay map to
+// themselves.
+class Q_QUICK3DRENDER_EXPORT QSSGRenderHandleMap
+{
+public:
+    template<typename THandle>
+    THandle map(THandle inHandle) const
+    {
+        if (!inHandle)
+            return inHandle;
+        const auto it = m_handles.constFind(reinterpret_cast<quintptr>(inHandle));
+        return it != m_handles.cend() ? reinterpret_cast<THandle>(it.value().created) : inHandle;
+    }
+
+    // inCreatedBy is the Create* command that made inCreated, inStage the
+    // stage of a created shader.
+    template<typename THandle>
+    void insert(THandle inRecorded,
+                THandle inCreated,
+                QSSGRenderCommandType inCreatedBy,
+                QSSGRenderCommands::ShaderStage inStage = QSSGRenderCommands::ShaderStage::Vertex)
+    {
+        m_handles.insert(reinterpret_cast<quintptr>(inRecorded),
+                         Entry{ reinterpret_cast<quintptr>(inCreated), inCreatedBy, inStage });
+    }
+
+    template<typename THandle>
+    void remove(THandle inRecorded)
+    {
+        m_handles.remove(reinterpret_cast<quintptr>(inRecorded));
+    }
+
+    void clear() { m_handles.clear(); }
+
+    // Releases every handle created during replay and not released by the
+    // replayed commands yet on inBackend, then clears the map. Objects
+    // referencing others are released first.
+    void releaseAll(QSSGRenderBackend *inBackend);
+
+private:
+    struct Entry
+    {
+        quintptr created;
+        QSSGRenderCommandType createdBy;
+        QSSGRenderCommands::ShaderStage stage;
+    };
+
+    QHash<quintptr, Entry> m_handles;
+};
+
+// A linear list of recorded backend calls.
+// Commands are stored back to back in large chunks: an 8 byte header
+// followed by the payload and any trailing data. reset() keeps the chunks
+// around so a list that is rebuilt every frame stops allocating after the
+// first few frames. A list is not thread safe, each recording thread is
+// expected to fill its own list; replay must happen on the thread owning the
+// target backend's context.
+class Q_QUICK3DRENDER_EXPORT QSSGRenderCommandList
+{
+    Q_DISABLE_COPY(QSSGRenderCommandList)
+public:
+    struct Header
+    {
+        QSSGRenderCommandType type;
+        quint16 reserved;
+        quint32 size; // size of the command, including this header
+    };
+
+    QSSGRenderCommandList() = default;
+    ~QSSGRenderCommandList();
+
+    template<typename TCommand>
+    TCommand *append(const TCommand &command, quint32 extraSize = 0)
+    {
+        Q_STATIC_ASSERT(alignof(TCommand) <= Alignment);
+        void *mem = allocate(TCommand::Type, sizeof(TCommand) + extraSize);
+        return new (mem) TCommand(command);
+    }
+
+    // Trailing data of a command returned by append()
+    template<typename TCommand>
+    static quint8 *extraData(TCommand *command)
+    {
+        return reinterpret_cast<quint8 *>(command + 1);
+    }
+
+    template<typename TCommand>
+    static const quint8 *extraData(const TCommand *command)
+    {
+        return reinterpret_cast<const quint8 *>(command + 1);
+    }
+
+    // Forget all recorded commands, keeping the allocated memory for reuse.
+    void reset();
+    // Forget all recorded commands and release the memory.
+    void clear();
+
+    bool isEmpty() const { return m_commandCount == 0; }
+    quint32 commandCount() const { return m_commandCount; }
+    // Number of bytes used by the recorded commands
+    size_t size() const;
+
+    // Number of bytes read from the value passed to setConstantValue, and
+    // the number of bytes to store for it in outStorageSize.
+    static quint32 constantValueSize(QSSGRenderShaderDataType inType, qint32 inCount, quint32 *outStorageSize);
+
+    // Copy a command, header included, from another list.
+    void appendCommand(const Header *inCommand);
+
+    // Issue all recorded commands, in recording order, on inBackend.
+    void replay(QSSGRenderBackend *inBackend) const;
+    // Same, translating handles through ioHandles. Needed for lists that
+    // contain resource creation, see QSSGRenderBackendCapture.
+    void replay(QSSGRenderBackend *inBackend, QSSGRenderHandleMap &ioHandles) const;
+    // Issue a single command.
+    static void replay(QSSGRenderBackend *inBackend, const Header *inCommand, QSSGRenderHandleMap *ioHandles = nullptr);
+
+    template<typename TFunc>
+    void forEachCommand(TFunc inFunc) const
+    {
+        for (const Chunk &chunk : m_chunks) {
+            size_t offset = 0;
+            while (offset < chunk.used) {
+                const Header *header = reinterpret_cast<const Header *>(chunk.data + offset);
+                inFunc(header);
+                offset += header->size;
+            }
+        }
+    }
+
+    // Serialize the commands as one block: command count, byte size and the
+    // commands back to back. Handles are written as they are, so the data
+    // can only be read back on a machine with the same pointer size.
+    bool write(QIODevice *inDevice) const;
+    // Append the commands of a block written by write().
+    bool read(QIODevice *inDevice);
+
+    static constexpr size_t Alignment = 8;
+    static constexpr size_t ChunkSize = 64 * 1024;
+
+private:
+    struct Chunk
+    {
+        quint8 *data;
+        size_t capacity;
+        size_t used;
+    };
+
+    void *allocate(QSSGRenderCommandType inType, size_t inSize);
+
+    QVector<Chunk> m_chunks;
+    int m_currentChunk = 0;
+    quint32 m_commandCount = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -53,6 +53,11 @@ bool QSSGOpenGLExtensions::initializeOpenGLFunctions()
             context->getProcAddress("glPathGlyphIndexArrayNV"));
     d->PathGlyphIndexRangeNV = reinterpret_cast<GLenum(QOPENGLF_APIENTRYP)(GLenum, const void *, GLbitfield, GLuint, GLfloat, GLuint[2])>(
             context->getProcAddress("glPathGlyphIndexRangeNV"));
+    d->MaxShaderCompilerThreadsKHR = reinterpret_cast<void(QOPENGLF_APIENTRYP)(GLuint)>(
+            context->getProcAddress("glMaxShaderCompilerThreadsKHR"));
+    if (!d->MaxShaderCompilerThreadsKHR)
+        d->MaxShaderCompilerThreadsKHR = reinterpret_cast<void(QOPENGLF_APIENTRYP)(GLuint)>(
+                context->getProcAddress("glMaxShaderCompilerThreadsARB"));
     QAbstractOpenGLExtension::initializeOpenGLFunctions();
     return true;
 }
@@ -80,6 +85,8 @@ bool QSSGOpenGLES2Extensions::initializeOpenGLFunctions()
             context->getProcAddress("glQueryCounterEXT"));
     d->GetQueryObjectui64vEXT = reinterpret_cast<void(QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64 *)>(
             context->getProcAddress("glGetQueryObjectui64vEXT"));
+    d->MaxShaderCompilerThreadsKHR = reinterpret_cast<void(QOPENGLF_APIENTRYP)(GLuint)>(
+            context->getProcAddress("glMaxShaderCompilerThreadsKHR"));
     d->GenPathsNV = reinterpret_cast<GLuint(QOPENGLF_APIENTRYP)(GLsizei)>(context->getProcAddress("glGenPathsNV"));
     d->DeletePathsNV = reinterpret_cast<void(QOPENGLF_APIENTRYP)(GLuint, GLsizei)>(
             context->getProcAddress("glDeletePathsNV"));
@@ -55,6 +55,8 @@ public:
     void(QOPENGLF_APIENTRYP BlendBarrierNV)();
     GLenum(QOPENGLF_APIENTRYP PathGlyphIndexArrayNV)(GLuint, GLenum, const void *, GLbitfield, GLuint, GLsizei, GLuint, GLfloat);
     GLenum(QOPENGLF_APIENTRYP PathGlyphIndexRangeNV)(GLenum, const void *, GLbitfield, GLuint, GLfloat, GLuint[2]);
+    // KHR_parallel_shader_compile, or the ARB entry point of the same signature
+    void(QOPENGLF_APIENTRYP MaxShaderCompilerThreadsKHR)(GLuint);
 
 #if defined(QT_OPENGL_ES) || defined(QT_OPENGL_ES_2_ANGLE)
     void(QOPENGLF_APIENTRYP PatchParameteriEXT)(GLenum, GLint);
@@ -107,6 +109,8 @@ public:
                                    GLuint pathParameterTemplate,
                                    GLfloat emScale,
                                    GLuint baseAndCount[2]);
+    bool hasMaxShaderCompilerThreads() const;
+    void glMaxShaderCompilerThreadsKHR(GLuint count);
 
 protected:
     Q_DECLARE_PRIVATE(QSSGOpenGLExtensions)
@@ -142,6 +146,18 @@ inline GLenum QSSGOpenGLExtensions::glPathGlyphIndexRangeNV(GLenum fontTarget,
     return d->PathGlyphIndexRangeNV(fontTarget, fontName, fontStyle, pathParameterTemplate, emScale, baseAndCount);
 }
 
+inline bool QSSGOpenGLExtensions::hasMaxShaderCompilerThreads() const
+{
+    Q_D(const QSSGOpenGLExtensions);
+    return d->MaxShaderCompilerThreadsKHR != nullptr;
+}
+
+inline void QSSGOpenGLExtensions::glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+    Q_D(QSSGOpenGLExtensions);
+    d->MaxShaderCompilerThreadsKHR(count);
+}
+
 #if defined(QT_OPENGL_ES) || defined(QT_OPENGL_ES_2_ANGLE)
 class QSSGOpenGLES2Extensions : public QSSGOpenGLExtensions
 {
@@ -106,6 +106,10 @@ QT_BEGIN_NAMESPACE
 #define GL_DRAW_INDIRECT_BUFFER 0x8F3F
 #endif
 
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+
 #ifndef GL_VERTEX_SHADER_BIT
 #define GL_VERTEX_SHADER_BIT 0x00000001
 #endif
@@ -708,6 +712,8 @@ struct GLConversion
             return GL_ATOMIC_COUNTER_BUFFER;
         case QSSGRenderBufferType::DrawIndirect:
             return GL_DRAW_INDIRECT_BUFFER;
+        case QSSGRenderBufferType::PixelPack:
+            return GL_PIXEL_PACK_BUFFER;
         }
         Q_ASSERT(false);
         return 0;
@@ -727,6 +733,8 @@ struct GLConversion
             return QSSGRenderBufferType::AtomicCounter;
         else if (value == GL_DRAW_INDIRECT_BUFFER)
             return QSSGRenderBufferType::DrawIndirect;
+        else if (value == GL_PIXEL_PACK_BUFFER)
+            return QSSGRenderBufferType::PixelPack;
         else
             Q_ASSERT(false);
 
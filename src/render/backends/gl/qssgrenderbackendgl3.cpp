@@ -77,6 +77,14 @@ QByteArray extsAstcLDR()
 {
     return QByteArrayLiteral("GL_KHR_texture_compression_astc_ldr");
 }
+QByteArray extsParallelShaderCompileKHR()
+{
+    return QByteArrayLiteral("GL_KHR_parallel_shader_compile");
+}
+QByteArray extsParallelShaderCompileARB()
+{
+    return QByteArrayLiteral("GL_ARB_parallel_shader_compile");
+}
 }
 
 /// constructor
@@ -129,6 +137,10 @@ QSSGRenderBackendGL3Impl::QSSGRenderBackendGL3Impl(const QSurfaceFormat &format)
         } else if (!m_backendSupport.caps.bits.bGPUShader5ExtensionSupported
                    && QSSGGlExtStrings::extsGpuShader5().compare(extensionString) == 0) {
             m_backendSupport.caps.bits.bGPUShader5ExtensionSupported = true;
+        } else if (!m_backendSupport.caps.bits.bParallelShaderCompileSupported
+                   && (QSSGGlExtStrings::extsParallelShaderCompileKHR().compare(extensionString) == 0
+                       || QSSGGlExtStrings::extsParallelShaderCompileARB().compare(extensionString) == 0)) {
+            m_backendSupport.caps.bits.bParallelShaderCompileSupported = true;
         }
     }
 
@@ -176,6 +188,13 @@ QSSGRenderBackendGL3Impl::QSSGRenderBackendGL3Impl(const QSurfaceFormat &format)
     m_QSSGExtensions = new QSSGOpenGLExtensions;
     m_QSSGExtensions->initializeOpenGLFunctions();
 #endif
+    // Let the driver pick the number of compiler threads
+    if (m_backendSupport.caps.bits.bParallelShaderCompileSupported) {
+        if (m_QSSGExtensions->hasMaxShaderCompilerThreads())
+            m_QSSGExtensions->glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        else
+            m_backendSupport.caps.bits.bParallelShaderCompileSupported = false;
+    }
 }
 /// destructor
 QSSGRenderBackendGL3Impl::~QSSGRenderBackendGL3Impl()
@@ -374,6 +393,18 @@ void QSSGRenderBackendGL3Impl::generateMipMaps(QSSGRenderBackendTextureObject to
     GL_CALL_EXTRA_FUNCTION(glBindTexture(glTarget, 0));
 }
 
+void QSSGRenderBackendGL3Impl::resetStateCache()
+{
+    QSSGRenderBackendGLBase::resetStateCache();
+    if (m_backendSupport.caps.bits.bTessellationSupported) {
+#if defined(QT_OPENGL_ES)
+        GL_CALL_TESSELATION_EXT(glPatchParameteriEXT(GL_PATCH_VERTICES, m_currentMiscState->m_patchVertexCount));
+#else
+        GL_CALL_TESSELATION_EXT(glPatchParameteri(GL_PATCH_VERTICES, GLint(m_currentMiscState->m_patchVertexCount)));
+#endif
+    }
+}
+
 bool QSSGRenderBackendGL3Impl::setInputAssembler(QSSGRenderBackendInputAssemblerObject iao, QSSGRenderBackendShaderProgramObject po)
 {
     if (iao == nullptr) {
@@ -398,6 +429,8 @@ bool QSSGRenderBackendGL3Impl::setInputAssembler(QSSGRenderBackendInputAssembler
         return false;
     }
 
+    // vertex array objects are not shared between contexts
+    inputAssembler->selectContext(QOpenGLContext::currentContext());
     if (inputAssembler->m_vaoID == 0) {
         // generate vao
         GL_CALL_EXTRA_FUNCTION(glGenVertexArrays(1, &inputAssembler->m_vaoID));
@@ -685,6 +718,17 @@ void QSSGRenderBackendGL3Impl::programSetConstantBuffer(quint32 index, QSSGRende
     GL_CALL_EXTRA_FUNCTION(glBindBufferBase(GL_UNIFORM_BUFFER, index, bufID));
 }
 
+void QSSGRenderBackendGL3Impl::programSetConstantBufferRange(quint32 index,
+                                                             QSSGRenderBackendBufferObject bo,
+                                                             quint32 offset,
+                                                             quint32 size)
+{
+    Q_ASSERT(bo);
+
+    GLuint bufID = HandleToID_cast(GLuint, size_t, bo);
+    GL_CALL_EXTRA_FUNCTION(glBindBufferRange(GL_UNIFORM_BUFFER, index, bufID, GLintptr(offset), GLsizeiptr(size)));
+}
+
 QSSGRenderBackend::QSSGRenderBackendQueryObject QSSGRenderBackendGL3Impl::createQuery()
 {
     quint32 glQueryID = 0;
@@ -776,4 +820,13 @@ void QSSGRenderBackendGL3Impl::waitSync(QSSGRenderBackendSyncObject so, QSSGRend
     GL_CALL_EXTRA_FUNCTION(glWaitSync(syncID, 0, GL_TIMEOUT_IGNORED));
 }
 
+bool QSSGRenderBackendGL3Impl::isSyncSignaled(QSSGRenderBackendSyncObject so)
+{
+    GLsync syncID = GLsync(so);
+
+    // a zero timeout only polls, the flush makes sure the sync is eventually signaled
+    const GLenum status = GL_CALL_EXTRA_FUNCTION(glClientWaitSync(syncID, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED;
+}
+
 QT_END_NAMESPACE
@@ -121,6 +121,7 @@ public:
                               QSSGRenderTextureSwizzleMode swizzleMode) override;
 
     bool setInputAssembler(QSSGRenderBackendInputAssemblerObject iao, QSSGRenderBackendShaderProgramObject po) override;
+    void resetStateCache() override;
 
     void setDrawBuffers(QSSGRenderBackendRenderTargetObject rto, QSSGDataView<qint32> inDrawBufferSet) override;
     void setReadBuffer(QSSGRenderBackendRenderTargetObject rto, QSSGReadFace inReadFace) override;
@@ -182,6 +183,7 @@ public:
                                              qint32 *offset) override;
     void programSetConstantBlock(QSSGRenderBackendShaderProgramObject po, quint32 blockIndex, quint32 binding) override;
     void programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) override;
 
     QSSGRenderBackendQueryObject createQuery() override;
     void releaseQuery(QSSGRenderBackendQueryObject qo) override;
@@ -194,6 +196,7 @@ public:
     QSSGRenderBackendSyncObject createSync(QSSGRenderSyncType tpye, QSSGRenderSyncFlags syncFlags) override;
     void releaseSync(QSSGRenderBackendSyncObject so) override;
     void waitSync(QSSGRenderBackendSyncObject so, QSSGRenderCommandFlushFlags syncFlags, quint64 timeout) override;
+    bool isSyncSignaled(QSSGRenderBackendSyncObject so) override;
 
 protected:
     QSSGRenderBackendMiscStateGL *m_currentMiscState; ///< this holds the current misc state
@@ -249,6 +249,9 @@ bool QSSGRenderBackendGLBase::getRenderBackendCap(QSSGRenderBackend::QSSGRenderB
     case QSSGRenderBackendCaps::TextureLod:
         bSupported = m_backendSupport.caps.bits.bTextureLodSupported;
         break;
+    case QSSGRenderBackendCaps::ParallelShaderCompile:
+        bSupported = m_backendSupport.caps.bits.bParallelShaderCompileSupported;
+        break;
     default:
         Q_ASSERT(false);
         bSupported = false;
@@ -295,6 +298,16 @@ void QSSGRenderBackendGLBase::getRenderBackendValue(QSSGRenderBackendQuery inQue
                 *params = 0;
             }
         } break;
+        case QSSGRenderBackendQuery::ConstantBufferOffsetAlignment: {
+            QSSGRenderContextTypes noConstantBufferSupportedContextFlags(QSSGRenderContextType::GL2
+                                                                          | QSSGRenderContextType::GLES2);
+            QSSGRenderContextType ctxType = getRenderContextType();
+            if (!(noConstantBufferSupportedContextFlags & ctxType)) {
+                GL_CALL_FUNCTION(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, params));
+            } else {
+                *params = 0;
+            }
+        } break;
         default:
             Q_ASSERT(false);
             *params = 0;
@@ -463,6 +476,40 @@ void QSSGRenderBackendGLBase::setRasterizerState(QSSGRenderBackendRasterizerStat
     }
 }
 
+void QSSGRenderBackendGLBase::resetStateCache()
+{
+    // The cached state reflects whatever context rendered last, so apply all of it again
+    const QSSGRenderBackendDepthStencilStateGL &ds = *m_currentDepthStencilState;
+    setRenderState(ds.m_depthEnable, QSSGRenderState::DepthTest);
+    setRenderState(ds.m_stencilEnable, QSSGRenderState::StencilTest);
+    GL_CALL_FUNCTION(glDepthMask(ds.m_depthMask));
+    GL_CALL_FUNCTION(glDepthFunc(m_conversion.fromBoolOpToGL(ds.m_depthFunc)));
+    GL_CALL_FUNCTION(glStencilOpSeparate(GL_FRONT,
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpFront.m_stencilFail),
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpFront.m_depthFail),
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpFront.m_depthPass)));
+    GL_CALL_FUNCTION(glStencilOpSeparate(GL_BACK,
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpBack.m_stencilFail),
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpBack.m_depthFail),
+                                         m_conversion.fromStencilOpToGL(ds.m_depthStencilOpBack.m_depthPass)));
+    GL_CALL_FUNCTION(glStencilFuncSeparate(GL_FRONT,
+                                           m_conversion.fromBoolOpToGL(ds.m_stencilFuncFront.m_function),
+                                           ds.m_stencilFuncFront.m_referenceValue,
+                                           ds.m_stencilFuncFront.m_mask));
+    GL_CALL_FUNCTION(glStencilFuncSeparate(GL_BACK,
+                                           m_conversion.fromBoolOpToGL(ds.m_stencilFuncBack.m_function),
+                                           ds.m_stencilFuncBack.m_referenceValue,
+                                           ds.m_stencilFuncBack.m_mask));
+
+    const QSSGRenderBackendRasterizerStateGL &rs = *m_currentRasterizerState;
+    if (rs.m_depthBias != 0.0f || rs.m_depthScale != 0.0f)
+        GL_CALL_FUNCTION(glEnable(GL_POLYGON_OFFSET_FILL));
+    else
+        GL_CALL_FUNCTION(glDisable(GL_POLYGON_OFFSET_FILL));
+    GL_CALL_FUNCTION(glPolygonOffset(rs.m_depthBias, rs.m_depthScale));
+    GL_CALL_FUNCTION(glCullFace(m_conversion.fromFacesToGL(rs.m_cullFace)));
+}
+
 bool QSSGRenderBackendGLBase::getRenderState(const QSSGRenderState value)
 {
     bool enabled = GL_CALL_FUNCTION(glIsEnabled(m_conversion.fromRenderStateToGL(value)));
@@ -715,6 +762,14 @@ void QSSGRenderBackendGLBase::waitSync(QSSGRenderBackendSyncObject, QSSGRenderCo
     qCCritical(INVALID_OPERATION) << QObject::tr("Unsupported method: ") << __FUNCTION__;
 }
 
+bool QSSGRenderBackendGLBase::isSyncSignaled(QSSGRenderBackendSyncObject)
+{
+    // needs GL 3 context
+    qCCritical(INVALID_OPERATION) << QObject::tr("Unsupported method: ") << __FUNCTION__;
+
+    return true;
+}
+
 QSSGRenderBackend::QSSGRenderBackendRenderTargetObject QSSGRenderBackendGLBase::createRenderTarget()
 {
     GLuint fboID = 0;
@@ -1296,6 +1351,11 @@ bool QSSGRenderBackendGLBase::compileSource(GLuint shaderID, QSSGByteView source
         GL_CALL_FUNCTION(glShaderSource(shaderID, 1, &shaderSourceData, &shaderSourceSize));
         GL_CALL_FUNCTION(glCompileShader(shaderID));
 
+        // With parallel compilation the status query would wait for the compiler.
+        // Errors surface when the program is linked, see linkProgram.
+        if (m_backendSupport.caps.bits.bParallelShaderCompileSupported)
+            return true;
+
         GLint logLen;
         GL_CALL_FUNCTION(glGetShaderiv(shaderID, GL_COMPILE_STATUS, &shaderStatus));
         GL_CALL_FUNCTION(glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &logLen));
@@ -1583,7 +1643,10 @@ bool QSSGRenderBackendGLBase::linkProgram(QSSGRenderBackendShaderProgramObject p
     QSSGRenderBackendShaderProgramGL *pProgram = reinterpret_cast<QSSGRenderBackendShaderProgramGL *>(po);
     GLuint programID = static_cast<GLuint>(pProgram->m_programID);
 
-    GL_CALL_FUNCTION(glLinkProgram(programID));
+    if (pProgram->m_linkStarted)
+        pProgram->m_linkStarted = false;
+    else
+        GL_CALL_FUNCTION(glLinkProgram(programID));
 
     GLint linkStatus, logLen;
     GL_CALL_FUNCTION(glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus));
@@ -1665,9 +1728,46 @@ bool QSSGRenderBackendGLBase::linkProgram(QSSGRenderBackendShaderProgramObject p
         GL_CALL_FUNCTION(glGetProgramInfoLog(programID, logLen, &lenWithoutNull, errorMessage.data()));
     }
 
+    // compileSource does not fetch the shader logs when compiling in parallel
+    if (!linkStatus && m_backendSupport.caps.bits.bParallelShaderCompileSupported) {
+        GLuint shaders[5];
+        GLsizei shaderCount = 0;
+        GL_CALL_FUNCTION(glGetAttachedShaders(programID, 5, &shaderCount, shaders));
+        for (GLsizei idx = 0; idx < shaderCount; ++idx) {
+            GLint shaderStatus, shaderLogLen;
+            GL_CALL_FUNCTION(glGetShaderiv(shaders[idx], GL_COMPILE_STATUS, &shaderStatus));
+            GL_CALL_FUNCTION(glGetShaderiv(shaders[idx], GL_INFO_LOG_LENGTH, &shaderLogLen));
+            if (shaderStatus == GL_TRUE || shaderLogLen <= 2)
+                continue;
+            QByteArray shaderLog(shaderLogLen + 1, '\0');
+            GLint lenWithoutNull;
+            GL_CALL_FUNCTION(glGetShaderInfoLog(shaders[idx], shaderLogLen, &lenWithoutNull, shaderLog.data()));
+            shaderLog.resize(lenWithoutNull);
+            errorMessage.append(shaderLog);
+        }
+    }
+
     return (linkStatus == GL_TRUE);
 }
 
+void QSSGRenderBackendGLBase::startLinkProgram(QSSGRenderBackendShaderProgramObject po)
+{
+    QSSGRenderBackendShaderProgramGL *pProgram = reinterpret_cast<QSSGRenderBackendShaderProgramGL *>(po);
+    GL_CALL_FUNCTION(glLinkProgram(static_cast<GLuint>(pProgram->m_programID)));
+    pProgram->m_linkStarted = true;
+}
+
+bool QSSGRenderBackendGLBase::isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po)
+{
+    if (!m_backendSupport.caps.bits.bParallelShaderCompileSupported)
+        return true;
+
+    QSSGRenderBackendShaderProgramGL *pProgram = reinterpret_cast<QSSGRenderBackendShaderProgramGL *>(po);
+    GLint complete = GL_TRUE;
+    GL_CALL_FUNCTION(glGetProgramiv(static_cast<GLuint>(pProgram->m_programID), GL_COMPLETION_STATUS_KHR, &complete));
+    return complete == GL_TRUE;
+}
+
 void QSSGRenderBackendGLBase::setActiveProgram(QSSGRenderBackendShaderProgramObject po)
 {
     GLuint programID = 0;
@@ -1828,6 +1928,20 @@ void QSSGRenderBackendGLBase::programSetConstantBuffer(quint32 index, QSSGRender
     qCCritical(INVALID_OPERATION) << QObject::tr("Unsupported method: ") << __FUNCTION__;
 }
 
+void QSSGRenderBackendGLBase::programSetConstantBufferRange(quint32 index,
+                                                            QSSGRenderBackendBufferObject bo,
+                                                            quint32 offset,
+                                                            quint32 size)
+{
+    // needs GL3 and above
+    Q_UNUSED(index)
+    Q_UNUSED(bo)
+    Q_UNUSED(offset)
+    Q_UNUSED(size)
+
+    qCCritical(INVALID_OPERATION) << QObject::tr("Unsupported method: ") << __FUNCTION__;
+}
+
 qint32 QSSGRenderBackendGLBase::getStorageBufferCount(QSSGRenderBackendShaderProgramObject po)
 {
     // needs GL4 and above
@@ -167,6 +167,7 @@ public:
     QSSGRenderBackendSyncObject createSync(QSSGRenderSyncType tpye, QSSGRenderSyncFlags syncFlags) override;
     void releaseSync(QSSGRenderBackendSyncObject so) override;
     void waitSync(QSSGRenderBackendSyncObject so, QSSGRenderCommandFlushFlags syncFlags, quint64 timeout) override;
+    bool isSyncSignaled(QSSGRenderBackendSyncObject so) override;
 
     QSSGRenderBackendRenderTargetObject createRenderTarget() override;
     void releaseRenderTarget(QSSGRenderBackendRenderTargetObject rto) override;
@@ -385,6 +386,8 @@ public:
     QSSGRenderBackendShaderProgramObject createShaderProgram(bool isSeparable) override;
     void releaseShaderProgram(QSSGRenderBackendShaderProgramObject po) override;
     bool linkProgram(QSSGRenderBackendShaderProgramObject po, QByteArray &errorMessage) override;
+    void startLinkProgram(QSSGRenderBackendShaderProgramObject po) override;
+    bool isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po) override;
     void setActiveProgram(QSSGRenderBackendShaderProgramObject po) override;
     void dispatchCompute(QSSGRenderBackendShaderProgramObject po, quint32 numGroupsX, quint32 numGroupsY, quint32 numGroupsZ) override;
     QSSGRenderBackendProgramPipeline createProgramPipeline() override;
@@ -428,6 +431,7 @@ public:
                                              qint32 *offset) override;
     void programSetConstantBlock(QSSGRenderBackendShaderProgramObject po, quint32 blockIndex, quint32 binding) override;
     void programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) override;
 
     // storage buffers
     qint32 getStorageBufferCount(QSSGRenderBackendShaderProgramObject po) override;
@@ -582,6 +586,7 @@ public:
                                   const float *) override;
 
     QSurfaceFormat format() const override { return m_format; }
+    void resetStateCache() override;
 
 protected:
     virtual bool compileSource(GLuint shaderID, QSSGByteView source, QByteArray &errorMessage, bool binary);
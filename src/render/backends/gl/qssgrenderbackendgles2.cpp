@@ -432,6 +432,8 @@ bool QSSGRenderBackendGLES2Impl::setInputAssembler(QSSGRenderBackendInputAssembl
         return false;
     }
 
+    // vertex array objects are not shared between contexts
+    inputAssembler->selectContext(QOpenGLContext::currentContext());
     if (inputAssembler->m_vaoID == 0) {
         // generate vao
         GL_CALL_EXTENSION_FUNCTION(glGenVertexArraysOES(1, &inputAssembler->m_vaoID));
@@ -826,6 +828,17 @@ void QSSGRenderBackendGLES2Impl::programSetConstantBuffer(quint32 index, QSSGRen
     GL_CALL_EXTRA_FUNCTION(glBindBufferBase(GL_UNIFORM_BUFFER, index, bufID));
 }
 
+void QSSGRenderBackendGLES2Impl::programSetConstantBufferRange(quint32 index,
+                                                               QSSGRenderBackendBufferObject bo,
+                                                               quint32 offset,
+                                                               quint32 size)
+{
+    Q_ASSERT(bo);
+
+    GLuint bufID = HandleToID_cast(GLuint, size_t, bo);
+    GL_CALL_EXTRA_FUNCTION(glBindBufferRange(GL_UNIFORM_BUFFER, index, bufID, GLintptr(offset), GLsizeiptr(size)));
+}
+
 QSSGRenderBackend::QSSGRenderBackendQueryObject QSSGRenderBackendGLES2Impl::createQuery()
 {
     quint32 glQueryID = 0;
@@ -859,4 +872,6 @@ void QSSGRenderBackendGLES2Impl::releaseSync(QSSGRenderBackendSyncObject) {}
 
 void QSSGRenderBackendGLES2Impl::waitSync(QSSGRenderBackendSyncObject, QSSGRenderCommandFlushFlags, quint64) {}
 
+bool QSSGRenderBackendGLES2Impl::isSyncSignaled(QSSGRenderBackendSyncObject) { return true; }
+
 QT_END_NAMESPACE
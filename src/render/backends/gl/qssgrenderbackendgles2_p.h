@@ -188,6 +188,7 @@ public:
                                              qint32 *offset) override;
     void programSetConstantBlock(QSSGRenderBackendShaderProgramObject po, quint32 blockIndex, quint32 binding) override;
     void programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo) override;
+    void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) override;
 
     QSSGRenderBackendQueryObject createQuery() override;
     void releaseQuery(QSSGRenderBackendQueryObject qo) override;
@@ -200,6 +201,7 @@ public:
     QSSGRenderBackendSyncObject createSync(QSSGRenderSyncType tpye, QSSGRenderSyncFlags syncFlags) override;
     void releaseSync(QSSGRenderBackendSyncObject so) override;
     void waitSync(QSSGRenderBackendSyncObject so, QSSGRenderCommandFlushFlags syncFlags, quint64 timeout) override;
+    bool isSyncSignaled(QSSGRenderBackendSyncObject so) override;
 
 protected:
     QSSGRenderBackendMiscStateGL *m_pCurrentMiscState; ///< this holds the current misc state
@@ -50,6 +50,9 @@
 #include <QtQuick3DRender/private/qssgrenderbackend_p.h>
 
 #include <QtCore/QString>
+#include <QtCore/QPointer>
+#include <QtCore/QVarLengthArray>
+#include <QtGui/QOpenGLContext>
 
 QT_BEGIN_NAMESPACE
 
@@ -127,6 +130,32 @@ public:
     {
     }
 
+    ///< make m_vaoID and m_cachedShaderHandle refer to the vertex array of the given context
+    void selectContext(QOpenGLContext *context)
+    {
+        if (m_vaoContext == context)
+            return;
+
+        // Buffers are shared within a share group but vertex array objects are not, so an
+        // assembler used by several contexts keeps one vertex array per context.
+        if (m_vaoContext && m_vaoID)
+            m_otherContextVaos.append({ m_vaoContext, m_vaoID, m_cachedShaderHandle });
+        m_vaoContext = context;
+        m_vaoID = 0;
+        m_cachedShaderHandle = 0;
+        for (int i = m_otherContextVaos.size() - 1; i >= 0; --i) {
+            const ContextVertexArray &entry = m_otherContextVaos.at(i);
+            if (entry.context == context) {
+                m_vaoID = entry.vaoID;
+                m_cachedShaderHandle = entry.cachedShaderHandle;
+            } else if (!entry.context.isNull()) {
+                continue;
+            }
+            // destroyed contexts took their vertex arrays with them
+            m_otherContextVaos.remove(i);
+        }
+    }
+
     QSSGRenderBackendAttributeLayoutGL *m_attribLayout; ///< pointer to attribute layout
     QSSGDataView<QSSGRenderBackend::QSSGRenderBackendBufferObject> m_vertexbufferHandles; ///< opaque vertex buffer backend handles
     QSSGRenderBackend::QSSGRenderBackendBufferObject m_indexbufferHandle; ///< opaque index buffer backend handles
@@ -135,6 +164,17 @@ public:
     quint32 m_patchVertexCount; ///< vertex count for a single patch primitive
     QVector<quint32> m_strides; ///< buffer strides
     QVector<quint32> m_offsets; ///< buffer offsets
+
+private:
+    struct ContextVertexArray
+    {
+        QPointer<QOpenGLContext> context;
+        quint32 vaoID;
+        quint32 cachedShaderHandle;
+    };
+
+    QPointer<QOpenGLContext> m_vaoContext; ///< context owning m_vaoID
+    QVarLengthArray<ContextVertexArray, 1> m_otherContextVaos; ///< vertex arrays created in other contexts
 };
 
 QT_END_NAMESPACE
@@ -95,13 +95,17 @@ class QSSGRenderBackendShaderProgramGL
 {
 public:
     ///< constructor
-    QSSGRenderBackendShaderProgramGL(quint32 programID) : m_programID(programID), m_shaderInput(nullptr) {}
+    QSSGRenderBackendShaderProgramGL(quint32 programID)
+        : m_programID(programID), m_shaderInput(nullptr), m_linkStarted(false)
+    {
+    }
 
     ///< destructor
     ~QSSGRenderBackendShaderProgramGL() {}
 
     quint32 m_programID; ///< this is the OpenGL object ID
     QSSGRenderBackendShaderInputGL *m_shaderInput; ///< pointer to shader input object
+    bool m_linkStarted; ///< glLinkProgram was issued by startLinkProgram
 };
 
 QT_END_NAMESPACE
@@ -32,6 +32,7 @@
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 #include <QtQuick3DRender/private/qssgrendershaderprogram_p.h>
 #include <QtQuick3DRender/private/qssgrenderprogrampipeline_p.h>
+#include <QtQuick3DRender/private/qssgrenderbackendcapture_p.h>
 #include <QtQuick3DUtils/private/qssgdataref_p.h>
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
@@ -65,6 +66,8 @@ QSSGRef<QSSGRenderContext> QSSGRenderContext::createGl(const QSurfaceFormat &for
         qCCritical(INTERNAL_ERROR) << "Can't find a suitable OpenGL version for" << format;
     }
 
+    theBackend = QSSGRenderBackendCapture::createFromEnvironment(theBackend);
+
     QSSGRef<QSSGRenderContext> impl(new QSSGRenderContext(theBackend));
     retval = impl;
 
@@ -131,7 +131,8 @@ public:
         AdvancedBlendKHR, ///< Driver supports advanced blend modes
         VertexArrayObject,
         StandardDerivatives,
-        TextureLod
+        TextureLod,
+        ParallelShaderCompile ///< Driver compiles and links shaders in the background
     };
 
     // backend queries
@@ -141,8 +142,10 @@ public:
         MaxTextureArrayLayers, ///< Return max supported layer count for texture arrays
         MaxConstantBufferSlots, ///< Return max supported constant buffe slots for a single
         /// shader stage
-        MaxConstantBufferBlockSize ///< Return max supported size for a single constant
+        MaxConstantBufferBlockSize, ///< Return max supported size for a single constant
         /// buffer block
+        ConstantBufferOffsetAlignment ///< Return the required alignment for offsets passed to
+        /// programSetConstantBufferRange
     };
 
     /// backend interface
@@ -653,6 +656,15 @@ public:
      */
     virtual void waitSync(QSSGRenderBackendSyncObject so, QSSGRenderCommandFlushFlags syncFlags, quint64 timeout) = 0;
 
+    /**
+     * @brief check if a sync object has been signaled without blocking
+     *
+     * @param[in] so			Handle to sync object
+     *
+     * @return true if all commands issued before the sync have completed
+     */
+    virtual bool isSyncSignaled(QSSGRenderBackendSyncObject so) = 0;
+
     /**
      * @brief create a render target object
      *
@@ -1575,6 +1587,25 @@ public:
      */
     virtual bool linkProgram(QSSGRenderBackendShaderProgramObject po, QByteArray &errorMessage) = 0;
 
+    /**
+     * @brief start linking a shader program object without waiting for the result
+     *
+     * @param[in] po				Pointer to shader program object
+     *
+     * @return No return. Call linkProgram to wait for the result.
+     */
+    virtual void startLinkProgram(QSSGRenderBackendShaderProgramObject po) = 0;
+
+    /**
+     * @brief query if a started link is finished
+     *
+     * @param[in] po				Pointer to shader program object
+     *
+     * @return True if linkProgram would not block. Always true when the
+     *         driver does not support parallel shader compilation.
+     */
+    virtual bool isProgramLinkComplete(QSSGRenderBackendShaderProgramObject po) = 0;
+
     /**
      * @brief Make a program current
      *
@@ -1753,6 +1784,19 @@ public:
      */
     virtual void programSetConstantBuffer(quint32 index, QSSGRenderBackendBufferObject bo) = 0;
 
+    /**
+     * @brief Bind a range of a constant buffer for usage in the current active shader program
+     *
+     * @param[in] index				Constant ID
+     * @param[in] bo				Pointer to constant buffer object
+     * @param[in] offset			Start of the range in bytes, a multiple of
+     * ConstantBufferOffsetAlignment
+     * @param[in] size				Size of the range in bytes
+     *
+     * @return No return
+     */
+    virtual void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) = 0;
+
     /**
      * @brief Query storage buffer count for a program object
      *
@@ -2260,6 +2304,23 @@ public:
 
     virtual QSurfaceFormat format() const = 0;
 
+    /**
+     * @brief Called by the context after all calls of a frame have been issued.
+     *        Backends that do not care about frame boundaries ignore it.
+     *
+     * @return No return
+     */
+    virtual void endFrame() {}
+
+    /**
+     * @brief Called by the context when a different native context of the same
+     *        share group may have been used since the last frame. Backends that
+     *        cache state must push their cached state to the current context.
+     *
+     * @return No return
+     */
+    virtual void resetStateCache() {}
+
 protected:
     /// struct for what the backend supports
     typedef struct QSSGRenderBackendSupport
@@ -2297,6 +2358,7 @@ protected:
                 bool bVertexArrayObjectSupported : 1;
                 bool bStandardDerivativesSupported : 1;
                 bool bTextureLodSupported : 1;
+                bool bParallelShaderCompileSupported : 1; ///< KHR/ARB_parallel_shader_compile
             } bits;
 
             quint32 u32Values;
@@ -134,6 +134,7 @@ struct QSSGNullBackend : public QSSGRenderBackend
     }
     void releaseSync(QSSGRenderBackendSyncObject) override {}
     void waitSync(QSSGRenderBackendSyncObject, QSSGRenderCommandFlushFlags, quint64) override {}
+    bool isSyncSignaled(QSSGRenderBackendSyncObject) override { return true; }
     QSSGRenderBackendRenderTargetObject createRenderTarget() override
     {
         return QSSGRenderBackendRenderTargetObject(1);
@@ -401,7 +402,10 @@ struct QSSGNullBackend : public QSSGRenderBackend
     }
     void releaseProgramPipeline(QSSGRenderBackendProgramPipeline) override {}
 
-    bool linkProgram(QSSGRenderBackendShaderProgramObject, QByteArray &) override { return false; }
+    // Nothing is compiled, report success so callers go on to use the program
+    bool linkProgram(QSSGRenderBackendShaderProgramObject, QByteArray &) override { return true; }
+    void startLinkProgram(QSSGRenderBackendShaderProgramObject) override {}
+    bool isProgramLinkComplete(QSSGRenderBackendShaderProgramObject) override { return true; }
     void setActiveProgram(QSSGRenderBackendShaderProgramObject) override {}
     void setActiveProgramPipeline(QSSGRenderBackendProgramPipeline) override {}
     void setProgramStages(QSSGRenderBackendProgramPipeline, QSSGRenderShaderTypeFlags, QSSGRenderBackendShaderProgramObject) override
@@ -432,6 +436,7 @@ struct QSSGNullBackend : public QSSGRenderBackend
     }
     void programSetConstantBlock(QSSGRenderBackendShaderProgramObject, quint32, quint32) override {}
     void programSetConstantBuffer(quint32, QSSGRenderBackendBufferObject) override {}
+    void programSetConstantBufferRange(quint32, QSSGRenderBackendBufferObject, quint32, quint32) override {}
 
     qint32 getStorageBufferCount(QSSGRenderBackendShaderProgramObject) override { return 0; }
     qint32 getStorageBufferInfoByID(QSSGRenderBackendShaderProgramObject, quint32, quint32, qint32 *, qint32 *, qint32 *, char *) override
@@ -206,6 +206,7 @@ enum class QSSGRenderBufferType : quint32
     Storage, ///< Bind as shader storage buffer
     AtomicCounter, ///< Bind as atomic counter buffer
     DrawIndirect, ///< Bind as draw indirect buffer
+    PixelPack, ///< Bind as pixel pack buffer
 };
 
 enum class QSSGRenderBufferUsageType
@@ -60,8 +60,17 @@ QSSGRenderConstantBuffer::QSSGRenderConstantBuffer(const QSSGRef<QSSGRenderConte
                                                        const QByteArray &bufferName,
                                                        QSSGRenderBufferUsageType usageType,
                                                        QSSGByteView data)
+    : QSSGRenderConstantBuffer(context, usageType, data)
+{
+    Q_ASSERT(data.size() < m_maxBlockSize);
+    m_name = bufferName;
+    context->registerConstantBuffer(this);
+}
+
+QSSGRenderConstantBuffer::QSSGRenderConstantBuffer(const QSSGRef<QSSGRenderContext> &context,
+                                                       QSSGRenderBufferUsageType usageType,
+                                                       QSSGByteView data)
     : QSSGRenderDataBuffer(context, QSSGRenderBufferType::Constant, usageType, data)
-    , m_name(bufferName)
     , m_currentOffset(0)
     , m_currentSize(0)
     , m_hwBufferInitialized(false)
@@ -72,11 +81,9 @@ QSSGRenderConstantBuffer::QSSGRenderConstantBuffer(const QSSGRef<QSSGRenderConte
     m_backend->getRenderBackendValue(QSSGRenderBackend::QSSGRenderBackendQuery::MaxConstantBufferBlockSize, &m_maxBlockSize);
 
     if (data.size()) {
-        Q_ASSERT(data.size() < m_maxBlockSize);
         m_shadowCopy.resize(data.size());
         memcpy(m_shadowCopy.begin(), data.begin(), size_t(data.size()));
     }
-    context->registerConstantBuffer(this);
 }
 
 QSSGRenderConstantBuffer::~QSSGRenderConstantBuffer()
@@ -105,6 +112,13 @@ void QSSGRenderConstantBuffer::bindToShaderProgram(const QSSGRef<QSSGRenderShade
     m_backend->programSetConstantBuffer(binding, m_handle);
 }
 
+void QSSGRenderConstantBuffer::bindRange(quint32 binding, quint32 offset, quint32 size)
+{
+    Q_ASSERT(offset + size <= quint32(m_shadowCopy.size()));
+    Q_ASSERT(size <= quint32(m_maxBlockSize));
+    m_backend->programSetConstantBufferRange(binding, m_handle, offset, size);
+}
+
 bool QSSGRenderConstantBuffer::setupBuffer(const QSSGRenderShaderProgram *program, qint32 index, qint32 bufSize, qint32 paramCount)
 {
     bool bSuccess = false;
@@ -258,7 +272,8 @@ void QSSGRenderConstantBuffer::updateRaw(quint32 offset, QSSGByteView data)
         m_shadowCopy.resize(data.size());
     }
 
-    Q_ASSERT((offset + data.size()) < (quint32)m_maxBlockSize);
+    // Buffers without a name can be larger than a block, they are bound in ranges
+    Q_ASSERT(m_name.isEmpty() || (offset + data.size()) < (quint32)m_maxBlockSize);
 
     // we do not initialize anything when this is used
     m_hwBufferInitialized = true;
@@ -103,6 +103,23 @@ public:
                                QSSGRenderBufferUsageType usageType,
                                QSSGByteView data);
 
+    /**
+     * @brief constructor for a buffer owned by its user
+     *
+     * The buffer is not registered with the context, so programs do not pick it up by
+     * name. It has to be bound explicitly with bindToShaderProgram or bindRange. Only
+     * the bound range is limited to the maximum block size.
+     *
+     * @param[in] context		Pointer to context
+     * @param[in] usage			Usage of the buffer (e.g. static, dynamic...)
+     * @param[in] data			Initial content, also defines the size of the buffer
+     *
+     * @return No return.
+     */
+    QSSGRenderConstantBuffer(const QSSGRef<QSSGRenderContext> &context,
+                               QSSGRenderBufferUsageType usageType,
+                               QSSGByteView data);
+
     ///< destructor
     virtual ~QSSGRenderConstantBuffer() override;
 
@@ -124,6 +141,17 @@ public:
      */
     void bindToShaderProgram(const QSSGRef<QSSGRenderShaderProgram> &inShader, quint32 blockIndex, quint32 binding);
 
+    /**
+     * @brief bind a range of the buffer to a binding point
+     *
+     * @param[in] binding		Binding point of constant buffer
+     * @param[in] offset		Start of the range, aligned to ConstantBufferOffsetAlignment
+     * @param[in] size			Size of the range
+     *
+     * @return no return.
+     */
+    void bindRange(quint32 binding, quint32 offset, quint32 size);
+
     /**
      * @brief update the buffer to hardware
      *
@@ -190,6 +218,8 @@ public:
      */
     QByteArray name() const { return m_name; }
 
+    qint32 maxBlockSize() const { return m_maxBlockSize; }
+
 private:
     /**
      * @brief Create a parameter entry
@@ -32,6 +32,7 @@
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 #include <QtQuick3DRender/private/qssgrendershaderprogram_p.h>
 #include <QtQuick3DRender/private/qssgrenderprogrampipeline_p.h>
+#include <QtQuick3DRender/private/qssgrenderbackendcapture_p.h>
 
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
@@ -46,7 +47,7 @@ QSSGRenderContext::QSSGRenderContext(const QSSGRef<QSSGRenderBackend> &inBackend
     , m_nextConstantBufferUnit(1)
 {
     m_maxTextureUnits = m_backend->getMaxCombinedTextureUnits();
-    m_maxConstantBufferUnits = 16; // need backend query
+    m_maxConstantBufferUnits = MaterialConstantBufferUnit; // need backend query
 
     // get initial state
     memset(&m_hardwarePropertyContext, 0, sizeof(m_hardwarePropertyContext));
@@ -121,7 +122,7 @@ QSSGRef<QSSGRenderConstantBuffer> QSSGRenderContext::getConstantBuffer(const QBy
 void QSSGRenderContext::bufferDestroyed(QSSGRenderConstantBuffer *buffer)
 {
     const auto it = m_constantToImpMap.constFind(buffer->name());
-    if (it != m_constantToImpMap.cend()) {
+    if (it != m_constantToImpMap.cend() && it.value() == buffer) {
         Q_ASSERT(it.value()->ref == 1);
         m_constantToImpMap.erase(it);
     }
@@ -247,7 +248,8 @@ QSSGRenderVertFragCompilationResult QSSGRenderContext::compileSource(const char
                                                                              QSSGByteView geometryShaderSource,
                                                                              bool separateProgram,
                                                                              QSSGRenderShaderProgramBinaryType type,
-                                                                             bool binaryProgram)
+                                                                             bool binaryProgram,
+                                                                             bool asyncLink)
 {
     QSSGRenderVertFragCompilationResult result = QSSGRenderShaderProgram::create(this,
                                                                                      shaderName,
@@ -258,7 +260,8 @@ QSSGRenderVertFragCompilationResult QSSGRenderContext::compileSource(const char
                                                                                      geometryShaderSource,
                                                                                      separateProgram,
                                                                                      type,
-                                                                                     binaryProgram);
+                                                                                     binaryProgram,
+                                                                                     asyncLink);
 
     return result;
 }
@@ -497,6 +500,24 @@ void QSSGRenderContext::readPixels(QRect inRect, QSSGRenderReadPixelFormat inFor
                          inWriteBuffer);
 }
 
+void QSSGRenderContext::readPixels(QRect inRect,
+                                   QSSGRenderReadPixelFormat inFormat,
+                                   const QSSGRef<QSSGRenderPixelPackBuffer> &inPackBuffer)
+{
+    const qint32 size = sizeofPixelFormat(inFormat) * inRect.width() * inRect.height();
+    Q_ASSERT(quint32(size) <= inPackBuffer->size());
+    inPackBuffer->bind();
+    // With a pack buffer bound the pixel pointer is an offset into that buffer
+    m_backend->readPixel(nullptr,
+                         inRect.x(),
+                         inRect.y(),
+                         inRect.width(),
+                         inRect.height(),
+                         inFormat,
+                         QSSGByteRef(nullptr, size));
+    inPackBuffer->unbind();
+}
+
 void QSSGRenderContext::setRenderTarget(QSSGRef<QSSGRenderFrameBuffer> inBuffer)
 {
     if (inBuffer != m_hardwarePropertyContext.m_frameBuffer)
@@ -546,6 +567,15 @@ void QSSGRenderContext::popPropertySet(bool inForceSetProperties)
     }
 }
 
+void QSSGRenderContext::resetStateCache()
+{
+    // Framebuffers and program pipelines are not shared, never rebind another context's
+    m_hardwarePropertyContext.m_frameBuffer = nullptr;
+    m_hardwarePropertyContext.m_activeProgramPipeline = nullptr;
+    resetStates();
+    m_backend->resetStateCache();
+}
+
 void QSSGRenderContext::clear(QSSGRenderClearFlags flags)
 {
     if ((flags & QSSGRenderClearValues::Depth) && m_hardwarePropertyContext.m_depthWriteEnabled == false) {
@@ -715,6 +745,7 @@ void QSSGRenderContext::doSetActiveProgramPipeline(const QSSGRef<QSSGRenderProgr
 }
 QSSGRef<QSSGRenderContext> QSSGRenderContext::createNull()
 {
-    return QSSGRef<QSSGRenderContext>(new QSSGRenderContext(QSSGRenderBackendNULL::createBackend()));;
+    const auto backend = QSSGRenderBackendCapture::createFromEnvironment(QSSGRenderBackendNULL::createBackend());
+    return QSSGRef<QSSGRenderContext>(new QSSGRenderContext(backend));
 }
 QT_END_NAMESPACE
@@ -69,6 +69,7 @@
 #include <QtQuick3DRender/private/qssgrenderstoragebuffer_p.h>
 #include <QtQuick3DRender/private/qssgrenderatomiccounterbuffer_p.h>
 #include <QtQuick3DRender/private/qssgrenderdrawindirectbuffer_p.h>
+#include <QtQuick3DRender/private/qssgrenderpixelpackbuffer_p.h>
 #include <QtQuick3DRender/private/qssgrenderpathrender_p.h>
 #include <QtQuick3DRender/private/qssgrenderpathspecification_p.h>
 
@@ -428,6 +429,10 @@ public:
     {
         return renderBackendCap(QSSGRenderBackend::QSSGRenderBackendCaps::TextureLod);
     }
+    bool supportsParallelShaderCompile() const
+    {
+        return renderBackendCap(QSSGRenderBackend::QSSGRenderBackendCaps::ParallelShaderCompile);
+    }
 
     void setDefaultRenderTarget(quint64 targetID)
     {
@@ -446,6 +451,13 @@ public:
 
     qint32 nextConstantBufferUnit();
 
+    // Binding points past the range handed out by nextConstantBufferUnit(). Programs
+    // assign them to their blocks once, the buffers are then bound directly per draw.
+    enum ReservedConstantBufferUnit : quint32 {
+        MaterialConstantBufferUnit = 16,
+        ObjectConstantBufferUnit
+    };
+
     void registerStorageBuffer(QSSGRenderStorageBuffer *buffer);
     QSSGRef<QSSGRenderStorageBuffer> getStorageBuffer(const QByteArray &bufferName);
     void bufferDestroyed(QSSGRenderStorageBuffer *buffer);
@@ -478,7 +490,8 @@ public:
             QSSGByteView geometryShaderSource = QSSGByteView(),
             bool separateProgram = false,
             QSSGRenderShaderProgramBinaryType type = QSSGRenderShaderProgramBinaryType::Unknown,
-            bool binaryProgram = false);
+            bool binaryProgram = false,
+            bool asyncLink = false);
 
     QSSGRenderVertFragCompilationResult compileBinary(const char *shaderName,
             QSSGRenderShaderProgramBinaryType type,
@@ -562,6 +575,8 @@ public:
     void setReadBuffer(QSSGReadFace inReadFace);
 
     void readPixels(QRect inRect, QSSGRenderReadPixelFormat inFormat, QSSGByteRef inWriteBuffer);
+    // Starts an asynchronous read into the pixel pack buffer, the pixels are packed at offset 0
+    void readPixels(QRect inRect, QSSGRenderReadPixelFormat inFormat, const QSSGRef<QSSGRenderPixelPackBuffer> &inPackBuffer);
 
     void setRenderTarget(QSSGRef<QSSGRenderFrameBuffer> inBuffer);
     void setReadTarget(QSSGRef<QSSGRenderFrameBuffer> inBuffer);
@@ -600,12 +615,17 @@ public:
     void drawIndirect(QSSGRenderDrawMode drawMode, quint32 offset);
 
     QSurfaceFormat format() const { return m_backend->format(); }
+    // Tell the backend that all calls of the current frame have been issued
+    void endFrame() { m_backend->endFrame(); }
     void resetStates()
     {
         pushPropertySet();
         popPropertySet(true);
     }
 
+    // Reapply all cached state after another context of the share group used this one.
+    void resetStateCache();
+
     // Used during layer rendering because we can't set the *actual* viewport to what it should
     // be due to hardware problems.
     // Set during begin render.
@@ -58,6 +58,14 @@ void QSSGRenderShaderConstantBuffer::bindToProgram(const QSSGRef<QSSGRenderShade
         m_constBuffer->bindToShaderProgram(inShader, m_location, m_binding);
 }
 
+void QSSGRenderShaderConstantBuffer::setBinding(const QSSGRef<QSSGRenderShaderProgram> &inShader, quint32 binding)
+{
+    if (m_binding == binding)
+        return;
+    inShader->backend()->programSetConstantBlock(inShader->handle(), m_location, binding);
+    m_binding = binding;
+}
+
 void QSSGRenderShaderStorageBuffer::validate(const QSSGRef<QSSGRenderShaderProgram> &)
 {
     // A constant buffer might not be set at first call
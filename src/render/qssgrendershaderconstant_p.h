@@ -289,6 +289,10 @@ public:
     }
 
     void bindToProgram(const QSSGRef<QSSGRenderShaderProgram> &inShader) override;
+
+    // Assigns a fixed binding point to the block, buffers bound to that point are
+    // then used without going through bindToProgram
+    void setBinding(const QSSGRef<QSSGRenderShaderProgram> &inShader, quint32 binding);
 };
 
 class QSSGRenderShaderStorageBuffer : public QSSGRenderShaderBufferBase
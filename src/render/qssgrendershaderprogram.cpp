@@ -542,6 +542,10 @@ QSSGRenderShaderProgram::~QSSGRenderShaderProgram()
 {
     m_context->shaderDestroyed(this);
 
+    // Deleting the program detaches its shaders
+    if (m_linkState == LinkState::Pending)
+        releasePendingStages(false);
+
     if (m_handle)
         m_backend->releaseShaderProgram(m_handle);
 
@@ -1019,6 +1023,50 @@ void writeErrorMessage(const char *tag, const QByteArray &message)
 }
 }
 
+void QSSGRenderShaderProgram::releasePendingStages(bool inDetach)
+{
+    if (inDetach) {
+        if (m_pendingStages.vertex)
+            detach(m_pendingStages.vertex);
+        if (m_pendingStages.fragment)
+            detach(m_pendingStages.fragment);
+        if (m_pendingStages.tessControl)
+            detach(m_pendingStages.tessControl);
+        if (m_pendingStages.tessEvaluation)
+            detach(m_pendingStages.tessEvaluation);
+        if (m_pendingStages.geometry)
+            detach(m_pendingStages.geometry);
+    }
+
+    m_backend->releaseVertexShader(m_pendingStages.vertex);
+    m_backend->releaseFragmentShader(m_pendingStages.fragment);
+    m_backend->releaseTessControlShader(m_pendingStages.tessControl);
+    m_backend->releaseTessEvaluationShader(m_pendingStages.tessEvaluation);
+    m_backend->releaseGeometryShader(m_pendingStages.geometry);
+    m_pendingStages = PendingStages();
+}
+
+QSSGRenderShaderProgram::LinkState QSSGRenderShaderProgram::updateLink(bool inWait)
+{
+    if (m_linkState != LinkState::Pending)
+        return m_linkState;
+
+    if (!inWait && !m_backend->isProgramLinkComplete(m_handle))
+        return m_linkState;
+
+    if (link()) {
+        m_linkState = LinkState::Linked;
+        releasePendingStages(true);
+    } else {
+        qCCritical(INTERNAL_ERROR, "Failed to link program!!");
+        writeErrorMessage("Program link output:", m_errorMessage);
+        m_linkState = LinkState::Failed;
+        releasePendingStages(false);
+    }
+
+    return m_linkState;
+}
+
 QSSGRenderVertFragCompilationResult QSSGRenderShaderProgram::create(const QSSGRef<QSSGRenderContext> &context,
                                                                         const char *programName,
                                                                         QSSGByteView vertShaderSource,
@@ -1028,7 +1076,8 @@ QSSGRenderVertFragCompilationResult QSSGRenderShaderProgram::create(const QSSGRe
                                                                         QSSGByteView geometryShaderSource,
                                                                         bool separateProgram,
                                                                         QSSGRenderShaderProgramBinaryType type,
-                                                                        bool binaryProgram)
+                                                                        bool binaryProgram,
+                                                                        bool asyncLink)
 {
     QSSGRenderVertFragCompilationResult result;
     result.m_shaderName = programName;
@@ -1123,6 +1172,18 @@ QSSGRenderVertFragCompilationResult QSSGRenderShaderProgram::create(const QSSGRe
     if (geShader)
         result.m_shader->attach(geShader);
 
+    // let the driver link in the background, the shaders stay attached until updateLink
+    if (asyncLink) {
+        backend->startLinkProgram(result.m_shader->m_handle);
+        result.m_shader->m_linkState = LinkState::Pending;
+        result.m_shader->m_pendingStages.vertex = vtxShader;
+        result.m_shader->m_pendingStages.fragment = fragShader;
+        result.m_shader->m_pendingStages.tessControl = tcShader;
+        result.m_shader->m_pendingStages.tessEvaluation = teShader;
+        result.m_shader->m_pendingStages.geometry = geShader;
+        return result;
+    }
+
     // link program
     if (!result.m_shader->link()) {
         qCCritical(INTERNAL_ERROR, "Failed to link program!!");
@@ -77,6 +77,13 @@ public:
         Compute
     };
 
+    enum class LinkState
+    {
+        Linked,
+        Pending, ///< created with asyncLink, see updateLink
+        Failed
+    };
+
 private:
     const QSSGRef<QSSGRenderContext> m_context; ///< pointer to context
     const QSSGRef<QSSGRenderBackend> m_backend; ///< pointer to backend
@@ -86,11 +93,23 @@ private:
     TShaderBufferMap m_shaderBuffers; ///< map of shader buffers
     ProgramType m_programType; ///< shader type
     QByteArray m_errorMessage; ///< contains the error message if linking fails
+    LinkState m_linkState = LinkState::Linked;
+
+    // Shaders kept attached while an asynchronous link is pending
+    struct PendingStages
+    {
+        QSSGRenderBackend::QSSGRenderBackendVertexShaderObject vertex = nullptr;
+        QSSGRenderBackend::QSSGRenderBackendFragmentShaderObject fragment = nullptr;
+        QSSGRenderBackend::QSSGRenderBackendTessControlShaderObject tessControl = nullptr;
+        QSSGRenderBackend::QSSGRenderBackendTessEvaluationShaderObject tessEvaluation = nullptr;
+        QSSGRenderBackend::QSSGRenderBackendGeometryShaderObject geometry = nullptr;
+    } m_pendingStages;
 
     template<typename TShaderObject>
     void attach(TShaderObject *pShader);
     template<typename TShaderObject>
     void detach(TShaderObject *pShader);
+    void releasePendingStages(bool inDetach);
 
     QSSGRenderShaderProgram(const QSSGRef<QSSGRenderContext> &context, const char *programName, bool separableProgram);
 public:
@@ -106,6 +125,18 @@ public:
 
     ProgramType programType() const { return m_programType; }
 
+    LinkState linkState() const { return m_linkState; }
+    bool isLinkPending() const { return m_linkState == LinkState::Pending; }
+
+    /**
+     * @brief finish an asynchronous link started by create
+     *
+     * @param[in] inWait	Block until the driver is done instead of polling
+     *
+     * @return the link state. Constants can be queried once it is Linked.
+     */
+    LinkState updateLink(bool inWait = false);
+
     /**
      * @brief Get Error Message
      *
@@ -240,6 +271,8 @@ public:
      * program
      * @param[in] type							Binary program type
      * @param[in] binaryProgram					True if program is binary
+     * @param[in] asyncLink						Only start linking, the program is
+     * returned pending and must be finished with updateLink
      *
      * @return a render result
      */
@@ -253,7 +286,8 @@ public:
             QSSGByteView geometryShaderSource = QSSGByteView(),
             bool separateProgram = false,
             QSSGRenderShaderProgramBinaryType type = QSSGRenderShaderProgramBinaryType::Unknown,
-            bool binaryProgram = false);
+            bool binaryProgram = false,
+            bool asyncLink = false);
 
     /**
      * @brief Create a compute shader program
@@ -66,6 +66,11 @@ void QSSGRenderSync::wait()
         m_backend->waitSync(m_handle, QSSGRenderCommandFlushFlags(), 0);
 }
 
+bool QSSGRenderSync::isSignaled() const
+{
+    return !m_handle || m_backend->isSyncSignaled(m_handle);
+}
+
 QSSGRef<QSSGRenderSync> QSSGRenderSync::create(const QSSGRef<QSSGRenderContext> &context)
 {
     if (!context->supportsCommandSync())
@@ -90,6 +90,14 @@ public:
      */
     void wait();
 
+    /**
+     * @brief Check if the sync has been signaled without blocking.
+     *		  A sync that was never placed counts as signaled.
+     *
+     * @return true if all commands before the sync have completed.
+     */
+    bool isSignaled() const;
+
     /**
      * @brief get the backend object handle
      *
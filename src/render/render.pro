@@ -29,6 +29,9 @@ HEADERS += \
     backends/gl/qssgrenderbackendrenderstatesgl_p.h \
     backends/gl/qssgrenderbackendshaderprogramgl_p.h \
     backends/software/qssgrenderbackendnull_p.h \
+    backends/deferred/qssgrendercommandlist_p.h \
+    backends/deferred/qssgrenderbackenddeferred_p.h \
+    backends/capture/qssgrenderbackendcapture_p.h \
     backends/qssgrenderbackend_p.h \
     glg/qssgglimplobjects_p.h \
     qssgrenderimagetexture_p.h \
@@ -36,6 +39,7 @@ HEADERS += \
     qssgrenderinputassembler_p.h \
     qssgrenderpathrender_p.h \
     qssgrenderpathspecification_p.h \
+    qssgrenderpixelpackbuffer_p.h \
     qssgrenderprogrampipeline_p.h \
     qssgrenderquerybase_p.h \
     qssgrenderrasterizerstate_p.h \
@@ -60,6 +64,9 @@ SOURCES += \
     backends/gl/qssgrenderbackendglbase.cpp \
     backends/gl/qssgrendercontextgl.cpp \
     backends/software/qssgrenderbackendnull.cpp \
+    backends/deferred/qssgrendercommandlist.cpp \
+    backends/deferred/qssgrenderbackenddeferred.cpp \
+    backends/capture/qssgrenderbackendcapture.cpp \
     qssgrenderatomiccounterbuffer.cpp \
     qssgrenderattriblayout.cpp \
     qssgrenderconstantbuffer.cpp \
@@ -74,6 +81,7 @@ SOURCES += \
     qssgrenderocclusionquery.cpp \
     qssgrenderpathrender.cpp \
     qssgrenderpathspecification.cpp \
+    qssgrenderpixelpackbuffer.cpp \
     qssgrenderprogrampipeline.cpp \
     qssgrenderquerybase.cpp \
     qssgrenderrasterizerstate.cpp \
@@ -8,6 +8,7 @@ HEADERS += \
     $$PWD/qssgrenderlayer_p.h \
     $$PWD/qssgrenderlight_p.h \
     $$PWD/qssgrenderlightmaps_p.h \
+    $$PWD/qssgrendermaterialconstantbuffers_p.h \
     $$PWD/qssgrendermaterialdirty_p.h \
     $$PWD/qssgrendermodel_p.h \
     $$PWD/qssgrendernode_p.h \
@@ -23,6 +24,7 @@ SOURCES += \
     $$PWD/qssgrenderlayer.cpp \
     $$PWD/qssgrenderlight.cpp \
     $$PWD/qssgrenderlightmaps.cpp \
+    $$PWD/qssgrendermaterialconstantbuffers.cpp \
     $$PWD/qssgrendermodel.cpp \
     $$PWD/qssgrendernode.cpp \
     $$PWD/qssgrenderpath.cpp \
@@ -44,6 +44,7 @@
 
 #include <QtQuick3DRuntimeRender/private/qssgrenderimage_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderlightmaps_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendermaterialconstantbuffers_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderdynamicobjectsystemcommands_p.h>
 
 #include <QtCore/qurl.h>
@@ -199,7 +200,16 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderCustomMaterial : public QSSGRende
 
     // Dirty
     bool m_dirtyFlagWithInFrame;
+    quint32 m_generation = 0; // Changes whenever the properties values change
+    // Property values as laid out in the cbCustomMaterial block, see
+    // QSSGMaterialSystem::applyConstantBuffer()
+    QSSGMaterialConstantBuffers constantBuffers;
     bool isDirty() const { return flags.testFlag(Flag::Dirty) || m_dirtyFlagWithInFrame || m_alwaysDirty; }
+    void setDirty()
+    {
+        flags.setFlag(Flag::Dirty);
+        ++m_generation;
+    }
     void updateDirtyForFrame()
     {
         m_dirtyFlagWithInFrame = flags.testFlag(Flag::Dirty);
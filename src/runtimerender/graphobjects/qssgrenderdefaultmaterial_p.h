@@ -45,6 +45,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrendergraphobject_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendermaterialdirty_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderlightmaps_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendermaterialconstantbuffers_p.h>
 
 #include <QtGui/QVector3D>
 
@@ -114,6 +115,9 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderDefaultMaterial : QSSGRenderGraph
     // Materials are stored as a linked list on models.
     QSSGRenderGraphObject *nextSibling = nullptr;
     QSSGRenderModel *parent = nullptr;
+    // Material values as laid out in the cbMaterial block, rewritten by the default
+    // material shader generator when dirty.generation() changes
+    mutable QSSGMaterialConstantBuffers constantBuffers;
 
     QSSGRenderDefaultMaterial();
 
@@ -39,6 +39,7 @@ QSSGRenderLayer::QSSGRenderLayer()
     , firstEffect(nullptr)
     , progressiveAAMode(QSSGRenderLayer::AAMode::NoAA)
     , multisampleAAMode(QSSGRenderLayer::AAMode::NoAA)
+    , postAAMode(QSSGRenderLayer::PostAAMode::NoAA)
     , background(QSSGRenderLayer::Background::Transparent)
     , blendType(QSSGRenderLayer::BlendMode::Normal)
     , horizontalFieldValues(QSSGRenderLayer::HorizontalField::LeftWidth)
@@ -61,6 +62,7 @@ QSSGRenderLayer::QSSGRenderLayer()
     , aoBias(0)
     , aoSamplerate(2)
     , aoDither(false)
+    , aoResolution(QSSGRenderLayer::AOResolution::Half)
     , shadowStrength(0)
     , shadowDist(10)
     , shadowSoftness(100.0f)
@@ -66,6 +66,22 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderLayer : public QSSGRenderNode
         X8 = 8
     };
 
+    // Antialiasing filters applied to the rendered layer texture
+    enum class PostAAMode : quint8
+    {
+        NoAA = 0,
+        FXAA,
+        SMAA
+    };
+
+    // Resolution of the ambient occlusion, as a divisor of the layer size
+    enum class AOResolution : quint8
+    {
+        Full = 1,
+        Half = 2,
+        Quarter = 4
+    };
+
     enum class HorizontalField : quint8
     {
         LeftWidth = 0,
@@ -120,6 +136,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderLayer : public QSSGRenderNode
 
     QSSGRenderLayer::AAMode progressiveAAMode;
     QSSGRenderLayer::AAMode multisampleAAMode;
+    QSSGRenderLayer::PostAAMode postAAMode;
     QSSGRenderLayer::Background background;
     QVector3D clearColor;
 
@@ -149,6 +166,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderLayer : public QSSGRenderNode
     float aoBias;
     qint32 aoSamplerate;
     bool aoDither;
+    QSSGRenderLayer::AOResolution aoResolution;
 
     // Direct occlusion
     float shadowStrength;
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_MATERIAL_CONSTANT_BUFFERS_H
+#define QSSG_RENDER_MATERIAL_CONSTANT_BUFFERS_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+
+#include <QtQuick3DRender/private/qssgrenderconstantbuffer_p.h>
+
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSSGRenderContext;
+
+/**
+ *	The constant buffers holding the values of one material, one per render context and
+ *	block size. The size of a material block can depend on the program (the default
+ *	material block has an entry per image), and a material can be drawn by windows that do
+ *	not share GL objects, so a single buffer would be recreated over and over.
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGMaterialConstantBuffers
+{
+public:
+    // Returns the buffer of inContext for blocks of inBlockSize bytes, creating it on first
+    // use. outNeedsUpload is set when the buffer does not hold the values of inGeneration
+    // yet, the caller then writes and uploads them.
+    QSSGRenderConstantBuffer *buffer(const QSSGRef<QSSGRenderContext> &inContext,
+                                     quint32 inBlockSize,
+                                     quint32 inGeneration,
+                                     bool *outNeedsUpload);
+
+private:
+    struct Entry
+    {
+        const QSSGRenderContext *context;
+        quint32 blockSize;
+        quint32 generation;
+        QSSGRef<QSSGRenderConstantBuffer> buffer; // Keeps the context alive
+    };
+
+    QVector<Entry> m_entries;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSG_RENDER_MATERIAL_CONSTANT_BUFFERS_H
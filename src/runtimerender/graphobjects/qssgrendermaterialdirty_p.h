@@ -51,11 +51,16 @@ class QSSGMaterialDirty
 private:
     bool m_dirty;
     bool m_dirtyFlagWithInFrame;
+    quint32 m_generation = 0;
 
 public:
     QSSGMaterialDirty() : m_dirty(true), m_dirtyFlagWithInFrame(m_dirty) {}
 
-    void setDirty() { m_dirty = m_dirtyFlagWithInFrame = true; }
+    void setDirty()
+    {
+        m_dirty = m_dirtyFlagWithInFrame = true;
+        ++m_generation;
+    }
     bool isDirty() const { return m_dirty || m_dirtyFlagWithInFrame; }
     void clearDirty() { m_dirtyFlagWithInFrame = m_dirty = false; }
     void updateDirtyForFrame()
@@ -63,6 +68,10 @@ public:
         m_dirtyFlagWithInFrame = m_dirty;
         m_dirty = false;
     }
+
+    // Changes whenever the values that go into the material's constant buffer change.
+    quint32 generation() const { return m_generation; }
+    void updateGeneration() { ++m_generation; }
 };
 
 QT_END_NAMESPACE
@@ -223,6 +223,7 @@ void QSSGRenderNode::addChild(QSSGRenderNode &inChild)
             inChild.parent->removeChild(inChild);
         inChild.parent = this;
     }
+    markStructureChanged();
     if (firstChild == nullptr) {
         firstChild = &inChild;
         inChild.nextSibling = nullptr;
@@ -261,6 +262,7 @@ void QSSGRenderNode::removeChild(QSSGRenderNode &inChild)
                 firstChild = child->nextSibling;
             child->nextSibling = nullptr;
             child->previousSibling = nullptr;
+            markStructureChanged();
             return;
         }
     }
@@ -280,6 +282,7 @@ void QSSGRenderNode::removeFromGraph()
 {
     if (parent)
         parent->removeChild(*this);
+    markStructureChanged();
 
     nextSibling = nullptr;
 
@@ -293,6 +296,12 @@ void QSSGRenderNode::removeFromGraph()
     }
 }
 
+void QSSGRenderNode::markStructureChanged()
+{
+    for (QSSGRenderNode *node = this; node; node = node->parent)
+        ++node->subtreeVersion;
+}
+
 QSSGBounds3 QSSGRenderNode::getBounds(const QSSGRef<QSSGBufferManager> &inManager,
                                          const QSSGRef<QSSGPathManagerInterface> &inPathManager,
                                          bool inIncludeChildren,
@@ -130,6 +130,9 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNode : public QSSGRenderGraphObje
     // Property maintained solely by the render system.
     // Depth-first-search index assigned and maintained by render system.
     quint32 dfsIndex = 0;
+    // Bumped on the node and all of its ancestors whenever a child is added to or removed
+    // from the subtree, so flattened copies of the graph know when they need to be rebuilt.
+    quint32 subtreeVersion = 0;
 
     QSSGRenderNode();
     QSSGRenderNode(Type type);
@@ -150,6 +153,9 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNode : public QSSGRenderGraphObje
     // finally they are no longer siblings of each other.
     void removeFromGraph();
 
+    // Bumps subtreeVersion of this node and its ancestors
+    void markStructureChanged();
+
     // Calculate global transform and opacity
     // Walks up the graph ensure all parents are not dirty so they have
     // valid global transforms.
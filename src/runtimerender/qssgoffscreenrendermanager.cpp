@@ -40,6 +40,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderresourcebufferobjects_p.h>
 #include "qssgrendererutil_p.h"
 #include <QtQuick3DRender/private/qssgrendertexture2d_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderasyncreadback_p.h>
 
 #include <limits>
 
@@ -56,6 +57,7 @@ uint qHash(const QSSGOffscreenRendererKey &key)
 struct QSSGRendererData : QSSGOffscreenRenderResult
 {
     QSSGRef<QSSGResourceManager> resourceManager;
+    QSSGRef<QSSGAsyncReadback> readback;
     quint32 frameCount = std::numeric_limits<quint32>::max();
     bool rendering = false;
 
@@ -158,6 +160,15 @@ QSSGRef<QSSGOffscreenRendererInterface> QSSGOffscreenRenderManager::getOffscreen
 
 void QSSGOffscreenRenderManager::releaseOffscreenRenderer(const QSSGOffscreenRendererKey &inKey) { m_renderers.remove(inKey); }
 
+bool QSSGOffscreenRenderManager::setReadback(const QSSGOffscreenRendererKey &inKey, const QSSGRef<QSSGAsyncReadback> &inReadback)
+{
+    TRendererMap::iterator theIter = m_renderers.find(inKey);
+    if (theIter == m_renderers.end())
+        return false;
+    theIter.value().readback = inReadback;
+    return true;
+}
+
 void QSSGOffscreenRenderManager::renderItem(QSSGRendererData &theData, QSSGOffscreenRendererEnvironment theDesiredEnvironment)
 {
     auto theContext = m_resourceManager->getRenderContext();
@@ -332,6 +343,10 @@ void QSSGOffscreenRenderManager::renderItem(QSSGRendererData &theData, QSSGOffsc
     theFrameBuffer->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer(), fboAttachmentType);
     if (theAttachmentLocation != QSSGRenderFrameBufferAttachment::Unknown)
         theFrameBuffer->attach(theAttachmentLocation, QSSGRenderTextureOrRenderBuffer(), fboAttachmentType);
+
+    // Queue the resolved result for readback, it is picked up in a later beginFrame()
+    if (theData.readback)
+        theData.readback->readTexture(theData.texture, m_frameCount);
 }
 
 QSSGOffscreenRenderResult QSSGOffscreenRenderManager::getRenderedItem(const QSSGOffscreenRendererKey &inKey)
@@ -417,6 +432,11 @@ QSSGOffscreenRenderResult QSSGOffscreenRenderManager::getRenderedItem(const QSSG
 
 void QSSGOffscreenRenderManager::beginFrame()
 { /* TODO: m_PerFrameAllocator.reset();*/
+    // Deliver the reads of earlier frames whose fences have signaled by now
+    for (auto it = m_renderers.begin(), end = m_renderers.end(); it != end; ++it) {
+        if (it.value().readback)
+            it.value().readback->poll();
+    }
 }
 
 void QSSGOffscreenRenderManager::endFrame() { ++m_frameCount; }
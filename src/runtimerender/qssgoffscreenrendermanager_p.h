@@ -53,6 +53,7 @@ struct QSSGRenderPickResult;
 class QSSGGraphObjectPickQueryInterface;
 class QSSGRenderContextInterface;
 class QSSGRenderContext;
+class QSSGAsyncReadback;
 
 enum class QSSGOffscreenRendererDepthValues
 {
@@ -205,6 +206,9 @@ public:
     bool hasOffscreenRenderer(const QSSGOffscreenRendererKey &inKey);
     QSSGRef<QSSGOffscreenRendererInterface> getOffscreenRenderer(const QSSGOffscreenRendererKey &inKey);
     void releaseOffscreenRenderer(const QSSGOffscreenRendererKey &inKey);
+    // Every frame rendered for this key is read back through inReadback, pass null to stop.
+    // Returns false if no renderer is registered under the key.
+    bool setReadback(const QSSGOffscreenRendererKey &inKey, const QSSGRef<QSSGAsyncReadback> &inReadback);
 
     // This doesn't trigger rendering right away.  A node is added to the render graph that
     // points to this item.
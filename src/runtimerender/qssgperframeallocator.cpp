@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qssgperframeallocator_p.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+
+QT_BEGIN_NAMESPACE
+
+// The chunk header takes the first MaxAlignment bytes so the data is aligned for any
+// supported alignment.
+struct QSSGPerFrameAllocator::Chunk
+{
+    Chunk *next;
+    size_t size;
+
+    quint8 *data() { return reinterpret_cast<quint8 *>(this) + MaxAlignment; }
+
+    static Chunk *create(size_t inSize)
+    {
+        Q_STATIC_ASSERT(sizeof(Chunk) <= MaxAlignment);
+        Chunk *chunk = static_cast<Chunk *>(qMallocAligned(MaxAlignment + inSize, MaxAlignment));
+        Q_CHECK_PTR(chunk);
+        chunk->next = nullptr;
+        chunk->size = inSize;
+        return chunk;
+    }
+};
+
+struct QSSGPerFrameAllocator::Arena
+{
+    enum { MaxIdleFrames = 8 };
+
+    Qt::HANDLE threadId = nullptr;
+    Chunk *first = nullptr;
+    Chunk *current = nullptr;
+    quint8 *cursor = nullptr;
+    quint8 *limit = nullptr;
+    // Bytes used in the chunks before current
+    size_t usedBefore = 0;
+    size_t nextChunkSize = MinChunkSize;
+    // Resets since the arena was last allocated from
+    qint32 idleFrames = 0;
+
+    ~Arena() { freeChunks(); }
+
+    void freeChunks()
+    {
+        while (first) {
+            Chunk *next = first->next;
+            qFreeAligned(first);
+            first = next;
+        }
+        current = nullptr;
+    }
+
+    size_t bytesUsed() const { return current ? usedBefore + size_t(cursor - current->data()) : 0; }
+
+    void *allocate(size_t inSize, size_t inAlignment)
+    {
+        quintptr address = (quintptr(cursor) + inAlignment - 1) & ~quintptr(inAlignment - 1);
+        if (!cursor || address + inSize > quintptr(limit))
+            address = quintptr(nextChunk(inSize + inAlignment - 1));
+        address = (address + inAlignment - 1) & ~quintptr(inAlignment - 1);
+        cursor = reinterpret_cast<quint8 *>(address + inSize);
+        return reinterpret_cast<void *>(address);
+    }
+
+    // Moves on to the next chunk with room for inSize bytes, reusing the chunks of
+    // earlier frames before allocating a new one
+    quint8 *nextChunk(size_t inSize)
+    {
+        if (current)
+            usedBefore += size_t(cursor - current->data());
+        Chunk *chunk = current ? current->next : first;
+        while (chunk && chunk->size < inSize)
+            chunk = chunk->next;
+        if (!chunk) {
+            chunk = Chunk::create(qMax(nextChunkSize, inSize));
+            nextChunkSize = qMin(nextChunkSize * 2, size_t(MaxChunkSize));
+            if (current) {
+                chunk->next = current->next;
+                current->next = chunk;
+            } else {
+                chunk->next = first;
+                first = chunk;
+            }
+        }
+        // Chunks that were skipped stay unused until the next reset
+        for (Chunk *skipped = current ? current->next : first; skipped != chunk; skipped = skipped->next)
+            usedBefore += skipped->size;
+        current = chunk;
+        cursor = chunk->data();
+        limit = cursor + chunk->size;
+        return cursor;
+    }
+
+    void reset()
+    {
+        const size_t used = bytesUsed();
+        if (used == 0) {
+            // Most likely the thread is gone, give the memory back
+            if (++idleFrames >= MaxIdleFrames) {
+                freeChunks();
+                nextChunkSize = MinChunkSize;
+            }
+        } else if (current != first) {
+            // The frame did not fit into the first chunk, use a single chunk for all of it
+            size_t size = MinChunkSize;
+            while (size < used)
+                size *= 2;
+            freeChunks();
+            first = Chunk::create(size);
+            nextChunkSize = qMax(nextChunkSize, qMin(size * 2, size_t(MaxChunkSize)));
+        }
+        if (used)
+            idleFrames = 0;
+        current = first;
+        usedBefore = 0;
+        cursor = first ? first->data() : nullptr;
+        limit = first ? cursor + first->size : nullptr;
+    }
+};
+
+namespace {
+
+QAtomicInteger<quint64> s_nextAllocatorId { 1 };
+
+// The arenas used last by this thread, keyed by allocator id. Ids are never
+// reused, so entries of destroyed allocators can not match.
+struct ArenaCache
+{
+    quint64 allocatorId[4] = {};
+    void *arena[4] = {};
+    quint32 next = 0;
+};
+
+thread_local ArenaCache t_arenaCache;
+
+}
+
+QSSGPerFrameAllocator::QSSGPerFrameAllocator()
+    : m_id(s_nextAllocatorId.fetchAndAddRelaxed(1))
+{
+}
+
+QSSGPerFrameAllocator::~QSSGPerFrameAllocator()
+{
+    qDeleteAll(m_arenas);
+}
+
+QSSGPerFrameAllocator::Arena *QSSGPerFrameAllocator::currentArena()
+{
+    ArenaCache &cache = t_arenaCache;
+    for (int idx = 0; idx < 4; ++idx) {
+        if (cache.allocatorId[idx] == m_id)
+            return static_cast<Arena *>(cache.arena[idx]);
+    }
+
+    Arena *arena = registerThread();
+    const quint32 slot = cache.next++ % 4;
+    cache.allocatorId[slot] = m_id;
+    cache.arena[slot] = arena;
+    return arena;
+}
+
+// Slow path, taken once per thread (and again only when a thread alternates
+// between more allocators than the cache holds)
+QSSGPerFrameAllocator::Arena *QSSGPerFrameAllocator::registerThread()
+{
+    const Qt::HANDLE threadId = QThread::currentThreadId();
+    QMutexLocker locker(&m_arenasMutex);
+    for (Arena *arena : qAsConst(m_arenas)) {
+        if (arena->threadId == threadId)
+            return arena;
+    }
+    Arena *arena = new Arena;
+    arena->threadId = threadId;
+    m_arenas.append(arena);
+    return arena;
+}
+
+void *QSSGPerFrameAllocator::allocate(size_t inSize, size_t inAlignment)
+{
+    Q_ASSERT(inAlignment && inAlignment <= MaxAlignment && !(inAlignment & (inAlignment - 1)));
+    return currentArena()->allocate(inSize, inAlignment);
+}
+
+void QSSGPerFrameAllocator::reset()
+{
+    QMutexLocker locker(&m_arenasMutex);
+    size_t bytesUsed = 0;
+    for (Arena *arena : qAsConst(m_arenas)) {
+        bytesUsed += arena->bytesUsed();
+        arena->reset();
+    }
+    m_highWaterMark = qMax(m_highWaterMark, bytesUsed);
+}
+
+QSSGPerFrameAllocator::Statistics QSSGPerFrameAllocator::statistics() const
+{
+    QMutexLocker locker(&m_arenasMutex);
+    Statistics stats;
+    for (const Arena *arena : m_arenas) {
+        stats.bytesUsed += arena->bytesUsed();
+        for (const Chunk *chunk = arena->first; chunk; chunk = chunk->next) {
+            stats.bytesReserved += chunk->size;
+            ++stats.chunkCount;
+        }
+    }
+    stats.highWaterMark = qMax(m_highWaterMark, stats.bytesUsed);
+    stats.arenaCount = m_arenas.size();
+    return stats;
+}
+
+QT_END_NAMESPACE
@@ -28,7 +28,6 @@
 **
 ****************************************************************************/
 
-
 #ifndef QSSGPERFRAMEALLOCATOR_H
 #define QSSGPERFRAMEALLOCATOR_H
 
@@ -45,123 +44,176 @@
 
 #include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
 
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include <new>
+#include <type_traits>
+
 QT_BEGIN_NAMESPACE
 
-class QSSGPerFrameAllocator
+/**
+ *	Linear allocator for memory that lives until the end of the frame.
+ *
+ *	Every thread that allocates gets an arena of its own, so the render preparation can
+ *	allocate from worker threads without locking. An arena bumps a pointer through a list
+ *	of chunks that grow geometrically. reset() keeps the chunks for the next frame; an
+ *	arena that needed more than one chunk is replaced by a single chunk of the size it
+ *	used, so it stays a single linear block in the steady state.
+ *
+ *	Nothing allocated here is destructed, only trivially destructible types may be
+ *	placed in it.
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGPerFrameAllocator
 {
-    struct FastAllocator
+public:
+    enum : size_t {
+        DefaultAlignment = 16,
+        MaxAlignment = 64,
+        MinChunkSize = 16 * 1024,
+        // Chunks stop doubling at this size
+        MaxChunkSize = 4 * 1024 * 1024
+    };
+
+    struct Statistics
     {
-        struct Slab;
-
-        enum : size_t {
-            ChunkSize = 8192*2,
-            Alignment = 4,
-            SlabSize = ChunkSize - sizeof(Slab *),
-            MaxAlloc = ChunkSize/2 // don't go all the way up to SlabSize, or we'd almost always get a big hole
-        };
-        struct Slab {
-            Slab() = default;
-            Slab(Slab *previous)
-            {
-                previous->next = this;
-            }
-            Slab *next = nullptr;
-            quint8 data[SlabSize];
-        };
-        Q_STATIC_ASSERT(sizeof(Slab) == ChunkSize);
-
-        Slab *first = nullptr;
-        Slab *current = nullptr;
-        size_t offset = 0;
-
-        FastAllocator()
-        {
-            first = current = new Slab;
-        }
+        size_t bytesUsed = 0; // Allocated since the last reset, including alignment padding
+        size_t highWaterMark = 0; // Largest bytesUsed of any frame so far
+        size_t bytesReserved = 0; // Chunk memory held by all arenas
+        qint32 chunkCount = 0;
+        qint32 arenaCount = 0;
+    };
 
-        ~FastAllocator()
-        {
-            Slab *s = first;
-            while (s) {
-                Slab *n = s->next;
-                delete s;
-                s = n;
-            }
-        }
-        void *allocate(size_t size)
-        {
-            size = (size + Alignment - 1) & ~(Alignment - 1);
-            Q_ASSERT(size <= SlabSize);
-            Q_ASSERT(!(offset % Alignment));
-
-            size_t amountLeftInSlab = SlabSize - offset;
-            if (size > amountLeftInSlab) {
-                if (current->next)
-                    current = current->next;
-                else
-                    current = new Slab(current);
-                offset = 0;
-            }
-
-            quint8 *data = current->data + offset;
-            offset += size;
-            return data;
-        }
+    QSSGPerFrameAllocator();
+    ~QSSGPerFrameAllocator();
 
-        // only reset, so we can re-use the memory
-        void reset() { current = first; offset = 0; }
-    };
+    // inAlignment must be a power of two up to MaxAlignment
+    void *allocate(size_t inSize, size_t inAlignment = DefaultAlignment);
 
-    struct LargeAllocator
+    // Storage for inCount value-initialized elements of T
+    template<typename T>
+    T *allocateArray(qint32 inCount)
     {
-        struct Slab {
-            Slab *next = nullptr;
-        };
-        Slab *current = nullptr;
-
-        LargeAllocator() {}
-
-        // Automatically deallocates everything that hasn't already been deallocated.
-        ~LargeAllocator() { deallocateAll(); }
-
-        void deallocateAll()
-        {
-            while (current) {
-                Slab *n = current->next;
-                ::free(current);
-                current = n;
-            }
-            current = nullptr;
-        }
+        Q_STATIC_ASSERT_X(std::is_trivially_destructible<T>::value, "Per frame memory is released without running destructors");
+        Q_STATIC_ASSERT(alignof(T) <= MaxAlignment);
+        if (inCount <= 0)
+            return nullptr;
+        T *data = static_cast<T *>(allocate(sizeof(T) * size_t(inCount), alignof(T)));
+        for (qint32 idx = 0; idx < inCount; ++idx)
+            new (data + idx) T();
+        return data;
+    }
 
-        void *allocate(size_t size)
-        {
-            quint8 *mem = reinterpret_cast<quint8 *>(::malloc(sizeof(Slab) + size));
-            Slab *s = reinterpret_cast<Slab *>(mem);
-            s->next = current;
-            return mem + sizeof(Slab);
-        }
-    };
+    // Invalidates everything allocated since the last reset. Must not race with allocations
+    // from other threads, it is called at the beginning of the frame.
+    void reset();
+
+    // Only meaningful while no other thread allocates
+    Statistics statistics() const;
+
+private:
+    Q_DISABLE_COPY(QSSGPerFrameAllocator)
+
+    struct Chunk;
+    struct Arena;
+
+    Arena *currentArena();
+    Arena *registerThread();
 
-    FastAllocator m_fastAllocator;
-    LargeAllocator m_largeAllocator;
+    const quint64 m_id;
+    QVector<Arena *> m_arenas;
+    mutable QMutex m_arenasMutex;
+    size_t m_highWaterMark = 0;
+};
+
+/**
+ *	Growable array in per frame memory for scratch lists that are filled and consumed within
+ *	one frame. Growing leaves the old storage behind until the allocator is reset and the
+ *	contents are only valid until then, so lists that can be read after the frame (for
+ *	picking, or by a View3D that does not render the next frame) belong in a QVector.
+ *	Copies are deep.
+ */
+template<typename T>
+class QSSGFrameVector
+{
+    Q_STATIC_ASSERT_X(std::is_trivially_destructible<T>::value, "Per frame memory is released without running destructors");
 
 public:
-    QSSGPerFrameAllocator() {}
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    explicit QSSGFrameVector(QSSGPerFrameAllocator *inAllocator = nullptr) : m_allocator(inAllocator) {}
+    QSSGFrameVector(const QSSGFrameVector &inOther) : m_allocator(inOther.m_allocator) { append(inOther); }
+    QSSGFrameVector &operator=(const QSSGFrameVector &inOther)
+    {
+        if (this != &inOther) {
+            clear();
+            m_allocator = inOther.m_allocator;
+            append(inOther);
+        }
+        return *this;
+    }
+
+    qint32 size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool empty() const { return m_size == 0; }
+
+    T &operator[](qint32 inIndex) { Q_ASSERT(inIndex >= 0 && inIndex < m_size); return m_data[inIndex]; }
+    const T &operator[](qint32 inIndex) const { Q_ASSERT(inIndex >= 0 && inIndex < m_size); return m_data[inIndex]; }
+    const T &at(qint32 inIndex) const { return operator[](inIndex); }
+    T &back() { return operator[](m_size - 1); }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
 
-    inline void *allocate(size_t size)
+    void reserve(qint32 inCapacity)
     {
-        if (size < FastAllocator::MaxAlloc)
-            return m_fastAllocator.allocate(size);
-        else
-            return m_largeAllocator.allocate(size);
+        if (inCapacity > m_capacity)
+            grow(inCapacity);
     }
 
-    void reset()
+    void push_back(const T &inValue)
     {
-        m_fastAllocator.reset();
-        m_largeAllocator.deallocateAll();
+        if (m_size == m_capacity)
+            grow(qMax(qint32(16), m_capacity * 2));
+        // The old storage stays valid when growing, so inValue may point into it
+        new (m_data + m_size) T(inValue);
+        ++m_size;
     }
+    void append(const T &inValue) { push_back(inValue); }
+    void append(const QSSGFrameVector &inOther)
+    {
+        reserve(m_size + inOther.m_size);
+        for (qint32 idx = 0, end = inOther.m_size; idx < end; ++idx)
+            new (m_data + m_size + idx) T(inOther.m_data[idx]);
+        m_size += inOther.m_size;
+    }
+
+    // The storage belongs to the allocator, dropping it is all that is needed
+    void clear()
+    {
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+private:
+    void grow(qint32 inCapacity)
+    {
+        Q_ASSERT(m_allocator);
+        T *data = static_cast<T *>(m_allocator->allocate(sizeof(T) * size_t(inCapacity), alignof(T)));
+        for (qint32 idx = 0; idx < m_size; ++idx)
+            new (data + idx) T(m_data[idx]);
+        m_data = data;
+        m_capacity = inCapacity;
+    }
+
+    QSSGPerFrameAllocator *m_allocator;
+    T *m_data = nullptr;
+    qint32 m_size = 0;
+    qint32 m_capacity = 0;
 };
 
 QT_END_NAMESPACE
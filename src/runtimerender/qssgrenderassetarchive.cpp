@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qssgrenderassetarchive_p.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QtEndian>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct Header
+{
+    quint32 magic;
+    quint32 version;
+    quint32 entryCount;
+    quint32 slotCount;
+    quint64 slotsOffset;
+    quint64 namesOffset;
+};
+
+const qint64 dataAlignment = 16;
+
+qint64 alignedOffset(qint64 inOffset)
+{
+    return (inOffset + dataAlignment - 1) & ~(dataAlignment - 1);
+}
+
+bool writePadding(QFile &inFile)
+{
+    const qint64 padding = alignedOffset(inFile.pos()) - inFile.pos();
+    static const char zeros[dataAlignment] = {};
+    return padding == 0 || inFile.write(zeros, padding) == padding;
+}
+
+}
+
+struct QSSGAssetArchive::Slot
+{
+    quint64 dataOffset;
+    quint64 dataSize;
+    quint32 nameOffset;
+    quint32 nameSize;
+    quint32 nameHash;
+    quint32 reserved;
+};
+
+QSSGAssetArchive::QSSGAssetArchive(const QString &inFileName) : m_file(inFileName) {}
+
+QSSGAssetArchive::~QSSGAssetArchive() = default;
+
+bool QSSGAssetArchive::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(Header))) {
+        m_errorString = QStringLiteral("Not an asset archive");
+        return false;
+    }
+    const uchar *data = m_file.map(0, m_size);
+    if (!data) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    const quint32 slotCount = qFromLittleEndian(header.slotCount);
+    const quint64 slotsOffset = qFromLittleEndian(header.slotsOffset);
+    const quint64 namesOffset = qFromLittleEndian(header.namesOffset);
+    if (qFromLittleEndian(header.magic) != Magic) {
+        m_errorString = QStringLiteral("Not an asset archive");
+    } else if (qFromLittleEndian(header.version) != Version) {
+        m_errorString = QStringLiteral("Unsupported asset archive version %1").arg(qFromLittleEndian(header.version));
+    } else if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || slotsOffset % dataAlignment != 0
+               || slotsOffset + quint64(slotCount) * sizeof(Slot) > quint64(m_size) || namesOffset > quint64(m_size)) {
+        m_errorString = QStringLiteral("Corrupt asset archive index");
+    }
+    if (!m_errorString.isEmpty()) {
+        m_file.unmap(const_cast<uchar *>(data));
+        return false;
+    }
+
+    // Validate every slot once so that lookups need no bounds checks
+    const Slot *slotTable = reinterpret_cast<const Slot *>(data + slotsOffset);
+    quint32 entryCount = 0;
+    for (quint32 i = 0; i < slotCount; ++i) {
+        const Slot &slot = slotTable[i];
+        const quint32 nameSize = qFromLittleEndian(slot.nameSize);
+        if (nameSize == 0)
+            continue;
+        const quint64 dataOffset = qFromLittleEndian(slot.dataOffset);
+        const quint64 dataSize = qFromLittleEndian(slot.dataSize);
+        const quint64 nameOffset = namesOffset + qFromLittleEndian(slot.nameOffset);
+        if (dataOffset + dataSize > quint64(m_size) || dataSize > quint64(std::numeric_limits<int>::max())
+                || nameOffset + nameSize > quint64(m_size)) {
+            m_errorString = QStringLiteral("Corrupt asset archive entry");
+            m_file.unmap(const_cast<uchar *>(data));
+            return false;
+        }
+        ++entryCount;
+    }
+    if (entryCount != qFromLittleEndian(header.entryCount) || entryCount == slotCount) {
+        m_errorString = QStringLiteral("Corrupt asset archive index");
+        m_file.unmap(const_cast<uchar *>(data));
+        return false;
+    }
+
+    m_data = data;
+    m_slots = slotTable;
+    m_slotMask = slotCount - 1;
+    m_entryCount = entryCount;
+    m_namesOffset = namesOffset;
+    return true;
+}
+
+QStringList QSSGAssetArchive::entryNames() const
+{
+    QStringList names;
+    if (!m_data)
+        return names;
+    names.reserve(int(m_entryCount));
+    for (quint32 i = 0; i <= m_slotMask; ++i) {
+        const Slot &slot = m_slots[i];
+        const quint32 nameSize = qFromLittleEndian(slot.nameSize);
+        if (nameSize) {
+            const char *name = reinterpret_cast<const char *>(m_data + m_namesOffset + qFromLittleEndian(slot.nameOffset));
+            names.append(QString::fromUtf8(name, int(nameSize)));
+        }
+    }
+    return names;
+}
+
+QByteArray QSSGAssetArchive::entry(const QString &inName) const
+{
+    return entry(inName.toUtf8());
+}
+
+QByteArray QSSGAssetArchive::entry(const QByteArray &inUtf8Name) const
+{
+    if (!m_data || inUtf8Name.isEmpty())
+        return QByteArray();
+
+    const quint32 hash = hashName(inUtf8Name.constData(), inUtf8Name.size());
+    // The table always has an empty slot, so the probe terminates
+    for (quint32 i = hash & m_slotMask;; i = (i + 1) & m_slotMask) {
+        const Slot &slot = m_slots[i];
+        const quint32 nameSize = qFromLittleEndian(slot.nameSize);
+        if (nameSize == 0)
+            return QByteArray();
+        if (qFromLittleEndian(slot.nameHash) != hash || nameSize != quint32(inUtf8Name.size()))
+            continue;
+        const uchar *name = m_data + m_namesOffset + qFromLittleEndian(slot.nameOffset);
+        if (memcmp(name, inUtf8Name.constData(), nameSize) != 0)
+            continue;
+        const char *entryData = reinterpret_cast<const char *>(m_data + qFromLittleEndian(slot.dataOffset));
+        const int entrySize = int(qFromLittleEndian(slot.dataSize));
+        // fromRawData() of an empty range gives an empty array, keep it non-null
+        return entrySize ? QByteArray::fromRawData(entryData, entrySize) : QByteArray("");
+    }
+}
+
+quint32 QSSGAssetArchive::hashName(const char *inName, int inSize)
+{
+    // FNV-1a, stable across platforms and Qt versions unlike qHash()
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < inSize; ++i) {
+        hash ^= quint8(inName[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool QSSGAssetArchive::write(const QString &inFileName, const QVector<QPair<QString, QString>> &inFiles, QString *outError)
+{
+    const auto fail = [outError](const QString &inError) {
+        if (outError)
+            *outError = inError;
+        return false;
+    };
+
+    QFile file(inFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return fail(file.errorString());
+
+    quint32 slotCount = 16;
+    while (slotCount < quint32(inFiles.size()) * 2)
+        slotCount *= 2;
+    QVector<Slot> slotTable(int(slotCount));
+    memset(slotTable.data(), 0, slotTable.size() * sizeof(Slot));
+    QByteArray names;
+    QSet<QByteArray> seen;
+
+    Header header = {};
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header))
+        return fail(file.errorString());
+
+    for (const auto &inputFile : inFiles) {
+        const QByteArray name = inputFile.first.toUtf8();
+        if (name.isEmpty())
+            return fail(QStringLiteral("Empty entry name for %1").arg(inputFile.second));
+        if (seen.contains(name))
+            return fail(QStringLiteral("Duplicate entry %1").arg(inputFile.first));
+        seen.insert(name);
+
+        QFile input(inputFile.second);
+        if (!input.open(QIODevice::ReadOnly))
+            return fail(QStringLiteral("Cannot read %1: %2").arg(inputFile.second, input.errorString()));
+        const QByteArray contents = input.readAll();
+        if (!writePadding(file))
+            return fail(file.errorString());
+        const qint64 dataOffset = file.pos();
+        if (file.write(contents) != contents.size())
+            return fail(file.errorString());
+
+        const quint32 hash = hashName(name.constData(), name.size());
+        quint32 i = hash & (slotCount - 1);
+        while (slotTable.at(int(i)).nameSize)
+            i = (i + 1) & (slotCount - 1);
+        Slot &slot = slotTable[int(i)];
+        slot.dataOffset = qToLittleEndian(quint64(dataOffset));
+        slot.dataSize = qToLittleEndian(quint64(contents.size()));
+        slot.nameOffset = qToLittleEndian(quint32(names.size()));
+        slot.nameSize = qToLittleEndian(quint32(name.size()));
+        slot.nameHash = qToLittleEndian(hash);
+        names.append(name);
+    }
+
+    if (!writePadding(file))
+        return fail(file.errorString());
+    header.magic = qToLittleEndian(quint32(Magic));
+    header.version = qToLittleEndian(quint32(Version));
+    header.entryCount = qToLittleEndian(quint32(inFiles.size()));
+    header.slotCount = qToLittleEndian(slotCount);
+    header.slotsOffset = qToLittleEndian(quint64(file.pos()));
+    header.namesOffset = qToLittleEndian(quint64(file.pos() + slotTable.size() * qint64(sizeof(Slot))));
+
+    const qint64 slotsSize = slotTable.size() * qint64(sizeof(Slot));
+    if (file.write(reinterpret_cast<const char *>(slotTable.constData()), slotsSize) != slotsSize
+            || file.write(names) != names.size() || !file.seek(0)
+            || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        return fail(file.errorString());
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_ASSET_ARCHIVE_H
+#define QSSG_RENDER_ASSET_ARCHIVE_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QPair>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+// Read-only archive of assets (meshes, textures, shaders) packed into a single
+// file. The file is memory-mapped when opened and its index is an open
+// addressing hash table, so finding an entry is a hash probe and the entry
+// data is a slice of the mapping.
+//
+// Layout, all integers little endian:
+//   header  magic, version, entry count, slot count, slots offset, names offset
+//   data    entry data, each aligned to 16 bytes
+//   slots   slot count (a power of two) entries of
+//           data offset, data size, name offset, name size, name hash
+//           a slot with name size 0 is empty
+//   names   UTF-8 entry names
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGAssetArchive
+{
+    Q_DISABLE_COPY(QSSGAssetArchive)
+public:
+    enum : quint32 {
+        Magic = 0x41475351, // "QSGA"
+        Version = 1
+    };
+
+    explicit QSSGAssetArchive(const QString &inFileName);
+    ~QSSGAssetArchive();
+
+    bool open();
+    bool isOpen() const { return m_data != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_errorString; }
+
+    int count() const { return int(m_entryCount); }
+    QStringList entryNames() const;
+
+    // Returns the entry without copying it, or a null array if there is none.
+    // The data stays valid as long as the archive is alive.
+    QByteArray entry(const QString &inName) const;
+    QByteArray entry(const QByteArray &inUtf8Name) const;
+
+    // Writes an archive of the given files as (entry name, file path) pairs
+    static bool write(const QString &inFileName, const QVector<QPair<QString, QString>> &inFiles, QString *outError);
+
+    static quint32 hashName(const char *inName, int inSize);
+
+private:
+    struct Slot;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    const Slot *m_slots = nullptr;
+    quint32 m_slotMask = 0;
+    quint32 m_entryCount = 0;
+    quint64 m_namesOffset = 0;
+    QString m_errorString;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderasyncreadback_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderresourcemanager_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderresourcebufferobjects_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgruntimerenderlogging_p.h>
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+#include <QtQuick3DRender/private/qssgrenderpixelpackbuffer_p.h>
+#include <QtQuick3DRender/private/qssgrendersync_p.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+QImage QSSGReadbackFrame::toImage() const
+{
+    QImage::Format imageFormat;
+    switch (format) {
+    case QSSGRenderReadPixelFormat::RGBA8:
+        imageFormat = QImage::Format_RGBA8888;
+        break;
+    case QSSGRenderReadPixelFormat::RGB8:
+        imageFormat = QImage::Format_RGB888;
+        break;
+    default:
+        return QImage();
+    }
+    if (!isValid())
+        return QImage();
+
+    // GL packs rows with an alignment of 4, which RGB8 rows of odd widths need
+    const int stride = (size.width() * sizeofPixelFormat(format) + 3) & ~3;
+    const QImage wrapped(reinterpret_cast<const uchar *>(data.constData()), size.width(), size.height(), stride, imageFormat);
+    return wrapped.mirrored();
+}
+
+QSSGAsyncReadback::QSSGAsyncReadback(const QSSGRef<QSSGRenderContext> &inContext,
+                                     const QSSGRef<QSSGResourceManager> &inResourceManager,
+                                     qint32 inRingSize)
+    : m_context(inContext), m_resourceManager(inResourceManager)
+{
+    // Pixel pack buffers can only be mapped on contexts that also have sync objects
+    m_asynchronous = m_context->supportsCommandSync();
+    if (m_asynchronous)
+        m_slots.resize(qMax(1, inRingSize));
+}
+
+QSSGAsyncReadback::~QSSGAsyncReadback()
+{
+    // Reads still in flight are dropped, mapping them here could stall for a full frame
+}
+
+static qint32 packedSize(const QRect &inRect, QSSGRenderReadPixelFormat inFormat)
+{
+    const qint32 stride = (inRect.width() * sizeofPixelFormat(inFormat) + 3) & ~3;
+    return stride * inRect.height();
+}
+
+void QSSGAsyncReadback::readRenderTarget(const QRect &inRect, quint64 inFrameId, QSSGRenderReadPixelFormat inFormat)
+{
+    if (inRect.isEmpty())
+        return;
+
+    const qint32 size = packedSize(inRect, inFormat);
+    QSSGReadbackFrame frame;
+    frame.frameId = inFrameId;
+    frame.size = inRect.size();
+    frame.format = inFormat;
+
+    if (!m_asynchronous) {
+        frame.data.resize(size);
+        m_context->readPixels(inRect, inFormat, QSSGByteRef(reinterpret_cast<quint8 *>(frame.data.data()), size));
+        m_synchronousFrames.enqueue(frame);
+        return;
+    }
+
+    // Back-pressure: never overwrite a buffer that has not been read yet
+    if (m_pendingCount == m_slots.size())
+        completeOldest();
+
+    Slot &slot = m_slots[(m_oldest + m_pendingCount) % m_slots.size()];
+    if (!slot.buffer || slot.buffer->size() < quint32(size))
+        slot.buffer = QSSGRef<QSSGRenderPixelPackBuffer>(new QSSGRenderPixelPackBuffer(m_context, QSSGRenderBufferUsageType::Dynamic, size));
+    if (!slot.sync)
+        slot.sync = QSSGRenderSync::create(m_context);
+
+    m_context->readPixels(inRect, inFormat, slot.buffer);
+    slot.sync->sync();
+    slot.frame = frame;
+    ++m_pendingCount;
+}
+
+void QSSGAsyncReadback::readTexture(const QSSGRef<QSSGRenderTexture2D> &inTexture, quint64 inFrameId, QSSGRenderReadPixelFormat inFormat)
+{
+    if (!inTexture)
+        return;
+
+    const QSSGTextureDetails details = inTexture->textureDetails();
+    QSSGRenderContextScopedProperty<QSSGRef<QSSGRenderFrameBuffer>> __renderTarget(*m_context,
+                                                                                  &QSSGRenderContext::renderTarget,
+                                                                                  &QSSGRenderContext::setRenderTarget);
+    QSSGResourceFrameBuffer readBuffer(m_resourceManager);
+    readBuffer.ensureFrameBuffer();
+    readBuffer->attach(QSSGRenderFrameBufferAttachment::Color0, inTexture);
+    m_context->setRenderTarget(readBuffer);
+    readRenderTarget(QRect(0, 0, details.width, details.height), inFrameId, inFormat);
+    readBuffer->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
+}
+
+void QSSGAsyncReadback::completeOldest()
+{
+    Q_ASSERT(m_pendingCount > 0);
+    Slot &slot = m_slots[m_oldest];
+    const qint32 size = packedSize(QRect(QPoint(), slot.frame.size), slot.frame.format);
+
+    // Mapping is what blocks if the fence has not signaled yet
+    slot.buffer->bind();
+    QSSGByteRef mapped = slot.buffer->mapBufferRange(0, size, QSSGRenderBufferAccessTypeValues::Read);
+    if (mapped.begin()) {
+        slot.frame.data.resize(size);
+        ::memcpy(slot.frame.data.data(), mapped.begin(), size_t(size));
+    } else {
+        qCWarning(PERF_WARNING, "Failed to map pixel pack buffer for frame %llu", slot.frame.frameId);
+    }
+    slot.buffer->unmapBuffer();
+    slot.buffer->unbind();
+
+    m_oldest = (m_oldest + 1) % m_slots.size();
+    --m_pendingCount;
+    QSSGReadbackFrame frame = slot.frame;
+    slot.frame = QSSGReadbackFrame();
+    if (frame.isValid())
+        deliver(frame);
+}
+
+void QSSGAsyncReadback::deliver(QSSGReadbackFrame &inFrame)
+{
+    if (m_callback)
+        m_callback(inFrame);
+    else
+        m_readyFrames.enqueue(inFrame);
+}
+
+qint32 QSSGAsyncReadback::poll()
+{
+    qint32 delivered = 0;
+    while (!m_synchronousFrames.isEmpty()) {
+        QSSGReadbackFrame frame = m_synchronousFrames.dequeue();
+        deliver(frame);
+        ++delivered;
+    }
+    // Reads complete in submission order, so stop at the first unsignaled fence
+    while (m_pendingCount && m_slots[m_oldest].sync->isSignaled()) {
+        completeOldest();
+        ++delivered;
+    }
+    return delivered;
+}
+
+void QSSGAsyncReadback::flush()
+{
+    poll();
+    while (m_pendingCount)
+        completeOldest();
+}
+
+bool QSSGAsyncReadback::takeFrame(QSSGReadbackFrame &outFrame)
+{
+    if (m_readyFrames.isEmpty())
+        return false;
+    outFrame = m_readyFrames.dequeue();
+    return true;
+}
+
+QT_END_NAMESPACE
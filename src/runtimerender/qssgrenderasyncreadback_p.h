@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_ASYNC_READBACK_H
+#define QSSG_RENDER_ASYNC_READBACK_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+#include <QtQuick3DRender/private/qssgrenderbasetypes_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QQueue>
+#include <QtCore/QRect>
+#include <QtCore/QVector>
+#include <QtGui/QImage>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+class QSSGRenderContext;
+class QSSGRenderPixelPackBuffer;
+class QSSGRenderSync;
+class QSSGRenderTexture2D;
+class QSSGResourceManager;
+
+struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGReadbackFrame
+{
+    quint64 frameId = 0;
+    QSize size;
+    QSSGRenderReadPixelFormat format = QSSGRenderReadPixelFormat::RGBA8;
+    QByteArray data; // bottom-up rows, as read from GL
+
+    bool isValid() const { return !data.isEmpty(); }
+    // Only RGBA8 and RGB8 frames can be converted, the result is flipped top-down
+    QImage toImage() const;
+};
+
+/**
+ *	Reads rendered frames back to client memory without stalling the pipeline.
+ *
+ *	Each read is packed into one buffer of a small ring of pixel pack buffers and
+ *	fenced. The buffer of frame N is only mapped once its fence has signaled, which
+ *	normally happens while frames N+1 and N+2 are rendered. When the ring is full
+ *	the oldest read is completed with a blocking map, so a slow consumer throttles
+ *	the renderer instead of growing the ring.
+ *
+ *	Contexts without sync objects read synchronously, the frame is still delivered
+ *	from poll() so callers see the same behavior on every backend.
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGAsyncReadback
+{
+    Q_DISABLE_COPY(QSSGAsyncReadback)
+public:
+    QAtomicInt ref;
+
+    typedef std::function<void(const QSSGReadbackFrame &)> FrameCallback;
+
+    QSSGAsyncReadback(const QSSGRef<QSSGRenderContext> &inContext,
+                      const QSSGRef<QSSGResourceManager> &inResourceManager,
+                      qint32 inRingSize = 3);
+    ~QSSGAsyncReadback();
+
+    // When set, completed frames are handed to the callback instead of being queued
+    void setFrameCallback(const FrameCallback &inCallback) { m_callback = inCallback; }
+
+    // Starts reading the given rectangle of the current render target
+    void readRenderTarget(const QRect &inRect,
+                          quint64 inFrameId,
+                          QSSGRenderReadPixelFormat inFormat = QSSGRenderReadPixelFormat::RGBA8);
+    // Starts reading the full texture, it is attached to a temporary frame buffer for this
+    void readTexture(const QSSGRef<QSSGRenderTexture2D> &inTexture,
+                     quint64 inFrameId,
+                     QSSGRenderReadPixelFormat inFormat = QSSGRenderReadPixelFormat::RGBA8);
+
+    // Delivers every read whose fence has signaled, never blocks. Returns the number of frames delivered.
+    qint32 poll();
+    // Blocks until all pending reads are delivered
+    void flush();
+
+    // Queue access, only used when no callback is set
+    bool takeFrame(QSSGReadbackFrame &outFrame);
+    qint32 queuedFrameCount() const { return m_readyFrames.size(); }
+
+    qint32 pendingReadCount() const { return m_pendingCount + m_synchronousFrames.size(); }
+    qint32 ringSize() const { return m_slots.size(); }
+    bool isAsynchronous() const { return m_asynchronous; }
+
+private:
+    struct Slot
+    {
+        QSSGRef<QSSGRenderPixelPackBuffer> buffer;
+        QSSGRef<QSSGRenderSync> sync;
+        QSSGReadbackFrame frame; // metadata only until completed
+    };
+
+    void completeOldest();
+    void deliver(QSSGReadbackFrame &inFrame);
+
+    QSSGRef<QSSGRenderContext> m_context;
+    QSSGRef<QSSGResourceManager> m_resourceManager;
+    QVector<Slot> m_slots;
+    qint32 m_oldest = 0;
+    qint32 m_pendingCount = 0;
+    bool m_asynchronous = false;
+    FrameCallback m_callback;
+    QQueue<QSSGReadbackFrame> m_readyFrames;
+    QQueue<QSSGReadbackFrame> m_synchronousFrames;
+};
+
+QT_END_NAMESPACE
+
+#endif
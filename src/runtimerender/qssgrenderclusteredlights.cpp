@@ -0,0 +1,411 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderclusteredlights_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercamera_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlight_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgruntimerenderlogging_p.h>
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+#include <QtQuick3DRender/private/qssgrendertexture2d_p.h>
+
+#include <QtCore/QSemaphore>
+#include <QtCore/QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const float MINATTENUATION = 0;
+const float MAXATTENUATION = 1000;
+// Contributions below this fraction of the light intensity end the light's range
+const float RANGECUTOFF = 1.0f / 256.0f;
+
+float clampFloat(float value, float min, float max)
+{
+    return value < min ? min : ((value > max) ? max : value);
+}
+
+float translateConstantAttenuation(float attenuation)
+{
+    return attenuation * .01f;
+}
+
+float translateLinearAttenuation(float attenuation)
+{
+    attenuation = clampFloat(attenuation, MINATTENUATION, MAXATTENUATION);
+    return attenuation * 0.0001f;
+}
+
+float translateQuadraticAttenuation(float attenuation)
+{
+    attenuation = clampFloat(attenuation, MINATTENUATION, MAXATTENUATION);
+    return attenuation * 0.0000001f;
+}
+
+// Distance at which 1 / (1 + l * d + q * d^2) drops the intensity below the cutoff
+float lightRange(float intensity, float linear, float quadratic)
+{
+    const float limit = intensity / RANGECUTOFF - 1.0f;
+    if (limit <= 0.0f)
+        return 0.0f;
+    if (quadratic > 0.0f)
+        return (-linear + std::sqrt(linear * linear + 4.0f * quadratic * limit)) / (2.0f * quadratic);
+    if (linear > 0.0f)
+        return limit / linear;
+    return std::numeric_limits<float>::max();
+}
+
+float maxComponent(const QVector3D &v)
+{
+    return qMax(v.x(), qMax(v.y(), v.z()));
+}
+
+} // namespace
+
+struct QSSGRenderClusteredLights::SliceJob
+{
+    QSSGRenderClusteredLights *clusters;
+    qint32 firstSlice;
+    qint32 endSlice;
+    QSemaphore *done;
+};
+
+QSSGRenderClusteredLights::QSSGRenderClusteredLights(QSSGRenderContextInterface *inContext)
+    : m_context(inContext)
+{
+    for (qint32 slice = 0; slice < GridDepth; ++slice)
+        m_tileCounts[slice].resize(TilesPerSlice);
+    m_gridData.resize(ClusterCount * 2);
+}
+
+QSSGRenderClusteredLights::~QSSGRenderClusteredLights() = default;
+
+bool QSSGRenderClusteredLights::isSupported(const QSSGRef<QSSGRenderContext> &inContext)
+{
+    const QSSGRenderContextTypes unsupportedContexts(QSSGRenderContextType::GL2 | QSSGRenderContextType::GLES2);
+    return !(unsupportedContexts & inContext->renderContextType());
+}
+
+bool QSSGRenderClusteredLights::isEnabled(const QSSGRef<QSSGRenderContext> &inContext)
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QUICK3D_CLUSTERED_LIGHTS")
+            && qEnvironmentVariableIntValue("QUICK3D_CLUSTERED_LIGHTS") == 0;
+    return !disabled && isSupported(inContext);
+}
+
+bool QSSGRenderClusteredLights::canCluster(const QSSGRenderLight &inLight)
+{
+    return inLight.m_lightType == QSSGRenderLight::Type::Point && !inLight.m_castShadow && inLight.m_scope == nullptr;
+}
+
+QVector4D QSSGRenderClusteredLights::gridParams() const
+{
+    return QVector4D(GridWidth, GridHeight, GridDepth, IndexTextureWidth);
+}
+
+void QSSGRenderClusteredLights::update(const QSSGRenderCamera &inCamera, const QVector<QSSGRenderLight *> &inLights)
+{
+    m_lightCount = qMin(inLights.size(), qint32(MaxLights));
+    if (inLights.size() > MaxLights)
+        qCWarning(PERF_WARNING, "Too many clustered lights on layer, only %d are used", int(MaxLights));
+
+    const QMatrix4x4 view = inCamera.globalTransform.inverted();
+    m_viewProjection = inCamera.projection * view;
+    // The view looks down -z, negate the third row to get a positive depth
+    m_viewDepthRow = -view.row(2);
+
+    const float nearPlane = qMax(inCamera.clipNear, 0.001f);
+    const float farPlane = qMax(inCamera.clipFar, nearPlane * 2.0f);
+    const float sliceScale = GridDepth / std::log(farPlane / nearPlane);
+    m_depthParams = QVector4D(sliceScale, -std::log(nearPlane) * sliceScale, nearPlane, farPlane);
+
+    m_viewX.resize(m_lightCount);
+    m_viewY.resize(m_lightCount);
+    m_viewDepth.resize(m_lightCount);
+    m_radius.resize(m_lightCount);
+    m_tileRange.resize(m_lightCount * 4);
+    m_sliceRange.resize(m_lightCount * 2);
+    m_lightData.resize(qMax(1, m_lightCount) * TexelsPerLight * 4);
+    m_ambientTotal = QVector3D();
+
+    for (qint32 idx = 0; idx < m_lightCount; ++idx) {
+        const QSSGRenderLight &theLight = *inLights.at(idx);
+        const float brightness = translateConstantAttenuation(theLight.m_brightness);
+        const QVector3D diffuse = theLight.m_diffuseColor * brightness;
+        const QVector3D specular = theLight.m_specularColor * brightness;
+        const float linear = translateLinearAttenuation(theLight.m_linearFade);
+        const float quadratic = translateQuadraticAttenuation(theLight.m_exponentialFade);
+        const float range = lightRange(qMax(maxComponent(diffuse), maxComponent(specular)), linear, quadratic);
+        const QVector3D worldPos = theLight.getGlobalPos();
+        const QVector3D viewPos = view * worldPos;
+
+        m_viewX[idx] = viewPos.x();
+        m_viewY[idx] = viewPos.y();
+        m_viewDepth[idx] = -viewPos.z();
+        m_radius[idx] = range;
+        m_ambientTotal += theLight.m_ambientColor;
+
+        float *texels = m_lightData.data() + idx * TexelsPerLight * 4;
+        texels[0] = worldPos.x();
+        texels[1] = worldPos.y();
+        texels[2] = worldPos.z();
+        texels[3] = range;
+        texels[4] = diffuse.x();
+        texels[5] = diffuse.y();
+        texels[6] = diffuse.z();
+        texels[7] = 0.0f;
+        texels[8] = specular.x();
+        texels[9] = specular.y();
+        texels[10] = specular.z();
+        texels[11] = 0.0f;
+        texels[12] = 1.0f;
+        texels[13] = linear;
+        texels[14] = quadratic;
+        texels[15] = 0.0f;
+    }
+
+    // Depth slice range of every light, plain arithmetic over the arrays above
+    const float *viewDepth = m_viewDepth.constData();
+    const float *radius = m_radius.constData();
+    qint32 *sliceRange = m_sliceRange.data();
+    for (qint32 idx = 0; idx < m_lightCount; ++idx) {
+        const float zNear = qMax(viewDepth[idx] - radius[idx], nearPlane);
+        const float zFar = qMin(viewDepth[idx] + radius[idx], farPlane);
+        if (zNear > zFar) {
+            sliceRange[idx * 2] = 1;
+            sliceRange[idx * 2 + 1] = 0;
+            continue;
+        }
+        const float z0 = std::log(zNear) * m_depthParams.x() + m_depthParams.y();
+        const float z1 = std::log(zFar) * m_depthParams.x() + m_depthParams.y();
+        sliceRange[idx * 2] = qBound(0, qint32(z0), GridDepth - 1);
+        sliceRange[idx * 2 + 1] = qBound(0, qint32(z1), GridDepth - 1);
+    }
+
+    // Screen tile range from the projected view space bounds of the light
+    for (qint32 idx = 0; idx < m_lightCount; ++idx) {
+        qint32 *tiles = m_tileRange.data() + idx * 4;
+        tiles[0] = 0;
+        tiles[1] = GridWidth - 1;
+        tiles[2] = 0;
+        tiles[3] = GridHeight - 1;
+        if (m_sliceRange[idx * 2] > m_sliceRange[idx * 2 + 1] || !qIsFinite(m_radius[idx]))
+            continue;
+        const float r = m_radius[idx];
+        if (r >= std::numeric_limits<float>::max())
+            continue;
+        float minX = 1.0f, maxX = -1.0f, minY = 1.0f, maxY = -1.0f;
+        bool behindCamera = false;
+        for (int corner = 0; corner < 8 && !behindCamera; ++corner) {
+            const QVector4D cornerPos(m_viewX[idx] + ((corner & 1) ? r : -r),
+                                      m_viewY[idx] + ((corner & 2) ? r : -r),
+                                      -(m_viewDepth[idx] + ((corner & 4) ? r : -r)),
+                                      1.0f);
+            const QVector4D clip = inCamera.projection * cornerPos;
+            if (clip.w() <= std::numeric_limits<float>::epsilon()) {
+                behindCamera = true;
+                break;
+            }
+            const float ndcX = clip.x() / clip.w();
+            const float ndcY = clip.y() / clip.w();
+            minX = qMin(minX, ndcX);
+            maxX = qMax(maxX, ndcX);
+            minY = qMin(minY, ndcY);
+            maxY = qMax(maxY, ndcY);
+        }
+        if (behindCamera)
+            continue;
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) {
+            // Fully outside the frustum sides
+            m_sliceRange[idx * 2] = 1;
+            m_sliceRange[idx * 2 + 1] = 0;
+            continue;
+        }
+        tiles[0] = qBound(0, qint32((minX * 0.5f + 0.5f) * GridWidth), GridWidth - 1);
+        tiles[1] = qBound(0, qint32((maxX * 0.5f + 0.5f) * GridWidth), GridWidth - 1);
+        tiles[2] = qBound(0, qint32((minY * 0.5f + 0.5f) * GridHeight), GridHeight - 1);
+        tiles[3] = qBound(0, qint32((maxY * 0.5f + 0.5f) * GridHeight), GridHeight - 1);
+    }
+
+    // Every slice writes only its own lists, so slices can be filled in parallel
+    const QSSGRef<QSSGAbstractThreadPool> &threadPool = m_context->threadPool();
+    if (threadPool && m_lightCount >= ParallelLightThreshold) {
+        const qint32 jobCount = 4;
+        const qint32 slicesPerJob = (GridDepth + jobCount - 1) / jobCount;
+        QSemaphore done;
+        SliceJob jobs[jobCount];
+        qint32 queued = 0;
+        // The first range is culled on this thread
+        for (qint32 job = 1; job < jobCount; ++job) {
+            jobs[job] = SliceJob{ this, job * slicesPerJob, qMin((job + 1) * slicesPerJob, qint32(GridDepth)), &done };
+            threadPool->addTask(&jobs[job], runSliceJob, runSliceJob);
+            ++queued;
+        }
+        cullSlices(0, slicesPerJob);
+        done.acquire(queued);
+    } else {
+        cullSlices(0, GridDepth);
+    }
+
+    upload();
+}
+
+void QSSGRenderClusteredLights::runSliceJob(void *inJob)
+{
+    SliceJob *job = static_cast<SliceJob *>(inJob);
+    job->clusters->cullSlices(job->firstSlice, job->endSlice);
+    job->done->release();
+}
+
+void QSSGRenderClusteredLights::cullSlices(qint32 inFirstSlice, qint32 inEndSlice)
+{
+    for (qint32 slice = inFirstSlice; slice < inEndSlice; ++slice) {
+        quint32 *counts = m_tileCounts[slice].data();
+        std::fill(counts, counts + TilesPerSlice, 0u);
+        QVector<quint16> &indices = m_sliceIndices[slice];
+        indices.clear();
+
+        // Count first so the lights of a tile end up next to each other
+        for (qint32 idx = 0; idx < m_lightCount; ++idx) {
+            if (slice < m_sliceRange[idx * 2] || slice > m_sliceRange[idx * 2 + 1])
+                continue;
+            const qint32 *tiles = m_tileRange.constData() + idx * 4;
+            for (qint32 y = tiles[2]; y <= tiles[3]; ++y) {
+                for (qint32 x = tiles[0]; x <= tiles[1]; ++x)
+                    ++counts[y * GridWidth + x];
+            }
+        }
+
+        quint32 total = 0;
+        for (qint32 tile = 0; tile < TilesPerSlice; ++tile) {
+            const quint32 count = counts[tile];
+            counts[tile] = total;
+            total += count;
+        }
+        if (!total)
+            continue;
+
+        indices.resize(int(total));
+        QVarLengthArray<quint32, TilesPerSlice> cursor(TilesPerSlice);
+        std::copy(counts, counts + TilesPerSlice, cursor.data());
+        for (qint32 idx = 0; idx < m_lightCount; ++idx) {
+            if (slice < m_sliceRange[idx * 2] || slice > m_sliceRange[idx * 2 + 1])
+                continue;
+            const qint32 *tiles = m_tileRange.constData() + idx * 4;
+            for (qint32 y = tiles[2]; y <= tiles[3]; ++y) {
+                for (qint32 x = tiles[0]; x <= tiles[1]; ++x)
+                    indices[int(cursor[y * GridWidth + x]++)] = quint16(idx);
+            }
+        }
+        // counts now holds the start of every tile, turn it back into the count
+        for (qint32 tile = 0; tile < TilesPerSlice; ++tile)
+            counts[tile] = cursor[tile] - counts[tile];
+    }
+}
+
+void QSSGRenderClusteredLights::upload()
+{
+    quint32 totalIndices = 0;
+    for (qint32 slice = 0; slice < GridDepth; ++slice)
+        totalIndices += quint32(m_sliceIndices[slice].size());
+    if (totalIndices > MaxLightIndices) {
+        qCWarning(PERF_WARNING, "Clustered light lists overflow, dropping lights of distant slices");
+        totalIndices = MaxLightIndices;
+    }
+
+    const qint32 indexRows = qMax(1, qint32((totalIndices + IndexTextureWidth - 1) / IndexTextureWidth));
+    m_indexData.resize(indexRows * IndexTextureWidth);
+
+    // Pack the slices one after another and store offset and count per cluster
+    quint32 offset = 0;
+    float *grid = m_gridData.data();
+    for (qint32 slice = 0; slice < GridDepth; ++slice) {
+        const QVector<quint16> &indices = m_sliceIndices[slice];
+        const quint32 *counts = m_tileCounts[slice].constData();
+        const quint32 sliceStart = offset;
+        const quint32 available = MaxLightIndices - sliceStart;
+        const quint32 sliceSize = qMin(quint32(indices.size()), available);
+        for (quint32 i = 0; i < sliceSize; ++i)
+            m_indexData[int(sliceStart + i)] = float(indices.at(int(i)));
+        quint32 tileStart = sliceStart;
+        for (qint32 tile = 0; tile < TilesPerSlice; ++tile) {
+            const quint32 count = indices.isEmpty() ? 0 : counts[tile];
+            const quint32 end = qMin(tileStart + count, sliceStart + sliceSize);
+            float *cluster = grid + (slice * TilesPerSlice + tile) * 2;
+            cluster[0] = float(tileStart);
+            cluster[1] = float(end > tileStart ? end - tileStart : 0);
+            tileStart += count;
+        }
+        offset += sliceSize;
+    }
+
+    const QSSGRef<QSSGRenderContext> &context = m_context->renderContext();
+    auto ensureTexture = [&context](QSSGRef<QSSGRenderTexture2D> &texture) {
+        if (!texture) {
+            texture = new QSSGRenderTexture2D(context);
+            texture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+            texture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+        }
+    };
+    ensureTexture(m_lightDataTexture);
+    ensureTexture(m_gridTexture);
+    ensureTexture(m_indexTexture);
+
+    m_lightDataTexture->setTextureData(QSSGByteView(reinterpret_cast<const quint8 *>(m_lightData.constData()),
+                                                    m_lightData.size() * qint32(sizeof(float))),
+                                       0,
+                                       TexelsPerLight,
+                                       qMax(1, m_lightCount),
+                                       QSSGRenderTextureFormat::RGBA32F);
+    m_gridTexture->setTextureData(QSSGByteView(reinterpret_cast<const quint8 *>(m_gridData.constData()),
+                                               m_gridData.size() * qint32(sizeof(float))),
+                                  0,
+                                  TilesPerSlice,
+                                  GridDepth,
+                                  QSSGRenderTextureFormat::RG32F);
+    m_indexTexture->setTextureData(QSSGByteView(reinterpret_cast<const quint8 *>(m_indexData.constData()),
+                                                m_indexData.size() * qint32(sizeof(float))),
+                                   0,
+                                   IndexTextureWidth,
+                                   indexRows,
+                                   QSSGRenderTextureFormat::R32F);
+}
+
+QSSGRef<QSSGRenderClusteredLights> QSSGRenderClusteredLights::create(QSSGRenderContextInterface *inContext)
+{
+    return QSSGRef<QSSGRenderClusteredLights>(new QSSGRenderClusteredLights(inContext));
+}
+
+QT_END_NAMESPACE
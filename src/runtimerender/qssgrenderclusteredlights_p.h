@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_CLUSTERED_LIGHTS_H
+#define QSSG_RENDER_CLUSTERED_LIGHTS_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+#include <QtQuick3DRender/private/qssgrenderbasetypes_p.h>
+
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector3D>
+#include <QtGui/QVector4D>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QSSGRenderContextInterface;
+class QSSGRenderContext;
+class QSSGRenderTexture2D;
+struct QSSGRenderCamera;
+struct QSSGRenderLight;
+
+/**
+ *	Assigns point lights to the froxels (view frustum clusters) of a camera so the default
+ *	material shader only has to evaluate the lights of the fragment's own cluster.
+ *
+ *	The frustum is split into GridWidth x GridHeight screen tiles and GridDepth slices that
+ *	grow exponentially with the view depth. The result is uploaded to three float textures
+ *	that funcclusterLightVars.glsllib reads with texelFetch:
+ *	- the light data, TexelsPerLight texels per light: position and range, diffuse color,
+ *	  specular color and attenuation
+ *	- the grid, one texel per cluster holding the offset and count of its index range
+ *	- the index list, IndexTextureWidth light indices per row
+ *
+ *	Lights with a shadow or a scope keep using the per-light shader code, only the plain
+ *	point lights of a layer are clustered.
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderClusteredLights
+{
+public:
+    enum {
+        GridWidth = 16,
+        GridHeight = 8,
+        GridDepth = 24,
+        TilesPerSlice = GridWidth * GridHeight,
+        ClusterCount = TilesPerSlice * GridDepth,
+        TexelsPerLight = 4,
+        IndexTextureWidth = 1024,
+        MaxLights = 1024,
+        MaxLightIndices = IndexTextureWidth * 256,
+        // Below this the thread pool round trip costs more than the culling
+        ParallelLightThreshold = 64
+    };
+
+    QAtomicInt ref;
+
+    explicit QSSGRenderClusteredLights(QSSGRenderContextInterface *inContext);
+    ~QSSGRenderClusteredLights();
+
+    // GL2 and GLES2 shaders cannot fetch from float textures by index
+    static bool isSupported(const QSSGRef<QSSGRenderContext> &inContext);
+    // Point lights are clustered unless QUICK3D_CLUSTERED_LIGHTS=0
+    static bool isEnabled(const QSSGRef<QSSGRenderContext> &inContext);
+    // Only point lights without shadow and scope can be evaluated from the cluster lists
+    static bool canCluster(const QSSGRenderLight &inLight);
+
+    // Culls the lights against the froxels of the camera and uploads the result.
+    void update(const QSSGRenderCamera &inCamera, const QVector<QSSGRenderLight *> &inLights);
+
+    bool isEmpty() const { return m_lightCount == 0; }
+    qint32 lightCount() const { return m_lightCount; }
+    // The ambient part of the clustered lights does not depend on the position
+    QVector3D ambientTotal() const { return m_ambientTotal; }
+
+    QSSGRenderTexture2D *lightDataTexture() const { return m_lightDataTexture.data(); }
+    QSSGRenderTexture2D *gridTexture() const { return m_gridTexture.data(); }
+    QSSGRenderTexture2D *indexTexture() const { return m_indexTexture.data(); }
+
+    // x, y, z: grid dimensions, w: width of the index texture
+    QVector4D gridParams() const;
+    // slice = log(viewDepth) * x + y
+    QVector4D depthParams() const { return m_depthParams; }
+    // dot(viewDepthRow, vec4(worldPos, 1.0)) is the view depth of a world position
+    QVector4D viewDepthRow() const { return m_viewDepthRow; }
+    const QMatrix4x4 &viewProjection() const { return m_viewProjection; }
+
+    static QSSGRef<QSSGRenderClusteredLights> create(QSSGRenderContextInterface *inContext);
+
+private:
+    struct SliceJob;
+    static void runSliceJob(void *inJob);
+
+    void cullSlices(qint32 inFirstSlice, qint32 inEndSlice);
+    void upload();
+
+    QSSGRenderContextInterface *m_context;
+    QSSGRef<QSSGRenderTexture2D> m_lightDataTexture;
+    QSSGRef<QSSGRenderTexture2D> m_gridTexture;
+    QSSGRef<QSSGRenderTexture2D> m_indexTexture;
+
+    qint32 m_lightCount = 0;
+    QVector3D m_ambientTotal;
+    QVector4D m_depthParams;
+    QVector4D m_viewDepthRow;
+    QMatrix4x4 m_viewProjection;
+
+    // Light bounds as structure of arrays so the range setup loop vectorizes
+    QVector<float> m_viewX;
+    QVector<float> m_viewY;
+    QVector<float> m_viewDepth;
+    QVector<float> m_radius;
+    QVector<qint32> m_tileRange; // x0, x1, y0, y1 per light
+    QVector<qint32> m_sliceRange; // z0, z1 per light
+
+    QVector<float> m_lightData;
+    QVector<float> m_gridData;
+    QVector<float> m_indexData;
+    QVector<quint16> m_sliceIndices[GridDepth];
+    QVector<quint32> m_tileCounts[GridDepth];
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -58,16 +58,17 @@ QT_BEGIN_NAMESPACE
 
 QSSGRenderContextInterface::~QSSGRenderContextInterface() = default;
 
-QSSGRenderContextInterface::QSSGRenderContextInterface(const QSSGRef<QSSGRenderContext> &ctx, const QString &inApplicationDirectory)
-    : m_renderContext(ctx)
-    , m_inputStreamFactory(new QSSGInputStreamFactory)
-    , m_bufferManager(new QSSGBufferManager(ctx, m_inputStreamFactory, &m_perfTimer))
-    , m_resourceManager(new QSSGResourceManager(ctx))
+QSSGRenderContextInterface::QSSGRenderContextInterface(const QSSGRef<QSSGRenderSharedResources> &sharedResources, const QString &inApplicationDirectory)
+    : m_sharedResources(sharedResources)
+    , m_renderContext(sharedResources->renderContext())
+    , m_inputStreamFactory(sharedResources->inputStreamFactory())
+    , m_bufferManager(sharedResources->bufferManager())
+    , m_resourceManager(new QSSGResourceManager(m_renderContext))
     , m_offscreenRenderManager(QSSGOffscreenRenderManager::createOffscreenRenderManager(m_resourceManager, this))
     , m_renderer(QSSGRendererInterface::createRenderer(this))
     , m_dynamicObjectSystem(new QSSGDynamicObjectSystem(this))
     , m_effectSystem(new QSSGEffectSystem(this))
-    , m_shaderCache(QSSGShaderCache::createShaderCache(ctx, m_inputStreamFactory, &m_perfTimer))
+    , m_shaderCache(sharedResources->shaderCache())
     , m_threadPool(QSSGAbstractThreadPool::createThreadPool(4))
     , m_customMaterialSystem(new QSSGMaterialSystem(this))
     , m_pixelGraphicsRenderer(QSSGPixelGraphicsRendererInterface::createRenderer(this))
@@ -78,14 +79,14 @@ QSSGRenderContextInterface::QSSGRenderContextInterface(const QSSGRef<QSSGRenderC
     , m_renderList(QSSGRenderList::createRenderList())
 {
     if (!inApplicationDirectory.isEmpty())
-        m_inputStreamFactory->addSearchDirectory(inApplicationDirectory);
+        m_sharedResources->addSearchDirectory(inApplicationDirectory);
 
-    const_cast<QSSGRef<IImageBatchLoader> &>(m_imageBatchLoader) = IImageBatchLoader::createBatchLoader(m_inputStreamFactory, m_bufferManager, m_threadPool, &m_perfTimer);
+    const_cast<QSSGRef<IImageBatchLoader> &>(m_imageBatchLoader) = IImageBatchLoader::createBatchLoader(m_inputStreamFactory, m_bufferManager, m_threadPool, performanceTimer());
     m_customMaterialSystem->setRenderContextInterface(this);
 
 
     const char *versionString = nullptr;
-    switch (ctx->renderContextType()) {
+    switch (m_renderContext->renderContextType()) {
     case QSSGRenderContextType::GLES2:
         versionString = "gles2";
         break;
@@ -104,6 +105,10 @@ QSSGRenderContextInterface::QSSGRenderContextInterface(const QSSGRef<QSSGRenderC
     case QSSGRenderContextType::GL4:
         versionString = "gl4";
         break;
+    case QSSGRenderContextType::NullContext:
+        // Nothing gets compiled, any library version will do
+        versionString = "gl3";
+        break;
     default:
         Q_ASSERT(false);
         break;
@@ -150,7 +155,22 @@ QSSGRenderContextInterface::QSSGRenderContextInterfacePtr QSSGRenderContextInter
     if (it != end)
         return *it;
 
-    QSSGRenderContextInterfacePtr ptr { new QSSGRenderContextInterface(ctx, inApplicationDirectory), wid };
+    return getRenderContextInterface(QSSGRenderSharedResources::getSharedResources(ctx), inApplicationDirectory, wid);
+}
+
+QSSGRenderContextInterface::QSSGRenderContextInterfacePtr QSSGRenderContextInterface::getRenderContextInterface(const QSSGRef<QSSGRenderSharedResources> &sharedResources, const QString &inApplicationDirectory, quintptr wid)
+{
+    auto it = g_renderContexts->cbegin();
+    const auto end = g_renderContexts->cend();
+    for (; it != end; ++it) {
+        if (it->m_wid == wid)
+            break;
+    }
+
+    if (it != end)
+        return *it;
+
+    QSSGRenderContextInterfacePtr ptr { new QSSGRenderContextInterface(sharedResources, inApplicationDirectory), wid };
     g_renderContexts->push_back(ptr);
 
     return ptr;
@@ -306,6 +326,8 @@ void QSSGRenderContextInterface::dumpGpuProfilerStats()
 
 void QSSGRenderContextInterface::beginFrame()
 {
+    m_sharedResources->beginFrame();
+    m_resourceManager->beginFrame();
     m_preRenderPresentationDimensions = m_presentationDimensions;
     QSize thePresentationDimensions(m_preRenderPresentationDimensions);
     QRect theContextViewport(contextViewport());
@@ -466,7 +488,9 @@ void QSSGRenderContextInterface::endFrame()
     m_offscreenRenderManager->endFrame();
     m_renderer->endFrame();
     m_customMaterialSystem->endFrame();
+    m_renderContext->endFrame();
     m_presentationDimensions = m_preRenderPresentationDimensions;
+    performanceTimer()->newFrame();
     ++m_frameCount;
 }
 
@@ -54,6 +54,7 @@
 #include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderinputstreamfactory_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgperframeallocator_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendersharedresources_p.h>
 
 #include <QtQuick3DUtils/private/qssgperftimer_p.h>
 
@@ -82,8 +83,8 @@ class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderContextInterface
 public:
     QAtomicInt ref;
 private:
+    const QSSGRef<QSSGRenderSharedResources> m_sharedResources;
     const QSSGRef<QSSGRenderContext> m_renderContext;
-    QSSGPerfTimer m_perfTimer;
 
     const QSSGRef<QSSGInputStreamFactory> m_inputStreamFactory;
     const QSSGRef<QSSGBufferManager> m_bufferManager;
@@ -153,7 +154,7 @@ private:
     QRect presentationViewport(const QRect &inViewerViewport, ScaleModes inScaleToFit, const QSize &inPresDimensions) const;
     void setupRenderTarget();
     void teardownRenderTarget();
-    QSSGRenderContextInterface(const QSSGRef<QSSGRenderContext> &ctx, const QString &inApplicationDirectory);
+    QSSGRenderContextInterface(const QSSGRef<QSSGRenderSharedResources> &sharedResources, const QString &inApplicationDirectory);
 
     static void releaseRenderContextInterface(quintptr wid);
 
@@ -173,6 +174,7 @@ public:
     };
 
     static QSSGRenderContextInterface::QSSGRenderContextInterfacePtr getRenderContextInterface(const QSSGRef<QSSGRenderContext> &ctx, const QString &inApplicationDirectory, quintptr wid);
+    static QSSGRenderContextInterface::QSSGRenderContextInterfacePtr getRenderContextInterface(const QSSGRef<QSSGRenderSharedResources> &sharedResources, const QString &inApplicationDirectory, quintptr wid);
     static QSSGRenderContextInterface::QSSGRenderContextInterfacePtr getRenderContextInterface(quintptr wid);
 
     ~QSSGRenderContextInterface();
@@ -181,6 +183,7 @@ public:
     const QSSGRef<QSSGBufferManager> &bufferManager() const;
     const QSSGRef<QSSGResourceManager> &resourceManager() const;
     const QSSGRef<QSSGRenderContext> &renderContext() const;
+    const QSSGRef<QSSGRenderSharedResources> &sharedResources() const { return m_sharedResources; }
     const QSSGRef<QSSGOffscreenRenderManager> &offscreenRenderManager() const;
     const QSSGRef<QSSGInputStreamFactory> &inputStreamFactory() const;
     const QSSGRef<QSSGEffectSystem> &effectSystem() const;
@@ -190,7 +193,7 @@ public:
     const QSSGRef<QSSGDynamicObjectSystem> &dynamicObjectSystem() const;
     const QSSGRef<QSSGMaterialSystem> &customMaterialSystem() const;
     const QSSGRef<QSSGPixelGraphicsRendererInterface> &pixelGraphicsRenderer() const;
-    QSSGPerfTimer *performanceTimer() { return &m_perfTimer; }
+    QSSGPerfTimer *performanceTimer() { return m_sharedResources->performanceTimer(); }
     const QSSGRef<QSSGRenderList> &renderList() const;
     const QSSGRef<QSSGPathManagerInterface> &pathManager() const;
     const QSSGRef<QSSGShaderProgramGeneratorInterface> &shaderProgramGenerator() const;
@@ -34,6 +34,7 @@
 
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 #include <QtQuick3DRender/private/qssgrendershaderprogram_p.h>
+#include <QtQuick3DRender/private/qssgrenderconstantbuffer_p.h>
 
 #include <QtQuick3DRuntimeRender/private/qssgrendercustommaterialrendercontext_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
@@ -1023,10 +1024,69 @@ void QSSGMaterialSystem::doApplyInstanceValue(QSSGRenderCustomMaterial &inMateri
     }
 }
 
+// The std140 layout of the cbCustomMaterial block declared by QQuick3DCustomMaterial, one
+// member per plain property in declaration order. The buffer is rewritten only when the
+// property values changed.
+void QSSGMaterialSystem::applyConstantBuffer(QSSGRenderCustomMaterial &inMaterial,
+                                             const QSSGRef<QSSGRenderShaderProgram> &inShader,
+                                             QSSGRenderShaderConstantBuffer *inBlock)
+{
+    const quint32 theBlockSize = quint32(inBlock->m_size);
+    bool needsUpload = false;
+    QSSGRenderConstantBuffer *theBuffer = inMaterial.constantBuffers.buffer(context->renderContext(),
+                                                                            theBlockSize,
+                                                                            inMaterial.m_generation,
+                                                                            &needsUpload);
+
+    if (needsUpload) {
+        quint32 theOffset = 0;
+        const auto write = [&theOffset, theBlockSize, theBuffer](quint32 inAlignment, QSSGByteView inData) {
+            theOffset = (theOffset + inAlignment - 1) & ~(inAlignment - 1);
+            if (theOffset + quint32(inData.size()) <= theBlockSize)
+                theBuffer->updateRaw(theOffset, inData);
+            theOffset += quint32(inData.size());
+        };
+        for (const auto &prop : qAsConst(inMaterial.properties)) {
+            switch (prop.shaderDataType) {
+            case QSSGRenderShaderDataType::Float:
+                write(4, toByteView(prop.value.value<float>()));
+                break;
+            case QSSGRenderShaderDataType::Boolean:
+                write(4, toByteView(qint32(prop.value.toBool() ? 1 : 0)));
+                break;
+            case QSSGRenderShaderDataType::Integer:
+                write(4, toByteView(qint32(prop.value.toInt())));
+                break;
+            case QSSGRenderShaderDataType::Vec2:
+                write(8, toByteView(prop.value.value<QVector2D>()));
+                break;
+            case QSSGRenderShaderDataType::Vec3:
+                write(16, toByteView(prop.value.value<QVector3D>()));
+                break;
+            case QSSGRenderShaderDataType::Vec4:
+                write(16, toByteView(prop.value.value<QVector4D>()));
+                break;
+            default:
+                // Not declared in the block
+                break;
+            }
+        }
+        theBuffer->update();
+    }
+
+    inBlock->setBinding(inShader, QSSGRenderContext::MaterialConstantBufferUnit);
+    theBuffer->bindToShaderProgram(inShader, inBlock->m_location, inBlock->m_binding);
+}
+
 void QSSGMaterialSystem::applyInstanceValue(QSSGRenderCustomMaterial &inMaterial,
                                               const QSSGRef<QSSGRenderShaderProgram> &inShader,
                                               const dynamic::QSSGApplyInstanceValue &inCommand)
 {
+    // Properties that live in the block are not found as loose constants below
+    const QSSGRef<QSSGRenderShaderBufferBase> &theBlock = inShader->shaderBuffer(QByteArrayLiteral("cbCustomMaterial"));
+    if (theBlock)
+        applyConstantBuffer(inMaterial, inShader, static_cast<QSSGRenderShaderConstantBuffer *>(theBlock.data()));
+
     // sanity check
     if (!inCommand.m_propertyName.isNull()) {
         const auto &properties = inMaterial.properties;
@@ -1363,7 +1423,8 @@ QSSGLayerGlobalRenderProperties QSSGMaterialSystem::getLayerGlobalRenderProperti
                 theLayer.probe2Window,
                 theLayer.probe2Pos,
                 theLayer.probe2Fade,
-                theLayer.probeFov };
+                theLayer.probeFov,
+                nullptr };
 }
 
 void QSSGMaterialSystem::renderPass(QSSGCustomMaterialRenderContext &inRenderContext, const QSSGRef<QSSGRenderCustomMaterialShader> &inShader, const QSSGRef<QSSGRenderTexture2D> &, const QSSGRef<QSSGRenderFrameBuffer> &inFrameBuffer, bool inRenderTargetNeedsClear, const QSSGRef<QSSGRenderInputAssembler> &inAssembler, quint32 inCount, quint32 inOffset)
@@ -67,6 +67,7 @@ struct QSSGMaterialClass;
 struct QSSGCustomMaterialTextureData;
 struct QSSGRenderCustomMaterialBuffer;
 struct QSSGMaterialOrComputeShader;
+class QSSGRenderShaderConstantBuffer;
 namespace dynamic {
 struct QSSGBindShader;
 struct QSSGApplyInstanceValue;
@@ -124,6 +125,10 @@ private:
                             const QSSGRef<QSSGRenderShaderProgram> &inShader,
                             const dynamic::QSSGApplyInstanceValue &inCommand);
 
+    void applyConstantBuffer(QSSGRenderCustomMaterial &inMaterial,
+                             const QSSGRef<QSSGRenderShaderProgram> &inShader,
+                             QSSGRenderShaderConstantBuffer *inBlock);
+
     void applyBlending(const dynamic::QSSGApplyBlending &inCommand);
 
     void applyRenderStateValue(const dynamic::QSSGApplyRenderState &inCommand);
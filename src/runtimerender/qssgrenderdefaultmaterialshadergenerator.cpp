@@ -33,15 +33,18 @@
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 #include <QtQuick3DRender/private/qssgrendershaderprogram_p.h>
 #include <QtQuick3DRender/private/qssgrendershaderprogram_p.h>
+#include <QtQuick3DRender/private/qssgrenderconstantbuffer_p.h>
 
 #include <QtQuick3DRuntimeRender/private/qssgrenderdefaultmaterialshadergenerator_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercodegeneratorv2_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderableimage_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderableobjects_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderimage_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderlight_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercamera_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadowmap_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderclusteredlights_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercustommaterial_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderdynamicobjectsystem_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderlightconstantproperties_p.h>
@@ -56,12 +59,34 @@ namespace {
 
 const float MINATTENUATION = 0;
 const float MAXATTENUATION = 1000;
+// std140 layout of the cbMaterial block, see addMaterialConstantBuffers()
+const quint32 MATERIAL_BLOCK_IMAGES_OFFSET = 64;
+const quint32 MATERIAL_BLOCK_IMAGE_STRIDE = 48;
+// std140 size of the cbObject block, see addMaterialConstantBuffers()
+const quint32 OBJECT_BLOCK_SIZE = 192;
+// Slots the per-object (cbObject) ring buffer starts with
+const quint32 OBJECT_RING_MIN_SLOTS = 64;
 
 float clampFloat(float value, float min, float max)
 {
     return value < min ? min : ((value > max) ? max : value);
 }
 
+float materialEmissivePower(const QSSGRenderDefaultMaterial &inMaterial)
+{
+    return inMaterial.lighting != QSSGRenderDefaultMaterial::MaterialLighting::NoLighting ? inMaterial.emissivePower / 100.0f : 1.0f;
+}
+
+// The material_diffuse value of the shaders
+QVector4D materialDiffuse(const QSSGRenderDefaultMaterial &inMaterial, float inOpacity)
+{
+    const float emissivePower = materialEmissivePower(inMaterial);
+    return QVector4D(inMaterial.emissiveColor[0] * emissivePower,
+                     inMaterial.emissiveColor[1] * emissivePower,
+                     inMaterial.emissiveColor[2] * emissivePower,
+                     inOpacity);
+}
+
 float translateConstantAttenuation(float attenuation)
 {
     return attenuation * .01f;
@@ -153,8 +178,19 @@ struct QSSGShaderGeneratorGeneratedShader
     QSSGRenderCachedShaderProperty<QVector4D> m_lightProbe2Props;
     QSSGRenderCachedShaderProperty<QVector2D> m_lightProbe2Size;
 
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> m_clusterLightData;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> m_clusterGrid;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> m_clusterIndices;
+    QSSGRenderCachedShaderProperty<QVector4D> m_clusterGridParams;
+    QSSGRenderCachedShaderProperty<QVector4D> m_clusterDepthParams;
+    QSSGRenderCachedShaderProperty<QVector4D> m_clusterViewDepth;
+    QSSGRenderCachedShaderProperty<QMatrix4x4> m_clusterViewProjection;
+
     QSSGRenderCachedShaderBuffer<QSSGRenderShaderConstantBuffer> m_aoShadowParams;
     QSSGRenderCachedShaderBuffer<QSSGRenderShaderConstantBuffer> m_lightsBuffer;
+    // Not present in programs built without constant buffer support
+    QSSGRenderCachedShaderBuffer<QSSGRenderShaderConstantBuffer> m_materialBlock;
+    QSSGRenderCachedShaderBuffer<QSSGRenderShaderConstantBuffer> m_objectBlock;
 
     QSSGLightConstantProperties<QSSGShaderGeneratorGeneratedShader> *m_lightConstantProperties = nullptr;
 
@@ -196,12 +232,27 @@ struct QSSGShaderGeneratorGeneratedShader
         , m_lightProbe2("light_probe2", inShader)
         , m_lightProbe2Props("light_probe2_props", inShader)
         , m_lightProbe2Size("light_probe2_size", inShader)
+        , m_clusterLightData("clusterLightData", inShader)
+        , m_clusterGrid("clusterGrid", inShader)
+        , m_clusterIndices("clusterIndices", inShader)
+        , m_clusterGridParams("clusterGridParams", inShader)
+        , m_clusterDepthParams("clusterDepthParams", inShader)
+        , m_clusterViewDepth("clusterViewDepth", inShader)
+        , m_clusterViewProjection("clusterViewProjection", inShader)
         , m_aoShadowParams("cbAoShadow", inShader)
         , m_lightsBuffer("cbBufferLights", inShader)
+        , m_materialBlock("cbMaterial", inShader)
+        , m_objectBlock("cbObject", inShader)
     {
         Q_UNUSED(inContext)
+        if (m_materialBlock.isValid() && m_objectBlock.isValid()) {
+            m_materialBlock.shaderBuffer->setBinding(inShader, QSSGRenderContext::MaterialConstantBufferUnit);
+            m_objectBlock.shaderBuffer->setBinding(inShader, QSSGRenderContext::ObjectConstantBufferUnit);
+        }
     }
     ~QSSGShaderGeneratorGeneratedShader() { delete m_lightConstantProperties; }
+
+    bool hasConstantBlocks() const { return m_materialBlock.isValid() && m_objectBlock.isValid(); }
 };
 
 struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
@@ -241,6 +292,17 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
     QByteArray m_shadowCoordStem;
     QByteArray m_shadowControlStem;
 
+    // Ring of cbObject blocks, each layer pass takes the next range of slots
+    QSSGRef<QSSGRenderConstantBuffer> m_objectConstants;
+    quint32 m_objectConstantsStride = 0;
+    quint32 m_objectConstantsSlotCount = 0;
+    quint32 m_nextObjectConstantsSlot = 0;
+    // Slot of the next draw, see setObjectConstantsOffset()
+    qint32 m_objectConstantsOffset = -1;
+    // Slots of the current pass left for draws that write their own, e.g. paths
+    quint32 m_spareObjectConstantsSlot = 0;
+    quint32 m_spareObjectConstantsEnd = 0;
+
     QSSGShaderGenerator(QSSGRenderContextInterface *inRc)
         : QSSGDefaultMaterialShaderGeneratorInterface (inRc)
         , m_shadowMapManager(nullptr)
@@ -248,6 +310,13 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
     {
     }
 
+    QSSGShaderGenerator(QSSGRenderContextInterface *inRc, const QSSGRef<QSSGShaderProgramGeneratorInterface> &inProgramGenerator)
+        : QSSGDefaultMaterialShaderGeneratorInterface(inRc, inProgramGenerator)
+        , m_shadowMapManager(nullptr)
+        , m_lightsAsSeparateUniforms(false)
+    {
+    }
+
     QSSGRef<QSSGShaderProgramGeneratorInterface> programGenerator() { return m_programGenerator; }
     QSSGDefaultMaterialVertexPipelineInterface &vertexGenerator() { return *m_currentPipeline; }
     QSSGShaderStageGeneratorInterface &fragmentGenerator()
@@ -700,6 +769,27 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                     QSSGShaderTextureProperties(inShader->m_shader, m_imageSampler, m_imageOffsets, m_imageRotations, m_imageSamplerSize));
         }
         QSSGShaderTextureProperties &theShaderProps = inShader->m_images[idx];
+        // The image horizontal and vertical tiling modes need to be set here, before we set texture
+        // on the shader.
+        // because setting the image on the texture forces the textue to bind and immediately apply
+        // any tex params.
+        const QSSGRef<QSSGRenderTexture2D> &imageTexture = inImage.m_image.m_textureData.m_texture;
+        imageTexture->setTextureWrapS(inImage.m_image.m_horizontalTilingMode);
+        imageTexture->setTextureWrapT(inImage.m_image.m_verticalTilingMode);
+        theShaderProps.sampler.set(imageTexture.data());
+        // Live in cbMaterial when the program has constant blocks
+        if (!inShader->hasConstantBlocks()) {
+            QVector3D offsets;
+            QVector4D rotations;
+            imageTransform(inImage, offsets, rotations);
+            theShaderProps.offsets.set(offsets);
+            theShaderProps.rotations.set(rotations);
+            theShaderProps.size.set(QVector2D(imageTexture->textureDetails().width, imageTexture->textureDetails().height));
+        }
+    }
+
+    static void imageTransform(const QSSGRenderableImage &inImage, QVector3D &outOffsets, QVector4D &outRotations)
+    {
         const QMatrix4x4 &textureTransform = inImage.m_image.m_textureTransform;
         // We separate rotational information from offset information so that just maybe the shader
         // will attempt to push less information to the card.
@@ -707,21 +797,172 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         // The third member of the offsets contains a flag indicating if the texture was
         // premultiplied or not.
         // We use this to mix the texture alpha.
-        QVector3D offsets(dataPtr[12], dataPtr[13], inImage.m_image.m_textureData.m_textureFlags.isPreMultiplied() ? 1.0f : 0.0f);
+        outOffsets = QVector3D(dataPtr[12], dataPtr[13], inImage.m_image.m_textureData.m_textureFlags.isPreMultiplied() ? 1.0f : 0.0f);
         // Grab just the upper 2x2 rotation matrix from the larger matrix.
-        QVector4D rotations(dataPtr[0], dataPtr[4], dataPtr[1], dataPtr[5]);
+        outRotations = QVector4D(dataPtr[0], dataPtr[4], dataPtr[1], dataPtr[5]);
+    }
 
-        // The image horizontal and vertical tiling modes need to be set here, before we set texture
-        // on the shader.
-        // because setting the image on the texture forces the textue to bind and immediately apply
-        // any tex params.
-        const QSSGRef<QSSGRenderTexture2D> &imageTexture = inImage.m_image.m_textureData.m_texture;
-        imageTexture->setTextureWrapS(inImage.m_image.m_horizontalTilingMode);
-        imageTexture->setTextureWrapT(inImage.m_image.m_verticalTilingMode);
-        theShaderProps.sampler.set(imageTexture.data());
-        theShaderProps.offsets.set(offsets);
-        theShaderProps.rotations.set(rotations);
-        theShaderProps.size.set(QVector2D(imageTexture->textureDetails().width, imageTexture->textureDetails().height));
+    // Rewrites the material's cbMaterial buffer when the material changed since the last
+    // upload and binds it. The block size depends on the number of images of the program,
+    // programs with the same layout share a buffer.
+    void updateMaterialConstants(const QSSGRef<QSSGShaderGeneratorGeneratedShader> &inShader,
+                                 const QSSGRenderDefaultMaterial &inMaterial,
+                                 QSSGRenderableImage *inFirstImage,
+                                 float inEmissivePower)
+    {
+        const QSSGRef<QSSGRenderShaderConstantBuffer> &theBlock = inShader->m_materialBlock.shaderBuffer;
+        const quint32 theBlockSize = quint32(theBlock->m_size);
+        bool needsUpload = false;
+        QSSGRenderConstantBuffer *theBuffer = inMaterial.constantBuffers.buffer(m_renderContext->renderContext(),
+                                                                                theBlockSize,
+                                                                                inMaterial.dirty.generation(),
+                                                                                &needsUpload);
+
+        if (needsUpload) {
+            const QVector4D theProperties(inMaterial.specularAmount, inMaterial.specularRoughness, inEmissivePower, 0.0f);
+            const QVector4D theSpecular(inMaterial.specularTint[0], inMaterial.specularTint[1], inMaterial.specularTint[2], inMaterial.ior);
+            theBuffer->updateRaw(0, toByteView(theProperties));
+            theBuffer->updateRaw(16, toByteView(theSpecular));
+            theBuffer->updateRaw(32, toByteView(inMaterial.diffuseColor));
+            theBuffer->updateRaw(44, toByteView(inMaterial.fresnelPower));
+            theBuffer->updateRaw(48, toByteView(inMaterial.bumpAmount));
+            theBuffer->updateRaw(52, toByteView(inMaterial.displaceAmount));
+            theBuffer->updateRaw(56, toByteView(inMaterial.translucentFalloff));
+            theBuffer->updateRaw(60, toByteView(inMaterial.diffuseLightWrap));
+
+            quint32 theOffset = MATERIAL_BLOCK_IMAGES_OFFSET;
+            for (QSSGRenderableImage *theImage = inFirstImage; theImage && theOffset + MATERIAL_BLOCK_IMAGE_STRIDE <= theBlockSize;
+                 theImage = theImage->m_nextImage, theOffset += MATERIAL_BLOCK_IMAGE_STRIDE) {
+                QVector3D offsets;
+                QVector4D rotations;
+                imageTransform(*theImage, offsets, rotations);
+                const QSSGTextureDetails &theDetails = theImage->m_image.m_textureData.m_texture->textureDetails();
+                theBuffer->updateRaw(theOffset, toByteView(offsets));
+                theBuffer->updateRaw(theOffset + 16, toByteView(rotations));
+                theBuffer->updateRaw(theOffset + 32, toByteView(QVector2D(theDetails.width, theDetails.height)));
+            }
+            theBuffer->update();
+        }
+
+        theBuffer->bindToShaderProgram(inShader->m_shader, theBlock->m_location, theBlock->m_binding);
+    }
+
+    // Makes room for inCount consecutive cbObject slots and returns the first one. A range
+    // continues behind the one of the previous pass, so a pass does not overwrite slots the
+    // draws of the pass before are still reading from, and wraps when it does not fit.
+    quint32 reserveObjectConstants(quint32 inCount)
+    {
+        if (!m_objectConstants || inCount > m_objectConstantsSlotCount) {
+            const QSSGRef<QSSGRenderContext> &theContext = m_renderContext->renderContext();
+            if (!m_objectConstantsStride) {
+                qint32 theAlignment = 0;
+                theContext->backend()->getRenderBackendValue(QSSGRenderBackend::QSSGRenderBackendQuery::ConstantBufferOffsetAlignment,
+                                                             &theAlignment);
+                theAlignment = qMax(theAlignment, 16);
+                m_objectConstantsStride = (OBJECT_BLOCK_SIZE + quint32(theAlignment) - 1) / quint32(theAlignment) * quint32(theAlignment);
+            }
+            m_objectConstantsSlotCount = qMax(qMax(inCount, OBJECT_RING_MIN_SLOTS), m_objectConstantsSlotCount * 2);
+            m_nextObjectConstantsSlot = 0;
+            m_spareObjectConstantsSlot = m_spareObjectConstantsEnd = 0;
+            const QByteArray theInitialData(int(m_objectConstantsSlotCount * m_objectConstantsStride), '\0');
+            m_objectConstants = new QSSGRenderConstantBuffer(theContext, QSSGRenderBufferUsageType::Dynamic, toByteView(theInitialData));
+        } else if (m_nextObjectConstantsSlot + inCount > m_objectConstantsSlotCount) {
+            m_nextObjectConstantsSlot = 0;
+        }
+
+        const quint32 theFirstSlot = m_nextObjectConstantsSlot;
+        m_nextObjectConstantsSlot += inCount;
+        return theFirstSlot;
+    }
+
+    // Writes the per-object values into the shadow copy of a cbObject slot, the caller
+    // uploads them.
+    void writeObjectConstants(quint32 inOffset,
+                              const QMatrix4x4 &inModelViewProjection,
+                              const QMatrix3x3 &inNormalMatrix,
+                              const QMatrix4x4 &inGlobalTransform,
+                              const QVector4D &inMaterialDiffuse)
+    {
+        // std140 stores a mat3 as three vec4 columns
+        const float *theNormalData = inNormalMatrix.constData();
+        const float theNormalColumns[12] = { theNormalData[0], theNormalData[1], theNormalData[2], 0.0f,
+                                             theNormalData[3], theNormalData[4], theNormalData[5], 0.0f,
+                                             theNormalData[6], theNormalData[7], theNormalData[8], 0.0f };
+        m_objectConstants->updateRaw(inOffset, toByteView(inModelViewProjection.constData(), 16));
+        m_objectConstants->updateRaw(inOffset + 64, toByteView(inGlobalTransform.constData(), 16));
+        m_objectConstants->updateRaw(inOffset + 128, toByteView(theNormalColumns, 12));
+        m_objectConstants->updateRaw(inOffset + 176, toByteView(inMaterialDiffuse));
+    }
+
+    void uploadObjectConstants(const QVector<QSSGRenderableObject *> &inOpaqueObjects,
+                               const QVector<QSSGRenderableObject *> &inTransparentObjects) override
+    {
+        if (!m_renderContext->renderContext()->supportsConstantBuffer())
+            return;
+
+        // Paths also use the default material shaders but write their values at draw time
+        quint32 theSubsetCount = 0;
+        quint32 theOtherCount = 0;
+        for (const QVector<QSSGRenderableObject *> *theObjects : { &inOpaqueObjects, &inTransparentObjects }) {
+            for (QSSGRenderableObject *theObject : *theObjects) {
+                if (theObject->renderableFlags.isDefaultMaterialMeshSubset())
+                    ++theSubsetCount;
+                else if (theObject->renderableFlags.isPath())
+                    ++theOtherCount;
+            }
+        }
+        if (theSubsetCount + theOtherCount == 0)
+            return;
+
+        const quint32 theFirstSlot = reserveObjectConstants(theSubsetCount + theOtherCount);
+        m_spareObjectConstantsSlot = theFirstSlot + theSubsetCount;
+        m_spareObjectConstantsEnd = m_spareObjectConstantsSlot + theOtherCount;
+        if (theSubsetCount == 0)
+            return;
+
+        quint32 theOffset = theFirstSlot * m_objectConstantsStride;
+        for (const QVector<QSSGRenderableObject *> *theObjects : { &inOpaqueObjects, &inTransparentObjects }) {
+            for (QSSGRenderableObject *theObject : *theObjects) {
+                if (!theObject->renderableFlags.isDefaultMaterialMeshSubset())
+                    continue;
+                QSSGSubsetRenderable &theSubset = static_cast<QSSGSubsetRenderable &>(*theObject);
+                const QSSGModelContext &theModelContext = theSubset.modelContext;
+                writeObjectConstants(theOffset,
+                                     theModelContext.modelViewProjection,
+                                     theModelContext.normalMatrix,
+                                     theModelContext.model.globalTransform,
+                                     materialDiffuse(theSubset.material, theSubset.opacity));
+                theSubset.objectConstantsOffset = qint32(theOffset);
+                theOffset += m_objectConstantsStride;
+            }
+        }
+        m_objectConstants->update();
+    }
+
+    void setObjectConstantsOffset(qint32 inOffset) override { m_objectConstantsOffset = inOffset; }
+
+    // Binds the cbObject slot uploadObjectConstants() wrote at inOffset. Other draws
+    // (inOffset -1) write and upload a slot of their own, from the spare slots of the pass
+    // while there are any.
+    void bindObjectConstants(const QSSGRef<QSSGShaderGeneratorGeneratedShader> &inShader,
+                             qint32 inOffset,
+                             const QMatrix4x4 &inModelViewProjection,
+                             const QMatrix3x3 &inNormalMatrix,
+                             const QMatrix4x4 &inGlobalTransform,
+                             const QVector4D &inMaterialDiffuse)
+    {
+        const QSSGRef<QSSGRenderShaderConstantBuffer> &theBlock = inShader->m_objectBlock.shaderBuffer;
+        Q_ASSERT(quint32(theBlock->m_size) <= OBJECT_BLOCK_SIZE);
+        qint32 theOffset = inOffset;
+        if (theOffset < 0) {
+            const quint32 theSlot = m_spareObjectConstantsSlot < m_spareObjectConstantsEnd
+                    ? m_spareObjectConstantsSlot++
+                    : reserveObjectConstants(1);
+            theOffset = qint32(theSlot * m_objectConstantsStride);
+            writeObjectConstants(quint32(theOffset), inModelViewProjection, inNormalMatrix, inGlobalTransform, inMaterialDiffuse);
+            m_objectConstants->update();
+        }
+        m_objectConstants->bindRange(theBlock->m_binding, quint32(theOffset), OBJECT_BLOCK_SIZE);
     }
 
     void generateShadowMapOcclusion(quint32 lightIdx, bool inShadowEnabled, QSSGRenderLight::Type inType)
@@ -744,6 +985,54 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         }
     }
 
+    // Point lights without shadows are not unrolled into the shader, the fragment loops over
+    // the light list of its cluster instead (see QSSGRenderClusteredLights).
+    void generateClusteredLights(QSSGRenderableImage *translucencyImage, bool specularEnabled, bool enableSSDO)
+    {
+        QSSGShaderStageGeneratorInterface &fragmentShader(fragmentGenerator());
+        vertexGenerator().generateWorldPosition();
+        addFunction(fragmentShader, "clusterLightVars");
+        addFunction(fragmentShader, "calculatePointLightAttenuation");
+
+        m_normalizedDirection = "clusterLight_normalized";
+        m_lightColor = "clusterLight_diffuse";
+        m_lightSpecularColor = "clusterLight_specular";
+
+        fragmentShader << "\n"
+                       << "    //Clustered lights\n"
+                       << "    ivec2 clusterRange = clusterLightRange( varWorldPos );\n"
+                       << "    for (int clusterItem = 0; clusterItem < clusterRange.y; ++clusterItem) {\n"
+                       << "    int clusterLight = clusterLightIndex( clusterRange.x + clusterItem );\n"
+                       << "    vec4 clusterLight_position = clusterLightTexel( clusterLight, 0 );\n"
+                       << "    vec3 clusterLight_relativeDirection = varWorldPos - clusterLight_position.xyz;\n"
+                       << "    float clusterLight_distance = length( clusterLight_relativeDirection );\n"
+                       << "    if (clusterLight_distance > clusterLight_position.w)\n"
+                       << "        continue;\n"
+                       << "    vec3 " << m_normalizedDirection << " = clusterLight_relativeDirection / clusterLight_distance;\n"
+                       << "    vec4 " << m_lightColor << " = vec4(clusterLightTexel( clusterLight, 1 ).rgb * diffuse_color.rgb, 1.0);\n";
+
+        if (enableSSDO)
+            fragmentShader << "    shadowFac = customMaterialShadow( " << m_normalizedDirection << ", varWorldPos );\n";
+        else
+            fragmentShader << "    shadowFac = 1.0;\n";
+
+        fragmentShader << "    lightAttenuation = shadowFac * calculatePointLightAttenuation("
+                       << "clusterLightTexel( clusterLight, 3 ).xyz, clusterLight_distance );\n";
+
+        addTranslucencyIrradiance(fragmentShader, translucencyImage, false);
+
+        fragmentShader << "    global_diffuse_light.rgb += lightAttenuation * "
+                          "diffuseReflectionBSDF( world_normal, "
+                       << "-" << m_normalizedDirection << ", view_vector, " << m_lightColor << ".rgb, 0.0 ).rgb;"
+                       << "\n";
+
+        if (specularEnabled) {
+            fragmentShader << "    vec4 " << m_lightSpecularColor << " = clusterLightTexel( clusterLight, 2 );\n";
+            outputSpecularEquation(material()->specularModel, fragmentShader, m_normalizedDirection, m_lightSpecularColor);
+        }
+        fragmentShader << "    }\n";
+    }
+
     void generateVertexShader()
     {
         // vertex displacement
@@ -772,6 +1061,7 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         bool hasImage = m_firstImage != nullptr;
 
         bool hasIblProbe = m_defaultMaterialShaderKeyProperties.m_hasIbl.getValue(inKey);
+        bool hasClusteredLights = m_defaultMaterialShaderKeyProperties.m_clusteredLighting.getValue(inKey);
         bool hasSpecMap = false;
         bool hasEnvMap = false;
         bool hasEmissiveMap = false;
@@ -1211,6 +1501,9 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                 }
             }
 
+            if (hasClusteredLights)
+                generateClusteredLights(translucencyImage, specularEnabled, enableSSDO);
+
             // This may be confusing but the light colors are already modulated by the base
             // material color.
             // Thus material color is the base material color * material emissive.
@@ -1241,7 +1534,7 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         // since we already modulate our material diffuse color
         // into the light color we will miss it entirely if no IBL
         // or light is used
-        if (hasLightmaps && !(m_lights.size() || hasIblProbe))
+        if (hasLightmaps && !(m_lights.size() || hasClusteredLights || hasIblProbe))
             fragmentShader << "    global_diffuse_light.rgb *= diffuse_color.rgb;"
                            << "\n";
 
@@ -1279,7 +1572,8 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                 QByteArray texSwizzle;
                 QByteArray lookupSwizzle;
 
-                generateImageUVCoordinates(idx, *image, 0);
+                // Lightmaps share the second UV set with the other baked maps
+                generateImageUVCoordinates(idx, *image, image->m_mapType == QSSGImageMapTypes::LightmapShadow ? 1 : 0);
 
                 generateTextureSwizzle(image->m_image.m_textureData.m_texture->textureSwizzleMode(), texSwizzle, lookupSwizzle);
 
@@ -1344,7 +1638,50 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         }
     }
 
-    QSSGRef<QSSGRenderShaderProgram> generateMaterialShader(const QByteArray &inShaderPrefix)
+    // Declares the material values and the per-object values as uniform blocks in every
+    // stage. Loose uniforms of the same names are then left out by the stage generators.
+    // The member order defines the std140 offsets used by updateMaterialConstants() and
+    // writeObjectConstants().
+    void addMaterialConstantBuffers()
+    {
+        quint32 imageCount = 0;
+        for (QSSGRenderableImage *theImage = m_firstImage; theImage; theImage = theImage->m_nextImage)
+            ++imageCount;
+
+        const QSSGShaderGeneratorStageFlags enabledStages = programGenerator()->getEnabledStages();
+        for (quint32 stageIdx = 0; stageIdx < quint32(QSSGShaderGeneratorStage::StageCount); ++stageIdx) {
+            const QSSGShaderGeneratorStage theStage = QSSGShaderGeneratorStage(1 << stageIdx);
+            QSSGShaderStageGeneratorInterface *theGenerator = (enabledStages & theStage)
+                    ? programGenerator()->getStage(theStage)
+                    : nullptr;
+            if (!theGenerator)
+                continue;
+
+            theGenerator->addConstantBuffer("cbMaterial", "layout (std140)");
+            theGenerator->addConstantBufferParam("cbMaterial", "material_properties", "vec4");
+            theGenerator->addConstantBufferParam("cbMaterial", "material_specular", "vec4");
+            theGenerator->addConstantBufferParam("cbMaterial", "diffuse_color", "vec3");
+            theGenerator->addConstantBufferParam("cbMaterial", "fresnelPower", "float");
+            theGenerator->addConstantBufferParam("cbMaterial", "bumpAmount", "float");
+            theGenerator->addConstantBufferParam("cbMaterial", "displaceAmount", "float");
+            theGenerator->addConstantBufferParam("cbMaterial", "translucentFalloff", "float");
+            theGenerator->addConstantBufferParam("cbMaterial", "diffuseLightWrap", "float");
+            for (quint32 imageIdx = 0; imageIdx < imageCount; ++imageIdx) {
+                setupImageVariableNames(imageIdx);
+                theGenerator->addConstantBufferParam("cbMaterial", m_imageOffsets, "vec3");
+                theGenerator->addConstantBufferParam("cbMaterial", m_imageRotations, "vec4");
+                theGenerator->addConstantBufferParam("cbMaterial", m_imageSamplerSize, "vec2");
+            }
+
+            theGenerator->addConstantBuffer("cbObject", "layout (std140)");
+            theGenerator->addConstantBufferParam("cbObject", "model_view_projection", "mat4");
+            theGenerator->addConstantBufferParam("cbObject", "model_matrix", "mat4");
+            theGenerator->addConstantBufferParam("cbObject", "normal_matrix", "mat3");
+            theGenerator->addConstantBufferParam("cbObject", "material_diffuse", "vec4");
+        }
+    }
+
+    QByteArray generateMaterialShaderStages(const QByteArray &inShaderPrefix)
     {
         // build a string that allows us to print out the shader we are generating to the log.
         // This is time consuming but I feel like it doesn't happen all that often and is very
@@ -1361,22 +1698,28 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
 
         generateVertexShader();
         generateFragmentShader(theKey);
+        if (!m_lightsAsSeparateUniforms)
+            addMaterialConstantBuffers();
 
         vertexGenerator().endVertexGeneration(false);
         vertexGenerator().endFragmentGeneration(false);
 
+        return generatedShaderString;
+    }
+
+    QSSGRef<QSSGRenderShaderProgram> generateMaterialShader(const QByteArray &inShaderPrefix)
+    {
+        const QByteArray generatedShaderString = generateMaterialShaderStages(inShaderPrefix);
         return programGenerator()->compileGeneratedShader(generatedShaderString, QSSGShaderCacheProgramFlags(), m_currentFeatureSet);
     }
 
-    QSSGRef<QSSGRenderShaderProgram> generateShader(const QSSGRenderGraphObject &inMaterial,
-                                                        QSSGShaderDefaultMaterialKey inShaderDescription,
-                                                        QSSGShaderStageGeneratorInterface &inVertexPipeline,
-                                                        const TShaderFeatureSet &inFeatureSet,
-                                                        const QVector<QSSGRenderLight *> &inLights,
-                                                        QSSGRenderableImage *inFirstImage,
-                                                        bool inHasTransparency,
-                                                        const QByteArray &inVertexPipelineName,
-                                                        const QByteArray &) override
+    void beginMaterial(const QSSGRenderGraphObject &inMaterial,
+                       QSSGShaderDefaultMaterialKey &inShaderDescription,
+                       QSSGShaderStageGeneratorInterface &inVertexPipeline,
+                       const TShaderFeatureSet &inFeatureSet,
+                       const QVector<QSSGRenderLight *> &inLights,
+                       QSSGRenderableImage *inFirstImage,
+                       bool inHasTransparency)
     {
         Q_ASSERT(inMaterial.type == QSSGRenderGraphObject::Type::DefaultMaterial);
         m_currentMaterial = static_cast<const QSSGRenderDefaultMaterial *>(&inMaterial);
@@ -1386,10 +1729,36 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
         m_lights = inLights;
         m_firstImage = inFirstImage;
         m_hasTransparency = inHasTransparency;
+    }
 
+    QSSGRef<QSSGRenderShaderProgram> generateShader(const QSSGRenderGraphObject &inMaterial,
+                                                        QSSGShaderDefaultMaterialKey inShaderDescription,
+                                                        QSSGShaderStageGeneratorInterface &inVertexPipeline,
+                                                        const TShaderFeatureSet &inFeatureSet,
+                                                        const QVector<QSSGRenderLight *> &inLights,
+                                                        QSSGRenderableImage *inFirstImage,
+                                                        bool inHasTransparency,
+                                                        const QByteArray &inVertexPipelineName,
+                                                        const QByteArray &) override
+    {
+        beginMaterial(inMaterial, inShaderDescription, inVertexPipeline, inFeatureSet, inLights, inFirstImage, inHasTransparency);
         return generateMaterialShader(inVertexPipelineName);
     }
 
+    QSSGShaderCacheProgramSource generateShaderSource(const QSSGRenderGraphObject &inMaterial,
+                                                      QSSGShaderDefaultMaterialKey inShaderDescription,
+                                                      QSSGShaderStageGeneratorInterface &inVertexPipeline,
+                                                      const TShaderFeatureSet &inFeatureSet,
+                                                      const QVector<QSSGRenderLight *> &inLights,
+                                                      QSSGRenderableImage *inFirstImage,
+                                                      bool inHasTransparency,
+                                                      const QByteArray &inVertexPipelineName) override
+    {
+        beginMaterial(inMaterial, inShaderDescription, inVertexPipeline, inFeatureSet, inLights, inFirstImage, inHasTransparency);
+        const QByteArray generatedShaderString = generateMaterialShaderStages(inVertexPipelineName);
+        return programGenerator()->generatedShaderSource(generatedShaderString, QSSGShaderCacheProgramFlags(), m_currentFeatureSet);
+    }
+
     const QSSGRef<QSSGShaderGeneratorGeneratedShader> &getShaderForProgram(const QSSGRef<QSSGRenderShaderProgram> &inProgram)
     {
         auto inserter = m_programToShaderMap.constFind(inProgram);
@@ -1409,6 +1778,7 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                              const QVector<QSSGRenderLight *> &inLights,
                              const QVector<QVector3D> &inLightDirections,
                              const QSSGRef<QSSGRenderShadowMap> &inShadowMapManager,
+                             const QSSGRenderClusteredLights *inClusteredLights,
                              bool receivesShadows = true)
     {
         const QSSGRef<QSSGShaderGeneratorGeneratedShader> &shader(getShaderForProgram(inProgram));
@@ -1507,6 +1877,17 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
             }
             theLightAmbientTotal += theLight->m_ambientColor;
         }
+
+        if (inClusteredLights && !inClusteredLights->isEmpty()) {
+            shader->m_clusterLightData.set(inClusteredLights->lightDataTexture());
+            shader->m_clusterGrid.set(inClusteredLights->gridTexture());
+            shader->m_clusterIndices.set(inClusteredLights->indexTexture());
+            shader->m_clusterGridParams.set(inClusteredLights->gridParams());
+            shader->m_clusterDepthParams.set(inClusteredLights->depthParams());
+            shader->m_clusterViewDepth.set(inClusteredLights->viewDepthRow());
+            shader->m_clusterViewProjection.set(inClusteredLights->viewProjection());
+            theLightAmbientTotal += inClusteredLights->ambientTotal();
+        }
         shader->m_lightAmbientTotal = theLightAmbientTotal;
     }
 
@@ -1533,9 +1914,14 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
 
         const QSSGRef<QSSGRenderContext> &context = m_renderContext->renderContext();
         const QSSGRef<QSSGShaderGeneratorGeneratedShader> &shader = getShaderForProgram(inProgram);
-        shader->m_mvp.set(inModelViewProjection);
-        shader->m_normalMatrix.set(inNormalMatrix);
-        shader->m_globalTransform.set(inGlobalTransform);
+        const bool hasConstantBlocks = shader->hasConstantBlocks();
+        const qint32 theObjectConstantsOffset = m_objectConstantsOffset;
+        m_objectConstantsOffset = -1;
+        if (!hasConstantBlocks) {
+            shader->m_mvp.set(inModelViewProjection);
+            shader->m_normalMatrix.set(inNormalMatrix);
+            shader->m_globalTransform.set(inGlobalTransform);
+        }
         shader->m_depthTexture.set(inDepthTexture.data());
 
         shader->m_aoTexture.set(inSSaoTexture.data());
@@ -1607,25 +1993,27 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
             shader->m_lightProbe2Props.set(QVector4D(0.0f, 0.0f, 0.0f, 0.0f));
         }
 
-        float emissivePower = 1.0;
-
-        quint32 hasLighting = inMaterial.lighting != QSSGRenderDefaultMaterial::MaterialLighting::NoLighting;
-        if (hasLighting)
-            emissivePower = inMaterial.emissivePower / 100.0f;
-
-        QVector4D material_diffuse = QVector4D(inMaterial.emissiveColor[0] * emissivePower,
-                                               inMaterial.emissiveColor[1] * emissivePower,
-                                               inMaterial.emissiveColor[2] * emissivePower,
-                                               inOpacity);
-        shader->m_materialDiffuse.set(material_diffuse);
-        shader->m_diffuseColor.set(inMaterial.diffuseColor);
-        QVector4D material_specular = QVector4D(inMaterial.specularTint[0],
-                                                inMaterial.specularTint[1],
-                                                inMaterial.specularTint[2],
-                                                inMaterial.ior);
-        shader->m_materialSpecular.set(material_specular);
+        const float emissivePower = materialEmissivePower(inMaterial);
+        const QVector4D material_diffuse = materialDiffuse(inMaterial, inOpacity);
+        if (hasConstantBlocks) {
+            bindObjectConstants(shader, theObjectConstantsOffset, inModelViewProjection, inNormalMatrix, inGlobalTransform, material_diffuse);
+            updateMaterialConstants(shader, inMaterial, inFirstImage, emissivePower);
+        } else {
+            shader->m_materialDiffuse.set(material_diffuse);
+            shader->m_diffuseColor.set(inMaterial.diffuseColor);
+            QVector4D material_specular = QVector4D(inMaterial.specularTint[0],
+                                                    inMaterial.specularTint[1],
+                                                    inMaterial.specularTint[2],
+                                                    inMaterial.ior);
+            shader->m_materialSpecular.set(material_specular);
+            shader->m_fresnelPower.set(inMaterial.fresnelPower);
+            shader->m_materialProperties.set(QVector4D(inMaterial.specularAmount, inMaterial.specularRoughness, emissivePower, 0.0f));
+            shader->m_bumpAmount.set(inMaterial.bumpAmount);
+            shader->m_displaceAmount.set(inMaterial.displaceAmount);
+            shader->m_translucentFalloff.set(inMaterial.translucentFalloff);
+            shader->m_diffuseLightWrap.set(inMaterial.diffuseLightWrap);
+        }
         shader->m_cameraProperties.set(inCameraVec);
-        shader->m_fresnelPower.set(inMaterial.fresnelPower);
 
         if (context->supportsConstantBuffer()) {
             const QSSGRef<QSSGRenderConstantBuffer> &pLightCb = getLightConstantBuffer(shader->m_lights.size());
@@ -1672,11 +2060,6 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                           shader->m_lightAmbientTotal.y() * inMaterial.diffuseColor[1],
                           shader->m_lightAmbientTotal.z() * inMaterial.diffuseColor[2]));
 
-        shader->m_materialProperties.set(QVector4D(inMaterial.specularAmount, inMaterial.specularRoughness, emissivePower, 0.0f));
-        shader->m_bumpAmount.set(inMaterial.bumpAmount);
-        shader->m_displaceAmount.set(inMaterial.displaceAmount);
-        shader->m_translucentFalloff.set(inMaterial.translucentFalloff);
-        shader->m_diffuseLightWrap.set(inMaterial.diffuseLightWrap);
         quint32 imageIdx = 0;
         for (QSSGRenderableImage *theImage = inFirstImage; theImage; theImage = theImage->m_nextImage, ++imageIdx)
             setImageShaderVariables(shader, *theImage, imageIdx);
@@ -1754,6 +2137,7 @@ struct QSSGShaderGenerator : public QSSGDefaultMaterialShaderGeneratorInterface
                             inRenderProperties.lights,
                             inRenderProperties.lightDirections,
                             inRenderProperties.shadowMapManager,
+                            inRenderProperties.clusteredLights,
                             receivesShadows);
         setMaterialProperties(inProgram,
                               theMaterial,
@@ -1795,6 +2179,13 @@ QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> QSSGDefaultMaterialShaderGe
     return QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface>(new QSSGShaderGenerator(inRc));
 }
 
+QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> QSSGDefaultMaterialShaderGeneratorInterface::createDefaultMaterialShaderGenerator(
+        QSSGRenderContextInterface *inRc,
+        const QSSGRef<QSSGShaderProgramGeneratorInterface> &inProgramGenerator)
+{
+    return QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface>(new QSSGShaderGenerator(inRc, inProgramGenerator));
+}
+
 QSSGDefaultMaterialVertexPipelineInterface::~QSSGDefaultMaterialVertexPipelineInterface() = default;
 
 QT_END_NAMESPACE
@@ -51,6 +51,7 @@ QT_BEGIN_NAMESPACE
 class QSSGRenderShadowMap;
 struct QSSGShaderGeneratorGeneratedShader;
 struct QSSGRenderableImage;
+struct QSSGRenderableObject;
 
 class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGDefaultMaterialVertexPipelineInterface : public QSSGShaderStageGeneratorInterface
 {
@@ -101,6 +102,10 @@ public:
     QSSGDefaultMaterialShaderGeneratorInterface(QSSGRenderContextInterface *renderContext)
         : QSSGMaterialShaderGeneratorInterface(renderContext)
     {}
+    QSSGDefaultMaterialShaderGeneratorInterface(QSSGRenderContextInterface *renderContext,
+                                                const QSSGRef<QSSGShaderProgramGeneratorInterface> &programGenerator)
+        : QSSGMaterialShaderGeneratorInterface(renderContext, programGenerator)
+    {}
 
     virtual ~QSSGDefaultMaterialShaderGeneratorInterface() override {}
     virtual void addDisplacementImageUniforms(QSSGShaderStageGeneratorInterface &inGenerator,
@@ -126,6 +131,17 @@ public:
                                                         const QByteArray &inVertexPipelineName,
                                                         const QByteArray &inCustomMaterialName = QByteArray()) override = 0;
 
+    // Same as generateShader, but stops before compiling. The program can then be
+    // compiled from the returned source with QSSGShaderCache::compileProgram.
+    virtual QSSGShaderCacheProgramSource generateShaderSource(const QSSGRenderGraphObject &inMaterial,
+                                                              QSSGShaderDefaultMaterialKey inShaderDescription,
+                                                              QSSGShaderStageGeneratorInterface &inVertexPipeline,
+                                                              const TShaderFeatureSet &inFeatureSet,
+                                                              const QVector<QSSGRenderLight *> &inLights,
+                                                              QSSGRenderableImage *inFirstImage,
+                                                              bool inHasTransparency,
+                                                              const QByteArray &inVertexPipelineName) = 0;
+
     // Also sets the blend function on the render context.
     virtual void setMaterialProperties(const QSSGRef<QSSGRenderShaderProgram> &inProgram,
                                        const QSSGRenderGraphObject &inMaterial,
@@ -138,7 +154,20 @@ public:
                                        const QSSGLayerGlobalRenderProperties &inRenderProperties,
                                        bool receivesShadows = true) override = 0;
 
+    // Writes the per-object constants of the default material subsets of a pass with one
+    // buffer upload and stores their offsets in QSSGSubsetRenderable::objectConstantsOffset.
+    virtual void uploadObjectConstants(const QVector<QSSGRenderableObject *> &inOpaqueObjects,
+                                       const QVector<QSSGRenderableObject *> &inTransparentObjects) = 0;
+    // The offset the next setMaterialProperties() binds the object constants at, -1 when the
+    // draw was not uploaded with its pass.
+    virtual void setObjectConstantsOffset(qint32 inOffset) = 0;
+
     static QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> createDefaultMaterialShaderGenerator(QSSGRenderContextInterface *inRenderContext);
+    // A generator that only uses inProgramGenerator, for generating sources
+    // next to the context's generator, e.g. from a worker thread.
+    static QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> createDefaultMaterialShaderGenerator(
+            QSSGRenderContextInterface *inRenderContext,
+            const QSSGRef<QSSGShaderProgramGeneratorInterface> &inProgramGenerator);
 
     QSSGLightConstantProperties<QSSGShaderGeneratorGeneratedShader> *getLightConstantProperties(QSSGShaderGeneratorGeneratedShader &shader);
 };
@@ -182,13 +182,10 @@ QString QSSGDynamicObjectSystem::getShaderCodeLibraryDirectory()
 {
     return QStringLiteral("res/effectlib");
 }
-static QByteArray includeSearch() { return QByteArrayLiteral("#include \""); };
-static QByteArray copyrightHeaderStart() { return QByteArrayLiteral("/****************************************************************************"); }
-static QByteArray copyrightHeaderEnd() { return QByteArrayLiteral("****************************************************************************/"); }
-
-
 QSSGDynamicObjectSystem::QSSGDynamicObjectSystem(QSSGRenderContextInterface *ctx)
-    : m_context(ctx), m_propertyLoadMutex()
+    : m_context(ctx)
+    , m_shaderLibrary([this](const QByteArray &inPath, QByteArray &outSource) { return loadShaderLibraryFile(inPath, outSource); })
+    , m_propertyLoadMutex()
 {
 }
 
@@ -207,6 +204,7 @@ void QSSGDynamicObjectSystem::setShaderData(const QByteArray &inPath,
         foundIt.value() = inData;
     else
         m_expandedFiles.insert(inPath, inData);
+    m_shaderLibrary.invalidate(inPath);
 
     // set shader type and version if available
     if (!inShaderType.isNull() || !inShaderVersion.isNull() || inHasGeomShader || inIsComputeShader) {
@@ -242,88 +240,69 @@ QByteArray QSSGDynamicObjectSystem::getShaderCacheKey(const QByteArray &inId,
 
 void QSSGDynamicObjectSystem::insertShaderHeaderInformation(QByteArray &theReadBuffer, const QByteArray &inPathToEffect)
 {
-    doInsertShaderHeaderInformation(theReadBuffer, inPathToEffect);
+    QSSGStackPerfTimer perfTimer(m_context->performanceTimer(), Q_FUNC_INFO);
+    // This is the complete source of a shader stage, so library functions it doesn't use can go
+    theReadBuffer = m_shaderLibrary.expand(theReadBuffer, inPathToEffect, true);
 }
 
 void QSSGDynamicObjectSystem::doInsertShaderHeaderInformation(QByteArray &theReadBuffer, const QByteArray &inPathToEffect)
 {
-    // Now do search and replace for the headers
-    for (int thePos = theReadBuffer.indexOf(includeSearch()); thePos != -1;
-         thePos = theReadBuffer.indexOf(includeSearch(), thePos + 1)) {
-        int theEndQuote = theReadBuffer.indexOf('\"', thePos + includeSearch().length() + 1);
-        // Indicates an unterminated include file.
-        if (theEndQuote == -1) {
-            qCCritical(INVALID_OPERATION, "Unterminated include in file: %s", inPathToEffect.constData());
-            theReadBuffer.clear();
-            break;
-        }
-        const int theActualBegin = thePos + includeSearch().length();
-        const auto &theInclude = theReadBuffer.mid(theActualBegin, theEndQuote - theActualBegin);
-        // If we haven't included the file yet this round
-        auto theHeader = doLoadShader(theInclude);
-        // Strip copywrite headers from include if present
-        if (theHeader.startsWith(copyrightHeaderStart())) {
-            int clipPos = theHeader.indexOf(copyrightHeaderEnd()) ;
-            if (clipPos >= 0)
-                theHeader.remove(0, clipPos + copyrightHeaderEnd().count());
-        }
-        // Write insert comment for begin source
-        theHeader.prepend(QByteArrayLiteral("\n// begin \"") + theInclude + QByteArrayLiteral("\"\n"));
-        // Write insert comment for end source
-        theHeader.append(QByteArrayLiteral("\n// end \"" ) + theInclude + QByteArrayLiteral("\"\n"));
-        theReadBuffer = theReadBuffer.replace(thePos, (theEndQuote + 1) - thePos, theHeader);
-    }
+    theReadBuffer = m_shaderLibrary.expand(theReadBuffer, inPathToEffect, false);
 }
 
-QByteArray QSSGDynamicObjectSystem::doLoadShader(const QByteArray &inPathToEffect)
+QByteArray QSSGDynamicObjectSystem::doLoadShader(const QByteArray &inPathToEffect, bool inStripUnusedFunctions)
 {
-    auto theInsert = m_expandedFiles.find(inPathToEffect);
-    const bool found = (theInsert != m_expandedFiles.end());
+    return m_shaderLibrary.expandFile(inPathToEffect, inStripUnusedFunctions);
+}
 
-    QByteArray theReadBuffer;
-    if (!found) {
-        const QString defaultDir = getShaderCodeLibraryDirectory();
-        const QString platformDir = shaderCodeLibraryPlatformDirectory();
-        const auto ver = shaderCodeLibraryVersion();
-
-        QString fullPath;
-        QSharedPointer<QIODevice> theStream;
-        if (!platformDir.isEmpty()) {
-            QTextStream stream(&fullPath);
-            stream << platformDir << QLatin1Char('/') << QString::fromLocal8Bit(inPathToEffect);
-            theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, true);
-        }
+bool QSSGDynamicObjectSystem::loadShaderLibraryFile(const QByteArray &inPath, QByteArray &outSource)
+{
+    auto theInsert = m_expandedFiles.constFind(inPath);
+    if (theInsert != m_expandedFiles.constEnd()) {
+        outSource = theInsert.value();
+        return true;
+    }
+
+    const QString defaultDir = getShaderCodeLibraryDirectory();
+    const QString platformDir = shaderCodeLibraryPlatformDirectory();
+    const auto ver = shaderCodeLibraryVersion();
+
+    QString fullPath;
+    QSharedPointer<QIODevice> theStream;
+    if (!platformDir.isEmpty()) {
+        QTextStream stream(&fullPath);
+        stream << platformDir << QLatin1Char('/') << QString::fromLocal8Bit(inPath);
+        theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, true);
+    }
 
+    if (theStream.isNull()) {
+        fullPath.clear();
+        QTextStream stream(&fullPath);
+        stream << defaultDir << QLatin1Char('/') << ver << QLatin1Char('/') << QString::fromLocal8Bit(inPath);
+        theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, true);
         if (theStream.isNull()) {
             fullPath.clear();
             QTextStream stream(&fullPath);
-            stream << defaultDir << QLatin1Char('/') << ver << QLatin1Char('/') << QString::fromLocal8Bit(inPathToEffect);
-            theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, true);
-            if (theStream.isNull()) {
-                fullPath.clear();
-                QTextStream stream(&fullPath);
-                stream << defaultDir << QLatin1Char('/') << QString::fromLocal8Bit(inPathToEffect);
-                theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, false);
-            }
-        }
-        if (!theStream.isNull()) {
-            char readBuf[1024];
-            qint64 amountRead = 0;
-            do {
-                amountRead = theStream->read(readBuf, 1024);
-                if (amountRead)
-                    theReadBuffer.append(readBuf, int(amountRead));
-            } while (amountRead);
-        } else {
-            qCCritical(INVALID_OPERATION, "Failed to find include file %s", qPrintable(QString::fromLocal8Bit(inPathToEffect)));
-            Q_ASSERT(false);
+            stream << defaultDir << QLatin1Char('/') << QString::fromLocal8Bit(inPath);
+            theStream = m_context->inputStreamFactory()->getStreamForFile(fullPath, false);
         }
-        theInsert = m_expandedFiles.insert(inPathToEffect, theReadBuffer);
+    }
+    QByteArray theReadBuffer;
+    if (!theStream.isNull()) {
+        char readBuf[1024];
+        qint64 amountRead = 0;
+        do {
+            amountRead = theStream->read(readBuf, 1024);
+            if (amountRead)
+                theReadBuffer.append(readBuf, int(amountRead));
+        } while (amountRead);
     } else {
-        theReadBuffer = theInsert.value();
+        qCCritical(INVALID_OPERATION, "Failed to find include file %s", qPrintable(QString::fromLocal8Bit(inPath)));
+        Q_ASSERT(false);
     }
-    doInsertShaderHeaderInformation(theReadBuffer, inPathToEffect);
-    return theReadBuffer;
+    m_expandedFiles.insert(inPath, theReadBuffer);
+    outSource = theReadBuffer;
+    return !theStream.isNull();
 }
 
 QStringList QSSGDynamicObjectSystem::getParameters(const QString &str, int begin, int end)
@@ -505,7 +484,7 @@ TShaderAndFlags QSSGDynamicObjectSystem::getShaderProgram(const QByteArray &inPa
             QSSGDynamicObjectShaderInfo
                     &theShaderInfo = m_shaderInfoMap.insert(inPath, QSSGDynamicObjectShaderInfo()).value();
             if (theShaderInfo.m_isComputeShader == false) {
-                QByteArray programSource = doLoadShader(inPath);
+                QByteArray programSource = doLoadShader(inPath, true);
                 if (theShaderInfo.m_hasGeomShader)
                     theFlags |= ShaderCacheProgramFlagValues::GeometryShaderEnabled;
                 theProgram = compileShader(inPath, programSource.constData(), nullptr, inProgramMacro, inFeatureSet, theFlags, inForceCompilation);
@@ -514,7 +493,7 @@ TShaderAndFlags QSSGDynamicObjectSystem::getShaderProgram(const QByteArray &inPa
                 const char *shaderVersionStr = "#version 430\n";
                 if (m_context->renderContext()->renderContextType() == QSSGRenderContextType::GLES3PLUS)
                     shaderVersionStr = "#version 310 es\n";
-                theShaderBuffer = doLoadShader(inPath);
+                theShaderBuffer = doLoadShader(inPath, true);
                 theShaderBuffer.insert(0, shaderVersionStr);
                 theProgram = m_context->renderContext()->compileComputeSource(inPath, toByteView(theShaderBuffer)).m_shader;
             }
@@ -582,6 +561,7 @@ TShaderAndFlags QSSGDynamicObjectSystem::getDepthPrepassShader(const QByteArray
 void QSSGDynamicObjectSystem::setShaderCodeLibraryVersion(const QByteArray &version)
 {
     m_shaderLibraryVersion = version;
+    m_shaderLibrary.clear();
 }
 
 QByteArray QSSGDynamicObjectSystem::shaderCodeLibraryVersion()
@@ -592,6 +572,7 @@ QByteArray QSSGDynamicObjectSystem::shaderCodeLibraryVersion()
 void QSSGDynamicObjectSystem::setShaderCodeLibraryPlatformDirectory(const QString &directory)
 {
     m_shaderLibraryPlatformDirectory = directory;
+    m_shaderLibrary.clear();
 }
 
 QString QSSGDynamicObjectSystem::shaderCodeLibraryPlatformDirectory()
@@ -48,6 +48,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendertessmodevalues_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendergraphobject_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendershaderlibrary_p.h>
 
 #include <QtGui/QVector2D>
 
@@ -143,6 +144,7 @@ struct QSSGDynamicObjectSystem
     QByteArray m_geometryShader;
     QByteArray m_shaderLibraryVersion;
     QString m_shaderLibraryPlatformDirectory;
+    QSSGShaderLibraryPreprocessor m_shaderLibrary;
     mutable QMutex m_propertyLoadMutex;
     QAtomicInt ref;
 
@@ -165,7 +167,9 @@ struct QSSGDynamicObjectSystem
 
     void doInsertShaderHeaderInformation(QByteArray &theReadBuffer, const QByteArray &inPathToEffect);
 
-    QByteArray doLoadShader(const QByteArray &inPathToEffect);
+    QByteArray doLoadShader(const QByteArray &inPathToEffect, bool inStripUnusedFunctions = false);
+
+    bool loadShaderLibraryFile(const QByteArray &inPath, QByteArray &outSource);
 
     QStringList getParameters(const QString &str, int begin, int end);
 
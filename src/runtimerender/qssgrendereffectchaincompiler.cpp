@@ -0,0 +1,412 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qssgrendereffectchaincompiler_p.h"
+
+#include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendereffect_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderdynamicobjectsystemcommands_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendershaderlibrary_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+using namespace dynamic;
+
+namespace {
+
+// Uniforms and varyings all effect shaders share through effect.glsllib, and
+// that the effect system sets on the fused shader once.
+const char *const s_sharedNames[] = { "ModelViewProjectionMatrix", "Texture0",  "Texture0Info", "Texture0Flags",
+                                      "DestSize",                  "TexCoord",  "FragColorAlphaSettings",
+                                      "AppFrame",                  "FPS",       "CameraClipRange" };
+
+// Types that can follow a qualifier without being a declared name
+const char *const s_typeNames[] = { "void",  "bool",  "int",   "float", "vec2",      "vec3",       "vec4",
+                                    "bvec2", "bvec3", "bvec4", "ivec2", "ivec3",     "ivec4",      "mat2",
+                                    "mat3",  "mat4",  "highp", "lowp",  "sampler2D", "samplerCube" };
+
+template<size_t N>
+bool isOneOf(const char *const (&inNames)[N], const QByteArray &inName)
+{
+    for (const char *theName : inNames) {
+        if (inName == theName)
+            return true;
+    }
+    return false;
+}
+
+inline bool isIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isIdentifierChar(char c)
+{
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+// Splits comment free source into identifiers and single punctuation
+// characters. Numbers and preprocessor lines are left out.
+QVector<QByteArray> tokensOf(const QByteArray &inText)
+{
+    QVector<QByteArray> result;
+    const char *data = inText.constData();
+    const int size = inText.size();
+    bool lineStart = true;
+    for (int i = 0; i < size;) {
+        const char c = data[i];
+        if (c == '#' && lineStart) {
+            while (i < size && !(data[i] == '\n' && data[i - 1] != '\\'))
+                ++i;
+        } else if (isIdentifierStart(c)) {
+            const int start = i;
+            while (i < size && isIdentifierChar(data[i]))
+                ++i;
+            result.append(QByteArray(data + start, i - start));
+            lineStart = false;
+        } else if (c >= '0' && c <= '9') {
+            while (i < size && (isIdentifierChar(data[i]) || data[i] == '.'))
+                ++i;
+            lineStart = false;
+        } else {
+            if (c == '\n') {
+                lineStart = true;
+            } else if (c != ' ' && c != '\t' && c != '\r') {
+                lineStart = false;
+                result.append(QByteArray(1, c));
+            }
+            ++i;
+        }
+    }
+    return result;
+}
+
+inline bool isIdentifier(const QByteArray &inToken)
+{
+    return !inToken.isEmpty() && isIdentifierStart(inToken.at(0));
+}
+
+void appendUnique(QVector<QByteArray> &ioNames, const QByteArray &inName)
+{
+    if (!ioNames.contains(inName))
+        ioNames.append(inName);
+}
+
+// Collects the names a top level chunk declares: variables, uniforms,
+// function prototypes and structs.
+void collectDeclarations(const QVector<QByteArray> &inTokens, QVector<QByteArray> &ioNames)
+{
+    int depth = 0;
+    for (int i = 0, end = inTokens.size(); i < end; ++i) {
+        const QByteArray &theToken = inTokens.at(i);
+        if (theToken == "(" || theToken == "{" || theToken == "[") {
+            ++depth;
+        } else if (theToken == ")" || theToken == "}" || theToken == "]") {
+            depth = qMax(0, depth - 1);
+        } else if (depth == 0 && i > 0 && i + 1 < end && isIdentifier(theToken) && isIdentifier(inTokens.at(i - 1))) {
+            const QByteArray &theNext = inTokens.at(i + 1);
+            const bool declares = theNext == ";" || theNext == "=" || theNext == "[" || theNext == "," || theNext == "("
+                    || (theNext == "{" && inTokens.at(i - 1) == "struct");
+            if (declares && !isOneOf(s_typeNames, theToken) && !isOneOf(s_sharedNames, theToken))
+                appendUnique(ioNames, theToken);
+        }
+    }
+}
+
+} // namespace
+
+QSSGEffectChainCompiler::QSSGEffectChainCompiler(QSSGRenderContextInterface *inContext) : m_context(inContext) {}
+
+bool QSSGEffectChainCompiler::chainStage(const QSSGRenderEffect &inEffect, QSSGEffectChainStage &outStage)
+{
+    if (!inEffect.textureProperties.isEmpty())
+        return false;
+
+    bool hasShader = false;
+    bool hasTarget = false;
+    bool rendered = false;
+    for (const QSSGCommand *theCommand : inEffect.commands) {
+        switch (theCommand->m_type) {
+        case CommandType::BindTarget:
+            if (rendered)
+                return false;
+            hasTarget = true;
+            break;
+        case CommandType::BindShader: {
+            if (hasShader)
+                return false;
+            const QSSGBindShader &theBindShader = static_cast<const QSSGBindShader &>(*theCommand);
+            outStage.shaderPath = theBindShader.m_shaderPath;
+            outStage.shaderDefine = theBindShader.m_shaderDefine;
+            hasShader = true;
+        } break;
+        case CommandType::ApplyInstanceValue:
+            if (!hasShader || rendered)
+                return false;
+            break;
+        case CommandType::Render:
+            if (rendered || !hasShader || !hasTarget || static_cast<const QSSGRender &>(*theCommand).m_drawIndirect)
+                return false;
+            rendered = true;
+            break;
+        default:
+            // Intermediate buffers, blending, depth and constant values all
+            // need the pass of their own
+            return false;
+        }
+    }
+    if (!rendered)
+        return false;
+
+    outStage.properties.clear();
+    for (const QSSGRenderEffect::Property &theProperty : inEffect.properties) {
+        if (theProperty.shaderDataType == QSSGRenderShaderDataType::Texture2D
+            || theProperty.shaderDataType == QSSGRenderShaderDataType::Image2D
+            || theProperty.shaderDataType == QSSGRenderShaderDataType::DataBuffer)
+            return false;
+        outStage.properties.append(theProperty.name);
+    }
+    return true;
+}
+
+bool QSSGEffectChainCompiler::canFuse(const QSSGEffectChainStage &inStage, int inIndex)
+{
+    if (inIndex >= MaxStages)
+        return false;
+    const StageInfo &theInfo = stageInfo(inStage);
+    return theInfo.valid && (inIndex == 0 || theInfo.local);
+}
+
+QByteArray QSSGEffectChainCompiler::chainKey(const QVector<QSSGEffectChainStage> &inStages)
+{
+    QByteArray theKey;
+    for (const QSSGEffectChainStage &theStage : inStages) {
+        if (!theKey.isEmpty())
+            theKey.append('|');
+        theKey.append(theStage.shaderPath);
+        theKey.append('#');
+        theKey.append(theStage.shaderDefine);
+        for (const QByteArray &theProperty : theStage.properties) {
+            theKey.append(',');
+            theKey.append(theProperty);
+        }
+    }
+    return theKey;
+}
+
+QByteArray QSSGEffectChainCompiler::uniformName(const QByteArray &inName, int inIndex)
+{
+    if (isOneOf(s_sharedNames, inName))
+        return inName;
+    return inName + "_fused" + QByteArray::number(inIndex);
+}
+
+QSSGRef<QSSGRenderShaderProgram> QSSGEffectChainCompiler::compile(const QVector<QSSGEffectChainStage> &inStages)
+{
+    if (inStages.isEmpty())
+        return nullptr;
+
+    // The color a stage writes with colorOutput() stays in a variable that
+    // the next stage reads back with texture2D_0().
+    QByteArray theSource("#define NO_FRAG_MAIN\n"
+                         "#include \"effect.glsllib\"\n"
+                         "#ifdef FRAGMENT_SHADER\n"
+                         "vec4 fusedColor;\n"
+                         "vec4 fusedInput(vec2 uv)\n"
+                         "{\n"
+                         "    return fusedColor;\n"
+                         "}\n"
+                         "void fusedOutput(vec4 c)\n"
+                         "{\n"
+                         "    fusedColor = clamp(c, 0.0, c.a);\n"
+                         "}\n"
+                         "#endif\n");
+
+    for (int idx = 0, end = inStages.size(); idx < end; ++idx) {
+        const QSSGEffectChainStage &theStage = inStages.at(idx);
+        const StageInfo &theInfo = stageInfo(theStage);
+        if (!theInfo.valid || (idx > 0 && !theInfo.local))
+            return nullptr;
+
+        QVector<QByteArray> theMacros;
+        QVector<QByteArray> theRenames = theInfo.globals;
+        for (const QByteArray &theProperty : theStage.properties)
+            appendUnique(theRenames, theProperty);
+        for (const QByteArray &theName : qAsConst(theRenames)) {
+            if (!isOneOf(s_sharedNames, theName))
+                theMacros.append(theName + " " + uniformName(theName, idx));
+        }
+        theMacros.append(QByteArrayLiteral("colorOutput fusedOutput"));
+        if (idx > 0)
+            theMacros.append(QByteArrayLiteral("texture2D_0 fusedInput"));
+        if (!theStage.shaderDefine.isEmpty())
+            theMacros.append(theStage.shaderDefine);
+
+        // Only the first stage has a vertex shader part
+        if (idx > 0)
+            theSource.append("#ifdef FRAGMENT_SHADER\n");
+        for (const QByteArray &theMacro : qAsConst(theMacros)) {
+            theSource.append("#define ");
+            theSource.append(theMacro);
+            theSource.append('\n');
+        }
+        theSource.append(theInfo.source);
+        if (!theSource.endsWith('\n'))
+            theSource.append('\n');
+        for (const QByteArray &theMacro : qAsConst(theMacros)) {
+            const int theSpace = theMacro.indexOf(' ');
+            theSource.append("#undef ");
+            theSource.append(theSpace == -1 ? theMacro : theMacro.left(theSpace));
+            theSource.append('\n');
+        }
+        if (idx > 0)
+            theSource.append("#endif\n");
+    }
+
+    theSource.append("#ifdef VERTEX_SHADER\n"
+                     "void vert()\n"
+                     "{\n"
+                     "    ");
+    theSource.append(uniformName(QByteArrayLiteral("vert"), 0));
+    theSource.append("();\n"
+                     "}\n"
+                     "#endif\n"
+                     "#ifdef FRAGMENT_SHADER\n"
+                     "void main()\n"
+                     "{\n");
+    for (int idx = 0, end = inStages.size(); idx < end; ++idx) {
+        theSource.append("    ");
+        theSource.append(uniformName(QByteArrayLiteral("frag"), idx));
+        theSource.append("();\n");
+    }
+    theSource.append("    colorOutput(fusedColor);\n"
+                     "}\n"
+                     "#endif\n");
+
+    const QByteArray theKey = chainKey(inStages);
+    const QSSGRef<QSSGDynamicObjectSystem> &theDynamicSystem = m_context->dynamicObjectSystem();
+    // Unused functions are not stripped, the renames are invisible to the preprocessor
+    const QByteArray theProgramSource = theDynamicSystem->m_shaderLibrary.expand(theSource, theKey, false);
+    return theDynamicSystem->compileShader(QByteArrayLiteral("fused effect:") + theKey,
+                                           theProgramSource,
+                                           QByteArray(),
+                                           QByteArray(),
+                                           TShaderFeatureSet(),
+                                           QSSGDynamicShaderProgramFlags());
+}
+
+void QSSGEffectChainCompiler::invalidate()
+{
+    m_stages.clear();
+}
+
+const QSSGEffectChainCompiler::StageInfo &QSSGEffectChainCompiler::stageInfo(const QSSGEffectChainStage &inStage)
+{
+    auto theFound = m_stages.find(inStage.shaderPath);
+    if (theFound != m_stages.end())
+        return theFound.value();
+
+    StageInfo &theInfo = m_stages.insert(inStage.shaderPath, StageInfo()).value();
+    const QSSGRef<QSSGDynamicObjectSystem> &theDynamicSystem = m_context->dynamicObjectSystem();
+    const auto theShaderInfo = theDynamicSystem->m_shaderInfoMap.constFind(inStage.shaderPath);
+    if (theShaderInfo != theDynamicSystem->m_shaderInfoMap.constEnd()
+        && (theShaderInfo.value().m_hasGeomShader || theShaderInfo.value().m_isComputeShader))
+        return theInfo;
+    if (!theDynamicSystem->loadShaderLibraryFile(inStage.shaderPath, theInfo.source))
+        return theInfo;
+
+    const QSSGShaderLibraryFile theFile = QSSGShaderLibraryFile::parse(theInfo.source, inStage.shaderPath);
+    bool hasVert = false;
+    bool hasFrag = false;
+    bool local = true;
+    QVector<QByteArray> theVisited;
+    for (const QSSGShaderLibraryChunk &theChunk : theFile.chunks) {
+        if (theChunk.type == QSSGShaderLibraryChunk::Type::Include) {
+            if (theChunk.text != "effect.glsllib" && includesReadInput(theChunk.text, theVisited))
+                local = false;
+            continue;
+        }
+        if (theChunk.type == QSSGShaderLibraryChunk::Type::Function) {
+            // A shader with a main of its own can't share it
+            if (theChunk.name == "main")
+                return theInfo;
+            hasVert |= (theChunk.name == "vert");
+            hasFrag |= (theChunk.name == "frag");
+            appendUnique(theInfo.globals, theChunk.name);
+        }
+
+        const QVector<QByteArray> theTokens = tokensOf(theChunk.text);
+        for (int idx = 0, end = theTokens.size(); idx < end; ++idx) {
+            const QByteArray &theToken = theTokens.at(idx);
+            if (theToken == "gl_FragColor" || theToken == "gl_FragData" || theToken == "discard")
+                return theInfo;
+            if (theToken == "Texture0" || theToken == "varying") {
+                local = false;
+            } else if (theToken == "texture2D_0") {
+                const bool ownPixel = idx + 3 < end && theTokens.at(idx + 1) == "(" && theTokens.at(idx + 2) == "TexCoord"
+                        && theTokens.at(idx + 3) == ")";
+                if (!ownPixel)
+                    local = false;
+            }
+        }
+        if (theChunk.type == QSSGShaderLibraryChunk::Type::Text)
+            collectDeclarations(theTokens, theInfo.globals);
+    }
+
+    theInfo.valid = hasVert && hasFrag;
+    theInfo.local = local;
+    return theInfo;
+}
+
+bool QSSGEffectChainCompiler::includesReadInput(const QByteArray &inPath, QVector<QByteArray> &ioVisited)
+{
+    if (ioVisited.contains(inPath))
+        return false;
+    ioVisited.append(inPath);
+
+    QByteArray theSource;
+    if (!m_context->dynamicObjectSystem()->loadShaderLibraryFile(inPath, theSource))
+        return true;
+    const QSSGShaderLibraryFile theFile = QSSGShaderLibraryFile::parse(theSource, inPath);
+    for (const QSSGShaderLibraryChunk &theChunk : theFile.chunks) {
+        if (theChunk.type == QSSGShaderLibraryChunk::Type::Include) {
+            if (theChunk.text != "effect.glsllib" && includesReadInput(theChunk.text, ioVisited))
+                return true;
+        } else if (std::binary_search(theChunk.identifiers.cbegin(), theChunk.identifiers.cend(), QByteArrayLiteral("Texture0"))
+                   || std::binary_search(theChunk.identifiers.cbegin(), theChunk.identifiers.cend(), QByteArrayLiteral("texture2D_0"))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QT_END_NAMESPACE
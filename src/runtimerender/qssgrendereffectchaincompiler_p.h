@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSG_RENDER_EFFECT_CHAIN_COMPILER_H
+#define QSSG_RENDER_EFFECT_CHAIN_COMPILER_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderdynamicobjectsystem_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+struct QSSGRenderEffect;
+class QSSGRenderContextInterface;
+class QSSGRenderShaderProgram;
+
+// The shader a single pass effect renders with
+struct QSSGEffectChainStage
+{
+    QByteArray shaderPath;
+    QByteArray shaderDefine;
+    // Names of the effect properties, set as uniforms of the shader
+    QVector<QByteArray> properties;
+};
+
+// Folds consecutive per-pixel effects into one shader, so a chain of color
+// adjustments costs one fullscreen pass instead of one pass and one
+// intermediate texture per effect.
+//
+// An effect can join a chain when it renders a single pass straight into
+// the effect target and, when it is not the first of the chain, only reads
+// its input at its own pixel, that is through texture2D_0(TexCoord). The
+// check is lexical and done on the comment free source, anything it can't
+// prove local (other uses of the input, varyings, discard, writing
+// gl_FragColor directly) keeps the effect in a pass of its own.
+//
+// In the generated shader every stage keeps its source as is. The names it
+// declares at global scope and its properties are renamed per stage with
+// #define, its colorOutput() writes to a variable that the next stage reads
+// back as its input, and main() calls the frag() of each stage in order.
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGEffectChainCompiler
+{
+    Q_DISABLE_COPY(QSSGEffectChainCompiler)
+public:
+    enum { MaxStages = 8 };
+
+    explicit QSSGEffectChainCompiler(QSSGRenderContextInterface *inContext);
+
+    // Returns true and the shader of inEffect if its commands are those of a
+    // single pass rendering to the effect target, without textures of its own.
+    static bool chainStage(const QSSGRenderEffect &inEffect, QSSGEffectChainStage &outStage);
+
+    // Returns true if the stage can be at inIndex in a chain
+    bool canFuse(const QSSGEffectChainStage &inStage, int inIndex);
+
+    // Returns a key identifying the fused shader of inStages
+    static QByteArray chainKey(const QVector<QSSGEffectChainStage> &inStages);
+
+    // Name of the uniform of property inName of the stage at inIndex
+    static QByteArray uniformName(const QByteArray &inName, int inIndex);
+
+    // Generate and compile the shader running all the stages, null on failure.
+    QSSGRef<QSSGRenderShaderProgram> compile(const QVector<QSSGEffectChainStage> &inStages);
+
+    // Forget the analysis of all sources, for when shader data changes
+    void invalidate();
+
+private:
+    struct StageInfo
+    {
+        bool valid = false;
+        // Whether the stage may come after another one
+        bool local = false;
+        QByteArray source;
+        // Names declared at global scope, renamed per stage
+        QVector<QByteArray> globals;
+    };
+
+    const StageInfo &stageInfo(const QSSGEffectChainStage &inStage);
+    bool includesReadInput(const QByteArray &inPath, QVector<QByteArray> &ioVisited);
+
+    QSSGRenderContextInterface *m_context;
+    QHash<QByteArray, StageInfo> m_stages; // by shader path
+};
+
+QT_END_NAMESPACE
+
+#endif
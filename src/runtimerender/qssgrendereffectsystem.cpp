@@ -411,7 +411,8 @@ QSSGRenderEffect::~QSSGRenderEffect()
 
 }
 
-QSSGEffectSystem::QSSGEffectSystem(QSSGRenderContextInterface *inContext) : m_context(inContext)
+QSSGEffectSystem::QSSGEffectSystem(QSSGRenderContextInterface *inContext)
+    : m_context(inContext), m_chainCompiler(inContext)
 {
     init();
 }
@@ -1590,6 +1591,94 @@ bool QSSGEffectSystem::renderEffect(QSSGEffectRenderArgument inRenderArgument, Q
     return true;
 }
 
+QSSGRef<QSSGRenderTexture2D> QSSGEffectSystem::renderEffectChain(QSSGEffectRenderArgument inRenderArgument, QSSGRenderEffect *&outLastEffect)
+{
+    outLastEffect = inRenderArgument.m_effect;
+
+    QVector<QSSGRenderEffect *> theEffects;
+    QVector<QSSGEffectChainStage> theStages;
+    for (QSSGRenderEffect *theEffect = inRenderArgument.m_effect; theEffect && theStages.size() < QSSGEffectChainCompiler::MaxStages;
+         theEffect = theEffect->m_nextEffect) {
+        // Inactive effects are skipped by the layer anyway
+        if (!theEffect->flags.testFlag(QSSGRenderEffect::Flag::Active))
+            continue;
+        QSSGEffectChainStage theStage;
+        if (!getEffectClass(theEffect->className) || !QSSGEffectChainCompiler::chainStage(*theEffect, theStage)
+            || !m_chainCompiler.canFuse(theStage, theStages.size()))
+            break;
+        theEffects.push_back(theEffect);
+        theStages.push_back(theStage);
+    }
+
+    if (theStages.size() < 2)
+        return renderEffect(inRenderArgument);
+
+    const QByteArray theKey = QSSGEffectChainCompiler::chainKey(theStages);
+    auto theShader = m_fusedShaderMap.find(theKey);
+    if (theShader == m_fusedShaderMap.end()) {
+        QSSGRef<QSSGRenderShaderProgram> theProgram = m_chainCompiler.compile(theStages);
+        if (!theProgram)
+            qCWarning(PERF_WARNING, "Effects %s can't be fused, rendering them separately", theKey.constData());
+        theShader = m_fusedShaderMap.insert(theKey, theProgram ? QSSGRef<QSSGEffectShader>(new QSSGEffectShader(theProgram)) : QSSGRef<QSSGEffectShader>());
+    }
+    if (!theShader.value())
+        return renderEffect(inRenderArgument);
+
+    QMatrix4x4 theMVP;
+    QSSGRenderCamera::setupOrthographicCameraForOffscreenRender(*inRenderArgument.m_colorBuffer, theMVP);
+    const auto &theContext(m_context->renderContext());
+    const auto &theManager(m_context->resourceManager());
+    QSSGRenderContextScopedProperty<QSSGRef<QSSGRenderFrameBuffer>> __framebuffer(*theContext,
+                                                                                        &QSSGRenderContext::renderTarget,
+                                                                                        &QSSGRenderContext::setRenderTarget);
+    QSSGTextureDetails theDetails(inRenderArgument.m_colorBuffer->textureDetails());
+    quint32 theFinalWidth = QSSGRendererUtil::nextMultipleOf4((quint32)(theDetails.width));
+    quint32 theFinalHeight = QSSGRendererUtil::nextMultipleOf4((quint32)(theDetails.height));
+    auto theBuffer = theManager->allocateFrameBuffer();
+    auto theTargetTexture = theManager->allocateTexture2D(theFinalWidth, theFinalHeight, QSSGRenderTextureFormat::RGBA8);
+    theBuffer->attach(QSSGRenderFrameBufferAttachment::Color0, theTargetTexture);
+    QSSGRenderContextScopedProperty<QRect> __viewport(*theContext,
+                                                        &QSSGRenderContext::viewport,
+                                                        &QSSGRenderContext::setViewport,
+                                                        QRect(0, 0, theFinalWidth, theFinalHeight));
+    QSSGRenderContextScopedProperty<bool> __scissorEnable(*theContext,
+                                                            &QSSGRenderContext::isScissorTestEnabled,
+                                                            &QSSGRenderContext::setScissorTestEnabled,
+                                                            false);
+    theContext->setBlendingEnabled(false);
+    theContext->setCullingEnabled(false);
+    theContext->setDepthTestEnabled(false);
+    theContext->setDepthWriteEnabled(false);
+
+    const QSSGRef<QSSGEffectShader> &theEffectShader = theShader.value();
+    theContext->setActiveShader(theEffectShader->m_shader);
+    for (int idx = 0, end = theEffects.size(); idx < end; ++idx) {
+        QSSGRenderEffect *theEffect = theEffects.at(idx);
+        for (const QSSGRenderEffect::Property &theProperty : qAsConst(theEffect->properties))
+            doApplyInstanceValue(theEffect,
+                                 QSSGEffectChainCompiler::uniformName(theProperty.name, idx),
+                                 theProperty.value,
+                                 theProperty.shaderDataType,
+                                 theEffectShader->m_shader);
+    }
+
+    QVector2D theDestSize(float(theFinalWidth), float(theFinalHeight));
+    renderPass(*theEffectShader,
+               theMVP,
+               QSSGEffectTextureData(inRenderArgument.m_colorBuffer, false),
+               theBuffer,
+               theDestSize,
+               inRenderArgument.m_cameraClipRange,
+               nullptr,
+               QSSGOption<QSSGDepthStencil>(),
+               false);
+
+    theBuffer->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
+    theManager->release(theBuffer);
+    outLastEffect = theEffects.back();
+    return theTargetTexture;
+}
+
 void QSSGEffectSystem::releaseEffectContext(QSSGEffectContext *inContext)
 {
     if (inContext == nullptr)
@@ -1621,6 +1710,8 @@ void QSSGEffectSystem::resetEffectFrameData(QSSGEffectContext &inContext)
 void QSSGEffectSystem::setShaderData(const QByteArray &path, const char *data, const char *inShaderType, const char *inShaderVersion, bool inHasGeomShader, bool inIsComputeShader)
 {
     m_context->dynamicObjectSystem()->setShaderData(path, data, inShaderType, inShaderVersion, inHasGeomShader, inIsComputeShader);
+    m_chainCompiler.invalidate();
+    m_fusedShaderMap.clear();
 }
 
 void QSSGEffectSystem::init()
@@ -45,6 +45,7 @@
 #include <QtQuick3DRender/private/qssgrenderbasetypes_p.h>
 #include <QtQuick3DUtils/private/qssgoption_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderdynamicobjectsystem_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendereffectchaincompiler_p.h>
 #include <QtGui/QVector2D>
 
 QT_BEGIN_NAMESPACE
@@ -131,6 +132,9 @@ class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGEffectSystem
     QString m_textureStringBuilder;
     QString m_textureStringBuilder2;
     TShaderMap m_shaderMap;
+    QSSGEffectChainCompiler m_chainCompiler;
+    // Shaders of fused effect chains, null for chains that failed to compile
+    QHash<QByteArray, QSSGRef<QSSGEffectShader>> m_fusedShaderMap;
     QSSGRef<QSSGRenderDepthStencilState> m_defaultStencilState;
     QVector<QSSGRef<QSSGRenderDepthStencilState>> m_depthStencilStates;
 
@@ -285,6 +289,11 @@ public:
     // enabling blending when rendering to the target
     bool renderEffect(QSSGEffectRenderArgument inRenderArgument, QMatrix4x4 &inMVP, bool inEnableBlendWhenRenderToTarget);
 
+    // Render the effect along with the active effects following it that can run in the same
+    // pass, see QSSGEffectChainCompiler. outLastEffect is set to the last effect rendered,
+    // the texture returned is released by the caller as with renderEffect.
+    QSSGRef<QSSGRenderTexture2D> renderEffectChain(QSSGEffectRenderArgument inRenderArgument, QSSGRenderEffect *&outLastEffect);
+
     // Calling release effect context with no context results in no problems.
     void releaseEffectContext(QSSGEffectContext *inContext);
 
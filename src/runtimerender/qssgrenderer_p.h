@@ -108,6 +108,11 @@ public:
     virtual void beginFrame() = 0;
     virtual void endFrame() = 0;
 
+    // True while material shaders are still being compiled in the background and
+    // some objects were drawn with a fallback or skipped. Render another frame to
+    // pick them up.
+    virtual bool hasPendingShaders() const = 0;
+
     // Setup the vertex and index buffers (but not shader state)
     // and render the quad.  The quad is setup so that its edges
     // go from -1,1 in x,y and its UV coordinates will map naturally
@@ -148,6 +153,26 @@ public:
                                         bool inPickSiblings = true,
                                         bool inPickEverything = false,
                                         const QSSGRenderInstanceId id = nullptr) = 0;
+    // Picks many rays against the objects inLayer rendered in the last frame. The per object
+    // data is set up once and shared by all rays, and the rays are spread over the thread pool.
+    // Every ray returns all of its hits, sub presentations and layer siblings are not picked.
+    virtual QSSGRenderPickBatchResult pickBatch(QSSGRenderLayer &inLayer,
+                                                const QVector2D &inViewportDimensions,
+                                                const QVector<QVector2D> &inMouseCoords,
+                                                bool inPickEverything = false,
+                                                const QSSGRenderInstanceId id = nullptr) = 0;
+    // Rays in world space
+    virtual QSSGRenderPickBatchResult pickBatch(QSSGRenderLayer &inLayer,
+                                                const QVector<QSSGRenderRay> &inRays,
+                                                bool inPickEverything = false,
+                                                const QSSGRenderInstanceId id = nullptr) = 0;
+    // All objects whose bounds intersect the part of the view frustum behind inRect, for
+    // rubber band selection. inRect is in the same coordinates as the mouse coordinates of pick().
+    virtual QVector<const QSSGRenderGraphObject *> pickFrustum(QSSGRenderLayer &inLayer,
+                                                               const QVector2D &inViewportDimensions,
+                                                               const QRectF &inRect,
+                                                               bool inPickEverything = false,
+                                                               const QSSGRenderInstanceId id = nullptr) = 0;
 
     // Return the relative hit position, in UV space, of a mouse pick against this object.
     // We need the node in order to figure out which layer rendered this object.
@@ -45,6 +45,8 @@
 #include <QtGui/QVector2D>
 #include <QtGui/QMatrix4x4>
 
+#include <QtCore/QVector>
+
 #include <QtQuick3DUtils/private/qssgdataref_p.h>
 
 #include <QtQuick3DRender/private/qssgrenderbasetypes_p.h>
@@ -92,6 +94,18 @@ struct QSSGRenderPickResult
 
 Q_STATIC_ASSERT(std::is_trivially_destructible<QSSGRenderPickResult>::value);
 
+// The hits of many rays picked at once. The hits of ray i are hits[rayOffsets[i]] up to
+// hits[rayOffsets[i + 1]], sorted nearest to furthest with one hit per object.
+struct QSSGRenderPickBatchResult
+{
+    QVector<QSSGRenderPickResult> hits;
+    QVector<qint32> rayOffsets;
+
+    qint32 rayCount() const { return qMax(rayOffsets.size() - 1, 0); }
+    qint32 hitCount(qint32 inRay) const { return rayOffsets.at(inRay + 1) - rayOffsets.at(inRay); }
+    const QSSGRenderPickResult &hit(qint32 inRay, qint32 inIndex) const { return hits.at(rayOffsets.at(inRay) + inIndex); }
+};
+
 class QSSGGraphObjectPickQueryInterface
 {
 protected:
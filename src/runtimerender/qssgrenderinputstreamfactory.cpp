@@ -30,14 +30,16 @@
 
 #include "qssgrenderinputstreamfactory_p.h"
 
+#include <QtQuick3DRuntimeRender/private/qssgrenderassetarchive_p.h>
+
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
+#include <QtCore/QBuffer>
 #include <QtCore/QDir>
 #include <QtCore/QDirIterator>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QUrl>
-#include <QtCore/QMutexLocker>
 
 #include <limits>
 
@@ -55,6 +57,20 @@ private:
     QString m_path;
 };
 
+// Reads an archive entry in place, keeping the archive mapped meanwhile
+class QSSGArchiveStream : public QBuffer
+{
+public:
+    QSSGArchiveStream(const QSharedPointer<const QSSGAssetArchive> &inArchive, const QByteArray &inData)
+        : m_archive(inArchive)
+    {
+        setData(inData);
+    }
+    ~QSSGArchiveStream() override = default;
+
+private:
+    QSharedPointer<const QSSGAssetArchive> m_archive;
+};
 
 QString normalizePathForQtUsage(const QString &path)
 {
@@ -70,6 +86,13 @@ QString normalizePathForQtUsage(const QString &path)
 
 const QString Q3DSTUDIO_TAG = QStringLiteral("qt3dstudio");
 
+void reportMissingFile(const QString &inFilename)
+{
+    // Print extensive debugging information.
+    qCritical("Failed to find file: %s", inFilename.toLatin1().data());
+    qCritical("Searched path: %s", QDir::searchPaths(Q3DSTUDIO_TAG).join(',').toLatin1().constData());
+}
+
 }
 
 QSSGInputStreamFactory::~QSSGInputStreamFactory() {}
@@ -79,11 +102,14 @@ QSSGInputStreamFactory::QSSGInputStreamFactory()
     // Add the top-level qrc directory
     if (!QDir::searchPaths(Q3DSTUDIO_TAG).contains(QLatin1String(":/")))
         QDir::addSearchPath(Q3DSTUDIO_TAG, QStringLiteral(":/"));
+
+    const QString archives = QString::fromLocal8Bit(qgetenv("QUICK3D_ASSET_ARCHIVES"));
+    for (const QString &archive : archives.split(QDir::listSeparator(), QString::SkipEmptyParts))
+        addArchive(archive);
 }
 
 void QSSGInputStreamFactory::addSearchDirectory(const QString &inDirectory)
 {
-    QMutexLocker factoryLocker(&m_mutex);
     QString localDir = normalizePathForQtUsage(inDirectory);
     QDir directory(localDir);
     if (!directory.exists()) {
@@ -91,43 +117,135 @@ void QSSGInputStreamFactory::addSearchDirectory(const QString &inDirectory)
         return;
     }
 
-    if (!QDir::searchPaths(Q3DSTUDIO_TAG).contains(localDir))
+    if (!QDir::searchPaths(Q3DSTUDIO_TAG).contains(localDir)) {
         QDir::addSearchPath(Q3DSTUDIO_TAG, localDir);
+        // Files that were not found may be in the new directory
+        invalidatePathCache();
+    }
+}
+
+bool QSSGInputStreamFactory::addArchive(const QString &inArchiveFile)
+{
+    QSharedPointer<QSSGAssetArchive> archive(new QSSGAssetArchive(inArchiveFile));
+    if (!archive->open()) {
+        qCritical("Failed to open asset archive %s: %s", qPrintable(inArchiveFile), qPrintable(archive->errorString()));
+        return false;
+    }
+    QWriteLocker locker(&m_archiveLock);
+    m_archives.append(archive);
+    m_archiveCount.store(m_archives.size());
+    return true;
 }
 
 QSharedPointer<QIODevice> QSSGInputStreamFactory::getStreamForFile(const QString &inFilename, bool inQuiet)
 {
-    QMutexLocker factoryLocker(&m_mutex);
-    QString localFile = normalizePathForQtUsage(inFilename);
-    QFileInfo fileInfo = QFileInfo(localFile);
-    QIODevice *inputStream = nullptr;
-    // Try to match the file with the search paths
-    if (!fileInfo.exists())
-        fileInfo.setFile(QStringLiteral("qt3dstudio:") + localFile);
+    const QString localFile = normalizePathForQtUsage(inFilename);
+    if (m_archiveCount.load()) {
+        QSharedPointer<QIODevice> stream = getStreamFromArchives(localFile);
+        if (stream)
+            return stream;
+    }
 
-    if (fileInfo.exists()) {
-        QSSGInputStream *file = new QSSGInputStream(fileInfo.absoluteFilePath());
-        if (file->open(QIODevice::ReadOnly))
+    QIODevice *inputStream = nullptr;
+    const QString path = resolvePath(localFile);
+    if (!path.isEmpty()) {
+        QSSGInputStream *file = new QSSGInputStream(path);
+        if (file->open(QIODevice::ReadOnly)) {
             inputStream = file;
+        } else {
+            delete file;
+            // Resolve again next time, the file may have moved
+            invalidatePathCache(inFilename);
+        }
     }
 
-    if (!inputStream && !inQuiet) {
-        // Print extensive debugging information.
-        qCritical("Failed to find file: %s", inFilename.toLatin1().data());
-        qCritical("Searched path: %s", QDir::searchPaths(Q3DSTUDIO_TAG).join(',').toLatin1().constData());
-    }
+    if (!inputStream && !inQuiet)
+        reportMissingFile(inFilename);
     return QSharedPointer<QIODevice>(inputStream);
 }
 
 bool QSSGInputStreamFactory::getPathForFile(const QString &inFilename, QString &outFile, bool inQuiet)
 {
-    QSharedPointer<QIODevice> theStream = getStreamForFile(inFilename, inQuiet);
-    if (theStream) {
-        QSSGInputStream *theRealStream = static_cast<QSSGInputStream *>(theStream.data());
-        outFile = theRealStream->path();
+    const QString localFile = normalizePathForQtUsage(inFilename);
+    if (m_archiveCount.load() && getStreamFromArchives(localFile)) {
+        // There is no file to point to, entries are known by their name
+        outFile = localFile;
         return true;
     }
-    return false;
+
+    const QString path = resolvePath(localFile);
+    if (path.isEmpty()) {
+        if (!inQuiet)
+            reportMissingFile(inFilename);
+        return false;
+    }
+    outFile = path;
+    return true;
+}
+
+void QSSGInputStreamFactory::invalidatePathCache(const QString &inFilename)
+{
+    if (!inFilename.isEmpty()) {
+        const QString localFile = normalizePathForQtUsage(inFilename);
+        PathCacheShard &shard = pathCacheShard(localFile);
+        QWriteLocker locker(&shard.lock);
+        shard.paths.remove(localFile);
+        return;
+    }
+
+    // Lookups that are resolving right now must not store their result
+    m_pathCacheGeneration.ref();
+    for (PathCacheShard &shard : m_pathCache) {
+        QWriteLocker locker(&shard.lock);
+        shard.paths.clear();
+    }
+}
+
+QString QSSGInputStreamFactory::resolvePath(const QString &inLocalFile)
+{
+    PathCacheShard &shard = pathCacheShard(inLocalFile);
+    {
+        QReadLocker locker(&shard.lock);
+        auto it = shard.paths.constFind(inLocalFile);
+        if (it != shard.paths.constEnd())
+            return it.value();
+    }
+
+    const int generation = m_pathCacheGeneration.load();
+    QFileInfo fileInfo = QFileInfo(inLocalFile);
+    // Try to match the file with the search paths
+    if (!fileInfo.exists())
+        fileInfo.setFile(QStringLiteral("qt3dstudio:") + inLocalFile);
+    const QString path = fileInfo.exists() ? fileInfo.absoluteFilePath() : QString();
+
+    QWriteLocker locker(&shard.lock);
+    if (m_pathCacheGeneration.load() == generation)
+        shard.paths.insert(inLocalFile, path);
+    return path;
+}
+
+QSharedPointer<QIODevice> QSSGInputStreamFactory::getStreamFromArchives(const QString &inLocalFile)
+{
+    const QByteArray name = inLocalFile.toUtf8();
+    const QByteArray resourceName = name.startsWith(":/") ? name.mid(2) : QByteArray();
+
+    QReadLocker locker(&m_archiveLock);
+    for (const auto &archive : qAsConst(m_archives)) {
+        QByteArray data = archive->entry(name);
+        if (data.isNull() && !resourceName.isEmpty())
+            data = archive->entry(resourceName);
+        if (!data.isNull()) {
+            QSSGArchiveStream *stream = new QSSGArchiveStream(archive, data);
+            stream->open(QIODevice::ReadOnly);
+            return QSharedPointer<QIODevice>(stream);
+        }
+    }
+    return QSharedPointer<QIODevice>();
+}
+
+QSSGInputStreamFactory::PathCacheShard &QSSGInputStreamFactory::pathCacheShard(const QString &inLocalFile)
+{
+    return m_pathCache[qHash(inLocalFile) % PathCacheShardCount];
 }
 
 QT_END_NAMESPACE
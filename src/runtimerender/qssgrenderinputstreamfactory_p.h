@@ -47,26 +47,63 @@
 #include <QtQuick3DUtils/private/qssgdataref_p.h>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QIODevice>
-#include <QtCore/qmutex.h>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
+class QSSGAssetArchive;
+
 // This class is threadsafe.
+//
+// Resolved paths are cached, including files that were not found, so repeated
+// opens do not stat the file system. The cache is split into shards with their
+// own lock to keep concurrent loads from serializing. Adding a search
+// directory drops the cache, invalidatePathCache() can be used when files
+// appear or go away behind the factory's back.
+//
+// Archives added with addArchive(), or listed in QUICK3D_ASSET_ARCHIVES, are
+// searched before the file system.
 class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGInputStreamFactory
 {
 public:
     QAtomicInt ref;
-    QMutex m_mutex;
 
     QSSGInputStreamFactory();
 
     ~QSSGInputStreamFactory();
     // These directories must have a '/' on them
     void addSearchDirectory(const QString &inDirectory);
+    // Entries of the archive are found by their name, a path relative to the
+    // directory the archive was packed from. Resource paths (":/a/b") also
+    // match the entry without the ":/" prefix.
+    bool addArchive(const QString &inArchiveFile);
     QSharedPointer<QIODevice> getStreamForFile(const QString &inFilename, bool inQuiet = false);
     // Return a path for this file.  Returns true if GetStreamForFile would return a valid
     // stream.
     // else returns false
     bool getPathForFile(const QString &inFilename, QString &outFile, bool inQuiet = false);
+
+    // Forget the resolved path of a file, or of all files if inFilename is empty
+    void invalidatePathCache(const QString &inFilename = QString());
+
+private:
+    enum { PathCacheShardCount = 16 };
+    struct PathCacheShard
+    {
+        QReadWriteLock lock;
+        QHash<QString, QString> paths; // empty if the file was not found
+    };
+
+    QString resolvePath(const QString &inLocalFile);
+    QSharedPointer<QIODevice> getStreamFromArchives(const QString &inLocalFile);
+    PathCacheShard &pathCacheShard(const QString &inLocalFile);
+
+    PathCacheShard m_pathCache[PathCacheShardCount];
+    QReadWriteLock m_archiveLock;
+    QAtomicInt m_pathCacheGeneration;
+    QAtomicInt m_archiveCount;
+    QVector<QSharedPointer<const QSSGAssetArchive>> m_archives;
 };
 QT_END_NAMESPACE
 
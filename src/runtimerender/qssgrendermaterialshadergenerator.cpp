@@ -40,6 +40,12 @@ QSSGMaterialShaderGeneratorInterface::QSSGMaterialShaderGeneratorInterface(QSSGR
 
 {}
 
+QSSGMaterialShaderGeneratorInterface::QSSGMaterialShaderGeneratorInterface(QSSGRenderContextInterface *renderContext,
+                                                                           const QSSGRef<QSSGShaderProgramGeneratorInterface> &programGenerator)
+    : m_renderContext(renderContext),
+      m_programGenerator(programGenerator)
+{}
+
 QSSGMaterialShaderGeneratorInterface::~QSSGMaterialShaderGeneratorInterface() {}
 
 QT_END_NAMESPACE
@@ -99,6 +99,7 @@ class QSSGShaderProgramGeneratorInterface;
 class QSSGDefaultMaterialVertexPipelineInterface;
 struct QSSGShaderGeneratorGeneratedShader;
 class QSSGRenderConstantBuffer;
+class QSSGRenderClusteredLights;
 
 struct QSSGLayerGlobalRenderProperties
 {
@@ -118,6 +119,8 @@ struct QSSGLayerGlobalRenderProperties
     float probe2Pos;
     float probe2Fade;
     float probeFOV;
+    // Point lights evaluated per cluster instead of from the lights list, may be null
+    const QSSGRenderClusteredLights *clusteredLights;
 };
 
 class QSSGMaterialShaderGeneratorInterface
@@ -144,6 +147,9 @@ protected:
 
 protected:
     QSSGMaterialShaderGeneratorInterface(QSSGRenderContextInterface *renderContext);
+    // Generate with a program generator of its own instead of the context's one
+    QSSGMaterialShaderGeneratorInterface(QSSGRenderContextInterface *renderContext,
+                                         const QSSGRef<QSSGShaderProgramGeneratorInterface> &programGenerator);
 public:
     virtual ~QSSGMaterialShaderGeneratorInterface();
     struct ImageVariableNames
@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtQuick3DRuntimeRender/private/qssgrendernodehierarchy_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernode_p.h>
+
+QT_BEGIN_NAMESPACE
+
+bool QSSGRenderNodeHierarchy::needsRebuild(const QSSGRenderNode &inRoot) const
+{
+    if (m_root != &inRoot || m_rootVersion != inRoot.subtreeVersion)
+        return true;
+    // The children of the root did not change, so the top level nodes are still valid
+    for (qint32 idx = 0, end = m_topLevelVersions.size(); idx < end; ++idx) {
+        if (m_nodes.at(idx)->subtreeVersion != m_topLevelVersions.at(idx))
+            return true;
+    }
+    return false;
+}
+
+void QSSGRenderNodeHierarchy::build(QSSGRenderNode &inRoot)
+{
+    clear();
+    m_root = &inRoot;
+    m_rootVersion = inRoot.subtreeVersion;
+
+    // Breadth first, so every level is a contiguous range following the range of its parents.
+    // The children of a node are contiguous as well, their range is kept for the depth first
+    // order below.
+    QVector<qint32> childBegins;
+    QVector<qint32> childEnds;
+    for (QSSGRenderNode *child = inRoot.firstChild; child; child = child->nextSibling) {
+        append(child, -1);
+        m_topLevelVersions.append(child->subtreeVersion);
+    }
+    qint32 levelBegin = 0;
+    while (levelBegin < m_nodes.size()) {
+        const qint32 levelEnd = m_nodes.size();
+        m_levelEnds.append(levelEnd);
+        for (qint32 idx = levelBegin; idx < levelEnd; ++idx) {
+            childBegins.append(m_nodes.size());
+            for (QSSGRenderNode *child = m_nodes.at(idx)->firstChild; child; child = child->nextSibling)
+                append(child, idx);
+            childEnds.append(m_nodes.size());
+        }
+        levelBegin = levelEnd;
+    }
+
+    const qint32 count = m_nodes.size();
+    m_localTransforms.resize(count);
+    m_globalTransforms.resize(count);
+    m_localOpacities.fill(1.0f, count);
+    m_globalOpacities.fill(1.0f, count);
+    m_states.fill(Dirty, count);
+
+    // Depth first order without recursion, deep hierarchies would overflow the stack
+    m_depthFirstOrder.reserve(count);
+    QVector<qint32> stack;
+    for (qint32 idx = m_topLevelVersions.size() - 1; idx >= 0; --idx)
+        stack.append(idx);
+    while (!stack.isEmpty()) {
+        const qint32 idx = stack.takeLast();
+        m_depthFirstOrder.append(idx);
+        for (qint32 childIdx = childEnds.at(idx) - 1; childIdx >= childBegins.at(idx); --childIdx)
+            stack.append(childIdx);
+    }
+}
+
+void QSSGRenderNodeHierarchy::clear()
+{
+    m_root = nullptr;
+    m_rootVersion = 0;
+    m_topLevelVersions.clear();
+    m_nodes.clear();
+    m_parents.clear();
+    m_levelEnds.clear();
+    m_depthFirstOrder.clear();
+    m_localTransforms.clear();
+    m_globalTransforms.clear();
+    m_localOpacities.clear();
+    m_globalOpacities.clear();
+    m_states.clear();
+}
+
+void QSSGRenderNodeHierarchy::append(QSSGRenderNode *inNode, qint32 inParent)
+{
+    m_nodes.append(inNode);
+    m_parents.append(inParent);
+}
+
+bool QSSGRenderNodeHierarchy::update(const QSSGRef<QSSGAbstractThreadPool> &inThreadPool)
+{
+    const qint32 count = m_nodes.size();
+    if (count == 0)
+        return false;
+
+    bool wasDirty = false;
+    runPass(Pass::Pull, 0, count, inThreadPool, &wasDirty);
+
+    // The children of the root may still have a parent outside of the hierarchy
+    for (qint32 idx = 0, end = m_levelEnds.first(); idx < end; ++idx) {
+        QSSGRenderNode *parent = m_nodes.at(idx)->parent;
+        if (parent && parent->flags.testFlag(QSSGRenderNode::Flag::Dirty)) {
+            parent->calculateGlobalVariables();
+            m_states[idx] |= Dirty;
+            wasDirty = true;
+        }
+    }
+    if (!wasDirty)
+        return false;
+
+    // A level only reads the levels before it, so each level can be split over the pool
+    qint32 levelBegin = 0;
+    for (const qint32 levelEnd : qAsConst(m_levelEnds)) {
+        runPass(Pass::Sweep, levelBegin, levelEnd, inThreadPool);
+        levelBegin = levelEnd;
+    }
+
+    bool wasVisible = false;
+    runPass(Pass::Push, 0, count, inThreadPool, &wasVisible);
+    return wasVisible;
+}
+
+void QSSGRenderNodeHierarchy::runPass(Pass inPass,
+                                      qint32 inBegin,
+                                      qint32 inEnd,
+                                      const QSSGRef<QSSGAbstractThreadPool> &inThreadPool,
+                                      bool *outResult)
+{
+    bool result = false;
+    if (inThreadPool && inEnd - inBegin >= ParallelNodeThreshold) {
+        QAtomicInt anyResult(0);
+        inThreadPool->parallelFor(inEnd - inBegin, ParallelGrainSize, [&](qint32 inRangeBegin, qint32 inRangeEnd) {
+            if (processRange(inPass, inBegin + inRangeBegin, inBegin + inRangeEnd))
+                anyResult.testAndSetRelaxed(0, 1);
+        });
+        result = anyResult.load() != 0;
+    } else {
+        result = processRange(inPass, inBegin, inEnd);
+    }
+    if (outResult)
+        *outResult = result;
+}
+
+bool QSSGRenderNodeHierarchy::processRange(Pass inPass, qint32 inBegin, qint32 inEnd)
+{
+    switch (inPass) {
+    case Pass::Pull:
+        return pull(inBegin, inEnd);
+    case Pass::Sweep:
+        sweep(inBegin, inEnd);
+        break;
+    case Pass::Push:
+        return push(inBegin, inEnd);
+    }
+    return false;
+}
+
+bool QSSGRenderNodeHierarchy::pull(qint32 inBegin, qint32 inEnd)
+{
+    bool wasDirty = false;
+    for (qint32 idx = inBegin; idx < inEnd; ++idx) {
+        QSSGRenderNode *node = m_nodes.at(idx);
+        if (!(m_states.at(idx) & Dirty) && !node->flags.testFlag(QSSGRenderNode::Flag::Dirty))
+            continue;
+        if (node->flags.testFlag(QSSGRenderNode::Flag::TransformDirty))
+            node->calculateLocalTransform();
+        m_localTransforms[idx] = node->localTransform;
+        m_localOpacities[idx] = node->localOpacity;
+        quint8 state = Dirty;
+        if (node->flags.testFlag(QSSGRenderNode::Flag::Active))
+            state |= Active;
+        if (node->flags.testFlag(QSSGRenderNode::Flag::LocallyPickable))
+            state |= LocallyPickable;
+        if (node->flags.testFlag(QSSGRenderNode::Flag::IgnoreParentTransform))
+            state |= IgnoreParentTransform;
+        m_states[idx] = state;
+        wasDirty = true;
+    }
+    return wasDirty;
+}
+
+void QSSGRenderNodeHierarchy::sweep(qint32 inBegin, qint32 inEnd)
+{
+    const qint32 *parents = m_parents.constData();
+    const QMatrix4x4 *localTransforms = m_localTransforms.constData();
+    const float *localOpacities = m_localOpacities.constData();
+    QMatrix4x4 *globalTransforms = m_globalTransforms.data();
+    float *globalOpacities = m_globalOpacities.data();
+    quint8 *states = m_states.data();
+
+    for (qint32 idx = inBegin; idx < inEnd; ++idx) {
+        const qint32 parentIdx = parents[idx];
+        const bool parentUpdated = parentIdx >= 0 && (states[parentIdx] & Dirty);
+        quint8 state = states[idx];
+        if (!(state & Dirty) && !parentUpdated)
+            continue;
+
+        const QMatrix4x4 &local = localTransforms[idx];
+        const bool ignoreParentTransform = state & IgnoreParentTransform;
+        float opacity = localOpacities[idx];
+        bool active = state & Active;
+        bool pickable = state & LocallyPickable;
+        if (parentUpdated) {
+            const quint8 parentState = states[parentIdx];
+            globalTransforms[idx] = ignoreParentTransform ? local : globalTransforms[parentIdx] * local;
+            opacity *= globalOpacities[parentIdx];
+            active = active && (parentState & GloballyActive);
+            pickable = pickable || (parentState & GloballyPickable);
+        } else {
+            // The parent did not change this frame, so the render node has its valid state
+            const QSSGRenderNode *parent = parentIdx >= 0 ? m_nodes.at(parentIdx) : m_nodes.at(idx)->parent;
+            if (parent) {
+                // Layer transforms do not flow down but affect the final layer's rendered
+                // representation.
+                if (parent->type != QSSGRenderGraphObject::Type::Layer) {
+                    opacity *= parent->globalOpacity;
+                    globalTransforms[idx] = ignoreParentTransform ? local : parent->globalTransform * local;
+                } else {
+                    globalTransforms[idx] = local;
+                }
+                active = active && parent->flags.testFlag(QSSGRenderNode::Flag::GloballyActive);
+                pickable = pickable || parent->flags.testFlag(QSSGRenderNode::Flag::GloballyPickable);
+            } else {
+                globalTransforms[idx] = local;
+            }
+        }
+
+        state &= ~(GloballyActive | GloballyPickable);
+        state |= Dirty;
+        if (active)
+            state |= GloballyActive;
+        if (pickable)
+            state |= GloballyPickable;
+        states[idx] = state;
+        globalOpacities[idx] = opacity;
+    }
+}
+
+bool QSSGRenderNodeHierarchy::push(qint32 inBegin, qint32 inEnd)
+{
+    bool wasVisible = false;
+    for (qint32 idx = inBegin; idx < inEnd; ++idx) {
+        quint8 &state = m_states[idx];
+        if (!(state & Dirty))
+            continue;
+        QSSGRenderNode *node = m_nodes.at(idx);
+        if ((state & GloballyActive) || node->flags.testFlag(QSSGRenderNode::Flag::GloballyActive))
+            wasVisible = true;
+        node->globalTransform = m_globalTransforms.at(idx);
+        node->globalOpacity = m_globalOpacities.at(idx);
+        node->flags.setFlag(QSSGRenderNode::Flag::GloballyActive, state & GloballyActive);
+        node->flags.setFlag(QSSGRenderNode::Flag::GloballyPickable, state & GloballyPickable);
+        node->flags.setFlag(QSSGRenderNode::Flag::Dirty, false);
+        state &= ~Dirty;
+    }
+    return wasVisible;
+}
+
+QT_END_NAMESPACE
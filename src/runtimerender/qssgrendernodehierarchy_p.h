@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSG_RENDER_NODE_HIERARCHY_H
+#define QSSG_RENDER_NODE_HIERARCHY_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+#include <QtQuick3DRender/private/qssgrenderbasetypes_p.h>
+
+#include <QtGui/QMatrix4x4>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+struct QSSGRenderNode;
+
+/**
+ *	Flattened copy of the node tree below a root (usually a layer) used to update the global
+ *	transforms, opacities and active/pickable flags without chasing parent pointers.
+ *
+ *	The nodes are stored breadth first, so every depth level is a contiguous index range
+ *	that only depends on the levels before it. Parent indices, local and global matrices,
+ *	opacities and flags live in separate arrays indexed like the nodes, which turns the
+ *	update into a linear sweep that the compiler can vectorize and that is split over the
+ *	thread pool level by level when the scene is large enough.
+ *
+ *	The render nodes stay the owners of the state: update() pulls the local state of the
+ *	dirty nodes, sweeps the hierarchy and pushes the global state back, so everything that
+ *	reads QSSGRenderNode::globalTransform keeps working. Layers can share nodes, so the
+ *	hierarchy never stores its indices in the nodes. Any change of the node graph below the
+ *	root invalidates the hierarchy, see needsRebuild().
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNodeHierarchy
+{
+public:
+    enum {
+        // Below this the thread pool round trip costs more than the sweep
+        ParallelNodeThreshold = 4096,
+        ParallelGrainSize = 1024
+    };
+
+    QSSGRenderNodeHierarchy() = default;
+
+    // True when the hierarchy was built for another root or the node graph below the root
+    // changed since
+    bool needsRebuild(const QSSGRenderNode &inRoot) const;
+    // Flattens the children of inRoot. All nodes are updated by the next update().
+    void build(QSSGRenderNode &inRoot);
+    void clear();
+
+    // Recalculates the global variables of the dirty nodes and their descendants and clears
+    // their dirty flag. Returns true if any updated node is, or was until now, globally
+    // active. Changes in hidden subtrees do not need a redraw.
+    bool update(const QSSGRef<QSSGAbstractThreadPool> &inThreadPool = QSSGRef<QSSGAbstractThreadPool>());
+
+    qint32 size() const { return m_nodes.size(); }
+    QSSGRenderNode *node(qint32 inIndex) const { return m_nodes.at(inIndex); }
+    qint32 parentIndex(qint32 inIndex) const { return m_parents.at(inIndex); }
+    const QMatrix4x4 &globalTransform(qint32 inIndex) const { return m_globalTransforms.at(inIndex); }
+    // Node indices in depth first order, the order the nodes are rendered and scoped in
+    const QVector<qint32> &depthFirstOrder() const { return m_depthFirstOrder; }
+
+private:
+    enum State : quint8 {
+        Dirty = 1,
+        Active = 1 << 1,
+        LocallyPickable = 1 << 2,
+        IgnoreParentTransform = 1 << 3,
+        GloballyActive = 1 << 4,
+        GloballyPickable = 1 << 5
+    };
+
+    enum class Pass {
+        Pull,
+        Sweep,
+        Push
+    };
+
+    void append(QSSGRenderNode *inNode, qint32 inParent);
+    void runPass(Pass inPass,
+                 qint32 inBegin,
+                 qint32 inEnd,
+                 const QSSGRef<QSSGAbstractThreadPool> &inThreadPool,
+                 bool *outResult = nullptr);
+    bool processRange(Pass inPass, qint32 inBegin, qint32 inEnd);
+    bool pull(qint32 inBegin, qint32 inEnd);
+    void sweep(qint32 inBegin, qint32 inEnd);
+    bool push(qint32 inBegin, qint32 inEnd);
+
+    const QSSGRenderNode *m_root = nullptr;
+    // subtreeVersion of the root and of its children when the hierarchy was built. The
+    // children of a layer do not have the layer as parent, so they are tracked separately.
+    quint32 m_rootVersion = 0;
+    QVector<quint32> m_topLevelVersions;
+
+    QVector<QSSGRenderNode *> m_nodes;
+    QVector<qint32> m_parents; // -1 for the children of the root
+    QVector<qint32> m_levelEnds;
+    QVector<qint32> m_depthFirstOrder;
+    QVector<QMatrix4x4> m_localTransforms;
+    QVector<QMatrix4x4> m_globalTransforms;
+    QVector<float> m_localOpacities;
+    QVector<float> m_globalOpacities;
+    QVector<quint8> m_states;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -49,6 +49,14 @@ QSSGOption<QVector3D> QSSGRenderRay::intersect(const QSSGPlane &inPlane) const
 
 QSSGRenderRay::IntersectionResult QSSGRenderRay::intersectWithAABB(const QMatrix4x4 &inGlobalTransform, const QSSGBounds3 &inBounds,
                                                                        bool inForceIntersect) const
+{
+    return intersectWithAABB(inGlobalTransform, inGlobalTransform.inverted(), inBounds, inForceIntersect);
+}
+
+QSSGRenderRay::IntersectionResult QSSGRenderRay::intersectWithAABB(const QMatrix4x4 &inGlobalTransform,
+                                                                       const QMatrix4x4 &inInverseGlobalTransform,
+                                                                       const QSSGBounds3 &inBounds,
+                                                                       bool inForceIntersect) const
 {
     // Intersect the origin with the AABB described by bounds.
 
@@ -61,13 +69,9 @@ QSSGRenderRay::IntersectionResult QSSGRenderRay::intersectWithAABB(const QMatrix
     // that the pick could possibly be in.
 
     // Transform pick origin and direction into the subset's space.
-    QMatrix4x4 theOriginTransform = inGlobalTransform.inverted();
-
-    QVector3D theTransformedOrigin = mat44::transform(theOriginTransform, origin);
-    float *outOriginTransformPtr(theOriginTransform.data());
-    outOriginTransformPtr[12] = outOriginTransformPtr[13] = outOriginTransformPtr[14] = 0.0f;
-
-    QVector3D theTransformedDirection = mat44::rotate(theOriginTransform, direction);
+    // rotate() ignores the translation of the matrix.
+    QVector3D theTransformedOrigin = mat44::transform(inInverseGlobalTransform, origin);
+    QVector3D theTransformedDirection = mat44::rotate(inInverseGlobalTransform, direction);
 
     static const float KD_FLT_MAX = 3.40282346638528860e+38;
     static const float kEpsilon = 1e-5f;
@@ -81,6 +81,12 @@ struct QSSGRenderRay
 
     IntersectionResult intersectWithAABB(const QMatrix4x4 &inGlobalTransform, const QSSGBounds3 &inBounds,
                                          bool inForceIntersect = false) const;
+    // The same with the inverse of inGlobalTransform computed once by the caller, for testing
+    // many rays against the same bounds.
+    IntersectionResult intersectWithAABB(const QMatrix4x4 &inGlobalTransform,
+                                         const QMatrix4x4 &inInverseGlobalTransform,
+                                         const QSSGBounds3 &inBounds,
+                                         bool inForceIntersect = false) const;
 
     QSSGOption<QVector2D> relative(const QMatrix4x4 &inGlobalTransform,
                                         const QSSGBounds3 &inBounds,
@@ -402,7 +402,7 @@ void QSSGShaderCache::addShaderPreprocessor(QByteArray &str, const QByteArray &i
     }
 }
 
-QSSGRef<QSSGRenderShaderProgram> QSSGShaderCache::forceCompileProgram(const QByteArray &inKey, const QByteArray &inVert, const QByteArray &inFrag, const QByteArray &inTessCtrl, const QByteArray &inTessEval, const QByteArray &inGeom, const QSSGShaderCacheProgramFlags &inFlags, const QVector<QSSGShaderPreprocessorFeature> &inFeatures, bool separableProgram, bool fromDisk)
+QSSGRef<QSSGRenderShaderProgram> QSSGShaderCache::forceCompileProgram(const QByteArray &inKey, const QByteArray &inVert, const QByteArray &inFrag, const QByteArray &inTessCtrl, const QByteArray &inTessEval, const QByteArray &inGeom, const QSSGShaderCacheProgramFlags &inFlags, const QVector<QSSGShaderPreprocessorFeature> &inFeatures, bool separableProgram, bool fromDisk, bool asyncLink)
 {
     if (m_shaderCompilationEnabled == false)
         return nullptr;
@@ -443,8 +443,13 @@ QSSGRef<QSSGRenderShaderProgram> QSSGShaderCache::forceCompileProgram(const QByt
                                                         toByteView(m_tessCtrlCode),
                                                         toByteView(m_tessEvalCode),
                                                         toByteView(m_geometryCode),
-                                                        separableProgram).m_shader;
+                                                        separableProgram,
+                                                        QSSGRenderShaderProgramBinaryType::Unknown,
+                                                        false,
+                                                        asyncLink).m_shader;
     const auto inserted = m_shaders.insert(tempKey, shaderProgram);
+    if (shaderProgram && shaderProgram->isLinkPending())
+        m_pendingPrograms.append(qMakePair(tempKey, shaderProgram));
     if (shaderProgram) {
         // ### Shader Chache Writing Code is disabled
         //            if (m_ShaderCache) {
@@ -510,6 +515,43 @@ QSSGRef<QSSGRenderShaderProgram> QSSGShaderCache::compileProgram(const QByteArra
     return retval;
 }
 
+QSSGRef<QSSGRenderShaderProgram> QSSGShaderCache::compileProgram(const QSSGShaderCacheProgramSource &inSource, bool inAsyncLink)
+{
+    const QSSGRef<QSSGRenderShaderProgram> &theProgram = getProgram(inSource.key, inSource.features);
+    if (theProgram)
+        return theProgram;
+
+    return forceCompileProgram(inSource.key,
+                               inSource.vertex,
+                               inSource.fragment,
+                               inSource.tessControl,
+                               inSource.tessEvaluation,
+                               inSource.geometry,
+                               inSource.flags,
+                               inSource.features,
+                               inSource.separable,
+                               false,
+                               inAsyncLink);
+}
+
+void QSSGShaderCache::updatePendingPrograms(bool inWait)
+{
+    for (int idx = 0; idx < m_pendingPrograms.size();) {
+        const auto &pending = m_pendingPrograms.at(idx);
+        const QSSGRenderShaderProgram::LinkState state = pending.second->updateLink(inWait);
+        if (state == QSSGRenderShaderProgram::LinkState::Pending) {
+            ++idx;
+            continue;
+        }
+        if (state == QSSGRenderShaderProgram::LinkState::Failed) {
+            auto it = m_shaders.find(pending.first);
+            if (it != m_shaders.end() && it.value() == pending.second)
+                it.value() = nullptr;
+        }
+        m_pendingPrograms.remove(idx);
+    }
+}
+
 void QSSGShaderCache::setShaderCachePersistenceEnabled(const QString &inDirectory)
 {
     // ### Shader Chache Writing Code is disabled
@@ -46,6 +46,7 @@
 
 #include <QtCore/QString>
 
+#include <QtCore/QPair>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QVector>
 
@@ -121,6 +122,21 @@ struct QSSGShaderCacheKey
     }
 };
 
+// The generated sources of a program before the cache adds its preprocessor
+// header. Building it does not touch the render context, so it can be done
+// on a worker thread and handed to compileProgram afterwards.
+struct QSSGShaderCacheProgramSource
+{
+    QByteArray key;
+    QByteArray vertex;
+    QByteArray tessControl;
+    QByteArray tessEvaluation;
+    QByteArray geometry;
+    QByteArray fragment;
+    QSSGShaderCacheProgramFlags flags;
+    TShaderFeatureSet features;
+    bool separable = false;
+};
 
 class QSSGShaderCache
 {
@@ -133,9 +149,11 @@ public:
     QAtomicInt ref;
 private:
     typedef QHash<QSSGShaderCacheKey, QSSGRef<QSSGRenderShaderProgram>> TShaderMap;
+    typedef QVector<QPair<QSSGShaderCacheKey, QSSGRef<QSSGRenderShaderProgram>>> TPendingProgramList;
     QSSGRef<QSSGRenderContext> m_renderContext;
     QSSGPerfTimer *m_perfTimer;
     TShaderMap m_shaders;
+    TPendingProgramList m_pendingPrograms;
     QString m_cacheFilePath;
     QByteArray m_vertexCode;
     QByteArray m_tessCtrlCode;
@@ -199,7 +217,8 @@ public:
                                                                      const QSSGShaderCacheProgramFlags &inFlags,
                                                                      const QVector<QSSGShaderPreprocessorFeature> &inFeatures,
                                                                      bool separableProgram,
-                                                                     bool fromDisk = false);
+                                                                     bool fromDisk = false,
+                                                                     bool asyncLink = false);
 
     // It is up to the caller to ensure that inFeatures contains unique keys.
     // It is also up the the caller to ensure the keys are ordered in some way.
@@ -213,6 +232,16 @@ public:
                                                                 const QVector<QSSGShaderPreprocessorFeature> &inFeatures,
                                                                 bool separableProgram = false);
 
+    // With inAsyncLink the program is returned while the driver is still linking it.
+    // Such a program must not be used before updatePendingPrograms reports it linked,
+    // see QSSGRenderShaderProgram::isLinkPending.
+    QSSGRef<QSSGRenderShaderProgram> compileProgram(const QSSGShaderCacheProgramSource &inSource, bool inAsyncLink = false);
+
+    // Finish the asynchronous links that are done, or all of them with inWait.
+    // Programs that failed to link are replaced by null in the cache.
+    void updatePendingPrograms(bool inWait = false);
+    bool hasPendingPrograms() const { return !m_pendingPrograms.isEmpty(); }
+
     // Used to disable any shader compilation during loading.  This is used when we are just
     // interested in going from uia->binary
     // and we expect to run on a headless server of sorts.  See the UICCompiler project for its
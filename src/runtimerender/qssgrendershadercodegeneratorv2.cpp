@@ -129,7 +129,18 @@ struct QSSGStageGeneratorBase : public QSSGShaderStageGeneratorInterface
 
     virtual void addShaderIncomingMap() { addShaderItemMap(GetIncomingVariableName(), m_incoming); }
 
-    virtual void addShaderUniformMap() { addShaderItemMap("uniform", m_uniforms); }
+    virtual void addShaderUniformMap()
+    {
+        if (m_constantBufferParams.isEmpty()) {
+            addShaderItemMap("uniform", m_uniforms);
+            return;
+        }
+        // Uniforms that are members of a constant buffer are declared by the block
+        TStrTableStrMap uniforms = m_uniforms;
+        for (const TConstantBufferParamPair &param : qAsConst(m_constantBufferParams))
+            uniforms.remove(param.second.first);
+        addShaderItemMap("uniform", uniforms);
+    }
 
     virtual void addShaderOutgoingMap()
     {
@@ -352,39 +363,48 @@ struct QSSGProgramGenerator : public QSSGShaderProgramGeneratorInterface
         return nullptr;
     }
 
-    QSSGRef<QSSGRenderShaderProgram> compileGeneratedShader(const QByteArray &inShaderName,
-                                                                const QSSGShaderCacheProgramFlags &inFlags,
-                                                                const TShaderFeatureSet &inFeatureSet,
-                                                                bool separableProgram) override
+    QSSGShaderCacheProgramSource generatedShaderSource(const QByteArray &inShaderName,
+                                                       const QSSGShaderCacheProgramFlags &inFlags,
+                                                       const TShaderFeatureSet &inFeatureSet,
+                                                       bool separableProgram) override
     {
-        // No stages enabled
-        if (((quint32)m_enabledStages) == 0) {
-            Q_ASSERT(false);
-            return nullptr;
-        }
+        QSSGShaderCacheProgramSource theSource;
+        theSource.key = inShaderName;
+        theSource.flags = inFlags;
+        theSource.features = inFeatureSet;
+        theSource.separable = separableProgram;
 
         QSSGRef<QSSGDynamicObjectSystem> theDynamicSystem(m_context->dynamicObjectSystem());
-        QSSGShaderCacheProgramFlags theCacheFlags(inFlags);
         for (quint32 stageIdx = 0; stageIdx < static_cast<quint32>(QSSGShaderGeneratorStage::StageCount); ++stageIdx) {
             QSSGShaderGeneratorStage stageName = static_cast<QSSGShaderGeneratorStage>(1 << stageIdx);
             if (m_enabledStages & stageName) {
                 QSSGStageGeneratorBase &theStage(internalGetStage(stageName));
                 theStage.buildShaderSource();
-                theStage.updateShaderCacheFlags(theCacheFlags);
+                theStage.updateShaderCacheFlags(theSource.flags);
                 theDynamicSystem->insertShaderHeaderInformation(theStage.m_finalBuilder, inShaderName);
             }
         }
 
-        const QSSGRef<QSSGShaderCache> &theCache = m_context->shaderCache();
-        return theCache->compileProgram(inShaderName,
-                                        m_vs.m_finalBuilder,
-                                        m_fs.m_finalBuilder,
-                                        m_tc.m_finalBuilder,
-                                        m_te.m_finalBuilder,
-                                        m_gs.m_finalBuilder,
-                                        theCacheFlags,
-                                        inFeatureSet,
-                                        separableProgram);
+        theSource.vertex = m_vs.m_finalBuilder;
+        theSource.tessControl = m_tc.m_finalBuilder;
+        theSource.tessEvaluation = m_te.m_finalBuilder;
+        theSource.geometry = m_gs.m_finalBuilder;
+        theSource.fragment = m_fs.m_finalBuilder;
+        return theSource;
+    }
+
+    QSSGRef<QSSGRenderShaderProgram> compileGeneratedShader(const QByteArray &inShaderName,
+                                                                const QSSGShaderCacheProgramFlags &inFlags,
+                                                                const TShaderFeatureSet &inFeatureSet,
+                                                                bool separableProgram) override
+    {
+        // No stages enabled
+        if (((quint32)m_enabledStages) == 0) {
+            Q_ASSERT(false);
+            return nullptr;
+        }
+
+        return m_context->shaderCache()->compileProgram(generatedShaderSource(inShaderName, inFlags, inFeatureSet, separableProgram));
     }
 };
 };
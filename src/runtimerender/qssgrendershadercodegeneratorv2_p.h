@@ -118,6 +118,14 @@ public:
 
     QSSGRef<QSSGRenderShaderProgram> compileGeneratedShader(const QByteArray &inShaderName, bool separableProgram = false);
 
+    // Ends the program like compileGeneratedShader but only returns its sources.
+    // Needs nothing but the shader library, so separate generators can run on
+    // worker threads.
+    virtual QSSGShaderCacheProgramSource generatedShaderSource(const QByteArray &inShaderName,
+                                                               const QSSGShaderCacheProgramFlags &inFlags,
+                                                               const TShaderFeatureSet &inFeatureSet,
+                                                               bool separableProgram = false) = 0;
+
     static QSSGRef<QSSGShaderProgramGeneratorInterface> createProgramGenerator(QSSGRenderContextInterface *inContext);
 
     static void outputParaboloidDepthVertex(QSSGShaderStageGeneratorInterface &inGenerator);
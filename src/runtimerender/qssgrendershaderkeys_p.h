@@ -487,6 +487,7 @@ struct QSSGShaderDefaultMaterialKeyProperties
     QSSGShaderKeyBoolean m_lightFlags[LightCount];
     QSSGShaderKeyBoolean m_lightAreaFlags[LightCount];
     QSSGShaderKeyBoolean m_lightShadowFlags[LightCount];
+    QSSGShaderKeyBoolean m_clusteredLighting;
     QSSGShaderKeyBoolean m_specularEnabled;
     QSSGShaderKeyBoolean m_fresnelEnabled;
     QSSGShaderKeyBoolean m_vertexColorsEnabled;
@@ -501,6 +502,7 @@ struct QSSGShaderDefaultMaterialKeyProperties
         : m_hasLighting("hasLighting")
         , m_hasIbl("hasIbl")
         , m_lightCount("lightCount")
+        , m_clusteredLighting("clusteredLighting")
         , m_specularEnabled("specularEnabled")
         , m_fresnelEnabled("fresnelEnabled")
         , m_vertexColorsEnabled("vertexColorsEnabled")
@@ -584,6 +586,8 @@ struct QSSGShaderDefaultMaterialKeyProperties
             inVisitor.visit(m_lightShadowFlags[idx]);
         }
 
+        inVisitor.visit(m_clusteredLighting);
+
         inVisitor.visit(m_specularEnabled);
         inVisitor.visit(m_fresnelEnabled);
         inVisitor.visit(m_vertexColorsEnabled);
@@ -0,0 +1,447 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qssgrendershaderlibrary_p.h"
+
+#include <QtQuick3DRuntimeRender/private/qssgruntimerenderlogging_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isIdentifierChar(char c)
+{
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+QVector<QByteArray> identifiersOf(const QByteArray &inText)
+{
+    QVector<QByteArray> result;
+    const char *data = inText.constData();
+    const int size = inText.size();
+    for (int i = 0; i < size;) {
+        const char c = data[i];
+        if (isIdentifierStart(c)) {
+            const int start = i;
+            while (i < size && isIdentifierChar(data[i]))
+                ++i;
+            result.append(QByteArray(data + start, i - start));
+        } else if (c >= '0' && c <= '9') {
+            // Skip numbers with their suffixes and exponents
+            while (i < size && (isIdentifierChar(data[i]) || data[i] == '.'))
+                ++i;
+        } else {
+            ++i;
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+// Removes comments from a preprocessor line
+QByteArray stripDirectiveComments(const char *inBegin, const char *inEnd)
+{
+    QByteArray result;
+    result.reserve(int(inEnd - inBegin));
+    bool inString = false;
+    for (const char *p = inBegin; p < inEnd; ++p) {
+        if (*p == '"') {
+            inString = !inString;
+        } else if (!inString && *p == '/' && p + 1 < inEnd) {
+            if (p[1] == '/')
+                break;
+            if (p[1] == '*') {
+                const char *end = p + 2;
+                while (end + 1 < inEnd && !(end[0] == '*' && end[1] == '/'))
+                    ++end;
+                p = end + 1;
+                result.append(' ');
+                continue;
+            }
+        }
+        result.append(*p);
+    }
+    while (!result.isEmpty() && isSpace(result.at(result.size() - 1)))
+        result.chop(1);
+    return result;
+}
+
+// Returns the name of the function whose body starts at the end of inText, if
+// the whole signature lies after inStatementStart.
+QByteArray functionName(const QByteArray &inText, int inStatementStart)
+{
+    const char *data = inText.constData();
+    int p = inText.size() - 1;
+    while (p >= inStatementStart && isSpace(data[p]))
+        --p;
+    if (p < inStatementStart || data[p] != ')')
+        return QByteArray();
+    int depth = 0;
+    for (; p >= inStatementStart; --p) {
+        if (data[p] == ')') {
+            ++depth;
+        } else if (data[p] == '(') {
+            if (--depth == 0)
+                break;
+        }
+    }
+    if (p < inStatementStart)
+        return QByteArray();
+    --p;
+    while (p >= inStatementStart && isSpace(data[p]))
+        --p;
+    const int end = p + 1;
+    while (p >= inStatementStart && isIdentifierChar(data[p]))
+        --p;
+    if (end == p + 1 || !isIdentifierStart(data[p + 1]))
+        return QByteArray();
+    const QByteArray name = inText.mid(p + 1, end - p - 1);
+    // Statements of a fragment meant to be included inside a function body
+    if (name == "if" || name == "for" || name == "while" || name == "switch")
+        return QByteArray();
+    return name;
+}
+
+} // namespace
+
+QSSGShaderLibraryFile QSSGShaderLibraryFile::parse(const QByteArray &inSource, const QByteArray &inPath)
+{
+    QSSGShaderLibraryFile file;
+
+    QByteArray current; // text of the chunk being read, without comments
+    current.reserve(inSource.size());
+    int statementStart = 0; // offset in current of the top level statement being read
+    int braceDepth = 0;
+    bool inFunction = false;
+    QByteArray name;
+
+    int conditionalDepth = 0;
+    int guardDepth = 0;
+    int directiveCount = 0;
+    bool codeSeen = false;
+    bool lineStart = true;
+    QByteArray guardCandidate;
+
+    const auto flushText = [&file, &current](int inLength) {
+        if (inLength <= 0)
+            return;
+        QSSGShaderLibraryChunk chunk;
+        chunk.text = current.left(inLength);
+        chunk.identifiers = identifiersOf(chunk.text);
+        file.chunks.append(chunk);
+        current.remove(0, inLength);
+    };
+
+    const char *data = inSource.constData();
+    const int size = inSource.size();
+    for (int i = 0; i < size;) {
+        const char c = data[i];
+
+        // Comments
+        if (c == '/' && i + 1 < size && data[i + 1] == '/') {
+            while (i < size && data[i] != '\n')
+                ++i;
+            continue;
+        }
+        if (c == '/' && i + 1 < size && data[i + 1] == '*') {
+            int end = i + 2;
+            bool hasNewline = false;
+            while (end + 1 < size && !(data[end] == '*' && data[end + 1] == '/')) {
+                hasNewline |= (data[end] == '\n');
+                ++end;
+            }
+            current.append(hasNewline ? '\n' : ' ');
+            if (hasNewline)
+                lineStart = true;
+            i = qMin(end + 2, size);
+            continue;
+        }
+
+        // Preprocessor lines, including their continuations
+        if (c == '#' && lineStart) {
+            int end = i;
+            while (end < size && !(data[end] == '\n' && data[end - 1] != '\\' && !(data[end - 1] == '\r' && data[end - 2] == '\\')))
+                ++end;
+            const QByteArray directive = stripDirectiveComments(data + i, data + end);
+            i = qMin(end + 1, size);
+
+            int p = 1;
+            while (p < directive.size() && isSpace(directive.at(p)))
+                ++p;
+            int keywordEnd = p;
+            while (keywordEnd < directive.size() && isIdentifierChar(directive.at(keywordEnd)))
+                ++keywordEnd;
+            const QByteArray keyword = directive.mid(p, keywordEnd - p);
+            const QByteArray argument = directive.mid(keywordEnd).trimmed();
+
+            if (keyword == "include" && argument.startsWith('"')) {
+                const int quote = argument.indexOf('"', 1);
+                if (quote == -1) {
+                    qCCritical(INVALID_OPERATION, "Unterminated include in file: %s", inPath.constData());
+                    continue;
+                }
+                // An include inside a block leaves the block as plain text
+                inFunction = false;
+                flushText(current.size());
+                QSSGShaderLibraryChunk chunk;
+                chunk.type = QSSGShaderLibraryChunk::Type::Include;
+                chunk.conditional = conditionalDepth > guardDepth;
+                chunk.inBlock = braceDepth > 0;
+                chunk.text = argument.mid(1, quote - 1);
+                file.chunks.append(chunk);
+                statementStart = 0;
+                ++directiveCount;
+                continue;
+            }
+
+            if (keyword == "if" || keyword == "ifdef" || keyword == "ifndef") {
+                if (keyword == "ifndef" && directiveCount == 0 && !codeSeen)
+                    guardCandidate = argument;
+                ++conditionalDepth;
+            } else if (keyword == "endif") {
+                conditionalDepth = qMax(0, conditionalDepth - 1);
+            } else if (keyword == "define" && directiveCount == 1 && !codeSeen && !guardCandidate.isEmpty()
+                       && argument == guardCandidate) {
+                file.guard = guardCandidate;
+                guardDepth = 1;
+            }
+            ++directiveCount;
+
+            current.append(directive);
+            current.append('\n');
+            if (braceDepth == 0 && !inFunction)
+                statementStart = current.size();
+            continue;
+        }
+
+        if (c == '\n')
+            lineStart = true;
+        else if (!isSpace(c))
+            lineStart = false;
+        if (!isSpace(c))
+            codeSeen = true;
+
+        if (c == '{') {
+            if (braceDepth == 0) {
+                name = functionName(current, statementStart);
+                if (!name.isEmpty()) {
+                    while (statementStart < current.size() && isSpace(current.at(statementStart)))
+                        ++statementStart;
+                    flushText(statementStart);
+                    inFunction = true;
+                }
+            }
+            ++braceDepth;
+            current.append(c);
+        } else if (c == '}') {
+            current.append(c);
+            if (braceDepth > 0 && --braceDepth == 0) {
+                if (inFunction) {
+                    QSSGShaderLibraryChunk chunk;
+                    chunk.type = QSSGShaderLibraryChunk::Type::Function;
+                    chunk.text = current;
+                    chunk.name = name;
+                    chunk.identifiers = identifiersOf(chunk.text);
+                    file.chunks.append(chunk);
+                    current.clear();
+                    inFunction = false;
+                }
+                statementStart = current.size();
+            }
+        } else {
+            current.append(c);
+            if (c == ';' && braceDepth == 0)
+                statementStart = current.size();
+        }
+        ++i;
+    }
+    flushText(current.size());
+
+    return file;
+}
+
+QSSGShaderLibraryPreprocessor::QSSGShaderLibraryPreprocessor(const LoadFunction &inLoad) : m_load(inLoad) {}
+
+QByteArray QSSGShaderLibraryPreprocessor::expand(const QByteArray &inSource, const QByteArray &inPath, bool inStripUnusedFunctions)
+{
+    // Nothing to resolve, and nothing from a library to strip
+    if (!inSource.contains("#include"))
+        return inSource;
+
+    const QSSGShaderLibraryFile root = QSSGShaderLibraryFile::parse(inSource, inPath);
+    ExpandState state;
+    if (!inPath.isEmpty())
+        state.stack.append(inPath);
+    expandChunks(root, true, false, false, state);
+    return output(state, inStripUnusedFunctions);
+}
+
+QByteArray QSSGShaderLibraryPreprocessor::expandFile(const QByteArray &inPath, bool inStripUnusedFunctions)
+{
+    ExpandState state;
+    const auto root = file(inPath);
+    state.files.append(root);
+    state.stack.append(inPath);
+    expandChunks(*root, true, false, false, state);
+    return output(state, inStripUnusedFunctions);
+}
+
+void QSSGShaderLibraryPreprocessor::invalidate(const QByteArray &inPath)
+{
+    QMutexLocker locker(&m_filesLock);
+    m_files.remove(inPath);
+}
+
+void QSSGShaderLibraryPreprocessor::clear()
+{
+    QMutexLocker locker(&m_filesLock);
+    m_files.clear();
+}
+
+QSharedPointer<const QSSGShaderLibraryFile> QSSGShaderLibraryPreprocessor::file(const QByteArray &inPath)
+{
+    // The loader is called with the lock held, so it is never run concurrently either
+    QMutexLocker locker(&m_filesLock);
+    auto it = m_files.constFind(inPath);
+    if (it != m_files.constEnd())
+        return it.value();
+
+    // A missing file is cached empty, the loader has already reported it
+    QByteArray source;
+    m_load(inPath, source);
+    QSharedPointer<const QSSGShaderLibraryFile> result(new QSSGShaderLibraryFile(QSSGShaderLibraryFile::parse(source, inPath)));
+    m_files.insert(inPath, result);
+    return result;
+}
+
+void QSSGShaderLibraryPreprocessor::expandChunks(const QSSGShaderLibraryFile &inFile,
+                                                 bool inRoot,
+                                                 bool inConditional,
+                                                 bool inInBlock,
+                                                 ExpandState &ioState)
+{
+    for (const QSSGShaderLibraryChunk &chunk : inFile.chunks) {
+        if (chunk.type != QSSGShaderLibraryChunk::Type::Include) {
+            const bool removable = !inRoot && !inInBlock && chunk.type == QSSGShaderLibraryChunk::Type::Function;
+            const Segment segment = { &chunk, QByteArray(), removable, true };
+            ioState.segments.append(segment);
+            continue;
+        }
+
+        const QByteArray &path = chunk.text;
+        if (ioState.stack.contains(path)) {
+            qCCritical(INVALID_OPERATION, "Recursive include of %s", path.constData());
+            continue;
+        }
+        if (ioState.included.contains(path))
+            continue;
+        const bool conditional = inConditional || chunk.conditional || chunk.inBlock;
+        if (!conditional)
+            ioState.included.insert(path);
+
+        const auto included = file(path);
+        ioState.files.append(included);
+        const Segment begin = { nullptr, QByteArrayLiteral("\n// begin \"") + path + QByteArrayLiteral("\"\n"), false, true };
+        ioState.segments.append(begin);
+        ioState.stack.append(path);
+        // Code included into a block is part of that block, not a set of definitions
+        expandChunks(*included, false, conditional, inInBlock || chunk.inBlock, ioState);
+        ioState.stack.removeLast();
+        const Segment end = { nullptr, QByteArrayLiteral("\n// end \"") + path + QByteArrayLiteral("\"\n"), false, true };
+        ioState.segments.append(end);
+    }
+}
+
+QByteArray QSSGShaderLibraryPreprocessor::output(ExpandState &ioState, bool inStripUnusedFunctions)
+{
+    QVector<Segment> &segments = ioState.segments;
+
+    if (inStripUnusedFunctions) {
+        // Library functions by name. Overloads share the name and are kept together.
+        QHash<QByteArray, QVector<int>> functions;
+        QVector<const QVector<QByteArray> *> worklist;
+        for (int idx = 0, end = segments.size(); idx < end; ++idx) {
+            Segment &segment = segments[idx];
+            if (!segment.chunk)
+                continue;
+            if (segment.removable) {
+                functions[segment.chunk->name].append(idx);
+                segment.kept = false;
+            } else {
+                worklist.append(&segment.chunk->identifiers);
+            }
+        }
+
+        const auto keep = [&functions, &segments, &worklist](const QByteArray &inName) {
+            auto it = functions.find(inName);
+            if (it == functions.end())
+                return;
+            for (int idx : it.value()) {
+                segments[idx].kept = true;
+                worklist.append(&segments[idx].chunk->identifiers);
+            }
+            functions.erase(it);
+        };
+
+        keep(QByteArrayLiteral("main"));
+        while (!worklist.isEmpty() && !functions.isEmpty()) {
+            const QVector<QByteArray> *identifiers = worklist.takeLast();
+            for (const QByteArray &identifier : *identifiers)
+                keep(identifier);
+        }
+    }
+
+    int size = 0;
+    for (const Segment &segment : qAsConst(segments))
+        size += segment.chunk ? (segment.kept ? segment.chunk->text.size() : 0) : segment.marker.size();
+    QByteArray result;
+    result.reserve(size);
+    for (const Segment &segment : qAsConst(segments)) {
+        if (!segment.chunk)
+            result.append(segment.marker);
+        else if (segment.kept)
+            result.append(segment.chunk->text);
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_SHADER_LIBRARY_H
+#define QSSG_RENDER_SHADER_LIBRARY_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+struct QSSGShaderLibraryChunk
+{
+    enum class Type : quint8
+    {
+        Text, // declarations, preprocessor lines and anything else that is always kept
+        Function, // a function definition, see name
+        Include // an #include directive, text holds the included path
+    };
+
+    Type type = Type::Text;
+    // The include is inside a conditional block of its file
+    bool conditional = false;
+    // The include is inside a function body or other block of its file
+    bool inBlock = false;
+    QByteArray text;
+    QByteArray name;
+    // Identifiers used by text, sorted and unique
+    QVector<QByteArray> identifiers;
+};
+
+// A shader source split into chunks, with comments removed
+struct QSSGShaderLibraryFile
+{
+    QVector<QSSGShaderLibraryChunk> chunks;
+    // Macro of the file's include guard, if it has one
+    QByteArray guard;
+
+    static QSSGShaderLibraryFile parse(const QByteArray &inSource, const QByteArray &inPath);
+};
+
+// Resolves #include "file" directives in shader sources.
+//
+// Each included file is tokenized once and cached as a chunk list. When
+// expanding a shader, a file that was already included unconditionally is
+// not inserted again. Includes inside #if blocks are always expanded and
+// left to the file's include guard, since whether they are active is only
+// known to the GLSL preprocessor.
+//
+// On request, functions coming from included files that the shader never
+// references (directly or through other kept code) are left out. The test
+// is lexical and ignores #if blocks, so it only errs on the side of keeping.
+//
+// Expanding is thread-safe, the file cache is guarded by a lock so shaders
+// can be generated from worker threads.
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGShaderLibraryPreprocessor
+{
+    Q_DISABLE_COPY(QSSGShaderLibraryPreprocessor)
+public:
+    // Returns false if the file cannot be found
+    typedef std::function<bool(const QByteArray &inPath, QByteArray &outSource)> LoadFunction;
+
+    explicit QSSGShaderLibraryPreprocessor(const LoadFunction &inLoad);
+
+    // Expand the includes of inSource. inPath is only used for messages.
+    QByteArray expand(const QByteArray &inSource, const QByteArray &inPath, bool inStripUnusedFunctions);
+    // Load a file and expand its includes
+    QByteArray expandFile(const QByteArray &inPath, bool inStripUnusedFunctions);
+
+    // Forget the parsed version of a file whose source changed
+    void invalidate(const QByteArray &inPath);
+    void clear();
+
+private:
+    struct Segment
+    {
+        const QSSGShaderLibraryChunk *chunk;
+        QByteArray marker; // used when chunk is null
+        bool removable;
+        bool kept;
+    };
+
+    struct ExpandState
+    {
+        QVector<Segment> segments;
+        QVector<QSharedPointer<const QSSGShaderLibraryFile>> files; // keeps the chunks alive
+        QSet<QByteArray> included; // files included unconditionally
+        QVector<QByteArray> stack;
+    };
+
+    QSharedPointer<const QSSGShaderLibraryFile> file(const QByteArray &inPath);
+    void expandChunks(const QSSGShaderLibraryFile &inFile,
+                      bool inRoot,
+                      bool inConditional,
+                      bool inInBlock,
+                      ExpandState &ioState);
+    static QByteArray output(ExpandState &ioState, bool inStripUnusedFunctions);
+
+    LoadFunction m_load;
+    QMutex m_filesLock;
+    QHash<QByteArray, QSharedPointer<const QSSGShaderLibraryFile>> m_files;
+};
+
+QT_END_NAMESPACE
+
+#endif
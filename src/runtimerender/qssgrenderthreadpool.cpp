@@ -30,72 +30,209 @@
 
 #include "qssgrenderthreadpool_p.h"
 
-#include <QtCore/QThreadPool>
-#include <QtCore/QRunnable>
-#include <QtCore/QHash>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QQueue>
+#include <QtCore/QSemaphore>
+
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 
 namespace {
-class QSSGThreadPool;
-class QSSGTask : public QRunnable
+
+// Work stealing thread pool.
+//
+// Every worker owns a Chase-Lev deque: the owner pushes and pops jobs at the bottom
+// without locking, idle workers steal the oldest jobs from the top of the other deques.
+// Threads outside of the pool get a deque of their own the first time they submit work,
+// so the render thread does not contend with the workers on a shared queue. The deque is
+// handed back when the thread exits. When all external deques are taken, further threads
+// queue their tasks in a shared injection queue guarded by a mutex.
+//
+// Jobs live in blocks of slots that are never released before the pool is destroyed.
+// Free slots are cached per deque and otherwise kept in a lock-free list, only growing
+// the slot blocks takes a mutex. A task id is the slot index combined with the
+// generation of the slot, which is bumped whenever the slot is released, so ids of
+// finished tasks are unknown to getTaskState() and cancelTask().
+
+enum JobState : quint8
+{
+    Free,
+    Queued,
+    Running,
+    Canceling, // cancelTask() is calling the cancel function
+    Canceled, // The cancel function was called, the executing thread releases the slot
+    Dropped // Popped while canceling, cancelTask() releases the slot
+};
+
+struct QSSGJob
+{
+    enum class Kind : quint8
+    {
+        Task,
+        Range
+    };
+
+    // quint32 generation << 8 | JobState
+    QAtomicInteger<quint64> control { 0 };
+    // Range jobs: the job itself plus the ranges split off it that did not finish yet
+    QAtomicInt unfinished { 0 };
+    QAtomicInteger<quint32> nextFree { 0 };
+    quint32 index = 0;
+    Kind kind = Kind::Task;
+
+    void *userData = nullptr;
+    QSSGTaskCallback function = nullptr;
+    QSSGTaskCallback cancelFunction = nullptr;
+
+    QSSGRangeCallback rangeFunction = nullptr;
+    qint32 begin = 0;
+    qint32 end = 0;
+    qint32 grainSize = 1;
+    QSSGJob *parent = nullptr;
+    QAtomicInt *completed = nullptr;
+
+    quint64 generationBits() const { return control.load() & ~quint64(0xff); }
+    quint64 taskId() const { return generationBits() << 24 | index; }
+    static JobState state(quint64 inControl) { return JobState(inControl & 0xff); }
+};
+
+class QSSGJobDeque
 {
 public:
-    QSSGTask(void *inUserData, QSSGTaskCallback inFunction, QSSGTaskCallback inCancelFunction, quint64 id, QSSGThreadPool *threadPool)
-        : m_userData(inUserData)
-        , m_function(inFunction)
-        , m_cancelFunction(inCancelFunction)
-        , m_id(id)
-        , m_taskState(TaskStates::Queued)
-        , m_threadPool(threadPool)
+    enum {
+        Capacity = 4096,
+        Mask = Capacity - 1,
+        FreeCacheSize = 64
+    };
+
+    explicit QSSGJobDeque(qint32 inSlot) : slot(inSlot) {}
+
+    // Owner only
+    bool push(QSSGJob *inJob)
     {
-        setAutoDelete(false);
+        const qint64 b = m_bottom.load();
+        const qint64 t = m_top.loadAcquire();
+        if (b - t >= Capacity)
+            return false;
+        m_jobs[b & Mask].store(inJob);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1);
+        return true;
     }
 
-    TaskStates taskState()
+    // Owner only
+    QSSGJob *pop()
     {
-        QMutexLocker locker(&m_mutex);
-        return m_taskState;
+        const qint64 b = m_bottom.load() - 1;
+        m_bottom.store(b);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        qint64 t = m_top.load();
+        QSSGJob *job = nullptr;
+        if (t <= b) {
+            job = m_jobs[b & Mask].load();
+            if (t == b) {
+                // Last job, race the thieves for it
+                if (!m_top.testAndSetOrdered(t, t + 1))
+                    job = nullptr;
+                m_bottom.store(b + 1);
+            }
+        } else {
+            m_bottom.store(b + 1);
+        }
+        return job;
     }
 
-    void run() override;
-
-    void doFunction()
+    // Any thread, may fail spuriously when another thread takes the same job
+    QSSGJob *steal()
     {
-        if (m_function)
-            m_function(m_userData);
+        qint64 t = m_top.loadAcquire();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const qint64 b = m_bottom.loadAcquire();
+        if (t >= b)
+            return nullptr;
+        QSSGJob *job = m_jobs[t & Mask].load();
+        if (!m_top.testAndSetOrdered(t, t + 1))
+            return nullptr;
+        return job;
     }
 
-    bool doCancel()
+    const qint32 slot;
+    // Thread using an external deque, workers own theirs from the start
+    QAtomicInteger<quintptr> owner { 0 };
+    // Free job slots of the owning thread
+    quint32 freeJobs[FreeCacheSize];
+    qint32 freeJobCount = 0;
+
+private:
+    // Keep the thieves' index away from the owner's
+    QAtomicInteger<qint64> m_top { 0 };
+    char m_padding[64];
+    QAtomicInteger<qint64> m_bottom { 0 };
+    QAtomicPointer<QSSGJob> m_jobs[Capacity];
+};
+
+// The deque this thread used last, keyed by pool serial. Serials are never reused,
+// so a pool created at the address of a destroyed one can not match.
+struct ThreadQueueCache
+{
+    quint32 poolSerial = 0;
+    QSSGJobDeque *queue = nullptr;
+};
+
+thread_local ThreadQueueCache t_queueCache;
+
+QAtomicInteger<quint32> s_nextPoolSerial { 1 };
+
+// Serials of the pools that were not destroyed yet, a thread only hands back the deques
+// of those when it exits.
+QBasicMutex g_livePoolsMutex;
+Q_GLOBAL_STATIC(QVector<quint32>, g_livePools)
+
+// The external deques the thread took, released when the thread exits
+struct ThreadQueueLeases
+{
+    struct Lease
     {
-        {
-            QMutexLocker locker(&m_mutex);
-            if (m_taskState == TaskStates::Running)
-                return false;
-        }
+        quint32 poolSerial;
+        QSSGJobDeque *queue;
+    };
 
-        if (m_cancelFunction)
-            m_cancelFunction(m_userData);
+    ~ThreadQueueLeases();
 
-        return true;
+    QSSGJobDeque *find(quint32 inPoolSerial) const
+    {
+        for (const Lease &lease : leases) {
+            if (lease.poolSerial == inPoolSerial)
+                return lease.queue;
+        }
+        return nullptr;
     }
 
-private:
-    void *m_userData;
-    QSSGTaskCallback m_function;
-    QSSGTaskCallback m_cancelFunction;
-    quint64 m_id;
-    TaskStates m_taskState;
-    QMutex m_mutex;
-    QSSGThreadPool *m_threadPool;
+    QVector<Lease> leases;
 };
 
+ThreadQueueLeases::~ThreadQueueLeases()
+{
+    if (leases.isEmpty() || g_livePools.isDestroyed())
+        return;
+    // Holding the mutex keeps the pool from deleting the deque under us
+    QMutexLocker locker(&g_livePoolsMutex);
+    for (const Lease &lease : qAsConst(leases)) {
+        if (g_livePools->contains(lease.poolSerial))
+            lease.queue->owner.storeRelease(0);
+    }
+}
+
+thread_local ThreadQueueLeases t_queueLeases;
+
 class QSSGThreadPool : public QSSGAbstractThreadPool
 {
 public:
-    QSSGThreadPool(quint32 numThreads);
+    explicit QSSGThreadPool(quint32 numThreads);
 
     ~QSSGThreadPool() override;
 
@@ -105,91 +242,474 @@ public:
 
     CancelReturnValues cancelTask(quint64 inTaskId) override;
 
-    // Called from another thread!
-    void taskFinished(quint64 inTaskId);
+    void parallelFor(qint32 inCount, qint32 inGrainSize, void *inUserData, QSSGRangeCallback inFunction) override;
+    using QSSGAbstractThreadPool::parallelFor;
+
+    // Called from the worker threads!
+    void workerLoop(qint32 inSlot);
 
 private:
-    static quint64 generateTaskID()
+    enum {
+        JobBlockSize = 256,
+        MaxJobBlocks = 256,
+        // Threads outside of the pool that can have a deque at the same time, any
+        // further thread uses the injection queue
+        ExternalQueueCount = 8,
+        // Rounds of looking for work before a worker goes to sleep
+        SpinCount = 64
+    };
+
+    QSSGJobDeque *currentQueue();
+    QSSGJob *jobAt(quint32 inIndex) const;
+    QSSGJob *jobForTask(quint64 inTaskId) const;
+
+    QSSGJob *allocateJob(QSSGJobDeque *inQueue);
+    void releaseJob(QSSGJob *inJob, QSSGJobDeque *inQueue);
+    bool popFreeJob(quint32 *outIndex);
+    void pushFreeJob(quint32 inIndex);
+    bool growJobs(quint32 *outIndex);
+
+    void inject(QSSGJob *inJob);
+    QSSGJob *takeInjected();
+
+    QSSGJob *findJob(QSSGJobDeque *inQueue);
+    void execute(QSSGJob *inJob, QSSGJobDeque *inQueue);
+    void runTask(QSSGJob *inJob, QSSGJobDeque *inQueue);
+    void runRange(QSSGJob *inJob, QSSGJobDeque *inQueue);
+    void finishRange(QSSGJob *inJob, QSSGJobDeque *inQueue);
+    void wakeWorker();
+
+    const quint32 m_serial;
+    qint32 m_workerCount;
+    // The deques of the workers followed by the external ones
+    QVector<QSSGJobDeque *> m_queues;
+    QVector<QThread *> m_workers;
+
+    QAtomicPointer<QSSGJob> m_jobBlocks[MaxJobBlocks];
+    QAtomicInt m_jobBlockCount { 0 };
+    QMutex m_growMutex;
+    // tag << 32 | (index + 1) of the first free slot, the tag prevents ABA
+    QAtomicInteger<quint64> m_freeHead { 0 };
+
+    // Tasks of the threads that did not get an external deque
+    QMutex m_injectedMutex;
+    QQueue<QSSGJob *> m_injected;
+    QAtomicInt m_injectedCount { 0 };
+
+    QAtomicInt m_sleepers { 0 };
+    QAtomicInt m_quit { 0 };
+    QSemaphore m_wakeup;
+};
+
+class QSSGWorkerThread : public QThread
+{
+public:
+    QSSGWorkerThread(QSSGThreadPool *inPool, qint32 inSlot) : m_pool(inPool), m_slot(inSlot)
     {
-        static quint64 taskID = 0;
-        return taskID++;
+        setObjectName(QStringLiteral("QSSGThreadPool worker %1").arg(inSlot));
     }
 
-    QThreadPool m_threadPool;
-    QHash<quint64, QSSGTask *> m_taskMap;
-    QMutex m_mutex;
+protected:
+    void run() override { m_pool->workerLoop(m_slot); }
+
+private:
+    QSSGThreadPool *m_pool;
+    qint32 m_slot;
 };
 
-void QSSGTask::run()
+QSSGThreadPool::QSSGThreadPool(quint32 numThreads)
+    : m_serial(s_nextPoolSerial.fetchAndAddRelaxed(1))
+    , m_workerCount(qMax(1, int(numThreads)))
+{
+    {
+        QMutexLocker locker(&g_livePoolsMutex);
+        g_livePools->append(m_serial);
+    }
+    for (qint32 slot = 0; slot < m_workerCount + ExternalQueueCount; ++slot)
+        m_queues.append(new QSSGJobDeque(slot));
+    for (qint32 slot = 0; slot < m_workerCount; ++slot) {
+        QThread *worker = new QSSGWorkerThread(this, slot);
+        m_workers.append(worker);
+        worker->start();
+    }
+}
+
+QSSGThreadPool::~QSSGThreadPool()
 {
+    m_quit.storeRelease(1);
+    m_wakeup.release(m_workerCount);
+    for (QThread *worker : qAsConst(m_workers)) {
+        worker->wait();
+        delete worker;
+    }
+
+    // Exiting threads must not touch the deques anymore
     {
-        QMutexLocker locker(&m_mutex);
-        m_taskState = TaskStates::Running;
+        QMutexLocker locker(&g_livePoolsMutex);
+        g_livePools->removeOne(m_serial);
     }
 
-    doFunction();
+    // Cancel the tasks that never ran, the workers are gone so nothing races for them
+    const auto cancelQueued = [](QSSGJob *inJob) {
+        if (inJob->kind == QSSGJob::Kind::Task && QSSGJob::state(inJob->control.load()) == Queued && inJob->cancelFunction)
+            inJob->cancelFunction(inJob->userData);
+    };
+    for (QSSGJobDeque *queue : qAsConst(m_queues)) {
+        while (QSSGJob *job = queue->steal())
+            cancelQueued(job);
+        delete queue;
+    }
+    for (QSSGJob *job : qAsConst(m_injected))
+        cancelQueued(job);
+    for (qint32 block = 0, end = m_jobBlockCount.load(); block < end; ++block)
+        delete[] m_jobBlocks[block].load();
+}
 
-    m_threadPool->taskFinished(m_id);
+QSSGJobDeque *QSSGThreadPool::currentQueue()
+{
+    if (t_queueCache.poolSerial == m_serial)
+        return t_queueCache.queue;
+
+    QSSGJobDeque *queue = t_queueLeases.find(m_serial);
+    if (!queue) {
+        const quintptr self = quintptr(QThread::currentThreadId());
+        for (qint32 slot = m_workerCount; slot < m_queues.size() && !queue; ++slot) {
+            if (m_queues.at(slot)->owner.testAndSetOrdered(0, self))
+                queue = m_queues.at(slot);
+        }
+        if (queue)
+            t_queueLeases.leases.append({ m_serial, queue });
+    }
+    if (queue) {
+        t_queueCache.poolSerial = m_serial;
+        t_queueCache.queue = queue;
+    }
+    return queue;
 }
 
-QSSGThreadPool::QSSGThreadPool(quint32 numThreads)
+QSSGJob *QSSGThreadPool::jobAt(quint32 inIndex) const
 {
-    m_threadPool.setMaxThreadCount(int(numThreads));
+    return m_jobBlocks[inIndex / JobBlockSize].loadAcquire() + inIndex % JobBlockSize;
 }
 
-QSSGThreadPool::~QSSGThreadPool()
+QSSGJob *QSSGThreadPool::jobForTask(quint64 inTaskId) const
 {
-    QMutexLocker locker(&m_mutex);
-    for (auto task : m_taskMap.values()) {
-        if (m_threadPool.tryTake(task))
-            task->doCancel();
-        delete task;
+    const quint32 index = quint32(inTaskId);
+    if (index / JobBlockSize >= quint32(m_jobBlockCount.loadAcquire()))
+        return nullptr;
+    return jobAt(index);
+}
+
+QSSGJob *QSSGThreadPool::allocateJob(QSSGJobDeque *inQueue)
+{
+    quint32 index;
+    if (inQueue && inQueue->freeJobCount > 0)
+        index = inQueue->freeJobs[--inQueue->freeJobCount];
+    else if (!popFreeJob(&index) && !growJobs(&index))
+        return nullptr;
+    return jobAt(index);
+}
+
+void QSSGThreadPool::releaseJob(QSSGJob *inJob, QSSGJobDeque *inQueue)
+{
+    // A new generation invalidates the task id handed out for the slot
+    const quint32 generation = quint32(inJob->control.load() >> 8) + 1;
+    inJob->control.storeRelease(quint64(generation) << 8 | Free);
+    if (inQueue && inQueue->freeJobCount < QSSGJobDeque::FreeCacheSize)
+        inQueue->freeJobs[inQueue->freeJobCount++] = inJob->index;
+    else
+        pushFreeJob(inJob->index);
+}
+
+bool QSSGThreadPool::popFreeJob(quint32 *outIndex)
+{
+    quint64 head = m_freeHead.loadAcquire();
+    while (quint32(head) != 0) {
+        const quint32 index = quint32(head) - 1;
+        const quint64 newHead = ((head >> 32) + 1) << 32 | jobAt(index)->nextFree.load();
+        if (m_freeHead.testAndSetAcquire(head, newHead, head)) {
+            *outIndex = index;
+            return true;
+        }
     }
+    return false;
+}
+
+void QSSGThreadPool::pushFreeJob(quint32 inIndex)
+{
+    QSSGJob *job = jobAt(inIndex);
+    quint64 head = m_freeHead.load();
+    quint64 newHead;
+    do {
+        job->nextFree.store(quint32(head));
+        newHead = ((head >> 32) + 1) << 32 | (inIndex + 1);
+    } while (!m_freeHead.testAndSetRelease(head, newHead, head));
+}
+
+bool QSSGThreadPool::growJobs(quint32 *outIndex)
+{
+    QMutexLocker locker(&m_growMutex);
+    // Another thread may have grown the slots while this one waited
+    if (popFreeJob(outIndex))
+        return true;
+    const qint32 blockCount = m_jobBlockCount.load();
+    if (blockCount == MaxJobBlocks)
+        return false;
+
+    QSSGJob *block = new QSSGJob[JobBlockSize];
+    const quint32 first = quint32(blockCount) * JobBlockSize;
+    for (quint32 idx = 0; idx < JobBlockSize; ++idx)
+        block[idx].index = first + idx;
+    m_jobBlocks[blockCount].storeRelease(block);
+    m_jobBlockCount.storeRelease(blockCount + 1);
+    for (quint32 idx = 1; idx < JobBlockSize; ++idx)
+        pushFreeJob(first + idx);
+    *outIndex = first;
+    return true;
 }
 
 quint64 QSSGThreadPool::addTask(void *inUserData, QSSGTaskCallback inFunction, QSSGTaskCallback inCancelFunction)
 {
-    QMutexLocker locker(&m_mutex);
-    const quint64 taskID = generateTaskID();
-    auto task = new QSSGTask(inUserData, inFunction, inCancelFunction, taskID, this);
-    m_taskMap.insert(taskID, task);
-    m_threadPool.start(task);
-    return taskID;
+    QSSGJobDeque *queue = currentQueue();
+    QSSGJob *job = allocateJob(queue);
+    if (!job) {
+        // Out of job slots, the task is done before anyone could ask for it
+        if (inFunction)
+            inFunction(inUserData);
+        return ~quint64(0);
+    }
+
+    job->kind = QSSGJob::Kind::Task;
+    job->userData = inUserData;
+    job->function = inFunction;
+    job->cancelFunction = inCancelFunction;
+    job->control.storeRelease(job->generationBits() | Queued);
+    const quint64 taskId = job->taskId();
+
+    if (!queue) {
+        inject(job);
+    } else if (!queue->push(job)) {
+        runTask(job, queue);
+        return taskId;
+    }
+    wakeWorker();
+    return taskId;
 }
 
 TaskStates QSSGThreadPool::getTaskState(quint64 inTaskId)
 {
-    QMutexLocker locker(&m_mutex);
-    auto task = m_taskMap.value(inTaskId, nullptr);
-    if (!task)
+    const QSSGJob *job = jobForTask(inTaskId);
+    if (!job)
         return TaskStates::UnknownTask;
-    return task->taskState();
+    const quint64 control = job->control.loadAcquire();
+    if (control >> 8 != inTaskId >> 32)
+        return TaskStates::UnknownTask;
+    switch (QSSGJob::state(control)) {
+    case Queued:
+        return TaskStates::Queued;
+    case Running:
+        return TaskStates::Running;
+    default:
+        return TaskStates::UnknownTask;
+    }
 }
 
 CancelReturnValues QSSGThreadPool::cancelTask(quint64 inTaskId)
 {
-    QMutexLocker locker(&m_mutex);
-    auto task = m_taskMap.value(inTaskId, nullptr);
-    if (!task)
+    QSSGJob *job = jobForTask(inTaskId);
+    if (!job)
         return CancelReturnValues::TaskNotFound;
+    const quint64 generationBits = (inTaskId >> 32) << 8;
+    quint64 current;
+    if (!job->control.testAndSetOrdered(generationBits | Queued, generationBits | Canceling, current))
+        return current == (generationBits | Running) ? CancelReturnValues::TaskRunning : CancelReturnValues::TaskNotFound;
+
+    if (job->cancelFunction)
+        job->cancelFunction(job->userData);
+    // If a worker popped the job in the meantime it left the slot to us
+    if (!job->control.testAndSetOrdered(generationBits | Canceling, generationBits | Canceled))
+        releaseJob(job, currentQueue());
+    return CancelReturnValues::TaskCanceled;
+}
+
+void QSSGThreadPool::parallelFor(qint32 inCount, qint32 inGrainSize, void *inUserData, QSSGRangeCallback inFunction)
+{
+    if (inCount <= 0)
+        return;
+    const qint32 grainSize = qMax(1, inGrainSize);
+    QSSGJobDeque *queue = inCount > grainSize ? currentQueue() : nullptr;
+    QSSGJob *root = queue ? allocateJob(queue) : nullptr;
+    if (!root) {
+        inFunction(inUserData, 0, inCount);
+        return;
+    }
+
+    QAtomicInt completed(0);
+    root->kind = QSSGJob::Kind::Range;
+    root->userData = inUserData;
+    root->rangeFunction = inFunction;
+    root->begin = 0;
+    root->end = inCount;
+    root->grainSize = grainSize;
+    root->parent = nullptr;
+    root->completed = &completed;
+    root->unfinished.store(1);
+    runRange(root, queue);
+
+    // Help with whatever is left until the ranges stolen by others are done
+    while (!completed.loadAcquire()) {
+        if (QSSGJob *job = findJob(queue))
+            execute(job, queue);
+        else
+            QThread::yieldCurrentThread();
+    }
+}
+
+void QSSGThreadPool::workerLoop(qint32 inSlot)
+{
+    QSSGJobDeque *queue = m_queues.at(inSlot);
+    queue->owner.storeRelease(quintptr(QThread::currentThreadId()));
+    t_queueCache.poolSerial = m_serial;
+    t_queueCache.queue = queue;
+
+    qint32 idleRounds = 0;
+    while (!m_quit.loadAcquire()) {
+        if (QSSGJob *job = findJob(queue)) {
+            execute(job, queue);
+            idleRounds = 0;
+            continue;
+        }
+        if (++idleRounds < SpinCount) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        // Announce the sleep before the last look, wakeWorker() checks in the opposite order
+        m_sleepers.fetchAndAddOrdered(1);
+        if (QSSGJob *job = findJob(queue)) {
+            m_sleepers.fetchAndSubOrdered(1);
+            execute(job, queue);
+        } else {
+            m_wakeup.acquire();
+            m_sleepers.fetchAndSubOrdered(1);
+        }
+        idleRounds = 0;
+    }
+}
+
+void QSSGThreadPool::inject(QSSGJob *inJob)
+{
+    QMutexLocker locker(&m_injectedMutex);
+    m_injected.enqueue(inJob);
+    m_injectedCount.storeRelease(m_injected.size());
+}
+
+QSSGJob *QSSGThreadPool::takeInjected()
+{
+    // Checked without the mutex, inject() happens before the worker is woken up
+    if (!m_injectedCount.loadAcquire())
+        return nullptr;
+    QMutexLocker locker(&m_injectedMutex);
+    if (m_injected.isEmpty())
+        return nullptr;
+    QSSGJob *job = m_injected.dequeue();
+    m_injectedCount.storeRelease(m_injected.size());
+    return job;
+}
+
+QSSGJob *QSSGThreadPool::findJob(QSSGJobDeque *inQueue)
+{
+    if (QSSGJob *job = inQueue->pop())
+        return job;
+    if (QSSGJob *job = takeInjected())
+        return job;
+    // Start with the next deque so the thieves spread over the victims
+    const qint32 count = m_queues.size();
+    for (qint32 offset = 1; offset < count; ++offset) {
+        if (QSSGJob *job = m_queues.at((inQueue->slot + offset) % count)->steal())
+            return job;
+    }
+    return nullptr;
+}
+
+void QSSGThreadPool::execute(QSSGJob *inJob, QSSGJobDeque *inQueue)
+{
+    if (inJob->kind == QSSGJob::Kind::Task)
+        runTask(inJob, inQueue);
+    else
+        runRange(inJob, inQueue);
+}
 
-    if (m_threadPool.tryTake(task))
-        if (task->doCancel()) {
-            auto task = m_taskMap.value(inTaskId);
-            delete task;
-            m_taskMap.remove(inTaskId);
-            return CancelReturnValues::TaskCanceled;
+void QSSGThreadPool::runTask(QSSGJob *inJob, QSSGJobDeque *inQueue)
+{
+    const quint64 generationBits = inJob->generationBits();
+    quint64 current;
+    if (inJob->control.testAndSetOrdered(generationBits | Queued, generationBits | Running, current)) {
+        if (inJob->function)
+            inJob->function(inJob->userData);
+        releaseJob(inJob, inQueue);
+        return;
+    }
+    // Canceled, the slot goes to whoever of us and cancelTask() is last
+    if (current == (generationBits | Canceling)
+        && inJob->control.testAndSetOrdered(generationBits | Canceling, generationBits | Dropped)) {
+        return;
+    }
+    releaseJob(inJob, inQueue);
+}
+
+void QSSGThreadPool::runRange(QSSGJob *inJob, QSSGJobDeque *inQueue)
+{
+    // Keep the lower half and offer the upper half to the thieves until the range is small
+    // enough. The thieves take the oldest, so the largest, halves first.
+    qint32 end = inJob->end;
+    while (end - inJob->begin > inJob->grainSize) {
+        QSSGJob *child = allocateJob(inQueue);
+        if (!child)
+            break;
+        const qint32 middle = inJob->begin + (end - inJob->begin) / 2;
+        child->kind = QSSGJob::Kind::Range;
+        child->userData = inJob->userData;
+        child->rangeFunction = inJob->rangeFunction;
+        child->begin = middle;
+        child->end = end;
+        child->grainSize = inJob->grainSize;
+        child->parent = inJob;
+        child->completed = nullptr;
+        child->unfinished.store(1);
+        inJob->unfinished.fetchAndAddRelaxed(1);
+        if (!inQueue->push(child)) {
+            inJob->unfinished.fetchAndSubRelaxed(1);
+            releaseJob(child, inQueue);
+            break;
         }
+        wakeWorker();
+        end = middle;
+    }
+    inJob->rangeFunction(inJob->userData, inJob->begin, end);
+    finishRange(inJob, inQueue);
+}
 
-    return CancelReturnValues::TaskRunning;
+void QSSGThreadPool::finishRange(QSSGJob *inJob, QSSGJobDeque *inQueue)
+{
+    // The last range to finish completes its parent
+    for (QSSGJob *job = inJob; job;) {
+        if (job->unfinished.deref())
+            return;
+        QSSGJob *parent = job->parent;
+        if (!parent)
+            job->completed->storeRelease(1);
+        releaseJob(job, inQueue);
+        job = parent;
+    }
 }
 
-void QSSGThreadPool::taskFinished(quint64 inTaskId)
+void QSSGThreadPool::wakeWorker()
 {
-    QMutexLocker locker(&m_mutex);
-    auto task = m_taskMap.value(inTaskId);
-    delete task;
-    m_taskMap.remove(inTaskId);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int sleepers = m_sleepers.load();
+    if (sleepers > 0 && m_wakeup.available() < sleepers)
+        m_wakeup.release();
 }
 }
 
@@ -46,9 +46,13 @@
 
 #include <QtCore/QSharedPointer>
 
+#include <type_traits>
+
 QT_BEGIN_NAMESPACE
 
 using QSSGTaskCallback = void (*)(void *);
+// Processes the indices [inBegin, inEnd) of a parallelFor
+using QSSGRangeCallback = void (*)(void *inUserData, qint32 inBegin, qint32 inEnd);
 
 enum class TaskStates
 {
@@ -79,6 +83,21 @@ public:
     virtual TaskStates getTaskState(quint64 inTaskId) = 0;
     virtual CancelReturnValues cancelTask(quint64 inTaskId) = 0;
 
+    // Calls inFunction for the indices [0, inCount) split into ranges of at most
+    // inGrainSize indices. The calling thread takes part in the work and the call
+    // returns once every range was processed, so it may also be used from within a task.
+    virtual void parallelFor(qint32 inCount, qint32 inGrainSize, void *inUserData, QSSGRangeCallback inFunction) = 0;
+
+    template<typename Function>
+    void parallelFor(qint32 inCount, qint32 inGrainSize, Function &&inFunction)
+    {
+        using FunctionType = typename std::remove_reference<Function>::type;
+        void *userData = const_cast<void *>(static_cast<const void *>(&inFunction));
+        parallelFor(inCount, inGrainSize, userData, [](void *inUserData, qint32 inBegin, qint32 inEnd) {
+            (*static_cast<FunctionType *>(inUserData))(inBegin, inEnd);
+        });
+    }
+
     static QSSGRef<QSSGAbstractThreadPool> createThreadPool(quint32 inNumThreads = 4);
 };
 QT_END_NAMESPACE
@@ -185,6 +185,28 @@ void QSSGSubsetRenderableBase::renderDepthPass(const QVector2D &inCameraVec, QSS
     context->draw(subset.primitiveType, subset.count, subset.offset);
 }
 
+void QSSGSubsetRenderableBase::renderVelocityPass()
+{
+    // Tessellated subsets are left out, they keep a zero velocity
+    if (subset.primitiveType == QSSGRenderDrawMode::Patches)
+        return;
+
+    const auto &context = generator->context();
+    QSSGRef<QSSGLayerVelocityShader> shader = generator->getLayerVelocityShader();
+    if (shader.isNull())
+        return;
+
+    context->setActiveShader(shader->shader);
+    context->setCullingEnabled(true);
+
+    shader->mvp.set(modelContext.modelViewProjection);
+    shader->currentMvp.set(modelContext.unjitteredModelViewProjection);
+    shader->previousMvp.set(modelContext.previousModelViewProjection);
+
+    context->setInputAssembler(subset.inputAssemblerDepth);
+    context->draw(subset.primitiveType, subset.count, subset.offset);
+}
+
 // An interface to the shader generator that is available to the renderables
 
 QSSGSubsetRenderable::QSSGSubsetRenderable(QSSGRenderableObjectFlags inFlags,
@@ -211,22 +233,25 @@ void QSSGSubsetRenderable::render(const QVector2D &inCameraVec, const TShaderFea
 {
     const auto &context = generator->context();
 
-    const QSSGRef<QSSGShaderGeneratorGeneratedShader> &shader = generator->getShader(*this, inFeatureSet);
+    bool isFallback = false;
+    const QSSGRef<QSSGShaderGeneratorGeneratedShader> &shader = generator->getShader(*this, inFeatureSet, &isFallback);
     if (shader == nullptr)
         return;
 
     context->setActiveShader(shader->shader);
 
-    generator->demonContext()->defaultMaterialShaderGenerator()->setMaterialProperties(shader->shader,
-                                                                                             material,
-                                                                                             inCameraVec,
-                                                                                             modelContext.modelViewProjection,
-                                                                                             modelContext.normalMatrix,
-                                                                                             modelContext.model.globalTransform,
-                                                                                             firstImage,
-                                                                                             opacity,
-                                                                                             generator->getLayerGlobalRenderProperties(),
-                                                                                             renderableFlags.receivesShadows());
+    const QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> &materialGenerator = generator->demonContext()->defaultMaterialShaderGenerator();
+    materialGenerator->setObjectConstantsOffset(objectConstantsOffset);
+    materialGenerator->setMaterialProperties(shader->shader,
+                                             material,
+                                             inCameraVec,
+                                             modelContext.modelViewProjection,
+                                             modelContext.normalMatrix,
+                                             modelContext.model.globalTransform,
+                                             isFallback ? nullptr : firstImage,
+                                             opacity,
+                                             generator->getLayerGlobalRenderProperties(),
+                                             renderableFlags.receivesShadows());
 
     // tesselation
     if (subset.primitiveType == QSSGRenderDrawMode::Patches) {
@@ -184,10 +184,16 @@ struct QSSGModelContext
     const QSSGRenderModel &model;
     QMatrix4x4 modelViewProjection;
     QMatrix3x3 normalMatrix;
+    // Without the temporal AA jitter, for this and the previous frame. The
+    // difference between the two is what the velocity pass writes.
+    QMatrix4x4 unjitteredModelViewProjection;
+    QMatrix4x4 previousModelViewProjection;
 
     QSSGModelContext(const QSSGRenderModel &inModel, const QMatrix4x4 &inViewProjection) : model(inModel)
     {
         model.calculateMVPAndNormalMatrix(inViewProjection, modelViewProjection, normalMatrix);
+        unjitteredModelViewProjection = modelViewProjection;
+        previousModelViewProjection = modelViewProjection;
     }
 };
 
@@ -216,6 +222,8 @@ struct QSSGSubsetRenderableBase : public QSSGRenderableObject
                              QSSGShadowMapEntry *inShadowMapEntry) const;
 
     void renderDepthPass(const QVector2D &inCameraVec, QSSGRenderableImage *inDisplacementImage, float inDisplacementAmount);
+
+    void renderVelocityPass();
 };
 
 Q_STATIC_ASSERT(std::is_trivially_destructible<QSSGSubsetRenderableBase>::value);
@@ -231,6 +239,9 @@ struct QSSGSubsetRenderable : public QSSGSubsetRenderableBase
     QSSGRenderableImage *firstImage;
     QSSGShaderDefaultMaterialKey shaderDescription;
     QSSGDataView<QMatrix4x4> bones;
+    // Offset of the object constants in the ring buffer of the default material shader
+    // generator, -1 until they are uploaded with the pass.
+    qint32 objectConstantsOffset = -1;
 
     QSSGSubsetRenderable(QSSGRenderableObjectFlags inFlags,
                            const QVector3D &inWorldCenterPt,
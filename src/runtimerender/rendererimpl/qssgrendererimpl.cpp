@@ -47,11 +47,14 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderdefaultmaterialshadergenerator_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderpathmanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgperframeallocator_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
 
 #include <QtQuick3DRender/private/qssgrenderframebuffer_p.h>
 #include <QtQuick3DUtils/private/qssgdataref_p.h>
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
+#include <QtCore/QSemaphore>
+
 #include <cstdlib>
 #include <algorithm>
 
@@ -97,6 +100,9 @@ QSSGRendererImpl::QSSGRendererImpl(const QSSGRef<QSSGRenderContextInterface> &ct
     , m_layerCachingEnabled(true)
     , m_layerGPuProfilingEnabled(false)
 {
+    const bool asyncDisabled = qEnvironmentVariableIsSet("QUICK3D_ASYNC_SHADERS")
+            && qEnvironmentVariableIntValue("QUICK3D_ASYNC_SHADERS") == 0;
+    m_asyncShaderGeneration = !asyncDisabled && ctx->threadPool();
 }
 
 QSSGRendererImpl::~QSSGRendererImpl()
@@ -417,11 +423,18 @@ void QSSGRendererImpl::setupWidgetLayer()
 
 void QSSGRendererImpl::beginFrame()
 {
+    resolvePendingShaders();
     for (int idx = 0, end = m_lastFrameLayers.size(); idx < end; ++idx)
         m_lastFrameLayers[idx]->resetForFrame();
     m_lastFrameLayers.clear();
     m_beginFrameViewport = m_demonContext->renderList()->getViewport();
 }
+
+bool QSSGRendererImpl::hasPendingShaders() const
+{
+    return !m_pendingShaders.isEmpty();
+}
+
 void QSSGRendererImpl::endFrame()
 {
     if (m_widgetTexture) {
@@ -459,6 +472,9 @@ void QSSGRendererImpl::endFrame()
     }
 }
 
+// Rays picked by one task of the thread pool in a batched pick
+const qint32 PICK_BATCH_GRAIN_SIZE = 16;
+
 inline bool pickResultLessThan(const QSSGRenderPickResult &lhs, const QSSGRenderPickResult &rhs)
 {
     return lhs.m_cameraDistanceSq < rhs.m_cameraDistanceSq;
@@ -1005,6 +1021,7 @@ void QSSGRendererImpl::beginLayerRender(QSSGLayerRenderData &inLayer)
 }
 void QSSGRendererImpl::endLayerRender()
 {
+    generateRequestedShaders();
     m_currentLayer = nullptr;
 }
 
@@ -1089,6 +1106,17 @@ static inline QSSGRenderPickSubResult constructSubResult(QSSGRenderableImage &in
     return constructSubResult(inImage.m_image);
 }
 
+static inline const QSSGRenderGraphObject *getPickObject(QSSGRenderableObject &inRenderableObject)
+{
+    if (inRenderableObject.renderableFlags.isDefaultMaterialMeshSubset())
+        return &static_cast<QSSGSubsetRenderable *>(&inRenderableObject)->modelContext.model;
+    if (inRenderableObject.renderableFlags.isCustomMaterialMeshSubset())
+        return &static_cast<QSSGCustomMaterialRenderable *>(&inRenderableObject)->modelContext.model;
+    if (inRenderableObject.renderableFlags.isPath())
+        return &static_cast<QSSGPathRenderable *>(&inRenderableObject)->m_path;
+    return nullptr;
+}
+
 void QSSGRendererImpl::intersectRayWithSubsetRenderable(const QSSGRenderRay &inRay,
                                                           QSSGRenderableObject &inRenderableObject,
                                                           TPickResultArray &outIntersectionResultList)
@@ -1099,14 +1127,7 @@ void QSSGRendererImpl::intersectRayWithSubsetRenderable(const QSSGRenderRay &inR
         return;
 
     // Leave the coordinates relative for right now.
-    const QSSGRenderGraphObject *thePickObject = nullptr;
-    if (inRenderableObject.renderableFlags.isDefaultMaterialMeshSubset())
-        thePickObject = &static_cast<QSSGSubsetRenderable *>(&inRenderableObject)->modelContext.model;
-    else if (inRenderableObject.renderableFlags.isCustomMaterialMeshSubset())
-        thePickObject = &static_cast<QSSGCustomMaterialRenderable *>(&inRenderableObject)->modelContext.model;
-    else if (inRenderableObject.renderableFlags.isPath())
-        thePickObject = &static_cast<QSSGPathRenderable *>(&inRenderableObject)->m_path;
-
+    const QSSGRenderGraphObject *thePickObject = getPickObject(inRenderableObject);
     if (thePickObject != nullptr) {
         outIntersectionResultList.push_back(
                 QSSGRenderPickResult(*thePickObject, intersectionResult.rayLengthSquared, intersectionResult.relXY));
@@ -1131,6 +1152,198 @@ void QSSGRendererImpl::intersectRayWithSubsetRenderable(const QSSGRenderRay &inR
     }
 }
 
+QSSGLayerRenderData *QSSGRendererImpl::getPickableLayerData(QSSGRenderLayer &inLayer, const QSSGRenderInstanceId id) const
+{
+    if (!inLayer.flags.testFlag(QSSGRenderLayer::Flag::Active))
+        return nullptr;
+    const auto theIter = m_instanceRenderMap.constFind(combineLayerAndId(&inLayer, id));
+    if (theIter == m_instanceRenderMap.cend())
+        return nullptr;
+    // The same conditions as getLayerHitObjectList(), without the offscreen renderer case.
+    QSSGLayerRenderData *theLayerData = theIter.value().data();
+    if (!theLayerData->layer.flags.testFlag(QSSGRenderLayer::Flag::LayerRenderToTarget) || theLayerData->camera == nullptr
+        || !theLayerData->layerPrepResult.hasValue() || theLayerData->lastFrameOffscreenRenderer != nullptr)
+        return nullptr;
+    return theLayerData;
+}
+
+const QVector<QSSGRenderPickTarget> &QSSGRendererImpl::getPickTargets(QSSGLayerRenderData &inLayer)
+{
+    QVector<QSSGRenderPickTarget> &theTargets = inLayer.m_pickTargets;
+    if (!theTargets.isEmpty())
+        return theTargets;
+
+    // In the order getLayerHitObjectList() visits them, so equally distant hits are
+    // reported the same way.
+    const auto addTargets = [&theTargets](const QSSGLayerRenderPreparationData::TRenderableObjectList &inObjects) {
+        for (int idx = inObjects.size(), end = 0; idx > end; --idx) {
+            QSSGRenderableObject &theRenderableObject = *inObjects.at(idx - 1);
+            const QSSGRenderGraphObject *thePickObject = getPickObject(theRenderableObject);
+            if (thePickObject == nullptr)
+                continue;
+            QSSGRenderPickTarget theTarget;
+            theTarget.object = thePickObject;
+            theTarget.globalTransform = theRenderableObject.globalTransform;
+            theTarget.inverseGlobalTransform = theRenderableObject.globalTransform.inverted();
+            theTarget.bounds = theRenderableObject.bounds;
+            theTarget.pickable = theRenderableObject.renderableFlags.isPickable();
+            theTargets.push_back(theTarget);
+        }
+    };
+    addTargets(inLayer.opaqueObjects);
+    addTargets(inLayer.transparentObjects);
+    return theTargets;
+}
+
+QSSGRenderPickBatchResult QSSGRendererImpl::pickRays(QSSGLayerRenderData *inLayer,
+                                                     const QVector<QSSGOption<QSSGRenderRay>> &inRays,
+                                                     bool inPickEverything)
+{
+    const qint32 theRayCount = inRays.size();
+    QVector<TPickResultArray> theRayHits(theRayCount);
+    if (inLayer != nullptr) {
+        const QVector<QSSGRenderPickTarget> &theTargets = getPickTargets(*inLayer);
+        const QSSGRenderPickTarget *theTargetData = theTargets.constData();
+        const qint32 theTargetCount = theTargets.size();
+        const QSSGOption<QSSGRenderRay> *theRays = inRays.constData();
+        TPickResultArray *theHits = theRayHits.data();
+        m_demonContext->threadPool()->parallelFor(theRayCount, PICK_BATCH_GRAIN_SIZE, [=](qint32 inBegin, qint32 inEnd) {
+            for (qint32 rayIdx = inBegin; rayIdx < inEnd; ++rayIdx) {
+                if (!theRays[rayIdx].hasValue())
+                    continue;
+                const QSSGRenderRay &theRay = *theRays[rayIdx];
+                TPickResultArray &theResults = theHits[rayIdx];
+                for (qint32 idx = 0; idx < theTargetCount; ++idx) {
+                    const QSSGRenderPickTarget &theTarget = theTargetData[idx];
+                    if (!inPickEverything && !theTarget.pickable)
+                        continue;
+                    const QSSGRenderRay::IntersectionResult theIntersection =
+                            theRay.intersectWithAABB(theTarget.globalTransform, theTarget.inverseGlobalTransform, theTarget.bounds);
+                    if (!theIntersection.intersects)
+                        continue;
+                    // A model with several subsets is reported once, at its nearest subset.
+                    auto theExisting = std::find_if(theResults.begin(), theResults.end(), [&theTarget](const QSSGRenderPickResult &inResult) {
+                        return inResult.m_hitObject == theTarget.object;
+                    });
+                    const QSSGRenderPickResult theHit(*theTarget.object, theIntersection.rayLengthSquared, theIntersection.relXY);
+                    if (theExisting == theResults.end())
+                        theResults.push_back(theHit);
+                    else if (theHit.m_cameraDistanceSq < theExisting->m_cameraDistanceSq)
+                        *theExisting = theHit;
+                }
+                std::stable_sort(theResults.begin(), theResults.end(), pickResultLessThan);
+            }
+        });
+    }
+
+    QSSGRenderPickBatchResult theResult;
+    theResult.rayOffsets.reserve(theRayCount + 1);
+    theResult.rayOffsets.push_back(0);
+    for (const TPickResultArray &theHits : qAsConst(theRayHits)) {
+        theResult.hits.append(theHits);
+        theResult.rayOffsets.push_back(theResult.hits.size());
+    }
+    return theResult;
+}
+
+QSSGRenderPickBatchResult QSSGRendererImpl::pickBatch(QSSGRenderLayer &inLayer,
+                                                      const QVector2D &inViewportDimensions,
+                                                      const QVector<QVector2D> &inMouseCoords,
+                                                      bool inPickEverything,
+                                                      const QSSGRenderInstanceId id)
+{
+    QSSGLayerRenderData *theLayerData = getPickableLayerData(inLayer, id);
+    QVector<QSSGOption<QSSGRenderRay>> theRays(inMouseCoords.size());
+    if (theLayerData != nullptr) {
+        for (int idx = 0, end = inMouseCoords.size(); idx < end; ++idx)
+            theRays[idx] = theLayerData->layerPrepResult->pickRay(inMouseCoords.at(idx), inViewportDimensions, false);
+    }
+    return pickRays(theLayerData, theRays, inPickEverything);
+}
+
+QSSGRenderPickBatchResult QSSGRendererImpl::pickBatch(QSSGRenderLayer &inLayer,
+                                                      const QVector<QSSGRenderRay> &inRays,
+                                                      bool inPickEverything,
+                                                      const QSSGRenderInstanceId id)
+{
+    QVector<QSSGOption<QSSGRenderRay>> theRays;
+    theRays.reserve(inRays.size());
+    for (const QSSGRenderRay &theRay : inRays)
+        theRays.push_back(theRay);
+    return pickRays(getPickableLayerData(inLayer, id), theRays, inPickEverything);
+}
+
+QVector<const QSSGRenderGraphObject *> QSSGRendererImpl::pickFrustum(QSSGRenderLayer &inLayer,
+                                                                     const QVector2D &inViewportDimensions,
+                                                                     const QRectF &inRect,
+                                                                     bool inPickEverything,
+                                                                     const QSSGRenderInstanceId id)
+{
+    QVector<const QSSGRenderGraphObject *> theObjects;
+    QSSGLayerRenderData *theLayerData = getPickableLayerData(inLayer, id);
+    const QRectF theRect = inRect.normalized();
+    if (theLayerData == nullptr || theRect.width() <= 0 || theRect.height() <= 0)
+        return theObjects;
+
+    // The rays through the corners are forced, a rect reaching out of the layer selects what
+    // is inside of it.
+    const QSSGLayerRenderPreparationResult &thePrepResult(*theLayerData->layerPrepResult);
+    const QPointF theCorners[4] = { theRect.topLeft(), theRect.topRight(), theRect.bottomRight(), theRect.bottomLeft() };
+    QSSGRenderRay theCornerRays[4];
+    for (int idx = 0; idx < 4; ++idx) {
+        const QSSGOption<QSSGRenderRay> theRay = thePrepResult.pickRay(QVector2D(theCorners[idx]), inViewportDimensions, true);
+        if (!theRay.hasValue())
+            return theObjects;
+        theCornerRays[idx] = *theRay;
+    }
+    const QSSGOption<QSSGRenderRay> theCenterRay = thePrepResult.pickRay(QVector2D(theRect.center()), inViewportDimensions, true);
+    if (!theCenterRay.hasValue())
+        return theObjects;
+    const QVector3D theInsidePoint = theCenterRay->origin + theCenterRay->direction;
+
+    // Each side plane holds the rays of two neighboring corners, this works for perspective
+    // rays from the eye and for parallel orthographic rays. The last plane drops everything
+    // behind the camera. The normals point into the selection.
+    QSSGClipPlane thePlanes[5];
+    for (int idx = 0; idx < 4; ++idx) {
+        const QSSGRenderRay &theRay = theCornerRays[idx];
+        const QSSGRenderRay &theNextRay = theCornerRays[(idx + 1) % 4];
+        QVector3D theNormal = QVector3D::crossProduct(theRay.direction, theNextRay.origin + theNextRay.direction - theRay.origin);
+        if (theNormal.lengthSquared() <= 0.0f)
+            return theObjects;
+        theNormal.normalize();
+        thePlanes[idx].normal = theNormal;
+        thePlanes[idx].d = -QVector3D::dotProduct(theNormal, theRay.origin);
+        if (thePlanes[idx].distance(theInsidePoint) < 0.0f) {
+            thePlanes[idx].normal = -thePlanes[idx].normal;
+            thePlanes[idx].d = -thePlanes[idx].d;
+        }
+    }
+    thePlanes[4].normal = theCenterRay->direction.normalized();
+    thePlanes[4].d = -QVector3D::dotProduct(thePlanes[4].normal, theCenterRay->origin);
+
+    for (const QSSGRenderPickTarget &theTarget : getPickTargets(*theLayerData)) {
+        if ((!inPickEverything && !theTarget.pickable) || theObjects.contains(theTarget.object))
+            continue;
+        // Test the local bounds against the planes moved into the local space of the object
+        const QMatrix4x4 &theTransform = theTarget.globalTransform;
+        bool isInside = true;
+        for (int idx = 0; idx < 5 && isInside; ++idx) {
+            const QSSGClipPlane &thePlane = thePlanes[idx];
+            QSSGClipPlane theLocalPlane;
+            theLocalPlane.normal = QVector3D(QVector3D::dotProduct(theTransform.column(0).toVector3D(), thePlane.normal),
+                                             QVector3D::dotProduct(theTransform.column(1).toVector3D(), thePlane.normal),
+                                             QVector3D::dotProduct(theTransform.column(2).toVector3D(), thePlane.normal));
+            theLocalPlane.d = thePlane.d + QVector3D::dotProduct(theTransform.column(3).toVector3D(), thePlane.normal);
+            theLocalPlane.calculateBBoxEdges();
+            isInside = theLocalPlane.intersect(theTarget.bounds) >= 0;
+        }
+        if (isInside)
+            theObjects.push_back(theTarget.object);
+    }
+    return theObjects;
+}
+
 QSSGRef<QSSGRenderShaderProgram> QSSGRendererImpl::compileShader(const QByteArray &inName, const char *inVert, const char *inFrag)
 {
     getProgramGenerator()->beginProgram();
@@ -1165,14 +1378,35 @@ float translateQuadraticAttenuation(float attenuation)
 }
 
 QSSGRef<QSSGShaderGeneratorGeneratedShader> QSSGRendererImpl::getShader(QSSGSubsetRenderable &inRenderable,
-                                                                              const TShaderFeatureSet &inFeatureSet)
+                                                                              const TShaderFeatureSet &inFeatureSet,
+                                                                              bool *outIsFallback)
 {
     if (Q_UNLIKELY(m_currentLayer == nullptr)) {
         Q_ASSERT(false);
         return nullptr;
     }
+    if (outIsFallback)
+        *outIsFallback = false;
     auto shaderIt = m_shaders.constFind(inRenderable.shaderDescription);
-    if (shaderIt == m_shaders.cend()) {
+    if (shaderIt == m_shaders.cend() && m_asyncShaderGeneration) {
+        if (requestShader(inRenderable.shaderDescription, inRenderable, inRenderable.firstImage, inFeatureSet)) {
+            shaderIt = m_shaders.constFind(inRenderable.shaderDescription);
+        } else {
+            // Until the shader is ready, draw with the variant that has no images if that one
+            // is. Otherwise the object is skipped for now.
+            QSSGShaderDefaultMaterialKey theFallbackKey(inRenderable.shaderDescription);
+            for (quint32 idx = 0; idx < QSSGShaderDefaultMaterialKeyProperties::ImageMapCount; ++idx) {
+                m_defaultMaterialShaderKeyProperties.m_imageMaps[idx].setValue(theFallbackKey, 0);
+                m_defaultMaterialShaderKeyProperties.m_textureSwizzle[idx].setValue(theFallbackKey, 0);
+            }
+            if (theFallbackKey == inRenderable.shaderDescription
+                || !requestShader(theFallbackKey, inRenderable, nullptr, inFeatureSet))
+                return nullptr;
+            shaderIt = m_shaders.constFind(theFallbackKey);
+            if (outIsFallback)
+                *outIsFallback = true;
+        }
+    } else if (shaderIt == m_shaders.cend()) {
         // Generate the shader.
         const QSSGRef<QSSGRenderShaderProgram> &theShader(generateShader(inRenderable, inFeatureSet));
         if (theShader) {
@@ -1195,6 +1429,136 @@ QSSGRef<QSSGShaderGeneratorGeneratedShader> QSSGRendererImpl::getShader(QSSGSubs
     }
     return *shaderIt;
 }
+
+QByteArray QSSGRendererImpl::shaderQueryString(const QSSGShaderDefaultMaterialKey &inKey)
+{
+    QByteArray theString = QByteArrayLiteral("mesh subset pipeline-- ");
+    inKey.toString(theString, m_defaultMaterialShaderKeyProperties);
+    return theString;
+}
+
+// Returns true once m_shaders has an entry for the key, otherwise makes sure the shader
+// gets generated.
+bool QSSGRendererImpl::requestShader(const QSSGShaderDefaultMaterialKey &inKey,
+                                     QSSGSubsetRenderable &inRenderable,
+                                     QSSGRenderableImage *inFirstImage,
+                                     const TShaderFeatureSet &inFeatureSet)
+{
+    if (m_shaders.contains(inKey))
+        return true;
+
+    auto pendingIt = m_pendingShaders.find(inKey);
+    if (pendingIt == m_pendingShaders.end()) {
+        QSSGPendingShader thePending;
+        thePending.queryString = shaderQueryString(inKey);
+        // Another view of the share group may have compiled it already
+        thePending.program = m_demonContext->shaderCache()->getProgram(thePending.queryString, inFeatureSet);
+        pendingIt = m_pendingShaders.insert(inKey, thePending);
+        if (!thePending.program) {
+            m_shaderRequests.append(QSSGShaderRequest{ inKey,
+                                                       &inRenderable,
+                                                       inFirstImage,
+                                                       inFeatureSet,
+                                                       m_currentLayer->globalLights,
+                                                       QSSGShaderCacheProgramSource() });
+            return false;
+        }
+    }
+
+    const QSSGRef<QSSGRenderShaderProgram> &theProgram = pendingIt->program;
+    if (!theProgram || theProgram->isLinkPending())
+        return false;
+
+    if (theProgram->linkState() == QSSGRenderShaderProgram::LinkState::Linked)
+        m_shaders.insert(inKey, QSSGRef<QSSGShaderGeneratorGeneratedShader>(
+                                 new QSSGShaderGeneratorGeneratedShader(pendingIt->queryString, theProgram)));
+    else
+        m_shaders.insert(inKey, nullptr);
+    m_pendingShaders.erase(pendingIt);
+    return true;
+}
+
+struct QSSGRendererImpl::QSSGShaderGenerationJob
+{
+    QSSGRendererImpl *renderer;
+    qint32 index;
+    qint32 stride;
+    QSemaphore *done;
+};
+
+void QSSGRendererImpl::runShaderGenerationJob(void *inJob)
+{
+    QSSGShaderGenerationJob *job = static_cast<QSSGShaderGenerationJob *>(inJob);
+    QSSGRendererImpl *renderer = job->renderer;
+    const TShaderGeneratorPair &theGenerators = renderer->m_shaderGenerators.at(job->index);
+    for (qint32 idx = job->index; idx < renderer->m_shaderRequests.size(); idx += job->stride)
+        renderer->generateShaderSource(renderer->m_shaderRequests[idx], theGenerators);
+    if (job->done)
+        job->done->release();
+}
+
+void QSSGRendererImpl::generateRequestedShaders()
+{
+    if (m_shaderRequests.isEmpty())
+        return;
+
+    QSSGStackPerfTimer ___timer(m_demonContext->performanceTimer(), Q_FUNC_INFO);
+
+    // Source generation only reads the scene and the shader library, so the requests
+    // are split over the thread pool with a generator pair per job. The render thread
+    // takes the first share.
+    const QSSGRef<QSSGAbstractThreadPool> &threadPool = m_demonContext->threadPool();
+    const qint32 jobCount = qMin(m_shaderRequests.size(), 4);
+    while (m_shaderGenerators.size() < jobCount) {
+        const auto theProgramGenerator = QSSGShaderProgramGeneratorInterface::createProgramGenerator(m_demonContext.data());
+        m_shaderGenerators.append(qMakePair(
+                QSSGDefaultMaterialShaderGeneratorInterface::createDefaultMaterialShaderGenerator(m_demonContext.data(), theProgramGenerator),
+                theProgramGenerator));
+    }
+
+    QSemaphore done;
+    QVector<QSSGShaderGenerationJob> jobs(jobCount);
+    for (qint32 job = 0; job < jobCount; ++job)
+        jobs[job] = QSSGShaderGenerationJob{ this, job, jobCount, job == 0 ? nullptr : &done };
+    for (qint32 job = 1; job < jobCount; ++job)
+        threadPool->addTask(&jobs[job], runShaderGenerationJob, runShaderGenerationJob);
+    runShaderGenerationJob(&jobs[0]);
+    done.acquire(jobCount - 1);
+
+    // Compiling needs the context, the driver links in the background if it can
+    const QSSGRef<QSSGShaderCache> &theCache = m_demonContext->shaderCache();
+    for (QSSGShaderRequest &theRequest : m_shaderRequests) {
+        auto pendingIt = m_pendingShaders.find(theRequest.key);
+        Q_ASSERT(pendingIt != m_pendingShaders.end());
+        pendingIt->program = theCache->compileProgram(theRequest.source, true);
+        if (!pendingIt->program) {
+            // Don't attempt to generate the same bad shader twice
+            m_shaders.insert(theRequest.key, nullptr);
+            m_pendingShaders.erase(pendingIt);
+        }
+    }
+    m_shaderRequests.clear();
+}
+
+void QSSGRendererImpl::resolvePendingShaders()
+{
+    m_demonContext->shaderCache()->updatePendingPrograms();
+
+    for (auto it = m_pendingShaders.begin(); it != m_pendingShaders.end();) {
+        const QSSGRef<QSSGRenderShaderProgram> &theProgram = it->program;
+        if (!theProgram || theProgram->isLinkPending()) {
+            ++it;
+            continue;
+        }
+        if (theProgram->linkState() == QSSGRenderShaderProgram::LinkState::Linked)
+            m_shaders.insert(it.key(), QSSGRef<QSSGShaderGeneratorGeneratedShader>(
+                                     new QSSGShaderGeneratorGeneratedShader(it->queryString, theProgram)));
+        else
+            m_shaders.insert(it.key(), nullptr);
+        it = m_pendingShaders.erase(it);
+    }
+}
+
 static QVector3D g_fullScreenRectFace[] = {
     QVector3D(-1, -1, 0),
     QVector3D(-1, 1, 0),
@@ -1307,7 +1671,8 @@ QSSGLayerGlobalRenderProperties QSSGRendererImpl::getLayerGlobalRenderProperties
                                               theLayer.probe2Window,
                                               theLayer.probe2Pos,
                                               theLayer.probe2Fade,
-                                              theLayer.probeFov };
+                                              theLayer.probeFov,
+                                              theData.clusteredLights.isEmpty() ? nullptr : theData.clusteredLightGrid.data() };
 }
 
 void QSSGRendererImpl::generateXYQuadStrip()
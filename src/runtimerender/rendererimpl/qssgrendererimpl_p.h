@@ -97,6 +97,27 @@ class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRendererImpl : public QSSGRendererInterf
 
     typedef QHash<long, QSSGRenderNode *> TBoneIdNodeMap;
 
+    // A default material shader that was missing during a layer render. The
+    // sources are generated on the thread pool once the layer is done.
+    struct QSSGShaderRequest
+    {
+        QSSGShaderDefaultMaterialKey key;
+        QSSGSubsetRenderable *renderable;
+        QSSGRenderableImage *firstImage;
+        TShaderFeatureSet features;
+        QVector<QSSGRenderLight *> lights;
+        QSSGShaderCacheProgramSource source;
+    };
+    struct QSSGShaderGenerationJob;
+
+    struct QSSGPendingShader
+    {
+        QByteArray queryString;
+        QSSGRef<QSSGRenderShaderProgram> program; // null until its sources are generated
+    };
+    typedef QHash<QSSGShaderDefaultMaterialKey, QSSGPendingShader> TPendingShaderMap;
+    typedef QPair<QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface>, QSSGRef<QSSGShaderProgramGeneratorInterface>> TShaderGeneratorPair;
+
     const QSSGRef<QSSGRenderContextInterface> m_demonContext;
     QSSGRef<QSSGRenderContext> m_context;
     QSSGRef<QSSGBufferManager> m_bufferManager;
@@ -132,8 +153,23 @@ class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRendererImpl : public QSSGRendererInterf
 
     QSSGRef<QSSGLayerSceneShader> m_sceneLayerShader;
     QSSGRef<QSSGLayerProgAABlendShader> m_layerProgAAShader;
+    QSSGRef<QSSGLayerPostAAShader> m_layerFxaaShader;
+    QSSGRef<QSSGLayerPostAAShader> m_layerSmaaEdgeShader;
+    QSSGRef<QSSGLayerPostAAShader> m_layerSmaaWeightShader;
+    QSSGRef<QSSGLayerPostAAShader> m_layerSmaaBlendShader;
+    QSSGRef<QSSGLayerVelocityShader> m_layerVelocityShader;
+    QSSGRef<QSSGLayerTemporalAAShader> m_layerTemporalAAShader[2];
+    QSSGRef<QSSGLayerAoFilterShader> m_layerAoDepthDownsampleShader;
+    QSSGRef<QSSGLayerAoFilterShader> m_layerLowResolutionAoShader;
+    QSSGRef<QSSGLayerAoFilterShader> m_layerAoBlurShader;
+    QSSGRef<QSSGLayerAoFilterShader> m_layerAoUpsampleShader;
 
     TShaderMap m_shaders;
+    QVector<QSSGShaderRequest> m_shaderRequests;
+    TPendingShaderMap m_pendingShaders;
+    // Generators owned by the generation jobs, job N uses entry N
+    QVector<TShaderGeneratorPair> m_shaderGenerators;
+    bool m_asyncShaderGeneration;
     TStrConstanBufMap m_constantBuffers; ///< store the the shader constant buffers
     // Option is true if we have attempted to generate the shader.
     // This does not mean we were successul, however.
@@ -242,6 +278,7 @@ public:
 
     void beginFrame() override;
     void endFrame() override;
+    bool hasPendingShaders() const override;
 
     void pickRenderPlugins(bool inPick) override { m_pickRenderPlugins = inPick; }
     QSSGRenderPickResult pick(QSSGRenderLayer &inLayer,
@@ -250,6 +287,20 @@ public:
                                 bool inPickSiblings,
                                 bool inPickEverything,
                                 const QSSGRenderInstanceId id) override;
+    QSSGRenderPickBatchResult pickBatch(QSSGRenderLayer &inLayer,
+                                        const QVector2D &inViewportDimensions,
+                                        const QVector<QVector2D> &inMouseCoords,
+                                        bool inPickEverything,
+                                        const QSSGRenderInstanceId id) override;
+    QSSGRenderPickBatchResult pickBatch(QSSGRenderLayer &inLayer,
+                                        const QVector<QSSGRenderRay> &inRays,
+                                        bool inPickEverything,
+                                        const QSSGRenderInstanceId id) override;
+    QVector<const QSSGRenderGraphObject *> pickFrustum(QSSGRenderLayer &inLayer,
+                                                       const QVector2D &inViewportDimensions,
+                                                       const QRectF &inRect,
+                                                       bool inPickEverything,
+                                                       const QSSGRenderInstanceId id) override;
 
     virtual QSSGOption<QVector2D> facePosition(QSSGRenderNode &inNode,
                                                  QSSGBounds3 inBounds,
@@ -305,8 +356,11 @@ public:
     QSSGRef<QSSGRenderShaderProgram> compileShader(const QByteArray &inName, const char *inVert, const char *inFrame);
 
     QSSGRef<QSSGRenderShaderProgram> generateShader(QSSGSubsetRenderable &inRenderable, const TShaderFeatureSet &inFeatureSet);
+    // outIsFallback is set when the material's shader is not compiled yet and the returned
+    // one is the variant without images. Such a shader must be used without the images.
     QSSGRef<QSSGShaderGeneratorGeneratedShader> getShader(QSSGSubsetRenderable &inRenderable,
-                                                              const TShaderFeatureSet &inFeatureSet);
+                                                              const TShaderFeatureSet &inFeatureSet,
+                                                              bool *outIsFallback = nullptr);
 
     QSSGRef<QSSGSkyBoxShader> getSkyBoxShader();
     QSSGRef<QSSGDefaultAoPassShader> getDefaultAoPassShader(TShaderFeatureSet inFeatureSet);
@@ -319,6 +373,16 @@ public:
     QSSGRef<QSSGRenderableDepthPrepassShader> getOrthographicDepthShader(TessModeValues inTessMode);
 
 private:
+    QByteArray shaderQueryString(const QSSGShaderDefaultMaterialKey &inKey);
+    bool requestShader(const QSSGShaderDefaultMaterialKey &inKey,
+                       QSSGSubsetRenderable &inRenderable,
+                       QSSGRenderableImage *inFirstImage,
+                       const TShaderFeatureSet &inFeatureSet);
+    void generateShaderSource(QSSGShaderRequest &ioRequest, const TShaderGeneratorPair &inGenerators);
+    void generateRequestedShaders();
+    void resolvePendingShaders();
+    static void runShaderGenerationJob(void *inJob);
+
     QSSGRef<QSSGRenderableDepthPrepassShader> getParaboloidDepthNoTessShader();
     QSSGRef<QSSGRenderableDepthPrepassShader> getParaboloidDepthTessLinearShader();
     QSSGRef<QSSGRenderableDepthPrepassShader> getParaboloidDepthTessPhongShader();
@@ -345,6 +409,16 @@ public:
     void generateXYZPoint();
     QPair<QSSGRef<QSSGRenderVertexBuffer>, QSSGRef<QSSGRenderIndexBuffer>> getXYQuad();
     QSSGRef<QSSGLayerProgAABlendShader> getLayerProgAABlendShader();
+    QSSGRef<QSSGLayerPostAAShader> getLayerFxaaShader();
+    QSSGRef<QSSGLayerPostAAShader> getLayerSmaaEdgeShader();
+    QSSGRef<QSSGLayerPostAAShader> getLayerSmaaWeightShader();
+    QSSGRef<QSSGLayerPostAAShader> getLayerSmaaBlendShader();
+    QSSGRef<QSSGLayerVelocityShader> getLayerVelocityShader();
+    QSSGRef<QSSGLayerTemporalAAShader> getLayerTemporalAAShader(bool inVelocity);
+    QSSGRef<QSSGLayerAoFilterShader> getLayerAoDepthDownsampleShader();
+    QSSGRef<QSSGLayerAoFilterShader> getLayerLowResolutionAoShader();
+    QSSGRef<QSSGLayerAoFilterShader> getLayerAoBlurShader();
+    QSSGRef<QSSGLayerAoFilterShader> getLayerAoUpsampleShader();
     QSSGRef<QSSGShadowmapPreblurShader> getCubeShadowBlurXShader();
     QSSGRef<QSSGShadowmapPreblurShader> getCubeShadowBlurYShader();
     QSSGRef<QSSGShadowmapPreblurShader> getOrthoShadowBlurXShader();
@@ -429,6 +503,12 @@ protected:
     void intersectRayWithSubsetRenderable(const QSSGRenderRay &inRay,
                                           QSSGRenderableObject &inRenderableObject,
                                           TPickResultArray &outIntersectionResultList);
+    // The layer data of inLayer if it can be picked against without sub renderers
+    QSSGLayerRenderData *getPickableLayerData(QSSGRenderLayer &inLayer, const QSSGRenderInstanceId id) const;
+    const QVector<QSSGRenderPickTarget> &getPickTargets(QSSGLayerRenderData &inLayer);
+    QSSGRenderPickBatchResult pickRays(QSSGLayerRenderData *inLayer,
+                                       const QVector<QSSGOption<QSSGRenderRay>> &inRays,
+                                       bool inPickEverything);
 };
 QT_END_NAMESPACE
 
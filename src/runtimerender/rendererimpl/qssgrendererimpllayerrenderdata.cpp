@@ -47,6 +47,7 @@
 #include <QtQuick3DUtils/private/qssgperftimer_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercustommaterialsystem_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderdefaultmaterialshadergenerator_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderrenderlist_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendererutil_p.h>
 #include <QtQuick3DUtils/private/qssgutils_p.h>
@@ -66,6 +67,7 @@ QSSGLayerRenderData::QSSGLayerRenderData(QSSGRenderLayer &inLayer, const QSSGRef
     , m_layerPrepassDepthTexture(inRenderer->demonContext()->resourceManager())
     , m_layerWidgetTexture(inRenderer->demonContext()->resourceManager())
     , m_layerSsaoTexture(inRenderer->demonContext()->resourceManager())
+    , m_layerVelocityTexture(inRenderer->demonContext()->resourceManager())
     , m_layerMultisampleTexture(inRenderer->demonContext()->resourceManager())
     , m_layerMultisamplePrepassDepthTexture(inRenderer->demonContext()->resourceManager())
     , m_layerMultisampleWidgetTexture(inRenderer->demonContext()->resourceManager())
@@ -148,6 +150,7 @@ void QSSGLayerRenderData::prepareForRender(const QSize &inViewportDimensions, bo
         m_layerWidgetTexture.releaseTexture();
         m_layerPrepassDepthTexture.releaseTexture();
         m_temporalAATexture.releaseTexture();
+        m_layerVelocityTexture.releaseTexture();
         m_layerMultisampleTexture.releaseTexture();
         m_layerMultisamplePrepassDepthTexture.releaseTexture();
         m_layerMultisampleWidgetTexture.releaseTexture();
@@ -264,11 +267,17 @@ void QSSGLayerRenderData::renderClearPass()
     renderer->endLayerRender();
 }
 
-void QSSGLayerRenderData::renderAoPass()
+void QSSGLayerRenderData::renderAoPass(QSSGResourceFrameBuffer *theFB)
 {
+    const auto &theContext = renderer->context();
+    const qint32 theFactor = qint32(layer.aoResolution);
+    if (theFactor > 1 && theContext->renderContextType() != QSSGRenderContextType::GLES2) {
+        renderLowResolutionAoPass(theFB, theFactor);
+        return;
+    }
+
     renderer->beginLayerDepthPassRender(*this);
 
-    const auto &theContext = renderer->context();
     QSSGRef<QSSGDefaultAoPassShader> shader = renderer->getDefaultAoPassShader(getShaderFeatureSet());
     if (shader == nullptr)
         return;
@@ -298,6 +307,91 @@ void QSSGLayerRenderData::renderAoPass()
     renderer->endLayerDepthPassRender();
 }
 
+// The AO is computed on a downsampled depth buffer, blurred along the surfaces
+// and then scaled up into the layer SSAO texture, which the materials sample.
+void QSSGLayerRenderData::renderLowResolutionAoPass(QSSGResourceFrameBuffer *theFB, qint32 inFactor)
+{
+    const auto &theContext = renderer->context();
+    const QSSGRef<QSSGResourceManager> &theResourceManager = renderer->demonContext()->resourceManager();
+    QSSGRef<QSSGLayerAoFilterShader> theDownsampleShader = renderer->getLayerAoDepthDownsampleShader();
+    QSSGRef<QSSGLayerAoFilterShader> theAoShader = renderer->getLayerLowResolutionAoShader();
+    QSSGRef<QSSGLayerAoFilterShader> theBlurShader = renderer->getLayerAoBlurShader();
+    QSSGRef<QSSGLayerAoFilterShader> theUpsampleShader = renderer->getLayerAoUpsampleShader();
+    if (!theDownsampleShader || !theAoShader || !theBlurShader || !theUpsampleShader)
+        return;
+
+    renderer->beginLayerDepthPassRender(*this);
+
+    const QSSGTextureDetails theDetails = m_layerSsaoTexture->textureDetails();
+    const qint32 theLowWidth = (theDetails.width + inFactor - 1) / inFactor;
+    const qint32 theLowHeight = (theDetails.height + inFactor - 1) / inFactor;
+    const QVector2D theLowPixelSize(1.0f / float(theLowWidth), 1.0f / float(theLowHeight));
+    const QVector2D theCameraProps(camera->clipNear, camera->clipFar);
+
+    theContext->setBlendingEnabled(false);
+    theContext->setDepthWriteEnabled(false);
+    theContext->setDepthTestEnabled(false);
+    // The depth texture is only read from
+    (*theFB)->attach(getFramebufferDepthAttachmentFormat(m_layerDepthTexture->textureDetails().format),
+                     QSSGRenderTextureOrRenderBuffer());
+
+    // Depth and AO are looked up per pixel, or between the pixels with weights of our own
+    QSSGResourceTexture2D theLowDepthTexture(theResourceManager, theLowWidth, theLowHeight, QSSGRenderTextureFormat::RG32F);
+    theLowDepthTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+    theLowDepthTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+    QSSGResourceTexture2D theLowAoTexture(theResourceManager, theLowWidth, theLowHeight, QSSGRenderTextureFormat::R8);
+    theLowAoTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+    theLowAoTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+    QSSGResourceTexture2D theBlurTexture(theResourceManager, theLowWidth, theLowHeight, QSSGRenderTextureFormat::R8);
+    theBlurTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+    theBlurTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+
+    {
+        QSSGRenderContextScopedProperty<QRect> __viewport(*theContext,
+                                                            &QSSGRenderContext::viewport,
+                                                            &QSSGRenderContext::setViewport,
+                                                            QRect(0, 0, theLowWidth, theLowHeight));
+
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theLowDepthTexture.getTexture());
+        theContext->setActiveShader(theDownsampleShader->shader);
+        theDownsampleShader->depthSampler.set(m_layerDepthTexture.getTexture().data());
+        theDownsampleShader->downsampleFactor.set(float(inFactor));
+        renderer->renderQuad();
+
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theLowAoTexture.getTexture());
+        theContext->setActiveShader(theAoShader->shader);
+        theAoShader->depthSampler.set(theLowDepthTexture.getTexture().data());
+        theAoShader->cameraProperties.set(theCameraProps);
+        theAoShader->pixelSize.set(theLowPixelSize);
+        theAoShader->aoShadowParams.set();
+        renderer->renderQuad();
+
+        // Separable blur, horizontally into the blur texture and back vertically
+        theContext->setActiveShader(theBlurShader->shader);
+        theBlurShader->lowDepthSampler.set(theLowDepthTexture.getTexture().data());
+        theBlurShader->cameraProperties.set(theCameraProps);
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theBlurTexture.getTexture());
+        theBlurShader->aoSampler.set(theLowAoTexture.getTexture().data());
+        theBlurShader->blurDirection.set(QVector2D(theLowPixelSize.x(), 0.0f));
+        renderer->renderQuad();
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theLowAoTexture.getTexture());
+        theBlurShader->aoSampler.set(theBlurTexture.getTexture().data());
+        theBlurShader->blurDirection.set(QVector2D(0.0f, theLowPixelSize.y()));
+        renderer->renderQuad();
+    }
+
+    (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, m_layerSsaoTexture.getTexture());
+    theContext->setActiveShader(theUpsampleShader->shader);
+    theUpsampleShader->depthSampler.set(m_layerDepthTexture.getTexture().data());
+    theUpsampleShader->lowDepthSampler.set(theLowDepthTexture.getTexture().data());
+    theUpsampleShader->aoSampler.set(theLowAoTexture.getTexture().data());
+    theUpsampleShader->cameraProperties.set(theCameraProps);
+    theUpsampleShader->pixelSize.set(theLowPixelSize);
+    renderer->renderQuad();
+
+    renderer->endLayerDepthPassRender();
+}
+
 void QSSGLayerRenderData::renderFakeDepthMapPass(QSSGRenderTexture2D *theDepthTex, QSSGRenderTextureCube *theDepthCube)
 {
     renderer->beginLayerDepthPassRender(*this);
@@ -806,7 +900,7 @@ inline void renderRenderableDepthPass(QSSGLayerRenderData &inData,
     if (inObject.renderableFlags.isDefaultMaterialMeshSubset())
         static_cast<QSSGSubsetRenderable &>(inObject).renderDepthPass(inCameraProps);
     else if (inObject.renderableFlags.isCustomMaterialMeshSubset()) {
-        static_cast<QSSGCustomMaterialRenderable &>(inObject).renderDepthPass(inCameraProps, inData.layer, inData.globalLights, inCamera, nullptr);
+        static_cast<QSSGCustomMaterialRenderable &>(inObject).renderDepthPass(inCameraProps, inData.layer, inData.customMaterialLights(), inCamera, nullptr);
     } else if (inObject.renderableFlags.isPath()) {
         static_cast<QSSGPathRenderable &>(inObject).renderDepthPass(inCameraProps, inData.layer, inData.globalLights, inCamera, nullptr);
     } else {
@@ -864,7 +958,7 @@ inline void renderRenderable(QSSGLayerRenderData &inData,
         static_cast<QSSGCustomMaterialRenderable &>(inObject).render(inCameraProps,
                                                                        inData,
                                                                        inData.layer,
-                                                                       inData.globalLights,
+                                                                       inData.customMaterialLights(),
                                                                        inCamera,
                                                                        inData.m_layerDepthTexture,
                                                                        inData.m_layerSsaoTexture,
@@ -907,7 +1001,7 @@ void QSSGLayerRenderData::runRenderPass(TRenderRenderableFunction inRenderFn,
 
     for (const auto &theObject : theOpaqueObjects) {
         QSSGScopedLightsListScope lightsScope(globalLights, lightDirections, sourceLightDirections, theObject->scopedLights);
-        setShaderFeature(QSSGShaderDefines::cgLighting(), globalLights.empty() == false);
+        setShaderFeature(QSSGShaderDefines::cgLighting(), globalLights.empty() == false || !clusteredLights.empty());
         inRenderFn(*this, *theObject, theCameraProps, getShaderFeatureSet(), indexLight, inCamera);
     }
 
@@ -916,7 +1010,7 @@ void QSSGLayerRenderData::runRenderPass(TRenderRenderableFunction inRenderFn,
         theRenderContext->setBlendingEnabled(true && inEnableBlending);
         theRenderContext->setDepthWriteEnabled(inEnableTransparentDepthWrite);
 
-        const auto theTransparentObjects = getTransparentRenderableObjects();
+        const auto &theTransparentObjects = getTransparentRenderableObjects();
         // Assume all objects have transparency if the layer's depth test enabled flag is true.
         if (layer.flags.testFlag(QSSGRenderLayer::Flag::LayerEnableDepthTest)) {
             for (const auto &theObject : theTransparentObjects) {
@@ -937,7 +1031,7 @@ void QSSGLayerRenderData::runRenderPass(TRenderRenderableFunction inRenderFn,
                         setupDrawFB(true);
 #endif
                     QSSGScopedLightsListScope lightsScope(globalLights, lightDirections, sourceLightDirections, theObject->scopedLights);
-                    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty());
+                    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty() || !clusteredLights.empty());
 
                     inRenderFn(*this, *theObject, theCameraProps, getShaderFeatureSet(), indexLight, inCamera);
 #ifdef ADVANCED_BLEND_SW_FALLBACK
@@ -980,7 +1074,7 @@ void QSSGLayerRenderData::runRenderPass(TRenderRenderableFunction inRenderFn,
                     }
 #endif
                     QSSGScopedLightsListScope lightsScope(globalLights, lightDirections, sourceLightDirections, theObject->scopedLights);
-                    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty());
+                    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty() || !clusteredLights.empty());
                     inRenderFn(*this, *theObject, theCameraProps, getShaderFeatureSet(), indexLight, inCamera);
 #ifdef ADVANCED_BLEND_SW_FALLBACK
                     if (useBlendFallback) {
@@ -1002,6 +1096,9 @@ void QSSGLayerRenderData::render(QSSGResourceFrameBuffer *theFB)
         return;
 
     renderer->beginLayerRender(*this);
+    // The object constants of all default material draws go up in one upload
+    renderer->demonContext()->defaultMaterialShaderGenerator()->uploadObjectConstants(getOpaqueRenderableObjects(),
+                                                                                     getTransparentRenderableObjects());
     runRenderPass(renderRenderable, true, !layer.flags.testFlag(QSSGRenderLayer::Flag::LayerEnableDepthPrePass), false, 0, *camera, theFB);
     renderer->endLayerRender();
 }
@@ -1186,13 +1283,35 @@ const QVector2D s_BlendFactors[QSSGLayerRenderPreparationData::MAX_AA_LEVELS] =
     QVector2D(0.111111f, 0.888889f), // 8x
 };
 
-const QVector2D s_TemporalVertexOffsets[QSSGLayerRenderPreparationData::MAX_TEMPORAL_AA_LEVELS] = { QVector2D(.3f, .3f),
-                                                                                                      QVector2D(-.3f, -.3f) };
+// Share of the reprojected history in the result of a temporal AA frame
+const float s_TemporalHistoryWeight = 0.9f;
+
+// Element of the Halton low discrepancy sequence
+static inline float halton(quint32 inIndex, quint32 inBase)
+{
+    float result = 0.0f;
+    float fraction = 1.0f;
+    while (inIndex > 0) {
+        fraction /= float(inBase);
+        result += fraction * float(inIndex % inBase);
+        inIndex /= inBase;
+    }
+    return result;
+}
 
+// Pixel offset of the camera for a temporal AA frame, within half a pixel
+static inline QVector2D temporalVertexOffset(quint32 inPassIndex)
+{
+    return QVector2D(halton(inPassIndex + 1, 2) - 0.5f, halton(inPassIndex + 1, 3) - 0.5f);
+}
+
+// Moves the projected position by the offset, in normalized device coordinates
 static inline void offsetProjectionMatrix(QMatrix4x4 &inProjectionMatrix, QVector2D inVertexOffsets)
 {
-    inProjectionMatrix(3, 0) = inProjectionMatrix(3, 0) + inProjectionMatrix(3, 3) * inVertexOffsets.x();
-    inProjectionMatrix(3, 1) = inProjectionMatrix(3, 1) + inProjectionMatrix(3, 3) * inVertexOffsets.y();
+    for (int column = 0; column < 4; ++column) {
+        inProjectionMatrix(0, column) += inProjectionMatrix(3, column) * inVertexOffsets.x();
+        inProjectionMatrix(1, column) += inProjectionMatrix(3, column) * inVertexOffsets.y();
+    }
 }
 
 // Render this layer's data to a texture.  Required if we have any effects,
@@ -1248,7 +1367,12 @@ void QSSGLayerRenderData::renderToTexture()
         if (layer.multisampleAAMode != QSSGRenderLayer::AAMode::SSAA)
             thFboAttachTarget = QSSGRenderTextureTargetType::Texture2D_MS;
     }
-    quint32 maxTemporalPassIndex = layer.temporalAAEnabled ? 2 : 0;
+    // Run through the jitter sequence twice before settling on the result
+    quint32 maxTemporalPassIndex = layer.temporalAAEnabled ? 2 * MAX_TEMPORAL_AA_LEVELS : 0;
+    // Velocity needs a float render target matching the single sampled depth buffer, and only
+    // opaque meshes produce any.
+    const bool hasVelocity = layer.temporalAAEnabled && sampleCount == 1 && opaqueObjects.size() > 0
+            && theRenderContext->renderContextType() != QSSGRenderContextType::GLES2;
 
     // If all the dimensions match then we do not have to re-render the layer.
     if (m_layerTexture.textureMatches(theLayerTextureDimensions.width(), theLayerTextureDimensions.height(), ColorTextureFormat)
@@ -1306,70 +1430,114 @@ void QSSGLayerRenderData::renderToTexture()
 
     QSSGResourceTexture2D theLastLayerTexture(theResourceManager);
     QSSGRef<QSSGLayerProgAABlendShader> theBlendShader = nullptr;
+    QSSGRef<QSSGLayerTemporalAAShader> theTemporalAAShader = nullptr;
     quint32 aaFactorIndex = 0;
     bool isProgressiveAABlendPass = m_progressiveAAPassIndex && m_progressiveAAPassIndex < thePrepResult.maxAAPassIndex;
     bool isTemporalAABlendPass = layer.temporalAAEnabled && m_progressiveAAPassIndex == 0;
 
-    if (isProgressiveAABlendPass || isTemporalAABlendPass) {
+    if (isProgressiveAABlendPass) {
         theBlendShader = renderer->getLayerProgAABlendShader();
         if (theBlendShader) {
             m_layerTexture.ensureTexture(theLayerOriginalTextureDimensions.width(),
                                          theLayerOriginalTextureDimensions.height(),
                                          ColorTextureFormat);
-            QVector2D theVertexOffsets;
-            if (isProgressiveAABlendPass) {
-                theLastLayerTexture.stealTexture(m_layerTexture);
-                aaFactorIndex = (m_progressiveAAPassIndex - 1);
-                theVertexOffsets = s_VertexOffsets[aaFactorIndex];
-            } else {
-                if (m_temporalAATexture.getTexture())
-                    theLastLayerTexture.stealTexture(m_temporalAATexture);
-                else {
-                    if (hadLayerTexture) {
-                        theLastLayerTexture.stealTexture(m_layerTexture);
-                    }
+            theLastLayerTexture.stealTexture(m_layerTexture);
+            aaFactorIndex = (m_progressiveAAPassIndex - 1);
+            QVector2D theVertexOffsets = s_VertexOffsets[aaFactorIndex];
+            theVertexOffsets.setX(theVertexOffsets.x() / (theLayerOriginalTextureDimensions.width() / 2.0f));
+            theVertexOffsets.setY(theVertexOffsets.y() / (theLayerOriginalTextureDimensions.height() / 2.0f));
+            // Run through all models and update MVP.
+            // run through all texts and update MVP.
+            // run through all path and update MVP.
+
+            // TODO - optimize this exact matrix operation.
+            for (qint32 idx = 0, end = modelContexts.size(); idx < end; ++idx) {
+                QMatrix4x4 &originalProjection(modelContexts[idx]->modelViewProjection);
+                offsetProjectionMatrix(originalProjection, theVertexOffsets);
+            }
+            for (qint32 idx = 0, end = opaqueObjects.size(); idx < end; ++idx) {
+                if (opaqueObjects[idx]->renderableFlags.isPath()) {
+                    QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*opaqueObjects[idx]);
+                    offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
                 }
-                theVertexOffsets = s_TemporalVertexOffsets[m_temporalAAPassIndex];
-                ++m_temporalAAPassIndex;
-                ++m_nonDirtyTemporalAAPassIndex;
-                m_temporalAAPassIndex = m_temporalAAPassIndex % MAX_TEMPORAL_AA_LEVELS;
             }
-            if (theLastLayerTexture.getTexture()) {
-                theVertexOffsets.setX(theVertexOffsets.x() / (theLayerOriginalTextureDimensions.width() / 2.0f));
-                theVertexOffsets.setY(theVertexOffsets.y() / (theLayerOriginalTextureDimensions.height() / 2.0f));
-                // Run through all models and update MVP.
-                // run through all texts and update MVP.
-                // run through all path and update MVP.
-
-                // TODO - optimize this exact matrix operation.
-                for (qint32 idx = 0, end = modelContexts.size(); idx < end; ++idx) {
-                    QMatrix4x4 &originalProjection(modelContexts[idx]->modelViewProjection);
-                    offsetProjectionMatrix(originalProjection, theVertexOffsets);
+            for (qint32 idx = 0, end = transparentObjects.size(); idx < end; ++idx) {
+                if (transparentObjects[idx]->renderableFlags.isPath()) {
+                    QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*transparentObjects[idx]);
+                    offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
                 }
-                for (qint32 idx = 0, end = opaqueObjects.size(); idx < end; ++idx) {
-                    if (opaqueObjects[idx]->renderableFlags.isPath()) {
-                        QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*opaqueObjects[idx]);
-                        offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
-                    }
+            }
+        }
+    }
+
+    if (isTemporalAABlendPass) {
+        theTemporalAAShader = renderer->getLayerTemporalAAShader(hasVelocity);
+        if (theTemporalAAShader) {
+            // The result of the last frame is the history. With multisampling the
+            // layer texture is only the resolve target, so it was not recreated above.
+            if ((hadLayerTexture || isMultisamplePass)
+                    && m_layerTexture.textureMatches(theLayerOriginalTextureDimensions.width(),
+                                                     theLayerOriginalTextureDimensions.height(),
+                                                     ColorTextureFormat))
+                m_temporalAATexture.stealTexture(m_layerTexture);
+            else
+                m_temporalAATexture.releaseTexture();
+
+            // Remember where the models were for the velocity of the next frame
+            QHash<const QSSGRenderModel *, QMatrix4x4> theModelViewProjections;
+            theModelViewProjections.reserve(modelContexts.size());
+            for (qint32 idx = 0, end = modelContexts.size(); idx < end; ++idx) {
+                QSSGModelContext &theContext(*modelContexts[idx]);
+                theContext.unjitteredModelViewProjection = theContext.modelViewProjection;
+                theContext.previousModelViewProjection = m_previousModelViewProjections.value(&theContext.model,
+                                                                                              theContext.modelViewProjection);
+                theModelViewProjections.insert(&theContext.model, theContext.modelViewProjection);
+            }
+            m_previousModelViewProjections.swap(theModelViewProjections);
+
+            QVector2D theVertexOffsets = temporalVertexOffset(m_temporalAAPassIndex);
+            ++m_temporalAAPassIndex;
+            ++m_nonDirtyTemporalAAPassIndex;
+            m_temporalAAPassIndex = m_temporalAAPassIndex % MAX_TEMPORAL_AA_LEVELS;
+            theVertexOffsets.setX(theVertexOffsets.x() / (theLayerOriginalTextureDimensions.width() / 2.0f));
+            theVertexOffsets.setY(theVertexOffsets.y() / (theLayerOriginalTextureDimensions.height() / 2.0f));
+            for (qint32 idx = 0, end = modelContexts.size(); idx < end; ++idx)
+                offsetProjectionMatrix(modelContexts[idx]->modelViewProjection, theVertexOffsets);
+            for (qint32 idx = 0, end = opaqueObjects.size(); idx < end; ++idx) {
+                if (opaqueObjects[idx]->renderableFlags.isPath()) {
+                    QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*opaqueObjects[idx]);
+                    offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
                 }
-                for (qint32 idx = 0, end = transparentObjects.size(); idx < end; ++idx) {
-                    if (transparentObjects[idx]->renderableFlags.isPath()) {
-                        QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*transparentObjects[idx]);
-                        offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
-                    }
+            }
+            for (qint32 idx = 0, end = transparentObjects.size(); idx < end; ++idx) {
+                if (transparentObjects[idx]->renderableFlags.isPath()) {
+                    QSSGPathRenderable &theRenderable = static_cast<QSSGPathRenderable &>(*transparentObjects[idx]);
+                    offsetProjectionMatrix(theRenderable.m_mvp, theVertexOffsets);
                 }
             }
         }
     }
-    if (theLastLayerTexture.getTexture() == nullptr) {
+    if (theLastLayerTexture.getTexture() == nullptr)
         isProgressiveAABlendPass = false;
+    if (theTemporalAAShader == nullptr)
         isTemporalAABlendPass = false;
-    }
     // Sometimes we will have stolen the render texture.
     renderColorTexture->ensureTexture(theLayerTextureDimensions.width(), theLayerTextureDimensions.height(), ColorTextureFormat, sampleCount);
 
-    if (!isTemporalAABlendPass)
+    if (!isTemporalAABlendPass) {
         m_temporalAATexture.releaseTexture();
+        m_previousModelViewProjections.clear();
+    }
+    if (isTemporalAABlendPass && hasVelocity) {
+        if (m_layerVelocityTexture.ensureTexture(theLayerTextureDimensions.width(),
+                                                 theLayerTextureDimensions.height(),
+                                                 QSSGRenderTextureFormat::RGBA16F)) {
+            m_layerVelocityTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+            m_layerVelocityTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+        }
+    } else {
+        m_layerVelocityTexture.releaseTexture();
+    }
 
     // Allocating a frame buffer can cause it to be bound, so we need to save state before this
     // happens.
@@ -1437,7 +1605,7 @@ void QSSGLayerRenderData::renderToTexture()
             // Setup FBO with single color buffer target
             theFB->attach(QSSGRenderFrameBufferAttachment::Color0, m_layerSsaoTexture.getTexture());
             theRenderContext->clear(QSSGRenderClearValues::Color);
-            renderAoPass();
+            renderAoPass(&theFB);
             theFB->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
             endProfiling("AO pass");
         }
@@ -1469,6 +1637,18 @@ void QSSGLayerRenderData::renderToTexture()
             }
         }
 
+        // The velocity is drawn against the depth of the prepass, or fills in the
+        // depth itself when there was none; it gets cleared for the render pass then.
+        if (m_layerVelocityTexture.getTexture() && renderPrepassDepthTexture->getTexture()) {
+            startProfiling("Velocity pass", false);
+            theFB->attach(QSSGRenderFrameBufferAttachment::Color0, m_layerVelocityTexture.getTexture());
+            renderVelocityPass(!layer.flags.testFlag(QSSGRenderLayer::Flag::LayerEnableDepthPrePass));
+            theFB->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
+            endProfiling("Velocity pass");
+            if (!layer.flags.testFlag(QSSGRenderLayer::Flag::LayerEnableDepthPrePass))
+                theRenderContext->setDepthWriteEnabled(true);
+        }
+
         theFB->attach(QSSGRenderFrameBufferAttachment::Color0, renderColorTexture->getTexture(), thFboAttachTarget);
         if (layer.background != QSSGRenderLayer::Background::Unspecified)
             theRenderContext->clear(clearFlags);
@@ -1530,7 +1710,7 @@ void QSSGLayerRenderData::renderToTexture()
             renderRenderWidgets();
         }
 
-        if (theLastLayerTexture.getTexture() != nullptr && (isProgressiveAABlendPass || isTemporalAABlendPass)) {
+        if (theLastLayerTexture.getTexture() != nullptr && isProgressiveAABlendPass) {
             theRenderContext->setViewport(
                         QRect(0, 0, theLayerOriginalTextureDimensions.width(), theLayerOriginalTextureDimensions.height()));
             QSSGResourceTexture2D targetTexture(theResourceManager,
@@ -1539,11 +1719,7 @@ void QSSGLayerRenderData::renderToTexture()
                                                   ColorTextureFormat);
             theFB->attach(theDepthAttachmentFormat, QSSGRenderTextureOrRenderBuffer());
             theFB->attach(QSSGRenderFrameBufferAttachment::Color0, targetTexture.getTexture());
-            QVector2D theBlendFactors;
-            if (isProgressiveAABlendPass)
-                theBlendFactors = s_BlendFactors[aaFactorIndex];
-            else
-                theBlendFactors = QVector2D(.5f, .5f);
+            QVector2D theBlendFactors = s_BlendFactors[aaFactorIndex];
 
             theRenderContext->setDepthTestEnabled(false);
             theRenderContext->setBlendingEnabled(false);
@@ -1554,8 +1730,43 @@ void QSSGLayerRenderData::renderToTexture()
             theBlendShader->blendFactors.set(theBlendFactors);
             renderer->renderQuad();
             theFB->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
-            if (isTemporalAABlendPass)
-                m_temporalAATexture.stealTexture(m_layerTexture);
+            m_layerTexture.stealTexture(targetTexture);
+        }
+
+        if (isTemporalAABlendPass) {
+            theRenderContext->setViewport(
+                        QRect(0, 0, theLayerOriginalTextureDimensions.width(), theLayerOriginalTextureDimensions.height()));
+            QSSGResourceTexture2D targetTexture(theResourceManager,
+                                                  theLayerOriginalTextureDimensions.width(),
+                                                  theLayerOriginalTextureDimensions.height(),
+                                                  ColorTextureFormat);
+            theFB->attach(theDepthAttachmentFormat, QSSGRenderTextureOrRenderBuffer(), thFboAttachTarget);
+            theFB->attach(QSSGRenderFrameBufferAttachment::Color0, targetTexture.getTexture());
+
+            theRenderContext->setDepthTestEnabled(false);
+            theRenderContext->setBlendingEnabled(false);
+            theRenderContext->setCullingEnabled(false);
+            theRenderContext->setActiveShader(theTemporalAAShader->shader);
+            m_layerTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
+            m_layerTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
+            theTemporalAAShader->currentSampler.set(m_layerTexture.getTexture().data());
+            // Without history the current frame is passed through
+            if (m_temporalAATexture.getTexture()) {
+                m_temporalAATexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
+                m_temporalAATexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
+                theTemporalAAShader->historySampler.set(m_temporalAATexture.getTexture().data());
+                theTemporalAAShader->historyWeight.set(s_TemporalHistoryWeight);
+            } else {
+                theTemporalAAShader->historySampler.set(m_layerTexture.getTexture().data());
+                theTemporalAAShader->historyWeight.set(0.0f);
+            }
+            if (m_layerVelocityTexture.getTexture())
+                theTemporalAAShader->velocitySampler.set(m_layerVelocityTexture.getTexture().data());
+            theTemporalAAShader->pixelSize.set(QVector2D(1.0f / theLayerOriginalTextureDimensions.width(),
+                                                         1.0f / theLayerOriginalTextureDimensions.height()));
+            renderer->renderQuad();
+            theFB->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
+            m_temporalAATexture.releaseTexture();
             m_layerTexture.stealTexture(targetTexture);
         }
 
@@ -1582,6 +1793,95 @@ void QSSGLayerRenderData::renderToTexture()
     }
 }
 
+void QSSGLayerRenderData::renderVelocityPass(bool inWriteDepth)
+{
+    if (camera == nullptr)
+        return;
+
+    const auto &theRenderContext = renderer->context();
+    QSSGRenderContextScopedProperty<QVector4D> __clearColor(*theRenderContext,
+                                                              &QSSGRenderContext::clearColor,
+                                                              &QSSGRenderContext::setClearColor,
+                                                              QVector4D(0.0, 0.0, 0.0, 0.0));
+    theRenderContext->setBlendingEnabled(false);
+    theRenderContext->setDepthTestEnabled(true);
+    theRenderContext->setDepthFunction(QSSGRenderBoolOp::LessThanOrEqual);
+    theRenderContext->setDepthWriteEnabled(inWriteDepth);
+
+    QSSGRenderClearFlags clearFlags = QSSGRenderClearValues::Color;
+    if (inWriteDepth)
+        clearFlags |= QSSGRenderClearValues::Depth | QSSGRenderClearValues::Stencil;
+    theRenderContext->clear(clearFlags);
+
+    // Only the opaque meshes, transparent ones keep the velocity of what is behind them
+    for (qint32 idx = 0, end = opaqueObjects.size(); idx < end; ++idx) {
+        QSSGRenderableObject *theObject = opaqueObjects[idx];
+        if (theObject->renderableFlags.isDefaultMaterialMeshSubset() || theObject->renderableFlags.isCustomMaterialMeshSubset())
+            static_cast<QSSGSubsetRenderableBase *>(theObject)->renderVelocityPass();
+    }
+}
+
+void QSSGLayerRenderData::renderPostAAPass(QSSGResourceFrameBuffer *theFB, const QSize &inDimensions, QSSGRenderTextureFormat inFormat)
+{
+    const auto &theRenderContext = renderer->context();
+    const QSSGRef<QSSGResourceManager> &theResourceManager = renderer->demonContext()->resourceManager();
+    const QVector2D thePixelSize(1.0f / float(inDimensions.width()), 1.0f / float(inDimensions.height()));
+
+    theRenderContext->setDepthTestEnabled(false);
+    theRenderContext->setBlendingEnabled(false);
+    theRenderContext->setCullingEnabled(false);
+
+    // The filters sample the color in between the pixels
+    m_layerTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
+    m_layerTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
+
+    QSSGResourceTexture2D targetTexture(theResourceManager, inDimensions.width(), inDimensions.height(), inFormat);
+    if (layer.postAAMode == QSSGRenderLayer::PostAAMode::FXAA) {
+        QSSGRef<QSSGLayerPostAAShader> theShader = renderer->getLayerFxaaShader();
+        if (!theShader)
+            return;
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, targetTexture.getTexture());
+        theRenderContext->setActiveShader(theShader->shader);
+        theShader->colorSampler.set(m_layerTexture.getTexture().data());
+        theShader->pixelSize.set(thePixelSize);
+        renderer->renderQuad();
+    } else {
+        QSSGRef<QSSGLayerPostAAShader> theEdgeShader = renderer->getLayerSmaaEdgeShader();
+        QSSGRef<QSSGLayerPostAAShader> theWeightShader = renderer->getLayerSmaaWeightShader();
+        QSSGRef<QSSGLayerPostAAShader> theBlendShader = renderer->getLayerSmaaBlendShader();
+        if (!theEdgeShader || !theWeightShader || !theBlendShader)
+            return;
+
+        // The edges and weights are looked up per pixel
+        QSSGResourceTexture2D theEdgeTexture(theResourceManager, inDimensions.width(), inDimensions.height(), QSSGRenderTextureFormat::RGBA8);
+        theEdgeTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+        theEdgeTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theEdgeTexture.getTexture());
+        theRenderContext->setActiveShader(theEdgeShader->shader);
+        theEdgeShader->colorSampler.set(m_layerTexture.getTexture().data());
+        theEdgeShader->pixelSize.set(thePixelSize);
+        renderer->renderQuad();
+
+        QSSGResourceTexture2D theWeightTexture(theResourceManager, inDimensions.width(), inDimensions.height(), QSSGRenderTextureFormat::RGBA8);
+        theWeightTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Nearest);
+        theWeightTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Nearest);
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, theWeightTexture.getTexture());
+        theRenderContext->setActiveShader(theWeightShader->shader);
+        theWeightShader->passSampler.set(theEdgeTexture.getTexture().data());
+        theWeightShader->pixelSize.set(thePixelSize);
+        renderer->renderQuad();
+
+        (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, targetTexture.getTexture());
+        theRenderContext->setActiveShader(theBlendShader->shader);
+        theBlendShader->colorSampler.set(m_layerTexture.getTexture().data());
+        theBlendShader->passSampler.set(theWeightTexture.getTexture().data());
+        theBlendShader->pixelSize.set(thePixelSize);
+        renderer->renderQuad();
+    }
+    (*theFB)->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
+    m_layerTexture.stealTexture(targetTexture);
+}
+
 void QSSGLayerRenderData::applyLayerPostEffects()
 {
     if (layer.firstEffect == nullptr) {
@@ -1604,12 +1904,15 @@ void QSSGLayerRenderData::applyLayerPostEffects()
         if (theEffect->flags.testFlag(QSSGRenderEffect::Flag::Active) && camera) {
             startProfiling(theEffect->className, false);
 
-            QSSGRef<QSSGRenderTexture2D> theRenderedEffect = theEffectSystem->renderEffect(
+            // Consecutive per-pixel effects are rendered in one pass, continue after the last one
+            QSSGRenderEffect *theLastEffect = theEffect;
+            QSSGRef<QSSGRenderTexture2D> theRenderedEffect = theEffectSystem->renderEffectChain(
                         QSSGEffectRenderArgument(theEffect,
                                                    theCurrentTexture,
                                                    QVector2D(camera->clipNear, camera->clipFar),
                                                    theLayerDepthTexture,
-                                                   m_layerPrepassDepthTexture));
+                                                   m_layerPrepassDepthTexture),
+                        theLastEffect);
 
             endProfiling(theEffect->className);
 
@@ -1627,6 +1930,8 @@ void QSSGLayerRenderData::applyLayerPostEffects()
                 qFatal("%s", errorMsg.toUtf8().constData());
                 break;
             }
+
+            theEffect = theLastEffect;
         }
     }
 
@@ -1746,7 +2051,7 @@ void QSSGLayerRenderData::runnableRenderToViewport(const QSSGRef<QSSGRenderFrame
                     QSSGRenderFrameBufferAttachment theAttachment = getFramebufferDepthAttachmentFormat(QSSGRenderTextureFormat::Depth24Stencil8);
                     theFBO->attach(theAttachment, m_layerDepthTexture.getTexture());
                     theContext->clear(QSSGRenderClearValues::Color);
-                    renderAoPass();
+                    renderAoPass(&theFBO);
                     theFBO->attach(QSSGRenderFrameBufferAttachment::Color0, QSSGRenderTextureOrRenderBuffer());
                     endProfiling("AO pass");
                 }
@@ -2158,14 +2463,11 @@ void QSSGLayerRenderData::resetForFrame()
 {
     QSSGLayerRenderPreparationData::resetForFrame();
     m_boundingRectColor.setEmpty();
+    m_pickTargets.clear();
 }
 
 void QSSGLayerRenderData::prepareAndRender(const QMatrix4x4 &inViewProjection)
 {
-    TRenderableObjectList theTransparentObjects(transparentObjects);
-    TRenderableObjectList theOpaqueObjects(opaqueObjects);
-    theTransparentObjects.clear();
-    theOpaqueObjects.clear();
     modelContexts.clear();
     QSSGLayerRenderPreparationResultFlags theFlags;
     prepareRenderablesForRender(inViewProjection, QSSGEmpty(), theFlags);
@@ -52,6 +52,18 @@ enum class AdvancedBlendModes
 {
     None = 0, Overlay, ColorBurn, ColorDodge
 };
+
+// A renderable of the last frame as seen by batched picking, the inverse transform is what
+// every ray needs and is computed once for all of them.
+struct QSSGRenderPickTarget
+{
+    const QSSGRenderGraphObject *object = nullptr;
+    QMatrix4x4 globalTransform;
+    QMatrix4x4 inverseGlobalTransform;
+    QSSGBounds3 bounds;
+    bool pickable = false;
+};
+
 struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
 {
     QAtomicInt ref;
@@ -66,6 +78,8 @@ struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
     QSSGResourceTexture2D m_layerPrepassDepthTexture;
     QSSGResourceTexture2D m_layerWidgetTexture;
     QSSGResourceTexture2D m_layerSsaoTexture;
+    // Screen space motion of the opaque geometry, for reprojecting the temporal AA history
+    QSSGResourceTexture2D m_layerVelocityTexture;
     // if we render multisampled we need resolve buffers
     QSSGResourceTexture2D m_layerMultisampleTexture;
     QSSGResourceTexture2D m_layerMultisamplePrepassDepthTexture;
@@ -95,6 +109,8 @@ struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
     // Ensures we don't stop on an in-between frame; we will run two frames after the dirty flag
     // is clear.
     quint32 m_nonDirtyTemporalAAPassIndex;
+    // Unjittered model view projections of the last temporal AA frame
+    QHash<const QSSGRenderModel *, QMatrix4x4> m_previousModelViewProjections;
     float m_textScale;
 
     QSSGOption<QVector3D> m_boundingRectColor;
@@ -102,6 +118,9 @@ struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
 
     QSize m_previousDimensions;
 
+    // Set up by the first batched pick after a frame and shared by the later ones
+    QVector<QSSGRenderPickTarget> m_pickTargets;
+
     QSSGLayerRenderData(QSSGRenderLayer &inLayer, const QSSGRef<QSSGRendererImpl> &inRenderer);
 
     virtual ~QSSGLayerRenderData() override;
@@ -118,7 +137,8 @@ struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
     // no effects.
     void renderClearPass();
     void renderDepthPass(bool inEnableTransparentDepthWrite = false);
-    void renderAoPass();
+    void renderAoPass(QSSGResourceFrameBuffer *theFB);
+    void renderLowResolutionAoPass(QSSGResourceFrameBuffer *theFB, qint32 inFactor);
     void renderFakeDepthMapPass(QSSGRenderTexture2D *theDepthTex, QSSGRenderTextureCube *theDepthCube);
     void renderShadowMapPass(QSSGResourceFrameBuffer *theFB);
     void renderShadowCubeBlurPass(QSSGResourceFrameBuffer *theFB,
@@ -131,6 +151,8 @@ struct QSSGLayerRenderData : public QSSGLayerRenderPreparationData
                                  const QSSGRef<QSSGRenderTexture2D> &target1,
                                  float filterSz,
                                  float clipFar);
+    void renderVelocityPass(bool inWriteDepth);
+    void renderPostAAPass(QSSGResourceFrameBuffer *theFB, const QSize &inDimensions, QSSGRenderTextureFormat inFormat);
 
     void render(QSSGResourceFrameBuffer *theFB = nullptr);
     void resetForFrame() override;
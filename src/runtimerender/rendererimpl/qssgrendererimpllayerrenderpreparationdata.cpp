@@ -49,6 +49,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercustommaterialsystem_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderrenderlist_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendermaterialshadergenerator_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderpath_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderpathmanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
@@ -63,13 +64,39 @@ QT_BEGIN_NAMESPACE
 
 namespace {
 
-inline bool iSRenderObjectPtrLessThan(const QSSGRenderableObject *lhs, const QSSGRenderableObject *rhs)
+// Sorting the distances next to the pointers avoids dereferencing every object in each comparison
+struct QSSGRenderableSortKey
 {
-    return lhs->cameraDistanceSq < rhs->cameraDistanceSq;
-}
-inline bool iSRenderObjectPtrGreatThan(const QSSGRenderableObject *lhs, const QSSGRenderableObject *rhs)
+    float cameraDistanceSq;
+    QSSGRenderableObject *object;
+};
+
+void sortRenderablesByCameraDistance(QSSGPerFrameAllocator &inAllocator,
+                                     QSSGLayerRenderPreparationData::TRenderableObjectList &ioObjects,
+                                     const QVector3D &inCameraPosition,
+                                     const QVector3D &inCameraDirection,
+                                     bool inFurthestFirst)
 {
-    return lhs->cameraDistanceSq > rhs->cameraDistanceSq;
+    const qint32 count = ioObjects.size();
+    QSSGRenderableSortKey *keys = inAllocator.allocateArray<QSSGRenderableSortKey>(count);
+    for (qint32 idx = 0; idx < count; ++idx) {
+        QSSGRenderableObject &theInfo = *ioObjects[idx];
+        QVector3D difference = theInfo.worldCenterPoint - inCameraPosition;
+        theInfo.cameraDistanceSq = QVector3D::dotProduct(difference, inCameraDirection);
+        keys[idx].cameraDistanceSq = theInfo.cameraDistanceSq;
+        keys[idx].object = &theInfo;
+    }
+    if (inFurthestFirst) {
+        std::sort(keys, keys + count, [](const QSSGRenderableSortKey &lhs, const QSSGRenderableSortKey &rhs) {
+            return lhs.cameraDistanceSq > rhs.cameraDistanceSq;
+        });
+    } else {
+        std::sort(keys, keys + count, [](const QSSGRenderableSortKey &lhs, const QSSGRenderableSortKey &rhs) {
+            return lhs.cameraDistanceSq < rhs.cameraDistanceSq;
+        });
+    }
+    for (qint32 idx = 0; idx < count; ++idx)
+        ioObjects[idx] = keys[idx].object;
 }
 
 void MaybeQueueNodeForRender(QSSGRenderNode &inNode,
@@ -86,9 +113,6 @@ void MaybeQueueNodeForRender(QSSGRenderNode &inNode,
         outCameras.push_back(static_cast<QSSGRenderCamera *>(&inNode));
     else if (inNode.type == QSSGRenderGraphObject::Type::Light)
         outLights.push_back(static_cast<QSSGRenderLight *>(&inNode));
-
-    for (QSSGRenderNode *theChild = inNode.firstChild; theChild != nullptr; theChild = theChild->nextSibling)
-        MaybeQueueNodeForRender(*theChild, outRenderables, outCameras, outLights, ioDFSIndex);
 }
 
 bool HasValidLightProbe(QSSGRenderImage *inLightProbeImage)
@@ -168,6 +192,16 @@ void QSSGLayerRenderPreparationData::createShadowMapManager()
     shadowMapManager = QSSGRenderShadowMap::create(renderer->demonContext());
 }
 
+QVector<QSSGRenderLight *> QSSGLayerRenderPreparationData::customMaterialLights() const
+{
+    if (clusteredLights.isEmpty())
+        return globalLights;
+    QVector<QSSGRenderLight *> theLights(globalLights);
+    for (qint32 idx = 0; idx < clusteredLights.size() && theLights.size() < QSSG_MAX_NUM_LIGHTS; ++idx)
+        theLights.push_back(clusteredLights.at(idx));
+    return theLights;
+}
+
 bool QSSGLayerRenderPreparationData::usesOffscreenRenderer()
 {
     if (lastFrameOffscreenRenderer)
@@ -201,31 +235,31 @@ QVector3D QSSGLayerRenderPreparationData::getCameraDirection()
 }
 
 // Per-frame cache of renderable objects post-sort.
-const QVector<QSSGRenderableObject *> &QSSGLayerRenderPreparationData::getOpaqueRenderableObjects()
+const QSSGLayerRenderPreparationData::TRenderableObjectList &QSSGLayerRenderPreparationData::getOpaqueRenderableObjects()
 {
     if (renderedOpaqueObjects.empty() == false || camera == nullptr)
         return renderedOpaqueObjects;
+    QSSGStackPerfTimer perfTimer(renderer->demonContext()->performanceTimer(), Q_FUNC_INFO);
     if (layer.flags.testFlag(QSSGRenderLayer::Flag::LayerEnableDepthTest) && !opaqueObjects.empty()) {
         QVector3D theCameraDirection(getCameraDirection());
         QVector3D theCameraPosition = camera->getGlobalPos();
         renderedOpaqueObjects = opaqueObjects;
-        // Setup the object's sorting information
-        for (int idx = 0, end = renderedOpaqueObjects.size(); idx < end; ++idx) {
-            QSSGRenderableObject &theInfo = *renderedOpaqueObjects[idx];
-            QVector3D difference = theInfo.worldCenterPoint - theCameraPosition;
-            theInfo.cameraDistanceSq = QVector3D::dotProduct(difference, theCameraDirection);
-        }
         // Render nearest to furthest objects
-        std::sort(renderedOpaqueObjects.begin(), renderedOpaqueObjects.end(), iSRenderObjectPtrLessThan);
+        sortRenderablesByCameraDistance(renderer->demonContext()->perFrameAllocator(),
+                                        renderedOpaqueObjects,
+                                        theCameraPosition,
+                                        theCameraDirection,
+                                        false);
     }
     return renderedOpaqueObjects;
 }
 
 // If layer depth test is false, this may also contain opaque objects.
-const QVector<QSSGRenderableObject *> &QSSGLayerRenderPreparationData::getTransparentRenderableObjects()
+const QSSGLayerRenderPreparationData::TRenderableObjectList &QSSGLayerRenderPreparationData::getTransparentRenderableObjects()
 {
     if (renderedTransparentObjects.empty() == false || camera == nullptr)
         return renderedTransparentObjects;
+    QSSGStackPerfTimer perfTimer(renderer->demonContext()->performanceTimer(), Q_FUNC_INFO);
 
     renderedTransparentObjects = transparentObjects;
 
@@ -236,14 +270,12 @@ const QVector<QSSGRenderableObject *> &QSSGLayerRenderPreparationData::getTransp
         QVector3D theCameraDirection(getCameraDirection());
         QVector3D theCameraPosition = camera->getGlobalPos();
 
-        // Setup the object's sorting information
-        for (quint32 idx = 0, end = renderedTransparentObjects.size(); idx < end; ++idx) {
-            QSSGRenderableObject &theInfo = *renderedTransparentObjects[idx];
-            QVector3D difference = theInfo.worldCenterPoint - theCameraPosition;
-            theInfo.cameraDistanceSq = QVector3D::dotProduct(difference, theCameraDirection);
-        }
         // render furthest to nearest.
-        std::sort(renderedTransparentObjects.begin(), renderedTransparentObjects.end(), iSRenderObjectPtrGreatThan);
+        sortRenderablesByCameraDistance(renderer->demonContext()->perFrameAllocator(),
+                                        renderedTransparentObjects,
+                                        theCameraPosition,
+                                        theCameraDirection,
+                                        true);
     }
 
     return renderedTransparentObjects;
@@ -273,6 +305,7 @@ void QSSGLayerRenderPreparationData::addRenderWidget(QSSGRenderWidgetInterface &
 
 QSSGShaderDefaultMaterialKey QSSGLayerRenderPreparationData::generateLightingKey(QSSGRenderDefaultMaterial::MaterialLighting inLightingType, bool receivesShadows)
 {
+    QSSGStackPerfTimer perfTimer(renderer->demonContext()->performanceTimer(), Q_FUNC_INFO);
     QSSGShaderDefaultMaterialKey theGeneratedKey(getShaderFeatureSetHash());
     const bool lighting = inLightingType != QSSGRenderDefaultMaterial::MaterialLighting::NoLighting;
     renderer->defaultMaterialShaderKeyProperties().m_hasLighting.setValue(theGeneratedKey, lighting);
@@ -288,6 +321,8 @@ QSSGShaderDefaultMaterialKey QSSGLayerRenderPreparationData::generateLightingKey
             Q_ASSERT(false);
         }
         renderer->defaultMaterialShaderKeyProperties().m_lightCount.setValue(theGeneratedKey, numLights);
+        // The number of clustered lights does not change the shader, only their presence does
+        renderer->defaultMaterialShaderKeyProperties().m_clusteredLighting.setValue(theGeneratedKey, !clusteredLights.isEmpty());
 
         for (quint32 lightIdx = 0, lightEnd = globalLights.size(); lightIdx < lightEnd; ++lightIdx) {
             QSSGRenderLight *theLight(globalLights[lightIdx]);
@@ -599,6 +634,9 @@ QSSGDefaultMaterialPreparationResult QSSGLayerRenderPreparationData::prepareDefa
         // Run through the material's images and prepare them for render.
         // this may in fact set pickable on the renderable flags if one of the images
         // links to a sub presentation or any offscreen rendered object.
+        // Image changes are tracked separately since they change the material's constant buffer.
+        const bool wasDirty = renderableFlags.isDirty();
+        renderableFlags.setDirty(false);
         QSSGRenderableImage *nextImage = nullptr;
 #define CHECK_IMAGE_AND_PREPARE(img, imgtype, shadercomponent)                                                         \
     if ((img))                                                                                                         \
@@ -642,6 +680,11 @@ QSSGDefaultMaterialPreparationResult QSSGLayerRenderPreparationData::prepareDefa
         CHECK_IMAGE_AND_PREPARE(theMaterial->lightmaps.m_lightmapShadow,
                                 QSSGImageMapTypes::LightmapShadow,
                                 QSSGShaderDefaultMaterialKeyProperties::LightmapShadow);
+
+        if (renderableFlags.isDirty())
+            theMaterial->dirty.updateGeneration();
+        if (wasDirty)
+            renderableFlags.setDirty(true);
     }
 #undef CHECK_IMAGE_AND_PREPARE
 
@@ -724,6 +767,7 @@ bool QSSGLayerRenderPreparationData::prepareModelForRender(QSSGRenderModel &inMo
                                                              const QSSGOption<QSSGClippingFrustum> &inClipFrustum,
                                                              QSSGNodeLightEntryList &inScopedLights)
 {
+    QSSGStackPerfTimer perfTimer(renderer->demonContext()->performanceTimer(), Q_FUNC_INFO);
     const QSSGRef<QSSGRenderContextInterface> &demonContext(renderer->demonContext());
     const QSSGRef<QSSGBufferManager> &bufferManager = demonContext->bufferManager();
     QSSGRenderMesh *theMesh = bufferManager->loadMesh(inModel.meshPath);
@@ -736,7 +780,7 @@ bool QSSGLayerRenderPreparationData::prepareModelForRender(QSSGRenderModel &inMo
     bool subsetDirty = false;
 
     const QSSGScopedLightsListScope lightsScope(globalLights, lightDirections, sourceLightDirections, inScopedLights);
-    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty());
+    setShaderFeature(QSSGShaderDefines::cgLighting(), !globalLights.empty() || !clusteredLights.empty());
     for (int idx = 0; idx < theMesh->subsets.size(); ++idx) {
         // If the materials list < size of subsets, then use the last material for the rest
         QSSGRenderGraphObject *theSourceMaterialObject = nullptr;
@@ -1101,9 +1145,15 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
             cameras.clear();
             lights.clear();
             renderableNodes.clear();
+            // The flattened hierarchy brings the global variables of all nodes up to date in
+            // one sweep and provides the depth first order. The depth first indices are
+            // assigned every frame since other layers can share the nodes.
+            if (nodeHierarchy.needsRebuild(layer))
+                nodeHierarchy.build(layer);
+            wasDataDirty = nodeHierarchy.update(renderer->demonContext()->threadPool()) || wasDataDirty;
             quint32 dfsIndex = 0;
-            for (QSSGRenderNode *theChild = layer.firstChild; theChild; theChild = theChild->nextSibling)
-                MaybeQueueNodeForRender(*theChild, renderableNodes, cameras, lights, dfsIndex);
+            for (const qint32 nodeIdx : nodeHierarchy.depthFirstOrder())
+                MaybeQueueNodeForRender(*nodeHierarchy.node(nodeIdx), renderableNodes, cameras, lights, dfsIndex);
             std::reverse(cameras.begin(), cameras.end());
             std::reverse(lights.begin(), lights.end());
             std::reverse(renderableNodes.begin(), renderableNodes.end());
@@ -1111,10 +1161,9 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
 
             camera = nullptr;
             globalLights.clear();
+            clusteredLights.clear();
             opaqueObjects.clear();
-            qDeleteAll(opaqueObjects);
             transparentObjects.clear();
-            qDeleteAll(transparentObjects);
             QVector<QSSGLightNodeMarker> theLightNodeMarkers;
             sourceLightDirections.clear();
 
@@ -1135,6 +1184,7 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
             }
 
             // Lights
+            const bool clusterLights = QSSGRenderClusteredLights::isEnabled(renderer->context());
             for (qint32 idx = 0, end = lights.size(); idx < end; ++idx) {
                 QSSGRenderLight *theLight = lights[idx];
                 wasDataDirty = wasDataDirty || theLight->flags.testFlag(QSSGRenderNode::Flag::Dirty);
@@ -1152,7 +1202,9 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
                 // as it used to but
                 // additional perhaps on the light's scoping rules.
                 if (theLight->flags.testFlag(QSSGRenderLight::Flag::GloballyActive)) {
-                    if (theLight->m_scope == nullptr) {
+                    if (clusterLights && QSSGRenderClusteredLights::canCluster(*theLight)) {
+                        clusteredLights.push_back(theLight);
+                    } else if (theLight->m_scope == nullptr) {
                         globalLights.push_back(theLight);
                         if (renderer->context()->renderContextType() != QSSGRenderContextType::GLES2
                                 && theLight->m_castShadow) {
@@ -1201,7 +1253,7 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
                         QSSGLightNodeMarker &theMarker = theLightNodeMarkers[markerIdx];
                         if (nodeDFSIndex >= theMarker.firstValidIndex && nodeDFSIndex < theMarker.justPastLastValidIndex) {
                             if (theMarker.addOrRemove) {
-                                QSSGNodeLightEntry *theNewEntry = new QSSGNodeLightEntry(theMarker.light, theMarker.lightIndex);
+                                QSSGNodeLightEntry *theNewEntry = RENDER_FRAME_NEW(QSSGNodeLightEntry)(theMarker.light, theMarker.lightIndex);
                                 theNodeEntry.lights.push_back(*theNewEntry);
                             } else {
                                 for (QSSGNodeLightEntryList::iterator lightIter = theNodeEntry.lights.begin(),
@@ -1211,7 +1263,6 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
                                     if (lightIter->light == theMarker.light) {
                                         QSSGNodeLightEntry &theEntry = *lightIter;
                                         theNodeEntry.lights.remove(theEntry);
-                                        delete &theEntry;
                                         break;
                                     }
                                 }
@@ -1239,6 +1290,14 @@ void QSSGLayerRenderPreparationData::prepareForRender(const QSize &inViewportDim
             } else
                 viewProjection = QMatrix4x4();
 
+            if (camera && !clusteredLights.isEmpty()) {
+                if (!clusteredLightGrid)
+                    clusteredLightGrid = QSSGRenderClusteredLights::create(renderer->demonContext().data());
+                clusteredLightGrid->update(*camera, clusteredLights);
+            } else if (!camera) {
+                clusteredLights.clear();
+            }
+
             // Setup the light directions here.
 
             for (qint32 lightIdx = 0, lightEnd = globalLights.size(); lightIdx < lightEnd; ++lightIdx) {
@@ -1322,6 +1381,9 @@ void QSSGLayerRenderPreparationData::resetForFrame()
     lightDirections.clear();
     renderedOpaqueObjects.clear();
     renderedTransparentObjects.clear();
+    // The renderables and the node light entries live in per frame memory, which the
+    // next frame of any layer of this context reuses.
+    renderableNodes.clear();
 }
 
 QT_END_NAMESPACE
@@ -50,6 +50,8 @@
 #include <QtQuick3DRuntimeRender/private/qssgoffscreenrendermanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendergpuprofiler_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadowmap_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderclusteredlights_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernodehierarchy_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderableobjects_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -242,7 +244,7 @@ struct QSSGLayerRenderPreparationData
 
     enum Enum {
         MAX_AA_LEVELS = 8,
-        MAX_TEMPORAL_AA_LEVELS = 2,
+        MAX_TEMPORAL_AA_LEVELS = 16,
     };
 
     QSSGRenderLayer &layer;
@@ -259,10 +261,14 @@ struct QSSGLayerRenderPreparationData
     // are being generated.
     QVector<QSSGRenderCamera *> cameras;
     QVector<QSSGRenderLight *> lights;
+    // Flattened node tree of the layer, rebuilt when the node graph changes.
+    QSSGRenderNodeHierarchy nodeHierarchy;
 
     // Results of prepare for render.
     QSSGRenderCamera *camera;
     QVector<QSSGRenderLight *> globalLights; // Only contains lights that are global.
+    // Global point lights that are shaded from the cluster lists instead of globalLights.
+    QVector<QSSGRenderLight *> clusteredLights;
     TRenderableObjectList opaqueObjects;
     TRenderableObjectList transparentObjects;
     // Sorted lists of the rendered objects.  There may be other transforms applied so
@@ -295,11 +301,15 @@ struct QSSGLayerRenderPreparationData
 
     // shadow mapps
     QSSGRef<QSSGRenderShadowMap> shadowMapManager;
+    // froxel light lists of clusteredLights, null until a layer has clustered lights
+    QSSGRef<QSSGRenderClusteredLights> clusteredLightGrid;
 
     QSSGLayerRenderPreparationData(QSSGRenderLayer &inLayer, const QSSGRef<QSSGRendererImpl> &inRenderer);
     virtual ~QSSGLayerRenderPreparationData();
     bool usesOffscreenRenderer();
     void createShadowMapManager();
+    // Custom materials have their own light buffer, they get the clustered lights appended.
+    QVector<QSSGRenderLight *> customMaterialLights() const;
     bool needsWidgetTexture() const;
 
     static QByteArray cgLightingFeatureName();
@@ -350,9 +360,9 @@ struct QSSGLayerRenderPreparationData
 
     QVector3D getCameraDirection();
     // Per-frame cache of renderable objects post-sort.
-    const QVector<QSSGRenderableObject *> &getOpaqueRenderableObjects();
+    const TRenderableObjectList &getOpaqueRenderableObjects();
     // If layer depth test is false, this may also contain opaque objects.
-    const QVector<QSSGRenderableObject *> &getTransparentRenderableObjects();
+    const TRenderableObjectList &getTransparentRenderableObjects();
 
     virtual void resetForFrame();
 
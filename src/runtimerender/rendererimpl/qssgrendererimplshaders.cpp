@@ -64,14 +64,27 @@ struct QSSGSubsetMaterialVertexPipeline : public QSSGVertexPipelineImpl
 {
     QSSGRendererImpl &renderer;
     QSSGSubsetRenderable &renderable;
+    QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> materialGenerator;
     TessModeValues tessMode;
 
     QSSGSubsetMaterialVertexPipeline(QSSGRendererImpl &inRenderer, QSSGSubsetRenderable &inRenderable, bool inWireframeRequested)
-        : QSSGVertexPipelineImpl(inRenderer.demonContext()->defaultMaterialShaderGenerator(),
-                                   inRenderer.demonContext()->shaderProgramGenerator(),
-                                   false)
+        : QSSGSubsetMaterialVertexPipeline(inRenderer,
+                                           inRenderable,
+                                           inWireframeRequested,
+                                           inRenderer.demonContext()->defaultMaterialShaderGenerator(),
+                                           inRenderer.demonContext()->shaderProgramGenerator())
+    {
+    }
+
+    QSSGSubsetMaterialVertexPipeline(QSSGRendererImpl &inRenderer,
+                                     QSSGSubsetRenderable &inRenderable,
+                                     bool inWireframeRequested,
+                                     const QSSGRef<QSSGDefaultMaterialShaderGeneratorInterface> &inMaterialGenerator,
+                                     const QSSGRef<QSSGShaderProgramGeneratorInterface> &inProgramGenerator)
+        : QSSGVertexPipelineImpl(inMaterialGenerator, inProgramGenerator, false)
         , renderer(inRenderer)
         , renderable(inRenderable)
+        , materialGenerator(inMaterialGenerator)
         , tessMode(TessModeValues::NoTess)
     {
         if (inRenderer.context()->supportsTessellation())
@@ -125,9 +138,9 @@ struct QSSGSubsetMaterialVertexPipeline : public QSSGVertexPipelineImpl
         setupTessIncludes(QSSGShaderGeneratorStage::TessEval, tessMode);
 
         if (tessMode == TessModeValues::TessLinear)
-            renderer.demonContext()->defaultMaterialShaderGenerator()->addDisplacementImageUniforms(tessEvalShader,
-                                                                                                          m_displacementIdx,
-                                                                                                          m_displacementImage);
+            materialGenerator->addDisplacementImageUniforms(tessEvalShader,
+                                                            m_displacementIdx,
+                                                            m_displacementImage);
 
         tessEvalShader.addUniform("model_view_projection", "mat4");
         tessEvalShader.addUniform("normal_matrix", "mat3");
@@ -193,7 +206,7 @@ struct QSSGSubsetMaterialVertexPipeline : public QSSGVertexPipelineImpl
             // displacement mapping makes only sense with linear tessellation
             if (tessMode == TessModeValues::TessLinear && m_displacementImage) {
                 QSSGDefaultMaterialShaderGeneratorInterface::ImageVariableNames
-                        theNames = renderer.demonContext()->defaultMaterialShaderGenerator()->getImageVariableNames(m_displacementIdx);
+                        theNames = materialGenerator->getImageVariableNames(m_displacementIdx);
                 tessEvalShader << "\tpos.xyz = defaultMaterialFileDisplacementTexture( " << theNames.m_imageSampler
                                << ", displaceAmount, " << theNames.m_imageFragCoords << outExt;
                 tessEvalShader << ", varObjectNormal" << outExt << ", pos.xyz );"
@@ -450,6 +463,25 @@ QSSGRef<QSSGRenderShaderProgram> QSSGRendererImpl::generateShader(QSSGSubsetRend
                                                                                logPrefix());
 }
 
+// Thread-safe counterpart of generateShader() used by the asynchronous path, the request
+// carries everything the generators need so nothing is read from the current layer.
+void QSSGRendererImpl::generateShaderSource(QSSGShaderRequest &ioRequest, const TShaderGeneratorPair &inGenerators)
+{
+    QSSGSubsetMaterialVertexPipeline pipeline(*this,
+                                              *ioRequest.renderable,
+                                              m_defaultMaterialShaderKeyProperties.m_wireframeMode.getValue(ioRequest.key),
+                                              inGenerators.first,
+                                              inGenerators.second);
+    ioRequest.source = inGenerators.first->generateShaderSource(ioRequest.renderable->material,
+                                                                ioRequest.key,
+                                                                pipeline,
+                                                                ioRequest.features,
+                                                                ioRequest.lights,
+                                                                ioRequest.firstImage,
+                                                                ioRequest.renderable->renderableFlags.hasTransparency(),
+                                                                logPrefix());
+}
+
 // --------------  Special cases for shadows  -------------------
 
 QSSGRef<QSSGRenderableDepthPrepassShader> QSSGRendererImpl::getParaboloidDepthShader(TessModeValues inTessMode)
@@ -1927,6 +1959,480 @@ QSSGRef<QSSGLayerProgAABlendShader> QSSGRendererImpl::getLayerProgAABlendShader(
     return m_layerProgAAShader;
 }
 
+// Full screen pass for the post-process antialiasing, the caller adds the fragment stage.
+static void beginLayerPostAAProgram(const QSSGRef<QSSGShaderProgramGeneratorInterface> &inGenerator)
+{
+    inGenerator->beginProgram();
+    QSSGShaderStageGeneratorInterface &vertexGenerator(*inGenerator->getStage(QSSGShaderGeneratorStage::Vertex));
+    vertexGenerator.addIncoming("attr_pos", "vec3");
+    vertexGenerator.addIncoming("attr_uv", "vec2");
+    vertexGenerator.addOutgoing("uv_coords", "vec2");
+    vertexGenerator.append("void main() {");
+    vertexGenerator.append("\tgl_Position = vec4(attr_pos, 1.0 );");
+    vertexGenerator.append("\tuv_coords = attr_uv;");
+    vertexGenerator.append("}");
+}
+
+static QSSGRef<QSSGLayerPostAAShader> compileLayerPostAAProgram(const QSSGRef<QSSGShaderProgramGeneratorInterface> &inGenerator,
+                                                                const char *inName)
+{
+    QSSGRef<QSSGRenderShaderProgram> theShader = inGenerator->compileGeneratedShader(inName,
+                                                                                     QSSGShaderCacheProgramFlags(),
+                                                                                     TShaderFeatureSet());
+    QSSGRef<QSSGLayerPostAAShader> retval;
+    if (theShader)
+        retval = QSSGRef<QSSGLayerPostAAShader>(new QSSGLayerPostAAShader(theShader));
+    return retval;
+}
+
+QSSGRef<QSSGLayerPostAAShader> QSSGRendererImpl::getLayerFxaaShader()
+{
+    if (m_layerFxaaShader)
+        return m_layerFxaaShader;
+
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("color_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    // Green is used as luma so that the alpha of the layer is left alone.
+    // Without GLSL 1.30 the offset lookups fall back to plain lookups.
+    fragmentGenerator.append("#define FXAA_PC 1\n"
+                             "#define FXAA_GLSL_130 1\n"
+                             "#define FXAA_QUALITY__PRESET 12\n"
+                             "#define FXAA_GREEN_AS_LUMA 1\n"
+                             "#define FXAA_GATHER4_ALPHA 0\n"
+                             "#if __VERSION__ < 130\n"
+                             "#define textureLodOffset(t, p, l, o) textureLod(t, (p) + vec2(o) * pixel_size, l)\n"
+                             "#endif\n"
+                             "#include \"Fxaa3_11.glsllib\"\n"
+                             "void main() {\n"
+                             "\tgl_FragColor = FxaaPixelShader(uv_coords, vec4(0.0), color_sampler, color_sampler, color_sampler,\n"
+                             "\t                               pixel_size, vec4(0.0), vec4(0.0), vec4(0.0),\n"
+                             "\t                               0.75, 0.166, 0.0833, 8.0, 0.125, 0.05, vec4(0.0));\n"
+                             "}");
+    m_layerFxaaShader = compileLayerPostAAProgram(getProgramGenerator(), "layer FXAA shader");
+    return m_layerFxaaShader;
+}
+
+// The SMAA passes follow SMAA 1x with luma edge detection. The blending weights of
+// the orthogonal patterns are computed in the shader, as the precomputed area and
+// search textures SMAA.glsllib expects are not available.
+QSSGRef<QSSGLayerPostAAShader> QSSGRendererImpl::getLayerSmaaEdgeShader()
+{
+    if (m_layerSmaaEdgeShader)
+        return m_layerSmaaEdgeShader;
+
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("color_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    // The left and top edges of the pixel go to red and green
+    fragmentGenerator.append("#define SMAA_THRESHOLD 0.1\n"
+                             "#define SMAA_LOCAL_CONTRAST_ADAPTATION_FACTOR 2.0\n"
+                             "float smaaLuma(vec2 coord) {\n"
+                             "\treturn dot(texture2D(color_sampler, coord).rgb, vec3(0.2126, 0.7152, 0.0722));\n"
+                             "}\n"
+                             "void main() {\n"
+                             "\tfloat L = smaaLuma(uv_coords);\n"
+                             "\tfloat Lleft = smaaLuma(uv_coords - vec2(pixel_size.x, 0.0));\n"
+                             "\tfloat Ltop = smaaLuma(uv_coords - vec2(0.0, pixel_size.y));\n"
+                             "\tvec4 delta;\n"
+                             "\tdelta.xy = abs(L - vec2(Lleft, Ltop));\n"
+                             "\tvec2 edges = step(vec2(SMAA_THRESHOLD), delta.xy);\n"
+                             "\tif (dot(edges, vec2(1.0)) == 0.0) {\n"
+                             "\t\tgl_FragColor = vec4(0.0);\n"
+                             "\t\treturn;\n"
+                             "\t}\n"
+                             "\tfloat Lright = smaaLuma(uv_coords + vec2(pixel_size.x, 0.0));\n"
+                             "\tfloat Lbottom = smaaLuma(uv_coords + vec2(0.0, pixel_size.y));\n"
+                             "\tdelta.zw = abs(L - vec2(Lright, Lbottom));\n"
+                             "\tvec2 maxDelta = max(delta.xy, delta.zw);\n"
+                             "\tfloat Lleftleft = smaaLuma(uv_coords - vec2(2.0 * pixel_size.x, 0.0));\n"
+                             "\tfloat Ltoptop = smaaLuma(uv_coords - vec2(0.0, 2.0 * pixel_size.y));\n"
+                             "\tdelta.zw = abs(vec2(Lleft, Ltop) - vec2(Lleftleft, Ltoptop));\n"
+                             "\tmaxDelta = max(maxDelta.xy, delta.zw);\n"
+                             "\tfloat finalDelta = max(maxDelta.x, maxDelta.y);\n"
+                             "\tedges *= step(vec2(finalDelta), SMAA_LOCAL_CONTRAST_ADAPTATION_FACTOR * delta.xy);\n"
+                             "\tgl_FragColor = vec4(edges, 0.0, 1.0);\n"
+                             "}");
+    m_layerSmaaEdgeShader = compileLayerPostAAProgram(getProgramGenerator(), "layer SMAA edge detection shader");
+    return m_layerSmaaEdgeShader;
+}
+
+QSSGRef<QSSGLayerPostAAShader> QSSGRendererImpl::getLayerSmaaWeightShader()
+{
+    if (m_layerSmaaWeightShader)
+        return m_layerSmaaWeightShader;
+
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("pass_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    // For the edge at the top of the pixel, red is how much of the pixel above is
+    // blended into this one and green the other way around. Blue and alpha are
+    // the same for the edge on the left.
+    fragmentGenerator.append("#define SMAA_MAX_SEARCH_STEPS 16\n"
+                             // Number of pixels the edge in channel continues in direction
+                             "float smaaSearch(vec2 coord, vec2 dir, int channel) {\n"
+                             "\tfloat dist = 0.0;\n"
+                             "\tfor (int i = 0; i < SMAA_MAX_SEARCH_STEPS; ++i) {\n"
+                             "\t\tcoord += dir;\n"
+                             "\t\tvec4 e = texture2D(pass_sampler, coord);\n"
+                             "\t\tif ((channel == 0 ? e.r : e.g) < 0.5)\n"
+                             "\t\t\tbreak;\n"
+                             "\t\tdist += 1.0;\n"
+                             "\t}\n"
+                             "\treturn dist;\n"
+                             "}\n"
+                             // The silhouette is reconstructed as a line from the crossing
+                             // edges at the ends of the edge to its middle. crossing is -1
+                             // when the silhouette turns into this pixel's side, 1 when it
+                             // turns into the neighbor's and 0 when it does not turn. Returns
+                             // the area of the pixel covered by the neighbor's side and the
+                             // area of the neighbor covered by this pixel's side.
+                             "vec2 smaaArea(vec2 dist, vec2 crossing) {\n"
+                             "\tfloat halfLength = 0.5 * (dist.x + dist.y + 1.0);\n"
+                             "\tfloat center = halfLength - dist.x;\n"
+                             "\tfloat split = clamp(center, 0.0, 1.0);\n"
+                             "\tfloat left = 0.25 * crossing.x * (2.0 * center - split) * split / halfLength;\n"
+                             "\tfloat right = 0.25 * crossing.y * (split + 1.0 - 2.0 * center) * (1.0 - split) / halfLength;\n"
+                             "\treturn vec2(-min(left, 0.0) - min(right, 0.0), max(left, 0.0) + max(right, 0.0));\n"
+                             "}\n"
+                             "float smaaCrossing(vec2 ownCoord, vec2 neighborCoord, int channel, float dist) {\n"
+                             "\tif (dist >= float(SMAA_MAX_SEARCH_STEPS))\n"
+                             "\t\treturn 0.0;\n"
+                             "\tvec4 own = texture2D(pass_sampler, ownCoord);\n"
+                             "\tvec4 neighbor = texture2D(pass_sampler, neighborCoord);\n"
+                             "\treturn channel == 0 ? neighbor.r - own.r : neighbor.g - own.g;\n"
+                             "}\n"
+                             "void main() {\n"
+                             "\tvec4 weights = vec4(0.0);\n"
+                             "\tvec2 e = texture2D(pass_sampler, uv_coords).rg;\n"
+                             "\tvec2 dx = vec2(pixel_size.x, 0.0);\n"
+                             "\tvec2 dy = vec2(0.0, pixel_size.y);\n"
+                             "\tif (e.g > 0.5) {\n"
+                             "\t\tvec2 dist = vec2(smaaSearch(uv_coords, -dx, 1), smaaSearch(uv_coords, dx, 1));\n"
+                             "\t\tvec2 leftEnd = uv_coords - dist.x * dx;\n"
+                             "\t\tvec2 rightEnd = uv_coords + (dist.y + 1.0) * dx;\n"
+                             "\t\tvec2 crossing = vec2(smaaCrossing(leftEnd, leftEnd - dy, 0, dist.x),\n"
+                             "\t\t                     smaaCrossing(rightEnd, rightEnd - dy, 0, dist.y));\n"
+                             "\t\tweights.rg = smaaArea(dist, crossing);\n"
+                             "\t}\n"
+                             "\tif (e.r > 0.5) {\n"
+                             "\t\tvec2 dist = vec2(smaaSearch(uv_coords, -dy, 0), smaaSearch(uv_coords, dy, 0));\n"
+                             "\t\tvec2 topEnd = uv_coords - dist.x * dy;\n"
+                             "\t\tvec2 bottomEnd = uv_coords + (dist.y + 1.0) * dy;\n"
+                             "\t\tvec2 crossing = vec2(smaaCrossing(topEnd, topEnd - dx, 1, dist.x),\n"
+                             "\t\t                     smaaCrossing(bottomEnd, bottomEnd - dx, 1, dist.y));\n"
+                             "\t\tweights.ba = smaaArea(dist, crossing);\n"
+                             "\t}\n"
+                             "\tgl_FragColor = weights;\n"
+                             "}");
+    m_layerSmaaWeightShader = compileLayerPostAAProgram(getProgramGenerator(), "layer SMAA blend weight shader");
+    return m_layerSmaaWeightShader;
+}
+
+QSSGRef<QSSGLayerPostAAShader> QSSGRendererImpl::getLayerSmaaBlendShader()
+{
+    if (m_layerSmaaBlendShader)
+        return m_layerSmaaBlendShader;
+
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("color_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pass_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    // Blends with the neighbors along the stronger direction, the bilinear
+    // filtering of the color does the actual mixing.
+    fragmentGenerator.append("void main() {\n"
+                             "\tvec4 a;\n"
+                             "\ta.x = texture2D(pass_sampler, uv_coords + vec2(pixel_size.x, 0.0)).a;\n"
+                             "\ta.y = texture2D(pass_sampler, uv_coords + vec2(0.0, pixel_size.y)).g;\n"
+                             "\ta.wz = texture2D(pass_sampler, uv_coords).rb;\n"
+                             "\tif (dot(a, vec4(1.0)) < 1e-5) {\n"
+                             "\t\tgl_FragColor = texture2D(color_sampler, uv_coords);\n"
+                             "\t\treturn;\n"
+                             "\t}\n"
+                             "\tvec4 blendingOffset = vec4(0.0, a.y, 0.0, a.w);\n"
+                             "\tvec2 blendingWeight = a.yw;\n"
+                             "\tif (max(a.x, a.z) > max(a.y, a.w)) {\n"
+                             "\t\tblendingOffset = vec4(a.x, 0.0, a.z, 0.0);\n"
+                             "\t\tblendingWeight = a.xz;\n"
+                             "\t}\n"
+                             "\tblendingWeight /= dot(blendingWeight, vec2(1.0));\n"
+                             "\tvec4 blendingCoord = uv_coords.xyxy + blendingOffset * vec4(pixel_size, -pixel_size);\n"
+                             "\tgl_FragColor = blendingWeight.x * texture2D(color_sampler, blendingCoord.xy)\n"
+                             "\t             + blendingWeight.y * texture2D(color_sampler, blendingCoord.zw);\n"
+                             "}");
+    m_layerSmaaBlendShader = compileLayerPostAAProgram(getProgramGenerator(), "layer SMAA neighborhood blend shader");
+    return m_layerSmaaBlendShader;
+}
+
+QSSGRef<QSSGLayerVelocityShader> QSSGRendererImpl::getLayerVelocityShader()
+{
+    if (m_layerVelocityShader)
+        return m_layerVelocityShader;
+
+    getProgramGenerator()->beginProgram();
+    QSSGShaderStageGeneratorInterface &vertexGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Vertex));
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    vertexGenerator.addIncoming("attr_pos", "vec3");
+    vertexGenerator.addUniform("model_view_projection", "mat4");
+    vertexGenerator.addUniform("current_model_view_projection", "mat4");
+    vertexGenerator.addUniform("previous_model_view_projection", "mat4");
+    vertexGenerator.addOutgoing("current_position", "vec4");
+    vertexGenerator.addOutgoing("previous_position", "vec4");
+    vertexGenerator.append("void main() {");
+    vertexGenerator.append("\tgl_Position = model_view_projection * vec4(attr_pos, 1.0);");
+    vertexGenerator.append("\tcurrent_position = current_model_view_projection * vec4(attr_pos, 1.0);");
+    vertexGenerator.append("\tprevious_position = previous_model_view_projection * vec4(attr_pos, 1.0);");
+    vertexGenerator.append("}");
+    // The motion since the last frame in texture coordinates
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tvec2 velocity = current_position.xy / current_position.w - previous_position.xy / previous_position.w;");
+    fragmentGenerator.append("\tgl_FragColor = vec4(0.5 * velocity, 0.0, 1.0);");
+    fragmentGenerator.append("}");
+    QSSGRef<QSSGRenderShaderProgram>
+            theShader = getProgramGenerator()->compileGeneratedShader("layer velocity shader",
+                                                                      QSSGShaderCacheProgramFlags(),
+                                                                      TShaderFeatureSet());
+    QSSGRef<QSSGLayerVelocityShader> retval;
+    if (theShader)
+        retval = QSSGRef<QSSGLayerVelocityShader>(new QSSGLayerVelocityShader(theShader));
+    m_layerVelocityShader = retval;
+    return m_layerVelocityShader;
+}
+
+QSSGRef<QSSGLayerTemporalAAShader> QSSGRendererImpl::getLayerTemporalAAShader(bool inVelocity)
+{
+    QSSGRef<QSSGLayerTemporalAAShader> &theTemporalAAShader = m_layerTemporalAAShader[inVelocity ? 1 : 0];
+    if (theTemporalAAShader)
+        return theTemporalAAShader;
+
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("current_sampler", "sampler2D");
+    fragmentGenerator.addUniform("history_sampler", "sampler2D");
+    if (inVelocity)
+        fragmentGenerator.addUniform("velocity_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    fragmentGenerator.addUniform("history_weight", "float");
+    // The history is reprojected along the velocity and clamped to the colors
+    // around the pixel in the current frame, which rejects the history of
+    // surfaces that were not visible in the last frame.
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tvec4 current = texture2D(current_sampler, uv_coords);");
+    fragmentGenerator.append("\tvec4 neighborMin = current;");
+    fragmentGenerator.append("\tvec4 neighborMax = current;");
+    fragmentGenerator.append("\tfor (int y = -1; y <= 1; ++y) {");
+    fragmentGenerator.append("\t\tfor (int x = -1; x <= 1; ++x) {");
+    fragmentGenerator.append("\t\t\tvec4 neighbor = texture2D(current_sampler, uv_coords + vec2(float(x), float(y)) * pixel_size);");
+    fragmentGenerator.append("\t\t\tneighborMin = min(neighborMin, neighbor);");
+    fragmentGenerator.append("\t\t\tneighborMax = max(neighborMax, neighbor);");
+    fragmentGenerator.append("\t\t}");
+    fragmentGenerator.append("\t}");
+    if (inVelocity)
+        fragmentGenerator.append("\tvec2 historyCoords = uv_coords - texture2D(velocity_sampler, uv_coords).xy;");
+    else
+        fragmentGenerator.append("\tvec2 historyCoords = uv_coords;");
+    fragmentGenerator.append("\tfloat weight = history_weight;");
+    fragmentGenerator.append("\tif (historyCoords.x < 0.0 || historyCoords.x > 1.0 || historyCoords.y < 0.0 || historyCoords.y > 1.0)");
+    fragmentGenerator.append("\t\tweight = 0.0;");
+    fragmentGenerator.append("\tvec4 history = clamp(texture2D(history_sampler, historyCoords), neighborMin, neighborMax);");
+    fragmentGenerator.append("\tgl_FragColor = mix(current, history, weight);");
+    fragmentGenerator.append("}");
+    QSSGRef<QSSGRenderShaderProgram>
+            theShader = getProgramGenerator()->compileGeneratedShader(inVelocity ? "layer temporal AA shader velocity"
+                                                                                 : "layer temporal AA shader",
+                                                                      QSSGShaderCacheProgramFlags(),
+                                                                      TShaderFeatureSet());
+    if (theShader)
+        theTemporalAAShader = QSSGRef<QSSGLayerTemporalAAShader>(new QSSGLayerTemporalAAShader(theShader));
+    return theTemporalAAShader;
+}
+
+// Full screen pass of the reduced resolution AO, the caller adds the fragment stage.
+static void beginLayerAoFilterProgram(const QSSGRef<QSSGShaderProgramGeneratorInterface> &inGenerator)
+{
+    beginLayerPostAAProgram(inGenerator);
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*inGenerator->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addInclude("viewProperties.glsllib");
+    fragmentGenerator.addInclude("depthpass.glsllib");
+    fragmentGenerator.append("float linearDepth(float depthSample) {");
+    fragmentGenerator.append("\treturn depthValueToLinearDistance(getDepthValue(vec4(depthSample), camera_properties), camera_properties);");
+    fragmentGenerator.append("}");
+}
+
+static QSSGRef<QSSGLayerAoFilterShader> compileLayerAoFilterProgram(const QSSGRef<QSSGShaderProgramGeneratorInterface> &inGenerator,
+                                                                    const char *inName)
+{
+    QSSGRef<QSSGRenderShaderProgram> theShader = inGenerator->compileGeneratedShader(inName,
+                                                                                     QSSGShaderCacheProgramFlags(),
+                                                                                     TShaderFeatureSet());
+    QSSGRef<QSSGLayerAoFilterShader> retval;
+    if (theShader)
+        retval = QSSGRef<QSSGLayerAoFilterShader>(new QSSGLayerAoFilterShader(theShader));
+    return retval;
+}
+
+QSSGRef<QSSGLayerAoFilterShader> QSSGRendererImpl::getLayerAoDepthDownsampleShader()
+{
+    if (m_layerAoDepthDownsampleShader)
+        return m_layerAoDepthDownsampleShader;
+
+    beginLayerAoFilterProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("depth_sampler", "sampler2D");
+    fragmentGenerator.addUniform("downsample_factor", "float");
+    // The nearest and the farthest depth under the pixel. The AO is computed on
+    // x, which alternates between the two in a checkerboard so that both sides
+    // of a depth edge are represented in the low resolution result.
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tint factor = int(downsample_factor);");
+    fragmentGenerator.append("\tivec2 lowCoords = ivec2(gl_FragCoord.xy);");
+    fragmentGenerator.append("\tivec2 maxCoords = textureSize(depth_sampler, 0) - ivec2(1);");
+    fragmentGenerator.append("\tfloat minDepth = 1.0;");
+    fragmentGenerator.append("\tfloat maxDepth = 0.0;");
+    fragmentGenerator.append("\tfor (int y = 0; y < factor; ++y) {");
+    fragmentGenerator.append("\t\tfor (int x = 0; x < factor; ++x) {");
+    fragmentGenerator.append("\t\t\tfloat depth = texelFetch(depth_sampler, min(lowCoords * factor + ivec2(x, y), maxCoords), 0).x;");
+    fragmentGenerator.append("\t\t\tminDepth = min(minDepth, depth);");
+    fragmentGenerator.append("\t\t\tmaxDepth = max(maxDepth, depth);");
+    fragmentGenerator.append("\t\t}");
+    fragmentGenerator.append("\t}");
+    fragmentGenerator.append("\tif ((lowCoords.x + lowCoords.y) % 2 == 0)");
+    fragmentGenerator.append("\t\tgl_FragColor = vec4(minDepth, maxDepth, 0.0, 1.0);");
+    fragmentGenerator.append("\telse");
+    fragmentGenerator.append("\t\tgl_FragColor = vec4(maxDepth, minDepth, 0.0, 1.0);");
+    fragmentGenerator.append("}");
+    m_layerAoDepthDownsampleShader = compileLayerAoFilterProgram(getProgramGenerator(), "layer AO depth downsample shader");
+    return m_layerAoDepthDownsampleShader;
+}
+
+QSSGRef<QSSGLayerAoFilterShader> QSSGRendererImpl::getLayerLowResolutionAoShader()
+{
+    if (m_layerLowResolutionAoShader)
+        return m_layerLowResolutionAoShader;
+
+    // Same as the fullscreen AO pass, but on the downsampled depth. The screen
+    // constants of cbAoShadow are for the layer resolution and get rescaled.
+    beginLayerPostAAProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addInclude("viewProperties.glsllib");
+    fragmentGenerator.addInclude("screenSpaceAO.glsllib");
+    fragmentGenerator << "layout (std140) uniform cbAoShadow { "
+                      << "\n"
+                      << "\tvec4 ao_properties;"
+                      << "\n"
+                      << "\tvec4 ao_properties2;"
+                      << "\n"
+                      << "\tvec4 shadow_properties;"
+                      << "\n"
+                      << "\tvec4 aoScreenConst;"
+                      << "\n"
+                      << "\tvec4 UvToEyeConst;"
+                      << "\n"
+                      << "};"
+                      << "\n";
+    fragmentGenerator.addUniform("depth_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    fragmentGenerator.append("float normalizedDepth(ivec2 coords) {");
+    fragmentGenerator.append("\tfloat depth = getDepthValue(texelFetch(depth_sampler, coords, 0), camera_properties);");
+    fragmentGenerator.append("\tdepth = depthValueToLinearDistance(depth, camera_properties);");
+    fragmentGenerator.append("\treturn (depth - camera_properties.x) / (camera_properties.y - camera_properties.x);");
+    fragmentGenerator.append("}");
+    fragmentGenerator.append("vec3 depthNormal(float depth) {");
+    fragmentGenerator.append("\treturn normalize(cross(vec3(10, 0, dFdx(depth)), vec3(0, 10, dFdy(depth))));");
+    fragmentGenerator.append("}");
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tivec2 iCoords = ivec2(gl_FragCoord.xy);");
+    fragmentGenerator.append("\tivec2 maxCoords = textureSize(depth_sampler, 0) - ivec2(1);");
+    fragmentGenerator.append("\tvec3 screenNorm = depthNormal(normalizedDepth(iCoords));");
+    fragmentGenerator.append("\tscreenNorm += depthNormal(normalizedDepth(min(iCoords + ivec2(1), maxCoords)));");
+    fragmentGenerator.append("\tscreenNorm += depthNormal(normalizedDepth(max(iCoords - ivec2(1), ivec2(0))));");
+    fragmentGenerator.append("\tscreenNorm = -normalize(screenNorm);");
+    fragmentGenerator.append("\tvec4 aoScreen = vec4(aoScreenConst.x, aoScreenConst.y * aoScreenConst.w / pixel_size.y, pixel_size);");
+    fragmentGenerator.append("\tfloat aoFactor = SSambientOcclusion(depth_sampler, screenNorm, ao_properties, ao_properties2,"
+                             " camera_properties, aoScreen, UvToEyeConst);");
+    fragmentGenerator.append("\tgl_FragColor = vec4(aoFactor, aoFactor, aoFactor, 1.0);");
+    fragmentGenerator.append("}");
+    m_layerLowResolutionAoShader = compileLayerAoFilterProgram(getProgramGenerator(), "layer low resolution AO pass shader");
+    return m_layerLowResolutionAoShader;
+}
+
+QSSGRef<QSSGLayerAoFilterShader> QSSGRendererImpl::getLayerAoBlurShader()
+{
+    if (m_layerAoBlurShader)
+        return m_layerAoBlurShader;
+
+    beginLayerAoFilterProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("ao_sampler", "sampler2D");
+    fragmentGenerator.addUniform("low_depth_sampler", "sampler2D");
+    fragmentGenerator.addUniform("blur_direction", "vec2");
+    // One direction of a separable gaussian. Samples on a surface farther than
+    // a few percent of the distance away do not contribute, which keeps the
+    // occlusion from bleeding over the silhouettes.
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tfloat centerDepth = linearDepth(texture2D(low_depth_sampler, uv_coords).x);");
+    fragmentGenerator.append("\tfloat ao = 0.0;");
+    fragmentGenerator.append("\tfloat totalWeight = 0.0;");
+    fragmentGenerator.append("\tfor (int i = -4; i <= 4; ++i) {");
+    fragmentGenerator.append("\t\tvec2 sampleCoords = uv_coords + float(i) * blur_direction;");
+    fragmentGenerator.append("\t\tfloat sampleDepth = linearDepth(texture2D(low_depth_sampler, sampleCoords).x);");
+    fragmentGenerator.append("\t\tfloat weight = exp(-float(i * i) / 8.0);");
+    fragmentGenerator.append("\t\tweight *= max(0.0, 1.0 - 20.0 * abs(sampleDepth - centerDepth) / centerDepth);");
+    fragmentGenerator.append("\t\tao += weight * texture2D(ao_sampler, sampleCoords).x;");
+    fragmentGenerator.append("\t\ttotalWeight += weight;");
+    fragmentGenerator.append("\t}");
+    fragmentGenerator.append("\tao /= totalWeight;");
+    fragmentGenerator.append("\tgl_FragColor = vec4(ao, ao, ao, 1.0);");
+    fragmentGenerator.append("}");
+    m_layerAoBlurShader = compileLayerAoFilterProgram(getProgramGenerator(), "layer AO bilateral blur shader");
+    return m_layerAoBlurShader;
+}
+
+QSSGRef<QSSGLayerAoFilterShader> QSSGRendererImpl::getLayerAoUpsampleShader()
+{
+    if (m_layerAoUpsampleShader)
+        return m_layerAoUpsampleShader;
+
+    beginLayerAoFilterProgram(getProgramGenerator());
+    QSSGShaderStageGeneratorInterface &fragmentGenerator(*getProgramGenerator()->getStage(QSSGShaderGeneratorStage::Fragment));
+    fragmentGenerator.addUniform("depth_sampler", "sampler2D");
+    fragmentGenerator.addUniform("low_depth_sampler", "sampler2D");
+    fragmentGenerator.addUniform("ao_sampler", "sampler2D");
+    fragmentGenerator.addUniform("pixel_size", "vec2");
+    // Bilinear interpolation of the four low resolution pixels around, with each
+    // weighted down by how far the closer of its two depths is from the depth of
+    // the pixel. This picks the AO of the same surface along the depth edges
+    // instead of blurring across them.
+    fragmentGenerator.append("void main() {");
+    fragmentGenerator.append("\tfloat depth = linearDepth(texelFetch(depth_sampler, ivec2(gl_FragCoord.xy), 0).x);");
+    fragmentGenerator.append("\tvec2 lowCoords = uv_coords / pixel_size - vec2(0.5);");
+    fragmentGenerator.append("\tvec2 baseCoords = floor(lowCoords);");
+    fragmentGenerator.append("\tvec2 fraction = lowCoords - baseCoords;");
+    fragmentGenerator.append("\tfloat ao = 0.0;");
+    fragmentGenerator.append("\tfloat totalWeight = 0.0;");
+    fragmentGenerator.append("\tfor (int y = 0; y <= 1; ++y) {");
+    fragmentGenerator.append("\t\tfor (int x = 0; x <= 1; ++x) {");
+    fragmentGenerator.append("\t\t\tvec2 offset = vec2(float(x), float(y));");
+    fragmentGenerator.append("\t\t\tvec2 sampleCoords = (baseCoords + offset + vec2(0.5)) * pixel_size;");
+    fragmentGenerator.append("\t\t\tvec2 bilinear = mix(vec2(1.0) - fraction, fraction, offset);");
+    fragmentGenerator.append("\t\t\tvec2 sampleDepths = texture2D(low_depth_sampler, sampleCoords).xy;");
+    fragmentGenerator.append("\t\t\tfloat difference = min(abs(linearDepth(sampleDepths.x) - depth), abs(linearDepth(sampleDepths.y) - depth));");
+    fragmentGenerator.append("\t\t\tfloat weight = bilinear.x * bilinear.y / (0.001 + difference / depth);");
+    fragmentGenerator.append("\t\t\tao += weight * texture2D(ao_sampler, sampleCoords).x;");
+    fragmentGenerator.append("\t\t\ttotalWeight += weight;");
+    fragmentGenerator.append("\t\t}");
+    fragmentGenerator.append("\t}");
+    fragmentGenerator.append("\tao /= max(totalWeight, 0.0001);");
+    fragmentGenerator.append("\tgl_FragColor = vec4(ao, ao, ao, 1.0);");
+    fragmentGenerator.append("}");
+    m_layerAoUpsampleShader = compileLayerAoFilterProgram(getProgramGenerator(), "layer AO upsample shader");
+    return m_layerAoUpsampleShader;
+}
+
 QSSGRef<QSSGShadowmapPreblurShader> QSSGRendererImpl::getCubeShadowBlurXShader()
 {
     if (m_cubeShadowBlurXShader)
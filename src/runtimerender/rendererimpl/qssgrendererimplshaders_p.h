@@ -239,6 +239,37 @@ struct QSSGDefaultAoPassShader
     ~QSSGDefaultAoPassShader() {}
 };
 
+// Shared by the passes of the reduced resolution AO: depth downsampling, the AO
+// itself, the bilateral blur and the upsampling to the layer resolution.
+struct QSSGLayerAoFilterShader
+{
+    QAtomicInt ref;
+    QSSGRef<QSSGRenderShaderProgram> shader;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> depthSampler;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> lowDepthSampler;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> aoSampler;
+    QSSGRenderCachedShaderProperty<QVector2D> cameraProperties;
+    QSSGRenderCachedShaderProperty<QVector3D> cameraDirection;
+    QSSGRenderCachedShaderProperty<QVector2D> pixelSize;
+    QSSGRenderCachedShaderProperty<QVector2D> blurDirection;
+    QSSGRenderCachedShaderProperty<float> downsampleFactor;
+    QSSGRenderCachedShaderBuffer<QSSGRenderShaderConstantBuffer> aoShadowParams;
+
+    QSSGLayerAoFilterShader(const QSSGRef<QSSGRenderShaderProgram> &inShader)
+        : shader(inShader)
+        , depthSampler("depth_sampler", inShader)
+        , lowDepthSampler("low_depth_sampler", inShader)
+        , aoSampler("ao_sampler", inShader)
+        , cameraProperties("camera_properties", inShader)
+        , cameraDirection("camera_direction", inShader)
+        , pixelSize("pixel_size", inShader)
+        , blurDirection("blur_direction", inShader)
+        , downsampleFactor("downsample_factor", inShader)
+        , aoShadowParams("cbAoShadow", inShader)
+    {
+    }
+};
+
 struct QSSGLayerProgAABlendShader
 {
     QAtomicInt ref;
@@ -252,6 +283,58 @@ struct QSSGLayerProgAABlendShader
     }
 };
 
+// Shared by the passes of the post-process antialiasing filters. Each pass
+// reads the layer color and, for the later SMAA passes, the output of the
+// previous pass.
+struct QSSGLayerPostAAShader
+{
+    QAtomicInt ref;
+    QSSGRef<QSSGRenderShaderProgram> shader;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> colorSampler;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> passSampler;
+    QSSGRenderCachedShaderProperty<QVector2D> pixelSize;
+    QSSGLayerPostAAShader(const QSSGRef<QSSGRenderShaderProgram> &inShader)
+        : shader(inShader), colorSampler("color_sampler", inShader), passSampler("pass_sampler", inShader), pixelSize("pixel_size", inShader)
+    {
+    }
+};
+
+struct QSSGLayerVelocityShader
+{
+    QAtomicInt ref;
+    QSSGRef<QSSGRenderShaderProgram> shader;
+    QSSGRenderCachedShaderProperty<QMatrix4x4> mvp;
+    QSSGRenderCachedShaderProperty<QMatrix4x4> currentMvp;
+    QSSGRenderCachedShaderProperty<QMatrix4x4> previousMvp;
+    QSSGLayerVelocityShader(const QSSGRef<QSSGRenderShaderProgram> &inShader)
+        : shader(inShader)
+        , mvp("model_view_projection", inShader)
+        , currentMvp("current_model_view_projection", inShader)
+        , previousMvp("previous_model_view_projection", inShader)
+    {
+    }
+};
+
+struct QSSGLayerTemporalAAShader
+{
+    QAtomicInt ref;
+    QSSGRef<QSSGRenderShaderProgram> shader;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> currentSampler;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> historySampler;
+    QSSGRenderCachedShaderProperty<QSSGRenderTexture2D *> velocitySampler;
+    QSSGRenderCachedShaderProperty<QVector2D> pixelSize;
+    QSSGRenderCachedShaderProperty<float> historyWeight;
+    QSSGLayerTemporalAAShader(const QSSGRef<QSSGRenderShaderProgram> &inShader)
+        : shader(inShader)
+        , currentSampler("current_sampler", inShader)
+        , historySampler("history_sampler", inShader)
+        , velocitySampler("velocity_sampler", inShader)
+        , pixelSize("pixel_size", inShader)
+        , historyWeight("history_weight", inShader)
+    {
+    }
+};
+
 struct QSSGLayerSceneShader
 {
     QAtomicInt ref;
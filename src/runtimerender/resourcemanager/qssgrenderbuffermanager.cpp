@@ -403,6 +403,7 @@ QSSGRenderMesh *QSSGBufferManager::loadMesh(const QSSGRenderMeshPath &inMeshPath
     if (inMeshPath.isNull())
         return nullptr;
 
+    QSSGStackPerfTimer __perfTimer(perfTimer, Q_FUNC_INFO);
 
     MeshMap::iterator meshItr = meshMap.find(inMeshPath);
 
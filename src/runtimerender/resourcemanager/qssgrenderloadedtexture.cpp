@@ -39,7 +39,7 @@
 
 QT_BEGIN_NAMESPACE
 
-QSSGRef<QSSGLoadedTexture> QSSGLoadedTexture::loadQImage(const QString &inPath,
+QSSGRef<QSSGLoadedTexture> QSSGLoadedTexture::loadQImage(QSharedPointer<QIODevice> source,
                                                                const QSSGRenderTextureFormat &inFormat,
                                                                qint32 flipVertical,
                                                                QSSGRenderContextType renderContextType)
@@ -47,7 +47,9 @@ QSSGRef<QSSGLoadedTexture> QSSGLoadedTexture::loadQImage(const QString &inPath,
     Q_UNUSED(flipVertical)
     Q_UNUSED(renderContextType)
     QSSGRef<QSSGLoadedTexture> retval(nullptr);
-    QImage image(inPath);
+    // Read from the stream, it may come from an asset archive rather than a file
+    QImage image;
+    image.load(source.data(), nullptr);
     if (inFormat == QSSGRenderTextureFormat::Unknown) {
         // Convert palleted images
         if (image.format() == QImage::Format_Indexed8)
@@ -378,14 +380,12 @@ QSSGRef<QSSGLoadedTexture> QSSGLoadedTexture::load(const QString &inPath,
 
     QSSGRef<QSSGLoadedTexture> theLoadedImage = nullptr;
     QSharedPointer<QIODevice> theStream(inFactory.getStreamForFile(inPath));
-    QString fileName;
-    inFactory.getPathForFile(inPath, fileName);
     if (theStream && inPath.size() > 3) {
         if (inPath.endsWith(QStringLiteral("png"), Qt::CaseInsensitive) || inPath.endsWith(QStringLiteral("jpg"), Qt::CaseInsensitive)
             || inPath.endsWith(QStringLiteral("peg"), Qt::CaseInsensitive)
             || inPath.endsWith(QStringLiteral("ktx"), Qt::CaseInsensitive) || inPath.endsWith(QStringLiteral("gif"), Qt::CaseInsensitive)
             || inPath.endsWith(QStringLiteral("bmp"), Qt::CaseInsensitive)) {
-            theLoadedImage = loadQImage(fileName, inFormat, inFlipY, renderContextType);
+            theLoadedImage = loadQImage(theStream, inFormat, inFlipY, renderContextType);
             //        } else if (inPath.endsWith("dds", Qt::CaseInsensitive)) {
             //            theLoadedImage = LoadDDS(theStream, inFlipY, renderContextType);
         } else if (inPath.endsWith(QStringLiteral("hdr"), Qt::CaseInsensitive)) {
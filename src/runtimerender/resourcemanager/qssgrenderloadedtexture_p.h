@@ -115,7 +115,7 @@ public:
                                                QSSGInputStreamFactory &inFactory,
                                                bool inFlipY = true,
                                                const QSSGRenderContextType &renderContextType = QSSGRenderContextType::NullContext);
-    static QSSGRef<QSSGLoadedTexture> loadQImage(const QString &inPath,
+    static QSSGRef<QSSGLoadedTexture> loadQImage(QSharedPointer<QIODevice> source,
                                                      const QSSGRenderTextureFormat &inFormat,
                                                      qint32 flipVertical,
                                                      QSSGRenderContextType renderContextType);
@@ -37,32 +37,129 @@
 #include <QtQuick3DRender/private/qssgrendertexture2darray_p.h>
 #include <QtQuick3DRender/private/qssgrendertexturecube_p.h>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
-template <typename T>
-static void replaceWithLast(QVector<T> &vector, int index)
+namespace {
+
+template<typename T>
+QSSGRef<T> takeFree(QSSGResourceManager::Pool<T> &pool, const QSSGResourceKey &key, qint64 &freeSize)
+{
+    auto it = pool.find(key);
+    if (it == pool.end() || it->isEmpty())
+        return nullptr;
+    // The most recently released one, entries are kept in release order
+    const QSSGResourceManager::FreeEntry<T> entry = it->takeLast();
+    freeSize -= entry.size;
+    return entry.object;
+}
+
+template<typename T>
+void addFree(QSSGResourceManager::Pool<T> &pool, const QSSGResourceKey &key, const QSSGRef<T> &object, quint64 frame, qint64 size, qint64 &freeSize)
+{
+    QVector<QSSGResourceManager::FreeEntry<T>> &entries = pool[key];
+#ifdef _DEBUG
+    for (const auto &entry : entries)
+        Q_ASSERT(entry.object != object);
+#endif
+    entries.append({ object, frame, size });
+    freeSize += size;
+}
+
+template<typename T>
+void removeIdle(QSSGResourceManager::Pool<T> &pool, quint64 oldestFrame, qint64 &freeSize)
+{
+    for (auto it = pool.begin(); it != pool.end();) {
+        QVector<QSSGResourceManager::FreeEntry<T>> &entries = it.value();
+        int idle = 0;
+        while (idle < entries.size() && entries.at(idle).releaseFrame < oldestFrame)
+            freeSize -= entries.at(idle++).size;
+        if (idle == entries.size()) {
+            it = pool.erase(it);
+        } else {
+            entries.remove(0, idle);
+            ++it;
+        }
+    }
+}
+
+template<typename T>
+void clearPool(QSSGResourceManager::Pool<T> &pool, qint64 &freeSize)
+{
+    removeIdle(pool, std::numeric_limits<quint64>::max(), freeSize);
+}
+
+// Finds the entry that was released first
+template<typename T>
+bool findOldest(const QSSGResourceManager::Pool<T> &pool, quint64 &oldestFrame, QSSGResourceKey &oldestKey)
 {
-    vector[index] = vector.back();
-    vector.pop_back();
+    bool found = false;
+    for (auto it = pool.cbegin(), end = pool.cend(); it != end; ++it) {
+        if (!it->isEmpty() && it->first().releaseFrame < oldestFrame) {
+            oldestFrame = it->first().releaseFrame;
+            oldestKey = it.key();
+            found = true;
+        }
+    }
+    return found;
 }
 
+template<typename T>
+void removeOldest(QSSGResourceManager::Pool<T> &pool, const QSSGResourceKey &key, qint64 &freeSize)
+{
+    auto it = pool.find(key);
+    freeSize -= it->first().size;
+    it->removeFirst();
+    if (it->isEmpty())
+        pool.erase(it);
+}
+
+qint64 renderBufferSize(QSSGRenderRenderBufferFormat format, qint32 width, qint32 height)
+{
+    qint64 bytesPerPixel = 4;
+    switch (format) {
+    case QSSGRenderRenderBufferFormat::RGBA4:
+    case QSSGRenderRenderBufferFormat::RGB565:
+    case QSSGRenderRenderBufferFormat::RGBA5551:
+    case QSSGRenderRenderBufferFormat::Depth16:
+        bytesPerPixel = 2;
+        break;
+    case QSSGRenderRenderBufferFormat::StencilIndex8:
+        bytesPerPixel = 1;
+        break;
+    default:
+        break;
+    }
+    return bytesPerPixel * width * height;
+}
+
+qint64 textureSize(const QSSGTextureDetails &details, qint32 sampleCount, qint32 faces = 1)
+{
+    return qint64(details.format.getSizeofFormat()) * details.width * details.height * qMax(1, details.depth)
+            * qMax(1, sampleCount) * faces;
+}
+
+}
 
 QSSGResourceManager::QSSGResourceManager(const QSSGRef<QSSGRenderContext> &ctx)
     : renderContext(ctx)
+    , m_maxIdleFrames(120)
+    , m_memoryBudget(qint64(256) * 1024 * 1024)
 {
+    if (qEnvironmentVariableIsSet("QUICK3D_RESOURCE_POOL_IDLE_FRAMES"))
+        m_maxIdleFrames = quint32(qMax(0, qEnvironmentVariableIntValue("QUICK3D_RESOURCE_POOL_IDLE_FRAMES")));
+    if (qEnvironmentVariableIsSet("QUICK3D_RESOURCE_POOL_BUDGET"))
+        m_memoryBudget = qint64(qMax(0, qEnvironmentVariableIntValue("QUICK3D_RESOURCE_POOL_BUDGET"))) * 1024 * 1024;
 }
 
 QSSGResourceManager::~QSSGResourceManager() = default;
 
 QSSGRef<QSSGRenderFrameBuffer> QSSGResourceManager::allocateFrameBuffer()
 {
-    if (freeFrameBuffers.empty() == true) {
-        auto newBuffer = new QSSGRenderFrameBuffer(renderContext);
-        freeFrameBuffers.push_back(newBuffer);
-    }
-    auto retval = freeFrameBuffers.back();
-    freeFrameBuffers.pop_back();
-    return retval;
+    if (freeFrameBuffers.empty() == true)
+        return new QSSGRenderFrameBuffer(renderContext);
+    return freeFrameBuffers.takeLast().object;
 }
 
 void QSSGResourceManager::release(QSSGRef<QSSGRenderFrameBuffer> inBuffer)
@@ -83,36 +180,18 @@ void QSSGResourceManager::release(QSSGRef<QSSGRenderFrameBuffer> inBuffer)
             inBuffer->attach(QSSGRenderFrameBufferAttachment::DepthStencil, QSSGRenderTextureOrRenderBuffer());
     }
 #ifdef _DEBUG
-    auto theFind = std::find(freeFrameBuffers.begin(), freeFrameBuffers.end(), inBuffer);
-    Q_ASSERT(theFind == freeFrameBuffers.end());
+    for (const auto &entry : qAsConst(freeFrameBuffers))
+        Q_ASSERT(entry.object != inBuffer);
 #endif
-    freeFrameBuffers.push_back(inBuffer);
+    freeFrameBuffers.append({ inBuffer, m_frame, 0 });
 }
 
 QSSGRef<QSSGRenderRenderBuffer> QSSGResourceManager::allocateRenderBuffer(qint32 inWidth, qint32 inHeight, QSSGRenderRenderBufferFormat inBufferFormat)
 {
     Q_ASSERT(inWidth >= 0 && inHeight >= 0);
-    // Look for one of this specific size and format.
-    int existingMatchIdx = freeRenderBuffers.size();
-    for (int idx = 0, end = existingMatchIdx; idx < end; ++idx) {
-        auto theBuffer = freeRenderBuffers[idx];
-        QSize theDims = theBuffer->size();
-        QSSGRenderRenderBufferFormat theFormat = theBuffer->storageFormat();
-        if (theDims.width() == inWidth && theDims.height() == inHeight && theFormat == inBufferFormat) {
-            // Replace idx with last for efficient erasure (that reorders the vector).
-            replaceWithLast(freeRenderBuffers, idx);
-            return theBuffer;
-        } else if (theFormat == inBufferFormat)
-            existingMatchIdx = idx;
-    }
-    // If a specific exact match couldn't be found, just use the buffer with
-    // the same format and resize it.
-    if (existingMatchIdx < freeRenderBuffers.size()) {
-        auto theBuffer = freeRenderBuffers[existingMatchIdx];
-        replaceWithLast(freeRenderBuffers, existingMatchIdx);
-        theBuffer->setSize(QSize(inWidth, inHeight));
+    const QSSGResourceKey key { QSSGResourceKey::Type::RenderBuffer, qint32(inBufferFormat), inWidth, inHeight, 0, 1 };
+    if (auto theBuffer = takeFree(freeRenderBuffers, key, m_freeSize))
         return theBuffer;
-    }
 
     auto theBuffer = new QSSGRenderRenderBuffer(renderContext, inBufferFormat, inWidth, inHeight);
     return theBuffer;
@@ -120,7 +199,10 @@ QSSGRef<QSSGRenderRenderBuffer> QSSGResourceManager::allocateRenderBuffer(qint32
 
 void QSSGResourceManager::release(QSSGRef<QSSGRenderRenderBuffer> inBuffer)
 {
-    freeRenderBuffers.push_back(inBuffer);
+    const QSize theDims = inBuffer->size();
+    const QSSGRenderRenderBufferFormat theFormat = inBuffer->storageFormat();
+    const QSSGResourceKey key { QSSGResourceKey::Type::RenderBuffer, qint32(theFormat), theDims.width(), theDims.height(), 0, 1 };
+    addFree(freeRenderBuffers, key, inBuffer, m_frame, renderBufferSize(theFormat, theDims.width(), theDims.height()), m_freeSize);
 }
 
 QSSGRef<QSSGRenderTexture2D> QSSGResourceManager::setupAllocatedTexture(QSSGRef<QSSGRenderTexture2D> inTexture)
@@ -134,30 +216,10 @@ QSSGRef<QSSGRenderTexture2D> QSSGResourceManager::allocateTexture2D(qint32 inWid
 {
     Q_ASSERT(inWidth >= 0 && inHeight >= 0 && inSampleCount >= 0);
     bool inMultisample = inSampleCount > 1 && renderContext->supportsMultisampleTextures();
-    for (qint32 idx = 0, end = freeTextures.size(); idx < end; ++idx) {
-        auto theTexture = freeTextures[idx];
-        QSSGTextureDetails theDetails = theTexture->textureDetails();
-        if (theDetails.width == inWidth && theDetails.height == inHeight && inTextureFormat == theDetails.format
-                && theTexture->sampleCount() == inSampleCount) {
-            replaceWithLast(freeTextures, idx);
-            return setupAllocatedTexture(theTexture);
-        }
-    }
-    // else resize an existing texture.  This is very expensive
-    // note that MSAA textures are not resizable ( in GLES )
-    /*
-        if ( !freeTextures.empty() && !inMultisample )
-        {
-                QSSGRenderTexture2D* theTexture = freeTextures.back();
-                freeTextures.pop_back();
-
-                // note we could re-use a former MSAA texture
-                // this causes a entiere destroy of the previous texture object
-                theTexture->SetTextureData( QSSGByteView(), 0, inWidth, inHeight, inTextureFormat
-        );
-
-                return SetupAllocatedTexture( *theTexture );
-        }*/
+    const QSSGResourceKey key { QSSGResourceKey::Type::Texture2D, qint32(inTextureFormat.format), inWidth, inHeight, 0, inSampleCount };
+    if (auto theTexture = takeFree(freeTextures, key, m_freeSize))
+        return setupAllocatedTexture(theTexture);
+
     // else create a new texture.
     auto theTexture = new QSSGRenderTexture2D(renderContext);
 
@@ -173,52 +235,30 @@ QSSGRef<QSSGRenderTexture2D> QSSGResourceManager::allocateTexture2D(qint32 inWid
 
 void QSSGResourceManager::release(QSSGRef<QSSGRenderTexture2D> inBuffer)
 {
-#ifdef _DEBUG
-    auto theFind = std::find(freeTextures.begin(), freeTextures.end(), inBuffer);
-    Q_ASSERT(theFind == freeTextures.end());
-#endif
-    freeTextures.push_back(inBuffer);
+    const QSSGTextureDetails theDetails = inBuffer->textureDetails();
+    const qint32 theSampleCount = inBuffer->sampleCount();
+    const QSSGResourceKey key { QSSGResourceKey::Type::Texture2D, qint32(theDetails.format.format), theDetails.width,
+                                theDetails.height, 0, theSampleCount };
+    addFree(freeTextures, key, inBuffer, m_frame, textureSize(theDetails, theSampleCount), m_freeSize);
 }
 
 QSSGRef<QSSGRenderTexture2DArray> QSSGResourceManager::allocateTexture2DArray(qint32 inWidth, qint32 inHeight, qint32 inSlices, QSSGRenderTextureFormat inTextureFormat, qint32 inSampleCount)
 {
     Q_ASSERT(inWidth >= 0 && inHeight >= 0 && inSlices >= 0 && inSampleCount >= 0);
     bool inMultisample = inSampleCount > 1 && renderContext->supportsMultisampleTextures();
-    for (int idx = 0, end = freeTexArrays.size(); idx < end; ++idx) {
-        auto theTexture = freeTexArrays[idx];
-        QSSGTextureDetails theDetails = theTexture->textureDetails();
-        if (theDetails.width == inWidth && theDetails.height == inHeight && theDetails.depth == inSlices
-                && inTextureFormat == theDetails.format && theTexture->sampleCount() == inSampleCount) {
-            replaceWithLast(freeTexArrays, idx);
-            theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
-            theTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
-            return theTexture;
-        }
-    }
-
-    // else resize an existing texture.  This should be fairly quick at the driver level.
-    // note that MSAA textures are not resizable ( in GLES )
-    if (!freeTexArrays.empty() && !inMultisample) {
-        auto theTexture = freeTexArrays.back();
-        freeTexArrays.pop_back();
-
-        // note we could re-use a former MSAA texture
-        // this causes a entiere destroy of the previous texture object
-        theTexture->setTextureData(QSSGByteView(), 0, inWidth, inHeight, inSlices, inTextureFormat);
-        theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
-        theTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
-        return theTexture;
-    }
+    const QSSGResourceKey key { QSSGResourceKey::Type::Texture2DArray, qint32(inTextureFormat.format), inWidth, inHeight,
+                                inSlices, inSampleCount };
+    QSSGRef<QSSGRenderTexture2DArray> theTexture = takeFree(freeTexArrays, key, m_freeSize);
 
     // else create a new texture.
-    QSSGRef<QSSGRenderTexture2DArray> theTexture = nullptr;
-
-    if (!inMultisample) {
-        theTexture = new QSSGRenderTexture2DArray(renderContext);
-        theTexture->setTextureData(QSSGByteView(), 0, inWidth, inHeight, inSlices, inTextureFormat);
-    } else {
-        // Not supported yet
-        return nullptr;
+    if (!theTexture) {
+        if (!inMultisample) {
+            theTexture = new QSSGRenderTexture2DArray(renderContext);
+            theTexture->setTextureData(QSSGByteView(), 0, inWidth, inHeight, inSlices, inTextureFormat);
+        } else {
+            // Not supported yet
+            return nullptr;
+        }
     }
 
     theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
@@ -228,62 +268,33 @@ QSSGRef<QSSGRenderTexture2DArray> QSSGResourceManager::allocateTexture2DArray(qi
 
 void QSSGResourceManager::release(QSSGRef<QSSGRenderTexture2DArray> inBuffer)
 {
-#ifdef _DEBUG
-    auto theFind = std::find(freeTexArrays.begin(), freeTexArrays.end(), inBuffer);
-    Q_ASSERT(theFind == freeTexArrays.end());
-#endif
-    freeTexArrays.push_back(inBuffer);
+    const QSSGTextureDetails theDetails = inBuffer->textureDetails();
+    const qint32 theSampleCount = inBuffer->sampleCount();
+    const QSSGResourceKey key { QSSGResourceKey::Type::Texture2DArray, qint32(theDetails.format.format), theDetails.width,
+                                theDetails.height, theDetails.depth, theSampleCount };
+    addFree(freeTexArrays, key, inBuffer, m_frame, textureSize(theDetails, theSampleCount), m_freeSize);
 }
 
 QSSGRef<QSSGRenderTextureCube> QSSGResourceManager::allocateTextureCube(qint32 inWidth, qint32 inHeight, QSSGRenderTextureFormat inTextureFormat, qint32 inSampleCount)
 {
     bool inMultisample = inSampleCount > 1 && renderContext->supportsMultisampleTextures();
-    for (int idx = 0, end = freeTexCubes.size(); idx < end; ++idx) {
-        auto theTexture = freeTexCubes[idx];
-        QSSGTextureDetails theDetails = theTexture->textureDetails();
-        if (theDetails.width == inWidth && theDetails.height == inHeight && inTextureFormat == theDetails.format
-                && theTexture->sampleCount() == inSampleCount) {
-            replaceWithLast(freeTexCubes, idx);
-
-            theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
-            theTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
-            return theTexture;
-        }
-    }
-
-    // else resize an existing texture.  This should be fairly quick at the driver level.
-    // note that MSAA textures are not resizable ( in GLES )
-    if (!freeTexCubes.empty() && !inMultisample) {
-        auto theTexture = freeTexCubes.back();
-        freeTexCubes.pop_back();
-
-        // note we could re-use a former MSAA texture
-        // this causes a entire destroy of the previous texture object
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosX, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegX, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosY, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegY, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosZ, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegZ, inWidth, inHeight, inTextureFormat);
-        theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
-        theTexture->setMagFilter(QSSGRenderTextureMagnifyingOp::Linear);
-        return theTexture;
-    }
+    const QSSGResourceKey key { QSSGResourceKey::Type::TextureCube, qint32(inTextureFormat.format), inWidth, inHeight, 0, inSampleCount };
+    QSSGRef<QSSGRenderTextureCube> theTexture = takeFree(freeTexCubes, key, m_freeSize);
 
     // else create a new texture.
-    QSSGRef<QSSGRenderTextureCube> theTexture = nullptr;
-
-    if (!inMultisample) {
-        theTexture = new QSSGRenderTextureCube(renderContext);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosX, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegX, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosY, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegY, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosZ, inWidth, inHeight, inTextureFormat);
-        theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegZ, inWidth, inHeight, inTextureFormat);
-    } else {
-        // Not supported yet
-        return nullptr;
+    if (!theTexture) {
+        if (!inMultisample) {
+            theTexture = new QSSGRenderTextureCube(renderContext);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosX, inWidth, inHeight, inTextureFormat);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegX, inWidth, inHeight, inTextureFormat);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosY, inWidth, inHeight, inTextureFormat);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegY, inWidth, inHeight, inTextureFormat);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubePosZ, inWidth, inHeight, inTextureFormat);
+            theTexture->setTextureData(QSSGByteView(), 0, QSSGRenderTextureCubeFace::CubeNegZ, inWidth, inHeight, inTextureFormat);
+        } else {
+            // Not supported yet
+            return nullptr;
+        }
     }
 
     theTexture->setMinFilter(QSSGRenderTextureMinifyingOp::Linear);
@@ -293,11 +304,11 @@ QSSGRef<QSSGRenderTextureCube> QSSGResourceManager::allocateTextureCube(qint32 i
 
 void QSSGResourceManager::release(QSSGRef<QSSGRenderTextureCube> inBuffer)
 {
-#ifdef _DEBUG
-    auto theFind = std::find(freeTexCubes.begin(), freeTexCubes.end(), inBuffer);
-    Q_ASSERT(theFind == freeTexCubes.end());
-#endif
-    freeTexCubes.push_back(inBuffer);
+    const QSSGTextureDetails theDetails = inBuffer->textureDetails();
+    const qint32 theSampleCount = inBuffer->sampleCount();
+    const QSSGResourceKey key { QSSGResourceKey::Type::TextureCube, qint32(theDetails.format.format), theDetails.width,
+                                theDetails.height, 0, theSampleCount };
+    addFree(freeTexCubes, key, inBuffer, m_frame, textureSize(theDetails, theSampleCount, 6), m_freeSize);
 }
 
 QSSGRef<QSSGRenderImage2D> QSSGResourceManager::allocateImage2D(QSSGRef<QSSGRenderTexture2D> inTexture, QSSGRenderImageAccessType inAccess)
@@ -328,21 +339,62 @@ QSSGRef<QSSGRenderContext> QSSGResourceManager::getRenderContext() { return rend
 
 void QSSGResourceManager::destroyFreeSizedResources()
 {
-    for (int idx = freeRenderBuffers.size() - 1; idx >= 0; --idx) {
-        auto obj = freeRenderBuffers[idx];
-        replaceWithLast(freeRenderBuffers, idx);
-    }
-    for (int idx = freeTextures.size() - 1; idx >= 0; --idx) {
-        auto obj = freeTextures[idx];
-        replaceWithLast(freeTextures, idx);
-    }
-    for (int idx = freeTexArrays.size() - 1; idx >= 0; --idx) {
-        auto obj = freeTexArrays[idx];
-        replaceWithLast(freeTexArrays, idx);
+    clearPool(freeRenderBuffers, m_freeSize);
+    clearPool(freeTextures, m_freeSize);
+    clearPool(freeTexArrays, m_freeSize);
+    clearPool(freeTexCubes, m_freeSize);
+}
+
+void QSSGResourceManager::beginFrame()
+{
+    ++m_frame;
+    if (m_frame > m_maxIdleFrames) {
+        const quint64 oldestFrame = m_frame - m_maxIdleFrames;
+        int idle = 0;
+        while (idle < freeFrameBuffers.size() && freeFrameBuffers.at(idle).releaseFrame < oldestFrame)
+            ++idle;
+        freeFrameBuffers.remove(0, idle);
+        removeIdle(freeRenderBuffers, oldestFrame, m_freeSize);
+        removeIdle(freeTextures, oldestFrame, m_freeSize);
+        removeIdle(freeTexArrays, oldestFrame, m_freeSize);
+        removeIdle(freeTexCubes, oldestFrame, m_freeSize);
     }
-    for (int idx = freeTexCubes.size() - 1; idx >= 0; --idx) {
-        auto obj = freeTexCubes[idx];
-        replaceWithLast(freeTexCubes, idx);
+    enforceMemoryBudget();
+}
+
+void QSSGResourceManager::enforceMemoryBudget()
+{
+    // Destroy the least recently released resources until the rest fits
+    while (m_freeSize > m_memoryBudget) {
+        enum { None, RenderBuffers, Textures, TexArrays, TexCubes } pool = None;
+        quint64 oldestFrame = std::numeric_limits<quint64>::max();
+        QSSGResourceKey key {};
+        if (findOldest(freeRenderBuffers, oldestFrame, key))
+            pool = RenderBuffers;
+        if (findOldest(freeTextures, oldestFrame, key))
+            pool = Textures;
+        if (findOldest(freeTexArrays, oldestFrame, key))
+            pool = TexArrays;
+        if (findOldest(freeTexCubes, oldestFrame, key))
+            pool = TexCubes;
+
+        switch (pool) {
+        case RenderBuffers:
+            removeOldest(freeRenderBuffers, key, m_freeSize);
+            break;
+        case Textures:
+            removeOldest(freeTextures, key, m_freeSize);
+            break;
+        case TexArrays:
+            removeOldest(freeTexArrays, key, m_freeSize);
+            break;
+        case TexCubes:
+            removeOldest(freeTexCubes, key, m_freeSize);
+            break;
+        case None:
+            m_freeSize = 0;
+            return;
+        }
     }
 }
 
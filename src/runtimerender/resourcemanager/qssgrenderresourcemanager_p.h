@@ -46,30 +46,86 @@
 #include <QtQuick3DRender/private/qssgrenderrenderbuffer_p.h>
 #include <QtQuick3DRender/private/qssgrendercontext_p.h>
 
+#include <QtCore/QHash>
+
 #include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
 
 QT_BEGIN_NAMESPACE
+
+// Describes a pooled resource, resources are only handed out for an exact match
+struct QSSGResourceKey
+{
+    enum class Type : quint8
+    {
+        RenderBuffer,
+        Texture2D,
+        Texture2DArray,
+        TextureCube
+    };
+
+    Type type;
+    qint32 format;
+    qint32 width;
+    qint32 height;
+    qint32 depth;
+    qint32 sampleCount;
+
+    bool operator==(const QSSGResourceKey &other) const
+    {
+        return type == other.type && format == other.format && width == other.width && height == other.height
+                && depth == other.depth && sampleCount == other.sampleCount;
+    }
+};
+
+inline uint qHash(const QSSGResourceKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    return qHash(quint64(key.width) << 32 | quint64(key.height), seed)
+            ^ qHash(quint32(key.type) << 24 ^ quint32(key.format) << 8 ^ quint32(key.sampleCount), seed)
+            ^ qHash(key.depth, seed);
+}
+
 /**
  *	Implements simple pooling of render resources
+ *
+ *	Released resources are kept in pools keyed by their description. Resources
+ *	that have not been used for a number of frames, or the least recently used
+ *	ones when the pools grow over the memory budget, are destroyed in beginFrame().
  */
 class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGResourceManager
 {
     Q_DISABLE_COPY(QSSGResourceManager)
 public:
     QAtomicInt ref;
+
+    template<typename T>
+    struct FreeEntry
+    {
+        QSSGRef<T> object;
+        quint64 releaseFrame;
+        qint64 size; // estimated, in bytes
+    };
+    template<typename T>
+    using Pool = QHash<QSSGResourceKey, QVector<FreeEntry<T>>>;
+
 private:
     QSSGRef<QSSGRenderContext> renderContext;
     // Complete list of all allocated objects
     //    QVector<QSSGRef<QSSGRefCounted>> m_allocatedObjects;
 
-    QVector<QSSGRef<QSSGRenderFrameBuffer>> freeFrameBuffers;
-    QVector<QSSGRef<QSSGRenderRenderBuffer>> freeRenderBuffers;
-    QVector<QSSGRef<QSSGRenderTexture2D>> freeTextures;
-    QVector<QSSGRef<QSSGRenderTexture2DArray>> freeTexArrays;
-    QVector<QSSGRef<QSSGRenderTextureCube>> freeTexCubes;
+    QVector<FreeEntry<QSSGRenderFrameBuffer>> freeFrameBuffers;
+    Pool<QSSGRenderRenderBuffer> freeRenderBuffers;
+    Pool<QSSGRenderTexture2D> freeTextures;
+    Pool<QSSGRenderTexture2DArray> freeTexArrays;
+    Pool<QSSGRenderTextureCube> freeTexCubes;
     QVector<QSSGRef<QSSGRenderImage2D>> freeImages;
 
+    quint64 m_frame = 0;
+    quint32 m_maxIdleFrames;
+    qint64 m_memoryBudget;
+    qint64 m_freeSize = 0;
+
     QSSGRef<QSSGRenderTexture2D> setupAllocatedTexture(QSSGRef<QSSGRenderTexture2D> inTexture);
+    void enforceMemoryBudget();
 
 public:
     QSSGResourceManager(const QSSGRef<QSSGRenderContext> &ctx);
@@ -104,6 +160,17 @@ public:
 
     QSSGRef<QSSGRenderContext> getRenderContext();
     void destroyFreeSizedResources();
+
+    // Ages the free resources and destroys the ones that are no longer worth keeping
+    void beginFrame();
+
+    // Free resources unused for more frames than this are destroyed (QUICK3D_RESOURCE_POOL_IDLE_FRAMES)
+    void setMaxIdleFrames(quint32 frames) { m_maxIdleFrames = frames; }
+    quint32 maxIdleFrames() const { return m_maxIdleFrames; }
+    // Upper limit for the free resources in bytes (QUICK3D_RESOURCE_POOL_BUDGET, in megabytes)
+    void setMemoryBudget(qint64 bytes) { m_memoryBudget = bytes; }
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    qint64 freeResourceSize() const { return m_freeSize; }
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qssgrendersharedresources_p.h"
+
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderinputstreamfactory_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// Not owning, entries remove themselves when destroyed
+QBasicMutex g_sharedResourcesMutex;
+Q_GLOBAL_STATIC(QVector<QSSGRenderSharedResources *>, g_sharedResources)
+
+// Takes a reference unless the resources are already being destroyed
+QSSGRef<QSSGRenderSharedResources> tryRef(QSSGRenderSharedResources *resources)
+{
+    int count = resources->ref.load();
+    while (count > 0 && !resources->ref.testAndSetOrdered(count, count + 1))
+        count = resources->ref.load();
+    if (count == 0)
+        return nullptr;
+
+    QSSGRef<QSSGRenderSharedResources> retval(resources);
+    resources->ref.deref();
+    return retval;
+}
+}
+
+QSSGRenderSharedResources::QSSGRenderSharedResources(const QSSGRef<QSSGRenderContext> &ctx, QOpenGLContextGroup *shareGroup, const QSurfaceFormat &format)
+    : m_shareGroup(shareGroup)
+    , m_format(format)
+    , m_renderContext(ctx)
+    , m_inputStreamFactory(new QSSGInputStreamFactory)
+    , m_bufferManager(new QSSGBufferManager(ctx, m_inputStreamFactory, &m_perfTimer))
+    , m_shaderCache(QSSGShaderCache::createShaderCache(ctx, m_inputStreamFactory, &m_perfTimer))
+{
+}
+
+QSSGRenderSharedResources::~QSSGRenderSharedResources()
+{
+    QMutexLocker locker(&g_sharedResourcesMutex);
+    g_sharedResources->removeOne(this);
+}
+
+// The render context picks its backend from these, everything else can differ per window
+bool QSSGRenderSharedResources::isCompatibleFormat(const QSurfaceFormat &a, const QSurfaceFormat &b)
+{
+    return a.renderableType() == b.renderableType()
+            && a.majorVersion() == b.majorVersion()
+            && a.minorVersion() == b.minorVersion()
+            && a.profile() == b.profile();
+}
+
+QSSGRef<QSSGRenderSharedResources> QSSGRenderSharedResources::getSharedResources(QOpenGLContext *inContext)
+{
+    Q_ASSERT(inContext);
+    QOpenGLContextGroup *shareGroup = inContext->shareGroup();
+    const QSurfaceFormat format = inContext->format();
+
+    QMutexLocker locker(&g_sharedResourcesMutex);
+    for (QSSGRenderSharedResources *resources : qAsConst(*g_sharedResources)) {
+        if (resources->m_shareGroup == shareGroup && isCompatibleFormat(resources->m_format, format)) {
+            QSSGRef<QSSGRenderSharedResources> retval = tryRef(resources);
+            if (retval)
+                return retval;
+        }
+    }
+
+    QSSGRef<QSSGRenderSharedResources> retval(new QSSGRenderSharedResources(QSSGRenderContext::createGl(format), shareGroup, format));
+    retval->m_lastContext = inContext;
+    g_sharedResources->append(retval.data());
+    return retval;
+}
+
+QSSGRef<QSSGRenderSharedResources> QSSGRenderSharedResources::getSharedResources(const QSSGRef<QSSGRenderContext> &ctx)
+{
+    QMutexLocker locker(&g_sharedResourcesMutex);
+    for (QSSGRenderSharedResources *resources : qAsConst(*g_sharedResources)) {
+        if (resources->m_renderContext == ctx) {
+            QSSGRef<QSSGRenderSharedResources> retval = tryRef(resources);
+            if (retval)
+                return retval;
+        }
+    }
+
+    // Contexts created by the caller are not shared with other share group members
+    QSSGRef<QSSGRenderSharedResources> retval(new QSSGRenderSharedResources(ctx, nullptr, QSurfaceFormat()));
+    retval->m_lastContext = QOpenGLContext::currentContext();
+    g_sharedResources->append(retval.data());
+    return retval;
+}
+
+void QSSGRenderSharedResources::beginFrame()
+{
+    QOpenGLContext *current = QOpenGLContext::currentContext();
+    if (current == m_lastContext)
+        return;
+
+    m_lastContext = current;
+    m_renderContext->resetStateCache();
+}
+
+void QSSGRenderSharedResources::addSearchDirectory(const QString &inDirectory)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_searchDirectories.contains(inDirectory))
+        return;
+
+    m_searchDirectories.append(inDirectory);
+    m_inputStreamFactory->addSearchDirectory(inDirectory);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSG_RENDER_SHARED_RESOURCES_H
+#define QSSG_RENDER_SHARED_RESOURCES_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+#include <QtQuick3DUtils/private/qssgperftimer_p.h>
+
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qsurfaceformat.h>
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSSGRenderContext;
+class QSSGInputStreamFactory;
+class QSSGBufferManager;
+class QSSGShaderCache;
+
+/**
+ *	Resources shared by every render context interface of one GL share group: the render
+ *	context itself, the buffer manager (meshes and textures) and the shader cache
+ *	(programs). Windows rendering in the same share group therefore upload each mesh and
+ *	texture and compile each program only once, while renderers, render lists, resource
+ *	pools and framebuffers stay per window.
+ *
+ *	The render context is created from the format of the first window of the share group.
+ *	Windows whose format asks for a different API, version or profile get a domain of
+ *	their own, so every member of a domain drives the same backend.
+ *
+ *	The domain lives as long as one interface references it. Windows that render on
+ *	different threads must hold lock() while they use it.
+ */
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderSharedResources
+{
+    Q_DISABLE_COPY(QSSGRenderSharedResources)
+public:
+    QAtomicInt ref;
+
+private:
+    QOpenGLContextGroup *m_shareGroup;
+    QSurfaceFormat m_format;
+    QMutex m_lock { QMutex::Recursive };
+    QSSGPerfTimer m_perfTimer;
+    const QSSGRef<QSSGRenderContext> m_renderContext;
+    const QSSGRef<QSSGInputStreamFactory> m_inputStreamFactory;
+    const QSSGRef<QSSGBufferManager> m_bufferManager;
+    const QSSGRef<QSSGShaderCache> m_shaderCache;
+    QPointer<QOpenGLContext> m_lastContext;
+    QStringList m_searchDirectories;
+
+    QSSGRenderSharedResources(const QSSGRef<QSSGRenderContext> &ctx, QOpenGLContextGroup *shareGroup, const QSurfaceFormat &format);
+
+    static bool isCompatibleFormat(const QSurfaceFormat &a, const QSurfaceFormat &b);
+
+public:
+    ~QSSGRenderSharedResources();
+
+    // Returns the resources of the share group of inContext whose format is compatible
+    // with the one of inContext, creating them on first use. The context must be current.
+    static QSSGRef<QSSGRenderSharedResources> getSharedResources(QOpenGLContext *inContext);
+    // Returns the resources already wrapping ctx or new resources used by nobody else.
+    static QSSGRef<QSSGRenderSharedResources> getSharedResources(const QSSGRef<QSSGRenderContext> &ctx);
+
+    QMutex *lock() { return &m_lock; }
+
+    // Called at the start of each frame with the lock held. Reapplies the cached render
+    // state when a different context of the share group rendered since the last frame.
+    void beginFrame();
+
+    // Adds inDirectory to the search paths of the input stream factory unless an interface
+    // of this domain already did.
+    void addSearchDirectory(const QString &inDirectory);
+
+    const QSSGRef<QSSGRenderContext> &renderContext() const { return m_renderContext; }
+    const QSSGRef<QSSGInputStreamFactory> &inputStreamFactory() const { return m_inputStreamFactory; }
+    const QSSGRef<QSSGBufferManager> &bufferManager() const { return m_bufferManager; }
+    const QSSGRef<QSSGShaderCache> &shaderCache() const { return m_shaderCache; }
+    QSSGPerfTimer *performanceTimer() { return &m_perfTimer; }
+};
+
+QT_END_NAMESPACE
+
+#endif
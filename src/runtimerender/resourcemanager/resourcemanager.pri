@@ -5,7 +5,8 @@ HEADERS += \
     $$PWD/qssgrenderprefiltertexture_p.h \
     $$PWD/qssgrenderresourcebufferobjects_p.h \
     $$PWD/qssgrenderresourcemanager_p.h \
-    $$PWD/qssgrenderresourcetexture2d_p.h
+    $$PWD/qssgrenderresourcetexture2d_p.h \
+    $$PWD/qssgrendersharedresources_p.h
 
 SOURCES += \
     $$PWD/qssgrenderbuffermanager.cpp \
@@ -14,4 +15,5 @@ SOURCES += \
     $$PWD/qssgrenderprefiltertexture.cpp \
     $$PWD/qssgrenderresourcebufferobjects.cpp \
     $$PWD/qssgrenderresourcemanager.cpp \
-    $$PWD/qssgrenderresourcetexture2d.cpp
+    $$PWD/qssgrenderresourcetexture2d.cpp \
+    $$PWD/qssgrendersharedresources.cpp
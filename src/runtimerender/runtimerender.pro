@@ -15,7 +15,10 @@ HEADERS += \
     qssgoffscreenrenderkey_p.h \
     qssgoffscreenrendermanager_p.h \
     qssgrenderableimage_p.h \
+    qssgrenderassetarchive_p.h \
+    qssgrenderasyncreadback_p.h \
     qssgrenderclippingfrustum_p.h \
+    qssgrenderclusteredlights_p.h \
     qssgrendercontextcore_p.h \
     qssgrendercustommaterialrendercontext_p.h \
     qssgrendercustommaterialsystem_p.h \
@@ -23,6 +26,7 @@ HEADERS += \
     qssgrenderdynamicobjectsystem_p.h \
     qssgrenderdynamicobjectsystemcommands_p.h \
     qssgrenderdynamicobjectsystemutil_p.h \
+    qssgrendereffectchaincompiler_p.h \
     qssgrendereffectsystem_p.h \
     qssgrenderer_p.h \
     qssgrendererutil_p.h \
@@ -33,6 +37,7 @@ HEADERS += \
     qssgrenderlightconstantproperties_p.h \
     qssgrendermaterialshadergenerator_p.h \
     qssgrendermesh_p.h \
+    qssgrendernodehierarchy_p.h \
     qssgrenderpathmanager_p.h \
     qssgrenderpathmath_p.h \
     qssgrenderpathrendercontext_p.h \
@@ -44,6 +49,7 @@ HEADERS += \
     qssgrendershadercodegenerator_p.h \
     qssgrendershadercodegeneratorv2_p.h \
     qssgrendershaderkeys_p.h \
+    qssgrendershaderlibrary_p.h \
     qssgrendershadowmap_p.h \
     qssgrendertessmodevalues_p.h \
     qssgrenderthreadpool_p.h \
@@ -53,18 +59,24 @@ HEADERS += \
 
 SOURCES += \
     qssgoffscreenrendermanager.cpp \
+    qssgperframeallocator.cpp \
+    qssgrenderassetarchive.cpp \
+    qssgrenderasyncreadback.cpp \
     qssgrenderclippingfrustum.cpp \
+    qssgrenderclusteredlights.cpp \
     qssgrendercontextcore.cpp \
     qssgrendercustommaterialshadergenerator.cpp \
     qssgrendercustommaterialsystem.cpp \
     qssgrenderdefaultmaterialshadergenerator.cpp \
     qssgrenderdynamicobjectsystem.cpp \
+    qssgrendereffectchaincompiler.cpp \
     qssgrendereffectsystem.cpp \
     qssgrendererutil.cpp \
     qssgrendereulerangles.cpp \
     qssgrendergpuprofiler.cpp \
     qssgrenderinputstreamfactory.cpp \
     qssgrendermaterialshadergenerator.cpp \
+    qssgrendernodehierarchy.cpp \
     qssgrenderpathmanager.cpp \
     qssgrenderpixelgraphicsrenderer.cpp \
     qssgrenderray.cpp \
@@ -72,6 +84,7 @@ SOURCES += \
     qssgrendershadercache.cpp \
     qssgrendershadercodegenerator.cpp \
     qssgrendershadercodegeneratorv2.cpp \
+    qssgrendershaderlibrary.cpp \
     qssgrendershadowmap.cpp \
     qssgrenderthreadpool.cpp \
     qssgrenderwidgets.cpp \
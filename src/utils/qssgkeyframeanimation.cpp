@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qssgkeyframeanimation_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QIODevice>
+#include <QtCore/private/qsimd_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+void QSSGKeyframeAnimationData::addChannel(quint32 target, Property property, Interpolation interpolation, const QVector<Key> &keys)
+{
+    Channel channel;
+    channel.target = target;
+    channel.property = property;
+    channel.interpolation = interpolation;
+    channel.firstKey = quint32(times.size());
+    channel.keyCount = quint32(keys.size());
+    channels.append(channel);
+
+    for (const Key &key : keys) {
+        times.append(key.time);
+        values.append(key.value);
+        inTangents.append(key.inTangent);
+        outTangents.append(key.outTangent);
+    }
+    if (!keys.isEmpty())
+        duration = qMax(duration, keys.last().time);
+    targetCount = qMax(targetCount, target + 1);
+}
+
+void QSSGKeyframeAnimationData::clear()
+{
+    channels.clear();
+    times.clear();
+    values.clear();
+    inTangents.clear();
+    outTangents.clear();
+    duration = 0.0f;
+    targetCount = 0;
+}
+
+void QSSGKeyframeAnimationData::save(QIODevice &outStream) const
+{
+    QDataStream out(&outStream);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    out << getFileTag();
+    out << getFileVersion();
+    out << duration;
+    out << targetCount;
+    out << quint32(channels.size());
+    out << quint32(times.size());
+    for (const Channel &channel : channels) {
+        out << channel.target;
+        out << quint8(channel.property);
+        out << quint8(channel.interpolation);
+        out << channel.firstKey;
+        out << channel.keyCount;
+    }
+    const int keyDataSize = times.size() * int(sizeof(float));
+    out.writeRawData(reinterpret_cast<const char *>(times.constData()), keyDataSize);
+    out.writeRawData(reinterpret_cast<const char *>(values.constData()), keyDataSize);
+    out.writeRawData(reinterpret_cast<const char *>(inTangents.constData()), keyDataSize);
+    out.writeRawData(reinterpret_cast<const char *>(outTangents.constData()), keyDataSize);
+}
+
+bool QSSGKeyframeAnimationData::load(QIODevice &inStream)
+{
+    clear();
+
+    QDataStream in(&inStream);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint64 fileTag;
+    quint32 version;
+    quint32 numChannels;
+    quint32 numKeys;
+    in >> fileTag;
+    in >> version;
+    if (fileTag != getFileTag()) {
+        qCritical("Invalid file, not a keyframe animation file");
+        return false;
+    }
+    if (version > getFileVersion()) {
+        qCritical("Version number out of range.");
+        return false;
+    }
+    in >> duration;
+    in >> targetCount;
+    in >> numChannels;
+    in >> numKeys;
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    channels.resize(int(numChannels));
+    for (Channel &channel : channels) {
+        quint8 property;
+        quint8 interpolation;
+        in >> channel.target;
+        in >> property;
+        in >> interpolation;
+        in >> channel.firstKey;
+        in >> channel.keyCount;
+        channel.property = Property(property);
+        channel.interpolation = Interpolation(interpolation);
+        if (in.status() != QDataStream::Ok || channel.target >= targetCount
+            || property >= quint8(Property::PropertyCount)
+            || interpolation > quint8(Interpolation::Hermite)
+            || quint64(channel.firstKey) + channel.keyCount > numKeys) {
+            qCritical("Invalid keyframe animation channel");
+            clear();
+            return false;
+        }
+    }
+
+    const int keyDataSize = int(numKeys * sizeof(float));
+    times.resize(int(numKeys));
+    values.resize(int(numKeys));
+    inTangents.resize(int(numKeys));
+    outTangents.resize(int(numKeys));
+    if (in.readRawData(reinterpret_cast<char *>(times.data()), keyDataSize) != keyDataSize
+        || in.readRawData(reinterpret_cast<char *>(values.data()), keyDataSize) != keyDataSize
+        || in.readRawData(reinterpret_cast<char *>(inTangents.data()), keyDataSize) != keyDataSize
+        || in.readRawData(reinterpret_cast<char *>(outTangents.data()), keyDataSize) != keyDataSize) {
+        qCritical("Truncated keyframe animation file");
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void QSSGKeyframeAnimationData::setLinearTangents(QVector<Key> &keys)
+{
+    for (int i = 0; i + 1 < keys.size(); ++i) {
+        const float length = keys.at(i + 1).time - keys.at(i).time;
+        const float slope = length > 0.0f ? (keys.at(i + 1).value - keys.at(i).value) / length : 0.0f;
+        keys[i].outTangent = slope;
+        keys[i + 1].inTangent = slope;
+    }
+}
+
+void QSSGKeyframeEvaluator::setAnimation(const QSSGKeyframeAnimationData *animation)
+{
+    m_animation = animation;
+    const int count = animation ? animation->channels.size() : 0;
+    m_cursors.fill(0, count);
+    m_start.resize(count);
+    m_invLength.resize(count);
+    m_from.resize(count);
+    m_to.resize(count);
+    m_outTangent.resize(count);
+    m_inTangent.resize(count);
+}
+
+void QSSGKeyframeEvaluator::evaluate(float time, float *outValues)
+{
+    if (!m_animation)
+        return;
+
+    const QSSGKeyframeAnimationData &animation = *m_animation;
+    const int count = animation.channels.size();
+    Q_ASSERT(m_cursors.size() == count);
+    const float *times = animation.times.constData();
+    const float *values = animation.values.constData();
+
+    // Find the segment of every channel. Going forward by a key or two is the common
+    // case, anything else falls back to a binary search.
+    for (int c = 0; c < count; ++c) {
+        const QSSGKeyframeAnimationData::Channel &channel = animation.channels.at(c);
+        if (!channel.keyCount) {
+            m_start[c] = time;
+            m_invLength[c] = 0.0f;
+            m_from[c] = m_to[c] = 0.0f;
+            m_outTangent[c] = m_inTangent[c] = 0.0f;
+            continue;
+        }
+
+        const float *keyTimes = times + channel.firstKey;
+        quint32 k = m_cursors.at(c);
+        if (k >= channel.keyCount || keyTimes[k] > time) {
+            k = quint32(std::upper_bound(keyTimes, keyTimes + channel.keyCount, time) - keyTimes);
+            k = k ? k - 1 : 0;
+        } else {
+            int steps = 0;
+            while (k + 1 < channel.keyCount && keyTimes[k + 1] <= time && ++steps < 4)
+                ++k;
+            if (steps == 4)
+                k = quint32(std::upper_bound(keyTimes + k, keyTimes + channel.keyCount, time) - keyTimes) - 1;
+        }
+        m_cursors[c] = k;
+
+        const quint32 key = channel.firstKey + k;
+        if (k + 1 >= channel.keyCount || time <= keyTimes[k]
+            || channel.interpolation == QSSGKeyframeAnimationData::Interpolation::Step) {
+            // Before the first key, after the last one or a step, hold the value
+            m_start[c] = time;
+            m_invLength[c] = 0.0f;
+            m_from[c] = m_to[c] = values[key];
+            m_outTangent[c] = m_inTangent[c] = 0.0f;
+        } else {
+            const float length = times[key + 1] - times[key];
+            m_start[c] = times[key];
+            m_invLength[c] = length > 0.0f ? 1.0f / length : 0.0f;
+            m_from[c] = values[key];
+            m_to[c] = values[key + 1];
+            // Hermite tangents are relative to the parameter, not to time
+            m_outTangent[c] = animation.outTangents.at(int(key)) * length;
+            m_inTangent[c] = animation.inTangents.at(int(key + 1)) * length;
+        }
+    }
+
+    // Evaluate the curves:
+    // v = (2s^3 - 3s^2 + 1) from + (s^3 - 2s^2 + s) outTangent + (3s^2 - 2s^3) to + (s^3 - s^2) inTangent
+    int c = 0;
+#if defined(__SSE2__)
+    const __m128 vTime = _mm_set1_ps(time);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vTwo = _mm_set1_ps(2.0f);
+    const __m128 vThree = _mm_set1_ps(3.0f);
+    for (; c + 4 <= count; c += 4) {
+        __m128 s = _mm_mul_ps(_mm_sub_ps(vTime, _mm_loadu_ps(m_start.constData() + c)),
+                              _mm_loadu_ps(m_invLength.constData() + c));
+        s = _mm_min_ps(_mm_max_ps(s, vZero), vOne);
+        const __m128 s2 = _mm_mul_ps(s, s);
+        const __m128 s3 = _mm_mul_ps(s2, s);
+        const __m128 h01 = _mm_sub_ps(_mm_mul_ps(vThree, s2), _mm_mul_ps(vTwo, s3));
+        const __m128 h00 = _mm_sub_ps(vOne, h01);
+        const __m128 h11 = _mm_sub_ps(s3, s2);
+        const __m128 h10 = _mm_add_ps(_mm_sub_ps(h11, s2), s);
+        __m128 v = _mm_mul_ps(h00, _mm_loadu_ps(m_from.constData() + c));
+        v = _mm_add_ps(v, _mm_mul_ps(h10, _mm_loadu_ps(m_outTangent.constData() + c)));
+        v = _mm_add_ps(v, _mm_mul_ps(h01, _mm_loadu_ps(m_to.constData() + c)));
+        v = _mm_add_ps(v, _mm_mul_ps(h11, _mm_loadu_ps(m_inTangent.constData() + c)));
+        _mm_storeu_ps(outValues + c, v);
+    }
+#endif
+    for (; c < count; ++c) {
+        const float s = qBound(0.0f, (time - m_start.at(c)) * m_invLength.at(c), 1.0f);
+        const float s2 = s * s;
+        const float s3 = s2 * s;
+        const float h01 = 3.0f * s2 - 2.0f * s3;
+        const float h11 = s3 - s2;
+        outValues[c] = (1.0f - h01) * m_from.at(c) + (h11 - s2 + s) * m_outTangent.at(c) + h01 * m_to.at(c)
+                + h11 * m_inTangent.at(c);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSSGKEYFRAMEANIMATION_H
+#define QSSGKEYFRAMEANIMATION_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DUtils/private/qtquick3dutilsglobal_p.h>
+
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+// Keyframe data of an animation, stored compactly so that many channels can be
+// evaluated in one go.
+//
+// A channel animates one float of one target, e.g. the x of a node's position.
+// The keys of all channels live in shared arrays, a channel refers to its range.
+// Between two keys the value follows a cubic Hermite curve, linear
+// interpolation is expressed through the tangents.
+struct Q_QUICK3DUTILS_EXPORT QSSGKeyframeAnimationData
+{
+    // 64 bit random number to uniquely identify this file type.
+    static quint64 getFileTag() { return 0x3e8f1c5a92d74b06ULL; }
+    static quint32 getFileVersion() { return 1; }
+
+    enum class Property : quint8
+    {
+        PositionX = 0,
+        PositionY,
+        PositionZ,
+        RotationX,
+        RotationY,
+        RotationZ,
+        ScaleX,
+        ScaleY,
+        ScaleZ,
+        Opacity,
+        PropertyCount
+    };
+
+    enum class Interpolation : quint8
+    {
+        Step = 0, // holds the value of the previous key
+        Hermite
+    };
+
+    struct Key
+    {
+        float time = 0.0f; // seconds
+        float value = 0.0f;
+        float inTangent = 0.0f; // slope when arriving at the key, value per second
+        float outTangent = 0.0f; // slope when leaving the key
+    };
+
+    struct Channel
+    {
+        quint32 target = 0;
+        Property property = Property::PositionX;
+        Interpolation interpolation = Interpolation::Hermite;
+        quint32 firstKey = 0;
+        quint32 keyCount = 0;
+    };
+
+    QVector<Channel> channels;
+    // Keys of all channels, one array per field
+    QVector<float> times;
+    QVector<float> values;
+    QVector<float> inTangents;
+    QVector<float> outTangents;
+    float duration = 0.0f; // seconds
+    quint32 targetCount = 0;
+
+    // Adds a channel, the keys have to be sorted by time
+    void addChannel(quint32 target, Property property, Interpolation interpolation, const QVector<Key> &keys);
+    void clear();
+    bool isEmpty() const { return channels.isEmpty(); }
+
+    void save(QIODevice &outStream) const;
+    bool load(QIODevice &inStream);
+
+    // Sets the tangents so that the curve between two keys is a straight line
+    static void setLinearTangents(QVector<Key> &keys);
+};
+
+// Samples all channels of an animation at a time.
+//
+// Playback is mostly continuous, so the key index of every channel is kept
+// between calls and the segment lookup is usually a single comparison. The
+// curves are then evaluated four channels at a time with SSE when available.
+class Q_QUICK3DUTILS_EXPORT QSSGKeyframeEvaluator
+{
+public:
+    void setAnimation(const QSSGKeyframeAnimationData *animation);
+    const QSSGKeyframeAnimationData *animation() const { return m_animation; }
+
+    // Writes the value of channel i to outValues[i], outValues must have room
+    // for all channels
+    void evaluate(float time, float *outValues);
+
+private:
+    const QSSGKeyframeAnimationData *m_animation = nullptr;
+    QVector<quint32> m_cursors;
+    // Per channel segment parameters, filled before the curves are evaluated
+    QVector<float> m_start;
+    QVector<float> m_invLength;
+    QVector<float> m_from;
+    QVector<float> m_to;
+    QVector<float> m_outTangent;
+    QVector<float> m_inTangent;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSGKEYFRAMEANIMATION_H
@@ -30,32 +30,98 @@
 
 #include "qssgperftimer_p.h"
 
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QHash>
+#include <QtCore/QThread>
 #include <QtCore/QVector>
 
 #include <private/qssgutils_p.h>
 
 QT_BEGIN_NAMESPACE
 
-static uint qHash(const QSSGPerfTimer::Key &key)
+namespace {
+
+enum : quint32 {
+    RingCapacity = 8192, // zones per thread between two newFrame() calls
+    MaxDepth = 64,
+    MaxTraceEvents = 1 << 20
+};
+
+QBasicAtomicInteger<quint64> nextTimerId = Q_BASIC_ATOMIC_INITIALIZER(1);
+
+}
+
+// Single producer (the owning thread), single consumer (collect()) ring
+struct QSSGPerfTimer::ThreadBuffer
+{
+    struct Event
+    {
+        const char *name;
+        qint64 start;
+        qint64 duration;
+        quint32 depth;
+    };
+
+    QAtomicInteger<quint32> head { 0 }; // written by the owning thread
+    QAtomicInteger<quint32> tail { 0 }; // written by collect()
+    QAtomicInteger<quint32> dropped { 0 };
+    quint32 depth = 0; // owning thread only
+    Qt::HANDLE threadId = nullptr;
+    int index = 0;
+    // Time spent in already closed nested zones per depth, collect() only
+    qint64 childTime[MaxDepth + 1] = {};
+    Event events[RingCapacity];
+};
+
+namespace {
+
+// The buffers used last by this thread, keyed by timer id. Ids are never
+// reused, so entries of destroyed timers can not match.
+struct ThreadBufferCache
 {
-    const uchar *s = reinterpret_cast<const uchar *>(key.id);
-    uint h = 0;
-    while (*s) {
-        h = 31 * h + *s;
-        ++s;
+    quint64 timerId[4] = {};
+    QSSGPerfTimer::ThreadBuffer *buffer[4] = {};
+    quint32 next = 0;
+};
+
+thread_local ThreadBufferCache t_bufferCache;
+
+void writeJsonString(QByteArray &out, const char *str)
+{
+    out.append('"');
+    for (const char *c = str; *c; ++c) {
+        switch (*c) {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        default:
+            if (uchar(*c) < 0x20)
+                out.append(' ');
+            else
+                out.append(*c);
+            break;
+        }
     }
-    return h;
+    out.append('"');
+}
+
 }
-static bool operator==(const QSSGPerfTimer::Key &a, const QSSGPerfTimer::Key &b) { return !strcmp(a.id, b.id); }
 
 static bool operator<(const QSSGPerfTimer::Entry &a, const QSSGPerfTimer::Entry &b) { return a.tag < b.tag; }
 
-void QSSGPerfTimer::Entry::update(qint64 elapsed)
+void QSSGPerfTimer::Entry::update(qint64 elapsed, qint64 self)
 {
     totalTime += elapsed;
+    selfTime += self;
     maxTime = qMax(maxTime, elapsed);
     ++count;
 }
@@ -63,6 +129,7 @@ void QSSGPerfTimer::Entry::update(qint64 elapsed)
 void QSSGPerfTimer::Entry::reset()
 {
     totalTime = 0;
+    selfTime = 0;
     maxTime = 0;
     count = 0;
 }
@@ -72,59 +139,218 @@ QString QSSGPerfTimer::Entry::toString(quint32 inFramesPassed) const
     if (!count)
         return QString();
 
-
     const double milliseconds = totalTime / 1000000.0;
+    const double selfMilliseconds = selfTime / 1000000.0;
     const double maxMilliseconds = maxTime / 1000000.0;
     if (inFramesPassed == 0)
-        return QString::fromLatin1("%1 - %2ms").arg(tag).arg(milliseconds);
+        return QString::fromLatin1("%1 - %2ms (%3ms self)").arg(tag).arg(milliseconds).arg(selfMilliseconds);
 
-    return QString::fromLatin1("%1 - %2ms/frame; %3ms max; %4 hits").arg(tag).arg(milliseconds/inFramesPassed).arg(maxMilliseconds).arg(count);
+    return QString::fromLatin1("%1 - %2ms/frame (%3ms self); %4ms max; %5 hits")
+            .arg(tag)
+            .arg(milliseconds / inFramesPassed)
+            .arg(selfMilliseconds / inFramesPassed)
+            .arg(maxMilliseconds)
+            .arg(count);
 }
 
+QSSGPerfTimer::QSSGPerfTimer()
+    : m_id(nextTimerId.fetchAndAddRelaxed(1))
+{
+    m_clock.start();
+}
 
-QSSGPerfTimer::QSSGPerfTimer() = default;
+QSSGPerfTimer::~QSSGPerfTimer()
+{
+    qDeleteAll(m_buffers);
+}
 
-QSSGPerfTimer::~QSSGPerfTimer() = default;
+QSSGPerfTimer::ThreadBuffer *QSSGPerfTimer::threadBuffer()
+{
+    ThreadBufferCache &cache = t_bufferCache;
+    for (int i = 0; i < 4; ++i) {
+        if (cache.timerId[i] == m_id)
+            return cache.buffer[i];
+    }
+    ThreadBuffer *buffer = registerThread();
+    const quint32 slot = cache.next++ % 4;
+    cache.timerId[slot] = m_id;
+    cache.buffer[slot] = buffer;
+    return buffer;
+}
 
-void QSSGPerfTimer::update(const char *inId, qint64 elapsed)
+// Slow path, taken once per thread (and again only when a thread alternates
+// between more timers than the cache holds)
+QSSGPerfTimer::ThreadBuffer *QSSGPerfTimer::registerThread()
 {
+    const Qt::HANDLE threadId = QThread::currentThreadId();
     QMutexLocker locker(&mutex);
-    auto it = entries.find(Key{inId});
-    if (it == entries.end())
-        it = entries.insert(Key{inId}, Entry(QString::fromUtf8(inId)));
-    it.value().update(elapsed);
+    for (ThreadBuffer *buffer : qAsConst(m_buffers)) {
+        if (buffer->threadId == threadId)
+            return buffer;
+    }
+    ThreadBuffer *buffer = new ThreadBuffer;
+    buffer->threadId = threadId;
+    buffer->index = m_buffers.size();
+    m_buffers.append(buffer);
+    return buffer;
 }
 
-void QSSGPerfTimer::dump()
+QSSGPerfTimer::Zone QSSGPerfTimer::beginZone()
+{
+    ThreadBuffer *buffer = threadBuffer();
+    ++buffer->depth;
+    return { buffer, m_clock.nsecsElapsed() };
+}
+
+void QSSGPerfTimer::endZone(const Zone &inZone, const char *inTag)
+{
+    const qint64 end = m_clock.nsecsElapsed();
+    ThreadBuffer *buffer = inZone.buffer;
+    const quint32 depth = --buffer->depth;
+    const quint32 head = buffer->head.load();
+    if (head - buffer->tail.loadAcquire() >= RingCapacity) {
+        buffer->dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+    buffer->events[head % RingCapacity] = { inTag, inZone.start, end - inZone.start, depth };
+    buffer->head.storeRelease(head + 1);
+}
+
+void QSSGPerfTimer::update(const char *inId, qint64 elapsed)
+{
+    if (!m_isEnabled)
+        return;
+    ThreadBuffer *buffer = threadBuffer();
+    ++buffer->depth;
+    endZone({ buffer, m_clock.nsecsElapsed() - elapsed }, inId);
+}
+
+// Drains the thread buffers. Zones of a thread close in order, children
+// before their parent, which is what the self time computation relies on.
+void QSSGPerfTimer::collect()
+{
+    for (ThreadBuffer *buffer : qAsConst(m_buffers)) {
+        const quint32 head = buffer->head.loadAcquire();
+        quint32 tail = buffer->tail.load();
+        for (; tail != head; ++tail) {
+            const ThreadBuffer::Event &event = buffer->events[tail % RingCapacity];
+            const quint32 depth = qMin(event.depth, quint32(MaxDepth - 1));
+            const qint64 self = event.duration - buffer->childTime[depth + 1];
+            buffer->childTime[depth + 1] = 0;
+            buffer->childTime[depth] += event.duration;
+            if (depth == 0)
+                buffer->childTime[0] = 0;
+
+            auto it = entries.find(event.name);
+            if (it == entries.end())
+                it = entries.insert(event.name, Entry(QString::fromUtf8(event.name)));
+            it.value().update(event.duration, self);
+
+            if (m_isTraceEnabled && m_trace.size() < int(MaxTraceEvents))
+                m_trace.append({ event.name, event.start, event.duration, buffer->index });
+        }
+        buffer->tail.storeRelease(head);
+        m_droppedZones += buffer->dropped.fetchAndStoreRelaxed(0);
+    }
+}
+
+int QSSGPerfTimer::newFrame()
+{
+    if (m_isEnabled) {
+        QMutexLocker locker(&mutex);
+        collect();
+    }
+    return ++frameCount;
+}
+
+QVector<QSSGPerfTimer::Entry> QSSGPerfTimer::snapshot()
 {
     QMutexLocker locker(&mutex);
-    QVector<QSSGPerfTimer::Entry> allEntries;
-    for (auto iter = entries.begin(), end = entries.end(); iter != end; ++iter) {
-        allEntries.push_back(iter.value());
-        iter.value().reset();
+    collect();
+
+    // The same name may have been recorded through different pointers
+    QMap<QString, Entry> merged;
+    for (auto iter = entries.cbegin(), end = entries.cend(); iter != end; ++iter) {
+        const Entry &entry = iter.value();
+        Entry &target = merged[entry.tag];
+        target.tag = entry.tag;
+        target.count += entry.count;
+        target.totalTime += entry.totalTime;
+        target.selfTime += entry.selfTime;
+        target.maxTime = qMax(target.maxTime, entry.maxTime);
     }
+    return merged.values().toVector();
+}
 
-    std::sort(allEntries.begin(), allEntries.end());
+quint64 QSSGPerfTimer::droppedZones()
+{
+    QMutexLocker locker(&mutex);
+    collect();
+    return m_droppedZones;
+}
+
+void QSSGPerfTimer::dump()
+{
+    const QVector<QSSGPerfTimer::Entry> allEntries = snapshot();
 
     qDebug() << "performance data:";
-    for (const auto &e: qAsConst(allEntries))
+    for (const auto &e: allEntries)
         qDebug() << "    " << e.toString(frameCount).toUtf8().constData();
+    const quint64 dropped = droppedZones();
+    if (dropped)
+        qDebug() << "     " << dropped << "zones dropped";
     qDebug() << "";
 
-    frameCount = 0;
+    reset();
 }
 
 void QSSGPerfTimer::reset()
 {
     QMutexLocker locker(&mutex);
+    collect();
     auto iter = entries.begin();
     const auto end = entries.end();
     while (iter != end) {
         iter.value().reset();
         ++iter;
     }
+    m_droppedZones = 0;
 
     frameCount = 0;
 }
 
+bool QSSGPerfTimer::exportTrace(QIODevice *inDevice)
+{
+    QMutexLocker locker(&mutex);
+    collect();
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(m_trace.size() * 128 + 64);
+    out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (int i = 0, end = m_trace.size(); i < end; ++i) {
+        const TraceEvent &event = m_trace.at(i);
+        if (i)
+            out.append(',');
+        // Complete events, timestamps in microseconds
+        out.append("\n{\"ph\":\"X\",\"cat\":\"quick3d\",\"name\":");
+        writeJsonString(out, event.name);
+        out.append(",\"ts\":").append(QByteArray::number(double(event.start) / 1000.0, 'f', 3));
+        out.append(",\"dur\":").append(QByteArray::number(double(event.duration) / 1000.0, 'f', 3));
+        out.append(",\"pid\":").append(pid);
+        out.append(",\"tid\":").append(QByteArray::number(event.thread));
+        out.append('}');
+    }
+    out.append("\n]}\n");
+    return inDevice->write(out) == out.size();
+}
+
+bool QSSGPerfTimer::exportTrace(const QString &inFileName)
+{
+    QFile file(inFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return exportTrace(&file);
+}
+
 QT_END_NAMESPACE
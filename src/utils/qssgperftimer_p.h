@@ -51,75 +51,126 @@
 
 QT_BEGIN_NAMESPACE
 
-struct QSSGTimerEntry;
+class QIODevice;
 
+// Records timed zones, see QSSGStackPerfTimer.
+//
+// Each thread writes the zones it closes to its own ring buffer without
+// taking locks. The buffers are drained and aggregated off the hot path: on
+// newFrame() and when the results are queried. Zone names must be string
+// literals (typically Q_FUNC_INFO); they are stored by pointer only.
+// When tracing is enabled the individual zones are kept as well and can be
+// exported in the Chrome trace event format, which Perfetto also reads.
 class Q_QUICK3DUTILS_EXPORT QSSGPerfTimer
 {
     Q_DISABLE_COPY(QSSGPerfTimer)
 
 public:
-    struct Key {
-        const char *id;
-    };
-
     struct Entry {
         Entry(const QString &id)
             : tag(id)
         {}
         Entry() = default;
 
-        void update(qint64 elapsed);
+        void update(qint64 elapsed, qint64 self);
         void reset();
         QString toString(quint32 nFrames) const;
 
         quint32 count = 0;
         qint64 totalTime = 0;
+        qint64 selfTime = 0; // total time minus the time spent in nested zones
         qint64 maxTime = 0;
         QString tag;
     };
 
+    struct ThreadBuffer;
+
+    // An open zone, returned by beginZone()
+    struct Zone {
+        ThreadBuffer *buffer;
+        qint64 start;
+    };
+
 private:
     bool m_isEnabled = false;
+    bool m_isTraceEnabled = false;
     int frameCount = 0;
+    const quint64 m_id;
+    QElapsedTimer m_clock;
+
+    // Everything below is only touched with the mutex held, never while
+    // recording a zone.
     QMutex mutex;
-    QHash<Key, Entry> entries;
+    QVector<ThreadBuffer *> m_buffers;
+    QHash<const char *, Entry> entries;
+    struct TraceEvent {
+        const char *name;
+        qint64 start;
+        qint64 duration;
+        int thread;
+    };
+    QVector<TraceEvent> m_trace;
+    quint64 m_droppedZones = 0;
+
+    ThreadBuffer *threadBuffer();
+    ThreadBuffer *registerThread();
+    void collect();
 
 public:
     QSSGPerfTimer();
     ~QSSGPerfTimer();
 
-    // amount is in counter frequency units
+    // Record a zone of inAmount nanoseconds ending now
     void update(const char *inTag, qint64 inAmount);
 
+    Zone beginZone();
+    void endZone(const Zone &inZone, const char *inTag);
+
     // Dump current summation of timer data.
     void dump();
     void reset();
+    // Copy of the current summation of timer data, sorted by tag.
+    QVector<Entry> snapshot();
+    // Number of zones lost because a thread's buffer was full
+    quint64 droppedZones();
+
+    // Write the zones recorded while tracing was enabled as Chrome trace
+    // event JSON.
+    bool exportTrace(QIODevice *inDevice);
+    bool exportTrace(const QString &inFileName);
 
-    int newFrame() { return ++frameCount; }
+    // Marks the end of a frame, aggregates what was recorded so far.
+    int newFrame();
+    int frames() const { return frameCount; }
 
     void setEnabled(bool b) { m_isEnabled = b; }
     bool isEnabled() const { return m_isEnabled; }
+    // Keep every zone for exportTrace(), up to a fixed limit.
+    void setTraceEnabled(bool b) { m_isTraceEnabled = b; }
+    bool isTraceEnabled() const { return m_isTraceEnabled; }
 };
 
+// Times the scope it lives in. When the timer is disabled this costs a
+// single branch on construction and destruction.
 struct QSSGStackPerfTimer
 {
+    Q_DISABLE_COPY(QSSGStackPerfTimer)
+
     QSSGPerfTimer *m_timer;
-    QElapsedTimer elapsedTimer;
     const char *m_id;
+    QSSGPerfTimer::Zone m_zone;
 
     QSSGStackPerfTimer(QSSGPerfTimer *timer, const char *inId)
-        : m_timer(timer), m_id(inId)
+        : m_timer(timer->isEnabled() ? timer : nullptr), m_id(inId), m_zone{ nullptr, 0 }
     {
-        if (timer->isEnabled())
-            elapsedTimer.start();
+        if (m_timer)
+            m_zone = m_timer->beginZone();
     }
 
     ~QSSGStackPerfTimer()
     {
-        if (m_timer->isEnabled()) {
-            qint64 elapsed = elapsedTimer.nsecsElapsed();
-            m_timer->update(m_id, elapsed);
-        }
+        if (m_timer)
+            m_timer->endZone(m_zone, m_id);
     }
 };
 
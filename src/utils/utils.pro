@@ -11,6 +11,7 @@ HEADERS += \
     qssgdataref_p.h \
     qssgoption_p.h \
     qssginvasivelinkedlist_p.h \
+    qssgkeyframeanimation_p.h \
     qssgplane_p.h \
     qssgperftimer_p.h \
     qtquick3dutilsglobal_p.h
@@ -18,6 +19,7 @@ HEADERS += \
 SOURCES += \
     qssgbounds3.cpp \
     qssgdataref.cpp \
+    qssgkeyframeanimation.cpp \
     qssgperftimer.cpp \
     qssgplane.cpp \
     qssgutils.cpp
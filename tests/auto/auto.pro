@@ -1,3 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = cmake \
-    assetimport
+    assetimport \
+    lightmapbaker \
+    perframeallocator \
+    nodehierarchy \
+    threadpool \
+    deferredbackend
@@ -0,0 +1,324 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtQuick3DRender/private/qssgrenderbackenddeferred_p.h>
+#include <QtQuick3DRender/private/qssgrenderbackendnull_p.h>
+
+namespace {
+
+QString hex(const void *inData, int inSize)
+{
+    return QString::fromLatin1(QByteArray(static_cast<const char *>(inData), inSize).toHex());
+}
+
+// Logs the calls that reach it with their arguments. It is a deferred backend over the
+// null backend only to get an implementation of the rest of the interface, the logged
+// calls are not recorded.
+class CountingBackend : public QSSGRenderBackendDeferred
+{
+public:
+    CountingBackend() : QSSGRenderBackendDeferred(QSSGRenderBackendNULL::createBackend()) {}
+
+    QStringList calls;
+
+    void setRenderState(bool bEnable, const QSSGRenderState value) override
+    {
+        calls.append(QStringLiteral("setRenderState(%1, %2)").arg(bEnable).arg(int(value)));
+    }
+    void setDepthFunc(const QSSGRenderBoolOp func) override
+    {
+        calls.append(QStringLiteral("setDepthFunc(%1)").arg(int(func)));
+    }
+    void setScissorRect(const QRect &rect) override
+    {
+        calls.append(QStringLiteral("setScissorRect(%1, %2, %3, %4)").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height()));
+    }
+    void setViewportRect(const QRect &rect) override
+    {
+        calls.append(QStringLiteral("setViewportRect(%1, %2, %3, %4)").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height()));
+    }
+    void setClearColor(const QVector4D *pClearColor) override
+    {
+        calls.append(QStringLiteral("setClearColor(%1)").arg(hex(pClearColor, int(sizeof(QVector4D)))));
+    }
+    void clear(QSSGRenderClearFlags flags) override
+    {
+        calls.append(QStringLiteral("clear(%1)").arg(int(flags)));
+    }
+    void bindBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags) override
+    {
+        calls.append(QStringLiteral("bindBuffer(%1, %2)").arg(quintptr(bo)).arg(int(bindFlags)));
+    }
+    void updateBufferRange(QSSGRenderBackendBufferObject bo,
+                           QSSGRenderBufferType bindFlags,
+                           size_t offset,
+                           QSSGByteView data) override
+    {
+        calls.append(QStringLiteral("updateBufferRange(%1, %2, %3, %4)")
+                             .arg(quintptr(bo))
+                             .arg(int(bindFlags))
+                             .arg(offset)
+                             .arg(hex(data.begin(), data.size())));
+    }
+    void *mapBuffer(QSSGRenderBackendBufferObject bo,
+                    QSSGRenderBufferType bindFlags,
+                    size_t offset,
+                    size_t length,
+                    QSSGRenderBufferAccessFlags accessFlags) override
+    {
+        calls.append(QStringLiteral("mapBuffer(%1, %2, %3, %4, %5)")
+                             .arg(quintptr(bo))
+                             .arg(int(bindFlags))
+                             .arg(offset)
+                             .arg(length)
+                             .arg(int(accessFlags)));
+        return mapped;
+    }
+    bool unmapBuffer(QSSGRenderBackendBufferObject bo, QSSGRenderBufferType bindFlags) override
+    {
+        calls.append(QStringLiteral("unmapBuffer(%1, %2)").arg(quintptr(bo)).arg(int(bindFlags)));
+        return true;
+    }
+    void getQueryResult(QSSGRenderBackendQueryObject qo, QSSGRenderQueryResultType resultType, quint32 *params) override
+    {
+        calls.append(QStringLiteral("getQueryResult(%1, %2)").arg(quintptr(qo)).arg(int(resultType)));
+        *params = 0;
+    }
+    QSSGRenderBackendSyncObject createSync(QSSGRenderSyncType type, QSSGRenderSyncFlags syncFlags) override
+    {
+        calls.append(QStringLiteral("createSync(%1, %2)").arg(int(type)).arg(int(syncFlags)));
+        return QSSGRenderBackendSyncObject(quintptr(0x50));
+    }
+    void setRenderTarget(QSSGRenderBackendRenderTargetObject rto) override
+    {
+        calls.append(QStringLiteral("setRenderTarget(%1)").arg(quintptr(rto)));
+    }
+    void setActiveProgram(QSSGRenderBackendShaderProgramObject po) override
+    {
+        calls.append(QStringLiteral("setActiveProgram(%1)").arg(quintptr(po)));
+    }
+    void programSetConstantBufferRange(quint32 index, QSSGRenderBackendBufferObject bo, quint32 offset, quint32 size) override
+    {
+        calls.append(QStringLiteral("programSetConstantBufferRange(%1, %2, %3, %4)").arg(index).arg(quintptr(bo)).arg(offset).arg(size));
+    }
+    void setConstantValue(QSSGRenderBackendShaderProgramObject po,
+                          quint32 id,
+                          QSSGRenderShaderDataType type,
+                          qint32 count,
+                          const void *value,
+                          bool transpose) override
+    {
+        quint32 storageSize = 0;
+        const quint32 size = QSSGRenderCommandList::constantValueSize(type, count, &storageSize);
+        calls.append(QStringLiteral("setConstantValue(%1, %2, %3, %4, %5, %6)")
+                             .arg(quintptr(po))
+                             .arg(id)
+                             .arg(int(type))
+                             .arg(count)
+                             .arg(hex(value, int(size)))
+                             .arg(transpose));
+    }
+    void draw(QSSGRenderDrawMode drawMode, quint32 start, quint32 count) override
+    {
+        calls.append(QStringLiteral("draw(%1, %2, %3)").arg(int(drawMode)).arg(start).arg(count));
+    }
+    void drawIndexed(QSSGRenderDrawMode drawMode, quint32 count, QSSGRenderComponentType type, const void *indices) override
+    {
+        calls.append(QStringLiteral("drawIndexed(%1, %2, %3, %4)").arg(int(drawMode)).arg(count).arg(int(type)).arg(quintptr(indices)));
+    }
+    void readPixel(QSSGRenderBackendRenderTargetObject rto,
+                   qint32 x,
+                   qint32 y,
+                   qint32 width,
+                   qint32 height,
+                   QSSGRenderReadPixelFormat inFormat,
+                   QSSGByteRef pixels) override
+    {
+        calls.append(QStringLiteral("readPixel(%1, %2, %3, %4, %5, %6, %7)")
+                             .arg(quintptr(rto))
+                             .arg(x)
+                             .arg(y)
+                             .arg(width)
+                             .arg(height)
+                             .arg(int(inFormat))
+                             .arg(pixels.size()));
+    }
+
+private:
+    quint8 mapped[256] = {};
+};
+
+template<typename THandle>
+THandle handle(quintptr inValue)
+{
+    return reinterpret_cast<THandle>(inValue);
+}
+
+const auto renderTarget = handle<QSSGRenderBackend::QSSGRenderBackendRenderTargetObject>(0x10);
+const auto buffer = handle<QSSGRenderBackend::QSSGRenderBackendBufferObject>(0x20);
+const auto program = handle<QSSGRenderBackend::QSSGRenderBackendShaderProgramObject>(0x30);
+const auto query = handle<QSSGRenderBackend::QSSGRenderBackendQueryObject>(0x40);
+
+// Issues a pass the way the renderer does
+void issuePass(QSSGRenderBackend *inBackend, int inPass)
+{
+    inBackend->setRenderTarget(renderTarget);
+    inBackend->setViewportRect(QRect(0, 0, 640 + inPass, 480));
+    inBackend->setScissorRect(QRect(8, 8, 320, 240 - inPass));
+    inBackend->setRenderState(true, QSSGRenderState::DepthTest);
+    inBackend->setRenderState(inPass % 2, QSSGRenderState::Blend);
+    inBackend->setDepthFunc(QSSGRenderBoolOp::LessThanOrEqual);
+    const QVector4D clearColor(0.1f, 0.2f, 0.3f, float(inPass));
+    inBackend->setClearColor(&clearColor);
+    inBackend->clear(QSSGRenderClearValues::Color | QSSGRenderClearValues::Depth);
+    inBackend->setActiveProgram(program);
+
+    quint8 vertices[32];
+    for (int i = 0; i < 32; ++i)
+        vertices[i] = quint8(i * 7 + inPass);
+    inBackend->bindBuffer(buffer, QSSGRenderBufferType::Vertex);
+    inBackend->updateBufferRange(buffer, QSSGRenderBufferType::Vertex, 16, QSSGByteView(vertices, 32));
+
+    const float color[4] = { 1.0f, 0.5f, 0.25f, float(inPass) };
+    inBackend->setConstantValue(program, 3, QSSGRenderShaderDataType::Vec4, 1, color, false);
+    const float matrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 2, 3, 4, float(inPass) };
+    inBackend->setConstantValue(program, 5, QSSGRenderShaderDataType::Matrix4x4, 1, matrix, true);
+    inBackend->programSetConstantBufferRange(17, buffer, 256 * quint32(inPass), 192);
+
+    inBackend->draw(QSSGRenderDrawMode::Triangles, 0, 36);
+    inBackend->drawIndexed(QSSGRenderDrawMode::TriangleStrip, 24, QSSGRenderComponentType::UnsignedInteger16, reinterpret_cast<const void *>(quintptr(8)));
+    inBackend->setRenderState(false, QSSGRenderState::DepthTest);
+}
+
+}
+
+class tst_deferredbackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void readbackReplaysRecorded_data();
+    void readbackReplaysRecorded();
+};
+
+// Replaying what was recorded issues the same calls with the same arguments as
+// executing them directly
+void tst_deferredbackend::roundTrip()
+{
+    CountingBackend direct;
+    for (int pass = 0; pass < 3; ++pass)
+        issuePass(&direct, pass);
+    QVERIFY(!direct.calls.isEmpty());
+
+    auto target = new CountingBackend;
+    QSSGRenderBackendDeferred deferred{ QSSGRef<QSSGRenderBackend>(target) };
+    for (int pass = 0; pass < 3; ++pass)
+        issuePass(&deferred, pass);
+    QVERIFY(target->calls.isEmpty());
+    QVERIFY(!deferred.commandList()->isEmpty());
+
+    deferred.submit();
+    QCOMPARE(target->calls, direct.calls);
+    QVERIFY(deferred.commandList()->isEmpty());
+
+    // The list is reused for the next frame
+    deferred.submit();
+    QCOMPARE(target->calls, direct.calls);
+    issuePass(&deferred, 0);
+    deferred.submit();
+    QCOMPARE(target->calls.size(), direct.calls.size() + direct.calls.size() / 3);
+}
+
+void tst_deferredbackend::readbackReplaysRecorded_data()
+{
+    QTest::addColumn<int>("call");
+    QTest::newRow("mapBuffer") << 0;
+    QTest::newRow("unmapBuffer") << 1;
+    QTest::newRow("readPixel") << 2;
+    QTest::newRow("getQueryResult") << 3;
+    QTest::newRow("createSync") << 4;
+}
+
+// Calls that observe the results of recorded commands must see them executed
+// first, commands recorded after the readback must not run before the next submit
+void tst_deferredbackend::readbackReplaysRecorded()
+{
+    QFETCH(int, call);
+
+    const auto issueReadback = [call](QSSGRenderBackend *inBackend) {
+        switch (call) {
+        case 0:
+            QVERIFY(inBackend->mapBuffer(buffer, QSSGRenderBufferType::Vertex, 0, 64, QSSGRenderBufferAccessTypeValues::Read));
+            break;
+        case 1:
+            inBackend->unmapBuffer(buffer, QSSGRenderBufferType::Vertex);
+            break;
+        case 2: {
+            quint8 pixels[4 * 4 * 4];
+            inBackend->readPixel(renderTarget, 1, 2, 4, 4, QSSGRenderReadPixelFormat::RGBA8, QSSGByteRef(pixels, sizeof(pixels)));
+        } break;
+        case 3: {
+            quint32 result = 1;
+            inBackend->getQueryResult(query, QSSGRenderQueryResultType::Result, &result);
+        } break;
+        case 4:
+            inBackend->createSync(QSSGRenderSyncType::GpuCommandsComplete, QSSGRenderSyncFlags());
+            break;
+        }
+    };
+
+    CountingBackend direct;
+    issuePass(&direct, 0);
+    issueReadback(&direct);
+    const auto prefix = direct.calls;
+    issuePass(&direct, 1);
+
+    auto target = new CountingBackend;
+    QSSGRenderBackendDeferred deferred{ QSSGRef<QSSGRenderBackend>(target) };
+    issuePass(&deferred, 0);
+    issueReadback(&deferred);
+    QCOMPARE(target->calls, prefix);
+    QVERIFY(deferred.commandList()->isEmpty());
+    issuePass(&deferred, 1);
+    QCOMPARE(target->calls, prefix);
+    QVERIFY(!deferred.commandList()->isEmpty());
+    deferred.submit();
+    QCOMPARE(target->calls, direct.calls);
+
+    // Nothing recorded, nothing to replay
+    target->calls.clear();
+    issueReadback(&deferred);
+    QCOMPARE(target->calls.size(), 1);
+}
+
+QTEST_APPLESS_MAIN(tst_deferredbackend)
+
+#include "tst_deferredbackend.moc"
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <QtQuick3DAssetImport/private/qssglightmapbaker_p.h>
+
+class tst_lightmapbaker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void generateUVs();
+    void bakeShadow();
+    void saveHdr();
+};
+
+// A unit cube with a separate set of vertices per face
+static void cube(QVector<QVector3D> *positions, QVector<quint32> *indices)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = -1; side <= 1; side += 2) {
+            const quint32 first = quint32(positions->size());
+            for (int corner = 0; corner < 4; ++corner) {
+                QVector3D p;
+                p[axis] = float(side);
+                p[(axis + 1) % 3] = (corner & 1) ? 1.0f : -1.0f;
+                p[(axis + 2) % 3] = (corner & 2) ? 1.0f : -1.0f;
+                positions->append(p);
+            }
+            *indices << first << first + 1 << first + 3 << first << first + 3 << first + 2;
+        }
+    }
+}
+
+static float cross2D(const QVector2D &a, const QVector2D &b, const QVector2D &c)
+{
+    return (b.x() - a.x()) * (c.y() - a.y()) - (c.x() - a.x()) * (b.y() - a.y());
+}
+
+void tst_lightmapbaker::generateUVs()
+{
+    QVector<QVector3D> positions;
+    QVector<quint32> indices;
+    cube(&positions, &indices);
+
+    const int resolution = 64;
+    QSSGLightmapUVGenerator generator;
+    QVERIFY(generator.generate(positions, indices, resolution));
+    QCOMPARE(generator.chartCount, 6);
+    QCOMPARE(generator.indices.size(), indices.size());
+    QCOMPARE(generator.uvs.size(), generator.vertexMap.size());
+
+    for (const QVector2D &uv : qAsConst(generator.uvs)) {
+        QVERIFY(uv.x() >= 0.0f && uv.x() <= 1.0f);
+        QVERIFY(uv.y() >= 0.0f && uv.y() <= 1.0f);
+    }
+    for (int i = 0; i < indices.size(); ++i)
+        QCOMPARE(positions.at(int(generator.vertexMap.at(int(generator.indices.at(i))))), positions.at(int(indices.at(i))));
+
+    // No texel center may be covered by more than one triangle
+    QVector<int> coverage(resolution * resolution, 0);
+    for (int i = 0; i < generator.indices.size(); i += 3) {
+        const QVector2D a = generator.uvs.at(int(generator.indices.at(i))) * float(resolution);
+        const QVector2D b = generator.uvs.at(int(generator.indices.at(i + 1))) * float(resolution);
+        const QVector2D c = generator.uvs.at(int(generator.indices.at(i + 2))) * float(resolution);
+        const float area = cross2D(a, b, c);
+        QVERIFY(std::abs(area) > 0.0f);
+        for (int y = 0; y < resolution; ++y) {
+            for (int x = 0; x < resolution; ++x) {
+                const QVector2D p(float(x) + 0.5f, float(y) + 0.5f);
+                const float w0 = cross2D(b, c, p) / area;
+                const float w1 = cross2D(c, a, p) / area;
+                const float w2 = cross2D(a, b, p) / area;
+                if (w0 > 1e-4f && w1 > 1e-4f && w2 > 1e-4f)
+                    ++coverage[y * resolution + x];
+            }
+        }
+    }
+    for (int count : qAsConst(coverage))
+        QVERIFY(count <= 1);
+}
+
+void tst_lightmapbaker::bakeShadow()
+{
+    // A floor from -1 to 1 with a blocker hovering over its center, lit from above
+    QSSGLightmapBaker::Model floor;
+    floor.positions << QVector3D(-1.0f, 0.0f, -1.0f) << QVector3D(1.0f, 0.0f, -1.0f)
+                    << QVector3D(-1.0f, 0.0f, 1.0f) << QVector3D(1.0f, 0.0f, 1.0f);
+    floor.normals.fill(QVector3D(0.0f, 1.0f, 0.0f), 4);
+    floor.uvs << QVector2D(0.0f, 0.0f) << QVector2D(1.0f, 0.0f) << QVector2D(0.0f, 1.0f) << QVector2D(1.0f, 1.0f);
+    floor.indices << 0 << 2 << 1 << 1 << 2 << 3;
+    floor.resolution = 32;
+
+    QSSGLightmapBaker::Model blocker;
+    blocker.positions << QVector3D(-0.25f, 0.5f, -0.25f) << QVector3D(0.25f, 0.5f, -0.25f)
+                      << QVector3D(-0.25f, 0.5f, 0.25f) << QVector3D(0.25f, 0.5f, 0.25f);
+    blocker.normals.fill(QVector3D(0.0f, 1.0f, 0.0f), 4);
+    blocker.indices << 0 << 2 << 1 << 1 << 2 << 3;
+    blocker.resolution = 0;
+
+    QSSGLightmapBaker::Light light;
+    light.direction = QVector3D(0.0f, -1.0f, 0.0f);
+
+    QSSGLightmapBaker baker;
+    QSSGLightmapBaker::Settings settings;
+    settings.indirectSamples = 4;
+    baker.setSettings(settings);
+    const int floorIndex = baker.addModel(floor);
+    baker.addModel(blocker);
+    baker.addLight(light);
+    QVERIFY(baker.bake());
+
+    const QSSGLightmapBaker::Lightmap &lightmap = baker.lightmap(floorIndex);
+    QCOMPARE(lightmap.width, 32);
+    QCOMPARE(lightmap.height, 32);
+    QCOMPARE(lightmap.shadow.size(), 32 * 32);
+
+    const float center = lightmap.shadow.at(16 * 32 + 16);
+    const float corner = lightmap.shadow.at(2 * 32 + 2);
+    QVERIFY2(center < 0.5f, qPrintable(QString::number(center)));
+    QVERIFY2(corner > 0.95f, qPrintable(QString::number(corner)));
+    QVERIFY(lightmap.radiosity.at(2 * 32 + 2).x() > lightmap.radiosity.at(16 * 32 + 16).x());
+}
+
+void tst_lightmapbaker::saveHdr()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("lightmap.hdr"));
+
+    const int width = 16;
+    const int height = 8;
+    QVector<QVector3D> texels;
+    for (int i = 0; i < width * height; ++i)
+        texels.append(QVector3D(float(i) / 16.0f, 0.5f, 2.0f));
+    QVERIFY(QSSGLightmapBaker::saveHdr(fileName, width, height, texels));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readLine().startsWith("#?RADIANCE"));
+    bool hasFormat = false;
+    QByteArray line;
+    while (!(line = file.readLine().trimmed()).isEmpty()) {
+        if (line == "FORMAT=32-bit_rle_rgbe")
+            hasFormat = true;
+    }
+    QVERIFY(hasFormat);
+    QCOMPARE(file.readLine().trimmed(), QByteArray("-Y 8 +X 16"));
+    // Each scanline is a 4 byte header and one literal run per channel
+    QCOMPARE(file.bytesAvailable(), qint64(height * (4 + 4 * (1 + width))));
+}
+
+QTEST_APPLESS_MAIN(tst_lightmapbaker)
+
+#include "tst_lightmapbaker.moc"
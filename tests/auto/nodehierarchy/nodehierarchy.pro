@@ -0,0 +1,9 @@
+QT += testlib
+QT += quick3druntimerender-private
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += tst_nodehierarchy.cpp
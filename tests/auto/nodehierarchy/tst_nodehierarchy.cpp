@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include <functional>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernode_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernodehierarchy_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+
+class tst_nodehierarchy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void matchesCalculateGlobalVariables_data();
+    void matchesCalculateGlobalVariables();
+    void reparent();
+    void rebuildPerRoot();
+    void sharedRoot();
+    void hiddenSubtree();
+
+private:
+    // Builds a tree of inCount nodes below inLayer where every node has inBranching children
+    void buildTree(QSSGRenderLayer &inLayer, int inCount, int inBranching);
+    // Compares the state pushed by the hierarchy with a pointer based update of the nodes
+    void verifyAgainstPointerUpdate(const QSSGRenderNodeHierarchy &inHierarchy);
+    void verifyDepthFirstOrder(const QSSGRenderNodeHierarchy &inHierarchy, const QSSGRenderNode &inRoot);
+
+    QSSGRef<QSSGAbstractThreadPool> m_threadPool;
+    QVector<QSSGRenderNode *> m_nodes;
+};
+
+void tst_nodehierarchy::initTestCase()
+{
+    m_threadPool = QSSGAbstractThreadPool::createThreadPool(4);
+    QVERIFY(m_threadPool);
+}
+
+void tst_nodehierarchy::cleanup()
+{
+    qDeleteAll(m_nodes);
+    m_nodes.clear();
+}
+
+void tst_nodehierarchy::buildTree(QSSGRenderLayer &inLayer, int inCount, int inBranching)
+{
+    const int first = m_nodes.size();
+    for (int i = 0; i < inCount; ++i) {
+        auto node = new QSSGRenderNode;
+        node->position = QVector3D(float(i % 5), float(i % 3), float(i % 7));
+        node->rotation = QVector3D(float(i % 4) * 0.2f, float(i % 7) * 0.1f, 0.0f);
+        node->scale = QVector3D(1.0f + float(i % 3) * 0.1f, 1.0f, 1.0f);
+        node->localOpacity = (i % 4) ? 1.0f : 0.5f;
+        node->flags.setFlag(QSSGRenderNode::Flag::Active, i % 11 != 5);
+        if (i < inBranching)
+            inLayer.addChild(*node);
+        else
+            m_nodes.at(first + i / inBranching - 1)->addChild(*node);
+        m_nodes.append(node);
+    }
+}
+
+void tst_nodehierarchy::verifyAgainstPointerUpdate(const QSSGRenderNodeHierarchy &inHierarchy)
+{
+    QVector<QMatrix4x4> transforms;
+    QVector<float> opacities;
+    QVector<bool> active;
+    for (qint32 idx = 0; idx < inHierarchy.size(); ++idx) {
+        const QSSGRenderNode *node = inHierarchy.node(idx);
+        QVERIFY(!node->flags.testFlag(QSSGRenderNode::Flag::Dirty));
+        QVERIFY(qFuzzyCompare(inHierarchy.globalTransform(idx), node->globalTransform));
+        transforms.append(node->globalTransform);
+        opacities.append(node->globalOpacity);
+        active.append(node->flags.testFlag(QSSGRenderNode::Flag::GloballyActive));
+    }
+
+    for (qint32 idx = 0; idx < inHierarchy.size(); ++idx)
+        inHierarchy.node(idx)->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    for (qint32 idx = 0; idx < inHierarchy.size(); ++idx)
+        inHierarchy.node(idx)->calculateGlobalVariables();
+
+    for (qint32 idx = 0; idx < inHierarchy.size(); ++idx) {
+        const QSSGRenderNode *node = inHierarchy.node(idx);
+        QVERIFY(qFuzzyCompare(transforms.at(idx), node->globalTransform));
+        QCOMPARE(opacities.at(idx), node->globalOpacity);
+        QCOMPARE(active.at(idx), node->flags.testFlag(QSSGRenderNode::Flag::GloballyActive));
+    }
+}
+
+void tst_nodehierarchy::verifyDepthFirstOrder(const QSSGRenderNodeHierarchy &inHierarchy, const QSSGRenderNode &inRoot)
+{
+    QVector<const QSSGRenderNode *> expected;
+    std::function<void(const QSSGRenderNode *)> visit = [&](const QSSGRenderNode *inNode) {
+        expected.append(inNode);
+        for (const QSSGRenderNode *child = inNode->firstChild; child; child = child->nextSibling)
+            visit(child);
+    };
+    for (const QSSGRenderNode *child = inRoot.firstChild; child; child = child->nextSibling)
+        visit(child);
+
+    const QVector<qint32> &order = inHierarchy.depthFirstOrder();
+    QCOMPARE(order.size(), expected.size());
+    QCOMPARE(inHierarchy.size(), expected.size());
+    for (int i = 0; i < order.size(); ++i)
+        QCOMPARE(inHierarchy.node(order.at(i)), expected.at(i));
+}
+
+void tst_nodehierarchy::matchesCalculateGlobalVariables_data()
+{
+    QTest::addColumn<int>("nodes");
+    QTest::addColumn<int>("branching");
+    QTest::addColumn<bool>("threaded");
+
+    QTest::newRow("deep") << 500 << 2 << false;
+    QTest::newRow("wide") << 500 << 16 << false;
+    // Above ParallelNodeThreshold, so the passes are split over the pool
+    QTest::newRow("threaded") << 20000 << 8 << true;
+}
+
+void tst_nodehierarchy::matchesCalculateGlobalVariables()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, branching);
+    QFETCH(bool, threaded);
+
+    QSSGRenderLayer layer;
+    buildTree(layer, nodes, branching);
+    const QSSGRef<QSSGAbstractThreadPool> pool = threaded ? m_threadPool : QSSGRef<QSSGAbstractThreadPool>();
+
+    QSSGRenderNodeHierarchy hierarchy;
+    QVERIFY(hierarchy.needsRebuild(layer));
+    hierarchy.build(layer);
+    QVERIFY(!hierarchy.needsRebuild(layer));
+    verifyDepthFirstOrder(hierarchy, layer);
+    QVERIFY(hierarchy.update(pool));
+    QVERIFY(!hierarchy.update(pool));
+    verifyAgainstPointerUpdate(hierarchy);
+
+    // Only a part of the tree is dirty
+    m_nodes.at(1)->rotation.setZ(0.3f);
+    m_nodes.at(1)->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    m_nodes.at(nodes - 1)->localOpacity = 0.25f;
+    m_nodes.at(nodes - 1)->markDirty();
+    QVERIFY(!hierarchy.needsRebuild(layer));
+    QVERIFY(hierarchy.update(pool));
+    verifyAgainstPointerUpdate(hierarchy);
+}
+
+void tst_nodehierarchy::reparent()
+{
+    QSSGRenderLayer layer;
+    buildTree(layer, 200, 3);
+
+    QSSGRenderNodeHierarchy hierarchy;
+    hierarchy.build(layer);
+    hierarchy.update();
+
+    // Move a subtree from deep down the tree below another top level node
+    QSSGRenderNode *moved = m_nodes.at(40);
+    QSSGRenderNode *newParent = m_nodes.at(2);
+    QVERIFY(moved->parent != newParent);
+    newParent->addChild(*moved);
+    QCOMPARE(moved->parent, newParent);
+    QVERIFY(hierarchy.needsRebuild(layer));
+
+    newParent->position = QVector3D(10.0f, -4.0f, 2.0f);
+    newParent->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    hierarchy.build(layer);
+    QVERIFY(!hierarchy.needsRebuild(layer));
+    verifyDepthFirstOrder(hierarchy, layer);
+    QVERIFY(hierarchy.update());
+    verifyAgainstPointerUpdate(hierarchy);
+
+    // Detaching a node drops its subtree from the hierarchy
+    QSSGRenderNode *removed = m_nodes.at(5);
+    removed->removeFromGraph();
+    QVERIFY(hierarchy.needsRebuild(layer));
+    hierarchy.build(layer);
+    verifyDepthFirstOrder(hierarchy, layer);
+    for (qint32 idx = 0; idx < hierarchy.size(); ++idx)
+        QVERIFY(hierarchy.node(idx) != removed);
+    hierarchy.update();
+    verifyAgainstPointerUpdate(hierarchy);
+}
+
+void tst_nodehierarchy::rebuildPerRoot()
+{
+    QSSGRenderLayer firstLayer;
+    QSSGRenderLayer secondLayer;
+    buildTree(firstLayer, 50, 3);
+    QSSGRenderNode *firstTreeNode = m_nodes.last();
+    buildTree(secondLayer, 50, 3);
+
+    QSSGRenderNodeHierarchy firstHierarchy;
+    QSSGRenderNodeHierarchy secondHierarchy;
+    firstHierarchy.build(firstLayer);
+    secondHierarchy.build(secondLayer);
+    QVERIFY(firstHierarchy.needsRebuild(secondLayer));
+
+    // Structure changes in one tree leave the hierarchy of the other tree valid
+    auto node = new QSSGRenderNode;
+    m_nodes.append(node);
+    firstTreeNode->addChild(*node);
+    QVERIFY(firstHierarchy.needsRebuild(firstLayer));
+    QVERIFY(!secondHierarchy.needsRebuild(secondLayer));
+
+    firstHierarchy.build(firstLayer);
+    secondHierarchy.build(secondLayer);
+    m_nodes.at(60)->removeFromGraph();
+    QVERIFY(!firstHierarchy.needsRebuild(firstLayer));
+    QVERIFY(secondHierarchy.needsRebuild(secondLayer));
+}
+
+void tst_nodehierarchy::sharedRoot()
+{
+    // Two layers rendering the same nodes each keep their own indices, nothing of the
+    // hierarchy is stored in the nodes.
+    QSSGRenderLayer layer;
+    buildTree(layer, 100, 4);
+    QSSGRenderNodeHierarchy firstHierarchy;
+    QSSGRenderNodeHierarchy secondHierarchy;
+    firstHierarchy.build(layer);
+    firstHierarchy.update();
+
+    m_nodes.at(3)->addChild(*m_nodes.at(90));
+    QVERIFY(firstHierarchy.needsRebuild(layer));
+    secondHierarchy.build(layer);
+    verifyDepthFirstOrder(secondHierarchy, layer);
+    secondHierarchy.update();
+    verifyAgainstPointerUpdate(secondHierarchy);
+
+    firstHierarchy.build(layer);
+    verifyDepthFirstOrder(firstHierarchy, layer);
+    verifyDepthFirstOrder(secondHierarchy, layer);
+}
+
+// Changes below an inactive node do not report the hierarchy dirty, like
+// calculateGlobalVariables() does not for inactive nodes
+void tst_nodehierarchy::hiddenSubtree()
+{
+    QSSGRenderLayer layer;
+    buildTree(layer, 40, 2);
+    for (QSSGRenderNode *node : qAsConst(m_nodes))
+        node->flags.setFlag(QSSGRenderNode::Flag::Active, true);
+    QSSGRenderNodeHierarchy hierarchy;
+    hierarchy.build(layer);
+    QVERIFY(hierarchy.update());
+
+    // Hiding a visible node needs a redraw
+    QSSGRenderNode *hidden = m_nodes.at(0);
+    hidden->flags.setFlag(QSSGRenderNode::Flag::Active, false);
+    hidden->markDirty();
+    QVERIFY(hierarchy.update());
+    QVERIFY(!m_nodes.at(2)->flags.testFlag(QSSGRenderNode::Flag::GloballyActive));
+
+    // Moving nodes inside the hidden subtree does not
+    m_nodes.at(2)->position = QVector3D(5.0f, 0.0f, 0.0f);
+    m_nodes.at(2)->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    m_nodes.at(6)->localOpacity = 0.5f;
+    m_nodes.at(6)->markDirty();
+    QVERIFY(!hierarchy.update());
+    verifyAgainstPointerUpdate(hierarchy);
+
+    // Moving a visible node does
+    m_nodes.at(1)->position = QVector3D(0.0f, 5.0f, 0.0f);
+    m_nodes.at(1)->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    QVERIFY(hierarchy.update());
+
+    // And so does showing the subtree again
+    hidden->flags.setFlag(QSSGRenderNode::Flag::Active, true);
+    hidden->markDirty();
+    QVERIFY(hierarchy.update());
+    QVERIFY(m_nodes.at(2)->flags.testFlag(QSSGRenderNode::Flag::GloballyActive));
+    verifyAgainstPointerUpdate(hierarchy);
+}
+
+QTEST_GUILESS_MAIN(tst_nodehierarchy)
+
+#include "tst_nodehierarchy.moc"
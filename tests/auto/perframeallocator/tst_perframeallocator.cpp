@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+#include <QtCore/QThread>
+#include <QtQuick3DRuntimeRender/private/qssgperframeallocator_p.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(const std::function<void()> &inFunction) : m_function(inFunction) {}
+
+protected:
+    void run() override { m_function(); }
+
+private:
+    std::function<void()> m_function;
+};
+
+}
+
+class tst_perframeallocator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void alignment();
+    void frameVector();
+    void manyAllocatorsOneThread();
+    void idleArenaReleased();
+};
+
+void tst_perframeallocator::alignment()
+{
+    QSSGPerFrameAllocator allocator;
+    for (size_t alignment = 1; alignment <= QSSGPerFrameAllocator::MaxAlignment; alignment *= 2) {
+        for (size_t size = 1; size < 100000; size = size * 3 + 1) {
+            void *data = allocator.allocate(size, alignment);
+            QVERIFY(data);
+            QCOMPARE(quintptr(data) % alignment, quintptr(0));
+            memset(data, 0xcd, size);
+        }
+    }
+    allocator.reset();
+    QCOMPARE(allocator.statistics().bytesUsed, size_t(0));
+    QCOMPARE(allocator.statistics().chunkCount, 1);
+}
+
+void tst_perframeallocator::frameVector()
+{
+    QSSGPerFrameAllocator allocator;
+    QSSGFrameVector<int> values(&allocator);
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(i);
+    QSSGFrameVector<int> copy(values);
+    values[0] = -1;
+    QCOMPARE(values.size(), 1000);
+    QCOMPARE(copy.size(), 1000);
+    QCOMPARE(copy.at(0), 0);
+    QCOMPARE(copy.at(999), 999);
+    copy.append(copy);
+    QCOMPARE(copy.size(), 2000);
+    QCOMPARE(copy.at(1999), 999);
+}
+
+// A thread that renders with more allocators than the per thread cache holds
+// must keep using one arena per allocator instead of creating new ones
+void tst_perframeallocator::manyAllocatorsOneThread()
+{
+    const int allocatorCount = 7;
+    std::vector<std::unique_ptr<QSSGPerFrameAllocator>> allocators;
+    for (int i = 0; i < allocatorCount; ++i)
+        allocators.emplace_back(new QSSGPerFrameAllocator);
+
+    for (int frame = 0; frame < 20; ++frame) {
+        for (auto &allocator : allocators) {
+            allocator->reset();
+            for (int i = 0; i < 64; ++i)
+                QVERIFY(allocator->allocate(256));
+        }
+        for (auto &allocator : allocators)
+            QCOMPARE(allocator->statistics().arenaCount, 1);
+    }
+
+    // Another thread gets an arena of its own, once
+    FunctionThread thread([&allocators]() {
+        for (int frame = 0; frame < 5; ++frame) {
+            for (auto &allocator : allocators)
+                allocator->allocate(64);
+        }
+    });
+    thread.start();
+    QVERIFY(thread.wait());
+    for (auto &allocator : allocators)
+        QCOMPARE(allocator->statistics().arenaCount, 2);
+}
+
+void tst_perframeallocator::idleArenaReleased()
+{
+    QSSGPerFrameAllocator allocator;
+    FunctionThread thread([&allocator]() { allocator.allocate(1000); });
+    thread.start();
+    QVERIFY(thread.wait());
+    QCOMPARE(allocator.statistics().chunkCount, 1);
+
+    // Used in the first frame, then idle
+    for (int frame = 0; frame <= 8; ++frame)
+        allocator.reset();
+    QSSGPerFrameAllocator::Statistics stats = allocator.statistics();
+    QCOMPARE(stats.chunkCount, 0);
+    QCOMPARE(stats.bytesReserved, size_t(0));
+    QVERIFY(stats.highWaterMark >= 1000);
+}
+
+QTEST_APPLESS_MAIN(tst_perframeallocator)
+
+#include "tst_perframeallocator.moc"
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/QScopeGuard>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(const std::function<void()> &inFunction) : m_function(inFunction) {}
+
+protected:
+    void run() override { m_function(); }
+
+private:
+    std::function<void()> m_function;
+};
+
+struct TaskCounter
+{
+    QAtomicInt ran;
+    QAtomicInt canceled;
+
+    static void run(void *inUserData) { static_cast<TaskCounter *>(inUserData)->ran.ref(); }
+    static void cancel(void *inUserData) { static_cast<TaskCounter *>(inUserData)->canceled.ref(); }
+};
+
+// Keeps a worker busy until released
+struct BlockingTask
+{
+    QSemaphore started;
+    QSemaphore release;
+
+    static void run(void *inUserData)
+    {
+        auto task = static_cast<BlockingTask *>(inUserData);
+        task->started.release();
+        task->release.acquire();
+    }
+};
+
+const quint64 InlineTaskId = ~quint64(0);
+
+}
+
+class tst_threadpool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void manyExternalThreads();
+    void shortLivedThreads();
+    void cancelQueuedTasks_data();
+    void cancelQueuedTasks();
+};
+
+// More threads than the pool has external deques submit at the same time. None of
+// them may fall back to running its tasks inline.
+void tst_threadpool::manyExternalThreads()
+{
+    QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(2);
+    const int threadCount = 20;
+    const int taskCount = 200;
+    TaskCounter counter;
+    QAtomicInt inlineTasks;
+    QSemaphore submitted;
+    QSemaphore exit;
+
+    std::vector<std::unique_ptr<FunctionThread>> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new FunctionThread([&]() {
+            for (int task = 0; task < taskCount; ++task) {
+                if (pool->addTask(&counter, TaskCounter::run, TaskCounter::cancel) == InlineTaskId)
+                    inlineTasks.ref();
+            }
+            // Stay alive so every thread holds on to its deque
+            submitted.release();
+            exit.acquire();
+        }));
+        threads.back()->start();
+    }
+    submitted.acquire(threadCount);
+    exit.release(threadCount);
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+    QCOMPARE(inlineTasks.load(), 0);
+
+    QTRY_COMPARE(counter.ran.load(), threadCount * taskCount);
+    QCOMPARE(counter.canceled.load(), 0);
+}
+
+// Threads hand their deque back when they exit
+void tst_threadpool::shortLivedThreads()
+{
+    QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(2);
+    TaskCounter counter;
+    QAtomicInt inlineTasks;
+    QAtomicInt rangeSum;
+    const int threadCount = 32;
+    for (int i = 0; i < threadCount; ++i) {
+        FunctionThread thread([&]() {
+            if (pool->addTask(&counter, TaskCounter::run, TaskCounter::cancel) == InlineTaskId)
+                inlineTasks.ref();
+            pool->parallelFor(1000, 10, [&rangeSum](qint32 inBegin, qint32 inEnd) {
+                rangeSum.fetchAndAddRelaxed(inEnd - inBegin);
+            });
+        });
+        thread.start();
+        QVERIFY(thread.wait());
+    }
+    QCOMPARE(inlineTasks.load(), 0);
+    QCOMPARE(rangeSum.load(), threadCount * 1000);
+    QTRY_COMPARE(counter.ran.load(), threadCount);
+}
+
+void tst_threadpool::cancelQueuedTasks_data()
+{
+    QTest::addColumn<int>("otherSubmitters");
+
+    // The submitting thread has an external deque of its own
+    QTest::newRow("deque") << 0;
+    // All external deques are taken, the tasks go to the injection queue
+    QTest::newRow("injected") << 12;
+}
+
+void tst_threadpool::cancelQueuedTasks()
+{
+    QFETCH(int, otherSubmitters);
+
+    const int workerCount = 2;
+    QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(workerCount);
+    BlockingTask blocker;
+    TaskCounter otherCounter;
+    QSemaphore submitted;
+    QSemaphore exit;
+    std::vector<std::unique_ptr<FunctionThread>> others;
+
+    // Unblock everything before the pool goes away, also when a check fails
+    auto cleanup = qScopeGuard([&]() {
+        blocker.release.release(workerCount);
+        exit.release(otherSubmitters);
+        for (auto &thread : others)
+            thread->wait();
+    });
+
+    // Occupy the workers, so nothing that is queued afterwards starts
+    std::vector<quint64> blockerIds;
+    for (int i = 0; i < workerCount; ++i)
+        blockerIds.push_back(pool->addTask(&blocker, BlockingTask::run, nullptr));
+    blocker.started.acquire(workerCount);
+    for (quint64 id : blockerIds) {
+        QCOMPARE(pool->getTaskState(id), TaskStates::Running);
+        QCOMPARE(pool->cancelTask(id), CancelReturnValues::TaskRunning);
+    }
+
+    for (int i = 0; i < otherSubmitters; ++i) {
+        others.emplace_back(new FunctionThread([&]() {
+            pool->addTask(&otherCounter, TaskCounter::run, TaskCounter::cancel);
+            submitted.release();
+            exit.acquire();
+        }));
+        others.back()->start();
+    }
+    submitted.acquire(otherSubmitters);
+
+    const int taskCount = 10;
+    TaskCounter counter;
+    std::vector<quint64> ids;
+    FunctionThread submitter([&]() {
+        for (int i = 0; i < taskCount; ++i)
+            ids.push_back(pool->addTask(&counter, TaskCounter::run, TaskCounter::cancel));
+    });
+    submitter.start();
+    QVERIFY(submitter.wait());
+
+    for (quint64 id : ids) {
+        QVERIFY(id != InlineTaskId);
+        QCOMPARE(pool->getTaskState(id), TaskStates::Queued);
+    }
+    QCOMPARE(counter.ran.load(), 0);
+
+    // Cancel every other task
+    for (int i = 0; i < taskCount; i += 2) {
+        QCOMPARE(pool->cancelTask(ids.at(i)), CancelReturnValues::TaskCanceled);
+        QCOMPARE(pool->getTaskState(ids.at(i)), TaskStates::UnknownTask);
+        QCOMPARE(pool->cancelTask(ids.at(i)), CancelReturnValues::TaskNotFound);
+    }
+    QCOMPARE(counter.canceled.load(), taskCount / 2);
+
+    blocker.release.release(workerCount);
+    QTRY_COMPARE(counter.ran.load(), taskCount / 2);
+    QTRY_COMPARE(otherCounter.ran.load(), otherSubmitters);
+    for (quint64 id : ids)
+        QTRY_COMPARE(pool->getTaskState(id), TaskStates::UnknownTask);
+    QCOMPARE(counter.canceled.load(), taskCount / 2);
+}
+
+QTEST_APPLESS_MAIN(tst_threadpool)
+
+#include "tst_threadpool.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+SUBDIRS = \
+    inputstreamfactory \
+    keyframeanimation \
+    nodehierarchy \
+    perframeallocator \
+    runtimerender \
+    shaderhitch \
+    threadpool
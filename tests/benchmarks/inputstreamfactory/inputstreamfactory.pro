@@ -0,0 +1,7 @@
+CONFIG += benchmark
+CONFIG -= app_bundle
+QT += testlib concurrent quick3druntimerender-private
+
+TARGET = tst_bench_inputstreamfactory
+
+SOURCES += tst_bench_inputstreamfactory.cpp
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFutureSynchronizer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThreadPool>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderassetarchive_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderinputstreamfactory_p.h>
+
+// Opens and reads a large set of small assets from several threads at once,
+// through the file system search paths and through a packed asset archive.
+
+namespace {
+const int assetCount = 10000;
+const int assetsPerDirectory = 100;
+const int assetSize = 512;
+}
+
+class tst_bench_inputstreamfactory : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void openAssets_data();
+    void openAssets();
+
+private:
+    static qint64 openAll(QSSGInputStreamFactory *factory, const QStringList &names, int threadCount);
+
+    QTemporaryDir m_dir;
+    QString m_assetDirectory;
+    QString m_archiveFile;
+    QStringList m_names;
+};
+
+void tst_bench_inputstreamfactory::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_assetDirectory = m_dir.filePath(QStringLiteral("assets"));
+    m_archiveFile = m_dir.filePath(QStringLiteral("assets.qsga"));
+
+    QVector<QPair<QString, QString>> files;
+    const QByteArray contents(assetSize, 'x');
+    for (int i = 0; i < assetCount; ++i) {
+        const QString directory = QStringLiteral("d%1").arg(i / assetsPerDirectory);
+        if (i % assetsPerDirectory == 0)
+            QVERIFY(QDir(m_assetDirectory).mkpath(directory));
+        const QString name = directory + QStringLiteral("/asset%1.mesh").arg(i);
+        const QString path = m_assetDirectory + QLatin1Char('/') + name;
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(contents), qint64(contents.size()));
+        m_names.append(name);
+        files.append(qMakePair(name, path));
+    }
+
+    QString error;
+    QVERIFY2(QSSGAssetArchive::write(m_archiveFile, files, &error), qPrintable(error));
+}
+
+void tst_bench_inputstreamfactory::openAssets_data()
+{
+    QTest::addColumn<bool>("archive");
+    QTest::addColumn<bool>("cached");
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount : { 1, 8 }) {
+        QTest::addRow("filesystem-uncached-%d", threadCount) << false << false << threadCount;
+        QTest::addRow("filesystem-cached-%d", threadCount) << false << true << threadCount;
+        QTest::addRow("archive-%d", threadCount) << true << true << threadCount;
+    }
+}
+
+void tst_bench_inputstreamfactory::openAssets()
+{
+    QFETCH(bool, archive);
+    QFETCH(bool, cached);
+    QFETCH(int, threadCount);
+
+    QSSGRef<QSSGInputStreamFactory> factory(new QSSGInputStreamFactory);
+    if (archive)
+        QVERIFY(factory->addArchive(m_archiveFile));
+    else
+        factory->addSearchDirectory(m_assetDirectory);
+
+    // Also checks that every asset can be found
+    QCOMPARE(openAll(factory.data(), m_names, threadCount), qint64(assetCount) * assetSize);
+
+    QBENCHMARK {
+        if (!cached)
+            factory->invalidatePathCache();
+        openAll(factory.data(), m_names, threadCount);
+    }
+}
+
+qint64 tst_bench_inputstreamfactory::openAll(QSSGInputStreamFactory *factory, const QStringList &names, int threadCount)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    QVector<qint64> bytesRead(threadCount);
+    QFutureSynchronizer<void> synchronizer;
+    const int namesPerThread = (names.size() + threadCount - 1) / threadCount;
+    for (int thread = 0; thread < threadCount; ++thread) {
+        qint64 *bytes = &bytesRead[thread];
+        const int begin = thread * namesPerThread;
+        const int end = qMin(names.size(), begin + namesPerThread);
+        synchronizer.addFuture(QtConcurrent::run(&pool, [factory, &names, bytes, begin, end]() {
+            char buffer[1024];
+            qint64 total = 0;
+            for (int i = begin; i < end; ++i) {
+                QSharedPointer<QIODevice> stream = factory->getStreamForFile(names.at(i), true);
+                if (!stream)
+                    continue;
+                for (qint64 read = stream->read(buffer, sizeof(buffer)); read > 0; read = stream->read(buffer, sizeof(buffer)))
+                    total += read;
+            }
+            *bytes = total;
+        }));
+    }
+    synchronizer.waitForFinished();
+
+    qint64 total = 0;
+    for (qint64 bytes : qAsConst(bytesRead))
+        total += bytes;
+    return total;
+}
+
+QTEST_GUILESS_MAIN(tst_bench_inputstreamfactory)
+
+#include "tst_bench_inputstreamfactory.moc"
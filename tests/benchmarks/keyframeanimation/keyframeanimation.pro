@@ -0,0 +1,7 @@
+CONFIG += benchmark
+CONFIG -= app_bundle
+QT += testlib qml quick3d-private quick3dutils-private
+
+TARGET = tst_bench_keyframeanimation
+
+SOURCES += tst_bench_keyframeanimation.cpp
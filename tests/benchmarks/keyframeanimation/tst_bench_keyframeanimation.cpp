@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlComponent>
+
+#include <QtQuick3D/private/qquick3dnode_p.h>
+#include <QtQuick3D/private/qquick3dkeyframeanimation_p.h>
+#include <QtQuick3DUtils/private/qssgkeyframeanimation_p.h>
+
+// Compares playing the same animation on many nodes through QML Timeline
+// KeyframeGroups, which is what the importers used to generate, with the
+// native KeyframeAnimation. Every node has a position and a rotation track.
+
+static const int nodeCount = 10000;
+static const int keyCount = 4;
+static const float keyInterval = 0.5f; // seconds
+
+static QVector3D keyPosition(int node, int key)
+{
+    return QVector3D(float(node % 100) * 10.0f, float(node / 100) * 10.0f, float(key) * 25.0f);
+}
+
+static QVector3D keyRotation(int node, int key)
+{
+    return QVector3D(0.0f, float((node + key * 45) % 360), 0.0f);
+}
+
+static QSSGKeyframeAnimationData createAnimationData()
+{
+    using Key = QSSGKeyframeAnimationData::Key;
+    using Property = QSSGKeyframeAnimationData::Property;
+
+    QSSGKeyframeAnimationData data;
+    for (int node = 0; node < nodeCount; ++node) {
+        for (int component = 0; component < 6; ++component) {
+            QVector<Key> keys;
+            for (int k = 0; k < keyCount; ++k) {
+                Key key;
+                key.time = float(k) * keyInterval;
+                key.value = component < 3 ? keyPosition(node, k)[component] : keyRotation(node, k)[component - 3];
+                keys.append(key);
+            }
+            QSSGKeyframeAnimationData::setLinearTangents(keys);
+            data.addChannel(quint32(node), Property(int(Property::PositionX) + component),
+                            QSSGKeyframeAnimationData::Interpolation::Hermite, keys);
+        }
+    }
+    return data;
+}
+
+static QByteArray createTimelineQml()
+{
+    QByteArray qml;
+    qml += "import QtQuick 2.12\nimport QtQuick3D 1.0\nimport QtQuick.Timeline 1.0\n";
+    qml += "Node {\n";
+    for (int node = 0; node < nodeCount; ++node)
+        qml += "    Node { id: n" + QByteArray::number(node) + " }\n";
+    qml += "    Timeline {\n        objectName: \"timeline\"\n        enabled: true\n";
+    qml += "        startFrame: 0\n        endFrame: " + QByteArray::number(int((keyCount - 1) * keyInterval * 1000)) + "\n";
+    auto vector = [](const QVector3D &v) {
+        return "Qt.vector3d(" + QByteArray::number(v.x()) + ", " + QByteArray::number(v.y()) + ", "
+                + QByteArray::number(v.z()) + ")";
+    };
+    for (int node = 0; node < nodeCount; ++node) {
+        for (int property = 0; property < 2; ++property) {
+            qml += "        KeyframeGroup {\n            target: n" + QByteArray::number(node) + "\n";
+            qml += property == 0 ? "            property: \"position\"\n" : "            property: \"rotation\"\n";
+            for (int k = 0; k < keyCount; ++k) {
+                const QVector3D value = property == 0 ? keyPosition(node, k) : keyRotation(node, k);
+                qml += "            Keyframe { frame: " + QByteArray::number(int(float(k) * keyInterval * 1000))
+                        + "; value: " + vector(value) + " }\n";
+            }
+            qml += "        }\n";
+        }
+    }
+    qml += "    }\n}\n";
+    return qml;
+}
+
+class tst_bench_keyframeanimation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void evaluate();
+    void timeline();
+    void keyframeAnimation();
+
+private:
+    const int m_frames = 60;
+};
+
+// The evaluator alone, without writing the values to any node
+void tst_bench_keyframeanimation::evaluate()
+{
+    const QSSGKeyframeAnimationData data = createAnimationData();
+    QSSGKeyframeEvaluator evaluator;
+    evaluator.setAnimation(&data);
+    QVector<float> values(data.channels.size());
+
+    const float duration = data.duration;
+    QBENCHMARK {
+        for (int frame = 0; frame < m_frames; ++frame)
+            evaluator.evaluate(duration * float(frame) / float(m_frames), values.data());
+    }
+}
+
+void tst_bench_keyframeanimation::timeline()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(createTimelineQml(), QUrl());
+    QScopedPointer<QObject> root(component.create());
+    if (!root)
+        QSKIP(qPrintable(QStringLiteral("QtQuick.Timeline is not available: ") + component.errorString()));
+    QObject *timeline = root->findChild<QObject *>(QStringLiteral("timeline"));
+    QVERIFY(timeline);
+
+    const qreal endFrame = timeline->property("endFrame").toReal();
+    QBENCHMARK {
+        for (int frame = 0; frame < m_frames; ++frame)
+            timeline->setProperty("currentFrame", endFrame * frame / m_frames);
+    }
+}
+
+void tst_bench_keyframeanimation::keyframeAnimation()
+{
+    QQuick3DNode root;
+    QQuick3DKeyframeAnimation animation;
+    QQmlListProperty<QQuick3DNode> targets = animation.targets();
+    for (int node = 0; node < nodeCount; ++node) {
+        auto target = new QQuick3DNode;
+        target->setParent(&root);
+        targets.append(&targets, target);
+    }
+    animation.setAnimationData(createAnimationData());
+
+    const qreal duration = animation.duration();
+    QBENCHMARK {
+        for (int frame = 0; frame < m_frames; ++frame)
+            animation.seek(duration * frame / m_frames);
+    }
+}
+
+QTEST_MAIN(tst_bench_keyframeanimation)
+
+#include "tst_bench_keyframeanimation.moc"
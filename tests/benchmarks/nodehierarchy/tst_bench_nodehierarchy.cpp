@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernode_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendernodehierarchy_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+
+// Compares updating the global transforms of a large node tree through the parent
+// pointers of the render nodes with the flattened QSSGRenderNodeHierarchy.
+
+class NodeTree
+{
+public:
+    NodeTree(int nodeCount, int branching);
+    ~NodeTree() { qDeleteAll(m_nodes); }
+
+    // Moves the top level nodes, which dirties the whole tree
+    void animate();
+
+    QSSGRenderLayer &layer() { return m_layer; }
+    const QVector<QSSGRenderNode *> &nodes() const { return m_nodes; }
+
+private:
+    QSSGRenderLayer m_layer;
+    QVector<QSSGRenderNode *> m_nodes;
+    int m_topLevelCount;
+};
+
+NodeTree::NodeTree(int nodeCount, int branching)
+    : m_topLevelCount(qMin(branching, nodeCount))
+{
+    m_nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        auto node = new QSSGRenderNode;
+        node->position = QVector3D(float(i % 17), float(i % 13), float(i % 11));
+        node->rotation = QVector3D(0.0f, float(i % 7) * 0.1f, 0.0f);
+        node->scale = QVector3D(1.01f, 1.01f, 1.01f);
+        if (i < branching)
+            m_layer.addChild(*node);
+        else
+            m_nodes.at(i / branching - 1)->addChild(*node);
+        m_nodes.append(node);
+    }
+}
+
+void NodeTree::animate()
+{
+    for (int i = 0; i < m_topLevelCount; ++i) {
+        QSSGRenderNode *node = m_nodes.at(i);
+        node->rotation.setY(node->rotation.y() + 0.01f);
+        node->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    }
+}
+
+class tst_bench_nodehierarchy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void sameResult();
+    void pointerUpdate_data();
+    void pointerUpdate();
+    void hierarchyUpdate_data();
+    void hierarchyUpdate();
+    void hierarchyUpdateThreaded_data();
+    void hierarchyUpdateThreaded();
+    void hierarchyBuild_data();
+    void hierarchyBuild();
+
+private:
+    void treeData();
+
+    QSSGRef<QSSGAbstractThreadPool> m_threadPool;
+};
+
+void tst_bench_nodehierarchy::initTestCase()
+{
+    m_threadPool = QSSGAbstractThreadPool::createThreadPool(QThread::idealThreadCount());
+    QVERIFY(m_threadPool);
+}
+
+void tst_bench_nodehierarchy::treeData()
+{
+    QTest::addColumn<int>("nodes");
+    QTest::addColumn<int>("branching");
+
+    QTest::newRow("100k deep") << 100000 << 2;
+    QTest::newRow("100k wide") << 100000 << 64;
+}
+
+void tst_bench_nodehierarchy::sameResult()
+{
+    NodeTree pointerTree(10000, 3);
+    NodeTree flatTree(10000, 3);
+    pointerTree.animate();
+    flatTree.animate();
+
+    for (QSSGRenderNode *node : pointerTree.nodes())
+        node->calculateGlobalVariables();
+    QSSGRenderNodeHierarchy hierarchy;
+    hierarchy.build(flatTree.layer());
+    QVERIFY(hierarchy.update(m_threadPool));
+    QVERIFY(!hierarchy.update(m_threadPool));
+
+    for (int i = 0; i < pointerTree.nodes().size(); ++i) {
+        const QSSGRenderNode *expected = pointerTree.nodes().at(i);
+        const QSSGRenderNode *actual = flatTree.nodes().at(i);
+        QVERIFY(!actual->flags.testFlag(QSSGRenderNode::Flag::Dirty));
+        QVERIFY(qFuzzyCompare(actual->globalTransform, expected->globalTransform));
+        QCOMPARE(actual->flags.testFlag(QSSGRenderNode::Flag::GloballyActive),
+                 expected->flags.testFlag(QSSGRenderNode::Flag::GloballyActive));
+    }
+    QCOMPARE(hierarchy.depthFirstOrder().size(), flatTree.nodes().size());
+}
+
+void tst_bench_nodehierarchy::pointerUpdate_data()
+{
+    treeData();
+}
+
+void tst_bench_nodehierarchy::pointerUpdate()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, branching);
+    NodeTree tree(nodes, branching);
+
+    QBENCHMARK {
+        tree.animate();
+        for (QSSGRenderNode *node : tree.nodes())
+            node->calculateGlobalVariables();
+    }
+}
+
+void tst_bench_nodehierarchy::hierarchyUpdate_data()
+{
+    treeData();
+}
+
+void tst_bench_nodehierarchy::hierarchyUpdate()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, branching);
+    NodeTree tree(nodes, branching);
+    QSSGRenderNodeHierarchy hierarchy;
+    hierarchy.build(tree.layer());
+
+    QBENCHMARK {
+        tree.animate();
+        hierarchy.update();
+    }
+}
+
+void tst_bench_nodehierarchy::hierarchyUpdateThreaded_data()
+{
+    treeData();
+}
+
+void tst_bench_nodehierarchy::hierarchyUpdateThreaded()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, branching);
+    NodeTree tree(nodes, branching);
+    QSSGRenderNodeHierarchy hierarchy;
+    hierarchy.build(tree.layer());
+
+    QBENCHMARK {
+        tree.animate();
+        hierarchy.update(m_threadPool);
+    }
+}
+
+void tst_bench_nodehierarchy::hierarchyBuild_data()
+{
+    treeData();
+}
+
+void tst_bench_nodehierarchy::hierarchyBuild()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, branching);
+    NodeTree tree(nodes, branching);
+    QSSGRenderNodeHierarchy hierarchy;
+
+    QBENCHMARK {
+        hierarchy.build(tree.layer());
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_nodehierarchy)
+
+#include "tst_bench_nodehierarchy.moc"
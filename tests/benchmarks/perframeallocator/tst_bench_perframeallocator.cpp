@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+
+#include <QtQuick3DRuntimeRender/private/qssgperframeallocator_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+
+// Measures QSSGPerFrameAllocator against the heap for the allocation pattern of
+// the render preparation: many small objects and lists that are all thrown
+// away at the end of the frame.
+
+namespace {
+
+struct Renderable
+{
+    float worldCenter[3];
+    float cameraDistanceSq;
+    void *model;
+    void *material;
+    quint32 flags;
+};
+
+}
+
+class tst_bench_perframeallocator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void smallAllocations_data();
+    void smallAllocations();
+    void smallAllocationsHeap_data();
+    void smallAllocationsHeap();
+    void frameVector();
+    void frameVectorQVector();
+    void threadedAllocations();
+    void steadyState();
+
+private:
+    void allocationCountData();
+};
+
+void tst_bench_perframeallocator::allocationCountData()
+{
+    QTest::addColumn<int>("allocations");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+}
+
+void tst_bench_perframeallocator::smallAllocations_data()
+{
+    allocationCountData();
+}
+
+void tst_bench_perframeallocator::smallAllocations()
+{
+    QFETCH(int, allocations);
+    QSSGPerFrameAllocator allocator;
+
+    QBENCHMARK {
+        for (int i = 0; i < allocations; ++i)
+            new (allocator.allocate(sizeof(Renderable))) Renderable();
+        allocator.reset();
+    }
+}
+
+void tst_bench_perframeallocator::smallAllocationsHeap_data()
+{
+    allocationCountData();
+}
+
+// The same as smallAllocations() with every object allocated and deleted on the heap
+void tst_bench_perframeallocator::smallAllocationsHeap()
+{
+    QFETCH(int, allocations);
+    QVector<Renderable *> objects(allocations);
+
+    QBENCHMARK {
+        for (int i = 0; i < allocations; ++i)
+            objects[i] = new Renderable();
+        qDeleteAll(objects);
+    }
+}
+
+void tst_bench_perframeallocator::frameVector()
+{
+    QSSGPerFrameAllocator allocator;
+    Renderable renderable;
+
+    QBENCHMARK {
+        QSSGFrameVector<Renderable *> objects(&allocator);
+        for (int i = 0; i < 10000; ++i)
+            objects.push_back(&renderable);
+        QSSGFrameVector<Renderable *> sorted(objects);
+        QCOMPARE(sorted.size(), 10000);
+        allocator.reset();
+    }
+}
+
+// The same as frameVector() with the QVectors the layer used to keep
+void tst_bench_perframeallocator::frameVectorQVector()
+{
+    Renderable renderable;
+
+    QBENCHMARK {
+        QVector<Renderable *> objects;
+        for (int i = 0; i < 10000; ++i)
+            objects.push_back(&renderable);
+        QVector<Renderable *> sorted(objects);
+        sorted.detach();
+        QCOMPARE(sorted.size(), 10000);
+    }
+}
+
+// Allocations from the workers of the thread pool go to per thread arenas and do not contend
+void tst_bench_perframeallocator::threadedAllocations()
+{
+    const QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(4);
+    QSSGPerFrameAllocator allocator;
+
+    QBENCHMARK {
+        pool->parallelFor(100000, 1024, [&allocator](qint32 inBegin, qint32 inEnd) {
+            for (qint32 i = inBegin; i < inEnd; ++i)
+                new (allocator.allocate(sizeof(Renderable))) Renderable();
+        });
+        allocator.reset();
+    }
+}
+
+// After a few frames of the same size every arena is down to a single chunk
+void tst_bench_perframeallocator::steadyState()
+{
+    QSSGPerFrameAllocator allocator;
+
+    for (int frame = 0; frame < 4; ++frame) {
+        for (int i = 0; i < 100000; ++i)
+            allocator.allocate(sizeof(Renderable));
+        allocator.reset();
+    }
+    const QSSGPerFrameAllocator::Statistics stats = allocator.statistics();
+    QCOMPARE(stats.arenaCount, 1);
+    QCOMPARE(stats.chunkCount, 1);
+    QVERIFY(stats.highWaterMark >= 100000 * sizeof(Renderable));
+
+    QBENCHMARK {
+        for (int i = 0; i < 100000; ++i)
+            allocator.allocate(sizeof(Renderable));
+        allocator.reset();
+    }
+    QCOMPARE(allocator.statistics().chunkCount, 1);
+}
+
+QTEST_GUILESS_MAIN(tst_bench_perframeallocator)
+
+#include "tst_bench_perframeallocator.moc"
@@ -0,0 +1,419 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/qmath.h>
+
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercamera_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlight_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendermodel_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderdefaultmaterial_p.h>
+#include <QtQuick3DUtils/private/qssgperftimer_p.h>
+
+// Benchmarks the CPU side of the runtime renderer on the null render backend,
+// so it runs on machines without a GPU.
+//
+// The benchmark results are reported through QTest, use e.g. "-o result.xml,xml"
+// to get them in a machine readable form. In addition, the QSSGPerfTimer stage
+// timings of each row are written as JSON to the file named by the
+// QUICK3D_BENCHMARK_STAGES environment variable.
+
+class SyntheticScene
+{
+public:
+    SyntheticScene(int modelCount, int lightCount, int materialCount, int depth);
+    ~SyntheticScene() { qDeleteAll(m_objects); }
+
+    QSSGRenderLayer *layer() const { return m_layer; }
+    // Move every model so the next frame has to recompute the transforms
+    void animate();
+
+private:
+    template<typename T>
+    T *create()
+    {
+        T *object = new T;
+        m_objects.append(object);
+        return object;
+    }
+
+    QVector<QSSGRenderGraphObject *> m_objects;
+    QVector<QSSGRenderModel *> m_models;
+    QSSGRenderLayer *m_layer = nullptr;
+};
+
+SyntheticScene::SyntheticScene(int modelCount, int lightCount, int materialCount, int depth)
+{
+    m_layer = create<QSSGRenderLayer>();
+    m_layer->background = QSSGRenderLayer::Background::Color;
+    m_layer->clearColor = QVector3D(0.0f, 0.0f, 0.0f);
+    m_layer->m_width = 100.f;
+    m_layer->m_height = 100.f;
+    m_layer->widthUnits = QSSGRenderLayer::UnitType::Percent;
+    m_layer->heightUnits = QSSGRenderLayer::UnitType::Percent;
+
+    auto camera = create<QSSGRenderCamera>();
+    camera->clipFar = 100000.0f;
+    m_layer->addChild(*camera);
+    camera->lookAt(QVector3D(0.0f, 0.0f, -2000.0f), QVector3D(0.0f, 1.0f, 0.0f), QVector3D(0.0f, 0.0f, 0.0f));
+
+    static const QSSGRenderLight::Type lightTypes[] = { QSSGRenderLight::Type::Directional,
+                                                        QSSGRenderLight::Type::Point,
+                                                        QSSGRenderLight::Type::Area };
+    for (int i = 0; i < lightCount; ++i) {
+        auto light = create<QSSGRenderLight>();
+        light->m_lightType = lightTypes[i % 3];
+        light->position = QVector3D(float(i * 100), 500.0f, -500.0f);
+        m_layer->addChild(*light);
+    }
+
+    // Vary the features used by the materials so they end up with different
+    // shader keys
+    QVector<QSSGRenderDefaultMaterial *> materials;
+    for (int i = 0; i < materialCount; ++i) {
+        auto material = create<QSSGRenderDefaultMaterial>();
+        material->diffuseColor = QVector3D(float(i % 7) / 7.0f, float(i % 5) / 5.0f, float(i % 3) / 3.0f);
+        material->lighting = (i & 1) ? QSSGRenderDefaultMaterial::MaterialLighting::FragmentLighting
+                                     : QSSGRenderDefaultMaterial::MaterialLighting::VertexLighting;
+        material->specularAmount = (i & 2) ? 0.5f : 0.0f;
+        material->opacity = (i % 4 == 3) ? 0.5f : 1.0f;
+        material->vertexColors = (i & 4) != 0;
+        materials.append(material);
+    }
+
+    // Models hang off a handful of node chains, depth levels deep
+    const int chainCount = qMax(1, qMin(modelCount, 16));
+    QVector<QSSGRenderNode *> chainEnds;
+    for (int i = 0; i < chainCount; ++i) {
+        QSSGRenderNode *parent = m_layer;
+        for (int level = 0; level < depth; ++level) {
+            auto node = create<QSSGRenderNode>();
+            node->position = QVector3D(0.0f, 0.0f, 1.0f);
+            parent->addChild(*node);
+            parent = node;
+        }
+        chainEnds.append(parent);
+    }
+
+    static const QString meshes[] = { QStringLiteral("#Cube"), QStringLiteral("#Sphere"),
+                                      QStringLiteral("#Cylinder"), QStringLiteral("#Cone") };
+    const int gridSize = qCeil(qSqrt(qreal(modelCount)));
+    for (int i = 0; i < modelCount; ++i) {
+        auto model = create<QSSGRenderModel>();
+        model->meshPath = QSSGRenderMeshPath::create(meshes[i % 4]);
+        model->position = QVector3D(float(i % gridSize - gridSize / 2) * 120.0f,
+                                    float(i / gridSize - gridSize / 2) * 120.0f,
+                                    0.0f);
+        model->scale = QVector3D(0.5f, 0.5f, 0.5f);
+        if (!materials.isEmpty())
+            model->materials.append(materials.at(i % materials.size()));
+        chainEnds.at(i % chainCount)->addChild(*model);
+        m_models.append(model);
+    }
+}
+
+void SyntheticScene::animate()
+{
+    for (QSSGRenderModel *model : qAsConst(m_models)) {
+        model->rotation.setY(model->rotation.y() + 0.01f);
+        model->markDirty(QSSGRenderNode::TransformDirtyFlag::TransformIsDirty);
+    }
+}
+
+class tst_bench_runtimerender : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void prepareLayer_data();
+    void prepareLayer();
+    void frame_data();
+    void frame();
+    void pick_data();
+    void pick();
+    void pickBatch_data();
+    void pickBatch();
+    void loadMesh();
+
+private:
+    void sceneData();
+    void beginFrame();
+    void endFrame();
+    void renderFrame(QSSGRenderLayer &layer);
+    QVector<QVector2D> pickPositions() const;
+
+    const QSize m_surfaceSize { 1280, 720 };
+    QSSGRef<QSSGRenderContext> m_renderContext;
+    QSSGRenderContextInterface::QSSGRenderContextInterfacePtr m_context;
+    QJsonObject m_stages;
+};
+
+void tst_bench_runtimerender::initTestCase()
+{
+    m_renderContext = QSSGRenderContext::createNull();
+    QVERIFY(m_renderContext);
+    m_context = QSSGRenderContextInterface::getRenderContextInterface(m_renderContext, QString(), quintptr(this));
+    QVERIFY(!m_context.isNull());
+    m_context->setPresentationDimensions(m_surfaceSize);
+    m_context->setWindowDimensions(m_surfaceSize);
+    m_context->performanceTimer()->setEnabled(true);
+}
+
+void tst_bench_runtimerender::cleanupTestCase()
+{
+    const QString fileName = qEnvironmentVariable("QUICK3D_BENCHMARK_STAGES");
+    if (fileName.isEmpty())
+        return;
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(file.errorString()));
+    file.write(QJsonDocument(m_stages).toJson());
+}
+
+// Collects the stage timings of the row that just finished
+void tst_bench_runtimerender::cleanup()
+{
+    QSSGPerfTimer *timer = m_context->performanceTimer();
+    const int frames = qMax(1, timer->frames());
+    QJsonArray stages;
+    for (const QSSGPerfTimer::Entry &entry : timer->snapshot()) {
+        if (!entry.count)
+            continue;
+        QJsonObject stage;
+        stage.insert(QStringLiteral("stage"), entry.tag);
+        stage.insert(QStringLiteral("msecsPerFrame"), double(entry.totalTime) / 1000000.0 / frames);
+        stage.insert(QStringLiteral("maxMsecs"), double(entry.maxTime) / 1000000.0);
+        stage.insert(QStringLiteral("hits"), double(entry.count));
+        stages.append(stage);
+    }
+    if (!stages.isEmpty()) {
+        QString key = QString::fromLatin1(QTest::currentTestFunction());
+        if (QTest::currentDataTag())
+            key += QLatin1Char(':') + QString::fromLatin1(QTest::currentDataTag());
+        QJsonObject row;
+        row.insert(QStringLiteral("frames"), frames);
+        row.insert(QStringLiteral("stages"), stages);
+        m_stages.insert(key, row);
+    }
+    timer->reset();
+}
+
+void tst_bench_runtimerender::sceneData()
+{
+    QTest::addColumn<int>("models");
+    QTest::addColumn<int>("lights");
+    QTest::addColumn<int>("materials");
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("small") << 100 << 1 << 4 << 1;
+    QTest::newRow("medium") << 1000 << 4 << 16 << 4;
+    QTest::newRow("large") << 5000 << 8 << 32 << 8;
+    QTest::newRow("deep") << 1000 << 2 << 8 << 32;
+}
+
+void tst_bench_runtimerender::beginFrame()
+{
+    m_context->beginFrame();
+    m_renderContext->setRenderTarget(nullptr);
+    m_context->renderList()->setViewport(QRect(QPoint(0, 0), m_surfaceSize));
+}
+
+void tst_bench_runtimerender::endFrame()
+{
+    m_context->endFrame();
+}
+
+void tst_bench_runtimerender::renderFrame(QSSGRenderLayer &layer)
+{
+    const QSSGRef<QSSGRendererInterface> &renderer = m_context->renderer();
+    beginFrame();
+    renderer->prepareLayerForRender(layer, m_surfaceSize, false, nullptr, true);
+    m_context->runRenderTasks();
+    renderer->renderLayer(layer, m_surfaceSize, true, QVector3D(0, 0, 0), false);
+    endFrame();
+}
+
+// A grid of positions over the whole surface, like a drag sweeping over the scene
+QVector<QVector2D> tst_bench_runtimerender::pickPositions() const
+{
+    QVector<QVector2D> positions;
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x)
+            positions.append(QVector2D((x + 0.5f) * m_surfaceSize.width() / 16, (y + 0.5f) * m_surfaceSize.height() / 16));
+    }
+    return positions;
+}
+
+void tst_bench_runtimerender::prepareLayer_data()
+{
+    sceneData();
+}
+
+void tst_bench_runtimerender::prepareLayer()
+{
+    QFETCH(int, models);
+    QFETCH(int, lights);
+    QFETCH(int, materials);
+    QFETCH(int, depth);
+
+    SyntheticScene scene(models, lights, materials, depth);
+    const QSSGRef<QSSGRendererInterface> &renderer = m_context->renderer();
+
+    // Warm up the mesh and shader caches
+    beginFrame();
+    renderer->prepareLayerForRender(*scene.layer(), m_surfaceSize, false, nullptr, true);
+    endFrame();
+    m_context->performanceTimer()->reset();
+
+    QBENCHMARK {
+        scene.animate();
+        beginFrame();
+        renderer->prepareLayerForRender(*scene.layer(), m_surfaceSize, false, nullptr, true);
+        endFrame();
+    }
+}
+
+void tst_bench_runtimerender::frame_data()
+{
+    sceneData();
+}
+
+void tst_bench_runtimerender::frame()
+{
+    QFETCH(int, models);
+    QFETCH(int, lights);
+    QFETCH(int, materials);
+    QFETCH(int, depth);
+
+    SyntheticScene scene(models, lights, materials, depth);
+    const QSSGRef<QSSGRendererInterface> &renderer = m_context->renderer();
+
+    renderFrame(*scene.layer());
+    m_context->performanceTimer()->reset();
+
+    QBENCHMARK {
+        scene.animate();
+        renderFrame(*scene.layer());
+    }
+}
+
+void tst_bench_runtimerender::pick_data()
+{
+    sceneData();
+}
+
+// 256 positions picked one at a time
+void tst_bench_runtimerender::pick()
+{
+    QFETCH(int, models);
+    QFETCH(int, lights);
+    QFETCH(int, materials);
+    QFETCH(int, depth);
+
+    SyntheticScene scene(models, lights, materials, depth);
+    const QSSGRef<QSSGRendererInterface> &renderer = m_context->renderer();
+    renderFrame(*scene.layer());
+    const QVector<QVector2D> positions = pickPositions();
+    const QVector2D viewport(m_surfaceSize.width(), m_surfaceSize.height());
+
+    QBENCHMARK {
+        for (const QVector2D &position : positions)
+            renderer->pick(*scene.layer(), viewport, position, false, true);
+    }
+}
+
+void tst_bench_runtimerender::pickBatch_data()
+{
+    sceneData();
+}
+
+// The same positions as pick() in one batch. The per object data is set up by the
+// first batch after a frame, the later ones share it.
+void tst_bench_runtimerender::pickBatch()
+{
+    QFETCH(int, models);
+    QFETCH(int, lights);
+    QFETCH(int, materials);
+    QFETCH(int, depth);
+
+    SyntheticScene scene(models, lights, materials, depth);
+    const QSSGRef<QSSGRendererInterface> &renderer = m_context->renderer();
+    renderFrame(*scene.layer());
+    const QVector<QVector2D> positions = pickPositions();
+    const QVector2D viewport(m_surfaceSize.width(), m_surfaceSize.height());
+
+    // The nearest hit of every ray is what pick() finds
+    const QSSGRenderPickBatchResult result = renderer->pickBatch(*scene.layer(), viewport, positions, true);
+    QCOMPARE(result.rayCount(), positions.size());
+    for (int ray = 0; ray < positions.size(); ++ray) {
+        const QSSGRenderPickResult single = renderer->pick(*scene.layer(), viewport, positions.at(ray), false, true);
+        if (single.m_hitObject) {
+            QVERIFY(result.hitCount(ray) > 0);
+            QCOMPARE(result.hit(ray, 0).m_cameraDistanceSq, single.m_cameraDistanceSq);
+        } else {
+            QCOMPARE(result.hitCount(ray), 0);
+        }
+    }
+
+    QBENCHMARK {
+        renderer->pickBatch(*scene.layer(), viewport, positions, true);
+    }
+}
+
+void tst_bench_runtimerender::loadMesh()
+{
+    const QSSGRef<QSSGBufferManager> &bufferManager = m_context->bufferManager();
+    const QSSGRenderMeshPath meshes[] = { QSSGRenderMeshPath::create(QStringLiteral("#Cube")),
+                                         QSSGRenderMeshPath::create(QStringLiteral("#Sphere")),
+                                         QSSGRenderMeshPath::create(QStringLiteral("#Cylinder")),
+                                         QSSGRenderMeshPath::create(QStringLiteral("#Cone")),
+                                         QSSGRenderMeshPath::create(QStringLiteral("#Rectangle")) };
+
+    QBENCHMARK {
+        bufferManager->clear();
+        for (const QSSGRenderMeshPath &mesh : meshes)
+            QVERIFY(bufferManager->loadMesh(mesh));
+        m_context->performanceTimer()->newFrame();
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_runtimerender)
+
+#include "tst_bench_runtimerender.moc"
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/QElapsedTimer>
+
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercontextcore_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendercamera_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlight_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendermodel_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderdefaultmaterial_p.h>
+
+// Measures the hitches caused by shader generation while a material heavy scene
+// streams in. Every frame a batch of models with materials that have not been seen
+// before is added to the layer, the result is the number of frames that took longer
+// than the frame budget.
+//
+// The rows compare the synchronous path with the asynchronous one, which generates
+// the shaders on the thread pool and draws with an already compiled variant until
+// they are ready (see QUICK3D_ASYNC_SHADERS).
+
+static const qint64 frameBudgetNSecs = 16666667;
+
+class MaterialScene
+{
+public:
+    MaterialScene();
+    ~MaterialScene() { qDeleteAll(m_objects); }
+
+    QSSGRenderLayer *layer() const { return m_layer; }
+    bool isComplete() const { return m_added == materialCount(); }
+    // Adds the next count models, each with a material of its own
+    void addModels(int count);
+
+    static int materialCount() { return 3 * 2 * 3 * 2 * 2 * 2; }
+
+private:
+    template<typename T>
+    T *create()
+    {
+        T *object = new T;
+        m_objects.append(object);
+        return object;
+    }
+
+    QVector<QSSGRenderGraphObject *> m_objects;
+    QSSGRenderLayer *m_layer = nullptr;
+    int m_added = 0;
+};
+
+MaterialScene::MaterialScene()
+{
+    m_layer = create<QSSGRenderLayer>();
+    m_layer->background = QSSGRenderLayer::Background::Color;
+    m_layer->clearColor = QVector3D(0.0f, 0.0f, 0.0f);
+    m_layer->m_width = 100.f;
+    m_layer->m_height = 100.f;
+    m_layer->widthUnits = QSSGRenderLayer::UnitType::Percent;
+    m_layer->heightUnits = QSSGRenderLayer::UnitType::Percent;
+
+    auto camera = create<QSSGRenderCamera>();
+    camera->clipFar = 100000.0f;
+    m_layer->addChild(*camera);
+    camera->lookAt(QVector3D(0.0f, 0.0f, -2000.0f), QVector3D(0.0f, 1.0f, 0.0f), QVector3D(0.0f, 0.0f, 0.0f));
+
+    auto directional = create<QSSGRenderLight>();
+    directional->m_lightType = QSSGRenderLight::Type::Directional;
+    m_layer->addChild(*directional);
+    auto point = create<QSSGRenderLight>();
+    point->m_lightType = QSSGRenderLight::Type::Point;
+    point->position = QVector3D(0.0f, 500.0f, -500.0f);
+    m_layer->addChild(*point);
+}
+
+void MaterialScene::addModels(int count)
+{
+    static const QSSGRenderDefaultMaterial::MaterialLighting lightings[] = {
+        QSSGRenderDefaultMaterial::MaterialLighting::NoLighting,
+        QSSGRenderDefaultMaterial::MaterialLighting::VertexLighting,
+        QSSGRenderDefaultMaterial::MaterialLighting::FragmentLighting
+    };
+    static const QSSGRenderDefaultMaterial::MaterialSpecularModel specularModels[] = {
+        QSSGRenderDefaultMaterial::MaterialSpecularModel::Default,
+        QSSGRenderDefaultMaterial::MaterialSpecularModel::KGGX,
+        QSSGRenderDefaultMaterial::MaterialSpecularModel::KWard
+    };
+
+    // Every combination of these gives a different shader key
+    for (const int end = qMin(m_added + count, materialCount()); m_added < end; ++m_added) {
+        int bits = m_added;
+        auto material = create<QSSGRenderDefaultMaterial>();
+        material->lighting = lightings[bits % 3];
+        bits /= 3;
+        material->specularAmount = (bits % 2) ? 0.5f : 0.0f;
+        bits /= 2;
+        material->specularModel = specularModels[bits % 3];
+        bits /= 3;
+        material->fresnelPower = (bits % 2) ? 1.0f : 0.0f;
+        bits /= 2;
+        material->vertexColors = (bits % 2) != 0;
+        bits /= 2;
+        material->opacity = (bits % 2) ? 0.5f : 1.0f;
+
+        auto model = create<QSSGRenderModel>();
+        model->meshPath = QSSGRenderMeshPath::create(QStringLiteral("#Sphere"));
+        model->position = QVector3D(float(m_added % 12 - 6) * 120.0f, float(m_added / 12 - 6) * 120.0f, 0.0f);
+        model->scale = QVector3D(0.5f, 0.5f, 0.5f);
+        model->materials.append(material);
+        m_layer->addChild(*model);
+    }
+}
+
+class tst_bench_shaderhitch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sceneLoad_data();
+    void sceneLoad();
+
+private:
+    const QSize m_surfaceSize { 1280, 720 };
+};
+
+void tst_bench_shaderhitch::sceneLoad_data()
+{
+    QTest::addColumn<bool>("async");
+    QTest::addColumn<int>("modelsPerFrame");
+
+    QTest::newRow("sync, 4 per frame") << false << 4;
+    QTest::newRow("async, 4 per frame") << true << 4;
+    QTest::newRow("sync, 16 per frame") << false << 16;
+    QTest::newRow("async, 16 per frame") << true << 16;
+}
+
+void tst_bench_shaderhitch::sceneLoad()
+{
+    QFETCH(bool, async);
+    QFETCH(int, modelsPerFrame);
+
+    // The renderer picks the mode up when it is created, so every row gets a context
+    // with empty caches of its own
+    qputenv("QUICK3D_ASYNC_SHADERS", async ? "1" : "0");
+    static quintptr rowId = 0;
+    const quintptr wid = quintptr(this) + ++rowId;
+    const QSSGRef<QSSGRenderContext> renderContext = QSSGRenderContext::createNull();
+    QVERIFY(renderContext);
+    {
+        auto context = QSSGRenderContextInterface::getRenderContextInterface(renderContext, QString(), wid);
+        QVERIFY(!context.isNull());
+        context->setPresentationDimensions(m_surfaceSize);
+        context->setWindowDimensions(m_surfaceSize);
+        const QSSGRef<QSSGRendererInterface> &renderer = context->renderer();
+
+        MaterialScene scene;
+        int frames = 0;
+        int framesOverBudget = 0;
+        qint64 longestFrame = 0;
+        QElapsedTimer timer;
+        do {
+            scene.addModels(modelsPerFrame);
+            timer.start();
+            context->beginFrame();
+            renderContext->setRenderTarget(nullptr);
+            context->renderList()->setViewport(QRect(QPoint(0, 0), m_surfaceSize));
+            renderer->prepareLayerForRender(*scene.layer(), m_surfaceSize, false, nullptr, true);
+            context->runRenderTasks();
+            renderer->renderLayer(*scene.layer(), m_surfaceSize, true, QVector3D(0, 0, 0), false);
+            context->endFrame();
+            const qint64 elapsed = timer.nsecsElapsed();
+            ++frames;
+            if (elapsed > frameBudgetNSecs)
+                ++framesOverBudget;
+            longestFrame = qMax(longestFrame, elapsed);
+        } while (!scene.isComplete() || renderer->hasPendingShaders());
+
+        qInfo("%d of %d frames over budget, longest frame %.2f ms",
+              framesOverBudget, frames, double(longestFrame) / 1000000.0);
+        QTest::setBenchmarkResult(framesOverBudget, QTest::Events);
+    }
+    QSSGRenderContextInterface::releaseRenderContextInterface(wid);
+    qunsetenv("QUICK3D_ASYNC_SHADERS");
+}
+
+QTEST_GUILESS_MAIN(tst_bench_shaderhitch)
+
+#include "tst_bench_shaderhitch.moc"
@@ -0,0 +1,7 @@
+CONFIG += benchmark
+CONFIG -= app_bundle
+QT += testlib quick3druntimerender-private
+
+TARGET = tst_bench_threadpool
+
+SOURCES += tst_bench_threadpool.cpp
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/qmath.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderthreadpool_p.h>
+
+// Measures the overhead of QSSGAbstractThreadPool for fine grained work: the
+// throughput of empty tasks, compared with QThreadPool, and how parallelFor
+// scales with the number of workers.
+
+namespace {
+
+struct EmptyTaskCounter
+{
+    QAtomicInt finished;
+};
+
+void countTask(void *inUserData)
+{
+    static_cast<EmptyTaskCounter *>(inUserData)->finished.ref();
+}
+
+class EmptyRunnable : public QRunnable
+{
+public:
+    explicit EmptyRunnable(EmptyTaskCounter *inCounter) : m_counter(inCounter) {}
+    void run() override { m_counter->finished.ref(); }
+
+private:
+    EmptyTaskCounter *m_counter;
+};
+
+void waitFor(const EmptyTaskCounter &inCounter, int inCount)
+{
+    while (inCounter.finished.loadAcquire() < inCount)
+        QThread::yieldCurrentThread();
+}
+
+}
+
+class tst_bench_threadpool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyTasks_data();
+    void emptyTasks();
+    void emptyTasksQThreadPool_data();
+    void emptyTasksQThreadPool();
+    void emptyParallelFor_data();
+    void emptyParallelFor();
+    void parallelForScaling_data();
+    void parallelForScaling();
+    void nestedParallelFor();
+
+private:
+    void taskCountData();
+};
+
+void tst_bench_threadpool::taskCountData()
+{
+    QTest::addColumn<int>("tasks");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("4k") << 4000;
+}
+
+void tst_bench_threadpool::emptyTasks_data()
+{
+    taskCountData();
+}
+
+void tst_bench_threadpool::emptyTasks()
+{
+    QFETCH(int, tasks);
+    const QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(4);
+
+    QBENCHMARK {
+        EmptyTaskCounter counter;
+        for (int i = 0; i < tasks; ++i)
+            pool->addTask(&counter, countTask, countTask);
+        waitFor(counter, tasks);
+    }
+}
+
+void tst_bench_threadpool::emptyTasksQThreadPool_data()
+{
+    taskCountData();
+}
+
+// The same as emptyTasks() on the QThreadPool the pool used to be based on
+void tst_bench_threadpool::emptyTasksQThreadPool()
+{
+    QFETCH(int, tasks);
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+
+    QBENCHMARK {
+        EmptyTaskCounter counter;
+        for (int i = 0; i < tasks; ++i)
+            pool.start(new EmptyRunnable(&counter));
+        waitFor(counter, tasks);
+    }
+}
+
+void tst_bench_threadpool::emptyParallelFor_data()
+{
+    taskCountData();
+}
+
+// A range per index, measures splitting and stealing
+void tst_bench_threadpool::emptyParallelFor()
+{
+    QFETCH(int, tasks);
+    const QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(4);
+
+    QBENCHMARK {
+        QAtomicInt visited;
+        pool->parallelFor(tasks, 1, [&visited](qint32 inBegin, qint32 inEnd) {
+            visited.fetchAndAddRelaxed(inEnd - inBegin);
+        });
+        QCOMPARE(visited.load(), tasks);
+    }
+}
+
+void tst_bench_threadpool::parallelForScaling_data()
+{
+    QTest::addColumn<int>("workers");
+
+    for (int workers : { 1, 2, 4, 8 })
+        QTest::addRow("%d workers", workers) << workers;
+}
+
+void tst_bench_threadpool::parallelForScaling()
+{
+    QFETCH(int, workers);
+    const QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(quint32(workers));
+
+    const int count = 1 << 20;
+    QVector<float> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = float(i % 1000);
+    float *data = values.data();
+
+    QBENCHMARK {
+        pool->parallelFor(count, 4096, [data](qint32 inBegin, qint32 inEnd) {
+            for (qint32 i = inBegin; i < inEnd; ++i)
+                data[i] = qSqrt(data[i] * data[i] + 1.0f);
+        });
+    }
+}
+
+// Ranges that start parallelFor themselves must not deadlock the workers
+void tst_bench_threadpool::nestedParallelFor()
+{
+    const QSSGRef<QSSGAbstractThreadPool> pool = QSSGAbstractThreadPool::createThreadPool(4);
+    QAtomicInt visited;
+
+    QBENCHMARK {
+        visited.store(0);
+        pool->parallelFor(64, 1, [&](qint32 inBegin, qint32 inEnd) {
+            for (qint32 i = inBegin; i < inEnd; ++i) {
+                pool->parallelFor(1024, 64, [&visited](qint32 inInnerBegin, qint32 inInnerEnd) {
+                    visited.fetchAndAddRelaxed(inInnerEnd - inInnerBegin);
+                });
+            }
+        });
+    }
+    QCOMPARE(visited.load(), 64 * 1024);
+}
+
+QTEST_GUILESS_MAIN(tst_bench_threadpool)
+
+#include "tst_bench_threadpool.moc"
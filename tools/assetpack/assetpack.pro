@@ -0,0 +1,4 @@
+QT += quick3druntimerender-private
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextStream>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderassetarchive_p.h>
+
+#include <algorithm>
+
+// Packs meshes, textures and shaders into a single archive that
+// QSSGInputStreamFactory can memory-map and serve files from, see
+// QUICK3D_ASSET_ARCHIVES. Entries are named by their path relative to the
+// directory they were packed from, which is how the scene refers to them.
+
+namespace {
+
+bool collectFiles(const QString &inDirectory,
+                  const QStringList &inNameFilters,
+                  QVector<QPair<QString, QString>> &outFiles)
+{
+    const QDir root(inDirectory);
+    if (!root.exists()) {
+        qWarning("%s is not a directory", qPrintable(inDirectory));
+        return false;
+    }
+    QDirIterator it(inDirectory, inNameFilters, QDir::Files, QDirIterator::Subdirectories);
+    QVector<QPair<QString, QString>> files;
+    while (it.hasNext()) {
+        const QString path = it.next();
+        files.append(qMakePair(QDir::cleanPath(root.relativeFilePath(path)), path));
+    }
+    // Keep archives reproducible
+    std::sort(files.begin(), files.end());
+    outFiles += files;
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser cmdLineParser;
+    cmdLineParser.setApplicationDescription(QStringLiteral("Packs Qt Quick 3D assets into a memory-mappable archive."));
+    cmdLineParser.addHelpOption();
+    cmdLineParser.addPositionalArgument(QStringLiteral("directories"), QStringLiteral("Directories to pack, entries are named relative to them."), QStringLiteral("directories..."));
+    QCommandLineOption outputOption({ QStringLiteral("o"), QStringLiteral("output") }, QStringLiteral("Write the archive to <file>."), QStringLiteral("file"), QStringLiteral("assets.qsga"));
+    QCommandLineOption filterOption(QStringLiteral("filter"), QStringLiteral("Only pack files matching the comma separated <patterns>, for example *.mesh,*.png."), QStringLiteral("patterns"));
+    QCommandLineOption listOption(QStringLiteral("list"), QStringLiteral("List the entries of an existing archive instead of packing."), QStringLiteral("archive"));
+    cmdLineParser.addOption(outputOption);
+    cmdLineParser.addOption(filterOption);
+    cmdLineParser.addOption(listOption);
+    cmdLineParser.process(app);
+
+    if (cmdLineParser.isSet(listOption)) {
+        QSSGAssetArchive archive(cmdLineParser.value(listOption));
+        if (!archive.open()) {
+            qWarning("Cannot open %s: %s", qPrintable(archive.fileName()), qPrintable(archive.errorString()));
+            return -1;
+        }
+        QStringList names = archive.entryNames();
+        names.sort();
+        QTextStream out(stdout);
+        for (const QString &name : qAsConst(names))
+            out << name << ' ' << archive.entry(name).size() << '\n';
+        return 0;
+    }
+
+    const QStringList directories = cmdLineParser.positionalArguments();
+    if (directories.isEmpty())
+        cmdLineParser.showHelp(-1);
+
+    QStringList nameFilters;
+    if (cmdLineParser.isSet(filterOption))
+        nameFilters = cmdLineParser.value(filterOption).split(QLatin1Char(','), QString::SkipEmptyParts);
+
+    QVector<QPair<QString, QString>> files;
+    for (const QString &directory : directories) {
+        if (!collectFiles(directory, nameFilters, files))
+            return -1;
+    }
+
+    // Do not pack the archive into itself when it is written inside an input directory
+    const QString output = cmdLineParser.value(outputOption);
+    const QString outputPath = QFileInfo(output).absoluteFilePath();
+    files.erase(std::remove_if(files.begin(), files.end(), [&outputPath](const QPair<QString, QString> &file) {
+        return QFileInfo(file.second).absoluteFilePath() == outputPath;
+    }), files.end());
+
+    QString error;
+    if (!QSSGAssetArchive::write(output, files, &error)) {
+        qWarning("Cannot write %s: %s", qPrintable(output), qPrintable(error));
+        return -1;
+    }
+    QTextStream(stdout) << "Packed " << files.size() << " files into " << output << '\n';
+    return 0;
+}
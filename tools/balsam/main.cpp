@@ -32,9 +32,201 @@
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QProcess>
+#include <QtCore/QEventLoop>
+#include <QtCore/QThread>
+#include <QtCore/QTextStream>
+#include <QtCore/QHash>
+#include <QtCore/QVariantMap>
+
+#include <functional>
 
 #include <QtQuick3DAssetImport/private/qssgassetimportmanager_p.h>
 
+// Keeps track of what was imported before, so that unchanged assets are not
+// imported again. Stored in the output directory.
+static const char manifestFileName[] = ".balsam-manifest.json";
+// Bump when the output of the importers changes, invalidates all manifests
+static const int manifestVersion = 1;
+
+struct ImportResult
+{
+    bool success = false;
+    QStringList outputs; // relative to the output directory
+};
+
+// Covers everything the output of an import depends on
+static QByteArray importHash(const QString &sourceFile, const QDir &outputDirectory, const QVariantMap &options)
+{
+    QFile file(sourceFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArrayLiteral(QT_VERSION_STR));
+    hash.addData(QByteArray::number(manifestVersion));
+    hash.addData(outputDirectory.absolutePath().toUtf8());
+    for (auto it = options.cbegin(), end = options.cend(); it != end; ++it)
+        hash.addData((it.key() + QLatin1Char('=') + it.value().toString() + QLatin1Char('\n')).toUtf8());
+    hash.addData(&file);
+    return hash.result().toHex();
+}
+
+static bool sameContent(const QString &fileA, const QString &fileB)
+{
+    QFile a(fileA);
+    QFile b(fileB);
+    if (a.size() != b.size() || !a.open(QIODevice::ReadOnly) || !b.open(QIODevice::ReadOnly))
+        return false;
+    while (!a.atEnd()) {
+        if (a.read(64 * 1024) != b.read(64 * 1024))
+            return false;
+    }
+    return true;
+}
+
+// Imports into a temporary directory first and only copies the files that
+// changed, so the timestamps of the unchanged outputs are left alone.
+static ImportResult importFile(QSSGAssetImportManager &importer, const QString &sourceFile, const QDir &outputDirectory,
+                               const QVariantMap &options)
+{
+    ImportResult result;
+    QTemporaryDir temporaryDirectory;
+    if (!temporaryDirectory.isValid()) {
+        qWarning() << "Failed to create temporary directory: " << temporaryDirectory.errorString();
+        return result;
+    }
+    const QDir stagingDirectory(temporaryDirectory.path());
+
+    QString errorString;
+    QStringList generatedFiles;
+    if (!importer.importFile(sourceFile, stagingDirectory, options, &errorString, &generatedFiles)) {
+        qWarning() << "Failed to import file with error: " << errorString;
+        return result;
+    }
+
+    for (const auto &generatedFile : qAsConst(generatedFiles)) {
+        const QString stagedFile = stagingDirectory.absoluteFilePath(generatedFile);
+        const QString relativePath = stagingDirectory.relativeFilePath(stagedFile);
+        const QString targetFile = outputDirectory.absoluteFilePath(relativePath);
+        result.outputs.append(relativePath);
+        if (sameContent(stagedFile, targetFile))
+            continue;
+        outputDirectory.mkpath(QFileInfo(relativePath).path());
+        QFile::remove(targetFile);
+        if (!QFile::copy(stagedFile, targetFile)) {
+            qWarning() << "Failed to write file: " << targetFile;
+            return result;
+        }
+        qDebug() << "generated file: " << targetFile;
+    }
+
+    result.success = true;
+    return result;
+}
+
+static QJsonObject readManifest(const QDir &outputDirectory)
+{
+    QFile file(outputDirectory.filePath(QLatin1String(manifestFileName)));
+    if (!file.open(QIODevice::ReadOnly))
+        return QJsonObject();
+    const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+    if (manifest.value(QLatin1String("version")).toInt() != manifestVersion)
+        return QJsonObject();
+    return manifest.value(QLatin1String("files")).toObject();
+}
+
+static void writeManifest(const QDir &outputDirectory, const QJsonObject &files)
+{
+    QJsonObject manifest;
+    manifest.insert(QLatin1String("version"), manifestVersion);
+    manifest.insert(QLatin1String("files"), files);
+    QFile file(outputDirectory.filePath(QLatin1String(manifestFileName)));
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(manifest).toJson()) < 0)
+        qWarning() << "Failed to write manifest: " << file.fileName();
+}
+
+static QByteArray escapeDepfilePath(const QString &path)
+{
+    QByteArray escaped = QDir::fromNativeSeparators(path).toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace(' ', "\\ ");
+    escaped.replace('#', "\\#");
+    escaped.replace('$', "$$");
+    return escaped;
+}
+
+// Makefile syntax with a single target, which is what ninja expects
+static void writeDepfile(const QString &fileName, const QString &target, const QStringList &dependencies)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to write depfile: " << fileName;
+        return;
+    }
+    QByteArray contents = escapeDepfilePath(target) + ':';
+    for (const auto &dependency : dependencies)
+        contents += " \\\n  " + escapeDepfilePath(dependency);
+    contents += '\n';
+    file.write(contents);
+}
+
+// Runs the imports in worker processes, the importers keep state of their own
+// and cannot be shared between threads.
+static QHash<QString, ImportResult> importInWorkers(const QStringList &sourceFiles, const QDir &outputDirectory, int jobs,
+                                                   const QStringList &importArguments)
+{
+    QHash<QString, ImportResult> results;
+    QEventLoop loop;
+    int next = 0;
+    int running = 0;
+
+    std::function<void()> startNext = [&]() {
+        while (running < jobs && next < sourceFiles.count()) {
+            const QString sourceFile = sourceFiles.at(next++);
+            auto process = new QProcess;
+            process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+            QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                             [&, process, sourceFile](int exitCode, QProcess::ExitStatus exitStatus) {
+                ImportResult &result = results[sourceFile];
+                result.success = exitStatus == QProcess::NormalExit && exitCode == 0;
+                // The worker prints the outputs, one per line
+                const QList<QByteArray> lines = process->readAllStandardOutput().split('\n');
+                for (const auto &line : lines) {
+                    if (!line.trimmed().isEmpty())
+                        result.outputs.append(QString::fromUtf8(line.trimmed()));
+                }
+                process->deleteLater();
+                --running;
+                startNext();
+                if (running == 0)
+                    loop.quit();
+            });
+            process->start(QCoreApplication::applicationFilePath(),
+                           QStringList { QStringLiteral("--worker"), QStringLiteral("-o"), outputDirectory.absolutePath() }
+                           + importArguments + QStringList { sourceFile });
+            if (!process->waitForStarted()) {
+                qWarning() << "Failed to start worker process: " << process->errorString();
+                delete process;
+                results[sourceFile].success = false;
+                continue;
+            }
+            ++running;
+        }
+    };
+
+    startNext();
+    if (running > 0)
+        loop.exec();
+    return results;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -47,6 +239,28 @@ int main(int argc, char *argv[])
                                         QObject::tr("Sets the location to place the generated file(s). Default is the current directory"),
                                         QObject::tr("outputPath"), QDir::currentPath());
     cmdLineParser.addOption(outputPathOption);
+    QCommandLineOption jobsOption({"jobs", "j"},
+                                  QObject::tr("Number of assets imported in parallel. Default is the number of cores"),
+                                  QObject::tr("jobs"), QString::number(QThread::idealThreadCount()));
+    cmdLineParser.addOption(jobsOption);
+    QCommandLineOption forceOption({"force", "f"},
+                                   QObject::tr("Imports all assets, even the ones that did not change since the last import"));
+    cmdLineParser.addOption(forceOption);
+    QCommandLineOption bakeLightmapsOption(QStringLiteral("bake-lightmaps"),
+                                           QObject::tr("Bakes the lighting of the imported scenes into lightmaps"));
+    cmdLineParser.addOption(bakeLightmapsOption);
+    QCommandLineOption lightmapResolutionOption(QStringLiteral("lightmap-resolution"),
+                                                QObject::tr("Width and height of the baked lightmaps. Default is 256"),
+                                                QObject::tr("resolution"), QStringLiteral("256"));
+    cmdLineParser.addOption(lightmapResolutionOption);
+    QCommandLineOption depfileOption(QStringLiteral("depfile"),
+                                     QObject::tr("Writes the source files as dependencies of the manifest in the output directory to a Makefile style depfile"),
+                                     QObject::tr("depfile"));
+    cmdLineParser.addOption(depfileOption);
+    // Imports a single file and prints the generated files, used for the parallel imports
+    QCommandLineOption workerOption(QStringLiteral("worker"));
+    workerOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    cmdLineParser.addOption(workerOption);
     cmdLineParser.process(app);
 
     QStringList assetFileNames = cmdLineParser.positionalArguments();
@@ -60,18 +274,89 @@ int main(int argc, char *argv[])
         }
     }
 
+    // The options for the importers, and the same as arguments for the worker processes
+    QVariantMap importOptions;
+    QStringList importArguments;
+    if (cmdLineParser.isSet(bakeLightmapsOption)) {
+        importOptions.insert(QStringLiteral("bakeLightmaps"), true);
+        importOptions.insert(QStringLiteral("lightmapResolution"), cmdLineParser.value(lightmapResolutionOption).toInt());
+        importArguments << QStringLiteral("--bake-lightmaps")
+                        << QStringLiteral("--lightmap-resolution") << cmdLineParser.value(lightmapResolutionOption);
+    }
+
+    if (cmdLineParser.isSet(workerOption)) {
+        if (assetFileNames.count() != 1)
+            return 1;
+        QSSGAssetImportManager assetImporter;
+        const ImportResult result = importFile(assetImporter, assetFileNames.first(), outputDirectory, importOptions);
+        QTextStream out(stdout);
+        for (const auto &output : result.outputs)
+            out << output << endl;
+        return result.success ? 0 : 1;
+    }
+
     // if there is nothing to do return early
     if (assetFileNames.isEmpty())
         return 0;
 
-    QSSGAssetImportManager assetImporter;
+    // Skip the assets that are unchanged since the last import, as long as their outputs are still there
+    const QJsonObject previousManifest = readManifest(outputDirectory);
+    QJsonObject manifest = previousManifest;
+    QStringList sourceFiles;
+    QStringList pendingFiles;
+    QHash<QString, QByteArray> hashes;
+    for (const auto &assetFileName : qAsConst(assetFileNames)) {
+        const QString sourceFile = QFileInfo(assetFileName).absoluteFilePath();
+        if (sourceFiles.contains(sourceFile))
+            continue;
+        sourceFiles.append(sourceFile);
 
-    // Convert each assetFile is possible
-    for (const auto &assetFileName : assetFileNames) {
-        QString errorString;
-        if (!assetImporter.importFile(assetFileName, outputDirectory, &errorString))
-            qWarning() << "Failed to import file with error: " << errorString;
+        const QByteArray hash = importHash(sourceFile, outputDirectory, importOptions);
+        hashes.insert(sourceFile, hash);
+        const QJsonObject entry = previousManifest.value(sourceFile).toObject();
+        bool upToDate = !cmdLineParser.isSet(forceOption) && !hash.isEmpty()
+                && entry.value(QLatin1String("hash")).toString().toLatin1() == hash;
+        const QJsonArray outputs = entry.value(QLatin1String("outputs")).toArray();
+        for (int i = 0; upToDate && i < outputs.count(); ++i)
+            upToDate = outputDirectory.exists(outputs.at(i).toString());
+        if (!upToDate)
+            pendingFiles.append(sourceFile);
     }
 
-    return 0;
+    const int jobs = qMax(1, cmdLineParser.value(jobsOption).toInt());
+    QHash<QString, ImportResult> results;
+    if (jobs > 1 && pendingFiles.count() > 1) {
+        results = importInWorkers(pendingFiles, outputDirectory, jobs, importArguments);
+    } else if (!pendingFiles.isEmpty()) {
+        QSSGAssetImportManager assetImporter;
+        for (const auto &sourceFile : qAsConst(pendingFiles))
+            results.insert(sourceFile, importFile(assetImporter, sourceFile, outputDirectory, importOptions));
+    }
+
+    int failures = 0;
+    for (const auto &sourceFile : qAsConst(pendingFiles)) {
+        const ImportResult result = results.value(sourceFile);
+        if (!result.success) {
+            ++failures;
+            manifest.remove(sourceFile);
+            continue;
+        }
+        // Remove what the previous import generated and this one did not
+        const QJsonArray previousOutputs = previousManifest.value(sourceFile).toObject().value(QLatin1String("outputs")).toArray();
+        for (const auto &previousOutput : previousOutputs) {
+            if (!result.outputs.contains(previousOutput.toString()))
+                outputDirectory.remove(previousOutput.toString());
+        }
+        QJsonObject entry;
+        entry.insert(QLatin1String("hash"), QString::fromLatin1(hashes.value(sourceFile)));
+        entry.insert(QLatin1String("outputs"), QJsonArray::fromStringList(result.outputs));
+        manifest.insert(sourceFile, entry);
+    }
+
+    if (manifest != previousManifest || !outputDirectory.exists(QLatin1String(manifestFileName)))
+        writeManifest(outputDirectory, manifest);
+    if (cmdLineParser.isSet(depfileOption))
+        writeDepfile(cmdLineParser.value(depfileOption), outputDirectory.absoluteFilePath(QLatin1String(manifestFileName)), sourceFiles);
+
+    return failures > 0 ? 1 : 0;
 }
@@ -0,0 +1,4 @@
+QT += quick3drender-private
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,292 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Quick 3D.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QTextStream>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+
+#include <QtQuick3DRender/private/qssgrenderbackendcapture_p.h>
+#include <QtQuick3DRender/private/qssgrendercontext_p.h>
+
+#include <algorithm>
+
+// Replays a capture written with QUICK3D_CAPTURE_FILE and reports the CPU time
+// spent per frame and per pass, along with the number of backend calls.
+// Passes are delimited by render target switches. The first frame of a capture
+// contains the creation of most resources and is reported as warm-up.
+
+namespace {
+
+struct PassStats
+{
+    qint64 nsecs = 0;
+    quint64 commands = 0;
+    int frames = 0;
+};
+
+struct ReplayStats
+{
+    qint64 warmupNsecs = 0;
+    int warmupFrames = 0;
+    QVector<qint64> frameNsecs;
+    QVector<PassStats> passes;
+    quint64 commandCounts[int(QSSGRenderCommandType::Count)] = {};
+};
+
+void replayFrame(QSSGRenderBackend *backend,
+                 const QSSGRenderCommandList &commands,
+                 QSSGRenderHandleMap &handles,
+                 ReplayStats &stats,
+                 bool warmup)
+{
+    QElapsedTimer frameTimer;
+    QElapsedTimer passTimer;
+    int pass = 0;
+    quint64 passCommands = 0;
+
+    auto finishPass = [&]() {
+        if (warmup || (pass == 0 && passCommands == 0))
+            return;
+        if (stats.passes.size() <= pass)
+            stats.passes.resize(pass + 1);
+        PassStats &passStats = stats.passes[pass];
+        passStats.nsecs += passTimer.nsecsElapsed();
+        passStats.commands += passCommands;
+        ++passStats.frames;
+    };
+
+    frameTimer.start();
+    passTimer.start();
+    commands.forEachCommand([&](const QSSGRenderCommandList::Header *header) {
+        if (header->type == QSSGRenderCommandType::SetRenderTarget && passCommands) {
+            finishPass();
+            ++pass;
+            passCommands = 0;
+            passTimer.start();
+        }
+        QSSGRenderCommandList::replay(backend, header, &handles);
+        ++passCommands;
+        if (!warmup)
+            ++stats.commandCounts[int(header->type)];
+    });
+    finishPass();
+    backend->endFrame();
+
+    if (warmup) {
+        stats.warmupNsecs += frameTimer.nsecsElapsed();
+        ++stats.warmupFrames;
+    } else
+        stats.frameNsecs.append(frameTimer.nsecsElapsed());
+}
+
+double toMsecs(qint64 nsecs)
+{
+    return double(nsecs) / 1000000.0;
+}
+
+void printText(const ReplayStats &stats)
+{
+    QTextStream out(stdout);
+    if (stats.warmupFrames)
+        out << "warm-up: " << toMsecs(stats.warmupNsecs / stats.warmupFrames) << " ms\n";
+
+    if (!stats.frameNsecs.isEmpty()) {
+        QVector<qint64> sorted = stats.frameNsecs;
+        std::sort(sorted.begin(), sorted.end());
+        qint64 total = 0;
+        for (qint64 nsecs : sorted)
+            total += nsecs;
+        out << "frames: " << sorted.size()
+            << " min " << toMsecs(sorted.first()) << " ms"
+            << " median " << toMsecs(sorted.at(sorted.size() / 2)) << " ms"
+            << " avg " << toMsecs(total / sorted.size()) << " ms"
+            << " max " << toMsecs(sorted.last()) << " ms\n";
+    }
+
+    out << "\npass   frames  avg ms      commands/frame\n";
+    for (int i = 0; i < stats.passes.size(); ++i) {
+        const PassStats &pass = stats.passes.at(i);
+        if (!pass.frames)
+            continue;
+        out << qSetFieldWidth(7) << left << i
+            << qSetFieldWidth(8) << pass.frames
+            << qSetFieldWidth(12) << toMsecs(pass.nsecs / pass.frames)
+            << qSetFieldWidth(0) << (pass.commands / quint64(pass.frames)) << '\n';
+    }
+
+    out << "\ncommand                                  calls\n";
+    for (int i = 0; i < int(QSSGRenderCommandType::Count); ++i) {
+        if (!stats.commandCounts[i])
+            continue;
+        out << qSetFieldWidth(41) << left << toString(QSSGRenderCommandType(i))
+            << qSetFieldWidth(0) << stats.commandCounts[i] << '\n';
+    }
+}
+
+void printJson(const ReplayStats &stats)
+{
+    QJsonObject root;
+    if (stats.warmupFrames)
+        root.insert(QStringLiteral("warmupMsecs"), toMsecs(stats.warmupNsecs / stats.warmupFrames));
+
+    QJsonArray frames;
+    for (qint64 nsecs : stats.frameNsecs)
+        frames.append(toMsecs(nsecs));
+    root.insert(QStringLiteral("frameMsecs"), frames);
+
+    QJsonArray passes;
+    for (const PassStats &pass : stats.passes) {
+        QJsonObject passObject;
+        passObject.insert(QStringLiteral("frames"), pass.frames);
+        passObject.insert(QStringLiteral("avgMsecs"), pass.frames ? toMsecs(pass.nsecs / pass.frames) : 0.0);
+        passObject.insert(QStringLiteral("commandsPerFrame"), pass.frames ? double(pass.commands / quint64(pass.frames)) : 0.0);
+        passes.append(passObject);
+    }
+    root.insert(QStringLiteral("passes"), passes);
+
+    QJsonObject counts;
+    for (int i = 0; i < int(QSSGRenderCommandType::Count); ++i) {
+        if (stats.commandCounts[i])
+            counts.insert(QLatin1String(toString(QSSGRenderCommandType(i))), double(stats.commandCounts[i]));
+    }
+    root.insert(QStringLiteral("calls"), counts);
+
+    QTextStream(stdout) << QJsonDocument(root).toJson();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // Never capture the replay itself
+    qunsetenv("QUICK3D_CAPTURE_FILE");
+
+    // A GL context needs a gui application, the null backend does not
+    bool useGl = false;
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--gl") == 0)
+            useGl = true;
+    }
+    QScopedPointer<QCoreApplication> app(useGl ? new QGuiApplication(argc, argv) : new QCoreApplication(argc, argv));
+
+    QCommandLineParser cmdLineParser;
+    cmdLineParser.setApplicationDescription(QStringLiteral("Replays a Qt Quick 3D backend capture and reports CPU time per pass and call counts."));
+    cmdLineParser.addHelpOption();
+    cmdLineParser.addPositionalArgument(QStringLiteral("capture"), QStringLiteral("Capture file written with QUICK3D_CAPTURE_FILE."));
+    QCommandLineOption glOption(QStringLiteral("gl"), QStringLiteral("Replay on an offscreen OpenGL context instead of the null backend."));
+    QCommandLineOption repeatOption(QStringLiteral("repeat"), QStringLiteral("Replay the capture <count> times."), QStringLiteral("count"), QStringLiteral("1"));
+    QCommandLineOption jsonOption(QStringLiteral("json"), QStringLiteral("Print the results as JSON."));
+    cmdLineParser.addOption(glOption);
+    cmdLineParser.addOption(repeatOption);
+    cmdLineParser.addOption(jsonOption);
+    cmdLineParser.process(*app);
+
+    const QStringList fileNames = cmdLineParser.positionalArguments();
+    if (fileNames.size() != 1)
+        cmdLineParser.showHelp(-1);
+
+    bool ok = false;
+    const int repeat = cmdLineParser.value(repeatOption).toInt(&ok);
+    if (!ok || repeat < 1) {
+        qWarning("Invalid repeat count %s", qPrintable(cmdLineParser.value(repeatOption)));
+        return -1;
+    }
+
+    // Load every frame up front so file access is not measured
+    QSSGRenderCaptureReader reader(fileNames.first());
+    if (!reader.open()) {
+        qWarning("Cannot open %s: %s", qPrintable(fileNames.first()), qPrintable(reader.errorString()));
+        return -1;
+    }
+    QVector<QSSGRenderCommandList *> frames;
+    while (!reader.atEnd()) {
+        QSSGRenderCommandList *frame = new QSSGRenderCommandList;
+        frames.append(frame);
+        if (!reader.readFrame(frame)) {
+            qWarning("Cannot read %s: %s", qPrintable(fileNames.first()), qPrintable(reader.errorString()));
+            qDeleteAll(frames);
+            return -1;
+        }
+    }
+    if (frames.isEmpty()) {
+        qWarning("%s contains no frames", qPrintable(fileNames.first()));
+        return -1;
+    }
+
+    QScopedPointer<QOpenGLContext> glContext;
+    QScopedPointer<QOffscreenSurface> surface;
+    QSSGRef<QSSGRenderContext> renderContext;
+    if (useGl) {
+        glContext.reset(new QOpenGLContext);
+        surface.reset(new QOffscreenSurface);
+        if (!glContext->create()) {
+            qWarning("Cannot create an OpenGL context");
+            qDeleteAll(frames);
+            return -1;
+        }
+        surface->setFormat(glContext->format());
+        surface->create();
+        glContext->makeCurrent(surface.data());
+        renderContext = QSSGRenderContext::createGl(glContext->format());
+    } else {
+        renderContext = QSSGRenderContext::createNull();
+    }
+    QSSGRenderBackend *backend = renderContext->backend().data();
+
+    // Each run starts over with the first frame, which creates the resources
+    // of the capture again. That frame is reported as warm-up, unless it is
+    // the only frame there is to measure: a single frame capture is only
+    // warmed up by the first of several runs. Resources the capture did not
+    // release are released after each run.
+    ReplayStats stats;
+    for (int run = 0; run < repeat; ++run) {
+        QSSGRenderHandleMap handles;
+        for (int i = 0; i < frames.size(); ++i) {
+            const bool warmup = i == 0 && (frames.size() > 1 || (run == 0 && repeat > 1));
+            replayFrame(backend, *frames.at(i), handles, stats, warmup);
+        }
+        handles.releaseAll(backend);
+    }
+
+    if (cmdLineParser.isSet(jsonOption))
+        printJson(stats);
+    else
+        printText(stats);
+
+    renderContext.clear();
+    qDeleteAll(frames);
+    return 0;
+}
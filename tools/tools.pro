@@ -1,5 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS = \
+    assetpack \
     balsam \
+    capturereplay \
     meshdebug